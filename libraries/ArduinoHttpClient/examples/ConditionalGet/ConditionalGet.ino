@@ -0,0 +1,88 @@
+/*
+  Conditional GET example for the ArduinoHttpClient library, for the ESP8266
+  and ESP32.
+  Fetches a JSON document once a minute, keeping the last copy in a file
+  on LittleFS along with its ETag.  The document is only downloaded and
+  parsed again when the server says it has changed; the rest of the time
+  the server answers 304 Not Modified without a body.
+
+  based on SimpleGet example by Tom Igoe
+
+  this example is in the public domain
+*/
+
+#include <ArduinoHttpClient.h>
+#include <HttpFileCacheStore.h>
+#include <LittleFS.h>
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#else
+#include <WiFi.h>
+#endif
+
+#include "arduino_secrets.h"
+
+///////please enter your sensitive data in the Secret tab/arduino_secrets.h
+/////// WiFi Settings ///////
+char ssid[] = SECRET_SSID;
+char pass[] = SECRET_PASS;
+
+char serverAddress[] = "192.168.0.3";  // server address
+int port = 8080;
+
+WiFiClient wifi;
+HttpClient client = HttpClient(wifi, serverAddress, port);
+HttpFileCacheStore store(LittleFS, "/config.json");
+HttpCache cache(client, store);
+
+// what was read from the document the last time it changed
+String mode;
+
+void readConfig() {
+  File file = store.open();
+  if (!file) {
+    return;
+  }
+  // a real sketch would parse the JSON here, e.g. with deserializeJson(doc, file)
+  mode = file.readString();
+  file.close();
+}
+
+void setup() {
+  Serial.begin(115200);
+  LittleFS.begin();
+
+  WiFi.begin(ssid, pass);
+  while (WiFi.status() != WL_CONNECTED) {
+    Serial.print("Attempting to connect to Network named: ");
+    Serial.println(ssid);                   // print the network name (SSID);
+    delay(1000);
+  }
+
+  // start from the copy saved before the last reset
+  readConfig();
+}
+
+void loop() {
+  Serial.println("making conditional GET request");
+  int statusCode = cache.get("/config.json");
+
+  Serial.print("Status code: ");
+  Serial.println(statusCode);
+  if (statusCode == HttpCache::kStatusOK) {
+    Serial.print("Changed, downloaded ");
+    Serial.print(cache.bodyLength());
+    Serial.println(" bytes");
+    readConfig();
+  } else if (statusCode == HttpCache::kStatusNotModified) {
+    Serial.println("Not modified, keeping the cached copy");
+  } else if (statusCode > 0) {
+    // the body of an unexpected response is still waiting in the client
+    client.stop();
+  }
+  Serial.print("Config: ");
+  Serial.println(mode);
+
+  Serial.println("Wait a minute");
+  delay(60000);
+}
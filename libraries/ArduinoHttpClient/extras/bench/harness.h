@@ -0,0 +1,45 @@
+// Timing helpers for the ArduinoHttpClient benchmarks
+// Released under Apache License, version 2.0
+
+#ifndef harness_h
+#define harness_h
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <string>
+
+/** Run aSetup then aRun aIterations times, and return the fastest aRun in
+    microseconds.  The best run is the one least disturbed by the rest of the
+    host
+*/
+template <typename TSetup, typename TRun>
+double bestOf(int aIterations, TSetup aSetup, TRun aRun)
+{
+    double best = 1e300;
+    for (int i = 0; i < aIterations; i++)
+    {
+        aSetup();
+        auto start = std::chrono::steady_clock::now();
+        aRun();
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+/** Frame aBody as chunks of aChunkSize bytes, followed by the last chunk
+*/
+inline std::string chunked(const std::string& aBody, size_t aChunkSize)
+{
+    std::string framed;
+    for (size_t i = 0; i < aBody.size(); i += aChunkSize)
+    {
+        size_t length = std::min(aChunkSize, aBody.size() - i);
+        framed += String((unsigned long)length, HEX).str() + "\r\n" + aBody.substr(i, length) + "\r\n";
+    }
+    return framed + "0\r\n\r\n";
+}
+
+#endif
@@ -0,0 +1,123 @@
+// Reads a response with 22 headers, keeping 4 of them, with headerAvailable()
+// and Strings, with captureHeaders(), and skips them all for comparison
+// Released under Apache License, version 2.0
+
+#include <ArduinoHttpClient.h>
+#include <ScriptedClient.h>
+
+#include <new>
+
+#include "harness.h"
+
+// Heap allocations, all of them go through operator new on the host
+static size_t allocations = 0;
+
+void* operator new(size_t aSize)
+{
+    allocations++;
+    if (void* p = malloc(aSize ? aSize : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* aPointer) noexcept { free(aPointer); }
+void operator delete(void* aPointer, size_t) noexcept { free(aPointer); }
+
+static const char* kResponse =
+    "HTTP/1.1 200 OK\r\n"
+    "Server: nginx/1.24.0\r\n"
+    "Date: Sat, 17 Oct 2026 09:12:44 GMT\r\n"
+    "Content-Type: application/json\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "Connection: keep-alive\r\n"
+    "Vary: Accept-Encoding\r\n"
+    "Cache-Control: no-cache, private\r\n"
+    "X-RateLimit-Limit: 60\r\n"
+    "X-RateLimit-Remaining: 59\r\n"
+    "Access-Control-Allow-Origin: *\r\n"
+    "Set-Cookie: XSRF-TOKEN=eyJpdiI6IjZ3a0tPT2x5c3ZmN2hJb1FHRmJ3PT0iLCJ2YWx1ZSI6IkJ2dUc5; "
+    "expires=Sat, 17 Oct 2026 11:12:44 GMT; Max-Age=7200; path=/; samesite=lax\r\n"
+    "Set-Cookie: laravel_session=eyJpdiI6Im5pU0ZRbUhKbm1PT1pQL0RjYVBkM1E9PSIsInZhbHVlIjoi; "
+    "expires=Sat, 17 Oct 2026 11:12:44 GMT; Max-Age=7200; path=/; httponly; samesite=lax\r\n"
+    "X-Frame-Options: SAMEORIGIN\r\n"
+    "X-XSS-Protection: 1; mode=block\r\n"
+    "X-Content-Type-Options: nosniff\r\n"
+    "Referrer-Policy: strict-origin-when-cross-origin\r\n"
+    "Strict-Transport-Security: max-age=31536000; includeSubDomains\r\n"
+    "ETag: \"5f3a-1b2c3d4e\"\r\n"
+    "Retry-After: 120\r\n"
+    "X-Request-Id: 4f9c2a1e-8b7d-4e6f-9a0b-1c2d3e4f5a6b\r\n"
+    "Content-Security-Policy: default-src 'self'\r\n"
+    "\r\n"
+    "2\r\n{}\r\n0\r\n\r\n";
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+
+    char date[40], etag[24], retryAfter[8], contentType[32];
+    HttpHeaderCapture captures[] = {
+        {"Date", date, sizeof(date), false},
+        {"ETag", etag, sizeof(etag), false},
+        {"Retry-After", retryAfter, sizeof(retryAfter), false},
+        {"Content-Type", contentType, sizeof(contentType), false},
+    };
+    const char* modes[] = {"headerAvailable() + String", "captureHeaders(4)", "skipResponseHeaders()"};
+
+    printf("%-28s %10s %20s\n", "headers read with", "best (us)", "allocations/response");
+    for (int mode = 0; mode < 3; mode++)
+    {
+        ScriptedClient client;
+        HttpClient http(client, "localhost", 80);
+        if (mode == 1)
+            http.captureHeaders(captures, 4);
+
+        size_t used = 0;
+        auto request = [&] {
+            date[0] = etag[0] = retryAfter[0] = contentType[0] = '\0';
+            client.sent.clear();
+            http.get("/");
+            client.respond(kResponse);
+            http.responseStatusCode();
+        };
+        double best = bestOf(iterations, request, [&] {
+            size_t before = allocations;
+            if (mode == 0)
+            {
+                while (http.headerAvailable())
+                {
+                    String name = http.readHeaderName();
+                    for (HttpHeaderCapture& capture : captures)
+                    {
+                        if (name.equalsIgnoreCase(capture.name))
+                        {
+                            String value = http.readHeaderValue();
+                            strncpy(capture.value, value.c_str(), capture.valueSize - 1);
+                            capture.value[capture.valueSize - 1] = '\0';
+                        }
+                    }
+                }
+            }
+            else
+            {
+                http.skipResponseHeaders();
+            }
+            used = allocations - before;
+        });
+
+        if (mode < 2 && (strcmp(date, "Sat, 17 Oct 2026 09:12:44 GMT") != 0 ||
+                         strcmp(etag, "\"5f3a-1b2c3d4e\"") != 0 ||
+                         strcmp(retryAfter, "120") != 0 ||
+                         strcmp(contentType, "application/json") != 0))
+        {
+            fprintf(stderr, "%s: wrong header values\n", modes[mode]);
+            return 1;
+        }
+        if (http.responseBody().str() != "{}")
+        {
+            fprintf(stderr, "%s: wrong body\n", modes[mode]);
+            return 1;
+        }
+        printf("%-28s %10.1f %20zu\n", modes[mode], best, used);
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+// Decodes a 220 KB JSON roster sent as is, gzip, zlib and raw deflate, with
+// the memory HttpInflateStream needs, alone and into deserializeJson(), then
+// downloads and parses it over a slow link
+// Released under Apache License, version 2.0
+
+#include <ArduinoHttpClient.h>
+#include <Compressed.h>
+#include <HttpInflateStream.h>
+#include <Loopback.h>
+#include <ScriptedClient.h>
+
+#include <ArduinoJson.h>
+
+#include <new>
+
+#include "harness.h"
+
+// Heap allocations, all of them go through operator new on the host
+static size_t allocations = 0;
+
+void* operator new(size_t aSize)
+{
+    allocations++;
+    if (void* p = malloc(aSize ? aSize : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* aPointer) noexcept { free(aPointer); }
+void operator delete(void* aPointer, size_t) noexcept { free(aPointer); }
+
+static uint8_t window[HttpInflateStream::kMaxWindowSize];
+
+static std::string response(const std::string& aBody, const char* aEncoding)
+{
+    std::string head = "HTTP/1.1 200 OK\r\n";
+    if (aEncoding[0])
+        head += std::string("Content-Encoding: ") + aEncoding + "\r\n";
+    return head + "Content-Length: " + std::to_string(aBody.size()) + "\r\nConnection: close\r\n\r\n" + aBody;
+}
+
+// Only what the terminal keeps of each card
+static JsonDocument filter()
+{
+    JsonDocument filter;
+    filter["cards"][0]["uid"] = true;
+    filter["cards"][0]["valid"] = true;
+    filter["cards"][0]["zones"] = true;
+    return filter;
+}
+
+static bool parsed(const JsonDocument& aDocument)
+{
+    return aDocument["cards"].size() == 2147 && aDocument["cards"][2146]["uid"].is<const char*>();
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    double linkMbps = argc > 2 ? atof(argv[2]) : 1.0;
+
+    const std::string json = roster();
+    struct {
+        const char* name;
+        std::string body;
+        const char* encoding;
+        size_t window;
+    } bodies[] = {
+        {"identity", json, "", 1},
+        {"gzip", compressed(json, 16 + 15), "gzip", 32768},
+        {"zlib", compressed(json, 15), "deflate", 32768},
+        {"zlib 1 KB", compressed(json, 10), "deflate", 1024},
+        {"raw", compressed(json, -15), "deflate", 32768},
+    };
+
+    printf("HttpInflateStream: %zu bytes, plus the window\n\n", sizeof(HttpInflateStream));
+    const JsonDocument cardFilter = filter();
+    printf("%-10s %8s %8s %10s %8s %12s %10s\n", "body", "encoded", "window", "best (us)", "MB/s", "allocations",
+           "parse (us)");
+    for (auto& test : bodies)
+    {
+        const std::string r = response(test.body, test.encoding);
+        ScriptedClient client;
+        HttpClient http(client, "localhost", 80);
+        size_t used = 0;
+        size_t decoded = 0;
+        int error = 0;
+        double best = bestOf(iterations, [&] {
+            http.get("/");
+            client.respond(r);
+            http.responseStatusCode();
+            http.skipResponseHeaders();
+        }, [&] {
+            size_t before = allocations;
+            HttpInflateStream body(http, window, test.window);
+            body.begin(test.encoding);
+            uint8_t buffer[256];
+            int n;
+            decoded = 0;
+            while ((n = body.read(buffer, sizeof(buffer))) > 0)
+                decoded += n;
+            error = body.error();
+            used = allocations - before;
+        });
+        if (decoded != json.size() || error != HTTP_SUCCESS)
+        {
+            fprintf(stderr, "%s: decoded %zu bytes, error %d\n", test.name, decoded, error);
+            return 1;
+        }
+
+        // The same, straight into the parser
+        JsonDocument doc;
+        DeserializationError parseError = DeserializationError::Ok;
+        double parse = bestOf(iterations, [&] {
+            http.get("/");
+            client.respond(r);
+            http.responseStatusCode();
+            http.skipResponseHeaders();
+        }, [&] {
+            HttpInflateStream body(http, window, test.window);
+            body.begin(test.encoding);
+            parseError = deserializeJson(doc, body, DeserializationOption::Filter(cardFilter));
+        });
+        if (parseError || !parsed(doc))
+        {
+            fprintf(stderr, "%s: %s\n", test.name, parseError.c_str());
+            return 1;
+        }
+        printf("%-10s %8zu %8zu %10.0f %8.1f %12zu %10.0f\n", test.name, test.body.size(), test.window, best,
+               json.size() / best, used, parse);
+    }
+
+    // The time to download and parse it, 1460 byte segments at the link rate
+    unsigned long pause = (unsigned long)(1460 * 8 / (linkMbps * 1000) + 0.5);
+    printf("\nover a %.1f Mbit/s link, download and parse\n", linkMbps);
+    printf("%-10s %8s %10s\n", "body", "encoded", "ms");
+    for (int i = 0; i < 2; i++)
+    {
+        const std::string r = response(bodies[i].body, bodies[i].encoding);
+        LoopbackServer server([&r, pause](LoopbackConnection& aConnection) {
+            aConnection.readRequest();
+            aConnection.send(r, 1460, pause);
+        });
+        LoopbackClient client;
+        HttpClient http(client, "localhost", server.port());
+        http.setHttpWaitForDataDelay(1);
+
+        unsigned long start = millis();
+        http.get("/");
+        http.responseStatusCode();
+        http.skipResponseHeaders();
+        HttpInflateStream body(http, window, bodies[i].window);
+        body.begin(bodies[i].encoding);
+        JsonDocument doc;
+        DeserializationError parseError = deserializeJson(doc, body, DeserializationOption::Filter(cardFilter));
+        if (parseError || !parsed(doc) || body.decodedLength() != json.size())
+        {
+            fprintf(stderr, "%s: %s over the link\n", bodies[i].name, parseError.c_str());
+            return 1;
+        }
+        printf("%-10s %8lu %10lu\n", bodies[i].name, body.encodedLength(), millis() - start);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Reads a 16 KB response body from a loopback server, with responseBody(),
+// read(buf, size) and read(), over Content-Length and chunked bodies
+// Released under Apache License, version 2.0
+
+#include <ArduinoHttpClient.h>
+#include <Loopback.h>
+
+#include "harness.h"
+
+static const size_t kBodySize = 16384;
+
+static std::string body()
+{
+    std::string s;
+    while (s.size() < kBodySize)
+        s += "{\"k\":\"0123456789abcdef\",\"v\":12345},";
+    s.resize(kBodySize);
+    return s;
+}
+
+static void serve(LoopbackConnection& aConnection)
+{
+    const std::string content = body();
+    std::string request;
+    while (!(request = aConnection.readRequest()).empty())
+    {
+        if (request.find(" /chunked") != std::string::npos)
+            aConnection.send("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + chunked(content, 1000));
+        else
+            aConnection.send("HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(kBodySize) + "\r\n\r\n" + content);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    LoopbackServer server(serve);
+    LoopbackClient client;
+    HttpClient http(client, "localhost", server.port());
+    http.connectionKeepAlive();
+
+    printf("%-10s %-16s %10s %14s\n", "body", "read with", "best (us)", "client reads");
+    for (const char* path : {"/length", "/chunked"})
+    {
+        for (int mode = 0; mode < 3; mode++)
+        {
+            size_t readCalls = 0;
+            auto request = [&] {
+                http.get(path);
+                http.responseStatusCode();
+                http.skipResponseHeaders();
+                // wait for the whole body, the link speed isn't measured
+                while (http.available() < 1000)
+                    ;
+                LoopbackConnection::pause(1);
+            };
+            double best = bestOf(iterations, request, [&] {
+                size_t before = client.readCalls;
+                size_t length = 0;
+                if (mode == 0)
+                {
+                    length = http.responseBody().length();
+                }
+                else
+                {
+                    uint8_t buffer[256];
+                    int n;
+                    while (!http.endOfBodyReached())
+                    {
+                        n = (mode == 1) ? http.read(buffer, sizeof(buffer)) : http.read();
+                        if (n > 0)
+                            length += (mode == 1) ? n : 1;
+                    }
+                }
+                readCalls = client.readCalls - before;
+                if (length != kBodySize)
+                {
+                    fprintf(stderr, "%s: read %zu bytes\n", path, length);
+                    exit(1);
+                }
+            });
+            const char* modes[] = {"responseBody()", "read(buf, 256)", "read()"};
+            printf("%-10s %-16s %10.0f %14zu\n", path + 1, modes[mode], best, readCalls);
+        }
+    }
+    return 0;
+}
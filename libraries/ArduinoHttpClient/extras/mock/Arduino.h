@@ -0,0 +1,216 @@
+// Stand-in for the parts of the Arduino core that ArduinoHttpClient uses, so
+// that the library can be built and run on a host
+// Released under Apache License, version 2.0
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HEX 16
+#define DEC 10
+#define F(s) (s)
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+long random(long max);
+long random(long min, long max);
+
+inline bool isHexadecimalDigit(int c) { return isxdigit(c) != 0; }
+inline bool isSpace(int c) { return isspace(c) != 0; }
+inline bool isAlphaNumeric(int c) { return isalnum(c) != 0; }
+
+using std::max;
+using std::min;
+
+class String
+{
+public:
+    String() {}
+    String(const char* aString) : iValid(aString != NULL) { if (aString) iString = aString; }
+    String(const std::string& aString) : iString(aString) {}
+    String(char aChar) : iString(1, aChar) {}
+    String(int aValue, unsigned char aBase = DEC) : iString(format(aValue, aBase)) {}
+    String(unsigned int aValue, unsigned char aBase = DEC) : iString(format(aValue, aBase)) {}
+    String(long aValue, unsigned char aBase = DEC) : iString(format(aValue, aBase)) {}
+    String(unsigned long aValue, unsigned char aBase = DEC) : iString(format(aValue, aBase)) {}
+
+    unsigned char reserve(unsigned int aSize) { iString.reserve(aSize); return 1; }
+    unsigned int length() const { return iString.size(); }
+    const char* c_str() const { return iString.c_str(); }
+    const std::string& str() const { return iString; }
+    explicit operator bool() const { return iValid; }
+
+    bool concat(const String& aString) { iString += aString.iString; return true; }
+    bool concat(const char* aString) { iString += aString; return true; }
+    bool concat(const char* aString, unsigned int aLength) { iString.append(aString, aLength); return true; }
+    bool concat(char aChar) { iString += aChar; return true; }
+    String& operator+=(const String& aString) { concat(aString); return *this; }
+    String& operator+=(const char* aString) { concat(aString); return *this; }
+    String& operator+=(char aChar) { concat(aChar); return *this; }
+    friend String operator+(const String& a, const String& b) { return String(a.iString + b.iString); }
+    friend String operator+(const String& a, const char* b) { return String(a.iString + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.iString); }
+
+    bool operator==(const String& aString) const { return iString == aString.iString; }
+    bool operator==(const char* aString) const { return iString == aString; }
+    bool operator!=(const String& aString) const { return iString != aString.iString; }
+    bool operator!=(const char* aString) const { return iString != aString; }
+    bool equalsIgnoreCase(const String& aString) const
+    {
+        if (aString.length() != length())
+            return false;
+        for (size_t i = 0; i < iString.size(); i++)
+            if (tolower(iString[i]) != tolower(aString.iString[i]))
+                return false;
+        return true;
+    }
+    bool startsWith(const String& aPrefix) const { return iString.compare(0, aPrefix.iString.size(), aPrefix.iString) == 0; }
+    bool endsWith(const String& aSuffix) const
+    {
+        return iString.size() >= aSuffix.iString.size() &&
+               iString.compare(iString.size() - aSuffix.iString.size(), aSuffix.iString.size(), aSuffix.iString) == 0;
+    }
+
+    char charAt(unsigned int aIndex) const { return aIndex < iString.size() ? iString[aIndex] : 0; }
+    char operator[](unsigned int aIndex) const { return charAt(aIndex); }
+    int indexOf(char aChar, unsigned int aFrom = 0) const { return position(iString.find(aChar, aFrom)); }
+    int indexOf(const String& aString, unsigned int aFrom = 0) const { return position(iString.find(aString.iString, aFrom)); }
+    String substring(unsigned int aFrom) const { return aFrom < iString.size() ? String(iString.substr(aFrom)) : String(""); }
+    String substring(unsigned int aFrom, unsigned int aTo) const
+    {
+        return aFrom < iString.size() && aFrom < aTo ? String(iString.substr(aFrom, aTo - aFrom)) : String("");
+    }
+    void toLowerCase() { for (size_t i = 0; i < iString.size(); i++) iString[i] = (char)tolower(iString[i]); }
+    void trim()
+    {
+        size_t first = 0;
+        while (first < iString.size() && isspace((unsigned char)iString[first]))
+            first++;
+        size_t last = iString.size();
+        while (last > first && isspace((unsigned char)iString[last - 1]))
+            last--;
+        iString = iString.substr(first, last - first);
+    }
+    long toInt() const { return atol(iString.c_str()); }
+    void getBytes(unsigned char* aBuffer, unsigned int aSize) const { strncpy((char*)aBuffer, iString.c_str(), aSize); }
+
+private:
+    template <typename T>
+    static std::string format(T aValue, unsigned char aBase)
+    {
+        char buffer[32];
+        if (aBase == HEX)
+            snprintf(buffer, sizeof(buffer), "%llx", (unsigned long long)aValue);
+        else
+            snprintf(buffer, sizeof(buffer), "%lld", (long long)aValue);
+        return buffer;
+    }
+    static int position(size_t aPosition) { return aPosition == std::string::npos ? -1 : (int)aPosition; }
+
+    std::string iString;
+    bool iValid = true;
+};
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t aByte) = 0;
+    virtual size_t write(const uint8_t* aBuffer, size_t aSize)
+    {
+        size_t n = 0;
+        while (aSize--)
+            n += write(*aBuffer++);
+        return n;
+    }
+    size_t write(const char* aString) { return write((const uint8_t*)aString, strlen(aString)); }
+    size_t write(const char* aBuffer, size_t aSize) { return write((const uint8_t*)aBuffer, aSize); }
+    virtual void flush() {}
+
+    size_t print(const char* aString) { return write(aString); }
+    size_t print(const String& aString) { return write(aString.c_str(), aString.length()); }
+    size_t print(char aChar) { return write((uint8_t)aChar); }
+    size_t print(int aValue, int aBase = DEC) { return print(String(aValue, aBase)); }
+    size_t print(unsigned int aValue, int aBase = DEC) { return print(String(aValue, aBase)); }
+    size_t print(long aValue, int aBase = DEC) { return print(String(aValue, aBase)); }
+    size_t print(unsigned long aValue, int aBase = DEC) { return print(String(aValue, aBase)); }
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& aValue) { return print(aValue) + println(); }
+    template <typename T>
+    size_t println(const T& aValue, int aBase) { return print(aValue, aBase) + println(); }
+};
+
+class Printable
+{
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& aPrint) const = 0;
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long aTimeout) { _timeout = aTimeout; }
+    size_t readBytes(char* aBuffer, size_t aLength)
+    {
+        size_t count = 0;
+        int c;
+        while (count < aLength && (c = timedRead()) >= 0)
+            aBuffer[count++] = (char)c;
+        return count;
+    }
+    size_t readBytes(uint8_t* aBuffer, size_t aLength) { return readBytes((char*)aBuffer, aLength); }
+    size_t readBytesUntil(char aTerminator, char* aBuffer, size_t aLength)
+    {
+        size_t count = 0;
+        int c;
+        while (count < aLength && (c = timedRead()) >= 0 && c != aTerminator)
+            aBuffer[count++] = (char)c;
+        return count;
+    }
+
+protected:
+    int timedRead()
+    {
+        unsigned long start = millis();
+        do
+        {
+            int c = read();
+            if (c >= 0)
+                return c;
+            yield();
+        } while (millis() - start < _timeout);
+        return -1;
+    }
+
+    unsigned long _timeout = 1000;
+};
+
+class HardwareSerial : public Print
+{
+public:
+    size_t write(uint8_t aByte) override { return fputc(aByte, stderr) == EOF ? 0 : 1; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,64 @@
+// Bodies compressed with the system zlib, for the HttpInflateStream tests and
+// benchmarks
+// Released under Apache License, version 2.0
+
+#ifndef Compressed_h
+#define Compressed_h
+
+#include <zlib.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+
+/** A JSON access-control roster of about 220 KB, which compresses about 7:1
+    like the real ones.  The same every time
+*/
+inline std::string roster()
+{
+    static const char* names[] = {"Ada Lovelace", "Alan Turing", "Grace Hopper", "Edsger Dijkstra",
+                                  "Barbara Liskov", "Donald Knuth", "Frances Allen", "Ken Thompson"};
+    std::string json = "{\"site\":\"HQ-01\",\"cards\":[";
+    uint32_t seed = 1;
+    for (int i = 0; i < 2147; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        char card[160];
+        snprintf(card, sizeof(card),
+                 "%s{\"id\":%d,\"uid\":\"%08X\",\"name\":\"%s\",\"valid\":%s,\"zones\":[%u,%u],\"expires\":\"2027-%02u-01\"}",
+                 i ? "," : "", 100000 + i, (unsigned)seed, names[(seed >> 8) % 8],
+                 (seed & 0x10000) ? "true" : "false", (unsigned)(seed >> 20) % 16,
+                 (unsigned)(seed >> 24) % 16, (unsigned)(seed >> 12) % 12 + 1);
+        json += card;
+    }
+    return json + "]}";
+}
+
+/** Compress aData with deflateInit2()
+  @param aWindowBits 8..15 for zlib, plus 16 for gzip, negative for raw
+                     deflate
+  @param aLevel      0 for stored blocks only, up to 9
+  @param aStrategy   e.g. Z_FIXED for the fixed Huffman codes only
+  @param aHeader     gzip header to write, with a name, comment, etc.
+*/
+inline std::string compressed(const std::string& aData, int aWindowBits,
+                              int aLevel = Z_DEFAULT_COMPRESSION,
+                              int aStrategy = Z_DEFAULT_STRATEGY, gz_header* aHeader = NULL)
+{
+    z_stream stream = {};
+    deflateInit2(&stream, aLevel, Z_DEFLATED, aWindowBits, 8, aStrategy);
+    if (aHeader)
+        deflateSetHeader(&stream, aHeader);
+    std::string out(deflateBound(&stream, aData.size()) + 64, '\0');
+    stream.next_in = (Bytef*)aData.data();
+    stream.avail_in = aData.size();
+    stream.next_out = (Bytef*)&out[0];
+    stream.avail_out = out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+#endif
@@ -0,0 +1,102 @@
+// Stand-in for the ESP8266/ESP32 file system API, in memory, for host tests
+// Released under Apache License, version 2.0
+
+#ifndef FS_h
+#define FS_h
+
+#include <Arduino.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace fs
+{
+
+/** An open file, which reads or writes the contents kept by its FS.
+    Writes fail once the FS is full
+*/
+class File : public Stream
+{
+public:
+    File() {}
+    File(std::shared_ptr<std::string> aContents, size_t* aFree)
+     : iContents(aContents), iFree(aFree) {}
+
+    size_t write(uint8_t aByte) override { return write(&aByte, 1); }
+    size_t write(const uint8_t* aBuffer, size_t aSize) override
+    {
+        if (!iContents)
+            return 0;
+        size_t n = std::min(aSize, *iFree);
+        iContents->append((const char*)aBuffer, n);
+        *iFree -= n;
+        return n;
+    }
+    int available() override { return iContents ? (int)(iContents->size() - iPos) : 0; }
+    int read() override { return available() ? (uint8_t)(*iContents)[iPos++] : -1; }
+    int peek() override { return available() ? (uint8_t)(*iContents)[iPos] : -1; }
+    size_t size() const { return iContents ? iContents->size() : 0; }
+    void close() { iContents.reset(); }
+    operator bool() const { return (bool)iContents; }
+
+private:
+    std::shared_ptr<std::string> iContents;
+    size_t* iFree = NULL;
+    size_t iPos = 0;
+};
+
+/** A file system of aCapacity bytes, e.g. LittleFS
+*/
+class FS
+{
+public:
+    explicit FS(size_t aCapacity = 1 << 20) : iFree(aCapacity) {}
+
+    File open(const String& aPath, const char* aMode) { return open(aPath.c_str(), aMode); }
+    File open(const char* aPath, const char* aMode)
+    {
+        auto file = files.find(aPath);
+        if (aMode[0] == 'w')
+        {
+            if (file != files.end())
+                iFree += file->second->size();
+            std::shared_ptr<std::string> contents(new std::string);
+            files[aPath] = contents;
+            return File(contents, &iFree);
+        }
+        if (file == files.end())
+            return File();
+        return File(file->second, &iFree);
+    }
+    bool exists(const String& aPath) { return files.count(aPath.c_str()) > 0; }
+    bool remove(const String& aPath)
+    {
+        auto file = files.find(aPath.c_str());
+        if (file == files.end())
+            return false;
+        iFree += file->second->size();
+        files.erase(file);
+        return true;
+    }
+    // Like SPIFFS, it won't rename onto an existing file
+    bool rename(const String& aFrom, const String& aTo)
+    {
+        auto from = files.find(aFrom.c_str());
+        if (from == files.end() || exists(aTo))
+            return false;
+        files[aTo.c_str()] = from->second;
+        files.erase(from);
+        return true;
+    }
+
+    // What each file holds, for the tests to look at
+    std::map<std::string, std::shared_ptr<std::string>> files;
+
+private:
+    size_t iFree;
+};
+
+}
+
+#endif
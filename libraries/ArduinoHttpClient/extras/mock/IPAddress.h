@@ -0,0 +1,21 @@
+// Stand-in for the Arduino IPAddress class
+// Released under Apache License, version 2.0
+
+#ifndef IPAddress_h
+#define IPAddress_h
+
+#include <stdint.h>
+
+class IPAddress
+{
+public:
+    IPAddress() : iAddress{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : iAddress{a, b, c, d} {}
+
+    uint8_t operator[](int aIndex) const { return iAddress[aIndex]; }
+
+private:
+    uint8_t iAddress[4];
+};
+
+#endif
@@ -0,0 +1,262 @@
+// A server and a Client on a loopback TCP socket, for host tests
+// Released under Apache License, version 2.0
+
+#ifndef Loopback_h
+#define Loopback_h
+
+#include <Client.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+#include <string>
+#include <thread>
+
+/** One connection accepted by a LoopbackServer, seen from the server side
+*/
+class LoopbackConnection
+{
+public:
+    explicit LoopbackConnection(int aSocket) : iSocket(aSocket) {}
+    ~LoopbackConnection() { close(iSocket); }
+
+    /** Read up to the end of the next request headers
+      @return The request line and the headers, without the empty line, or an
+      empty string if the client closed the connection first
+    */
+    std::string readRequest()
+    {
+        size_t end;
+        while ((end = iReceived.find("\r\n\r\n")) == std::string::npos)
+        {
+            if (!receive())
+                return "";
+        }
+        std::string request = iReceived.substr(0, end);
+        iReceived.erase(0, end + 4);
+        return request;
+    }
+
+    /** Read exactly aLength bytes, false if the client closed the connection
+    */
+    bool readBytes(std::string& aData, size_t aLength)
+    {
+        while (iReceived.size() < aLength)
+        {
+            if (!receive())
+                return false;
+        }
+        aData = iReceived.substr(0, aLength);
+        iReceived.erase(0, aLength);
+        return true;
+    }
+
+    /** Send aData in pieces of aPieceSize bytes, aPauseMs apart
+    */
+    void send(const std::string& aData, size_t aPieceSize = 0, unsigned long aPauseMs = 0)
+    {
+        if (aPieceSize == 0)
+            aPieceSize = aData.size();
+        for (size_t sent = 0; sent < aData.size(); sent += aPieceSize)
+        {
+            if (sent > 0)
+                pause(aPauseMs);
+            size_t length = std::min(aPieceSize, aData.size() - sent);
+            for (size_t done = 0; done < length;)
+            {
+                ssize_t n = ::send(iSocket, aData.data() + sent + done, length - done, MSG_NOSIGNAL);
+                if (n <= 0)
+                    return;
+                done += n;
+            }
+        }
+    }
+
+    static void pause(unsigned long aMs)
+    {
+        if (aMs)
+            std::this_thread::sleep_for(std::chrono::milliseconds(aMs));
+    }
+
+private:
+    bool receive()
+    {
+        char buffer[4096];
+        ssize_t n = recv(iSocket, buffer, sizeof(buffer), 0);
+        if (n <= 0)
+            return false;
+        iReceived.append(buffer, n);
+        return true;
+    }
+
+    int iSocket;
+    std::string iReceived;
+};
+
+/** A TCP server on 127.0.0.1 that runs aHandler in a thread of its own for
+    each connection, which is closed when aHandler returns
+*/
+class LoopbackServer
+{
+public:
+    typedef std::function<void(LoopbackConnection&)> Handler;
+
+    explicit LoopbackServer(Handler aHandler) : iHandler(aHandler)
+    {
+        iSocket = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(iSocket, (sockaddr*)&address, sizeof(address));
+        socklen_t length = sizeof(address);
+        getsockname(iSocket, (sockaddr*)&address, &length);
+        iPort = ntohs(address.sin_port);
+        listen(iSocket, 8);
+        std::thread([this] { acceptConnections(); }).detach();
+    }
+
+    uint16_t port() const { return iPort; }
+
+private:
+    void acceptConnections()
+    {
+        for (;;)
+        {
+            int connection = accept(iSocket, NULL, NULL);
+            if (connection < 0)
+                return;
+            Handler handler = iHandler;
+            std::thread([connection, handler] {
+                LoopbackConnection c(connection);
+                handler(c);
+            }).detach();
+        }
+    }
+
+    Handler iHandler;
+    int iSocket;
+    uint16_t iPort;
+};
+
+/** Client over a non-blocking loopback TCP socket.  The host name is ignored,
+    it always connects to 127.0.0.1
+*/
+class LoopbackClient : public Client
+{
+public:
+    ~LoopbackClient() { stop(); }
+
+    // Number of calls to read(), to measure how the library reads
+    size_t readCalls = 0;
+
+    int connect(IPAddress, uint16_t aPort) override { return connect("127.0.0.1", aPort); }
+    int connect(const char*, uint16_t aPort) override
+    {
+        stop();
+        iSocket = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(aPort);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(iSocket, (sockaddr*)&address, sizeof(address)) != 0)
+        {
+            stop();
+            return 0;
+        }
+        int one = 1;
+        setsockopt(iSocket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(iSocket, F_SETFL, O_NONBLOCK);
+        iClosed = false;
+        iPos = iLength = 0;
+        return 1;
+    }
+    size_t write(uint8_t aByte) override { return write(&aByte, 1); }
+    size_t write(const uint8_t* aBuffer, size_t aSize) override
+    {
+        size_t done = 0;
+        while (iSocket >= 0 && done < aSize)
+        {
+            ssize_t n = ::send(iSocket, aBuffer + done, aSize - done, MSG_NOSIGNAL);
+            if (n > 0)
+                done += n;
+            else if (errno != EAGAIN && errno != EWOULDBLOCK)
+                break;
+        }
+        return done;
+    }
+    int available() override
+    {
+        fill();
+        int queued = 0;
+        if (iSocket >= 0)
+            ioctl(iSocket, FIONREAD, &queued);
+        return (int)(iLength - iPos) + queued;
+    }
+    int read() override
+    {
+        readCalls++;
+        fill();
+        return iPos < iLength ? iBuffer[iPos++] : -1;
+    }
+    int read(uint8_t* aBuffer, size_t aSize) override
+    {
+        readCalls++;
+        fill();
+        size_t count = std::min(aSize, iLength - iPos);
+        if (count == 0)
+            return -1;
+        memcpy(aBuffer, iBuffer + iPos, count);
+        iPos += count;
+        return (int)count;
+    }
+    int peek() override
+    {
+        fill();
+        return iPos < iLength ? iBuffer[iPos] : -1;
+    }
+    void stop() override
+    {
+        if (iSocket >= 0)
+            close(iSocket);
+        iSocket = -1;
+        iPos = iLength = 0;
+    }
+    uint8_t connected() override
+    {
+        fill();
+        return iSocket >= 0 && !(iClosed && iPos == iLength);
+    }
+    operator bool() override { return iSocket >= 0; }
+
+private:
+    void fill()
+    {
+        if (iPos < iLength || iSocket < 0)
+            return;
+        ssize_t n = recv(iSocket, iBuffer, sizeof(iBuffer), 0);
+        if (n > 0)
+        {
+            iPos = 0;
+            iLength = n;
+        }
+        else if (n == 0)
+        {
+            iClosed = true;
+        }
+    }
+
+    int iSocket = -1;
+    bool iClosed = false;
+    uint8_t iBuffer[1460];
+    size_t iPos = 0;
+    size_t iLength = 0;
+};
+
+#endif
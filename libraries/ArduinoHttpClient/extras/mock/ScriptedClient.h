@@ -0,0 +1,98 @@
+// A Client that plays back a scripted response, for host tests
+// Released under Apache License, version 2.0
+
+#ifndef ScriptedClient_h
+#define ScriptedClient_h
+
+#include <Client.h>
+
+#include <string>
+#include <vector>
+
+/** Client whose incoming data is set by the test, and arrives in pieces:
+    available(), read() and peek() only see the current piece, and the next
+    one arrives once it has been consumed, as if each was a TCP segment.
+    Whatever the library writes is kept in sent.
+*/
+class ScriptedClient : public Client
+{
+public:
+    /** Set the incoming data, split into pieces of aPieceSize bytes
+    */
+    void respond(const std::string& aData, size_t aPieceSize = 1460)
+    {
+        std::vector<size_t> ends;
+        for (size_t end = aPieceSize; end < aData.size(); end += aPieceSize)
+            ends.push_back(end);
+        respond(aData, ends);
+    }
+
+    /** Set the incoming data, split at the offsets in aSplits, which must
+        be in increasing order
+    */
+    void respond(const std::string& aData, const std::vector<size_t>& aSplits)
+    {
+        iIncoming = aData;
+        iSplits = aSplits;
+        iSplits.push_back(aData.size());
+        iPos = 0;
+        iPiece = 0;
+    }
+
+    /** Offsets to split aLength bytes at, chosen at random
+    */
+    static std::vector<size_t> randomSplits(size_t aLength, size_t aCount)
+    {
+        std::vector<size_t> splits;
+        for (size_t i = 0; i < aCount && aLength > 1; i++)
+            splits.push_back(1 + rand() % (aLength - 1));
+        std::sort(splits.begin(), splits.end());
+        return splits;
+    }
+
+    std::string sent;
+    // Set by stop(), a closed client has nothing more to read
+    bool closed = false;
+    size_t stopCalls = 0;
+
+    int connect(IPAddress, uint16_t) override { closed = false; return 1; }
+    int connect(const char*, uint16_t) override { closed = false; return 1; }
+    size_t write(uint8_t aByte) override { return write(&aByte, 1); }
+    size_t write(const uint8_t* aBuffer, size_t aSize) override
+    {
+        sent.append((const char*)aBuffer, aSize);
+        return aSize;
+    }
+    int available() override { return (int)(pieceEnd() - iPos); }
+    int read() override { return available() ? (uint8_t)iIncoming[iPos++] : -1; }
+    int read(uint8_t* aBuffer, size_t aSize) override
+    {
+        size_t count = std::min(aSize, (size_t)available());
+        if (count == 0)
+            return -1;
+        memcpy(aBuffer, iIncoming.data() + iPos, count);
+        iPos += count;
+        return (int)count;
+    }
+    int peek() override { return available() ? (uint8_t)iIncoming[iPos] : -1; }
+    void stop() override { closed = true; stopCalls++; }
+    uint8_t connected() override { return !closed && iPos < iIncoming.size(); }
+    operator bool() override { return !closed; }
+
+private:
+    size_t pieceEnd()
+    {
+        if (closed)
+            return iPos;
+        while (iPiece < iSplits.size() && iPos >= iSplits[iPiece])
+            iPiece++;
+        return iPiece < iSplits.size() ? iSplits[iPiece] : iIncoming.size();
+    }
+
+    std::string iIncoming;
+    std::vector<size_t> iSplits;
+    size_t iPos = 0;
+    size_t iPiece = 0;
+};
+
+#endif
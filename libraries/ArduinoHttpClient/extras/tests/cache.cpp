@@ -0,0 +1,226 @@
+// HttpCache with HttpFileCacheStore, on an in-memory file system, against a
+// server which answers conditional requests
+// Released under Apache License, version 2.0
+
+#include <ArduinoHttpClient.h>
+#include <HttpFileCacheStore.h>
+#include <Loopback.h>
+
+#include <atomic>
+#include <mutex>
+
+#include "check.h"
+
+// What the server has, changed by the tests between requests
+static std::atomic<int> version(1);
+static std::atomic<bool> lastModifiedOnly(false);
+static std::atomic<bool> truncateBody(false);
+static std::atomic<bool> badChunks(false);
+static std::atomic<size_t> padding(300);
+static std::atomic<size_t> bytesSent(0);
+static std::mutex requestMutex;
+static std::string lastRequest;
+
+static std::string etag() { return "\"v" + std::to_string(version) + "\""; }
+static std::string lastModified() { return "Sat, 17 Oct 2026 09:0" + std::to_string(version) + ":00 GMT"; }
+static std::string body()
+{
+    return "{\"terminal\":\"T-01\",\"version\":" + std::to_string(version) + ",\"pad\":\"" +
+           std::string(padding, 'x') + "\"}";
+}
+
+static void serve(LoopbackConnection& aConnection)
+{
+    std::string request;
+    while (!(request = aConnection.readRequest()).empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            lastRequest = request;
+        }
+        bool notModified = lastModifiedOnly
+            ? request.find("\r\nIf-Modified-Since: " + lastModified()) != std::string::npos
+            : request.find("\r\nIf-None-Match: " + etag()) != std::string::npos;
+
+        std::string response;
+        if (notModified)
+        {
+            response = "HTTP/1.1 304 Not Modified\r\nETag: " + etag() + "\r\n\r\n";
+        }
+        else if (badChunks)
+        {
+            // a chunk-size line which isn't hex, after the first chunk
+            std::string content = body();
+            response = "HTTP/1.1 200 OK\r\nETag: " + etag() + "\r\n"
+                       "Transfer-Encoding: chunked\r\n\r\n"
+                       "5\r\n" + content.substr(0, 5) + "\r\nZZ\r\n" + content.substr(5) + "\r\n0\r\n\r\n";
+            bytesSent += response.size();
+            aConnection.send(response);
+            return;
+        }
+        else
+        {
+            std::string content = body();
+            response = "HTTP/1.1 200 OK\r\n";
+            if (!lastModifiedOnly)
+                response += "ETag: " + etag() + "\r\n";
+            response += "last-modified: " + lastModified() + "\r\n"
+                        "Content-Length: " + std::to_string(content.size()) + "\r\n\r\n" + content;
+            if (truncateBody)
+            {
+                // and close the connection
+                response.resize(response.size() - 10);
+                bytesSent += response.size();
+                aConnection.send(response);
+                return;
+            }
+        }
+        bytesSent += response.size();
+        aConnection.send(response, 97);
+    }
+}
+
+static std::string request()
+{
+    std::lock_guard<std::mutex> lock(requestMutex);
+    return lastRequest;
+}
+
+static std::string contents(fs::FS& aFS, const char* aPath)
+{
+    auto file = aFS.files.find(aPath);
+    return file == aFS.files.end() ? "(none)" : *file->second;
+}
+
+static const char* kPath = "/terminal.json";
+
+static void checkCached(fs::FS& aFS, HttpFileCacheStore& aStore, const std::string& aValidators)
+{
+    REQUIRE(contents(aFS, kPath) == body());
+    REQUIRE(contents(aFS, "/terminal.json.val") == aValidators);
+    REQUIRE(!aFS.exists("/terminal.json.tmp"));
+
+    fs::File file = aStore.open();
+    REQUIRE(file);
+    std::string read;
+    int c;
+    while ((c = file.read()) >= 0)
+        read += (char)c;
+    REQUIRE(read == body());
+}
+
+static void testConditionalRequests(HttpClient& aHttp)
+{
+    fs::FS fs;
+    HttpFileCacheStore store(fs, kPath);
+    HttpCache cache(aHttp, store);
+    REQUIRE(!store.open());
+
+    // nothing cached, an unconditional request
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusOK);
+    REQUIRE(request().find("If-None-Match") == std::string::npos);
+    REQUIRE(request().find("If-Modified-Since") == std::string::npos);
+    REQUIRE(cache.bodyLength() == body().size());
+    checkCached(fs, store, etag() + "\n" + lastModified() + "\n");
+
+    size_t unchangedStart = bytesSent;
+    for (int i = 0; i < 5; i++)
+    {
+        REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusNotModified);
+        REQUIRE(request().find("\r\nIf-None-Match: \"v1\"") != std::string::npos);
+        REQUIRE(request().find("\r\nIf-Modified-Since: " + lastModified()) != std::string::npos);
+        REQUIRE(cache.bodyLength() == 0);
+    }
+    // only the 304s came over the connection
+    REQUIRE(bytesSent - unchangedStart < 5 * body().size() / 4);
+    checkCached(fs, store, "\"v1\"\n" + lastModified() + "\n");
+
+    version = 2;
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusOK);
+    checkCached(fs, store, "\"v2\"\n" + lastModified() + "\n");
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusNotModified);
+
+    // the client doesn't capture into the cache's buffers any more, the
+    // validators stay those of the cached copy
+    REQUIRE(aHttp.get("/other") == 0);
+    REQUIRE(aHttp.responseStatusCode() == 200);
+    REQUIRE(aHttp.responseBody().length() == body().size());
+
+    // Last-Modified only
+    lastModifiedOnly = true;
+    version = 3;
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusOK);
+    checkCached(fs, store, "\n" + lastModified() + "\n");
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusNotModified);
+    REQUIRE(request().find("If-None-Match") == std::string::npos);
+    REQUIRE(request().find("\r\nIf-Modified-Since: " + lastModified()) != std::string::npos);
+    lastModifiedOnly = false;
+
+    // after clear(), an unconditional request again
+    store.clear();
+    REQUIRE(!store.open());
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusOK);
+    REQUIRE(request().find("If-None-Match") == std::string::npos);
+    checkCached(fs, store, etag() + "\n" + lastModified() + "\n");
+
+    // validators without a body, e.g. after a reset in commitBody(), aren't sent
+    fs.remove(kPath);
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusOK);
+    REQUIRE(request().find("If-None-Match") == std::string::npos);
+    checkCached(fs, store, etag() + "\n" + lastModified() + "\n");
+}
+
+static void testFailedDownloads(HttpClient& aHttp)
+{
+    fs::FS fs(1000);
+    HttpFileCacheStore store(fs, kPath);
+    HttpCache cache(aHttp, store);
+    version = 4;
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusOK);
+    const std::string cached = body();
+    const std::string validators = etag() + "\n" + lastModified() + "\n";
+
+    // a body cut short leaves the cached copy alone
+    version = 5;
+    truncateBody = true;
+    REQUIRE(cache.get("/api/terminal") == HTTP_ERROR_TIMED_OUT);
+    truncateBody = false;
+    REQUIRE(contents(fs, kPath) == cached);
+    REQUIRE(contents(fs, "/terminal.json.val") == validators);
+    REQUIRE(!fs.exists("/terminal.json.tmp"));
+
+    // so does one with bad chunk framing, which ends it early too
+    badChunks = true;
+    REQUIRE(cache.get("/api/terminal") == HTTP_ERROR_INVALID_RESPONSE);
+    badChunks = false;
+    REQUIRE(contents(fs, kPath) == cached);
+    REQUIRE(contents(fs, "/terminal.json.val") == validators);
+    REQUIRE(!fs.exists("/terminal.json.tmp"));
+
+    // and one which doesn't fit on the file system
+    padding = 900;
+    REQUIRE(cache.get("/api/terminal") == HTTP_ERROR_API);
+    padding = 300;
+    REQUIRE(contents(fs, kPath) == cached);
+    REQUIRE(contents(fs, "/terminal.json.val") == validators);
+    REQUIRE(!fs.exists("/terminal.json.tmp"));
+
+    // and the next request still sends its validators
+    REQUIRE(cache.get("/api/terminal") == HttpCache::kStatusOK);
+    REQUIRE(request().find("\r\nIf-None-Match: \"v4\"") != std::string::npos);
+    checkCached(fs, store, etag() + "\n" + lastModified() + "\n");
+}
+
+int main()
+{
+    LoopbackServer server(serve);
+    LoopbackClient client;
+    HttpClient http(client, "localhost", server.port());
+    http.connectionKeepAlive();
+    // the server answers within a millisecond, don't sleep 100 ms each time
+    http.setHttpWaitForDataDelay(1);
+
+    testConditionalRequests(http);
+    testFailedDownloads(http);
+    return 0;
+}
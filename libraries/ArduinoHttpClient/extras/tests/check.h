@@ -0,0 +1,22 @@
+// Assertions for the ArduinoHttpClient tests
+// Released under Apache License, version 2.0
+
+#ifndef check_h
+#define check_h
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Stops the test with the location of the failure, also in release builds
+#define REQUIRE(condition)                                                    \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: REQUIRE(%s) failed\n", __FILE__, __LINE__, \
+                    #condition);                                              \
+            exit(1);                                                          \
+        }                                                                     \
+    } while (0)
+
+#endif
@@ -0,0 +1,193 @@
+// Chunked transfer coding: responses fed one byte at a time and in random
+// pieces, malformed chunk-size lines, and chunked request bodies
+// Released under Apache License, version 2.0
+
+#include <ArduinoHttpClient.h>
+#include <ScriptedClient.h>
+
+#include "check.h"
+
+static const std::string kHead = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+// On the same connection, to check the body was read up to its end
+static const std::string kNext = "HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nnext";
+
+enum ReadMode { kResponseBody, kReadByte, kReadBlock };
+
+static std::string readBody(HttpClient& aHttp, ReadMode aMode)
+{
+    std::string body;
+    if (aMode == kResponseBody)
+        return aHttp.responseBody().str();
+    for (int i = 0; i < 100000 && !aHttp.endOfBodyReached(); i++)
+    {
+        if (aMode == kReadByte)
+        {
+            int c = aHttp.read();
+            if (c >= 0)
+                body += (char)c;
+        }
+        else
+        {
+            uint8_t buffer[5];
+            int n = aHttp.read(buffer, sizeof(buffer));
+            if (n > 0)
+                body.append((const char*)buffer, n);
+        }
+    }
+    return body;
+}
+
+static void checkBody(const std::string& aChunks, const std::vector<size_t>& aSplits,
+                      ReadMode aMode, const std::string& aExpected)
+{
+    ScriptedClient client;
+    HttpClient http(client, "localhost", 80);
+    http.connectionKeepAlive();
+    client.respond(kHead + aChunks + kNext, aSplits);
+
+    REQUIRE(http.get("/") == 0);
+    REQUIRE(http.responseStatusCode() == 200);
+    REQUIRE(http.skipResponseHeaders() == 0);
+    REQUIRE(http.isResponseChunked());
+    REQUIRE(readBody(http, aMode) == aExpected);
+    REQUIRE(http.endOfBodyReached());
+    REQUIRE(!http.responseBodyInvalid());
+
+    REQUIRE(http.get("/") == 0);
+    REQUIRE(http.responseStatusCode() == 200);
+    REQUIRE(http.responseBody().str() == "next");
+}
+
+static void checkBody(const std::string& aChunks, const std::string& aExpected)
+{
+    size_t length = kHead.size() + aChunks.size() + kNext.size();
+    std::vector<size_t> everyByte;
+    for (size_t i = 1; i < length; i++)
+        everyByte.push_back(i);
+
+    for (ReadMode mode : {kResponseBody, kReadByte, kReadBlock})
+    {
+        checkBody(aChunks, everyByte, mode, aExpected);
+        checkBody(aChunks, std::vector<size_t>(), mode, aExpected);
+        for (int i = 0; i < 50; i++)
+            checkBody(aChunks, ScriptedClient::randomSplits(length, 1 + i % 8), mode, aExpected);
+    }
+}
+
+static void testValidBodies()
+{
+    checkBody("5\r\nhello\r\n7\r\n, world\r\n0\r\n\r\n", "hello, world");
+    checkBody("0\r\n\r\n", "");
+    checkBody("00000003\r\nabc\r\n0\r\n\r\n", "abc");
+    checkBody("1A\r\nabcdefghijklmnopqrstuvwxyz\r\n1a\r\nABCDEFGHIJKLMNOPQRSTUVWXYZ\r\n0\r\n\r\n",
+              "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    // extensions
+    checkBody("5;name=val\r\nhello\r\n3 ; x=\"1;2\"\r\nabc\r\n0;end\r\n\r\n", "helloabc");
+    checkBody("2\t;x\r\nok\r\n0\r\n\r\n", "ok");
+    // trailers
+    checkBody("a\r\n0123456789\r\n0\r\nExpires: never\r\nX-Sum: 1f\r\n\r\n", "0123456789");
+    // chunk data that looks like framing
+    checkBody("6\r\n0\r\n\r\n\r\n0\r\n\r\n", "0\r\n\r\n\r");
+}
+
+static void checkInvalid(const std::string& aChunks, const std::vector<size_t>& aSplits)
+{
+    ScriptedClient client;
+    HttpClient http(client, "localhost", 80);
+    http.connectionKeepAlive();
+    client.respond(kHead + aChunks + kNext, aSplits);
+
+    REQUIRE(http.get("/") == 0);
+    REQUIRE(http.responseStatusCode() == 200);
+    REQUIRE(http.skipResponseHeaders() == 0);
+    String body = http.responseBody();
+    REQUIRE(!body);
+    REQUIRE(http.responseBodyInvalid());
+    REQUIRE(http.endOfBodyReached());
+    REQUIRE(http.read() == -1);
+    // the rest of the connection can't be trusted
+    REQUIRE(client.stopCalls > 0);
+}
+
+static void testInvalidBodies()
+{
+    const char* invalid[] = {
+        "5x\r\nhello\r\n0\r\n\r\n",
+        "g\r\n",
+        ";ext\r\nhello\r\n0\r\n\r\n",
+        "\r\nhello\r\n0\r\n\r\n",
+        "-5\r\nhello\r\n0\r\n\r\n",
+        "5\r\nhello\r\nzz\r\n0\r\n\r\n",
+        // more than a long holds
+        "FFFFFFFFFFFFFFFFF\r\nhello\r\n0\r\n\r\n",
+        "80000000000000000000000000000000\r\nhello\r\n0\r\n\r\n",
+    };
+    for (const char* chunks : invalid)
+    {
+        std::string s(chunks);
+        size_t length = kHead.size() + s.size() + kNext.size();
+        std::vector<size_t> everyByte;
+        for (size_t i = 1; i < length; i++)
+            everyByte.push_back(i);
+        checkInvalid(s, everyByte);
+        checkInvalid(s, std::vector<size_t>());
+        for (int i = 0; i < 20; i++)
+            checkInvalid(s, ScriptedClient::randomSplits(length, 1 + i % 8));
+    }
+}
+
+static void testChunkedRequest()
+{
+    ScriptedClient client;
+    HttpClient http(client, "localhost", 80);
+    client.respond("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+
+    http.beginRequest();
+    REQUIRE(http.post("/upload") == 0);
+    http.sendHeader("Content-Type", "text/plain");
+    REQUIRE(http.beginChunkedBody() == 0);
+    http.print("hello");
+    // nothing to send, and not the last chunk
+    http.write((const uint8_t*)"", 0);
+    http.print("0123456789abcdefg");
+    REQUIRE(http.responseStatusCode() == 200);
+
+    const std::string& sent = client.sent;
+    size_t endOfHeaders = sent.find("\r\n\r\n");
+    REQUIRE(endOfHeaders != std::string::npos);
+    REQUIRE(sent.substr(0, endOfHeaders).find("Transfer-Encoding: chunked") != std::string::npos);
+    REQUIRE(sent.substr(0, endOfHeaders).find("Content-Length") == std::string::npos);
+    REQUIRE(sent.substr(endOfHeaders + 4) == "5\r\nhello\r\n11\r\n0123456789abcdefg\r\n0\r\n\r\n");
+
+    // too late, the headers have been sent
+    REQUIRE(http.beginChunkedBody() != 0);
+}
+
+static void testEndChunkedBody()
+{
+    ScriptedClient client;
+    HttpClient http(client, "localhost", 80);
+    client.respond("HTTP/1.1 201 Created\r\nContent-Length: 0\r\n\r\n");
+
+    http.beginRequest();
+    REQUIRE(http.put("/item") == 0);
+    REQUIRE(http.beginChunkedBody() == 0);
+    http.write((const uint8_t*)"abc", 3);
+    http.endChunkedBody();
+    // once only, responseStatusCode() doesn't end it again
+    http.endChunkedBody();
+    REQUIRE(http.responseStatusCode() == 201);
+
+    const std::string& sent = client.sent;
+    REQUIRE(sent.substr(sent.find("\r\n\r\n") + 4) == "3\r\nabc\r\n0\r\n\r\n");
+}
+
+int main()
+{
+    srand(40);
+    testValidBodies();
+    testInvalidBodies();
+    testChunkedRequest();
+    testEndChunkedBody();
+    return 0;
+}
@@ -0,0 +1,245 @@
+// HttpInflateStream: gzip, zlib and raw deflate bodies made by zlib, with
+// Content-Length and chunked, in pieces and over a slow link, and broken ones
+// Released under Apache License, version 2.0
+
+#include <ArduinoHttpClient.h>
+#include <Compressed.h>
+#include <HttpInflateStream.h>
+#include <Loopback.h>
+#include <ScriptedClient.h>
+
+#include "check.h"
+
+static uint8_t window[HttpInflateStream::kMaxWindowSize];
+
+static std::string chunked(const std::string& aBody, size_t aChunkSize)
+{
+    std::string framed;
+    for (size_t i = 0; i < aBody.size(); i += aChunkSize)
+    {
+        size_t length = std::min(aChunkSize, aBody.size() - i);
+        char size[16];
+        snprintf(size, sizeof(size), "%zx\r\n", length);
+        framed += size + aBody.substr(i, length) + "\r\n";
+    }
+    return framed + "0\r\n\r\n";
+}
+
+static std::string response(const std::string& aBody, const char* aEncoding, bool aChunked)
+{
+    std::string head = "HTTP/1.1 200 OK\r\n";
+    if (aEncoding[0])
+        head += std::string("Content-Encoding: ") + aEncoding + "\r\n";
+    if (aChunked)
+        return head + "Transfer-Encoding: chunked\r\n\r\n" + chunked(aBody, 1000);
+    return head + "Content-Length: " + std::to_string(aBody.size()) + "\r\n\r\n" + aBody;
+}
+
+/** Decode aResponse, arriving in the pieces given by aSplits, with the
+    Content-Encoding it names
+*/
+static std::string decode(const std::string& aResponse, const std::vector<size_t>& aSplits,
+                          size_t aWindowSize, int& aError)
+{
+    ScriptedClient client;
+    HttpClient http(client, "localhost", 80);
+    char encoding[16];
+    HttpHeaderCapture captures[] = {{HTTP_HEADER_CONTENT_ENCODING, encoding, sizeof(encoding), false}};
+    http.captureHeaders(captures, 1);
+
+    http.beginRequest();
+    REQUIRE(http.get("/roster.json") == 0);
+    http.sendHeader(HTTP_HEADER_ACCEPT_ENCODING, HttpInflateStream::kAcceptEncoding);
+    http.endRequest();
+    REQUIRE(client.sent.find("\r\nAccept-Encoding: gzip, deflate\r\n") != std::string::npos);
+
+    client.respond(aResponse, aSplits);
+    REQUIRE(http.responseStatusCode() == 200);
+    REQUIRE(http.skipResponseHeaders() == 0);
+
+    HttpInflateStream body(http, window, aWindowSize);
+    body.begin(encoding);
+    std::string decoded;
+    uint8_t buffer[100];
+    int n;
+    while ((n = body.read(buffer, sizeof(buffer))) > 0)
+        decoded.append((const char*)buffer, n);
+    aError = body.error();
+    if (aError == HTTP_SUCCESS)
+        REQUIRE(body.decodedLength() == decoded.size());
+    return decoded;
+}
+
+static std::string decode(const std::string& aResponse, size_t aWindowSize, int& aError)
+{
+    return decode(aResponse, ScriptedClient::randomSplits(aResponse.size(), aResponse.size() / 1460), aWindowSize, aError);
+}
+
+static void testEncodings(const std::string& aJson)
+{
+    char name[] = "roster.json";
+    char comment[] = "nightly export";
+    // one extra field, "XY", of 4 bytes
+    unsigned char extra[] = {'X', 'Y', 4, 0, 'a', 'b', 'c', 'd'};
+    gz_header header = {};
+    header.name = (Bytef*)name;
+    header.comment = (Bytef*)comment;
+    header.extra = extra;
+    header.extra_len = sizeof(extra);
+    header.hcrc = 1;
+
+    struct {
+        std::string body;
+        const char* encoding;
+        size_t window;
+    } valid[] = {
+        {compressed(aJson, 16 + 15), "gzip", 32768},
+        {compressed(aJson, 16 + 15, 9, Z_DEFAULT_STRATEGY, &header), "x-gzip", 32768},
+        {compressed(aJson, 15), "deflate", 32768},
+        // what some servers send as "deflate"
+        {compressed(aJson, -15), "deflate", 32768},
+        {compressed(aJson, 10), "deflate", 1024},
+        {compressed(aJson, 15, 0), "deflate", 1},
+        {compressed(aJson, -15, 6, Z_FIXED), "deflate", 32768},
+        {compressed(aJson, -15, 6, Z_HUFFMAN_ONLY), "deflate", 1},
+        {aJson, "", 1},
+    };
+    for (auto& test : valid)
+    {
+        for (bool isChunked : {false, true})
+        {
+            int error;
+            REQUIRE(decode(response(test.body, test.encoding, isChunked), test.window, error) == aJson);
+            REQUIRE(error == HTTP_SUCCESS);
+        }
+    }
+
+    // a window smaller than the server's
+    int error;
+    decode(response(compressed(aJson, 15), "deflate", false), 4096, error);
+    REQUIRE(error == HTTP_ERROR_INVALID_RESPONSE);
+}
+
+static void testSmallInputs()
+{
+    for (const std::string& json : {std::string(""), std::string("{}"), std::string(70000, 'a')})
+    {
+        std::string gzip = compressed(json, 16 + 15);
+        std::string r = response(gzip, "gzip", true);
+        std::vector<size_t> everyByte;
+        for (size_t i = 1; i < r.size() && i < 5000; i++)
+            everyByte.push_back(i);
+        int error;
+        REQUIRE(decode(r, everyByte, 32768, error) == json);
+        REQUIRE(error == HTTP_SUCCESS);
+    }
+}
+
+static void testBrokenBodies(const std::string& aJson)
+{
+    const std::string gzip = compressed(aJson, 16 + 15);
+    int error;
+
+    std::string corrupt = gzip;
+    corrupt[corrupt.size() / 2] ^= 0x40;
+    decode(response(corrupt, "gzip", false), 32768, error);
+    REQUIRE(error == HTTP_ERROR_INVALID_RESPONSE);
+
+    // the CRC-32
+    std::string badChecksum = gzip;
+    badChecksum[badChecksum.size() - 6] ^= 1;
+    decode(response(badChecksum, "gzip", false), 32768, error);
+    REQUIRE(error == HTTP_ERROR_INVALID_RESPONSE);
+
+    // the Adler-32
+    std::string zlib = compressed(aJson, 15);
+    zlib[zlib.size() - 1] ^= 1;
+    decode(response(zlib, "deflate", true), 32768, error);
+    REQUIRE(error == HTTP_ERROR_INVALID_RESPONSE);
+
+    // the connection closes before the end of the body
+    std::string truncated = response(gzip, "gzip", false);
+    truncated.resize(truncated.size() - 100);
+    decode(truncated, 32768, error);
+    REQUIRE(error == HTTP_ERROR_INVALID_RESPONSE);
+
+    decode(response("not gzip at all", "gzip", false), 32768, error);
+    REQUIRE(error == HTTP_ERROR_INVALID_RESPONSE);
+
+    // a chunk-size line which isn't hex cuts the body short, also when it's
+    // passed through as is
+    const char* badChunks = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                            "5\r\nhello\r\nZZ\r\n world\r\n0\r\n\r\n";
+    REQUIRE(decode(badChunks, 32768, error) == "hello");
+    REQUIRE(error == HTTP_ERROR_INVALID_RESPONSE);
+
+    std::string gzipChunks = response(gzip, "gzip", true);
+    gzipChunks.replace(gzipChunks.find("\r\n3e8\r\n"), 7, "\r\n3g8\r\n");
+    decode(gzipChunks, 32768, error);
+    REQUIRE(error == HTTP_ERROR_INVALID_RESPONSE);
+}
+
+static void testPeek(const std::string& aJson)
+{
+    std::string r = response(compressed(aJson, 16 + 15), "gzip", true);
+    ScriptedClient client;
+    HttpClient http(client, "localhost", 80);
+    REQUIRE(http.get("/") == 0);
+    client.respond(r, 7);
+    REQUIRE(http.responseStatusCode() == 200);
+    REQUIRE(http.skipResponseHeaders() == 0);
+
+    HttpInflateStream body(http, window, sizeof(window));
+    body.begin("gzip");
+    std::string decoded;
+    for (;;)
+    {
+        int peeked = body.peek();
+        REQUIRE(body.peek() == peeked);
+        int c = body.read();
+        REQUIRE(c == peeked);
+        if (c < 0)
+            break;
+        decoded += (char)c;
+    }
+    REQUIRE(decoded == aJson);
+    REQUIRE(body.available() == 0);
+    REQUIRE(body.error() == HTTP_SUCCESS);
+}
+
+// The body arrives in small pieces a few ms apart, the decoder waits for each
+static void testSlowLink(const std::string& aJson)
+{
+    const std::string gzip = compressed(aJson, 16 + 15);
+    LoopbackServer server([&gzip](LoopbackConnection& aConnection) {
+        aConnection.readRequest();
+        aConnection.send(response(gzip, "gzip", true), 1460, 2);
+    });
+    LoopbackClient client;
+    HttpClient http(client, "localhost", server.port());
+    REQUIRE(http.get("/") == 0);
+    REQUIRE(http.responseStatusCode() == 200);
+    REQUIRE(http.skipResponseHeaders() == 0);
+
+    HttpInflateStream body(http, window, sizeof(window));
+    body.begin("gzip");
+    std::string decoded;
+    int c;
+    while ((c = body.read()) >= 0)
+        decoded += (char)c;
+    REQUIRE(decoded == aJson);
+    REQUIRE(body.error() == HTTP_SUCCESS);
+    REQUIRE(body.encodedLength() == gzip.size());
+}
+
+int main()
+{
+    srand(44);
+    const std::string json = roster();
+    testEncodings(json);
+    testSmallInputs();
+    testBrokenBodies(json);
+    testPeek(json);
+    testSlowLink(json);
+    return 0;
+}
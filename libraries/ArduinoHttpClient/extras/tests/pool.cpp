@@ -0,0 +1,239 @@
+// HttpClientPool and pollResponseHeaders() against a server which waits
+// between the parts of its responses
+// Released under Apache License, version 2.0
+
+#include <ArduinoHttpClient.h>
+#include <Loopback.h>
+
+#include "check.h"
+
+static const size_t kBodySize = 3000;
+
+// GET /delay/<before status>/<between headers>/<between body parts>[/chunked]
+// in ms, or GET /bad-chunk for a chunk-size line that isn't hexadecimal
+static void serve(LoopbackConnection& aConnection)
+{
+    const std::string body(kBodySize, 'x');
+    std::string request;
+    while (!(request = aConnection.readRequest()).empty())
+    {
+        if (request.find("GET /bad-chunk ") == 0)
+        {
+            aConnection.send("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                             "5\r\nhello\r\nnot a size\r\n0\r\n\r\n");
+            continue;
+        }
+
+        int statusDelay = 0, headerDelay = 0, bodyDelay = 0;
+        sscanf(request.c_str(), "GET /delay/%d/%d/%d", &statusDelay, &headerDelay, &bodyDelay);
+        bool chunked = request.find("/chunked ") != std::string::npos;
+        size_t half = kBodySize / 2;
+
+        LoopbackConnection::pause(statusDelay);
+        aConnection.send("HTTP/1.1 200 OK\r\n");
+        LoopbackConnection::pause(headerDelay);
+        aConnection.send("Server: stand-in\r\n");
+        LoopbackConnection::pause(headerDelay);
+        if (chunked)
+        {
+            char size[16];
+            snprintf(size, sizeof(size), "%zx\r\n", kBodySize);
+            aConnection.send(std::string("Transfer-Encoding: chunked\r\n\r\n") + size);
+            LoopbackConnection::pause(bodyDelay);
+            aConnection.send(body.substr(0, half));
+            LoopbackConnection::pause(bodyDelay);
+            aConnection.send(body.substr(half) + "\r\n0\r\n\r\n");
+        }
+        else
+        {
+            aConnection.send("Content-Length: " + std::to_string(kBodySize) + "\r\n\r\n");
+            LoopbackConnection::pause(bodyDelay);
+            aConnection.send(body.substr(0, half));
+            LoopbackConnection::pause(bodyDelay);
+            aConnection.send(body.substr(half));
+        }
+    }
+}
+
+struct Result
+{
+    int status = 0;
+    size_t bodyLength = 0;
+    int completions = 0;
+    unsigned long completedAt = 0;
+};
+
+static void onBody(void* aContext, const uint8_t*, size_t aLength)
+{
+    ((Result*)aContext)->bodyLength += aLength;
+}
+
+static void onComplete(void* aContext, int aStatusCode)
+{
+    Result* result = (Result*)aContext;
+    result->status = aStatusCode;
+    result->completions++;
+    result->completedAt = millis();
+}
+
+// Poll until nothing is outstanding, return the longest poll() in ms
+static unsigned long pollAll(HttpClientPool& aPool)
+{
+    unsigned long worst = 0;
+    unsigned long start = millis();
+    while (aPool.outstanding())
+    {
+        unsigned long before = millis();
+        aPool.poll();
+        worst = std::max(worst, millis() - before);
+        REQUIRE(millis() - start < 5000);
+    }
+    return worst;
+}
+
+static void testConcurrentRequests(HttpClientPool& aPool)
+{
+    // twice, the second time over the connections kept alive
+    for (int round = 0; round < 2; round++)
+    {
+        Result results[4];
+        int slow = aPool.startRequest("/delay/100/50/50", "GET", onComplete, onBody, &results[0]);
+        int chunked = aPool.startRequest("/delay/30/30/30/chunked", "GET", onComplete, onBody, &results[1]);
+        int fast = aPool.startRequest("/delay/0/0/0", "GET", onComplete, onBody, &results[2]);
+        REQUIRE(slow == 0 && chunked == 1 && fast == 2);
+        REQUIRE(aPool.outstanding() == 3);
+
+        // no idle client left
+        REQUIRE(aPool.startRequest("/delay/0/0/0", "GET", onComplete, onBody, &results[3]) == HTTP_ERROR_API);
+
+        // the server's delays are all longer than this, poll() doesn't wait
+        // for any of them
+        REQUIRE(pollAll(aPool) < 50);
+
+        for (int i = 0; i < 3; i++)
+        {
+            REQUIRE(results[i].status == 200);
+            REQUIRE(results[i].completions == 1);
+            REQUIRE(results[i].bodyLength == kBodySize);
+        }
+        REQUIRE(results[3].completions == 0);
+        // completed as they arrived, not in the order they were sent
+        REQUIRE(results[2].completedAt < results[1].completedAt);
+        REQUIRE(results[1].completedAt < results[0].completedAt);
+    }
+}
+
+static void testTimeouts(HttpClientPool& aPool)
+{
+    Result status;
+    aPool.setTimeouts(50, 1000, 1000);
+    REQUIRE(aPool.startRequest("/delay/200/0/0", "GET", onComplete, onBody, &status) >= 0);
+    pollAll(aPool);
+    REQUIRE(status.status == HTTP_ERROR_TIMED_OUT);
+    REQUIRE(status.completions == 1);
+
+    Result headers;
+    aPool.setTimeouts(1000, 40, 1000);
+    REQUIRE(aPool.startRequest("/delay/0/100/0", "GET", onComplete, onBody, &headers) >= 0);
+    pollAll(aPool);
+    REQUIRE(headers.status == HTTP_ERROR_TIMED_OUT);
+
+    // the body deadline is reset by each part of the body
+    Result body;
+    aPool.setTimeouts(1000, 1000, 60);
+    REQUIRE(aPool.startRequest("/delay/0/0/30", "GET", onComplete, onBody, &body) >= 0);
+    pollAll(aPool);
+    REQUIRE(body.status == 200);
+    REQUIRE(body.bodyLength == kBodySize);
+
+    Result stalled;
+    aPool.setTimeouts(1000, 1000, 40);
+    REQUIRE(aPool.startRequest("/delay/0/0/100", "GET", onComplete, onBody, &stalled) >= 0);
+    pollAll(aPool);
+    REQUIRE(stalled.status == HTTP_ERROR_TIMED_OUT);
+    REQUIRE(stalled.bodyLength < kBodySize);
+
+    aPool.setTimeouts(1000, 1000, 1000);
+}
+
+static void testNoBodyCallback(HttpClientPool& aPool, HttpClient* const aClients[])
+{
+    Result result;
+    int request = aPool.startRequest("/delay/0/20/20", "GET", onComplete, NULL, &result);
+    REQUIRE(request >= 0);
+    while (aPool.busy(request))
+        aPool.poll();
+    // completed once the headers were read, the body is left to the sketch
+    REQUIRE(result.status == 200);
+    REQUIRE(aClients[request]->responseBody().length() == kBodySize);
+}
+
+static void testInvalidBody(HttpClientPool& aPool)
+{
+    Result result;
+    REQUIRE(aPool.startRequest("/bad-chunk", "GET", onComplete, onBody, &result) >= 0);
+    pollAll(aPool);
+    REQUIRE(result.status == HTTP_ERROR_INVALID_RESPONSE);
+    REQUIRE(result.completions == 1);
+}
+
+static void testCancel(HttpClientPool& aPool)
+{
+    Result result;
+    int request = aPool.startRequest("/delay/50/0/0", "GET", onComplete, onBody, &result);
+    REQUIRE(request >= 0);
+    aPool.poll();
+    aPool.cancel(request);
+    REQUIRE(!aPool.busy(request));
+    REQUIRE(aPool.outstanding() == 0);
+    LoopbackConnection::pause(100);
+    aPool.poll();
+    REQUIRE(result.completions == 0);
+}
+
+static void testPollResponseHeaders(uint16_t aPort)
+{
+    LoopbackClient client;
+    HttpClient http(client, "localhost", aPort);
+    http.connectionKeepAlive();
+
+    for (const char* path : {"/delay/20/20/0", "/delay/0/20/0/chunked"})
+    {
+        REQUIRE(http.get(path) == 0);
+        int status = 0;
+        int notYet = 0;
+        unsigned long start = millis();
+        while ((status = http.pollResponseHeaders()) == 0)
+        {
+            notYet++;
+            REQUIRE(millis() - start < 5000);
+        }
+        REQUIRE(status == 200);
+        // it returned while the server was still sending the headers
+        REQUIRE(notYet > 1);
+        REQUIRE(http.responseBody().length() == kBodySize);
+    }
+
+    // before the request is sent
+    HttpClient idle(client, "localhost", aPort);
+    REQUIRE(idle.pollResponseHeaders() == HTTP_ERROR_API);
+}
+
+int main()
+{
+    LoopbackServer server(serve);
+    LoopbackClient client1, client2, client3;
+    HttpClient http1(client1, "localhost", server.port());
+    HttpClient http2(client2, "localhost", server.port());
+    HttpClient http3(client3, "localhost", server.port());
+    HttpClient* const clients[] = {&http1, &http2, &http3};
+    HttpClientPool pool(clients, 3);
+
+    testConcurrentRequests(pool);
+    testTimeouts(pool);
+    testNoBodyCallback(pool, clients);
+    testInvalidBody(pool);
+    testCancel(pool);
+    testPollResponseHeaders(server.port());
+    return 0;
+}
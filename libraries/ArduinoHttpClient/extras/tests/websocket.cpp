@@ -0,0 +1,328 @@
+// WebSocketClient against an echo server which checks the client's masking,
+// and answers in fragments with pings and pongs between them
+// Released under Apache License, version 2.0
+
+#include <ArduinoHttpClient.h>
+#include <Loopback.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "check.h"
+
+static std::atomic<bool> answerPings(true);
+static std::atomic<int> pingsReceived(0);
+static std::atomic<int> pongsReceived(0);
+static std::atomic<int> closesReceived(0);
+// Whether the server masks the frames it sends, which clients must accept
+// although servers don't do it
+static std::atomic<bool> maskReplies(false);
+static std::mutex receivedMutex;
+static std::vector<std::string> received;
+static std::vector<uint32_t> maskKeys;
+
+static std::string frame(uint8_t aOpCode, const std::string& aPayload, bool aMasked = false)
+{
+    std::string f(1, (char)aOpCode);
+    uint8_t maskBit = aMasked ? 0x80 : 0;
+    if (aPayload.size() < 126)
+    {
+        f += (char)(maskBit | aPayload.size());
+    }
+    else if (aPayload.size() <= 0xffff)
+    {
+        f += (char)(maskBit | 126);
+        f += (char)(aPayload.size() >> 8);
+        f += (char)aPayload.size();
+    }
+    else
+    {
+        f += (char)(maskBit | 127);
+        for (int shift = 56; shift >= 0; shift -= 8)
+            f += (char)((uint64_t)aPayload.size() >> shift);
+    }
+    if (!aMasked)
+        return f + aPayload;
+
+    const char key[4] = {0x12, 0x34, 0x56, 0x78};
+    f.append(key, 4);
+    for (size_t i = 0; i < aPayload.size(); i++)
+        f += (char)(aPayload[i] ^ key[i & 3]);
+    return f;
+}
+
+static void serve(LoopbackConnection& aConnection)
+{
+    std::string request = aConnection.readRequest();
+    REQUIRE(request.find("GET /echo HTTP/1.1") == 0);
+    REQUIRE(request.find("\r\nUpgrade: websocket") != std::string::npos);
+    REQUIRE(request.find("\r\nSec-WebSocket-Version: 13") != std::string::npos);
+    REQUIRE(request.find("\r\nSec-WebSocket-Key: ") != std::string::npos);
+    // the headers trickle in
+    aConnection.send("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n\r\n", 5);
+
+    std::string message;
+    int messageType = 0;
+    for (;;)
+    {
+        std::string header;
+        if (!aConnection.readBytes(header, 2))
+            return;
+        uint8_t opCode = header[0];
+        // clients must mask everything they send
+        REQUIRE(header[1] & 0x80);
+        uint64_t length = header[1] & 0x7f;
+        if (length >= 126)
+        {
+            std::string extended;
+            REQUIRE(aConnection.readBytes(extended, length == 126 ? 2 : 8));
+            length = 0;
+            for (char c : extended)
+                length = (length << 8) | (uint8_t)c;
+        }
+        std::string key, payload;
+        REQUIRE(aConnection.readBytes(key, 4));
+        REQUIRE(aConnection.readBytes(payload, length));
+        for (size_t i = 0; i < payload.size(); i++)
+            payload[i] ^= key[i & 3];
+
+        int type = opCode & 0x0f;
+        if (type == TYPE_PING)
+        {
+            pingsReceived++;
+            REQUIRE(opCode & 0x80);
+            if (answerPings)
+                aConnection.send(frame(0x80 | TYPE_PONG, payload));
+            continue;
+        }
+        if (type == TYPE_PONG)
+        {
+            REQUIRE(payload == "hb!");
+            pongsReceived++;
+            continue;
+        }
+        if (type == TYPE_CONNECTION_CLOSE)
+        {
+            closesReceived++;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(receivedMutex);
+            uint32_t k;
+            memcpy(&k, key.data(), 4);
+            maskKeys.push_back(k);
+        }
+        if (type != TYPE_CONTINUATION)
+        {
+            // a new message can't start in the middle of one
+            REQUIRE(messageType == 0);
+            messageType = type;
+            message.clear();
+        }
+        else
+        {
+            REQUIRE(messageType != 0);
+        }
+        message += payload;
+        if (!(opCode & 0x80))
+            continue;
+
+        {
+            std::lock_guard<std::mutex> lock(receivedMutex);
+            received.push_back(message);
+        }
+        // echo it in three fragments, with a ping and a pong between them
+        size_t third = message.size() / 3;
+        bool masked = maskReplies;
+        std::string reply = frame(messageType, message.substr(0, third), masked) +
+                            frame(0x80 | TYPE_PING, "hb!") +
+                            frame(TYPE_CONTINUATION, message.substr(third, third), masked) +
+                            frame(0x80 | TYPE_PONG, "unsolicited") +
+                            frame(0x80 | TYPE_CONTINUATION, message.substr(2 * third), masked);
+        messageType = 0;
+        // small messages a few bytes at a time, so the frame headers are split
+        if (message.size() < 1000)
+            aConnection.send(reply, 3);
+        else
+            aConnection.send(reply, 1400);
+    }
+}
+
+static std::string pattern(size_t aLength, int aSeed)
+{
+    std::string s(aLength, '\0');
+    for (size_t i = 0; i < aLength; i++)
+        s[i] = (char)(i * 31 + aSeed);
+    return s;
+}
+
+static std::string lastReceived()
+{
+    std::lock_guard<std::mutex> lock(receivedMutex);
+    return received.back();
+}
+
+static uint8_t buffer[70000];
+
+static int waitForMessage(WebSocketClient& aClient, size_t aSize)
+{
+    unsigned long start = millis();
+    int ret;
+    while ((ret = aClient.pollMessage(buffer, aSize)) == 0)
+        REQUIRE(millis() - start < 3000);
+    return ret;
+}
+
+// Messages of all sizes, written in one go or in pieces, are sent masked and
+// in fragments, and come back whole
+static void testEcho(WebSocketClient& aClient)
+{
+    struct {
+        size_t size;
+        int writes;
+    } tests[] = {{0, 1}, {5, 1}, {125, 1}, {126, 1}, {127, 1}, {128, 1}, {129, 3},
+                 {1000, 7}, {10000, 1}, {66000, 1}, {20000, 333}};
+    for (bool masked : {false, true})
+    {
+        maskReplies = masked;
+        for (auto& test : tests)
+        {
+            std::string message = pattern(test.size, (int)test.size + masked);
+            REQUIRE(aClient.beginMessage(TYPE_BINARY) == 0);
+            size_t step = test.size / test.writes + 1;
+            for (size_t i = 0; i < test.size; i += step)
+            {
+                size_t length = std::min(step, test.size - i);
+                REQUIRE(aClient.write((const uint8_t*)message.data() + i, length) == length);
+            }
+            REQUIRE(aClient.endMessage() == 0);
+
+            REQUIRE(waitForMessage(aClient, sizeof(buffer)) == TYPE_BINARY);
+            REQUIRE(aClient.messageType() == TYPE_BINARY);
+            REQUIRE(aClient.messageLength() == test.size);
+            REQUIRE(std::string((const char*)buffer, test.size) == message);
+            REQUIRE(lastReceived() == message);
+        }
+    }
+    maskReplies = false;
+
+    // the server's pings were answered, between the fragments
+    for (int i = 0; i < 100 && pongsReceived < 22; i++)
+        LoopbackConnection::pause(5);
+    REQUIRE(pongsReceived == 22);
+
+    // a new mask for each frame
+    std::lock_guard<std::mutex> lock(receivedMutex);
+    std::vector<uint32_t> keys = maskKeys;
+    std::sort(keys.begin(), keys.end());
+    REQUIRE(std::unique(keys.begin(), keys.end()) - keys.begin() > (long)keys.size() * 9 / 10);
+}
+
+// A ping sent while a message is being sent goes between its fragments
+static void testPingBetweenFragments(WebSocketClient& aClient)
+{
+    int pings = pingsReceived;
+    std::string message = pattern(1000, 7);
+    REQUIRE(aClient.beginMessage(TYPE_TEXT) == 0);
+    REQUIRE(aClient.write((const uint8_t*)message.data(), 500) == 500);
+    REQUIRE(aClient.ping() == 0);
+    REQUIRE(aClient.write((const uint8_t*)message.data() + 500, 500) == 500);
+    REQUIRE(aClient.endMessage() == 0);
+    REQUIRE(waitForMessage(aClient, sizeof(buffer)) == TYPE_TEXT);
+    REQUIRE(std::string((const char*)buffer, aClient.messageLength()) == message);
+    REQUIRE(pingsReceived == pings + 1);
+}
+
+static void testTooLong(WebSocketClient& aClient)
+{
+    std::string message = pattern(3000, 1);
+    REQUIRE(aClient.beginMessage(TYPE_TEXT) == 0);
+    aClient.write((const uint8_t*)message.data(), message.size());
+    REQUIRE(aClient.endMessage() == 0);
+    REQUIRE(waitForMessage(aClient, 1024) == WS_ERROR_MESSAGE_TOO_LONG);
+
+    // the next one is fine
+    REQUIRE(aClient.beginMessage(TYPE_TEXT) == 0);
+    aClient.print("hello");
+    REQUIRE(aClient.endMessage() == 0);
+    REQUIRE(waitForMessage(aClient, 1024) == TYPE_TEXT);
+    REQUIRE(aClient.messageLength() == 5);
+    REQUIRE(memcmp(buffer, "hello", 5) == 0);
+}
+
+// The older API: parseMessage() and read() a frame at a time
+static void testParseMessage(WebSocketClient& aClient)
+{
+    for (bool masked : {false, true})
+    {
+        maskReplies = masked;
+        std::string message = "fragmented and " + std::string(masked ? "masked" : "not masked");
+        REQUIRE(aClient.beginMessage(TYPE_TEXT) == 0);
+        aClient.print(message.c_str());
+        REQUIRE(aClient.endMessage() == 0);
+
+        std::string got;
+        unsigned long start = millis();
+        for (;;)
+        {
+            REQUIRE(millis() - start < 3000);
+            int size = aClient.parseMessage();
+            if (size <= 0)
+                continue;
+            REQUIRE(aClient.messageType() == TYPE_TEXT);
+            // a byte at a time with read() and peek(), then the rest
+            int peeked = aClient.peek();
+            int c = aClient.read();
+            REQUIRE(c == peeked);
+            got += (char)c;
+            while (aClient.available())
+            {
+                uint8_t part[4];
+                int n = aClient.read(part, sizeof(part));
+                if (n > 0)
+                    got.append((const char*)part, n);
+            }
+            if (aClient.isFinal())
+                break;
+        }
+        REQUIRE(got == message);
+    }
+    maskReplies = false;
+}
+
+static void testKeepAlive(WebSocketClient& aClient)
+{
+    int pings = pingsReceived;
+    aClient.setKeepAlive(50, 100);
+    unsigned long start = millis();
+    while (millis() - start < 300)
+        REQUIRE(aClient.pollMessage(buffer, sizeof(buffer)) == 0);
+    REQUIRE(pingsReceived - pings >= 4);
+
+    // the server stops answering
+    answerPings = false;
+    start = millis();
+    int ret;
+    while ((ret = aClient.pollMessage(buffer, sizeof(buffer))) == 0)
+        REQUIRE(millis() - start < 1000);
+    REQUIRE(ret == HTTP_ERROR_TIMED_OUT);
+    REQUIRE(millis() - start >= 100);
+}
+
+int main()
+{
+    LoopbackServer server(serve);
+    LoopbackClient client;
+    WebSocketClient ws(client, "localhost", server.port());
+    REQUIRE(ws.begin("/echo") == 0);
+
+    testEcho(ws);
+    testPingBetweenFragments(ws);
+    testTooLong(ws);
+    testParseMessage(ws);
+    testKeepAlive(ws);
+    return 0;
+}
@@ -6,6 +6,9 @@
 #define ArduinoHttpClient_h
 
 #include "HttpClient.h"
+#include "HttpClientPool.h"
+#include "HttpCache.h"
+#include "HttpInflateStream.h"
 #include "WebSocketClient.h"
 #include "URLEncoder.h"
 
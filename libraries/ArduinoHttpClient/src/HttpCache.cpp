@@ -0,0 +1,121 @@
+// Library to simplify HTTP fetching on Arduino
+// Released under Apache License, version 2.0
+
+#include "HttpCache.h"
+
+// Size of the block the body is copied to the store in
+static const int kCacheBufferSize = 64;
+
+HttpCache::HttpCache(HttpClient& aClient, HttpCacheStore& aStore)
+ : iClient(aClient), iStore(aStore), iBodyLength(0)
+{
+    iETag[0] = '\0';
+    iLastModified[0] = '\0';
+    iCaptures[0].name = "ETag";
+    iCaptures[0].value = iETag;
+    iCaptures[0].valueSize = sizeof(iETag);
+    iCaptures[1].name = "Last-Modified";
+    iCaptures[1].value = iLastModified;
+    iCaptures[1].valueSize = sizeof(iLastModified);
+}
+
+int HttpCache::get(const char* aURLPath)
+{
+    iBodyLength = 0;
+    if (!iStore.loadValidators(iETag, iLastModified, sizeof(iETag)))
+    {
+        // Nothing cached, so it's an unconditional request
+        iETag[0] = '\0';
+        iLastModified[0] = '\0';
+    }
+
+    iClient.beginRequest();
+    int ret = iClient.get(aURLPath);
+    if (ret != HTTP_SUCCESS)
+    {
+        return ret;
+    }
+    if (iETag[0] != '\0')
+    {
+        iClient.sendHeader("If-None-Match", iETag);
+    }
+    if (iLastModified[0] != '\0')
+    {
+        iClient.sendHeader("If-Modified-Since", iLastModified);
+    }
+    iClient.endRequest();
+
+    // The validators have been sent, so their buffers can now receive those
+    // of the response
+    iClient.captureHeaders(iCaptures, 2);
+
+    ret = iClient.responseStatusCode();
+    if (ret >= 0)
+    {
+        int status = ret;
+        ret = iClient.skipResponseHeaders();
+        if (ret == HTTP_SUCCESS)
+        {
+            ret = status;
+            if (status == kStatusOK)
+            {
+                Print* body = iStore.beginBody();
+                ret = body ? storeBody(*body) : HTTP_ERROR_API;
+                if (ret == HTTP_SUCCESS)
+                {
+                    ret = iStore.commitBody(iETag, iLastModified) ? kStatusOK : HTTP_ERROR_API;
+                }
+                else if (body)
+                {
+                    iStore.abortBody();
+                }
+            }
+        }
+    }
+    // Don't let the client write into our buffers on its later requests
+    iClient.captureHeaders(NULL, 0);
+
+    if (ret < 0)
+    {
+        // Whatever is left of the response is in the way of the next one
+        iClient.stop();
+    }
+    return ret;
+}
+
+int HttpCache::storeBody(Print& aBody)
+{
+    uint8_t buffer[kCacheBufferSize];
+    unsigned long timeoutStart = millis();
+    while (!iClient.endOfBodyReached())
+    {
+        int n = iClient.read(buffer, sizeof(buffer));
+        if (n > 0)
+        {
+            if (aBody.write(buffer, n) != (size_t)n)
+            {
+                // Out of space
+                return HTTP_ERROR_API;
+            }
+            iBodyLength += n;
+            // We read something, reset the timeout counter
+            timeoutStart = millis();
+        }
+        else if (!iClient.connected() && !iClient.available())
+        {
+            // The server closed the connection, which only marks the end of
+            // the body if it didn't tell us where the body ends
+            if (iClient.isResponseChunked() || iClient.contentLength() != HttpClient::kNoContentLengthHeader)
+            {
+                return HTTP_ERROR_TIMED_OUT;
+            }
+            return HTTP_SUCCESS;
+        }
+        else if ((millis() - timeoutStart) >= iClient.httpResponseTimeout())
+        {
+            return HTTP_ERROR_TIMED_OUT;
+        }
+    }
+    // Bad chunk framing ends the body too, but not where the server meant
+    return iClient.responseBodyInvalid() ? HTTP_ERROR_INVALID_RESPONSE : HTTP_SUCCESS;
+}
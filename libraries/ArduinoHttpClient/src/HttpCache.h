@@ -0,0 +1,109 @@
+// Library to simplify HTTP fetching on Arduino
+// Released under Apache License, version 2.0
+
+#ifndef HttpCache_h
+#define HttpCache_h
+
+#include <Arduino.h>
+
+#include "HttpClient.h"
+
+#ifndef HTTP_CACHE_VALIDATOR_SIZE
+  #define HTTP_CACHE_VALIDATOR_SIZE 64
+#endif
+
+/** Where an HttpCache keeps the body of a resource along with its
+    validators (ETag and Last-Modified), e.g. in a file on flash.
+    The store decides what to keep: the body as received, or something
+    derived from it as it's written, such as a parsed binary image.
+*/
+class HttpCacheStore
+{
+public:
+    virtual ~HttpCacheStore() {};
+
+    /** Read the validators saved with the cached body
+      @param aETag         Buffer for the ETag, set to "" if there isn't one
+      @param aLastModified Buffer for the Last-Modified date, set to "" if
+                           there isn't one
+      @param aSize         Size of each of the buffers
+      @return true if there is a cached body, else false
+    */
+    virtual bool loadValidators(char* aETag, char* aLastModified, size_t aSize) = 0;
+
+    /** Start storing a new body.  The cached body must be kept until
+      commitBody() is called
+      @return Where to write the new body, or NULL if it can't be stored
+    */
+    virtual Print* beginBody() = 0;
+
+    /** Replace the cached body with the one written since beginBody()
+      @param aETag         ETag of the new body, "" if there isn't one
+      @param aLastModified Last-Modified date of the new body, "" if there
+                           isn't one
+      @return true if successful, else false
+    */
+    virtual bool commitBody(const char* aETag, const char* aLastModified) = 0;
+
+    /** Throw away the body written since beginBody() and keep the cached one
+    */
+    virtual void abortBody() = 0;
+};
+
+/** Fetches a resource with conditional GET requests.  The validators of the
+    cached copy are sent in If-None-Match and If-Modified-Since headers, so
+    when the resource hasn't changed the server answers 304 Not Modified
+    without a body, and the caller can keep using what it got from the cached
+    copy last time, without downloading or parsing it again.
+*/
+class HttpCache
+{
+public:
+    /** Create a cache for a resource
+      @param aClient HttpClient to make the requests with
+      @param aStore  Where to keep the body and its validators
+    */
+    HttpCache(HttpClient& aClient, HttpCacheStore& aStore);
+
+    /** Fetch the resource if it has changed since the cached copy was stored.
+      Uses captureHeaders() on the client, replacing any headers the sketch
+      had asked it to capture
+      @param aURLPath Url to request
+      @return kStatusOK (200) if a new body has been stored,
+              kStatusNotModified (304) if the cached copy is still current,
+              any other HTTP status code if the server returned something
+              else, in which case the headers have been read and the body is
+              left in the client, else an HTTP_ERROR_* error
+    */
+    int get(const char* aURLPath);
+    int get(const String& aURLPath)
+      { return get(aURLPath.c_str()); }
+
+    /** Return the number of body bytes received by the last get()
+    */
+    unsigned long bodyLength() { return iBodyLength; };
+
+    // Status codes returned by get() when it succeeds
+    static const int kStatusOK = 200;
+    static const int kStatusNotModified = 304;
+
+protected:
+    /** Copy the body of the response into the store
+      @return HTTP_SUCCESS if the whole body has been written, else
+              HTTP_ERROR_TIMED_OUT if it stopped arriving,
+              HTTP_ERROR_INVALID_RESPONSE if its chunk framing was bad, or
+              HTTP_ERROR_API if the store couldn't take it
+    */
+    int storeBody(Print& aBody);
+
+    HttpClient& iClient;
+    HttpCacheStore& iStore;
+    // Validators of the cached copy when the request is sent, then those of
+    // the response as they're captured
+    char iETag[HTTP_CACHE_VALIDATOR_SIZE];
+    char iLastModified[HTTP_CACHE_VALIDATOR_SIZE];
+    HttpHeaderCapture iCaptures[2];
+    unsigned long iBodyLength;
+};
+
+#endif
@@ -3,16 +3,30 @@
 // Released under Apache License, version 2.0
 
 #include "HttpClient.h"
-#include "b64.h"
+#include <Base64Codec.h>
+#include <limits.h>
+
+// Move along a header prefix if the next character matches it, ignoring case
+// @return The rest of the prefix, or NULL if it doesn't match (any more)
+static const char* matchHeaderPrefix(const char* aPrefix, char c)
+{
+    if (aPrefix && (tolower(*aPrefix) == tolower(c)))
+    {
+        return aPrefix + 1;
+    }
+    return NULL;
+}
 
 // Initialize constants
 const char* HttpClient::kUserAgent = "Arduino/2.2.0";
+const char* HttpClient::kStatusPrefix = "HTTP/*.* ";
 const char* HttpClient::kContentLengthPrefix = HTTP_HEADER_CONTENT_LENGTH ": ";
 const char* HttpClient::kTransferEncodingChunked = HTTP_HEADER_TRANSFER_ENCODING ": " HTTP_HEADER_VALUE_CHUNKED;
 
 HttpClient::HttpClient(Client& aClient, const char* aServerName, uint16_t aServerPort)
  : iClient(&aClient), iServerName(aServerName), iServerAddress(), iServerPort(aServerPort),
-   iConnectionClose(true), iSendDefaultRequestHeaders(true)
+   iConnectionClose(true), iSendDefaultRequestHeaders(true), iHeaderCaptures(NULL),
+   iHeaderCaptureCount(0)
 {
   resetState();
 }
@@ -24,7 +38,8 @@ HttpClient::HttpClient(Client& aClient, const String& aServerName, uint16_t aSer
 
 HttpClient::HttpClient(Client& aClient, const IPAddress& aServerAddress, uint16_t aServerPort)
  : iClient(&aClient), iServerName(NULL), iServerAddress(aServerAddress), iServerPort(aServerPort),
-   iConnectionClose(true), iSendDefaultRequestHeaders(true)
+   iConnectionClose(true), iSendDefaultRequestHeaders(true), iHeaderCaptures(NULL),
+   iHeaderCaptureCount(0)
 {
   resetState();
 }
@@ -33,12 +48,18 @@ void HttpClient::resetState()
 {
   iState = eIdle;
   iStatusCode = 0;
+  iStatusPtr = kStatusPrefix;
+  iStatusLineRead = false;
   iContentLength = kNoContentLengthHeader;
   iBodyLengthConsumed = 0;
   iContentLengthPtr = kContentLengthPrefix;
   iTransferEncodingChunkedPtr = kTransferEncodingChunked;
   iIsChunked = false;
   iChunkLength = 0;
+  iChunkLengthFound = false;
+  iChunkTrailerLineEmpty = false;
+  iChunkedBodyComplete = false;
+  iSendingChunkedBody = false;
   iHttpResponseTimeout = kHttpResponseTimeout;
   iHttpWaitForDataDelay = kHttpWaitForDataDelay;
 }
@@ -67,9 +88,13 @@ void HttpClient::beginRequest()
 int HttpClient::startRequest(const char* aURLPath, const char* aHttpMethod, 
                                 const char* aContentType, int aContentLength, const byte aBody[])
 {
-    if (iState == eReadingBody || iState == eReadingChunkLength || iState == eReadingBodyChunk)
+    if (endOfHeadersReached())
     {
-        flushClientRx();
+        if (!endOfBodyReached())
+        {
+            // Throw away the rest of the previous response
+            flushClientRx();
+        }
 
         resetState();
     }
@@ -208,55 +233,35 @@ void HttpClient::sendBasicAuth(const char* aUser, const char* aPassword)
 {
     // Send the initial part of this header line
     iClient->print("Authorization: Basic ");
-    // Now Base64 encode "aUser:aPassword" and send that
-    // This seems trickier than it should be but it's mostly to avoid either
-    // (a) some arbitrarily sized buffer which hopes to be big enough, or
-    // (b) allocating and freeing memory
-    // ...so we'll loop through 3 bytes at a time, outputting the results as we
-    // go.
-    // In Base64, each 3 bytes of unencoded data become 4 bytes of encoded data
-    unsigned char input[3];
-    unsigned char output[5]; // Leave space for a '\0' terminator so we can easily print
-    int userLen = strlen(aUser);
-    int passwordLen = strlen(aPassword);
-    int inputOffset = 0;
-    for (int i = 0; i < (userLen+1+passwordLen); i++)
-    {
-        // Copy the relevant input byte into the input
-        if (i < userLen)
-        {
-            input[inputOffset++] = aUser[i];
-        }
-        else if (i == userLen)
-        {
-            input[inputOffset++] = ':';
-        }
-        else
-        {
-            input[inputOffset++] = aPassword[i-(userLen+1)];
-        }
-        // See if we've got a chunk to encode
-        if ( (inputOffset == 3) || (i == userLen+passwordLen) )
-        {
-            // We've either got to a 3-byte boundary, or we've reached then end
-            b64_encode(input, inputOffset, output, 4);
-            // NUL-terminate the output string
-            output[4] = '\0';
-            // And write it out
-            iClient->print((char*)output);
-// FIXME We might want to fill output with '=' characters if b64_encode doesn't
-// FIXME do it for us when we're encoding the final chunk
-            inputOffset = 0;
-        }
-    }
+    // Now Base64 encode "aUser:aPassword" and send that, a piece at a time
+    // so that we don't need a buffer big enough for the whole thing
+    Base64Encoder encoder;
+    sendBase64(encoder, (const uint8_t*)aUser, strlen(aUser));
+    sendBase64(encoder, (const uint8_t*)":", 1);
+    sendBase64(encoder, (const uint8_t*)aPassword, strlen(aPassword));
+    char output[Base64Encoder::kEndLength];
+    iClient->write((const uint8_t*)output, encoder.end(output));
     // And end the header we've sent
     iClient->println();
 }
 
+void HttpClient::sendBase64(Base64Encoder& aEncoder, const uint8_t* aData, size_t aLength)
+{
+    char output[32];
+    while (aLength > 0)
+    {
+        // Each 3 bytes of input become 4 characters
+        size_t len = min(aLength, (sizeof(output) / 4) * 3);
+        iClient->write((const uint8_t*)output, aEncoder.update(aData, len, output));
+        aData += len;
+        aLength -= len;
+    }
+}
+
 void HttpClient::finishHeaders()
 {
     iClient->println();
-    iState = eRequestSent;
+    restartStatusLine();
 }
 
 void HttpClient::flushClientRx()
@@ -282,6 +287,54 @@ void HttpClient::beginBody()
     // else the end of headers has already been sent, so nothing to do here
 }
 
+int HttpClient::beginChunkedBody()
+{
+    if (iState >= eRequestSent)
+    {
+        // Too late to send the Transfer-Encoding header
+        return HTTP_ERROR_API;
+    }
+    sendHeader(HTTP_HEADER_TRANSFER_ENCODING, HTTP_HEADER_VALUE_CHUNKED);
+    finishHeaders();
+    iSendingChunkedBody = true;
+    return HTTP_SUCCESS;
+}
+
+void HttpClient::endChunkedBody()
+{
+    if (iSendingChunkedBody)
+    {
+        // The zero-length last chunk, and an empty trailer
+        iClient->print("0\r\n\r\n");
+        iSendingChunkedBody = false;
+    }
+}
+
+size_t HttpClient::write(const uint8_t *aBuffer, size_t aSize)
+{
+    if (iState < eRequestSent)
+    {
+        finishHeaders();
+    }
+
+    if (!iSendingChunkedBody)
+    {
+        return iClient->write(aBuffer, aSize);
+    }
+
+    if (aSize == 0)
+    {
+        // Don't send a zero-length chunk, it would end the body
+        return 0;
+    }
+    // Send the buffer as one chunk
+    iClient->print((unsigned long)aSize, HEX);
+    iClient->print("\r\n");
+    size_t ret = iClient->write(aBuffer, aSize);
+    iClient->print("\r\n");
+    return ret;
+}
+
 int HttpClient::get(const char* aURLPath)
 {
     return startRequest(aURLPath, HTTP_METHOD_GET);
@@ -392,12 +445,73 @@ int HttpClient::del(const char* aURLPath, const char* aContentType, int aContent
     return startRequest(aURLPath, HTTP_METHOD_DELETE, aContentType, aContentLength, aBody);
 }
 
+void HttpClient::restartStatusLine()
+{
+    iStatusCode = 0;
+    iState = eRequestSent;
+    iStatusPtr = kStatusPrefix;
+    iStatusLineRead = false;
+
+    // Forget the headers captured from the previous response
+    resetHeaderCaptures();
+}
+
+int HttpClient::parseStatusLine(int c)
+{
+    switch(iState)
+    {
+    case eRequestSent:
+        // We haven't reached the status code yet
+        // Psuedo-regexp we're expecting before the status-code is kStatusPrefix
+        if ( (*iStatusPtr == '*') || (*iStatusPtr == c) )
+        {
+            // This character matches, just move along
+            iStatusPtr++;
+            if (*iStatusPtr == '\0')
+            {
+                // We've reached the end of the prefix
+                iState = eReadingStatusCode;
+            }
+        }
+        else
+        {
+            return HTTP_ERROR_INVALID_RESPONSE;
+        }
+        break;
+    case eReadingStatusCode:
+        if (isdigit(c))
+        {
+            // This assumes we won't get more than the 3 digits we
+            // want
+            iStatusCode = iStatusCode*10 + (c - '0');
+        }
+        else
+        {
+            // We've reached the end of the status code
+            // We could sanity check it here or double-check for ' '
+            // rather than anything else, but let's be lenient
+            iState = eStatusCodeRead;
+        }
+        break;
+    case eStatusCodeRead:
+        // We're just waiting for the end of the line now
+        break;
+
+    default:
+        break;
+    };
+    return HTTP_SUCCESS;
+}
+
 int HttpClient::responseStatusCode()
 {
     if (iState < eRequestSent)
     {
         return HTTP_ERROR_API;
     }
+    // Finish off the request body, if it's chunked and still open
+    endChunkedBody();
+
     // The first line will be of the form Status-Line:
     //   HTTP-Version SP Status-Code SP Reason-Phrase CRLF
     // Where HTTP-Version is of the form:
@@ -409,13 +523,9 @@ int HttpClient::responseStatusCode()
         // Make sure the status code is reset, and likewise the state.  This
         // lets us easily cope with 1xx informational responses by just
         // ignoring them really, and reading the next line for a proper response
-        iStatusCode = 0;
-        iState = eRequestSent;
+        restartStatusLine();
 
         unsigned long timeoutStart = millis();
-        // Psuedo-regexp we're expecting before the status-code
-        const char* statusPrefix = "HTTP/*.* ";
-        const char* statusPtr = statusPrefix;
         // Whilst we haven't timed out & haven't reached the end of the headers
         while ((c != '\n') && 
                ( (millis() - timeoutStart) < iHttpResponseTimeout ))
@@ -425,47 +535,10 @@ int HttpClient::responseStatusCode()
                 c = HttpClient::read();
                 if (c != -1)
                 {
-                    switch(iState)
+                    if (parseStatusLine(c) != HTTP_SUCCESS)
                     {
-                    case eRequestSent:
-                        // We haven't reached the status code yet
-                        if ( (*statusPtr == '*') || (*statusPtr == c) )
-                        {
-                            // This character matches, just move along
-                            statusPtr++;
-                            if (*statusPtr == '\0')
-                            {
-                                // We've reached the end of the prefix
-                                iState = eReadingStatusCode;
-                            }
-                        }
-                        else
-                        {
-                            return HTTP_ERROR_INVALID_RESPONSE;
-                        }
-                        break;
-                    case eReadingStatusCode:
-                        if (isdigit(c))
-                        {
-                            // This assumes we won't get more than the 3 digits we
-                            // want
-                            iStatusCode = iStatusCode*10 + (c - '0');
-                        }
-                        else
-                        {
-                            // We've reached the end of the status code
-                            // We could sanity check it here or double-check for ' '
-                            // rather than anything else, but let's be lenient
-                            iState = eStatusCodeRead;
-                        }
-                        break;
-                    case eStatusCodeRead:
-                        // We're just waiting for the end of the line now
-                        break;
-
-                    default:
-                        break;
-                    };
+                        return HTTP_ERROR_INVALID_RESPONSE;
+                    }
                     // We read something, reset the timeout counter
                     timeoutStart = millis();
                 }
@@ -490,6 +563,7 @@ int HttpClient::responseStatusCode()
     if ( (c == '\n') && (iState == eStatusCodeRead) )
     {
         // We've read the status-line successfully
+        iStatusLineRead = true;
         return iStatusCode;
     }
     else if (c != '\n')
@@ -505,6 +579,51 @@ int HttpClient::responseStatusCode()
     }
 }
 
+int HttpClient::pollResponseHeaders()
+{
+    if (iState < eRequestSent)
+    {
+        return HTTP_ERROR_API;
+    }
+    // Finish off the request body, if it's chunked and still open
+    endChunkedBody();
+
+    // Only deal with what has already arrived, we don't wait for more
+    while (!endOfHeadersReached() && iClient->available())
+    {
+        if (iStatusLineRead)
+        {
+            (void)readHeader();
+            continue;
+        }
+
+        int c = HttpClient::read();
+        if (parseStatusLine(c) != HTTP_SUCCESS)
+        {
+            return HTTP_ERROR_INVALID_RESPONSE;
+        }
+        if (c == '\n')
+        {
+            if (iState != eStatusCodeRead)
+            {
+                // This wasn't a properly formed status line
+                return HTTP_ERROR_INVALID_RESPONSE;
+            }
+            if (iStatusCode < 200 && iStatusCode != 101)
+            {
+                // An informational (1xx) status line, the real one follows
+                restartStatusLine();
+            }
+            else
+            {
+                iStatusLineRead = true;
+            }
+        }
+    }
+
+    return endOfHeadersReached() ? iStatusCode : 0;
+}
+
 int HttpClient::skipResponseHeaders()
 {
     // Just keep reading until we finish reading the headers or time out
@@ -515,7 +634,12 @@ int HttpClient::skipResponseHeaders()
     {
         if (available())
         {
-            (void)readHeader();
+            // Read everything that has arrived before looking at the clock again
+            do
+            {
+                (void)readHeader();
+            }
+            while (!endOfHeadersReached() && available());
             // We read something, reset the timeout counter
             timeoutStart = millis();
         }
@@ -540,7 +664,9 @@ int HttpClient::skipResponseHeaders()
 
 bool HttpClient::endOfHeadersReached()
 {
-    return (iState == eReadingBody || iState == eReadingChunkLength || iState == eReadingBodyChunk);
+    return (iState == eReadingBody || iState == eReadingChunkLength || iState == eReadingBodyChunk ||
+            iState == eSkipChunkExtension || iState == eReadingChunkTrailer ||
+            iState == eChunkFramingError);
 };
 
 long HttpClient::contentLength()
@@ -568,23 +694,57 @@ String HttpClient::responseBody()
         }
     }
 
-    // keep on timedRead'ing, until:
-    //  - we have a content length: body length equals consumed or no bytes
-    //                              available
-    //  - no content length:        no bytes are available
-    while (iBodyLengthConsumed != bodyLength)
+    // Read the body a block at a time, until:
+    //  - we have a content length: body length equals consumed
+    //  - the body is chunked:      the last chunk has been read
+    //  - otherwise:                the server closes the connection
+    // or no more bytes arrive within the timeout
+    char buffer[kHttpBodyBufferSize + 1]; // Leave space for a '\0' terminator
+    unsigned long timeoutStart = millis();
+    while (!endOfBodyReached())
     {
-        int c = timedRead();
+        int n = read((uint8_t*)buffer, kHttpBodyBufferSize);
 
-        if (c == -1) {
+        if (n > 0)
+        {
+            buffer[n] = '\0';
+            if (strlen(buffer) == (size_t)n)
+            {
+                if (!response.concat(buffer)) {
+                    // adding block failed
+                    return String((const char*)NULL);
+                }
+            }
+            else
+            {
+                // The block contains a '\0', add it a char at a time so we
+                // don't lose what follows
+                for (int i = 0; i < n; i++)
+                {
+                    if (!response.concat(buffer[i])) {
+                        // adding char failed
+                        return String((const char*)NULL);
+                    }
+                }
+            }
+            // We read something, reset the timeout counter
+            timeoutStart = millis();
+        }
+        else if (!iClient->connected() && !iClient->available())
+        {
+            // The server closed the connection, done
+            break;
+        }
+        else if ((millis() - timeoutStart) >= _timeout)
+        {
             // read timed out, done
             break;
         }
+    }
 
-        if (!response.concat((char)c)) {
-            // adding char failed
-            return String((const char*)NULL);
-        }
+    if (iState == eChunkFramingError) {
+        // failure, the body was cut short by invalid chunk framing
+        return String((const char*)NULL);
     }
 
     if (bodyLength > 0 && (unsigned int)bodyLength != response.length()) {
@@ -597,55 +757,148 @@ String HttpClient::responseBody()
 
 bool HttpClient::endOfBodyReached()
 {
-    if (endOfHeadersReached() && (contentLength() != kNoContentLengthHeader))
+    if (endOfHeadersReached())
     {
-        // We've got to the body and we know how long it will be
-        return (iBodyLengthConsumed >= contentLength());
+        if (iIsChunked)
+        {
+            // We've reached the end when we've read the zero-length chunk and
+            // the trailer that follows it, or when the framing was invalid
+            return iChunkedBodyComplete || iState == eChunkFramingError;
+        }
+        if (iContentLength != kNoContentLengthHeader)
+        {
+            // We've got to the body and we know how long it will be
+            return (iBodyLengthConsumed >= iContentLength);
+        }
     }
     return false;
 }
 
-int HttpClient::available()
+void HttpClient::readChunkFraming()
 {
-    if (iState == eReadingChunkLength)
+    // Consume whatever chunk framing has arrived, stopping at the start of the
+    // next chunk's data or at the end of the body
+    while ((iState != eReadingBodyChunk) && !iChunkedBodyComplete && iClient->available())
     {
-        while (iClient->available())
-        {
-            char c = iClient->read();
+        int c = iClient->read();
 
+        switch(iState)
+        {
+        case eReadingChunkLength:
+            if (isHexadecimalDigit(c))
+            {
+                int digit = (c <= '9') ? (c - '0') : ((c | 0x20) - 'a' + 10);
+                if (iChunkLength > (LONG_MAX - digit) / 16)
+                {
+                    // Too long to count, we couldn't find the next chunk
+                    chunkFramingError();
+                    return;
+                }
+                iChunkLength = iChunkLength*16 + digit;
+                iChunkLengthFound = true;
+            }
+            else if (c == '\n')
+            {
+                endOfChunkSizeLine();
+            }
+            else if (c == ';' || c == ' ' || c == '\t')
+            {
+                // The start of a chunk extension (";name=value"), or some
+                // whitespace before it. We don't use them
+                iState = eSkipChunkExtension;
+            }
+            else if (c != '\r')
+            {
+                chunkFramingError();
+                return;
+            }
+            break;
+        case eSkipChunkExtension:
             if (c == '\n')
             {
-                iState = eReadingBodyChunk;
-                break;
+                endOfChunkSizeLine();
             }
-            else if (c == '\r')
+            break;
+        case eReadingChunkTrailer:
+            // Trailer header lines until an empty line. We don't use them
+            if (c == '\n')
             {
-                // no-op
+                if (iChunkTrailerLineEmpty)
+                {
+                    iChunkedBodyComplete = true;
+                }
+                iChunkTrailerLineEmpty = true;
             }
-            else if (isHexadecimalDigit(c))
+            else if (c != '\r')
             {
-                char digit[2] = {c, '\0'};
-
-                iChunkLength = (iChunkLength * 16) + strtol(digit, NULL, 16);
+                iChunkTrailerLineEmpty = false;
             }
-        }
+            break;
+        default:
+            break;
+        };
     }
+}
 
-    if (iState == eReadingBodyChunk && iChunkLength == 0)
+void HttpClient::endOfChunkSizeLine()
+{
+    if (!iChunkLengthFound && iState == eSkipChunkExtension)
+    {
+        // A chunk extension without a chunk size
+        chunkFramingError();
+        return;
+    }
+    if (!iChunkLengthFound)
     {
+        // This is the CRLF following the previous chunk's data, the
+        // chunk-size line comes next
         iState = eReadingChunkLength;
     }
-    
-    if (iState == eReadingChunkLength)
+    else if (iChunkLength == 0)
     {
-        return 0;
+        // The zero-length chunk marks the end of the body data, only the
+        // trailer is left
+        iState = eReadingChunkTrailer;
+        iChunkTrailerLineEmpty = true;
     }
-    
+    else
+    {
+        iState = eReadingBodyChunk;
+    }
+    iChunkLengthFound = false;
+}
+
+void HttpClient::chunkFramingError()
+{
+    // Whatever follows can't be told apart from the body, so the connection
+    // can't be used for another request either
+    iState = eChunkFramingError;
+    iClient->stop();
+}
+
+int HttpClient::available()
+{
+    if (iIsChunked && endOfHeadersReached())
+    {
+        if (iState != eReadingBodyChunk)
+        {
+            readChunkFraming();
+            if (iState != eReadingBodyChunk)
+            {
+                return 0;
+            }
+        }
+        int clientAvailable = iClient->available();
+        return (clientAvailable < iChunkLength) ? clientAvailable : (int)iChunkLength;
+    }
+
     int clientAvailable = iClient->available();
 
-    if (iState == eReadingBodyChunk)
+    if (iState == eReadingBody && iContentLength != kNoContentLengthHeader)
     {
-        return min(clientAvailable, iChunkLength);
+        // Don't report the bytes that follow the body, they aren't ours
+        long bodyRemaining = iContentLength - iBodyLengthConsumed;
+        return (clientAvailable < bodyRemaining) ? clientAvailable : (int)bodyRemaining;
     }
     else
     {
@@ -656,11 +909,35 @@ int HttpClient::available()
 
 int HttpClient::read()
 {
-    if (iIsChunked && !available())
+    if (endOfBodyReached())
     {
         return -1;
     }
 
+    if (iIsChunked && endOfHeadersReached())
+    {
+        if (iState != eReadingBodyChunk)
+        {
+            readChunkFraming();
+            if (iState != eReadingBodyChunk)
+            {
+                return -1;
+            }
+        }
+
+        int ret = iClient->read();
+        if (ret >= 0)
+        {
+            iChunkLength--;
+
+            if (iChunkLength == 0)
+            {
+                iState = eReadingChunkLength;
+            }
+        }
+        return ret;
+    }
+
     int ret = iClient->read();
     if (ret >= 0)
     {
@@ -670,18 +947,109 @@ int HttpClient::read()
             // So keep track of how many bytes are left
             iBodyLengthConsumed++;
         }
+    }
+    return ret;
+}
+
+int HttpClient::captureHeaders(HttpHeaderCapture aHeaders[], int aCount)
+{
+    if (aCount < 0 || aCount > kMaxHeaderCaptures || (aCount > 0 && aHeaders == NULL))
+    {
+        return HTTP_ERROR_API;
+    }
+    iHeaderCaptures = aHeaders;
+    iHeaderCaptureCount = aCount;
+    resetHeaderCaptures();
+    return HTTP_SUCCESS;
+}
 
-        if (iState == eReadingBodyChunk)
+void HttpClient::resetHeaderCaptures()
+{
+    for (int i = 0; i < iHeaderCaptureCount; i++)
+    {
+        iHeaderCaptures[i].found = false;
+        if (iHeaderCaptures[i].valueSize > 0)
         {
-            iChunkLength--;
+            iHeaderCaptures[i].value[0] = '\0';
+        }
+    }
+    iCaptureCandidates = allHeaderCaptures();
+    iCaptureNamePos = 0;
+    iCaptureIndex = -1;
+}
 
-            if (iChunkLength == 0)
+void HttpClient::captureHeaderCharacter(char c)
+{
+    if (c == '\n')
+    {
+        if (iCaptureIndex >= 0)
+        {
+            // Trim any trailing whitespace from the value
+            HttpHeaderCapture& header = iHeaderCaptures[iCaptureIndex];
+            while (iCaptureValueLength > 0 && isSpace(header.value[iCaptureValueLength-1]))
             {
-                iState = eReadingChunkLength;
+                header.value[--iCaptureValueLength] = '\0';
             }
         }
+        // Start matching the next header name
+        iCaptureCandidates = allHeaderCaptures();
+        iCaptureNamePos = 0;
+        iCaptureIndex = -1;
+        return;
     }
-    return ret;
+
+    if (iCaptureIndex >= 0)
+    {
+        // We're in the value of a header we want
+        HttpHeaderCapture& header = iHeaderCaptures[iCaptureIndex];
+        if ((c == '\r') || ((iCaptureValueLength == 0) && isSpace(c)))
+        {
+            // Skip the CR and the leading whitespace
+            return;
+        }
+        if (iCaptureValueLength + 1 < header.valueSize)
+        {
+            header.value[iCaptureValueLength++] = c;
+            header.value[iCaptureValueLength] = '\0';
+        }
+        // else it doesn't fit, drop the rest
+        return;
+    }
+
+    if (iCaptureCandidates == 0)
+    {
+        // Not a header we want, nothing to do until the end of the line
+        return;
+    }
+
+    char lowerC = tolower(c);
+    for (int i = 0; i < iHeaderCaptureCount; i++)
+    {
+        uint16_t bit = (uint16_t)(1U << i);
+        if (!(iCaptureCandidates & bit))
+        {
+            continue;
+        }
+        char expected = iHeaderCaptures[i].name[iCaptureNamePos];
+        if (c == ':' && expected == '\0')
+        {
+            // We've matched the whole name, the value comes next
+            iCaptureIndex = i;
+            iCaptureValueLength = 0;
+            if (iHeaderCaptures[i].valueSize > 0)
+            {
+                iHeaderCaptures[i].value[0] = '\0';
+            }
+            iHeaderCaptures[i].found = true;
+            iCaptureCandidates = 0;
+            return;
+        }
+        if (tolower(expected) != lowerC || expected == '\0')
+        {
+            iCaptureCandidates &= ~bit;
+        }
+    }
+    iCaptureNamePos++;
 }
 
 bool HttpClient::headerAvailable()
@@ -748,16 +1116,70 @@ String HttpClient::readHeaderValue()
 
 int HttpClient::read(uint8_t *buf, size_t size)
 {
-    int ret =iClient->read(buf, size);
-    if (endOfHeadersReached() && iContentLength > 0)
+    if (!endOfHeadersReached())
     {
-        // We're outputting the body now and we've seen a Content-Length header
-        // So keep track of how many bytes are left
-        if (ret >= 0)
+        return iClient->read(buf, size);
+    }
+
+    if (iIsChunked)
+    {
+        // Hand out the data of as many chunks as have arrived, never the
+        // framing between them
+        size_t total = 0;
+        while (total < size)
+        {
+            if (iState != eReadingBodyChunk)
+            {
+                readChunkFraming();
+                if (iState != eReadingBodyChunk)
+                {
+                    break;
+                }
+            }
+
+            size_t wanted = size - total;
+            if (wanted > (unsigned long)iChunkLength)
+            {
+                wanted = iChunkLength;
+            }
+            int ret = iClient->read(buf + total, wanted);
+            if (ret <= 0)
+            {
+                break;
+            }
+            total += ret;
+            iChunkLength -= ret;
+
+            if (iChunkLength == 0)
+            {
+                iState = eReadingChunkLength;
+            }
+        }
+        return total;
+    }
+
+    // Don't read past what's left of the body, so that we never hand out the
+    // start of the next response on the connection
+    if (endOfBodyReached())
+    {
+        return 0;
+    }
+    if (iContentLength != kNoContentLengthHeader)
+    {
+        long bodyRemaining = iContentLength - iBodyLengthConsumed;
+        if (size > (unsigned long)bodyRemaining)
         {
-            iBodyLengthConsumed += ret;
+            size = bodyRemaining;
         }
     }
+
+    int ret = iClient->read(buf, size);
+    if (ret > 0 && iContentLength > 0)
+    {
+        // We're outputting the body now and we've seen a Content-Length header
+        // So keep track of how many bytes are left
+        iBodyLengthConsumed += ret;
+    }
     return ret;
 }
 
@@ -772,50 +1194,56 @@ int HttpClient::readHeader()
         return c;
     }
 
+    if (iHeaderCaptureCount > 0)
+    {
+        captureHeaderCharacter(c);
+    }
+
     // Whilst reading out the headers to whoever wants them, we'll keep an
     // eye out for the "Content-Length" header
     switch(iState)
     {
     case eStatusCodeRead:
+    {
         // We're at the start of a line, or somewhere in the middle of reading
-        // the Content-Length prefix
-        if (*iContentLengthPtr == c)
+        // the Content-Length or Transfer Encoding chunked prefixes.  Header
+        // names are case-insensitive, so a character can match both of them,
+        // keep track of each one separately (NULL once it doesn't match)
+        bool lineStart = (iContentLengthPtr == kContentLengthPrefix) && (iTransferEncodingChunkedPtr == kTransferEncodingChunked);
+        iContentLengthPtr = matchHeaderPrefix(iContentLengthPtr, c);
+        iTransferEncodingChunkedPtr = matchHeaderPrefix(iTransferEncodingChunkedPtr, c);
+        if (iContentLengthPtr && (*iContentLengthPtr == '\0'))
         {
-            // This character matches, just move along
-            iContentLengthPtr++;
-            if (*iContentLengthPtr == '\0')
-            {
-                // We've reached the end of the prefix
-                iState = eReadingContentLength;
-                // Just in case we get multiple Content-Length headers, this
-                // will ensure we just get the value of the last one
-                iContentLength = 0;
-                iBodyLengthConsumed = 0;
-            }
+            // We've reached the end of the prefix
+            iState = eReadingContentLength;
+            // Just in case we get multiple Content-Length headers, this
+            // will ensure we just get the value of the last one
+            iContentLength = 0;
+            iBodyLengthConsumed = 0;
         }
-        else if (*iTransferEncodingChunkedPtr == c)
+        else if (iTransferEncodingChunkedPtr && (*iTransferEncodingChunkedPtr == '\0'))
         {
-            // This character matches, just move along
-            iTransferEncodingChunkedPtr++;
-            if (*iTransferEncodingChunkedPtr == '\0')
+            // We've reached the end of the Transfer Encoding: chunked header
+            iIsChunked = true;
+            iState = eSkipToEndOfHeader;
+        }
+        else if (!iContentLengthPtr && !iTransferEncodingChunkedPtr)
+        {
+            if (lineStart && (c == '\r'))
             {
-                // We've reached the end of the Transfer Encoding: chunked header
-                iIsChunked = true;
+                // We've found a '\r' at the start of a line, so this is probably
+                // the end of the headers
+                iState = eLineStartingCRFound;
+            }
+            else
+            {
+                // This isn't the Content-Length or Transfer Encoding chunked header, skip to the end of the line
                 iState = eSkipToEndOfHeader;
             }
         }
-        else if (((iContentLengthPtr == kContentLengthPrefix) && (iTransferEncodingChunkedPtr == kTransferEncodingChunked)) && (c == '\r'))
-        {
-            // We've found a '\r' at the start of a line, so this is probably
-            // the end of the headers
-            iState = eLineStartingCRFound;
-        }
-        else
-        {
-            // This isn't the Content-Length or Transfer Encoding chunked header, skip to the end of the line
-            iState = eSkipToEndOfHeader;
-        }
+        // else this character matches, just move along
         break;
+    }
     case eReadingContentLength:
         if (isdigit(c))
         {
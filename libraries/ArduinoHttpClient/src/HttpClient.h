@@ -36,8 +36,25 @@ static const int HTTP_ERROR_INVALID_RESPONSE =-4;
 #define HTTP_HEADER_CONNECTION     "Connection"
 #define HTTP_HEADER_TRANSFER_ENCODING "Transfer-Encoding"
 #define HTTP_HEADER_USER_AGENT     "User-Agent"
+#define HTTP_HEADER_ACCEPT_ENCODING  "Accept-Encoding"
+#define HTTP_HEADER_CONTENT_ENCODING "Content-Encoding"
 #define HTTP_HEADER_VALUE_CHUNKED  "chunked"
 
+/** A response header to keep, see HttpClient::captureHeaders()
+*/
+typedef struct {
+    // Name of the header, matched case-insensitively
+    const char* name;
+    // Buffer for the value, which is NUL terminated and truncated to fit
+    char* value;
+    // Size of the value buffer
+    size_t valueSize;
+    // Set if the header was in the response
+    bool found;
+} HttpHeaderCapture;
+
+class Base64Encoder;
+
 class HttpClient : public Client
 {
 public:
@@ -45,6 +62,8 @@ public:
     static const int kHttpPort =80;
     static const int kHttpsPort =443;
     static const char* kUserAgent;
+    // Maximum number of headers captureHeaders() can keep
+    static const int kMaxHeaderCaptures = 16;
 
 // FIXME Write longer API request, using port and user-agent, example
 // FIXME Update tempToPachube example to calculate Content-Length correctly
@@ -72,6 +91,22 @@ public:
     */
     void beginBody();
 
+    /** Start a chunked body for a more complex request.
+        Use this instead of beginBody() to stream a body whose length isn't
+        known in advance: it sends the Transfer-Encoding header and ends the
+        headers, then each call to write() (or print(), etc.) is sent as one
+        chunk. Call endChunkedBody() when you are finished; responseStatusCode()
+        will do it if you haven't.
+        MUST be called before the end of the headers, i.e. after
+        beginRequest() and post() (or put(), etc.), and any calls to sendHeader()
+      @return 0 if successful, else error
+    */
+    int beginChunkedBody();
+
+    /** End the chunked body started with beginChunkedBody()
+    */
+    void endChunkedBody();
+
     /** Connect to the server and start to send a GET request.
       @param aURLPath     Url to request
       @return 0 if successful, else error
@@ -217,6 +252,38 @@ public:
     */
     int responseStatusCode();
 
+    /** Read as much of the status line and the response headers as has
+      arrived, without waiting for more.
+      This is the non-blocking alternative to calling responseStatusCode() and
+      then skipResponseHeaders(): call it repeatedly (e.g. from loop()) until
+      it returns something other than 0, then read the body as usual.
+      MUST be called after the request has been sent
+      @return The HTTP status code once all the headers have been read, 0 if
+      they haven't all arrived yet, else error
+    */
+    int pollResponseHeaders();
+
+    /** Keep the values of some response headers, without allocating memory.
+      The header names are matched case-insensitively while the headers are
+      read (by skipResponseHeaders(), pollResponseHeaders(), contentLength(),
+      headerAvailable(), etc.), and the values of the ones which match are
+      copied into their buffers.  The other headers are discarded.
+      The list stays in use for the following requests, until this is called
+      again, so it MUST stay valid until then.
+      For example:
+        char etag[40];
+        char date[32];
+        HttpHeaderCapture headers[] = {
+          { "ETag", etag, sizeof(etag) },
+          { "Date", date, sizeof(date) }
+        };
+        client.captureHeaders(headers, 2);
+      @param aHeaders Headers to keep
+      @param aCount   Number of headers, up to kMaxHeaderCaptures (0 to stop)
+      @return 0 if successful, else error
+    */
+    int captureHeaders(HttpHeaderCapture aHeaders[], int aCount);
+
     /** Check if a header is available to be read.
       Use readHeaderName() to read header name, and readHeaderValue() to
       read the header value
@@ -260,7 +327,8 @@ public:
     bool endOfHeadersReached();
 
     /** Test whether the end of the body has been reached.
-      Only works if the Content-Length header was returned by the server
+      Only works if the Content-Length header was returned by the server, or if
+      the body is chunked
       @return true if we are now at the end of the body, else false
     */
     bool endOfBodyReached();
@@ -280,6 +348,14 @@ public:
     */
     int isResponseChunked() { return iIsChunked; }
 
+    /** Test whether the chunk framing of the response body was invalid, e.g.
+      a chunk-size line that isn't hexadecimal or doesn't fit in a long.
+      The body then ends there, and the connection is closed as what follows
+      can't be trusted.
+      @return true if the body was cut short because of invalid framing
+    */
+    bool responseBodyInvalid() { return iState == eChunkFramingError; }
+
     /** Return the response body as a String
       Also skips response headers if they have not been read already
       MUST be called after responseStatusCode()
@@ -298,14 +374,25 @@ public:
     // Inherited from Print
     // Note: 1st call to these indicates the user is sending the body, so if need
     // Note: be we should finish the header first
-    virtual size_t write(uint8_t aByte) { if (iState < eRequestSent) { finishHeaders(); }; return iClient-> write(aByte); };
-    virtual size_t write(const uint8_t *aBuffer, size_t aSize) { if (iState < eRequestSent) { finishHeaders(); }; return iClient->write(aBuffer, aSize); };
+    virtual size_t write(uint8_t aByte) { return write(&aByte, 1); };
+    virtual size_t write(const uint8_t *aBuffer, size_t aSize);
     // Inherited from Stream
     virtual int available();
     /** Read the next byte from the server.
-      @return Byte read or -1 if there are no bytes available.
+      @return Byte read or -1 if there are no bytes available, or if the end
+      of the body has been reached.
     */
     virtual int read();
+    /** Read up to size bytes of the response body from the server.
+      Once the headers have been read, this never returns more than what's left
+      of the body, and it removes the chunk framing from chunked bodies, so the
+      HttpClient can be handed straight to a parser (e.g.
+      deserializeJson(doc, http)) rather than reading the body into a String.
+      @param buf  Buffer to read into
+      @param size Size of buf
+      @return Number of bytes read, 0 if none are available yet or at the end
+      of the body
+    */
     virtual int read(uint8_t *buf, size_t size);
     virtual int peek() { return iClient->peek(); };
     virtual void flush() { iClient->flush(); };
@@ -321,6 +408,9 @@ public:
     virtual uint32_t httpWaitForDataDelay() { return iHttpWaitForDataDelay; };
     virtual void setHttpWaitForDataDelay(uint32_t delay) { iHttpWaitForDataDelay = delay; };
 protected:
+    // The pool follows the progress of the status line
+    friend class HttpClientPool;
+
     /** Reset internal state data back to the "just initialised" state
     */
     void resetState();
@@ -337,10 +427,51 @@ protected:
     */
     void finishHeaders();
 
+    /** Base64 encode aData with aEncoder and send it
+    */
+    void sendBase64(Base64Encoder& aEncoder, const uint8_t* aData, size_t aLength);
+
+    /** Get ready to read a status line
+    */
+    void restartStatusLine();
+
+    /** Process the next character of the status line
+      @param c Character read
+      @return HTTP_SUCCESS if the line is as expected so far, else
+      HTTP_ERROR_INVALID_RESPONSE
+    */
+    int parseStatusLine(int c);
+
+    /** Process the next character of the headers for captureHeaders()
+      @param c Character read
+    */
+    void captureHeaderCharacter(char c);
+
+    /** Clear the captured values, ready for a new response
+    */
+    void resetHeaderCaptures();
+
+    // One bit for each of the headers to capture
+    uint16_t allHeaderCaptures() { return (uint16_t)((1UL << iHeaderCaptureCount) - 1); };
+
     /** Reading any pending data from the client (used in connection keep alive mode)
     */
     void flushClientRx();
 
+    /** Consume the chunk-size line, chunk extensions, and trailer of a
+      chunked body, as far as the data received so far allows
+    */
+    void readChunkFraming();
+
+    /* Give up on a chunked body whose framing is invalid, e.g. a chunk-size
+      line that isn't hexadecimal or doesn't fit in a long
+    */
+    void chunkFramingError();
+
+    /* Move on from the end of a chunk-size line
+    */
+    void endOfChunkSizeLine();
+
     // Number of milliseconds that we wait each time there isn't any data
     // available to be read (during status code and header processing)
     static const int kHttpWaitForDataDelay = 100;
@@ -348,6 +479,9 @@ protected:
     // data before returning HTTP_ERROR_TIMED_OUT (during status code and header
     // processing)
     static const int kHttpResponseTimeout = 30*1000;
+    // Size of the block responseBody() reads at a time
+    static const int kHttpBodyBufferSize = 64;
+    static const char* kStatusPrefix;
     static const char* kContentLengthPrefix;
     static const char* kTransferEncodingChunked;
     typedef enum {
@@ -361,7 +495,10 @@ protected:
         eLineStartingCRFound,
         eReadingBody,
         eReadingChunkLength,
-        eReadingBodyChunk
+        eReadingBodyChunk,
+        eSkipChunkExtension,
+        eReadingChunkTrailer,
+        eChunkFramingError
     } tHttpState;
     // Client we're using
     Client* iClient;
@@ -374,6 +511,10 @@ protected:
     tHttpState iState;
     // Stores the status code for the response, once known
     int iStatusCode;
+    // How far through the status line prefix we are
+    const char* iStatusPtr;
+    // Stores if the status line has been read, and the headers come next
+    bool iStatusLineRead;
     // Stores the value of the Content-Length header, if present
     long iContentLength;
     // How many bytes of the response body have been read by the user
@@ -384,13 +525,34 @@ protected:
     const char* iTransferEncodingChunkedPtr;
     // Stores if the response body is chunked
     bool iIsChunked;
-    // Stores the value of the current chunk length, if present
-    int iChunkLength;
+    // Stores the value of the current chunk length, if present, then how
+    // much of the chunk is left to read
+    long iChunkLength;
+    // Stores if the current chunk-size line contained any digits
+    bool iChunkLengthFound;
+    // Stores if the current trailer line is empty so far
+    bool iChunkTrailerLineEmpty;
+    // Stores if the zero-length chunk which ends a chunked body, and the
+    // trailer after it, have been read
+    bool iChunkedBodyComplete;
+    // Stores if the request body is being sent chunked
+    bool iSendingChunkedBody;
     uint32_t iHttpResponseTimeout;
     uint32_t iHttpWaitForDataDelay;
     bool iConnectionClose;
     bool iSendDefaultRequestHeaders;
     String iHeaderLine;
+    // Headers to keep, see captureHeaders()
+    HttpHeaderCapture* iHeaderCaptures;
+    int iHeaderCaptureCount;
+    // Headers whose names match the current line so far, one bit each
+    uint16_t iCaptureCandidates;
+    // How far through the name of the current header we are
+    int iCaptureNamePos;
+    // Header whose value we're reading, or -1
+    int iCaptureIndex;
+    // Length of the value read so far
+    size_t iCaptureValueLength;
 };
 
 #endif
@@ -0,0 +1,209 @@
+// Library to simplify HTTP fetching on Arduino
+// Released under Apache License, version 2.0
+
+#include "HttpClientPool.h"
+
+HttpClientPool::HttpClientPool(HttpClient* const aClients[], int aClientCount)
+ : iRequestCount(0), iStatusTimeout(kPhaseTimeout), iHeadersTimeout(kPhaseTimeout),
+   iBodyTimeout(kPhaseTimeout)
+{
+    if (aClientCount > HTTP_CLIENT_POOL_SIZE)
+    {
+        aClientCount = HTTP_CLIENT_POOL_SIZE;
+    }
+    for (int i = 0; i < aClientCount; i++)
+    {
+        iRequests[i].iClient = aClients[i];
+        iRequests[i].iPhase = eIdle;
+        aClients[i]->connectionKeepAlive();
+    }
+    iRequestCount = aClientCount;
+}
+
+int HttpClientPool::startRequest(const char* aURLPath, const char* aHttpMethod,
+                                 tCompletionCallback aOnComplete, tBodyCallback aOnBody, void* aContext,
+                                 const char* aContentType, int aContentLength, const byte aBody[])
+{
+    for (int i = 0; i < iRequestCount; i++)
+    {
+        tRequest& request = iRequests[i];
+        if (request.iPhase != eIdle)
+        {
+            continue;
+        }
+
+        int ret = request.iClient->startRequest(aURLPath, aHttpMethod, aContentType, aContentLength, aBody);
+        if (ret != HTTP_SUCCESS)
+        {
+            // Don't leave a half-sent request on the connection
+            request.iClient->stop();
+            return ret;
+        }
+
+        request.iStatusCode = 0;
+        // The response to a HEAD request never has a body, whatever its headers say
+        request.iNoBody = (strcmp(aHttpMethod, "HEAD") == 0);
+        request.iOnComplete = aOnComplete;
+        request.iOnBody = aOnBody;
+        request.iContext = aContext;
+        startPhase(request, eWaitingForStatus);
+        return i;
+    }
+
+    // All the clients are busy
+    return HTTP_ERROR_API;
+}
+
+void HttpClientPool::poll()
+{
+    for (int i = 0; i < iRequestCount; i++)
+    {
+        tRequest& request = iRequests[i];
+
+        switch(request.iPhase)
+        {
+        case eWaitingForStatus:
+        case eReadingHeaders:
+        {
+            int ret = request.iClient->pollResponseHeaders();
+            if (ret < 0)
+            {
+                complete(request, ret);
+                break;
+            }
+            if (ret > 0)
+            {
+                request.iStatusCode = ret;
+                // Informational, No Content, and Not Modified responses have
+                // no body either
+                if (ret < 200 || ret == 204 || ret == 304)
+                {
+                    request.iNoBody = true;
+                }
+                startPhase(request, eReadingBody);
+                if (request.iNoBody || readBody(request))
+                {
+                    complete(request, request.iStatusCode);
+                }
+                break;
+            }
+
+            if (request.iPhase == eWaitingForStatus && request.iClient->iStatusLineRead)
+            {
+                startPhase(request, eReadingHeaders);
+            }
+            else
+            {
+                uint32_t timeout = (request.iPhase == eWaitingForStatus) ? iStatusTimeout : iHeadersTimeout;
+                if ((millis() - request.iPhaseStart) >= timeout)
+                {
+                    complete(request, HTTP_ERROR_TIMED_OUT);
+                }
+            }
+            break;
+        }
+        case eReadingBody:
+            if (readBody(request))
+            {
+                complete(request, request.iStatusCode);
+            }
+            else if ((millis() - request.iPhaseStart) >= iBodyTimeout)
+            {
+                complete(request, HTTP_ERROR_TIMED_OUT);
+            }
+            break;
+        default:
+            break;
+        };
+    }
+}
+
+bool HttpClientPool::readBody(tRequest& aRequest)
+{
+    HttpClient* client = aRequest.iClient;
+
+    if (!aRequest.iOnBody)
+    {
+        // Leave the body to the completion callback
+        return true;
+    }
+
+    uint8_t buffer[kBodyBufferSize];
+    int n;
+    while ((n = client->read(buffer, sizeof(buffer))) > 0)
+    {
+        aRequest.iOnBody(aRequest.iContext, buffer, n);
+        // We read something, reset the timeout counter
+        aRequest.iPhaseStart = millis();
+    }
+
+    if (client->endOfBodyReached())
+    {
+        return true;
+    }
+    if (!client->isResponseChunked() && client->contentLength() == HttpClient::kNoContentLengthHeader)
+    {
+        // The body ends when the server closes the connection
+        return !client->connected() && !client->available();
+    }
+    return false;
+}
+
+void HttpClientPool::startPhase(tRequest& aRequest, tRequestPhase aPhase)
+{
+    aRequest.iPhase = aPhase;
+    aRequest.iPhaseStart = millis();
+}
+
+void HttpClientPool::complete(tRequest& aRequest, int aResult)
+{
+    if (aResult > 0 && aRequest.iClient->responseBodyInvalid())
+    {
+        // The body ended at chunk framing we couldn't read
+        aResult = HTTP_ERROR_INVALID_RESPONSE;
+    }
+    if (aResult < 0)
+    {
+        // The connection is in an unknown state, start afresh next time
+        aRequest.iClient->stop();
+    }
+    aRequest.iPhase = eIdle;
+    if (aRequest.iOnComplete)
+    {
+        aRequest.iOnComplete(aRequest.iContext, aResult);
+    }
+}
+
+void HttpClientPool::cancel(int aRequest)
+{
+    if (busy(aRequest))
+    {
+        iRequests[aRequest].iClient->stop();
+        iRequests[aRequest].iPhase = eIdle;
+    }
+}
+
+bool HttpClientPool::busy(int aRequest)
+{
+    return (aRequest >= 0) && (aRequest < iRequestCount) && (iRequests[aRequest].iPhase != eIdle);
+}
+
+int HttpClientPool::outstanding()
+{
+    int count = 0;
+    for (int i = 0; i < iRequestCount; i++)
+    {
+        if (iRequests[i].iPhase != eIdle)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+void HttpClientPool::setTimeouts(uint32_t aStatusTimeout, uint32_t aHeadersTimeout, uint32_t aBodyTimeout)
+{
+    iStatusTimeout = aStatusTimeout;
+    iHeadersTimeout = aHeadersTimeout;
+    iBodyTimeout = aBodyTimeout;
+}
@@ -0,0 +1,147 @@
+// Library to simplify HTTP fetching on Arduino
+// Released under Apache License, version 2.0
+
+#ifndef HttpClientPool_h
+#define HttpClientPool_h
+
+#include <Arduino.h>
+
+#include "HttpClient.h"
+
+#ifndef HTTP_CLIENT_POOL_SIZE
+  #define HTTP_CLIENT_POOL_SIZE 4
+#endif
+
+/** Runs requests on a set of HttpClients without blocking the sketch.
+    startRequest() sends the request and returns, then each call to poll()
+    (e.g. from loop()) reads whatever part of the responses has arrived, hands
+    the body to a callback as it comes in, and calls another callback when a
+    request has finished.  Each HttpClient runs one request at a time, so
+    there can be as many outstanding requests as there are clients.
+    The connections are kept alive between requests, so that most requests
+    don't have to wait for Client::connect(), which blocks.
+*/
+class HttpClientPool
+{
+public:
+    /** Called with each part of the response body, as it arrives
+      @param aContext Context passed to startRequest()
+      @param aData    Part of the body
+      @param aLength  Length of aData
+    */
+    typedef void (*tBodyCallback)(void* aContext, const uint8_t* aData, size_t aLength);
+
+    /** Called once, when the request has finished.  If no tBodyCallback was
+      given, that's as soon as the headers have been read, and the body can be
+      read from the HttpClient from here
+      @param aContext    Context passed to startRequest()
+      @param aStatusCode HTTP status code of the response, else error
+    */
+    typedef void (*tCompletionCallback)(void* aContext, int aStatusCode);
+
+    /** Create a pool of clients.
+      The clients are switched to connection keep-alive mode
+      @param aClients     Clients to run the requests on, all of them for the
+                          same server
+      @param aClientCount Number of clients, up to HTTP_CLIENT_POOL_SIZE
+    */
+    HttpClientPool(HttpClient* const aClients[], int aClientCount);
+
+    /** Send a request on the first idle client.
+      aOnComplete won't be called if the request couldn't be sent
+      @param aURLPath     Url to request
+      @param aHttpMethod  Type of HTTP request to make, e.g. "GET", "POST", etc.
+      @param aOnComplete  Called once the request has finished
+      @param aOnBody      Called with the body as it arrives (optional)
+      @param aContext     Passed to the callbacks (optional)
+      @param aContentType Content type of request body (optional)
+      @param aContentLength Length of request body (optional)
+      @param aBody        Body of request (optional)
+      @return Request number, 0 or more, if successful, else error
+    */
+    int startRequest(const char* aURLPath,
+                     const char* aHttpMethod,
+                     tCompletionCallback aOnComplete,
+                     tBodyCallback aOnBody = NULL,
+                     void* aContext = NULL,
+                     const char* aContentType = NULL,
+                     int aContentLength = -1,
+                     const byte aBody[] = NULL);
+
+    /** Advance all the outstanding requests, as far as the data received so
+      far allows.  Calls the callbacks from here
+    */
+    void poll();
+
+    /** Abandon a request.  Its callbacks won't be called, and its connection
+      is closed
+      @param aRequest Request number returned by startRequest()
+    */
+    void cancel(int aRequest);
+
+    /** Test whether a request is still outstanding
+      @param aRequest Request number returned by startRequest()
+    */
+    bool busy(int aRequest);
+
+    /** Return the number of outstanding requests
+    */
+    int outstanding();
+
+    /** Set how long each phase of a request may take before it fails with
+      HTTP_ERROR_TIMED_OUT.  Connecting and sending the request happen in
+      startRequest(), limited by the Client's own timeouts
+      @param aStatusTimeout  Time from sending the request to the end of the
+                             status line
+      @param aHeadersTimeout Time from there to the end of the headers
+      @param aBodyTimeout    Longest time without receiving any of the body
+    */
+    void setTimeouts(uint32_t aStatusTimeout, uint32_t aHeadersTimeout, uint32_t aBodyTimeout);
+
+protected:
+    // Size of the block poll() reads the body in
+    static const int kBodyBufferSize = 64;
+    // Default time for each phase of a request
+    static const uint32_t kPhaseTimeout = 30*1000;
+
+    typedef enum {
+        eIdle,
+        eWaitingForStatus,
+        eReadingHeaders,
+        eReadingBody
+    } tRequestPhase;
+
+    typedef struct {
+        HttpClient* iClient;
+        tRequestPhase iPhase;
+        // When the current phase started, or the body last made progress
+        unsigned long iPhaseStart;
+        int iStatusCode;
+        bool iNoBody;
+        tCompletionCallback iOnComplete;
+        tBodyCallback iOnBody;
+        void* iContext;
+    } tRequest;
+
+    /** Move a request on to another phase
+    */
+    void startPhase(tRequest& aRequest, tRequestPhase aPhase);
+
+    /** Read the part of the body which has arrived
+      @return true once the whole body has been read
+    */
+    bool readBody(tRequest& aRequest);
+
+    /** Finish a request and let the caller know
+      @param aResult Status code, or error
+    */
+    void complete(tRequest& aRequest, int aResult);
+
+    tRequest iRequests[HTTP_CLIENT_POOL_SIZE];
+    int iRequestCount;
+    uint32_t iStatusTimeout;
+    uint32_t iHeadersTimeout;
+    uint32_t iBodyTimeout;
+};
+
+#endif
@@ -0,0 +1,102 @@
+// Library to simplify HTTP fetching on Arduino
+// Released under Apache License, version 2.0
+
+#include "HttpFileCacheStore.h"
+
+#if defined(ESP8266) || defined(ESP32)
+
+HttpFileCacheStore::HttpFileCacheStore(fs::FS& aFS, const char* aPath)
+ : iFS(aFS), iPath(aPath), iValidatorsPath(String(aPath) + ".val"),
+   iTempPath(String(aPath) + ".tmp")
+{
+}
+
+fs::File HttpFileCacheStore::open()
+{
+    if (!iFS.exists(iPath))
+    {
+        return fs::File();
+    }
+    return iFS.open(iPath, "r");
+}
+
+void HttpFileCacheStore::clear()
+{
+    iFS.remove(iValidatorsPath);
+    iFS.remove(iPath);
+}
+
+bool HttpFileCacheStore::loadValidators(char* aETag, char* aLastModified, size_t aSize)
+{
+    aETag[0] = '\0';
+    aLastModified[0] = '\0';
+    if (!iFS.exists(iPath))
+    {
+        return false;
+    }
+    if (iFS.exists(iValidatorsPath))
+    {
+        fs::File validators = iFS.open(iValidatorsPath, "r");
+        if (validators)
+        {
+            readValidator(validators, aETag, aSize);
+            readValidator(validators, aLastModified, aSize);
+            validators.close();
+        }
+    }
+    return true;
+}
+
+void HttpFileCacheStore::readValidator(fs::File& aFile, char* aBuffer, size_t aSize)
+{
+    size_t len = aFile.readBytesUntil('\n', aBuffer, aSize - 1);
+    aBuffer[len] = '\0';
+}
+
+Print* HttpFileCacheStore::beginBody()
+{
+    iTempFile = iFS.open(iTempPath, "w");
+    if (!iTempFile)
+    {
+        return NULL;
+    }
+    return &iTempFile;
+}
+
+bool HttpFileCacheStore::commitBody(const char* aETag, const char* aLastModified)
+{
+    iTempFile.close();
+
+    // Remove the validators first, so that if we're interrupted the next
+    // request is unconditional rather than made with the wrong validators
+    iFS.remove(iValidatorsPath);
+    // SPIFFS won't rename onto an existing file
+    iFS.remove(iPath);
+    if (!iFS.rename(iTempPath, iPath))
+    {
+        return false;
+    }
+
+    if (aETag[0] != '\0' || aLastModified[0] != '\0')
+    {
+        fs::File validators = iFS.open(iValidatorsPath, "w");
+        if (!validators)
+        {
+            return false;
+        }
+        validators.print(aETag);
+        validators.print('\n');
+        validators.print(aLastModified);
+        validators.print('\n');
+        validators.close();
+    }
+    return true;
+}
+
+void HttpFileCacheStore::abortBody()
+{
+    iTempFile.close();
+    iFS.remove(iTempPath);
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Library to simplify HTTP fetching on Arduino
+// Released under Apache License, version 2.0
+
+#ifndef HttpFileCacheStore_h
+#define HttpFileCacheStore_h
+
+#if defined(ESP8266) || defined(ESP32)
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "HttpCache.h"
+
+/** Keeps the cached copy of a resource in files on a flash file system,
+    e.g. LittleFS or SPIFFS.  Not included by ArduinoHttpClient.h, as it's only
+    available on the ESP8266 and ESP32.
+    The body is in the file at aPath, and its validators are in aPath + ".val".
+    A new body is written to aPath + ".tmp" and only replaces the cached one
+    once it's complete, so a failed download or a reset leaves the previous
+    copy in place.
+*/
+class HttpFileCacheStore : public HttpCacheStore
+{
+public:
+    /** Create a store
+      @param aFS   File system to keep the files on, which must have been
+                   mounted already
+      @param aPath Path of the file holding the body
+    */
+    HttpFileCacheStore(fs::FS& aFS, const char* aPath);
+
+    /** Open the cached body for reading, e.g. with deserializeJson()
+      @return The open file, which is false if nothing has been cached yet
+    */
+    fs::File open();
+
+    /** Delete the cached copy, so the next request is unconditional
+    */
+    void clear();
+
+    virtual bool loadValidators(char* aETag, char* aLastModified, size_t aSize);
+    virtual Print* beginBody();
+    virtual bool commitBody(const char* aETag, const char* aLastModified);
+    virtual void abortBody();
+
+protected:
+    /** Read one line of the validators file into aBuffer
+    */
+    void readValidator(fs::File& aFile, char* aBuffer, size_t aSize);
+
+    fs::FS& iFS;
+    String iPath;
+    String iValidatorsPath;
+    String iTempPath;
+    fs::File iTempFile;
+};
+
+#endif
+
+#endif
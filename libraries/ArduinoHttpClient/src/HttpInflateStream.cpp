@@ -0,0 +1,731 @@
+// Library to simplify HTTP fetching on Arduino
+// Released under Apache License, version 2.0
+// Decoder based on the structure of Mark Adler's puff.c, the reference
+// inflate from zlib's contrib directory, turned inside out so that it hands
+// out one byte at a time
+
+#include "HttpInflateStream.h"
+
+const char* HttpInflateStream::kAcceptEncoding = "gzip, deflate";
+
+// Base lengths and extra bits of length symbols 257 to 285
+static const uint16_t kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+// Base distances and extra bits of distance symbols 0 to 29
+static const uint16_t kDistanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577 };
+static const uint8_t kDistanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+// Order the code length code lengths are sent in
+static const uint8_t kCodeLengthOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+// CRC-32 a nibble at a time, to keep the table small
+static const uint32_t kCrcTable[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+    0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+    0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c };
+static const uint32_t kAdlerModulus = 65521;
+
+// gzip header flags
+static const uint8_t kGzipHeaderCrc = 0x02;
+static const uint8_t kGzipExtra = 0x04;
+static const uint8_t kGzipName = 0x08;
+static const uint8_t kGzipComment = 0x10;
+
+HttpInflateStream::HttpInflateStream(HttpClient& aSource, uint8_t* aWindow, size_t aWindowSize)
+ : iSource(aSource), iWindow(aWindow), iWindowSize(aWindowSize)
+{
+    iLengthCode.count = iLengthCount;
+    iLengthCode.symbol = iLengthSymbol;
+    iDistanceCode.count = iDistanceCount;
+    iDistanceCode.symbol = iDistanceSymbol;
+    begin("");
+}
+
+void HttpInflateStream::begin(const char* aContentEncoding)
+{
+    iWindowPos = 0;
+    iWindowFill = 0;
+    iError = HTTP_SUCCESS;
+    iPeeked = -1;
+    iInputPos = 0;
+    iInputLength = 0;
+    iBitBuffer = 0;
+    iBitCount = 0;
+    iLastBlock = false;
+    iFixedCodes = false;
+    iRemaining = 0;
+    iMatchDistance = 0;
+    iEncodedLength = 0;
+    iDecodedLength = 0;
+
+    if (strcasecmp(aContentEncoding, "gzip") == 0 || strcasecmp(aContentEncoding, "x-gzip") == 0)
+    {
+        iEncoding = eGzip;
+        iChecksum = 0xffffffff;
+    }
+    else if (strcasecmp(aContentEncoding, "deflate") == 0)
+    {
+        iEncoding = eZlib;
+        iChecksum = 1;
+    }
+    else
+    {
+        iEncoding = eIdentity;
+        iState = ePassThrough;
+        return;
+    }
+
+    iState = eFormatHeader;
+    if (!iWindow || iWindowSize == 0 || iWindowSize > kMaxWindowSize)
+    {
+        fail(HTTP_ERROR_API);
+    }
+}
+
+int HttpInflateStream::available()
+{
+    if (iPeeked >= 0)
+    {
+        return 1;
+    }
+    switch (iState)
+    {
+    case eDone:
+    case eFailed:
+        return 0;
+    case eCopyMatch:
+        return iRemaining;
+    default:
+        return (iInputPos < iInputLength || iBitCount >= 8 || iSource.available()) ? 1 : 0;
+    };
+}
+
+int HttpInflateStream::read()
+{
+    if (iPeeked >= 0)
+    {
+        int c = iPeeked;
+        iPeeked = -1;
+        return c;
+    }
+    return decode();
+}
+
+int HttpInflateStream::read(uint8_t *buf, size_t size)
+{
+    size_t n = 0;
+    while (n < size)
+    {
+        int c = read();
+        if (c < 0)
+        {
+            break;
+        }
+        buf[n++] = (uint8_t)c;
+    }
+    return (n > 0) ? (int)n : -1;
+}
+
+int HttpInflateStream::peek()
+{
+    if (iPeeked < 0)
+    {
+        iPeeked = decode();
+    }
+    return iPeeked;
+}
+
+int HttpInflateStream::decode()
+{
+    for (;;)
+    {
+        switch (iState)
+        {
+        case ePassThrough:
+        {
+            int c = nextInputByte();
+            if (c < 0)
+            {
+                if (iState != eFailed)
+                {
+                    iState = eDone;
+                }
+                return -1;
+            }
+            iDecodedLength++;
+            return c;
+        }
+        case eFormatHeader:
+            if (readFormatHeader())
+            {
+                iState = eBlockHeader;
+            }
+            else
+            {
+                fail(HTTP_ERROR_INVALID_RESPONSE);
+            }
+            break;
+        case eBlockHeader:
+            if (iLastBlock)
+            {
+                iState = eTrailer;
+            }
+            else if (!readBlockHeader())
+            {
+                fail(HTTP_ERROR_INVALID_RESPONSE);
+            }
+            break;
+        case eStoredBlock:
+        {
+            if (iRemaining == 0)
+            {
+                iState = eBlockHeader;
+                break;
+            }
+            uint8_t c = bits(8);
+            if (iState == eFailed)
+            {
+                return -1;
+            }
+            iRemaining--;
+            output(c);
+            return c;
+        }
+        case eCompressedBlock:
+        {
+            int symbol = decodeSymbol(iLengthCode);
+            if (symbol < 0)
+            {
+                fail(HTTP_ERROR_INVALID_RESPONSE);
+                break;
+            }
+            if (symbol < 256)
+            {
+                output((uint8_t)symbol);
+                return symbol;
+            }
+            if (symbol == 256)
+            {
+                // End of block
+                iState = eBlockHeader;
+                break;
+            }
+
+            symbol -= 257;
+            if (symbol >= 29)
+            {
+                fail(HTTP_ERROR_INVALID_RESPONSE);
+                break;
+            }
+            uint16_t length = kLengthBase[symbol] + bits(kLengthExtra[symbol]);
+            symbol = decodeSymbol(iDistanceCode);
+            if (symbol < 0 || symbol >= 30)
+            {
+                fail(HTTP_ERROR_INVALID_RESPONSE);
+                break;
+            }
+            uint16_t distance = kDistanceBase[symbol] + bits(kDistanceExtra[symbol]);
+            if (iState == eFailed)
+            {
+                break;
+            }
+            if (distance > iWindowFill)
+            {
+                // Before the start of the body, or further back than our
+                // window reaches
+                fail(HTTP_ERROR_INVALID_RESPONSE);
+                break;
+            }
+            iRemaining = length;
+            iMatchDistance = distance;
+            iState = eCopyMatch;
+            break;
+        }
+        case eCopyMatch:
+        {
+            size_t from = (iWindowPos >= iMatchDistance) ? iWindowPos - iMatchDistance
+                                                         : iWindowPos + iWindowSize - iMatchDistance;
+            uint8_t c = iWindow[from];
+            if (--iRemaining == 0)
+            {
+                iState = eCompressedBlock;
+            }
+            output(c);
+            return c;
+        }
+        case eTrailer:
+            if (readTrailer())
+            {
+                iState = eDone;
+            }
+            else
+            {
+                fail(HTTP_ERROR_INVALID_RESPONSE);
+            }
+            break;
+        case eDone:
+        case eFailed:
+        default:
+            return -1;
+        };
+    }
+}
+
+bool HttpInflateStream::readFormatHeader()
+{
+    if (iEncoding == eGzip)
+    {
+        if (bits(8) != 0x1f || bits(8) != 0x8b || bits(8) != 8)
+        {
+            return false;
+        }
+        uint8_t flags = bits(8);
+        // Modification time, extra flags and OS
+        for (int i = 0; i < 6; i++)
+        {
+            bits(8);
+        }
+        if (flags & kGzipExtra)
+        {
+            uint16_t length = bits(16);
+            while (length-- && iState != eFailed)
+            {
+                bits(8);
+            }
+        }
+        if (flags & kGzipName)
+        {
+            while (bits(8) != 0 && iState != eFailed)
+            {
+            }
+        }
+        if (flags & kGzipComment)
+        {
+            while (bits(8) != 0 && iState != eFailed)
+            {
+            }
+        }
+        if (flags & kGzipHeaderCrc)
+        {
+            bits(16);
+        }
+        return iState != eFailed;
+    }
+
+    // Content-Encoding: deflate is meant to be zlib, but some servers send
+    // raw deflate data, so take it as that if it doesn't start with a zlib
+    // header
+    uint16_t header = bits(16);
+    uint8_t method = header & 0xff;
+    uint8_t flags = header >> 8;
+    if (iState == eFailed)
+    {
+        return false;
+    }
+    if ((method & 0x0f) == 8 && (method >> 4) <= 7 && ((method << 8) | flags) % 31 == 0)
+    {
+        // A preset dictionary isn't something a web server would use
+        return (flags & 0x20) == 0;
+    }
+    // Put the two bytes back
+    iEncoding = eRawDeflate;
+    iBitBuffer = header;
+    iBitCount = 16;
+    return true;
+}
+
+bool HttpInflateStream::readTrailer()
+{
+    // The trailer starts on a byte boundary
+    iBitBuffer >>= (iBitCount & 7);
+    iBitCount -= (iBitCount & 7);
+
+    if (iEncoding == eGzip)
+    {
+        uint32_t crc = bits(16);
+        crc |= (uint32_t)bits(16) << 16;
+        uint32_t size = bits(16);
+        size |= (uint32_t)bits(16) << 16;
+        return (iState != eFailed) && (crc == (iChecksum ^ 0xffffffff)) && (size == (uint32_t)iDecodedLength);
+    }
+    if (iEncoding == eZlib)
+    {
+        uint32_t adler = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            adler = (adler << 8) | bits(8);
+        }
+        return (iState != eFailed) && (adler == iChecksum);
+    }
+    // Raw deflate has no trailer
+    return true;
+}
+
+bool HttpInflateStream::readBlockHeader()
+{
+    iLastBlock = bits(1);
+    switch (bits(2))
+    {
+    case 0:
+    {
+        // Stored, which starts on a byte boundary
+        iBitBuffer >>= (iBitCount & 7);
+        iBitCount -= (iBitCount & 7);
+        uint16_t length = bits(16);
+        uint16_t check = bits(16);
+        if (iState == eFailed || length != (uint16_t)~check)
+        {
+            return false;
+        }
+        iRemaining = length;
+        iState = eStoredBlock;
+        return true;
+    }
+    case 1:
+        if (!iFixedCodes)
+        {
+            buildFixedCodes();
+        }
+        iState = eCompressedBlock;
+        return true;
+    case 2:
+        if (!readDynamicCodes())
+        {
+            return false;
+        }
+        iState = eCompressedBlock;
+        return true;
+    default:
+        return false;
+    };
+}
+
+void HttpInflateStream::buildFixedCodes()
+{
+    uint8_t lengths[288];
+    int i;
+    for (i = 0; i < 144; i++)
+    {
+        lengths[i] = 8;
+    }
+    for (; i < 256; i++)
+    {
+        lengths[i] = 9;
+    }
+    for (; i < 280; i++)
+    {
+        lengths[i] = 7;
+    }
+    for (; i < 288; i++)
+    {
+        lengths[i] = 8;
+    }
+    buildHuffman(iLengthCode, lengths, 288);
+
+    for (i = 0; i < 30; i++)
+    {
+        lengths[i] = 5;
+    }
+    buildHuffman(iDistanceCode, lengths, 30);
+    iFixedCodes = true;
+}
+
+bool HttpInflateStream::readDynamicCodes()
+{
+    uint8_t lengths[286 + 30];
+    iFixedCodes = false;
+
+    int lengthCount = bits(5) + 257;
+    int distanceCount = bits(5) + 1;
+    int codeCount = bits(4) + 4;
+    if (lengthCount > 286 || distanceCount > 30)
+    {
+        return false;
+    }
+
+    // The code lengths are themselves Huffman coded, with a code that
+    // borrows the tables of the length code while we read them
+    int i;
+    for (i = 0; i < codeCount; i++)
+    {
+        lengths[kCodeLengthOrder[i]] = bits(3);
+    }
+    for (; i < 19; i++)
+    {
+        lengths[kCodeLengthOrder[i]] = 0;
+    }
+    if (iState == eFailed || buildHuffman(iLengthCode, lengths, 19) != 0)
+    {
+        return false;
+    }
+
+    int index = 0;
+    while (index < lengthCount + distanceCount)
+    {
+        int symbol = decodeSymbol(iLengthCode);
+        if (symbol < 0 || iState == eFailed)
+        {
+            return false;
+        }
+        if (symbol < 16)
+        {
+            lengths[index++] = symbol;
+            continue;
+        }
+
+        uint8_t length = 0;
+        int repeat;
+        if (symbol == 16)
+        {
+            // Repeat the previous length
+            if (index == 0)
+            {
+                return false;
+            }
+            length = lengths[index - 1];
+            repeat = 3 + bits(2);
+        }
+        else if (symbol == 17)
+        {
+            repeat = 3 + bits(3);
+        }
+        else
+        {
+            repeat = 11 + bits(7);
+        }
+        if (index + repeat > lengthCount + distanceCount)
+        {
+            return false;
+        }
+        while (repeat--)
+        {
+            lengths[index++] = length;
+        }
+    }
+
+    if (lengths[256] == 0)
+    {
+        // No end of block code
+        return false;
+    }
+
+    // Incomplete codes are only allowed when they have a single code
+    int left = buildHuffman(iLengthCode, lengths, lengthCount);
+    if (left < 0 || (left > 0 && lengthCount - iLengthCount[0] != 1))
+    {
+        return false;
+    }
+    left = buildHuffman(iDistanceCode, lengths + lengthCount, distanceCount);
+    if (left < 0 || (left > 0 && distanceCount - iDistanceCount[0] != 1))
+    {
+        return false;
+    }
+    return true;
+}
+
+int HttpInflateStream::buildHuffman(tHuffman& aCode, const uint8_t* aLengths, int aCount)
+{
+    uint16_t offsets[16];
+    int length;
+
+    for (length = 0; length < 16; length++)
+    {
+        aCode.count[length] = 0;
+    }
+    for (int symbol = 0; symbol < aCount; symbol++)
+    {
+        aCode.count[aLengths[symbol]]++;
+    }
+    if (aCode.count[0] == aCount)
+    {
+        // No codes, complete but can't be decoded
+        return 0;
+    }
+
+    // Check for an over-subscribed or incomplete set of lengths
+    int32_t left = 1;
+    for (length = 1; length < 16; length++)
+    {
+        left <<= 1;
+        left -= aCode.count[length];
+        if (left < 0)
+        {
+            return -1;
+        }
+    }
+
+    offsets[1] = 0;
+    for (length = 1; length < 15; length++)
+    {
+        offsets[length + 1] = offsets[length] + aCode.count[length];
+    }
+    for (int symbol = 0; symbol < aCount; symbol++)
+    {
+        if (aLengths[symbol] != 0)
+        {
+            aCode.symbol[offsets[aLengths[symbol]]++] = symbol;
+        }
+    }
+    return (left > 0) ? 1 : 0;
+}
+
+int HttpInflateStream::decodeSymbol(const tHuffman& aCode)
+{
+    // Canonical codes of each length follow on from those of the previous
+    // length, so walk down the lengths a bit at a time
+    int32_t code = 0;
+    int32_t first = 0;
+    int index = 0;
+    for (int length = 1; length < 16; length++)
+    {
+        if (iBitCount == 0)
+        {
+            int c = nextInputByte();
+            if (c < 0)
+            {
+                fail(iError != HTTP_SUCCESS ? iError : HTTP_ERROR_INVALID_RESPONSE);
+                return -1;
+            }
+            iBitBuffer = c;
+            iBitCount = 8;
+        }
+        code |= iBitBuffer & 1;
+        iBitBuffer >>= 1;
+        iBitCount--;
+
+        int count = aCode.count[length];
+        if (code - count < first)
+        {
+            return aCode.symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    // Ran out of codes
+    return -1;
+}
+
+int HttpInflateStream::nextInputByte()
+{
+    if (iInputPos < iInputLength)
+    {
+        iEncodedLength++;
+        return iInput[iInputPos++];
+    }
+
+    unsigned long timeoutStart = millis();
+    for (;;)
+    {
+        int n = iSource.read(iInput, sizeof(iInput));
+        if (n > 0)
+        {
+            iInputLength = n;
+            iInputPos = 1;
+            iEncodedLength++;
+            return iInput[0];
+        }
+        if (iSource.endOfBodyReached())
+        {
+            // Bad chunk framing ends the body too, before the server meant
+            if (iSource.responseBodyInvalid())
+            {
+                fail(HTTP_ERROR_INVALID_RESPONSE);
+            }
+            return -1;
+        }
+        if (!iSource.connected() && !iSource.available())
+        {
+            // The server closed the connection.  That's the end of the body
+            // if the server didn't say how long it was
+            if (!iSource.isResponseChunked() && iSource.contentLength() == HttpClient::kNoContentLengthHeader)
+            {
+                return -1;
+            }
+            fail(HTTP_ERROR_INVALID_RESPONSE);
+            return -1;
+        }
+        if ((millis() - timeoutStart) >= iSource.httpResponseTimeout())
+        {
+            fail(HTTP_ERROR_TIMED_OUT);
+            return -1;
+        }
+        // Let the network stack (and the watchdog) run while we wait.  Not
+        // delay(), the next packet is usually a few ms away at most
+        yield();
+    }
+}
+
+uint16_t HttpInflateStream::bits(int aCount)
+{
+    while (iBitCount < aCount)
+    {
+        int c = nextInputByte();
+        if (c < 0)
+        {
+            // The body ended part way through
+            fail(iError != HTTP_SUCCESS ? iError : HTTP_ERROR_INVALID_RESPONSE);
+            return 0;
+        }
+        iBitBuffer |= (uint32_t)c << iBitCount;
+        iBitCount += 8;
+    }
+    uint16_t value = iBitBuffer & ((1UL << aCount) - 1);
+    iBitBuffer >>= aCount;
+    iBitCount -= aCount;
+    return value;
+}
+
+void HttpInflateStream::output(uint8_t aByte)
+{
+    iWindow[iWindowPos] = aByte;
+    if (++iWindowPos == iWindowSize)
+    {
+        iWindowPos = 0;
+    }
+    if (iWindowFill < iWindowSize)
+    {
+        iWindowFill++;
+    }
+    iDecodedLength++;
+
+    if (iEncoding == eGzip)
+    {
+        iChecksum ^= aByte;
+        iChecksum = (iChecksum >> 4) ^ kCrcTable[iChecksum & 0x0f];
+        iChecksum = (iChecksum >> 4) ^ kCrcTable[iChecksum & 0x0f];
+    }
+    else if (iEncoding == eZlib)
+    {
+        uint32_t a = (iChecksum & 0xffff) + aByte;
+        if (a >= kAdlerModulus)
+        {
+            a -= kAdlerModulus;
+        }
+        uint32_t b = (iChecksum >> 16) + a;
+        if (b >= kAdlerModulus)
+        {
+            b -= kAdlerModulus;
+        }
+        iChecksum = (b << 16) | a;
+    }
+}
+
+void HttpInflateStream::fail(int aError)
+{
+    if (iState != eFailed)
+    {
+        iError = aError;
+        iState = eFailed;
+    }
+}
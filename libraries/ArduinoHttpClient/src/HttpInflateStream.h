@@ -0,0 +1,192 @@
+// Library to simplify HTTP fetching on Arduino
+// Released under Apache License, version 2.0
+
+#ifndef HttpInflateStream_h
+#define HttpInflateStream_h
+
+#include <Arduino.h>
+
+#include "HttpClient.h"
+
+/** Decompresses a gzip or deflate encoded response body as it's read.
+    It reads the body from the HttpClient, so the chunked encoding has
+    already been removed, and can be read like any Stream, e.g. passed
+    straight to deserializeJson().  The whole body is never held in memory:
+    the only buffer is the window of previous output which deflate refers
+    back to, which is supplied by the caller and can be from 1 to 32KB.  It
+    must be at least as large as the window the server compresses with,
+    which is 32KB unless the server has been told otherwise (e.g. zlib's
+    windowBits); references further back than the window fail with
+    HTTP_ERROR_INVALID_RESPONSE.
+    The checksum at the end of the data is checked when the end is read.
+    deserializeJson() stops at the end of the JSON document, so keep reading
+    until read() returns -1 before checking error() if that matters.
+
+    Typical use:
+      uint8_t window[8192];
+      HttpInflateStream body(client, window, sizeof(window));
+      ...
+      char encoding[16];
+      HttpHeaderCapture headers[] = {{HTTP_HEADER_CONTENT_ENCODING, encoding, sizeof(encoding)}};
+      client.captureHeaders(headers, 1);
+      client.beginRequest();
+      client.get("/roster.json");
+      client.sendHeader(HTTP_HEADER_ACCEPT_ENCODING, HttpInflateStream::kAcceptEncoding);
+      client.endRequest();
+      client.responseStatusCode();
+      client.skipResponseHeaders();
+      body.begin(encoding);
+      deserializeJson(doc, body);
+*/
+class HttpInflateStream : public Stream
+{
+public:
+    // Value for the Accept-Encoding header, listing the encodings we decode
+    static const char* kAcceptEncoding;
+    // Largest window deflate can refer back to
+    static const size_t kMaxWindowSize = 32768;
+
+    /** Create a decoder for the bodies read by aSource
+      @param aSource     Client the response is read from
+      @param aWindow     Buffer for the window
+      @param aWindowSize Size of aWindow, from 1 to kMaxWindowSize bytes
+    */
+    HttpInflateStream(HttpClient& aSource, uint8_t* aWindow, size_t aWindowSize);
+
+    /** Start decoding a response body.  Call it once the response headers
+      have been read
+      @param aContentEncoding Value of the Content-Encoding header: "gzip"
+                              and "deflate" are decoded, anything else
+                              (including "" if there was no such header) is
+                              passed through unchanged
+    */
+    void begin(const char* aContentEncoding);
+
+    /** Return HTTP_SUCCESS, or the reason the body couldn't be decoded:
+      HTTP_ERROR_INVALID_RESPONSE if the data is corrupted (or refers back
+      further than the window), HTTP_ERROR_TIMED_OUT if the body stopped
+      arriving before its end, HTTP_ERROR_API if begin() was given a window
+      it can't use
+    */
+    int error() { return iError; };
+
+    /** Return the number of encoded bytes read from the client so far
+    */
+    unsigned long encodedLength() { return iEncodedLength; };
+
+    /** Return the number of bytes decoded so far
+    */
+    unsigned long decodedLength() { return iDecodedLength; };
+
+    // Inherited from Stream
+    virtual int available();
+    virtual int read();
+    virtual int read(uint8_t *buf, size_t size);
+    virtual int peek();
+    // Inherited from Print, the stream can't be written to
+    virtual size_t write(uint8_t aByte) { return 0; };
+
+protected:
+    // Size of the block the encoded body is read in
+    static const int kInputBufferSize = 64;
+
+    typedef enum {
+        eIdentity,
+        eGzip,
+        eZlib,
+        eRawDeflate
+    } tEncoding;
+
+    typedef enum {
+        eFormatHeader,
+        eBlockHeader,
+        eStoredBlock,
+        eCompressedBlock,
+        eCopyMatch,
+        eTrailer,
+        ePassThrough,
+        eDone,
+        eFailed
+    } tInflateState;
+
+    // A canonical Huffman code: the number of codes of each length, and the
+    // symbols ordered by code
+    typedef struct {
+        uint16_t* count;
+        uint16_t* symbol;
+    } tHuffman;
+
+    /** Produce the next decoded byte
+      @return The byte, or -1 at the end of the body or on error
+    */
+    int decode();
+
+    /** Read the gzip or zlib header, or decide the data is raw deflate
+      @return true if successful, else false
+    */
+    bool readFormatHeader();
+    bool readTrailer();
+    bool readBlockHeader();
+    bool readDynamicCodes();
+    void buildFixedCodes();
+
+    /** Build a Huffman code from its code lengths
+      @return 0 if the code is complete, less than 0 if there are too many
+              codes of some length, more than 0 if it's incomplete
+    */
+    static int buildHuffman(tHuffman& aCode, const uint8_t* aLengths, int aCount);
+    int decodeSymbol(const tHuffman& aCode);
+
+    /** Read the next byte of the encoded body, waiting for it if needed
+      @return The byte, or -1 if there isn't one
+    */
+    int nextInputByte();
+    /** Read aCount bits, least significant first.  Fails the stream if the
+      body runs out
+    */
+    uint16_t bits(int aCount);
+
+    /** Add a decoded byte to the window and the checksum
+    */
+    void output(uint8_t aByte);
+    void fail(int aError);
+
+    HttpClient& iSource;
+    uint8_t* iWindow;
+    size_t iWindowSize;
+    size_t iWindowPos;
+    // Window bytes which have been written, up to iWindowSize
+    size_t iWindowFill;
+
+    tEncoding iEncoding;
+    tInflateState iState;
+    int iError;
+    // Byte returned by peek() and not read yet, or -1
+    int iPeeked;
+
+    uint8_t iInput[kInputBufferSize];
+    int iInputPos;
+    int iInputLength;
+    uint32_t iBitBuffer;
+    int iBitCount;
+
+    bool iLastBlock;
+    bool iFixedCodes;
+    // Bytes left in the current stored block, or of the current match
+    uint16_t iRemaining;
+    uint16_t iMatchDistance;
+
+    // CRC-32 for gzip, Adler-32 for zlib
+    uint32_t iChecksum;
+    unsigned long iEncodedLength;
+    unsigned long iDecodedLength;
+
+    uint16_t iLengthCount[16];
+    uint16_t iLengthSymbol[288];
+    uint16_t iDistanceCount[16];
+    uint16_t iDistanceSymbol[30];
+    tHuffman iLengthCode;
+    tHuffman iDistanceCode;
+};
+
+#endif
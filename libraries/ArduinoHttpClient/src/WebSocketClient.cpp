@@ -1,28 +1,58 @@
 // (c) Copyright Arduino. 2016
 // Released under Apache License, version 2.0
 
-#include "b64.h"
+#include <Base64Codec.h>
 
 #include "WebSocketClient.h"
 
 WebSocketClient::WebSocketClient(Client& aClient, const char* aServerName, uint16_t aServerPort)
  : HttpClient(aClient, aServerName, aServerPort),
    iTxStarted(false),
-   iRxSize(0)
+   iTxFragmented(false),
+   iTxSize(0),
+   iRxSize(0),
+   iRxHeaderLength(0),
+   iRxControlPending(false),
+   iRxMessageLength(0),
+   iRxMessageTooLong(false),
+   iKeepAliveInterval(0),
+   iKeepAliveTimeout(0),
+   iLastRxTime(0),
+   iPingSent(false)
 {
 }
 
 WebSocketClient::WebSocketClient(Client& aClient, const String& aServerName, uint16_t aServerPort) 
  : HttpClient(aClient, aServerName, aServerPort),
    iTxStarted(false),
-   iRxSize(0)
+   iTxFragmented(false),
+   iTxSize(0),
+   iRxSize(0),
+   iRxHeaderLength(0),
+   iRxControlPending(false),
+   iRxMessageLength(0),
+   iRxMessageTooLong(false),
+   iKeepAliveInterval(0),
+   iKeepAliveTimeout(0),
+   iLastRxTime(0),
+   iPingSent(false)
 {
 }
 
 WebSocketClient::WebSocketClient(Client& aClient, const IPAddress& aServerAddress, uint16_t aServerPort)
  : HttpClient(aClient, aServerAddress, aServerPort),
    iTxStarted(false),
-   iRxSize(0)
+   iTxFragmented(false),
+   iTxSize(0),
+   iRxSize(0),
+   iRxHeaderLength(0),
+   iRxControlPending(false),
+   iRxMessageLength(0),
+   iRxMessageTooLong(false),
+   iKeepAliveInterval(0),
+   iKeepAliveTimeout(0),
+   iLastRxTime(0),
+   iPingSent(false)
 {
 }
 
@@ -44,7 +74,7 @@ int WebSocketClient::begin(const char* aPath)
             randomKey[i] = random(0x01, 0xff);
         }
         memset(base64RandomKey, 0x00, sizeof(base64RandomKey));
-        b64_encode(randomKey, sizeof(randomKey), (unsigned char*)base64RandomKey, sizeof(base64RandomKey));
+        base64Encode(randomKey, sizeof(randomKey), base64RandomKey);
 
         // start the connection upgrade sequence
         sendHeader("Upgrade", "websocket");
@@ -62,6 +92,15 @@ int WebSocketClient::begin(const char* aPath)
     }
 
     iRxSize = 0;
+    iRxHeaderLength = 0;
+    iRxControlPending = false;
+    iRxMessageLength = 0;
+    iRxMessageTooLong = false;
+    iTxStarted = false;
+    iTxFragmented = false;
+    iTxSize = 0;
+    iLastRxTime = millis();
+    iPingSent = false;
 
     // status code of 101 means success
     return (status == 101) ? 0 : status;
@@ -81,6 +120,7 @@ int WebSocketClient::beginMessage(int aType)
     }
 
     iTxStarted = true;
+    iTxFragmented = false;
     iTxMessageType = (aType & 0xf);
     iTxSize = 0;
 
@@ -95,54 +135,142 @@ int WebSocketClient::endMessage()
         return 1;
     }
 
+    int ret = flushTx(true);
+
+    iTxStarted = false;
+    iTxFragmented = false;
+
+    return ret;
+}
+
+int WebSocketClient::flushTx(bool aFinal)
+{
+    // only the first frame of a message carries its type
+    uint8_t opcode = iTxFragmented ? TYPE_CONTINUATION : iTxMessageType;
+    if (aFinal)
+    {
+        opcode |= 0x80;
+    }
+
+    size_t txSize = iTxSize;
+    iTxSize = 0;
+    iTxFragmented = true;
+
+    return sendFrame(opcode, iTxBuffer, txSize);
+}
+
+bool WebSocketClient::sendFrameHeader(uint8_t aOpCode, uint64_t aLength, uint8_t aMaskKey[4])
+{
+    uint8_t header[14];
+    size_t headerLength = 0;
+
     // send FIN + the message type (opcode)
-    HttpClient::write(0x80 | iTxMessageType);
+    header[headerLength++] = aOpCode;
 
     // the message is masked (0x80)
     // send the length
-    if (iTxSize < 126)
+    if (aLength < 126)
     {
-        HttpClient::write(0x80 | (uint8_t)iTxSize);
+        header[headerLength++] = 0x80 | (uint8_t)aLength;
     }
-    else if (iTxSize < 0xffff)
+    else if (aLength <= 0xffff)
     {
-        HttpClient::write(0x80 | 126);
-        HttpClient::write((iTxSize >> 8) & 0xff);
-        HttpClient::write((iTxSize >> 0) & 0xff);
+        header[headerLength++] = 0x80 | 126;
+        header[headerLength++] = (aLength >> 8) & 0xff;
+        header[headerLength++] = (aLength >> 0) & 0xff;
     }
     else
     {
-        HttpClient::write(0x80 | 127);
-        HttpClient::write((iTxSize >> 56) & 0xff);
-        HttpClient::write((iTxSize >> 48) & 0xff);
-        HttpClient::write((iTxSize >> 40) & 0xff);
-        HttpClient::write((iTxSize >> 32) & 0xff);
-        HttpClient::write((iTxSize >> 24) & 0xff);
-        HttpClient::write((iTxSize >> 16) & 0xff);
-        HttpClient::write((iTxSize >> 8) & 0xff);
-        HttpClient::write((iTxSize >> 0) & 0xff);
+        header[headerLength++] = 0x80 | 127;
+        for (int shift = 56; shift >= 0; shift -= 8)
+        {
+            header[headerLength++] = (aLength >> shift) & 0xff;
+        }
     }
 
+    // create a random mask for the data and send
+    for (int i = 0; i < 4; i++)
+    {
+        aMaskKey[i] = random(0xff);
+        header[headerLength++] = aMaskKey[i];
+    }
+
+    return HttpClient::write(header, headerLength) == headerLength;
+}
+
+int WebSocketClient::sendFrame(uint8_t aOpCode, uint8_t* aData, size_t aLength)
+{
     uint8_t maskKey[4];
 
-    // create a random mask for the data and send
-    for (int i = 0; i < (int)sizeof(maskKey); i++)
+    if (!sendFrameHeader(aOpCode, aLength, maskKey))
     {
-        maskKey[i] = random(0xff);
+        return 1;
     }
-    HttpClient::write(maskKey, sizeof(maskKey));
 
     // mask the data and send
-    for (int i = 0; i < (int)iTxSize; i++) {
-        iTxBuffer[i] ^= maskKey[i % sizeof(maskKey)];
+    mask(aData, aLength, maskKey, 0);
+
+    return (HttpClient::write(aData, aLength) == aLength) ? 0 : 1;
+}
+
+size_t WebSocketClient::sendFragment(const uint8_t* aData, size_t aLength)
+{
+    uint8_t maskKey[4];
+
+    if (!sendFrameHeader(iTxFragmented ? TYPE_CONTINUATION : iTxMessageType, aLength, maskKey))
+    {
+        return 0;
     }
+    iTxFragmented = true;
 
-    size_t txSize = iTxSize;
+    // mask the data a buffer at a time, as we can't change the caller's copy
+    size_t sent = 0;
+    while (sent < aLength)
+    {
+        size_t blockSize = aLength - sent;
+        if (blockSize > sizeof(iTxBuffer))
+        {
+            blockSize = sizeof(iTxBuffer);
+        }
+        memcpy(iTxBuffer, aData + sent, blockSize);
+        mask(iTxBuffer, blockSize, maskKey, sent);
+        size_t written = HttpClient::write(iTxBuffer, blockSize);
+        sent += written;
+        if (written != blockSize)
+        {
+            // The frame is broken, the connection can't be used any more
+            break;
+        }
+    }
+    return sent;
+}
 
-    iTxStarted = false;
-    iTxSize = 0;
+void WebSocketClient::mask(uint8_t* aData, size_t aLength, const uint8_t aMaskKey[4], size_t aOffset)
+{
+    size_t i = 0;
+
+    // byte by byte until we're lined up with the start of the key
+    for (; i < aLength && ((aOffset + i) & 3); i++)
+    {
+        aData[i] ^= aMaskKey[(aOffset + i) & 3];
+    }
+
+    // then a word at a time: the key's bytes are in the same order in the
+    // word as the data's, whatever the endianness
+    uint32_t key;
+    memcpy(&key, aMaskKey, sizeof(key));
+    for (; i + 4 <= aLength; i += 4)
+    {
+        uint32_t word;
+        memcpy(&word, aData + i, sizeof(word));
+        word ^= key;
+        memcpy(aData + i, &word, sizeof(word));
+    }
 
-    return (HttpClient::write(iTxBuffer, txSize) == txSize) ? 0 : 1;
+    for (; i < aLength; i++)
+    {
+        aData[i] ^= aMaskKey[(aOffset + i) & 3];
+    }
 }
 
 size_t WebSocketClient::write(uint8_t aByte)
@@ -164,106 +292,314 @@ size_t WebSocketClient::write(const uint8_t *aBuffer, size_t aSize)
         return 0;
     }
 
-    // check if the write size, fits in the buffer
-    if ((iTxSize + aSize) > sizeof(iTxBuffer))
+    size_t written = 0;
+    while (written < aSize)
     {
-        aSize = sizeof(iTxSize) - iTxSize;
-    }
-
-    // copy data into the buffer
-    memcpy(iTxBuffer + iTxSize, aBuffer, aSize);
+        size_t remaining = aSize - written;
 
-    iTxSize += aSize;
-    
-    return aSize;
-}
+        if (iTxSize == 0 && remaining >= sizeof(iTxBuffer))
+        {
+            // Too big for the buffer anyway, send it as a fragment of its own
+            // rather than copying it in a piece at a time
+            return written + sendFragment(aBuffer + written, remaining);
+        }
 
-int WebSocketClient::parseMessage()
-{
-    flushRx();
+        // copy data into the buffer
+        size_t space = sizeof(iTxBuffer) - iTxSize;
+        size_t copySize = (remaining < space) ? remaining : space;
+        memcpy(iTxBuffer + iTxSize, aBuffer + written, copySize);
+        iTxSize += copySize;
+        written += copySize;
 
-    // make sure 2 bytes (opcode + length)
-    // are available
-    if (HttpClient::available() < 2)
-    {
-        return 0;
+        if (iTxSize == sizeof(iTxBuffer))
+        {
+            // the buffer is full, send what we have as a fragment
+            if (flushTx(false) != 0)
+            {
+                return written - copySize;
+            }
+        }
     }
 
-    // read open code and length
-    uint8_t opcode = HttpClient::read();
-    int length = HttpClient::read();
+    return written;
+}
 
-    if ((opcode & 0x0f) == 0)
-    {
-        // continuation, use previous opcode and update flags
-        iRxOpCode |= opcode;
-    }
-    else
+bool WebSocketClient::readFrameHeader()
+{
+    // The header is 2 to 14 bytes, depending on the length and the mask,
+    // which we only know once we have the first 2
+    for (;;)
     {
-        iRxOpCode = opcode;
+        size_t headerLength = 2;
+        if (iRxHeaderLength >= 2)
+        {
+            uint8_t length = iRxHeader[1] & 0x7f;
+            if (length == 126)
+            {
+                headerLength += 2;
+            }
+            else if (length == 127)
+            {
+                headerLength += 8;
+            }
+            if (iRxHeader[1] & 0x80)
+            {
+                headerLength += 4;
+            }
+            if (iRxHeaderLength == headerLength)
+            {
+                break;
+            }
+        }
+
+        int c = HttpClient::read();
+        if (c < 0)
+        {
+            // wait for the rest
+            return false;
+        }
+        iRxHeader[iRxHeaderLength++] = c;
+        iLastRxTime = millis();
+        iPingSent = false;
     }
 
-    iRxMasked = (length & 0x80);
-    length &= 0x7f;
+    iRxFrameOpCode = iRxHeader[0];
+    iRxMasked = (iRxHeader[1] & 0x80);
 
     // read the RX size
+    uint8_t length = iRxHeader[1] & 0x7f;
+    int pos = 2;
     if (length < 126)
     {
         iRxSize = length;
     }
-    else if (length == 126)
-    {
-        iRxSize = (HttpClient::read() << 8) | HttpClient::read();
-    }
     else
     {
-        iRxSize = ((uint64_t)HttpClient::read() << 56) | 
-                    ((uint64_t)HttpClient::read() << 48) | 
-                    ((uint64_t)HttpClient::read() << 40) | 
-                    ((uint64_t)HttpClient::read() << 32) | 
-                    ((uint64_t)HttpClient::read() << 24) | 
-                    ((uint64_t)HttpClient::read() << 16) | 
-                    ((uint64_t)HttpClient::read() << 8)  |
-                    (uint64_t)HttpClient::read(); 
+        int lengthBytes = (length == 126) ? 2 : 8;
+        iRxSize = 0;
+        for (int i = 0; i < lengthBytes; i++)
+        {
+            iRxSize = (iRxSize << 8) | iRxHeader[pos++];
+        }
     }
 
     // read in the mask, if present
     if (iRxMasked)
     {
-        for (int i = 0; i < (int)sizeof(iRxMaskKey); i++)
-        {
-            iRxMaskKey[i] = HttpClient::read();
-        }
+        memcpy(iRxMaskKey, iRxHeader + pos, sizeof(iRxMaskKey));
     }
 
     iRxMaskIndex = 0;
+    iRxHeaderLength = 0;
+
+    return true;
+}
 
-    if (TYPE_CONNECTION_CLOSE == messageType())
+bool WebSocketClient::handleControlFrame()
+{
+    if (iRxSize > 125)
     {
-        flushRx();
+        // control frames can't be this long, the stream is garbled
         stop();
         iRxSize = 0;
+        iRxControlPending = false;
+        return true;
     }
-    else if (TYPE_PING == messageType())
+
+    // control frames are short, so wait for all of it before acting on it
+    if (HttpClient::available() < (int)iRxSize)
     {
-        beginMessage(TYPE_PONG);
-        while(available())
+        iRxControlPending = true;
+        return false;
+    }
+    iRxControlPending = false;
+
+    uint8_t payload[125];
+    size_t length = iRxSize;
+    // it has all arrived, but the client may hand it over in pieces
+    size_t received = 0;
+    while (received < length)
+    {
+        int n = read(payload + received, length - received);
+        if (n <= 0)
         {
-            write(read());
+            break;
         }
-        endMessage();
+        received += n;
+    }
 
-        iRxSize = 0;
+    switch (iRxFrameOpCode & 0x0f)
+    {
+    case TYPE_PING:
+        // answer with the same data, even in the middle of sending a
+        // fragmented message
+        sendFrame(0x80 | TYPE_PONG, payload, length);
+        break;
+    case TYPE_CONNECTION_CLOSE:
+        // send back the status code, then close
+        sendFrame(0x80 | TYPE_CONNECTION_CLOSE, payload, (length < 2) ? length : 2);
+        stop();
+        break;
+    default:
+        // a pong, receiving it is all that matters
+        break;
+    };
+
+    iRxSize = 0;
+    return true;
+}
+
+int WebSocketClient::parseMessage()
+{
+    if (iRxControlPending && !handleControlFrame())
+    {
+        return 0;
     }
-    else if (TYPE_PONG == messageType())
+
+    flushRx();
+
+    if (iRxSize > 0)
     {
-        flushRx();
-        iRxSize = 0;
+        // the rest of the previous frame hasn't arrived yet
+        return 0;
+    }
+
+    if (!readFrameHeader())
+    {
+        return 0;
+    }
+
+    if (iRxFrameOpCode & 0x08)
+    {
+        // ping, pong, or close, which can come between the fragments of a
+        // message, so the message's opcode is kept for the next one
+        handleControlFrame();
+        return 0;
+    }
+
+    if ((iRxFrameOpCode & 0x0f) == TYPE_CONTINUATION)
+    {
+        // continuation, use previous opcode and update flags
+        iRxOpCode = (iRxOpCode & 0x0f) | (iRxFrameOpCode & 0x80);
+    }
+    else
+    {
+        iRxOpCode = iRxFrameOpCode;
     }
 
     return iRxSize;
 }
 
+int WebSocketClient::pollMessage(uint8_t* aBuffer, size_t aSize)
+{
+    for (;;)
+    {
+        if (iRxControlPending)
+        {
+            if (!handleControlFrame())
+            {
+                break;
+            }
+            continue;
+        }
+
+        if (iRxSize == 0)
+        {
+            if (!readFrameHeader())
+            {
+                break;
+            }
+            if (iRxFrameOpCode & 0x08)
+            {
+                // ping, pong, or close, which can come between the fragments
+                // of a message
+                handleControlFrame();
+                continue;
+            }
+            if ((iRxFrameOpCode & 0x0f) != TYPE_CONTINUATION)
+            {
+                // the start of a message
+                iRxMessageType = iRxFrameOpCode & 0x0f;
+                iRxMessageLength = 0;
+                iRxMessageTooLong = false;
+            }
+        }
+
+        // Take what has arrived of the frame
+        while (iRxSize > 0)
+        {
+            int n;
+            if (iRxMessageTooLong || iRxMessageLength == aSize)
+            {
+                iRxMessageTooLong = true;
+                flushRx();
+                n = 0;
+            }
+            else
+            {
+                n = read(aBuffer + iRxMessageLength, aSize - iRxMessageLength);
+                if (n > 0)
+                {
+                    iRxMessageLength += n;
+                }
+            }
+            if (iRxSize > 0 && n <= 0)
+            {
+                // wait for the rest
+                break;
+            }
+        }
+        if (iRxSize > 0)
+        {
+            break;
+        }
+
+        if (iRxFrameOpCode & 0x80)
+        {
+            // that was the last frame of the message
+            iRxOpCode = 0x80 | iRxMessageType;
+            if (iRxMessageTooLong)
+            {
+                iRxMessageTooLong = false;
+                iRxMessageLength = 0;
+                return WS_ERROR_MESSAGE_TOO_LONG;
+            }
+            return iRxMessageType;
+        }
+    }
+
+    if (!connected() && !HttpClient::available())
+    {
+        return HTTP_ERROR_CONNECTION_FAILED;
+    }
+
+    if (iKeepAliveInterval > 0)
+    {
+        if (!iPingSent && (millis() - iLastRxTime) >= iKeepAliveInterval)
+        {
+            ping();
+            iPingSent = true;
+            iLastRxTime = millis();
+        }
+        else if (iPingSent && (millis() - iLastRxTime) >= iKeepAliveTimeout)
+        {
+            // the server has gone quiet
+            stop();
+            return HTTP_ERROR_TIMED_OUT;
+        }
+    }
+
+    return 0;
+}
+
+void WebSocketClient::setKeepAlive(uint32_t aInterval, uint32_t aTimeout)
+{
+    iKeepAliveInterval = aInterval;
+    iKeepAliveTimeout = aTimeout;
+    iLastRxTime = millis();
+    iPingSent = false;
+}
+
 int WebSocketClient::messageType()
 {
     return (iRxOpCode & 0x0f);
@@ -285,7 +621,12 @@ String WebSocketClient::readString()
 
         for (int i = 0; i < avail; i++)
         {
-            s += (char)read();
+            int c = read();
+            if (c < 0)
+            {
+                break;
+            }
+            s += (char)c;
         }
     }
 
@@ -302,9 +643,9 @@ int WebSocketClient::ping()
         pingData[i] = random(0xff);
     }
 
-    beginMessage(TYPE_PING);
-    write(pingData, sizeof(pingData));
-    return endMessage();
+    // sent as a frame of its own, so it can go between the fragments of a
+    // message being sent
+    return sendFrame(0x80 | TYPE_PING, pingData, sizeof(pingData));
 }
 
 int WebSocketClient::available()
@@ -319,32 +660,67 @@ int WebSocketClient::available()
 
 int WebSocketClient::read()
 {
-    byte b;
+    if (iState < eReadingBody)
+    {
+        return HttpClient::read();
+    }
 
-    if (read(&b, sizeof(b)))
+    // don't read into the next frame
+    if (iRxSize == 0)
     {
-        return b;
+        return -1;
     }
 
-    return -1;
+    int c = HttpClient::read();
+
+    if (c != -1)
+    {
+        iRxSize--;
+        iLastRxTime = millis();
+        iPingSent = false;
+
+        // unmask the RX data if needed
+        if (iRxMasked)
+        {
+            c = (uint8_t)c ^ iRxMaskKey[iRxMaskIndex & 3];
+        }
+        iRxMaskIndex++;
+    }
+
+    return c;
 }
 
 int WebSocketClient::read(uint8_t *aBuffer, size_t aSize)
 {
+    if (iState < eReadingBody)
+    {
+        return HttpClient::read(aBuffer, aSize);
+    }
+
+    // don't read into the next frame
+    if (aSize > iRxSize)
+    {
+        aSize = iRxSize;
+    }
+    if (aSize == 0)
+    {
+        return 0;
+    }
+
     int readCount = HttpClient::read(aBuffer, aSize);
 
     if (readCount > 0)
     {
         iRxSize -= readCount;
+        iLastRxTime = millis();
+        iPingSent = false;
 
         // unmask the RX data if needed
         if (iRxMasked)
         {
-            for (int i = 0; i < (int)aSize; i++, iRxMaskIndex++)
-            {
-                aBuffer[i] ^= iRxMaskKey[iRxMaskIndex % sizeof(iRxMaskKey)];
-            }
+            mask(aBuffer, readCount, iRxMaskKey, iRxMaskIndex);
         }
+        iRxMaskIndex += readCount;
     }
 
     return readCount;
@@ -357,7 +733,7 @@ int WebSocketClient::peek()
     if (p != -1 && iRxMasked)
     {
         // unmask the RX data if needed
-        p = (uint8_t)p ^ iRxMaskKey[iRxMaskIndex % sizeof(iRxMaskKey)];
+        p = (uint8_t)p ^ iRxMaskKey[iRxMaskIndex & 3];
     }
 
     return p;
@@ -365,8 +741,20 @@ int WebSocketClient::peek()
 
 void WebSocketClient::flushRx()
 {
-    while(available())
+    // throw away what has arrived of the rest of the frame, without waiting
+    // for the rest or unmasking it
+    uint8_t buffer[32];
+    while (iRxSize > 0)
     {
-        read();
+        size_t wanted = (iRxSize < sizeof(buffer)) ? (size_t)iRxSize : sizeof(buffer);
+        int readCount = HttpClient::read(buffer, wanted);
+        if (readCount <= 0)
+        {
+            break;
+        }
+        iRxSize -= readCount;
+        iRxMaskIndex += readCount;
+        iLastRxTime = millis();
+        iPingSent = false;
     }
 }
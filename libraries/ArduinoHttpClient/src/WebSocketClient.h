@@ -19,6 +19,9 @@ static const int TYPE_CONNECTION_CLOSE = 0x8;
 static const int TYPE_PING             = 0x9;
 static const int TYPE_PONG             = 0xa;
 
+// A message received by pollMessage() didn't fit in the buffer
+static const int WS_ERROR_MESSAGE_TOO_LONG = -5;
+
 class WebSocketClient : public HttpClient
 {
 public:
@@ -35,8 +38,10 @@ public:
 
     /** Begin to send a message of type (TYPE_TEXT or TYPE_BINARY)
         Use the write or Stream API's to set message content, followed by endMessage
-        to complete the message.
-      @param aURLPath     Path to use in request
+        to complete the message.  The message can be of any length: whenever
+        the content outgrows the WS_TX_BUFFER_SIZE buffer it is sent as a
+        fragment, and endMessage sends the final one
+      @param aType        Type of message
       @return 0 if successful, else error
     */
     int beginMessage(int aType);
@@ -51,6 +56,36 @@ public:
     */
     int parseMessage();
 
+    /** Receive the next whole message into aBuffer, joining its fragments
+      together, without waiting for it to arrive.  Call it repeatedly
+      (e.g. from loop()); each call reads whatever has arrived, answers pings
+      and sends the keep-alive pings set by setKeepAlive().
+      Don't mix it with parseMessage() and read() on the same connection
+      @param aBuffer Buffer for the message
+      @param aSize   Size of aBuffer
+      @return Type of the message (TYPE_TEXT or TYPE_BINARY) once one has
+              been received, and messageLength() gives its length, 0 while
+              there isn't a whole message yet, WS_ERROR_MESSAGE_TOO_LONG if
+              the message didn't fit in aBuffer (it has been thrown away),
+              HTTP_ERROR_TIMED_OUT if a keep-alive ping wasn't answered, or
+              HTTP_ERROR_CONNECTION_FAILED once the connection has closed
+    */
+    int pollMessage(uint8_t* aBuffer, size_t aSize);
+
+    /** Returns the length of the message received by pollMessage()
+    */
+    size_t messageLength() { return iRxMessageLength; };
+
+    /** Keep an idle connection alive, and notice when it has died, from
+      pollMessage().  A ping is sent when nothing has been received for
+      aInterval, and the connection is closed if nothing arrives within
+      aTimeout after that
+      @param aInterval Time without any data before sending a ping, in
+                       milliseconds, 0 to never send pings
+      @param aTimeout  Time to wait for the answer, in milliseconds
+    */
+    void setKeepAlive(uint32_t aInterval, uint32_t aTimeout);
+
     /** Returns type of current parsed message
       @return type of current parsedMessage (TYPE_TEXT or TYPE_BINARY)
     */
@@ -87,17 +122,73 @@ public:
 private:
     void flushRx();
 
+    /** Send what is in the TX buffer as a frame of the current message
+      @param aFinal true for the last frame of the message
+      @return 0 if successful, else error
+    */
+    int flushTx(bool aFinal);
+
+    /** Send a whole frame.  aData is masked in place
+      @param aOpCode Opcode, with the FIN bit if needed
+      @return 0 if successful, else error
+    */
+    int sendFrame(uint8_t aOpCode, uint8_t* aData, size_t aLength);
+
+    /** Send a frame of the current message straight from the caller's
+      data, masking it a buffer at a time.  The TX buffer must be empty
+    */
+    size_t sendFragment(const uint8_t* aData, size_t aLength);
+
+    /** Send the header of a frame, and choose its mask
+    */
+    bool sendFrameHeader(uint8_t aOpCode, uint64_t aLength, uint8_t aMaskKey[4]);
+
+    /** XOR aData with the mask, a word at a time
+      @param aOffset Position of aData in the frame
+    */
+    static void mask(uint8_t* aData, size_t aLength, const uint8_t aMaskKey[4], size_t aOffset);
+
+    /** Read as much of the next frame header as has arrived
+      @return true once the whole header has been read
+    */
+    bool readFrameHeader();
+
+    /** Answer or act on a ping, pong, or close frame, once all of it has
+      arrived
+      @return true if the frame has been dealt with
+    */
+    bool handleControlFrame();
+
 private:
     bool iTxStarted;
+    // A fragment of the current message has been sent already
+    bool iTxFragmented;
     uint8_t iTxMessageType;
     uint8_t iTxBuffer[WS_TX_BUFFER_SIZE];
-    uint64_t iTxSize;
+    size_t iTxSize;
 
     uint8_t iRxOpCode;
+    // Opcode and FIN bit of the frame being read
+    uint8_t iRxFrameOpCode;
     uint64_t iRxSize;
     bool iRxMasked;
-    int iRxMaskIndex;
+    size_t iRxMaskIndex;
     uint8_t iRxMaskKey[4];
+    // Part of the next frame header received so far
+    uint8_t iRxHeader[14];
+    uint8_t iRxHeaderLength;
+    // Waiting for the rest of a control frame
+    bool iRxControlPending;
+
+    // Message being put together by pollMessage()
+    uint8_t iRxMessageType;
+    size_t iRxMessageLength;
+    bool iRxMessageTooLong;
+
+    uint32_t iKeepAliveInterval;
+    uint32_t iKeepAliveTimeout;
+    unsigned long iLastRxTime;
+    bool iPingSent;
 };
 
 #endif
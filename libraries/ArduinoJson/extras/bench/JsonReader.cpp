@@ -0,0 +1,149 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Streams a 5 MB array through JsonReader and reports the peak heap usage
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Generates the array on the fly, so the input never sits in memory
+class RosterGenerator {
+ public:
+  explicit RosterGenerator(size_t targetSize) : targetSize_(targetSize) {}
+
+  int read() {
+    if (pos_ == chunk_.size() && !refill())
+      return -1;
+    produced_++;
+    return static_cast<unsigned char>(chunk_[pos_++]);
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+      int c = read();
+      if (c < 0)
+        break;
+      buffer[n++] = static_cast<char>(c);
+    }
+    return n;
+  }
+
+  size_t produced() const {
+    return produced_;
+  }
+
+ private:
+  bool refill() {
+    if (done_)
+      return false;
+    char buffer[128];
+    if (index_ == 0) {
+      chunk_ = "[";
+    } else if (produced_ >= targetSize_) {
+      chunk_ = "]";
+      done_ = true;
+      pos_ = 0;
+      return true;
+    } else {
+      chunk_ = ",";
+    }
+    snprintf(buffer, sizeof(buffer),
+             "{\"uid\":\"%08X\",\"student\":\"Student %u\",\"balance\":%u.%02u,"
+             "\"active\":%s}",
+             index_ * 2654435761u, index_, index_ % 100000, index_ % 100,
+             index_ % 7 ? "true" : "false");
+    chunk_ += buffer;
+    index_++;
+    pos_ = 0;
+    return true;
+  }
+
+  size_t targetSize_;
+  size_t produced_ = 0;
+  std::string chunk_;
+  size_t pos_ = 0;
+  unsigned index_ = 0;
+  bool done_ = false;
+};
+
+class PeakAllocator : public ArduinoJson::Allocator {
+ public:
+  virtual ~PeakAllocator() {}
+
+  void* allocate(size_t n) override {
+    auto p = static_cast<size_t*>(malloc(n + sizeof(size_t)));
+    *p = n;
+    add(n);
+    return p + 1;
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr)
+      return;
+    auto p = static_cast<size_t*>(ptr) - 1;
+    current_ -= *p;
+    free(p);
+  }
+
+  void* reallocate(void* ptr, size_t n) override {
+    auto p = ptr ? static_cast<size_t*>(ptr) - 1 : nullptr;
+    size_t old = p ? *p : 0;
+    p = static_cast<size_t*>(realloc(p, n + sizeof(size_t)));
+    *p = n;
+    current_ -= old;
+    add(n);
+    return p + 1;
+  }
+
+  size_t peak() const {
+    return peak_;
+  }
+
+ private:
+  void add(size_t n) {
+    current_ += n;
+    if (current_ > peak_)
+      peak_ = current_;
+  }
+
+  size_t current_ = 0;
+  size_t peak_ = 0;
+};
+
+int main() {
+  PeakAllocator allocator;
+  JsonDocument doc(&allocator);
+  RosterGenerator input(5 * 1024 * 1024);
+  JsonReader<RosterGenerator> reader(input, doc);
+
+  auto start = std::chrono::steady_clock::now();
+
+  size_t count = 0;
+  double total = 0;
+  if (reader.next() == JsonEvent::StartArray) {
+    while (reader.next() == JsonEvent::StartObject) {
+      if (reader.read())
+        break;
+      total += doc["balance"].as<double>();
+      count++;
+    }
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
+  printf("error:       %s\n", reader.error().c_str());
+  printf("input:       %zu bytes\n", input.produced());
+  printf("records:     %zu (checksum %.2f)\n", count, total);
+  printf("time:        %lld ms\n", static_cast<long long>(elapsed));
+  printf("peak memory: %zu bytes (+ %zu bytes of JsonReader)\n",
+         allocator.peak(), sizeof(reader));
+  return 0;
+}
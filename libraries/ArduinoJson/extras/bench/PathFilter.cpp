@@ -0,0 +1,74 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares Filter and PathFilter on getCardInfo() response bodies
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string makeCardInfo(int historySize) {
+  std::string s =
+      "{\"success\":true,\"message\":\"Card found\",\"data\":{\"user\":{"
+      "\"id\":1842,\"name\":\"Siti Rahmawati\",\"email\":\"siti@example.sch."
+      "id\",\"role_type\":\"student\",\"status\":\"active\",\"class\":\"XI "
+      "IPA 2\",\"created_at\":\"2024-07-15T08:12:44.000000Z\"},\"card\":{"
+      "\"id\":977,\"uid\":\"04A1B2C3D4E5F6\",\"balance\":125000.5,\"is_"
+      "blocked\":false,\"permissions\":[\"canteen\",\"library\",\"gate\","
+      "\"bus\"],\"history\":[";
+  for (int i = 0; i < historySize; i++) {
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer),
+             "%s{\"id\":%d,\"terminal_id\":\"T-%03d\",\"amount\":%d.00,\"type\":"
+             "\"payment\",\"created_at\":\"2024-10-%02dT12:00:00Z\"}",
+             i ? "," : "", 10000 + i, i % 40, 5000 + i * 25, 1 + i % 28);
+    s += buffer;
+  }
+  s += "]}}}";
+  return s;
+}
+
+template <typename TFilter>
+static void run(const char* name, const std::string& input,
+                const TFilter& filter) {
+  JsonDocument doc;
+  const int repetitions = 2000;
+  double sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    deserializeJson(doc, input, filter);
+    sink += doc["data"]["card"]["balance"].as<double>();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto us = std::chrono::duration<double, std::micro>(elapsed).count() /
+            repetitions;
+  printf("  %-12s %8.2f us/parse  (checksum %g)\n", name, us, sink);
+}
+
+int main() {
+  const char* paths[] = {"success",           "data.user.name",
+                         "data.user.role_type", "data.user.status",
+                         "data.card.balance", "data.card.is_blocked"};
+
+  JsonDocument filterDoc;
+  filterDoc["success"] = true;
+  filterDoc["data"]["user"]["name"] = true;
+  filterDoc["data"]["user"]["role_type"] = true;
+  filterDoc["data"]["user"]["status"] = true;
+  filterDoc["data"]["card"]["balance"] = true;
+  filterDoc["data"]["card"]["is_blocked"] = true;
+  DeserializationOption::Filter filter(filterDoc);
+  DeserializationOption::PathFilter<> pathFilter(paths);
+
+  int sizes[] = {0, 10, 100, 400};
+  for (int size : sizes) {
+    std::string input = makeCardInfo(size);
+    printf("history = %d entries (%zu bytes)\n", size, input.size());
+    run("Filter", input, filter);
+    run("PathFilter", input, pathFilter);
+  }
+  return 0;
+}
@@ -0,0 +1,157 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares JsonBinding with a JsonDocument (with and without PathFilter) on
+// the responses handled by getCardInfo() and processTransactionResponse():
+// time per parse and peak heap usage
+
+#include <ArduinoJson.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "harness.hpp"
+
+// The response to a payment, as read by processTransactionResponse()
+static const char transactionResponse[] =
+    "{\"success\":true,\"message\":\"Payment accepted\",\"data\":{"
+    "\"transaction\":{\"id\":884213,\"amount\":12500,\"type\":\"payment\","
+    "\"created_at\":\"2024-10-12T07:41:03Z\"},\"card\":{\"uid\":"
+    "\"04A1B2C3D4E5F6\",\"balance\":112500.5,\"is_blocked\":false},\"user\":{"
+    "\"name\":\"Siti Rahmawati\",\"class\":\"XI IPA 2\"}}}";
+
+struct Transaction {
+  bool success;
+  char message[32];
+  long id;
+  double amount;
+  double balance;
+};
+
+static const auto transactionBinding =
+    bindJson(jsonField("success", &Transaction::success),
+             jsonField("message", &Transaction::message),
+             jsonField("data.transaction.id", &Transaction::id),
+             jsonField("data.transaction.amount", &Transaction::amount),
+             jsonField("data.card.balance", &Transaction::balance));
+
+static const char* transactionPaths[] = {
+    "success", "message", "data.transaction.id", "data.transaction.amount",
+    "data.card.balance"};
+
+template <size_t N>
+static void copyString(char (&dst)[N], const char* src) {
+  strncpy(dst, src, N - 1);
+  dst[N - 1] = 0;
+}
+
+static void readTransaction(Transaction& t, JsonDocument& doc) {
+  t.success = doc["success"];
+  copyString(t.message, doc["message"] | "");
+  t.id = doc["data"]["transaction"]["id"];
+  t.amount = doc["data"]["transaction"]["amount"];
+  t.balance = doc["data"]["card"]["balance"];
+}
+
+// The response to a card lookup, as read by getCardInfo()
+static std::string makeCardInfo(int historySize) {
+  std::string s =
+      "{\"success\":true,\"message\":\"Card found\",\"data\":{\"user\":{"
+      "\"id\":1842,\"name\":\"Siti Rahmawati\",\"email\":\"siti@example.sch."
+      "id\",\"role_type\":\"student\",\"status\":\"active\",\"class\":\"XI "
+      "IPA 2\",\"created_at\":\"2024-07-15T08:12:44.000000Z\"},\"card\":{"
+      "\"id\":977,\"uid\":\"04A1B2C3D4E5F6\",\"balance\":125000.5,\"is_"
+      "blocked\":false,\"permissions\":[\"canteen\",\"library\",\"gate\","
+      "\"bus\"],\"history\":[";
+  for (int i = 0; i < historySize; i++) {
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer),
+             "%s{\"id\":%d,\"terminal_id\":\"T-%03d\",\"amount\":%d.00,\"type\":"
+             "\"payment\",\"created_at\":\"2024-10-%02dT12:00:00Z\"}",
+             i ? "," : "", 10000 + i, i % 40, 5000 + i * 25, 1 + i % 28);
+    s += buffer;
+  }
+  s += "]}}}";
+  return s;
+}
+
+struct CardInfo {
+  bool success;
+  bool isBlocked;
+  double balance;
+  char userType[16];
+  char status[16];
+};
+
+static const auto cardInfoBinding =
+    bindJson(jsonField("success", &CardInfo::success),
+             jsonField("data.card.is_blocked", &CardInfo::isBlocked),
+             jsonField("data.card.balance", &CardInfo::balance),
+             jsonField("data.user.role_type", &CardInfo::userType),
+             jsonField("data.user.status", &CardInfo::status));
+
+static const char* cardInfoPaths[] = {"success", "data.card.is_blocked",
+                                      "data.card.balance", "data.user.role_type",
+                                      "data.user.status"};
+
+static void readCardInfo(CardInfo& info, JsonDocument& doc) {
+  info.success = doc["success"];
+  info.isBlocked = doc["data"]["card"]["is_blocked"];
+  info.balance = doc["data"]["card"]["balance"];
+  copyString(info.userType, doc["data"]["user"]["role_type"] | "");
+  copyString(info.status, doc["data"]["user"]["status"] | "");
+}
+
+static double sink = 0;
+
+template <typename TStruct, typename TBinding, size_t N>
+static void compare(BenchmarkHarness& harness, const char* corpus,
+                    const std::string& json, const TBinding& binding,
+                    const char* const (&paths)[N],
+                    void (*read)(TStruct&, JsonDocument&)) {
+  harness.run("JsonDocument", corpus, json.size(), [&](Allocator* allocator) {
+    JsonDocument doc(allocator);
+    TStruct value;
+    deserializeJson(doc, json);
+    read(value, doc);
+    sink += value.success;
+  });
+
+  DeserializationOption::PathFilter<> filter(paths);
+  harness.run("PathFilter", corpus, json.size(), [&](Allocator* allocator) {
+    JsonDocument doc(allocator);
+    TStruct value;
+    deserializeJson(doc, json, filter);
+    read(value, doc);
+    sink += value.success;
+  });
+
+  harness.run("JsonBinding", corpus, json.size(), [&](Allocator* allocator) {
+    TStruct value;
+    binding.deserialize(value, json, allocator);
+    sink += value.success;
+  });
+}
+
+int main(int argc, const char* argv[]) {
+  BenchmarkHarness harness;
+  if (argc > 1)
+    harness.setFilter(argv[1]);
+
+  compare(harness, "transaction", transactionResponse, transactionBinding,
+          transactionPaths, readTransaction);
+  compare(harness, "card-info", makeCardInfo(0), cardInfoBinding, cardInfoPaths,
+          readCardInfo);
+  compare(harness, "card-info-50", makeCardInfo(50), cardInfoBinding,
+          cardInfoPaths, readCardInfo);
+
+  for (auto& r : harness.results()) {
+    printf("%-12s %-12s %6zu B  median %9.0f ns  %3zu allocs  peak %6zu B\n",
+           r.name.c_str(), r.corpus.c_str(), r.inputSize, r.medianNs,
+           r.allocations + r.reallocations, r.peakBytes);
+  }
+  printf("(checksum %g)\n", sink);
+  return 0;
+}
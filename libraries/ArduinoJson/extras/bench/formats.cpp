@@ -0,0 +1,145 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares JSON, MessagePack and CBOR on a card record and a config snapshot:
+// encoded size, deserialization time and serialization time
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static const int repetitions = 20000;
+
+static void makeCardRecord(JsonDocument& doc, int historySize) {
+  doc["uid"] = "04A1B2C3D4E5F6";
+  doc["balance"] = 125000.5;
+  doc["is_blocked"] = false;
+  JsonObject user = doc["user"].to<JsonObject>();
+  user["id"] = 1842;
+  user["name"] = "Siti Rahmawati";
+  user["class"] = "XI IPA 2";
+  JsonArray permissions = doc["permissions"].to<JsonArray>();
+  permissions.add("canteen");
+  permissions.add("library");
+  permissions.add("gate");
+  JsonArray history = doc["history"].to<JsonArray>();
+  for (int i = 0; i < historySize; i++) {
+    JsonObject entry = history.add<JsonObject>();
+    entry["id"] = 10000 + i;
+    entry["terminal"] = i % 40;
+    entry["amount"] = 5000 + i * 25;
+    entry["timestamp"] = 1729000000 + i * 3600;
+  }
+}
+
+static void makeConfigSnapshot(JsonDocument& doc) {
+  doc["version"] = 7;
+  JsonObject wifi = doc["wifi"].to<JsonObject>();
+  wifi["ssid"] = "Kantin-Utama";
+  wifi["channel"] = 6;
+  wifi["tx_power"] = 19.5;
+  JsonObject server = doc["server"].to<JsonObject>();
+  server["host"] = "api.example.sch.id";
+  server["port"] = 443;
+  server["timeout_ms"] = 5000;
+  server["retry"] = true;
+  JsonArray readers = doc["readers"].to<JsonArray>();
+  for (int i = 0; i < 4; i++) {
+    JsonObject reader = readers.add<JsonObject>();
+    reader["slot"] = i;
+    reader["gain"] = 0.25 * (i + 1);
+    reader["enabled"] = i != 2;
+  }
+}
+
+struct Format {
+  const char* name;
+  size_t (*serialize)(JsonVariantConst, std::string&);
+  DeserializationError (*deserialize)(JsonDocument&, const std::string&);
+};
+
+static const Format formats[] = {
+    {"JSON",
+     [](JsonVariantConst src, std::string& dst) {
+       return serializeJson(src, dst);
+     },
+     [](JsonDocument& doc, const std::string& src) {
+       return deserializeJson(doc, src);
+     }},
+    {"MessagePack",
+     [](JsonVariantConst src, std::string& dst) {
+       return serializeMsgPack(src, dst);
+     },
+     [](JsonDocument& doc, const std::string& src) {
+       return deserializeMsgPack(doc, src);
+     }},
+    {"CBOR",
+     [](JsonVariantConst src, std::string& dst) {
+       return serializeCbor(src, dst);
+     },
+     [](JsonDocument& doc, const std::string& src) {
+       return deserializeCbor(doc, src);
+     }},
+};
+
+static double sink = 0;
+
+static void compare(const char* name, const JsonDocument& source) {
+  printf("%s\n", name);
+
+  size_t jsonSize = measureJson(source);
+
+  for (const Format& format : formats) {
+    std::string encoded;
+    format.serialize(source, encoded);
+
+    JsonDocument doc;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++) {
+      format.deserialize(doc, encoded);
+      sink += double(doc.size());
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    auto parseUs =
+        std::chrono::duration<double, std::micro>(elapsed).count() /
+        repetitions;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++) {
+      std::string output;
+      sink += double(format.serialize(doc, output));
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    auto serializeUs =
+        std::chrono::duration<double, std::micro>(elapsed).count() /
+        repetitions;
+
+    printf("  %-12s %5zu bytes (%3.0f%%)  %7.2f us/parse  %7.2f us/serialize\n",
+           format.name, encoded.size(),
+           100.0 * double(encoded.size()) / double(jsonSize), parseUs,
+           serializeUs);
+  }
+}
+
+int main() {
+  {
+    JsonDocument doc;
+    makeCardRecord(doc, 0);
+    compare("card record", doc);
+  }
+  {
+    JsonDocument doc;
+    makeCardRecord(doc, 20);
+    compare("card record (20 history items)", doc);
+  }
+  {
+    JsonDocument doc;
+    makeConfigSnapshot(doc);
+    compare("config snapshot", doc);
+  }
+  printf("(checksum %g)\n", sink);
+  return 0;
+}
@@ -0,0 +1,156 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Replays the JSON traffic of a payment terminal (token request, transaction
+// request, server response) and counts the allocator calls per tap with:
+// - a new JsonDocument for each message (the usual pattern),
+// - a single JsonDocument with retainMemory(),
+// - a single JsonDocument backed by an ArenaAllocator.
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "Allocators.hpp"
+
+static const long taps = 100000;
+
+static const char tokenResponse[] =
+    "{\"success\":true,\"token\":\"eyJhbGciOiJIUzI1NiJ9.eyJzdWIiOiJULTAxMiJ9."
+    "c2lnbmF0dXJl\",\"expires_in\":3600}";
+
+static const char transactionResponse[] =
+    "{\"success\":true,\"message\":\"Payment accepted\",\"data\":{"
+    "\"transaction\":{\"id\":884213,\"amount\":12500,\"type\":\"payment\","
+    "\"created_at\":\"2024-10-12T07:41:03Z\"},\"card\":{\"uid\":"
+    "\"04A1B2C3D4E5F6\",\"balance\":112500.5,\"is_blocked\":false},\"user\":{"
+    "\"name\":\"Siti Rahmawati\",\"class\":\"XI IPA 2\"}}}";
+
+static double sink = 0;
+
+// One tap: getToken(), sendToServer(), handleServerResponse(),
+// processTransactionResponse()
+template <typename TDocumentFactory>
+static void tap(long i, TDocumentFactory& documents) {
+  char output[256];
+
+  {
+    JsonDocument& doc = documents.get();
+    doc["terminal_id"] = "T-012";
+    doc["secret"] = "s3cr3t";
+    serializeJson(doc, output);
+  }
+  {
+    JsonDocument& doc = documents.get();
+    deserializeJson(doc, tokenResponse);
+    sink += doc["expires_in"].as<double>();
+  }
+  {
+    JsonDocument& doc = documents.get();
+    doc["uid"] = "04A1B2C3D4E5F6";
+    doc["amount"] = 12500 + i % 100;
+    doc["terminal_id"] = "T-012";
+    doc["nonce"] = std::to_string(i);
+    serializeJson(doc, output);
+  }
+  {
+    JsonDocument& doc = documents.get();
+    deserializeJson(doc, transactionResponse);
+    sink += doc["data"]["card"]["balance"].as<double>();
+  }
+  {
+    JsonDocument& doc = documents.get();
+    deserializeJson(doc, transactionResponse);
+    JsonObject data = doc["data"];
+    sink += data["transaction"]["amount"].as<double>();
+    sink += double(data["user"]["name"].as<std::string>().size());
+  }
+}
+
+// Constructs a new document for each message
+class FreshDocuments {
+ public:
+  FreshDocuments(Allocator* allocator) : allocator_(allocator) {}
+
+  ~FreshDocuments() {
+    delete doc_;
+  }
+
+  JsonDocument& get() {
+    delete doc_;
+    doc_ = new JsonDocument(allocator_);
+    return *doc_;
+  }
+
+ private:
+  Allocator* allocator_;
+  JsonDocument* doc_ = nullptr;
+};
+
+// Clears the same document for each message
+class SharedDocument {
+ public:
+  SharedDocument(Allocator* allocator, bool retain) : doc_(allocator) {
+    doc_.retainMemory(retain);
+  }
+
+  JsonDocument& get() {
+    doc_.clear();
+    return doc_;
+  }
+
+ private:
+  JsonDocument doc_;
+};
+
+template <typename TDocumentFactory>
+static void run(const char* name, TrackingAllocator& tracker,
+                TDocumentFactory& documents) {
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < taps; i++)
+    tap(i, documents);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto us = std::chrono::duration<double, std::micro>(elapsed).count() / taps;
+  auto calls = tracker.allocations() + tracker.reallocations() +
+               tracker.deallocations();
+  printf("  %-16s %7.2f us/tap %8.2f allocator calls/tap  peak %6zu bytes\n", name,
+         us, double(calls) / taps, tracker.peakBytes());
+}
+
+int main() {
+  printf("%ld taps\n", taps);
+
+  {
+    TrackingAllocator tracker;
+    FreshDocuments documents(&tracker);
+    run("new documents", tracker, documents);
+  }
+
+  {
+    TrackingAllocator tracker;
+    SharedDocument documents(&tracker, false);
+    run("clear()", tracker, documents);
+  }
+
+  {
+    TrackingAllocator tracker;
+    SharedDocument documents(&tracker, true);
+    run("retainMemory()", tracker, documents);
+  }
+
+  {
+    static char buffer[8192];
+    ArenaAllocator arena(buffer, sizeof(buffer));
+    TrackingAllocator tracker(&arena);  // malloc() is never called
+    SharedDocument documents(&tracker, false);
+    run("ArenaAllocator", tracker, documents);
+    printf("  %-16s arena high-water mark %zu/%zu bytes\n", "",
+           arena.highWaterMark(), arena.capacity());
+  }
+
+  printf("(checksum %g)\n", sink);
+  return 0;
+}
@@ -0,0 +1,120 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares a JsonDocument with its frozen image (freezeJson()) on a
+// configuration object and an allow-list: key lookup, iteration, and size
+
+#include <ArduinoJson.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+
+static std::vector<std::string> makeConfig(JsonDocument& doc, int count) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < count; i++) {
+    char key[32];
+    snprintf(key, sizeof(key), "setting_%03d_%s", (i * 37) % count,
+             i % 2 ? "enabled" : "value");
+    keys.push_back(key);
+    if (i % 2)
+      doc[key] = i % 3 == 0;
+    else
+      doc[key] = i * 100;
+  }
+  return keys;
+}
+
+static void makeAllowList(JsonDocument& doc, int count) {
+  JsonArray list = doc["cards"].to<JsonArray>();
+  for (int i = 0; i < count; i++) {
+    char uid[16];
+    snprintf(uid, sizeof(uid), "%08X", unsigned(i) * 2654435761u);
+    JsonObject card = list.add<JsonObject>();
+    card["uid"] = uid;
+    card["limit"] = 50000 + i;
+    card["blocked"] = i % 17 == 0;
+  }
+}
+
+static double sink = 0;
+
+static void runConfig(BenchmarkHarness& harness, int count) {
+  char corpus[32];
+  snprintf(corpus, sizeof(corpus), "config-%d", count);
+
+  JsonDocument doc;
+  auto keys = makeConfig(doc, count);
+  std::vector<uint8_t> image(measureFrozenJson(doc));
+  freezeJson(doc, image.data(), image.size());
+  JsonFrozenVariant frozen(image.data(), image.size());
+
+  harness.run("lookup/document", corpus, image.size(), [&](Allocator*) {
+    for (auto& key : keys)
+      sink += doc[key].as<int>();
+  });
+
+  harness.run("lookup/frozen", corpus, image.size(), [&](Allocator*) {
+    for (auto& key : keys)
+      sink += frozen[key].as<int>();
+  });
+}
+
+static void runAllowList(BenchmarkHarness& harness, int count) {
+  char corpus[32];
+  snprintf(corpus, sizeof(corpus), "allow-%d", count);
+
+  JsonDocument doc;
+  makeAllowList(doc, count);
+  std::vector<uint8_t> image(measureFrozenJson(doc));
+  freezeJson(doc, image.data(), image.size());
+  JsonFrozenVariant frozen(image.data(), image.size());
+
+  harness.run("iterate/document", corpus, image.size(), [&](Allocator*) {
+    for (JsonObjectConst card : doc["cards"].as<JsonArrayConst>())
+      sink += card["limit"].as<int>();
+  });
+
+  harness.run("iterate/frozen", corpus, image.size(), [&](Allocator*) {
+    JsonFrozenVariant cards = frozen["cards"];
+    for (size_t i = 0; i < cards.size(); i++)
+      sink += cards[i]["limit"].as<int>();
+  });
+
+  harness.run("freeze", corpus, image.size(), [&](Allocator*) {
+    sink += double(freezeJson(doc, image.data(), image.size()));
+  });
+
+  // what it costs to load the list from JSON every time instead
+  std::string json;
+  serializeJson(doc, json);
+  harness.run("deserialize", corpus, json.size(), [&](Allocator* allocator) {
+    JsonDocument copy(allocator);
+    deserializeJson(copy, json);
+    sink += double(copy.size());
+  });
+
+  printf("%-10s JSON %6zu B  document %6zu B  frozen image %6zu B\n", corpus,
+         json.size(), harness.results().back().peakBytes, image.size());
+}
+
+int main(int argc, const char* argv[]) {
+  BenchmarkHarness harness;
+  if (argc > 1)
+    harness.setFilter(argv[1]);
+
+  runConfig(harness, 16);
+  runConfig(harness, 256);
+  runAllowList(harness, 100);
+  runAllowList(harness, 2000);
+
+  for (auto& r : harness.results()) {
+    printf("%-17s %-11s median %10.0f ns  p95 %10.0f ns\n", r.name.c_str(),
+           r.corpus.c_str(), r.medianNs, r.p95Ns);
+  }
+  printf("(checksum %g)\n", sink);
+  return 0;
+}
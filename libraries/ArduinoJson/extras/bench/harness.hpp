@@ -0,0 +1,149 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Allocators.hpp"
+
+// A minimal timing harness: each benchmark runs a few warmup iterations, then
+// a number of samples, each sample being a batch of iterations long enough to
+// be measured reliably. One extra iteration runs with a TrackingAllocator to
+// count the allocator calls.
+class BenchmarkHarness {
+ public:
+  struct Result {
+    std::string name;
+    std::string corpus;
+    size_t inputSize;
+    double medianNs;
+    double p95Ns;
+    double minNs;
+    size_t iterationsPerSample;
+    size_t allocations;
+    size_t reallocations;
+    size_t deallocations;
+    size_t peakBytes;
+  };
+
+  BenchmarkHarness(int samples = 31, int warmup = 3,
+                   double minSampleUs = 500)
+      : samples_(samples), warmup_(warmup), minSampleUs_(minSampleUs) {}
+
+  // Runs the benchmark if its name contains the filter.
+  // The function receives the allocator that the documents must use.
+  template <typename TFunction>
+  void run(const char* name, const char* corpus, size_t inputSize,
+           TFunction function) {
+    std::string fullName = std::string(name) + "/" + corpus;
+    if (fullName.find(filter_) == std::string::npos)
+      return;
+
+    Allocator* allocator = detail::DefaultAllocator::instance();
+
+    for (int i = 0; i < warmup_; i++)
+      function(allocator);
+
+    size_t batch = calibrate(function, allocator);
+
+    std::vector<double> samples;
+    for (int i = 0; i < samples_; i++) {
+      auto start = clock::now();
+      for (size_t j = 0; j < batch; j++)
+        function(allocator);
+      samples.push_back(elapsedNs(start) / double(batch));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    TrackingAllocator tracker;
+    function(&tracker);
+
+    Result result;
+    result.name = name;
+    result.corpus = corpus;
+    result.inputSize = inputSize;
+    result.medianNs = percentile(samples, 50);
+    result.p95Ns = percentile(samples, 95);
+    result.minNs = samples.front();
+    result.iterationsPerSample = batch;
+    result.allocations = tracker.allocations();
+    result.reallocations = tracker.reallocations();
+    result.deallocations = tracker.deallocations();
+    result.peakBytes = tracker.peakBytes();
+    results_.push_back(result);
+  }
+
+  void setFilter(const char* filter) {
+    filter_ = filter;
+  }
+
+  const std::vector<Result>& results() const {
+    return results_;
+  }
+
+  // Writes the results in a JSON document that can be diffed between versions
+  void toJson(JsonDocument& doc) const {
+    doc["version"] = ARDUINOJSON_VERSION;
+    doc["samples"] = samples_;
+    doc["warmup"] = warmup_;
+    JsonArray array = doc["results"].to<JsonArray>();
+    for (const Result& r : results_) {
+      JsonObject obj = array.add<JsonObject>();
+      obj["name"] = r.name;
+      obj["corpus"] = r.corpus;
+      obj["input_bytes"] = r.inputSize;
+      obj["median_ns"] = round(r.medianNs);
+      obj["p95_ns"] = round(r.p95Ns);
+      obj["min_ns"] = round(r.minNs);
+      obj["iterations_per_sample"] = r.iterationsPerSample;
+      obj["allocations"] = r.allocations;
+      obj["reallocations"] = r.reallocations;
+      obj["deallocations"] = r.deallocations;
+      obj["peak_bytes"] = r.peakBytes;
+    }
+  }
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  static double elapsedNs(clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(clock::now() - start)
+        .count();
+  }
+
+  // Doubles the batch size until one batch lasts at least minSampleUs_
+  template <typename TFunction>
+  size_t calibrate(TFunction& function, Allocator* allocator) const {
+    size_t batch = 1;
+    for (;;) {
+      auto start = clock::now();
+      for (size_t j = 0; j < batch; j++)
+        function(allocator);
+      if (elapsedNs(start) >= minSampleUs_ * 1000 || batch >= (1 << 24))
+        return batch;
+      batch *= 2;
+    }
+  }
+
+  static double percentile(const std::vector<double>& sorted, int p) {
+    size_t index = (sorted.size() - 1) * size_t(p) / 100;
+    return sorted[index];
+  }
+
+  static double round(double value) {
+    return double(static_cast<long long>(value + 0.5));
+  }
+
+  int samples_;
+  int warmup_;
+  double minSampleUs_;
+  std::string filter_;
+  std::vector<Result> results_;
+};
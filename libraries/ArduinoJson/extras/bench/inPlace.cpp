@@ -0,0 +1,83 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares deserializeJson() and deserializeJsonInPlace() on getCardInfo()
+// and login response bodies: peak memory used by the document and parse time
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "Allocators.hpp"
+
+static std::string makeCardInfo(int historySize) {
+  std::string s =
+      "{\"success\":true,\"message\":\"Card found\",\"data\":{\"user\":{"
+      "\"id\":1842,\"name\":\"Siti Rahmawati\",\"email\":\"siti@example.sch."
+      "id\",\"role_type\":\"student\",\"status\":\"active\",\"class\":\"XI "
+      "IPA 2\",\"created_at\":\"2024-07-15T08:12:44.000000Z\"},\"card\":{"
+      "\"id\":977,\"uid\":\"04A1B2C3D4E5F6\",\"balance\":125000.5,\"is_"
+      "blocked\":false,\"permissions\":[\"canteen\",\"library\",\"gate\","
+      "\"bus\"],\"history\":[";
+  for (int i = 0; i < historySize; i++) {
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer),
+             "%s{\"id\":%d,\"terminal_id\":\"T-%03d\",\"amount\":%d.00,\"type\":"
+             "\"payment\",\"created_at\":\"2024-10-%02dT12:00:00Z\"}",
+             i ? "," : "", 10000 + i, i % 40, 5000 + i * 25, 1 + i % 28);
+    s += buffer;
+  }
+  s += "]}}}";
+  return s;
+}
+
+static const char loginResponse[] =
+    "{\"success\":true,\"message\":\"Login successful\",\"data\":{\"token\":"
+    "\"eyJ0eXAiOiJKV1QiLCJhbGciOiJIUzI1NiJ9.eyJpc3MiOiJodHRwczpcL1wvYXBpLmV4"
+    "YW1wbGUuc2NoLmlkIiwic3ViIjoiVC0wMTIiLCJpYXQiOjE3MjkwMDAwMDB9.c2lnbmF0dX"
+    "Jl\",\"token_type\":\"Bearer\",\"expires_in\":3600,\"terminal\":{\"id\":"
+    "\"T-012\",\"name\":\"Kantin Utama\",\"location\":\"Gedung B, Lantai 1\","
+    "\"merchant\":\"Koperasi Sekolah\"}}}";
+
+template <typename TParse>
+static void measure(const char* name, const std::string& input,
+                    TParse parse) {
+  const int repetitions = 2000;
+  size_t peak = 0, kept = 0;
+  double us = 0;
+
+  for (int i = 0; i < repetitions; i++) {
+    std::string buffer = input;  // deserializeJsonInPlace() modifies it
+    TrackingAllocator tracker;
+    JsonDocument doc(&tracker);
+    auto start = std::chrono::steady_clock::now();
+    parse(doc, &buffer[0]);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    us += std::chrono::duration<double, std::micro>(elapsed).count();
+    peak = tracker.peakBytes();
+    kept = tracker.allocatedBytes();
+  }
+
+  printf("  %-24s %8.2f us/parse  peak %6zu bytes  kept %6zu bytes\n", name,
+         us / repetitions, peak, kept);
+}
+
+static void compare(const char* name, const std::string& input) {
+  printf("%s (%zu bytes)\n", name, input.size());
+  measure("deserializeJson()", input, [](JsonDocument& doc, char* json) {
+    deserializeJson(doc, json);
+  });
+  measure("deserializeJsonInPlace()", input, [](JsonDocument& doc, char* json) {
+    deserializeJsonInPlace(doc, json);
+  });
+}
+
+int main() {
+  compare("login", loginResponse);
+  compare("card info (10 history items)", makeCardInfo(10));
+  compare("card info (50 history items)", makeCardInfo(50));
+  return 0;
+}
@@ -0,0 +1,74 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Writes and reads back 100k tap events as JSON Lines (JsonLinesWriter and
+// JsonLinesReader). The peak memory stays at one record, whatever the size of
+// the batch.
+
+#include <ArduinoJson.h>
+
+#include <cstdio>
+#include <string>
+
+#include "harness.hpp"
+
+static const int records = 100000;
+
+static double sink = 0;
+
+static void makeTap(JsonDocument& doc, int i) {
+  char uid[16];
+  snprintf(uid, sizeof(uid), "04%08X", unsigned(i) * 2654435761u);
+  doc.clear();
+  doc["seq"] = i;
+  doc["uid"] = uid;
+  doc["amount"] = 12500 + i % 100;
+  doc["terminal_id"] = "T-012";
+  doc["ts"] = 1728718863 + i;
+  doc["offline"] = i % 7 == 0;
+}
+
+int main(int argc, const char* argv[]) {
+  BenchmarkHarness harness(7, 1);
+  if (argc > 1)
+    harness.setFilter(argv[1]);
+
+  std::string lines;
+  {
+    JsonDocument doc;
+    JsonLinesWriter<std::string> writer(lines);
+    for (int i = 0; i < records; i++) {
+      makeTap(doc, i);
+      writer.write(doc);
+    }
+  }
+
+  harness.run("write", "lines", lines.size(), [&](Allocator* allocator) {
+    JsonDocument doc(allocator);
+    std::string output;
+    output.reserve(lines.size());
+    JsonLinesWriter<std::string> writer(output);
+    for (int i = 0; i < records; i++) {
+      makeTap(doc, i);
+      writer.write(doc);
+    }
+    sink += double(writer.bytesWritten());
+  });
+
+  harness.run("read", "lines", lines.size(), [&](Allocator* allocator) {
+    JsonDocument doc(allocator);
+    JsonLinesReader<std::string> reader(lines, doc);
+    while (reader.next())
+      sink += doc["amount"].as<int>();
+  });
+
+  for (auto& r : harness.results()) {
+    printf("%-6s %-6s %9zu B  median %7.2f ms  %6.2f Mrecords/s  peak %9zu B  "
+           "%zu allocs\n",
+           r.name.c_str(), r.corpus.c_str(), r.inputSize, r.medianNs / 1e6,
+           records / r.medianNs * 1e3, r.peakBytes, r.allocations);
+  }
+  printf("(checksum %g)\n", sink);
+  return 0;
+}
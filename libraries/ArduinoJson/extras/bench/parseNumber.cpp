@@ -0,0 +1,93 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace ArduinoJson::detail;
+
+enum class Format { Integer, Decimal, Coordinate, Scientific };
+
+static std::vector<std::string> generate(Format format, size_t count,
+                                         unsigned long long range) {
+  std::vector<std::string> result;
+  srand(42);
+  for (size_t i = 0; i < count; i++) {
+    unsigned long long value =
+        (static_cast<unsigned long long>(rand()) << 31 ^
+         static_cast<unsigned long long>(rand())) %
+        range;
+    char buffer[64];
+    switch (format) {
+      case Format::Integer:
+        snprintf(buffer, sizeof(buffer), "%llu", value);
+        break;
+      case Format::Decimal:
+        snprintf(buffer, sizeof(buffer), "%llu.%02llu", value / 100,
+                 value % 100);
+        break;
+      case Format::Coordinate:
+        snprintf(buffer, sizeof(buffer), "%llu.%06llu", value / 1000000,
+                 value % 1000000);
+        break;
+      case Format::Scientific:
+        snprintf(buffer, sizeof(buffer), "%llue-%llu", value / 100,
+                 value % 20);
+        break;
+    }
+    result.push_back(buffer);
+  }
+  return result;
+}
+
+template <typename TFunc>
+static void run(const char* name, const std::vector<std::string>& inputs,
+                TFunc func) {
+  const int repetitions = 50;
+  double sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repetitions; r++)
+    for (const auto& s : inputs)
+      sink += func(s.c_str());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double ns = static_cast<double>(
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                      .count()) /
+              static_cast<double>(repetitions * inputs.size());
+  printf("%-28s %8.2f ns/number  (checksum %g)\n", name, ns, sink);
+}
+
+int main() {
+  const size_t count = 100000;
+
+  struct {
+    const char* name;
+    std::vector<std::string> inputs;
+  } corpora[] = {
+      {"ids (6 digits)", generate(Format::Integer, count, 1000000)},
+      {"timestamps (10 digits)",
+       generate(Format::Integer, count, 10000000000)},
+      {"card numbers (16 digits)",
+       generate(Format::Integer, count, 10000000000000000)},
+      {"balances (x.yy)", generate(Format::Decimal, count, 100000000)},
+      {"coordinates (x.yyyyyy)",
+       generate(Format::Coordinate, count, 180000000)},
+      {"scientific (xe-y)", generate(Format::Scientific, count, 200000)},
+  };
+
+  for (auto& corpus : corpora) {
+    printf("%s\n", corpus.name);
+    run("  parseNumber<double>()", corpus.inputs,
+        [](const char* s) { return parseNumber<double>(s); });
+    run("  strtod()", corpus.inputs,
+        [](const char* s) { return strtod(s, nullptr); });
+  }
+
+  return 0;
+}
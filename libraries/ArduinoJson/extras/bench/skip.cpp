@@ -0,0 +1,98 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Extracts a few fields from a 64 KB card-info response where the filter
+// rejects about 95% of the content (transaction history, permissions).
+// Compares the inputs that the SkipScanner reads directly (char* and char*
+// with a size) with a stream, which goes through the character-by-character
+// skipVariant().
+
+#include <ArduinoJson.h>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "harness.hpp"
+
+static std::string makeCardInfo(size_t targetSize) {
+  std::string json =
+      "{\"success\":true,\"data\":{\"card\":{\"uid\":\"04A1B2C3D4E5F6\","
+      "\"balance\":112500.5,\"is_blocked\":false},\"user\":{\"name\":"
+      "\"Siti Rahmawati\",\"class\":\"XI IPA 2\"},\"history\":[";
+  for (int i = 0; json.size() < targetSize * 85 / 100; i++) {
+    char entry[256];
+    snprintf(entry, sizeof(entry),
+             "%s{\"id\":%d,\"amount\":%d,\"type\":\"payment\",\"merchant\":"
+             "\"Canteen #%d \\\"Kantin Sehat\\\"\",\"created_at\":"
+             "\"2024-10-%02dT07:41:03Z\",\"tags\":[\"food\",\"school\"]}",
+             i ? "," : "", 884213 + i, 12500 + i % 100, i % 7, 1 + i % 28);
+    json += entry;
+  }
+  json += "],\"permissions\":{";
+  for (int i = 0; json.size() < targetSize; i++) {
+    char entry[128];
+    snprintf(entry, sizeof(entry),
+             "%s\"door_%d\":{\"allowed\":%s,\"schedule\":[[7,0],[15,30]]}",
+             i ? "," : "", i, i % 3 ? "true" : "false");
+    json += entry;
+  }
+  json += "}}}";
+  return json;
+}
+
+static double sink = 0;
+
+int main(int argc, const char* argv[]) {
+  BenchmarkHarness harness;
+  if (argc > 1)
+    harness.setFilter(argv[1]);
+
+  std::string json = makeCardInfo(64 * 1024);
+
+  JsonDocument filter;
+  filter["success"] = true;
+  filter["data"]["card"]["uid"] = true;
+  filter["data"]["card"]["balance"] = true;
+  filter["data"]["user"]["name"] = true;
+
+  auto extract = [&](JsonDocument& doc) {
+    sink += doc["data"]["card"]["balance"].as<double>();
+    sink += double(doc["data"]["user"]["name"].as<JsonString>().size());
+  };
+
+  harness.run("skip/char*", "card-64k", json.size(), [&](Allocator* a) {
+    JsonDocument doc(a);
+    deserializeJson(doc, json.c_str(), DeserializationOption::Filter(filter));
+    extract(doc);
+  });
+
+  harness.run("skip/char*+size", "card-64k", json.size(), [&](Allocator* a) {
+    JsonDocument doc(a);
+    deserializeJson(doc, json.data(), json.size(),
+                    DeserializationOption::Filter(filter));
+    extract(doc);
+  });
+
+  harness.run("skip/stream", "card-64k", json.size(), [&](Allocator* a) {
+    JsonDocument doc(a);
+    std::istringstream stream(json);
+    deserializeJson(doc, stream, DeserializationOption::Filter(filter));
+    extract(doc);
+  });
+
+  harness.run("parse/no filter", "card-64k", json.size(), [&](Allocator* a) {
+    JsonDocument doc(a);
+    deserializeJson(doc, json.data(), json.size());
+    extract(doc);
+  });
+
+  for (auto& r : harness.results()) {
+    printf("%-16s %-9s %6zu B  median %8.1f us  %7.1f MB/s\n", r.name.c_str(),
+           r.corpus.c_str(), r.inputSize, r.medianNs / 1000,
+           double(r.inputSize) / r.medianNs * 1000);
+  }
+  printf("(checksum %g)\n", sink);
+  return 0;
+}
@@ -0,0 +1,197 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Runs the hot paths (parse, serialize, measure, lookup, copy) on three
+// corpora and prints the results as JSON, so two versions can be compared.
+//
+// Usage: BenchmarkSuite [filter] > results.json
+// The filter selects the benchmarks whose "name/corpus" contains it.
+// A human-readable summary is printed on stderr.
+
+#include <ArduinoJson.h>
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "harness.hpp"
+
+// The messages exchanged during a tap on the payment terminal
+static const char tapPayload[] =
+    "{\"success\":true,\"message\":\"Payment accepted\",\"data\":{"
+    "\"transaction\":{\"id\":884213,\"amount\":12500,\"type\":\"payment\","
+    "\"created_at\":\"2024-10-12T07:41:03Z\"},\"card\":{\"uid\":"
+    "\"04A1B2C3D4E5F6\",\"balance\":112500.5,\"is_blocked\":false},\"user\":{"
+    "\"name\":\"Siti Rahmawati\",\"class\":\"XI IPA 2\"}}}";
+
+// A getCardInfo() response with the transaction history
+static std::string makeCardInfo(int historySize) {
+  std::string s =
+      "{\"success\":true,\"message\":\"Card found\",\"data\":{\"user\":{"
+      "\"id\":1842,\"name\":\"Siti Rahmawati\",\"email\":\"siti@example.sch."
+      "id\",\"role_type\":\"student\",\"status\":\"active\",\"class\":\"XI "
+      "IPA 2\",\"created_at\":\"2024-07-15T08:12:44.000000Z\"},\"card\":{"
+      "\"id\":977,\"uid\":\"04A1B2C3D4E5F6\",\"balance\":125000.5,\"is_"
+      "blocked\":false,\"permissions\":[\"canteen\",\"library\",\"gate\","
+      "\"bus\"],\"history\":[";
+  for (int i = 0; i < historySize; i++) {
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer),
+             "%s{\"id\":%d,\"terminal_id\":\"T-%03d\",\"amount\":%d.00,\"type\":"
+             "\"payment\",\"created_at\":\"2024-10-%02dT12:00:00Z\"}",
+             i ? "," : "", 10000 + i, i % 40, 5000 + i * 25, 1 + i % 28);
+    s += buffer;
+  }
+  s += "]}}}";
+  return s;
+}
+
+// The list of students synchronized to the terminal
+static std::string makeRoster(unsigned count) {
+  std::string s = "{\"school\":\"SMA Negeri 1\",\"students\":[";
+  for (unsigned i = 0; i < count; i++) {
+    char buffer[200];
+    snprintf(buffer, sizeof(buffer),
+             "%s{\"uid\":\"%08X\",\"nis\":%u,\"name\":\"Student %u\","
+             "\"class\":\"X%c-%u\",\"balance\":%u.%02u,\"daily_limit\":50000,"
+             "\"active\":%s}",
+             i ? "," : "", i * 2654435761u, 20240000 + i, i,
+             "ABC"[i % 3], i % 10 + 1, i % 100000, i % 100,
+             i % 7 ? "true" : "false");
+    s += buffer;
+  }
+  s += "]}";
+  return s;
+}
+
+static double sink = 0;
+
+// Looks up the last member of every object, by key, which is the worst case
+// for ObjectData::findKey()
+class LastKeyLookup {
+ public:
+  explicit LastKeyLookup(JsonVariantConst root) {
+    collect(root);
+  }
+
+  void operator()(Allocator*) const {
+    for (auto& target : targets_)
+      sink += target.first[target.second].isNull() ? 0 : 1;
+  }
+
+ private:
+  void collect(JsonVariantConst variant) {
+    if (variant.is<JsonObjectConst>()) {
+      JsonObjectConst object = variant;
+      const char* lastKey = nullptr;
+      for (JsonPairConst pair : object) {
+        lastKey = pair.key().c_str();
+        collect(pair.value());
+      }
+      if (lastKey)
+        targets_.emplace_back(object, lastKey);
+    } else if (variant.is<JsonArrayConst>()) {
+      for (JsonVariantConst element : variant.as<JsonArrayConst>())
+        collect(element);
+    }
+  }
+
+  std::vector<std::pair<JsonObjectConst, std::string>> targets_;
+};
+
+static void runCorpus(BenchmarkHarness& harness, const char* corpus,
+                      const std::string& json) {
+  JsonDocument source;
+  deserializeJson(source, json);
+
+  std::string msgpack, cbor;
+  serializeMsgPack(source, msgpack);
+  serializeCbor(source, cbor);
+
+  harness.run("deserializeJson", corpus, json.size(),
+              [&](Allocator* allocator) {
+                JsonDocument doc(allocator);
+                deserializeJson(doc, json);
+                sink += double(doc.size());
+              });
+
+  harness.run("deserializeMsgPack", corpus, msgpack.size(),
+              [&](Allocator* allocator) {
+                JsonDocument doc(allocator);
+                deserializeMsgPack(doc, msgpack);
+                sink += double(doc.size());
+              });
+
+  harness.run("deserializeCbor", corpus, cbor.size(),
+              [&](Allocator* allocator) {
+                JsonDocument doc(allocator);
+                deserializeCbor(doc, cbor);
+                sink += double(doc.size());
+              });
+
+  harness.run("serializeJson", corpus, json.size(), [&](Allocator*) {
+    std::string output;
+    output.reserve(json.size());
+    sink += double(serializeJson(source, output));
+  });
+
+  harness.run("serializeJsonPretty", corpus, json.size(), [&](Allocator*) {
+    std::string output;
+    sink += double(serializeJsonPretty(source, output));
+  });
+
+  harness.run("measureJson", corpus, json.size(), [&](Allocator*) {
+    sink += double(measureJson(source));
+  });
+
+  LastKeyLookup lookup(source);
+  harness.run("lookup", corpus, json.size(), lookup);
+
+  // Copies every string and every slot: StringPool and MemoryPoolList
+  harness.run("copy", corpus, json.size(), [&](Allocator* allocator) {
+    JsonDocument doc(allocator);
+    doc.set(source);
+    sink += double(doc.size());
+  });
+
+  // Builds the document node by node, like a sketch that composes a message
+  harness.run("build", corpus, json.size(), [&](Allocator* allocator) {
+    JsonDocument doc(allocator);
+    JsonArray array = doc.to<JsonArray>();
+    for (size_t i = 0; i < json.size() / 64; i++) {
+      JsonObject obj = array.add<JsonObject>();
+      obj["id"] = i;
+      obj["type"] = "payment";
+      obj["amount"] = 12500;
+    }
+    sink += double(doc.size());
+  });
+}
+
+int main(int argc, const char* argv[]) {
+  BenchmarkHarness harness;
+  if (argc > 1)
+    harness.setFilter(argv[1]);
+
+  runCorpus(harness, "small", tapPayload);
+  runCorpus(harness, "medium", makeCardInfo(50));
+  runCorpus(harness, "large", makeRoster(2000));
+
+  for (auto& r : harness.results()) {
+    fprintf(stderr,
+            "%-20s %-6s %7zu B  median %11.0f ns  p95 %11.0f ns  %5zu allocs  "
+            "peak %8zu B\n",
+            r.name.c_str(), r.corpus.c_str(), r.inputSize, r.medianNs, r.p95Ns,
+            r.allocations + r.reallocations, r.peakBytes);
+  }
+  fprintf(stderr, "(checksum %g)\n", sink);
+
+  JsonDocument report;
+  harness.toJson(report);
+  std::string output;
+  serializeJsonPretty(report, output);
+  puts(output.c_str());
+  return 0;
+}
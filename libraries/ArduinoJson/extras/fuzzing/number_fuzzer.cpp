@@ -0,0 +1,82 @@
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace ArduinoJson::detail;
+
+// Differential fuzzer: parseNumber() must agree with the C library whenever
+// the conversion is supposed to be exact.
+//
+// Input layout:
+//   bytes 0-7: mantissa (little endian, truncated to 14 digits)
+//   byte 8:    decimal exponent
+//   byte 9:    number of digits after the decimal point
+//   byte 10:   sign
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size < 11)
+    return 0;
+
+  uint64_t mantissa = 0;
+  for (int i = 7; i >= 0; i--)
+    mantissa = (mantissa << 8) | data[i];
+  mantissa %= 100000000000000;  // keeps every digit in the mantissa
+  int exponent = int8_t(data[8]) % 40;
+  bool negative = data[10] & 1;
+
+  char digits[32];
+  int len = snprintf(digits, sizeof(digits), "%llu",
+                     static_cast<unsigned long long>(mantissa));
+  int decimals = data[9] % 16;
+  if (decimals >= len)
+    decimals = 0;
+
+  // integers must round-trip
+  char input[64];
+  snprintf(input, sizeof(input), "%s%s", negative ? "-" : "", digits);
+  Number integer = parseNumber(input);
+  if (negative) {
+    if (integer.type() != NumberType::SignedInteger ||
+        integer.asSignedInteger() != -static_cast<int64_t>(mantissa))
+      abort();
+  } else {
+    if (integer.type() != NumberType::UnsignedInteger ||
+        integer.asUnsignedInteger() != mantissa)
+      abort();
+  }
+
+  // decimal numbers must be correctly rounded when the fast path applies
+  snprintf(input, sizeof(input), "%s%.*s%s%se%d", negative ? "-" : "",
+           len - decimals, digits, decimals ? "." : "",
+           digits + len - decimals, exponent);
+  int effectiveExponent = exponent - decimals;
+  Number number = parseNumber(input);
+  switch (number.type()) {
+    case NumberType::Float:
+      if (mantissa <= FloatTraits<float>::exact_mantissa_max &&
+          effectiveExponent >= -FloatTraits<float>::exact_exponent_max &&
+          effectiveExponent <= FloatTraits<float>::exact_exponent_max) {
+        float expected = strtof(input, nullptr);
+        float actual = number.asFloat();
+        if (memcmp(&expected, &actual, sizeof(float)) != 0)
+          abort();
+      }
+      break;
+
+    case NumberType::Double:
+      if (effectiveExponent >= -FloatTraits<double>::exact_exponent_max &&
+          effectiveExponent <= FloatTraits<double>::exact_exponent_max) {
+        double expected = strtod(input, nullptr);
+        double actual = number.asDouble();
+        if (memcmp(&expected, &actual, sizeof(double)) != 0)
+          abort();
+      }
+      break;
+
+    default:
+      abort();
+  }
+
+  return 0;
+}
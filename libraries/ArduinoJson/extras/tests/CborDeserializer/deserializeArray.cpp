@@ -0,0 +1,99 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+TEST_CASE("deserialize CBOR array") {
+  JsonDocument doc;
+
+  SECTION("empty") {
+    const char* input = "\x80";
+
+    DeserializationError error = deserializeCbor(doc, input);
+    JsonArray array = doc.as<JsonArray>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(array.size() == 0);
+  }
+
+  SECTION("[1,2,3]") {
+    const char* input = "\x83\x01\x02\x03";
+
+    DeserializationError error = deserializeCbor(doc, input);
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "[1,2,3]");
+  }
+
+  SECTION("[1,[2,3],[4,5]]") {
+    const char* input = "\x83\x01\x82\x02\x03\x82\x04\x05";
+
+    DeserializationError error = deserializeCbor(doc, input);
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "[1,[2,3],[4,5]]");
+  }
+
+  SECTION("25 elements") {
+    const char* input =
+        "\x98\x19\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E"
+        "\x0F\x10\x11\x12\x13\x14\x15\x16\x17\x18\x18\x18\x19";
+
+    DeserializationError error = deserializeCbor(doc, input);
+    JsonArray array = doc.as<JsonArray>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(array.size() == 25);
+    REQUIRE(array[0] == 1);
+    REQUIRE(array[24] == 25);
+  }
+
+  SECTION("two strings, with a 16-bit length") {
+    const char* input = "\x99\x00\x02\x65hello\x65world";
+
+    DeserializationError error = deserializeCbor(doc, input);
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "[\"hello\",\"world\"]");
+  }
+
+  SECTION("two floats, with a 32-bit length") {
+    const char* input =
+        "\x9A\x00\x00\x00\x02\xFA\x00\x00\x00\x00\xFA\x40\x48\xF5\xC3";
+
+    DeserializationError error = deserializeCbor(doc, input);
+    JsonArray array = doc.as<JsonArray>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(array.size() == 2);
+    REQUIRE(array[0] == 0.0f);
+    REQUIRE(array[1] == 3.14f);
+  }
+
+  SECTION("indefinite length") {
+    SECTION("empty") {
+      DeserializationError error = deserializeCbor(doc, "\x9F\xFF");
+
+      REQUIRE(error == DeserializationError::Ok);
+      REQUIRE(doc.as<std::string>() == "[]");
+    }
+
+    SECTION("[_ 1, [2, 3], [_ 4, 5]]") {
+      DeserializationError error =
+          deserializeCbor(doc, "\x9F\x01\x82\x02\x03\x9F\x04\x05\xFF\xFF");
+
+      REQUIRE(error == DeserializationError::Ok);
+      REQUIRE(doc.as<std::string>() == "[1,[2,3],[4,5]]");
+    }
+
+    SECTION("[1, [_ 2, 3]]") {
+      DeserializationError error =
+          deserializeCbor(doc, "\x82\x01\x9F\x02\x03\xFF");
+
+      REQUIRE(error == DeserializationError::Ok);
+      REQUIRE(doc.as<std::string>() == "[1,[2,3]]");
+    }
+  }
+}
@@ -0,0 +1,85 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+TEST_CASE("deserialize CBOR object") {
+  JsonDocument doc;
+
+  SECTION("empty") {
+    DeserializationError error = deserializeCbor(doc, "\xA0");
+    JsonObject obj = doc.as<JsonObject>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.is<JsonObject>());
+    REQUIRE(obj.size() == 0);
+  }
+
+  SECTION("{\"a\": 1, \"b\": [2, 3]}") {
+    DeserializationError error =
+        deserializeCbor(doc, "\xA2\x61\x61\x01\x61\x62\x82\x02\x03");
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"a\":1,\"b\":[2,3]}");
+  }
+
+  SECTION("[\"a\", {\"b\": \"c\"}]") {
+    DeserializationError error =
+        deserializeCbor(doc, "\x82\x61\x61\xA1\x61\x62\x61\x63");
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "[\"a\",{\"b\":\"c\"}]");
+  }
+
+  SECTION("two members, with an 8-bit length") {
+    DeserializationError error =
+        deserializeCbor(doc, "\xB8\x02\x63one\x01\x63two\x02");
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"one\":1,\"two\":2}");
+  }
+
+  SECTION("two members, with a 32-bit length") {
+    DeserializationError error = deserializeCbor(
+        doc, "\xBA\x00\x00\x00\x02\x63one\xFA\x00\x00\x00\x00\x63two\x02");
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc["one"] == 0.0f);
+    REQUIRE(doc["two"] == 2);
+  }
+
+  SECTION("indefinite length") {
+    SECTION("empty") {
+      DeserializationError error = deserializeCbor(doc, "\xBF\xFF");
+
+      REQUIRE(error == DeserializationError::Ok);
+      REQUIRE(doc.as<std::string>() == "{}");
+    }
+
+    SECTION("{_ \"a\": 1, \"b\": [_ 2, 3]}") {
+      DeserializationError error = deserializeCbor(
+          doc, "\xBF\x61\x61\x01\x61\x62\x9F\x02\x03\xFF\xFF");
+
+      REQUIRE(error == DeserializationError::Ok);
+      REQUIRE(doc.as<std::string>() == "{\"a\":1,\"b\":[2,3]}");
+    }
+
+    SECTION("{_ \"Fun\": true, \"Amt\": -2}") {
+      DeserializationError error = deserializeCbor(
+          doc, "\xBF\x63\x46\x75\x6E\xF5\x63\x41\x6D\x74\x21\xFF");
+
+      REQUIRE(error == DeserializationError::Ok);
+      REQUIRE(doc.as<std::string>() == "{\"Fun\":true,\"Amt\":-2}");
+    }
+
+    SECTION("key is an indefinite-length string") {
+      DeserializationError error =
+          deserializeCbor(doc, "\xA1\x7F\x62ke\x61y\xFF\x01");
+
+      REQUIRE(error == DeserializationError::Ok);
+      REQUIRE(doc.as<std::string>() == "{\"key\":1}");
+    }
+  }
+}
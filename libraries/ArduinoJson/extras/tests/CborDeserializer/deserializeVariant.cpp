@@ -0,0 +1,231 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <math.h>
+
+#include "Allocators.hpp"
+#include "Literals.hpp"
+
+template <typename T>
+static void checkValue(const char* input, T expected) {
+  JsonDocument doc;
+
+  DeserializationError error = deserializeCbor(doc, input);
+
+  CAPTURE(input);
+  REQUIRE(error == DeserializationError::Ok);
+  REQUIRE(doc.is<T>());
+  REQUIRE(doc.as<T>() == expected);
+}
+
+static void checkError(size_t timebombCountDown, const char* input,
+                       DeserializationError expected) {
+  TimebombAllocator timebomb(timebombCountDown);
+  JsonDocument doc(&timebomb);
+
+  DeserializationError error = deserializeCbor(doc, input);
+
+  CAPTURE(input);
+  REQUIRE(error == expected);
+}
+
+// Examples from RFC 8949, Appendix A
+TEST_CASE("deserialize CBOR value") {
+  SECTION("null") {
+    checkValue("\xF6", nullptr);
+  }
+
+  SECTION("undefined") {
+    checkValue("\xF7", nullptr);
+  }
+
+  SECTION("simple values") {
+    checkValue("\xF0", nullptr);
+    checkValue("\xF8\xFF", nullptr);
+  }
+
+  SECTION("bool") {
+    checkValue<bool>("\xF4", false);
+    checkValue<bool>("\xF5", true);
+  }
+
+  SECTION("unsigned integer") {
+    checkValue<int>("\x00", 0);
+    checkValue<int>("\x17", 23);
+    checkValue<int>("\x18\x18", 24);
+    checkValue<int>("\x18\x64", 100);
+    checkValue<int>("\x19\x03\xE8", 1000);
+    checkValue<uint32_t>("\x1A\x00\x0F\x42\x40", 1000000);
+    checkValue<uint32_t>("\x1A\xFF\xFF\xFF\xFF", 0xFFFFFFFFU);
+  }
+
+  SECTION("unsigned 64-bit integer") {
+#if ARDUINOJSON_USE_LONG_LONG
+    checkValue<uint64_t>("\x1B\x00\x00\x00\xE8\xD4\xA5\x10\x00",
+                         1000000000000U);
+    checkValue<uint64_t>("\x1B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF",
+                         0xFFFFFFFFFFFFFFFFU);
+#else
+    checkValue("\x1B\x00\x00\x00\xE8\xD4\xA5\x10\x00", nullptr);
+    checkValue("\x1B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", nullptr);
+#endif
+  }
+
+  SECTION("negative integer") {
+    checkValue<int>("\x20", -1);
+    checkValue<int>("\x29", -10);
+    checkValue<int>("\x38\x63", -100);
+    checkValue<int>("\x39\x03\xE7", -1000);
+    checkValue<int32_t>("\x3A\x7F\xFF\xFF\xFF", -2147483647 - 1);
+  }
+
+  SECTION("negative 64-bit integer") {
+#if ARDUINOJSON_USE_LONG_LONG
+    checkValue<int64_t>("\x3B\x00\x00\x00\x01\x00\x00\x00\x00",
+                        int64_t(-4294967297));
+    checkValue<int64_t>("\x3B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF",
+                        int64_t(0x8000000000000000));
+#else
+    checkValue("\x3B\x00\x00\x00\x01\x00\x00\x00\x00", nullptr);
+#endif
+    // -18446744073709551616 doesn't fit
+    checkValue("\x3B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", nullptr);
+  }
+
+  SECTION("half-precision float") {
+    checkValue<double>("\xF9\x00\x00", 0.0);
+    checkValue<double>("\xF9\x80\x00", -0.0);
+    checkValue<double>("\xF9\x3C\x00", 1.0);
+    checkValue<double>("\xF9\x3E\x00", 1.5);
+    checkValue<double>("\xF9\x7B\xFF", 65504.0);
+    checkValue<double>("\xF9\x00\x01", 5.9604644775390625e-8);
+    checkValue<double>("\xF9\x04\x00", 0.00006103515625);
+    checkValue<double>("\xF9\xC4\x00", -4.0);
+    checkValue<double>("\xF9\x7C\x00", INFINITY);
+    checkValue<double>("\xF9\xFC\x00", -INFINITY);
+
+    JsonDocument doc;
+    deserializeCbor(doc, "\xF9\x7E\x00");
+    REQUIRE(isnan(doc.as<double>()));
+  }
+
+  SECTION("single-precision float") {
+    checkValue<double>("\xFA\x47\xC3\x50\x00", 100000.0);
+    checkValue<double>("\xFA\x7F\x7F\xFF\xFF", 3.4028234663852886e+38);
+  }
+
+  SECTION("double-precision float") {
+    checkValue<double>("\xFB\x3F\xF1\x99\x99\x99\x99\x99\x9A", 1.1);
+    checkValue<double>("\xFB\x7E\x37\xE4\x3C\x88\x00\x75\x9C", 1.0e+300);
+    checkValue<double>("\xFB\xC0\x10\x66\x66\x66\x66\x66\x66", -4.1);
+  }
+
+  SECTION("text string") {
+    checkValue<std::string>("\x60", ""_s);
+    checkValue<std::string>("\x61\x61", "a"_s);
+    checkValue<std::string>("\x64IETF", "IETF"_s);
+    checkValue<std::string>("\x62\xC3\xBC", "\xC3\xBC"_s);
+    checkValue<std::string>("\x78\x05hello", "hello"_s);
+    checkValue<std::string>("\x79\x00\x05hello", "hello"_s);
+    checkValue<std::string>("\x7A\x00\x00\x00\x05hello", "hello"_s);
+    checkValue<std::string>("\x7B\x00\x00\x00\x00\x00\x00\x00\x05hello",
+                            "hello"_s);
+  }
+
+  SECTION("indefinite-length text string") {
+    checkValue<std::string>("\x7F\x65strea\x64ming\xFF", "streaming"_s);
+    checkValue<std::string>("\x7F\xFF", ""_s);
+  }
+
+  SECTION("byte string") {
+    JsonDocument doc;
+
+    auto error = deserializeCbor(doc, "\x44\x01\x02\x03\x04");
+
+    REQUIRE(error == DeserializationError::Ok);
+    std::string output;
+    serializeCbor(doc, output);
+    REQUIRE(output == "\x44\x01\x02\x03\x04"_s);
+  }
+
+  SECTION("indefinite-length byte string") {
+    JsonDocument doc;
+
+    auto error = deserializeCbor(doc, "\x5F\x42\x01\x02\x43\x03\x04\x05\xFF");
+
+    REQUIRE(error == DeserializationError::Ok);
+    std::string output;
+    serializeCbor(doc, output);
+    REQUIRE(output == "\x5F\x42\x01\x02\x43\x03\x04\x05\xFF"_s);
+  }
+
+  SECTION("tags are ignored") {
+    checkValue<std::string>("\xC0\x74"
+                            "2013-03-21T20:04:00Z",
+                            "2013-03-21T20:04:00Z"_s);
+    checkValue<int>("\xC1\x1A\x51\x4B\x67\xB0", 1363896240);
+    checkValue<int>("\xD8\x20\xD8\x21\x01", 1);
+  }
+}
+
+TEST_CASE("deserializeCbor() under memory constaints") {
+  SECTION("single values always fit") {
+    checkError(0, "\xF6", DeserializationError::Ok);              // null
+    checkError(0, "\xF4", DeserializationError::Ok);              // false
+    checkError(0, "\xF5", DeserializationError::Ok);              // true
+    checkError(0, "\x18\x64", DeserializationError::Ok);          // 100
+    checkError(0, "\x1A\x00\x0F\x42\x40", DeserializationError::Ok);
+    checkError(0, "\xF9\x3E\x00", DeserializationError::Ok);      // 1.5
+  }
+
+  SECTION("text string") {
+    checkError(2, "\x67ZZZZZZZ", DeserializationError::Ok);
+    checkError(0, "\x67ZZZZZZZ", DeserializationError::NoMemory);
+  }
+
+  SECTION("indefinite-length text string") {
+    checkError(3, "\x7F\x63ZZZ\x64ZZZZ\xFF", DeserializationError::Ok);
+    checkError(1, "\x7F\x63ZZZ\x64ZZZZ\xFF", DeserializationError::NoMemory);
+    checkError(0, "\x7F\x63ZZZ\x64ZZZZ\xFF", DeserializationError::NoMemory);
+  }
+
+  SECTION("indefinite-length text string made of many chunks") {
+    SpyingAllocator spy;
+    JsonDocument doc(&spy);
+    std::string input = "\x7F";
+    for (int i = 0; i < 100; i++)
+      input += "\x61Z";
+    input += "\xFF";
+
+    DeserializationError error = deserializeCbor(doc, input);
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == std::string(100, 'Z'));
+    auto log = spy.log().str();
+    size_t reallocations = 0;
+    for (auto p = log.find("reallocate("); p != std::string::npos;
+         p = log.find("reallocate(", p + 1))
+      reallocations++;
+    REQUIRE(reallocations < 10);  // grows geometrically, then trimmed
+  }
+
+  SECTION("array") {
+    checkError(0, "\x80", DeserializationError::Ok);                // []
+    checkError(0, "\x81\x01", DeserializationError::NoMemory);      // [1]
+    checkError(1, "\x81\x01", DeserializationError::Ok);            // [1]
+    checkError(0, "\x9F\x01\xFF", DeserializationError::NoMemory);  // [_ 1]
+    checkError(1, "\x9F\x01\xFF", DeserializationError::Ok);        // [_ 1]
+  }
+
+  SECTION("map") {
+    checkError(0, "\xA0", DeserializationError::Ok);
+    checkError(1, "\xA1\x61H\x01", DeserializationError::NoMemory);
+    checkError(2, "\xA1\x61H\x01", DeserializationError::Ok);
+    checkError(2, "\xA2\x61H\x01\x61W\x02", DeserializationError::NoMemory);
+    checkError(3, "\xA2\x61H\x01\x61W\x02", DeserializationError::Ok);
+  }
+}
@@ -0,0 +1,121 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+
+static void testInvalidInput(const char* input, size_t len) {
+  JsonDocument doc;
+  CAPTURE(std::string(input, len));
+  REQUIRE(deserializeCbor(doc, input, len) ==
+          DeserializationError::InvalidInput);
+}
+
+TEST_CASE("deserializeCbor() returns InvalidInput") {
+  SECTION("integer as key") {
+    testInvalidInput("\xA1\x01\x61H", 4);
+  }
+
+  SECTION("reserved additional information") {
+    testInvalidInput("\x1C", 1);
+    testInvalidInput("\x3D", 1);
+    testInvalidInput("\x7E", 1);
+    testInvalidInput("\xDE\x01", 2);
+    testInvalidInput("\xFC", 1);
+  }
+
+  SECTION("indefinite-length integer") {
+    testInvalidInput("\x1F", 1);
+    testInvalidInput("\x3F", 1);
+  }
+
+  SECTION("break outside of an indefinite-length item") {
+    testInvalidInput("\xFF", 1);
+    testInvalidInput("\x81\xFF", 2);
+  }
+
+  SECTION("chunk of the wrong type") {
+    testInvalidInput("\x7F\x41X\xFF", 4);
+    testInvalidInput("\x5F\x61X\xFF", 4);
+  }
+
+  SECTION("nested indefinite-length chunk") {
+    testInvalidInput("\x7F\x7F\xFF\xFF", 4);
+  }
+}
+
+TEST_CASE("deserializeCbor() returns EmptyInput") {
+  JsonDocument doc;
+
+  SECTION("from sized buffer") {
+    auto err = deserializeCbor(doc, "", 0);
+
+    REQUIRE(err == DeserializationError::EmptyInput);
+  }
+
+  SECTION("from stream") {
+    std::istringstream input("");
+
+    auto err = deserializeCbor(doc, input);
+
+    REQUIRE(err == DeserializationError::EmptyInput);
+  }
+}
+
+static void testIncompleteInput(const char* input, size_t len) {
+  JsonDocument doc;
+  CAPTURE(std::string(input, len));
+  REQUIRE(deserializeCbor(doc, input, len) == DeserializationError::Ok);
+
+  while (--len) {
+    REQUIRE(deserializeCbor(doc, input, len) ==
+            DeserializationError::IncompleteInput);
+  }
+}
+
+TEST_CASE("deserializeCbor() returns IncompleteInput") {
+  SECTION("integers") {
+    testIncompleteInput("\x18\x64", 2);
+    testIncompleteInput("\x19\x03\xE8", 3);
+    testIncompleteInput("\x3A\x7F\xFF\xFF\xFF", 5);
+    testIncompleteInput("\x1B\x00\x00\x00\xE8\xD4\xA5\x10\x00", 9);
+  }
+
+  SECTION("floats") {
+    testIncompleteInput("\xF9\x3E\x00", 3);
+    testIncompleteInput("\xFA\x47\xC3\x50\x00", 5);
+    testIncompleteInput("\xFB\x3F\xF1\x99\x99\x99\x99\x99\x9A", 9);
+  }
+
+  SECTION("simple value") {
+    testIncompleteInput("\xF8\xFF", 2);
+  }
+
+  SECTION("strings") {
+    testIncompleteInput("\x65hello", 6);
+    testIncompleteInput("\x78\x05hello", 7);
+    testIncompleteInput("\x44\x01\x02\x03\x04", 5);
+    testIncompleteInput("\x7F\x62he\x63llo\xFF", 9);
+    testIncompleteInput("\x5F\x42\x01\x02\x41\x03\xFF", 7);
+  }
+
+  SECTION("tag") {
+    testIncompleteInput("\xD8\x20\x01", 3);
+  }
+
+  SECTION("arrays") {
+    testIncompleteInput("\x82\x01\x02", 3);
+    testIncompleteInput("\x99\x00\x01\x01", 4);
+    testIncompleteInput("\x9F\x01\x02\xFF", 4);
+  }
+
+  SECTION("maps") {
+    testIncompleteInput("\xA1\x61\x61\x01", 4);
+    testIncompleteInput("\xB9\x00\x01\x61\x61\x01", 6);
+    testIncompleteInput("\xBF\x61\x61\x01\xFF", 5);
+    testIncompleteInput("\xA1\x7F\x61\x61\xFF\x01", 6);
+  }
+}
@@ -0,0 +1,147 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+#include "Allocators.hpp"
+#include "Literals.hpp"
+
+using namespace ArduinoJson::detail;
+
+TEST_CASE("deserializeCbor() filter") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+  DeserializationError error;
+
+  JsonDocument filter;
+  DeserializationOption::Filter filterOpt(filter);
+
+  SECTION("filter = {include:true,ignore:false}") {
+    filter["include"] = true;
+    filter["ignore"] = false;
+
+    struct TestCase {
+      const char* description;
+      std::string ignored;
+    };
+
+    TestCase testCases[] = {
+        {"null", "\xF6"_s},
+        {"true", "\xF5"_s},
+        {"unsigned integer", "\x1A\x00\x0F\x42\x40"_s},
+        {"negative integer", "\x39\x03\xE7"_s},
+        {"half float", "\xF9\x3E\x00"_s},
+        {"single float", "\xFA\x47\xC3\x50\x00"_s},
+        {"double float", "\xFB\x3F\xF1\x99\x99\x99\x99\x99\x9A"_s},
+        {"simple value", "\xF8\xFF"_s},
+        {"text string", "\x65hello"_s},
+        {"indefinite text string", "\x7F\x62he\x63llo\xFF"_s},
+        {"byte string", "\x44\x01\x02\x03\x04"_s},
+        {"indefinite byte string", "\x5F\x42\x01\x02\x41\x03\xFF"_s},
+        {"tagged value", "\xC1\x1A\x51\x4B\x67\xB0"_s},
+        {"array", "\x83\x01\x82\x02\x03\x61x"_s},
+        {"indefinite array", "\x9F\x01\x9F\x02\xFF\xFF"_s},
+        {"map", "\xA2\x61\x61\x01\x61\x62\xA1\x61\x63\x02"_s},
+        {"indefinite map", "\xBF\x61\x61\xBF\x61\x62\x01\xFF\xFF"_s},
+    };
+
+    for (auto& tc : testCases) {
+      SECTION(tc.description) {
+        auto input = "\xA2\x66ignore"_s + tc.ignored + "\x67include\x18\x2A"_s;
+
+        error = deserializeCbor(doc, input, filterOpt);
+
+        CHECK(error == DeserializationError::Ok);
+        CHECK(doc.as<std::string>() == "{\"include\":42}");
+        CHECK(spy.log() == AllocatorLog{
+                               Allocate(sizeofString("ignore")),
+                               Deallocate(sizeofString("ignore")),
+                               Allocate(sizeofString("include")),
+                               Allocate(sizeofPool()),
+                               Reallocate(sizeofPool(), sizeofObject(1)),
+                           });
+      }
+    }
+
+    SECTION("input truncated inside skipped value") {
+      error = deserializeCbor(doc, "\xA2\x66ignore\x83\x01", 10, filterOpt);
+
+      CHECK(error == DeserializationError::IncompleteInput);
+      CHECK(doc.as<std::string>() == "{}");
+    }
+
+    SECTION("invalid input inside skipped value") {
+      error = deserializeCbor(doc, "\xA2\x66ignore\x81\xFC", 10, filterOpt);
+
+      CHECK(error == DeserializationError::InvalidInput);
+    }
+
+    SECTION("key is not a string") {
+      error = deserializeCbor(doc, "\xA1\x01\x02", filterOpt);
+
+      CHECK(error == DeserializationError::InvalidInput);
+    }
+  }
+
+  SECTION("filter = {data:[{id:true}]}") {
+    filter["data"][0]["id"] = true;
+
+    SECTION("keeps only the id of each element") {
+      error = deserializeCbor(
+          doc,
+          "\xA2\x64info\x65hello\x64"
+          "data\x82\xA2\x62id\x01\x64name\x61x\xA2\x62id\x02\x64name\x61y",
+          filterOpt);
+
+      CHECK(error == DeserializationError::Ok);
+      CHECK(doc.as<std::string>() == "{\"data\":[{\"id\":1},{\"id\":2}]}");
+    }
+
+    SECTION("indefinite-length containers") {
+      error = deserializeCbor(doc,
+                              "\xBF\x64"
+                              "data\x9F\xBF\x62id\x01\x64name\x61x\xFF\xFF\xFF",
+                              filterOpt);
+
+      CHECK(error == DeserializationError::Ok);
+      CHECK(doc.as<std::string>() == "{\"data\":[{\"id\":1}]}");
+    }
+
+    SECTION("data is not an array") {
+      error = deserializeCbor(doc, "\xA1\x64"
+                                   "data\xA1\x62id\x01",
+                              filterOpt);
+
+      CHECK(error == DeserializationError::Ok);
+      CHECK(doc.as<std::string>() == "{\"data\":null}");
+    }
+  }
+
+  SECTION("filter = false") {
+    filter.set(false);
+
+    error = deserializeCbor(doc, "\x83\x01\x02\x03", filterOpt);
+
+    CHECK(error == DeserializationError::Ok);
+    CHECK(doc.isNull());
+  }
+
+  SECTION("PathFilter") {
+    const char* paths[] = {"card.balance"};
+    DeserializationOption::PathFilter<> pathFilter(paths);
+
+    error = deserializeCbor(doc,
+                            "\xA2\x64"
+                            "card\xA2\x63uid\x64"
+                            "04A1\x67"
+                            "balance\xFA\x47\xC3\x50\x00\x62ok\xF5",
+                            pathFilter);
+
+    CHECK(error == DeserializationError::Ok);
+    CHECK(doc.as<std::string>() == "{\"card\":{\"balance\":100000}}");
+  }
+}
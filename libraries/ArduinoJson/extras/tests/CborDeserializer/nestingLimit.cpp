@@ -0,0 +1,71 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+
+#define SHOULD_WORK(expression) REQUIRE(DeserializationError::Ok == expression);
+#define SHOULD_FAIL(expression) \
+  REQUIRE(DeserializationError::TooDeep == expression);
+
+TEST_CASE("deserializeCbor() nesting") {
+  JsonDocument doc;
+
+  SECTION("Input = const char*") {
+    SECTION("limit = 0") {
+      DeserializationOption::NestingLimit nesting(0);
+      SHOULD_WORK(deserializeCbor(doc, "\x61H", nesting));  // "H"
+      SHOULD_FAIL(deserializeCbor(doc, "\x80", nesting));   // []
+      SHOULD_FAIL(deserializeCbor(doc, "\xA0", nesting));   // {}
+      SHOULD_FAIL(deserializeCbor(doc, "\x9F\xFF", nesting));  // [_ ]
+      SHOULD_FAIL(deserializeCbor(doc, "\xBF\xFF", nesting));  // {_ }
+    }
+
+    SECTION("limit = 1") {
+      DeserializationOption::NestingLimit nesting(1);
+      SHOULD_WORK(deserializeCbor(doc, "\x80", nesting));           // []
+      SHOULD_WORK(deserializeCbor(doc, "\xA0", nesting));           // {}
+      SHOULD_FAIL(deserializeCbor(doc, "\xA1\x61H\xA0", nesting));  // {H:{}}
+      SHOULD_FAIL(deserializeCbor(doc, "\x81\x80", nesting));       // [[]]
+      SHOULD_FAIL(deserializeCbor(doc, "\x9F\x9F\xFF\xFF", nesting));
+    }
+  }
+
+  SECTION("char* and size_t") {
+    SECTION("limit = 0") {
+      DeserializationOption::NestingLimit nesting(0);
+      SHOULD_WORK(deserializeCbor(doc, "\x61H", 2, nesting));
+      SHOULD_FAIL(deserializeCbor(doc, "\x80", 1, nesting));
+      SHOULD_FAIL(deserializeCbor(doc, "\xA0", 1, nesting));
+    }
+
+    SECTION("limit = 1") {
+      DeserializationOption::NestingLimit nesting(1);
+      SHOULD_WORK(deserializeCbor(doc, "\x80", 1, nesting));
+      SHOULD_WORK(deserializeCbor(doc, "\xA0", 1, nesting));
+      SHOULD_FAIL(deserializeCbor(doc, "\xA1\x61H\xA0", 4, nesting));
+      SHOULD_FAIL(deserializeCbor(doc, "\x81\x80", 2, nesting));
+    }
+  }
+
+  SECTION("Input = std::istream") {
+    SECTION("limit = 0") {
+      DeserializationOption::NestingLimit nesting(0);
+      std::istringstream good("\x61H");  // "H"
+      std::istringstream bad("\x80");    // []
+      SHOULD_WORK(deserializeCbor(doc, good, nesting));
+      SHOULD_FAIL(deserializeCbor(doc, bad, nesting));
+    }
+
+    SECTION("limit = 1") {
+      DeserializationOption::NestingLimit nesting(1);
+      std::istringstream good("\x80");     // []
+      std::istringstream bad("\x81\x80");  // [[]]
+      SHOULD_WORK(deserializeCbor(doc, good, nesting));
+      SHOULD_FAIL(deserializeCbor(doc, bad, nesting));
+    }
+  }
+}
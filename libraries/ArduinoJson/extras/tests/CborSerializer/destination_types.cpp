@@ -0,0 +1,54 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+TEST_CASE("serialize CBOR to various destination types") {
+  JsonDocument doc;
+  JsonObject object = doc.to<JsonObject>();
+  object["hello"] = "world";
+  const char* expected_result = "\xA1\x65hello\x65world";
+  const size_t expected_length = 13;
+
+  SECTION("std::string") {
+    std::string result;
+    size_t len = serializeCbor(object, result);
+
+    REQUIRE(expected_result == result);
+    REQUIRE(expected_length == len);
+  }
+
+  SECTION("char[] larger than needed") {
+    char result[64];
+    memset(result, 42, sizeof(result));
+    size_t len = serializeCbor(object, result);
+
+    REQUIRE(expected_length == len);
+    REQUIRE(std::string(expected_result, len) == std::string(result, len));
+    REQUIRE(result[len] == 42);
+  }
+
+  SECTION("char[] of the right size") {
+    char result[13];
+    size_t len = serializeCbor(object, result);
+
+    REQUIRE(expected_length == len);
+    REQUIRE(std::string(expected_result, len) == std::string(result, len));
+  }
+
+  SECTION("char*") {
+    char result[64];
+    memset(result, 42, sizeof(result));
+    size_t len = serializeCbor(object, result, 64);
+
+    REQUIRE(expected_length == len);
+    REQUIRE(std::string(expected_result, len) == std::string(result, len));
+    REQUIRE(result[len] == 42);
+  }
+
+  SECTION("measureCbor()") {
+    REQUIRE(measureCbor(object) == expected_length);
+  }
+}
@@ -0,0 +1,84 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+static void check(const JsonArray array, const char* expected_data,
+                  size_t expected_len) {
+  std::string expected(expected_data, expected_data + expected_len);
+  std::string actual;
+  size_t len = serializeCbor(array, actual);
+  CAPTURE(array);
+  REQUIRE(len == expected_len);
+  REQUIRE(actual == expected);
+}
+
+template <size_t N>
+static void check(const JsonArray array, const char (&expected_data)[N]) {
+  const size_t expected_len = N - 1;
+  check(array, expected_data, expected_len);
+}
+
+static void check(const JsonArray array, const std::string& expected) {
+  check(array, expected.data(), expected.length());
+}
+
+TEST_CASE("serialize CBOR array") {
+  JsonDocument doc;
+  JsonArray array = doc.to<JsonArray>();
+
+  SECTION("empty") {
+    check(array, "\x80");
+  }
+
+  SECTION("[1,2,3]") {
+    array.add(1);
+    array.add(2);
+    array.add(3);
+
+    check(array, "\x83\x01\x02\x03");
+  }
+
+  SECTION("[1,[2,3],[4,5]]") {
+    array.add(1);
+    JsonArray a1 = array.add<JsonArray>();
+    a1.add(2);
+    a1.add(3);
+    JsonArray a2 = array.add<JsonArray>();
+    a2.add(4);
+    a2.add(5);
+
+    check(array, "\x83\x01\x82\x02\x03\x82\x04\x05");
+  }
+
+  SECTION("23 elements") {
+    for (int i = 0; i < 23; i++)
+      array.add(i);
+
+    check(array,
+          "\x97\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E"
+          "\x0F\x10\x11\x12\x13\x14\x15\x16");
+  }
+
+  SECTION("25 elements") {
+    for (int i = 1; i <= 25; i++)
+      array.add(i);
+
+    check(array,
+          "\x98\x19\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E"
+          "\x0F\x10\x11\x12\x13\x14\x15\x16\x17\x18\x18\x18\x19");
+  }
+
+  SECTION("65536 elements") {
+    for (int i = 0; i < 65536; i++)
+      array.add(i % 2 == 0);
+
+    std::string expected("\x9A\x00\x01\x00\x00", 5);
+    for (int i = 0; i < 65536; i++)
+      expected += i % 2 == 0 ? '\xF5' : '\xF4';
+
+    check(array, expected);
+  }
+}
@@ -0,0 +1,73 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+static void check(const JsonObject object, const char* expected_data,
+                  size_t expected_len) {
+  std::string expected(expected_data, expected_data + expected_len);
+  std::string actual;
+  size_t len = serializeCbor(object, actual);
+  CAPTURE(object);
+  REQUIRE(len == expected_len);
+  REQUIRE(actual == expected);
+}
+
+template <size_t N>
+static void check(const JsonObject object, const char (&expected_data)[N]) {
+  const size_t expected_len = N - 1;
+  check(object, expected_data, expected_len);
+}
+
+TEST_CASE("serialize CBOR object") {
+  JsonDocument doc;
+  JsonObject object = doc.to<JsonObject>();
+
+  SECTION("empty") {
+    check(object, "\xA0");
+  }
+
+  SECTION("{\"a\":1,\"b\":[2,3]}") {
+    object["a"] = 1;
+    JsonArray b = object["b"].to<JsonArray>();
+    b.add(2);
+    b.add(3);
+
+    check(object, "\xA2\x61\x61\x01\x61\x62\x82\x02\x03");
+  }
+
+  SECTION("{\"a\":\"A\",\"b\":\"B\",\"c\":\"C\",\"d\":\"D\",\"e\":\"E\"}") {
+    object["a"] = "A";
+    object["b"] = "B";
+    object["c"] = "C";
+    object["d"] = "D";
+    object["e"] = "E";
+
+    check(object,
+          "\xA5\x61\x61\x61\x41\x61\x62\x61\x42\x61\x63\x61\x43\x61\x64\x61"
+          "\x44\x61\x65\x61\x45");
+  }
+
+  SECTION("24 members") {
+    for (int i = 0; i < 24; i++) {
+      char key[] = {char('0' + i / 10), char('0' + i % 10), 0};
+      object[key] = i;
+    }
+
+    std::string actual;
+    serializeCbor(object, actual);
+
+    REQUIRE(actual.size() == 2 + 24 * 3 + 24);
+    REQUIRE(actual.substr(0, 5) == "\xB8\x18\x62"
+                                   "00");
+  }
+
+  SECTION("serialized(const char*)") {
+    object["hello"] = serialized("\xF5");
+    object["world"] = serialized("\x82\x01\x02", 3);
+
+    check(object, "\xA2\x65hello\xF5\x65world\x82\x01\x02");
+  }
+}
@@ -0,0 +1,139 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include "Literals.hpp"
+
+template <typename T>
+static void checkVariant(T value, const char* expected_data,
+                         size_t expected_len) {
+  JsonDocument doc;
+  JsonVariant variant = doc.to<JsonVariant>();
+  variant.set(value);
+  std::string expected(expected_data, expected_data + expected_len);
+  std::string actual;
+  size_t len = serializeCbor(variant, actual);
+  CAPTURE(variant);
+  REQUIRE(len == expected_len);
+  REQUIRE(measureCbor(variant) == expected_len);
+  REQUIRE(actual == expected);
+}
+
+template <typename T, size_t N>
+static void checkVariant(T value, const char (&expected_data)[N]) {
+  const size_t expected_len = N - 1;
+  checkVariant(value, expected_data, expected_len);
+}
+
+template <typename T>
+static void checkVariant(T value, const std::string& expected) {
+  checkVariant(value, expected.data(), expected.length());
+}
+
+// Examples from RFC 8949, Appendix A
+TEST_CASE("serialize CBOR value") {
+  SECTION("unbound") {
+    checkVariant(JsonVariant(), "\xF6");  // we represent undefined as null
+  }
+
+  SECTION("null") {
+    const char* nil = 0;  // ArduinoJson uses a string for null
+    checkVariant(nil, "\xF6");
+  }
+
+  SECTION("bool") {
+    checkVariant(false, "\xF4");
+    checkVariant(true, "\xF5");
+  }
+
+  SECTION("unsigned integer") {
+    checkVariant(0, "\x00");
+    checkVariant(23, "\x17");
+    checkVariant(24, "\x18\x18");
+    checkVariant(100U, "\x18\x64");
+    checkVariant(255, "\x18\xFF");
+    checkVariant(256, "\x19\x01\x00");
+    checkVariant(1000, "\x19\x03\xE8");
+    checkVariant(65535, "\x19\xFF\xFF");
+    checkVariant(65536, "\x1A\x00\x01\x00\x00");
+    checkVariant(1000000, "\x1A\x00\x0F\x42\x40");
+    checkVariant(0xFFFFFFFFU, "\x1A\xFF\xFF\xFF\xFF");
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("unsigned 64-bit integer") {
+    checkVariant(1000000000000U, "\x1B\x00\x00\x00\xE8\xD4\xA5\x10\x00");
+    checkVariant(0xFFFFFFFFFFFFFFFFU, "\x1B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF");
+  }
+#endif
+
+  SECTION("negative integer") {
+    checkVariant(-1, "\x20");
+    checkVariant(-10, "\x29");
+    checkVariant(-24, "\x37");
+    checkVariant(-25, "\x38\x18");
+    checkVariant(-100, "\x38\x63");
+    checkVariant(-256, "\x38\xFF");
+    checkVariant(-257, "\x39\x01\x00");
+    checkVariant(-1000, "\x39\x03\xE7");
+    checkVariant(-2147483647 - 1, "\x3A\x7F\xFF\xFF\xFF");
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("negative 64-bit integer") {
+    checkVariant(int64_t(-4294967297), "\x3B\x00\x00\x00\x01\x00\x00\x00\x00");
+    checkVariant(int64_t(0x8000000000000000),
+                 "\x3B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF");
+  }
+#endif
+
+  SECTION("single-precision float") {
+    checkVariant(1.5, "\xFA\x3F\xC0\x00\x00");
+    checkVariant(100000.5f, "\xFA\x47\xC3\x50\x40");
+  }
+
+  SECTION("double-precision float") {
+    checkVariant(1.1, "\xFB\x3F\xF1\x99\x99\x99\x99\x99\x9A");
+    checkVariant(1.0e+300, "\xFB\x7E\x37\xE4\x3C\x88\x00\x75\x9C");
+    checkVariant(-4.1, "\xFB\xC0\x10\x66\x66\x66\x66\x66\x66");
+  }
+
+  SECTION("serialize round double as integer") {
+    checkVariant(0.0, "\x00");
+    checkVariant(-1.0, "\x20");
+    checkVariant(1000.0, "\x19\x03\xE8");
+    checkVariant(-1000.0, "\x39\x03\xE7");
+  }
+
+  SECTION("text string") {
+    checkVariant("", "\x60");
+    checkVariant("a", "\x61\x61");
+    checkVariant("IETF", "\x64IETF");
+    checkVariant("\xC3\xBC", "\x62\xC3\xBC");
+    checkVariant("hello world hello world", "\x77hello world hello world");
+    checkVariant("hello world hello world!", "\x78\x18hello world hello world!");
+  }
+
+  SECTION("text string with 16-bit length") {
+    std::string shortest(256, '?');
+    checkVariant(shortest.c_str(), "\x79\x01\x00"_s + shortest);
+
+    std::string longest(65535, '?');
+    checkVariant(longest.c_str(), "\x79\xFF\xFF"_s + longest);
+  }
+
+  SECTION("text string with 32-bit length") {
+    std::string shortest(65536, '?');
+    checkVariant(JsonString(shortest.c_str(), true),  // force store by pointer
+                 "\x7A\x00\x01\x00\x00"_s + shortest);
+  }
+
+  SECTION("serialized(const char*)") {
+    checkVariant(serialized("\x44\x01\x02\x03\x04"), "\x44\x01\x02\x03\x04");
+    checkVariant(serialized("\xC1\x1A\x51\x4B\x67\xB0", 6),
+                 "\xC1\x1A\x51\x4B\x67\xB0");
+  }
+}
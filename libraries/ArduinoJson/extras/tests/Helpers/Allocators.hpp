@@ -122,6 +122,21 @@ class AllocatorLog {
   std::ostringstream log_;
 };
 
+struct AllocatedBlock {
+  size_t size;
+  char payload[1];
+
+  static AllocatedBlock* fromPayload(void* p) {
+    if (!p)
+      return nullptr;
+    return reinterpret_cast<AllocatedBlock*>(
+        // Cast to void* to silence "cast increases required alignment of
+        // target type [-Werror=cast-align]"
+        reinterpret_cast<void*>(reinterpret_cast<char*>(p) -
+                                offsetof(AllocatedBlock, payload)));
+  }
+};
+
 class SpyingAllocator : public ArduinoJson::Allocator {
  public:
   SpyingAllocator(
@@ -179,26 +194,97 @@ class SpyingAllocator : public ArduinoJson::Allocator {
   }
 
  private:
-  struct AllocatedBlock {
-    size_t size;
-    char payload[1];
-
-    static AllocatedBlock* fromPayload(void* p) {
-      if (!p)
-        return nullptr;
-      return reinterpret_cast<AllocatedBlock*>(
-          // Cast to void* to silence "cast increases required alignment of
-          // target type [-Werror=cast-align]"
-          reinterpret_cast<void*>(reinterpret_cast<char*>(p) -
-                                  offsetof(AllocatedBlock, payload)));
-    }
-  };
-
   AllocatorLog log_;
   Allocator* upstream_;
   size_t allocatedBytes_ = 0;
 };
 
+// Like SpyingAllocator, but only keeps counters, so it can run for millions of
+// calls
+class TrackingAllocator : public ArduinoJson::Allocator {
+ public:
+  TrackingAllocator(
+      Allocator* upstream = ArduinoJson::detail::DefaultAllocator::instance())
+      : upstream_(upstream) {}
+  virtual ~TrackingAllocator() {}
+
+  // Number of calls to the upstream allocator
+  size_t allocations() const {
+    return allocations_;
+  }
+
+  size_t deallocations() const {
+    return deallocations_;
+  }
+
+  size_t reallocations() const {
+    return reallocations_;
+  }
+
+  // Number of blocks and bytes currently allocated
+  size_t liveBlocks() const {
+    return allocations_ - deallocations_;
+  }
+
+  size_t allocatedBytes() const {
+    return allocatedBytes_;
+  }
+
+  size_t peakBytes() const {
+    return peakBytes_;
+  }
+
+  void* allocate(size_t n) override {
+    auto block = reinterpret_cast<AllocatedBlock*>(
+        upstream_->allocate(sizeof(AllocatedBlock) + n - 1));
+    if (!block)
+      return nullptr;
+    allocations_++;
+    block->size = n;
+    grow(n);
+    return block->payload;
+  }
+
+  void deallocate(void* p) override {
+    auto block = AllocatedBlock::fromPayload(p);
+    if (!block)
+      return;
+    deallocations_++;
+    allocatedBytes_ -= block->size;
+    upstream_->deallocate(block);
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    if (!p)
+      return allocate(n);
+    auto block = AllocatedBlock::fromPayload(p);
+    auto oldSize = block->size;
+    block = reinterpret_cast<AllocatedBlock*>(
+        upstream_->reallocate(block, sizeof(AllocatedBlock) + n - 1));
+    if (!block)
+      return nullptr;
+    reallocations_++;
+    block->size = n;
+    allocatedBytes_ -= oldSize;
+    grow(n);
+    return block->payload;
+  }
+
+ private:
+  void grow(size_t n) {
+    allocatedBytes_ += n;
+    if (allocatedBytes_ > peakBytes_)
+      peakBytes_ = allocatedBytes_;
+  }
+
+  Allocator* upstream_;
+  size_t allocations_ = 0;
+  size_t deallocations_ = 0;
+  size_t reallocations_ = 0;
+  size_t allocatedBytes_ = 0;
+  size_t peakBytes_ = 0;
+};
+
 class KillswitchAllocator : public ArduinoJson::Allocator {
  public:
   KillswitchAllocator(
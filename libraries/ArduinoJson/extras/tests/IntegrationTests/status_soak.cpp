@@ -0,0 +1,89 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <stdio.h>
+
+#include "Allocators.hpp"
+
+// A status document that a terminal updates in place for days: counters, the
+// last tap, a rolling list of recent taps, and from time to time a burst of
+// pending uploads that are removed once sent.
+static void mutate(JsonDocument& doc, unsigned long i) {
+  char uid[16];
+  snprintf(uid, sizeof(uid), "%08lX", (i * 2654435761UL) & 0xFFFFFFFFUL);
+
+  switch (i % 5) {
+    case 0:
+      doc["counters"]["taps"] = i;
+      break;
+    case 1: {
+      JsonObject last = doc["last_tap"];
+      last["uid"] = uid;
+      if (i % 2)
+        last["amount"] = 12500.25 + double(i % 100);  // extension slot
+      else
+        last["amount"] = long(i % 100000);
+      break;
+    }
+    case 2: {
+      JsonArray recent = doc["recent"];
+      JsonObject tap = recent.add<JsonObject>();
+      tap["uid"] = uid;
+      tap["at"] = 1729000000LL + static_cast<long long>(i);
+      if (recent.size() > 8)
+        recent.remove(0);
+      break;
+    }
+    case 3:
+      if (i % 3)
+        doc["alert"] = "low balance";
+      else
+        doc.remove("alert");
+      break;
+    case 4:
+      doc["counters"]["errors"] = i % 7;
+      break;
+  }
+}
+
+TEST_CASE("Status document soak test") {
+  TrackingAllocator tracker;
+  JsonDocument doc(&tracker);
+  doc["counters"].to<JsonObject>();
+  doc["last_tap"].to<JsonObject>();
+  doc["recent"].to<JsonArray>();
+
+  const unsigned long mutations = 1000000;
+  size_t baseline = 0;
+
+  for (unsigned long i = 0; i < mutations; i++) {
+    mutate(doc, i);
+
+    // a burst of pending uploads, sent later
+    if (i % 100000 == 50000) {
+      JsonArray pending = doc["pending"].to<JsonArray>();
+      for (int j = 0; j < 1000; j++)
+        pending.add<JsonObject>()["seq"] = j;
+    }
+    if (i % 100000 == 60000)
+      doc.remove("pending");
+
+    if (i % 10000 == 9999) {
+      REQUIRE(doc.garbageCollect() == true);
+      if (!baseline)
+        baseline = tracker.allocatedBytes();
+      INFO("after " << i + 1 << " mutations");
+      if (doc["pending"].isNull())
+        REQUIRE(tracker.allocatedBytes() <= baseline + sizeofPool());
+    }
+  }
+
+  REQUIRE(doc["recent"].size() == 8);
+  REQUIRE(doc["counters"]["taps"] == 999995);
+  REQUIRE(doc["pending"].isNull());
+  REQUIRE(doc.overflowed() == false);
+}
@@ -0,0 +1,170 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+#include "Allocators.hpp"
+
+namespace {
+struct CardInfo {
+  bool success = false;
+  char uid[8] = "";
+  double balance = 0;
+  bool blocked = true;
+  std::string name;
+  int userId = 0;
+};
+}  // namespace
+
+static const auto cardInfoBinding =
+    bindJson(jsonField("success", &CardInfo::success),
+             jsonField("data.card.uid", &CardInfo::uid),
+             jsonField("data.card.balance", &CardInfo::balance),
+             jsonField("data.card.is_blocked", &CardInfo::blocked),
+             jsonField("data.user.name", &CardInfo::name),
+             jsonField("data.user.id", &CardInfo::userId));
+
+TEST_CASE("JsonBinding::deserialize()") {
+  CardInfo info;
+
+  SECTION("stores the values at the bound paths") {
+    auto err = cardInfoBinding.deserialize(
+        info,
+        "{\"success\":true,\"data\":{\"card\":{\"uid\":\"04A1B2\",\"balance\":"
+        "125000.5,\"is_blocked\":false},\"user\":{\"id\":42,\"name\":\"Siti\"}}"
+        "}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(info.success == true);
+    REQUIRE(info.uid == std::string("04A1B2"));
+    REQUIRE(info.balance == 125000.5);
+    REQUIRE(info.blocked == false);
+    REQUIRE(info.name == "Siti");
+    REQUIRE(info.userId == 42);
+  }
+
+  SECTION("ignores the other members, including arrays") {
+    auto err = cardInfoBinding.deserialize(
+        info,
+        "{\"message\":\"ok\",\"data\":{\"history\":[{\"card\":{\"uid\":\"X\"}}"
+        "],\"card\":{\"permissions\":[1,2],\"balance\":5,\"extra\":{\"uid\":"
+        "\"Y\"}},\"uid\":\"Z\"},\"success\":true}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(info.success == true);
+    REQUIRE(info.balance == 5);
+    REQUIRE(info.uid == std::string(""));
+  }
+
+  SECTION("leaves the missing members unchanged") {
+    info.userId = 7;
+    auto err = cardInfoBinding.deserialize(info, "{\"data\":{\"user\":null}}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(info.userId == 7);
+    REQUIRE(info.blocked == true);
+  }
+
+  SECTION("truncates strings that don't fit in a char array") {
+    auto err = cardInfoBinding.deserialize(
+        info, "{\"data\":{\"card\":{\"uid\":\"04A1B2C3D4E5F6\"}}}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(info.uid == std::string("04A1B2C"));
+  }
+
+  SECTION("converts values like JsonVariant::as<T>()") {
+    auto err = cardInfoBinding.deserialize(
+        info, "{\"success\":1,\"data\":{\"user\":{\"id\":\"x\",\"name\":3}}}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(info.success == true);
+    REQUIRE(info.userId == 0);
+    REQUIRE(info.name == "3");
+  }
+
+  SECTION("a value replaces an object at the same path") {
+    auto err = cardInfoBinding.deserialize(info, "{\"data\":42}");
+
+    REQUIRE(err == DeserializationError::Ok);
+  }
+
+  SECTION("accepts a stream") {
+    std::istringstream json("{\"data\":{\"user\":{\"id\":12}}}");
+
+    auto err = cardInfoBinding.deserialize(info, json);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(info.userId == 12);
+  }
+
+  SECTION("requires an object at the root") {
+    REQUIRE(cardInfoBinding.deserialize(info, "[1,2]") ==
+            DeserializationError::InvalidInput);
+    REQUIRE(cardInfoBinding.deserialize(info, "42") ==
+            DeserializationError::InvalidInput);
+  }
+
+  SECTION("returns EmptyInput") {
+    REQUIRE(cardInfoBinding.deserialize(info, "") ==
+            DeserializationError::EmptyInput);
+  }
+
+  SECTION("returns IncompleteInput") {
+    REQUIRE(cardInfoBinding.deserialize(info, "{\"data\":{\"card\":{") ==
+            DeserializationError::IncompleteInput);
+    REQUIRE(cardInfoBinding.deserialize(info, "{\"message\":[1,") ==
+            DeserializationError::IncompleteInput);
+  }
+
+  SECTION("returns InvalidInput") {
+    REQUIRE(cardInfoBinding.deserialize(info, "{\"success\":true]") ==
+            DeserializationError::InvalidInput);
+  }
+
+  SECTION("honors the nesting limit") {
+    REQUIRE(cardInfoBinding.deserialize(info, "{\"data\":{\"card\":{}}}",
+                                        DeserializationOption::NestingLimit(
+                                            2)) == DeserializationError::TooDeep);
+  }
+}
+
+TEST_CASE("JsonBinding::deserialize() doesn't build a tree") {
+  using namespace ArduinoJson::detail;
+  SpyingAllocator spy;
+  CardInfo info;
+
+  SECTION("only the key buffer for numbers and booleans") {
+    auto err = cardInfoBinding.deserialize(
+        info,
+        "{\"success\":true,\"data\":{\"card\":{\"balance\":12.5,\"is_"
+        "blocked\":false},\"user\":{\"id\":42}},\"history\":[{\"a\":1},"
+        "{\"b\":2}]}",
+        &spy);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(info.balance == 12.5);
+    REQUIRE(info.userId == 42);
+    REQUIRE(spy.log() == AllocatorLog{
+                             Allocate(sizeofStringBuffer()),
+                             Deallocate(sizeofStringBuffer()),
+                         });
+  }
+
+  SECTION("one string buffer at a time") {
+    auto err = cardInfoBinding.deserialize(
+        info, "{\"data\":{\"user\":{\"name\":\"Siti\"}}}", &spy);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(info.name == "Siti");
+    REQUIRE(spy.log() == AllocatorLog{
+                             Allocate(sizeofStringBuffer()),
+                             Reallocate(sizeofStringBuffer(), sizeofString("Siti")),
+                             Deallocate(sizeofString("Siti")),
+                         });
+  }
+}
@@ -0,0 +1,88 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+namespace {
+struct Transaction {
+  long id;
+  char type[12];
+  double amount;
+  bool offline;
+  std::string uid;
+  unsigned terminal;
+};
+}  // namespace
+
+static const auto transactionBinding =
+    bindJson(jsonField("id", &Transaction::id),
+             jsonField("card.uid", &Transaction::uid),
+             jsonField("type", &Transaction::type),
+             jsonField("payment.amount", &Transaction::amount),
+             jsonField("payment.offline", &Transaction::offline),
+             jsonField("card.terminal.id", &Transaction::terminal));
+
+TEST_CASE("JsonBinding::serialize()") {
+  Transaction t = {884213, "payment", 12500.5, false, "04A1", 7};
+
+  SECTION("groups the dotted paths in nested objects") {
+    std::string json;
+
+    size_t n = transactionBinding.serialize(t, json);
+
+    REQUIRE(json ==
+            "{\"id\":884213,\"card\":{\"uid\":\"04A1\",\"terminal\":{\"id\":7}"
+            "},\"type\":\"payment\",\"payment\":{\"amount\":12500.5,"
+            "\"offline\":false}}");
+    REQUIRE(n == json.size());
+  }
+
+  SECTION("escapes the strings") {
+    t.uid = "a\"b";
+    strcpy(t.type, "x\ny");
+    std::string json;
+
+    transactionBinding.serialize(t, json);
+
+    REQUIRE(json ==
+            "{\"id\":884213,\"card\":{\"uid\":\"a\\\"b\",\"terminal\":{\"id\":"
+            "7}},\"type\":\"x\\ny\",\"payment\":{\"amount\":12500.5,"
+            "\"offline\":false}}");
+  }
+
+  SECTION("writes to a char buffer") {
+    char buffer[256];
+
+    size_t n = transactionBinding.serialize(t, buffer, sizeof(buffer));
+
+    REQUIRE(n == strlen(buffer));
+    REQUIRE(buffer[0] == '{');
+  }
+
+  SECTION("measure() returns the length") {
+    std::string json;
+    transactionBinding.serialize(t, json);
+
+    REQUIRE(transactionBinding.measure(t) == json.size());
+  }
+
+  SECTION("output can be read back") {
+    std::string json;
+    transactionBinding.serialize(t, json);
+    Transaction u = {};
+
+    auto err = transactionBinding.deserialize(u, json);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(u.id == t.id);
+    REQUIRE(u.uid == t.uid);
+    REQUIRE(u.type == std::string(t.type));
+    REQUIRE(u.amount == t.amount);
+    REQUIRE(u.offline == t.offline);
+    REQUIRE(u.terminal == t.terminal);
+  }
+}
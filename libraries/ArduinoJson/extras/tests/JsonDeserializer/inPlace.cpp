@@ -0,0 +1,137 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_DECODE_UNICODE 1
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+#include "Allocators.hpp"
+
+using ArduinoJson::detail::sizeofArray;
+using ArduinoJson::detail::sizeofObject;
+
+TEST_CASE("deserializeJsonInPlace()") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+
+  SECTION("doesn't copy strings") {
+    char input[] = "{\"hello\":\"world\",\"answer\":[42,\"life\"]}";
+
+    auto err = deserializeJsonInPlace(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() ==
+            "{\"hello\":\"world\",\"answer\":[42,\"life\"]}");
+    REQUIRE(spy.log() == AllocatorLog{
+                             Allocate(sizeofPool()),
+                             Reallocate(sizeofPool(), sizeofObject(2) +
+                                                          sizeofArray(2)),
+                         });
+  }
+
+  SECTION("points to the input") {
+    char input[] = "[\"hello\"]";
+
+    deserializeJsonInPlace(doc, input);
+
+    REQUIRE(doc[0].as<const char*>() == input + 1);  // over the quote
+    REQUIRE(std::string(input) == "[hello");
+  }
+
+  SECTION("unescapes in place") {
+    char input[] =
+        "{\"a\\tb\":\"1\\\"2\\\\3\\/4\\n5\",\"c\":\"\\u00e4\\ud83d\\udda4\"}";
+
+    auto err = deserializeJsonInPlace(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["a\tb"] == "1\"2\\3/4\n5");
+    REQUIRE(doc["c"] == "\xc3\xa4\xf0\x9f\x96\xa4");
+  }
+
+  SECTION("single quotes and unquoted keys") {
+    char input[] = "{key:'value',other :'x'}";
+
+    auto err = deserializeJsonInPlace(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["key"] == "value");
+    REQUIRE(doc["other"] == "x");
+  }
+
+  SECTION("empty strings") {
+    char input[] = "{\"\":\"\"}";
+
+    auto err = deserializeJsonInPlace(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"\":\"\"}");
+  }
+
+  SECTION("duplicate keys") {
+    char input[] = "{\"a\":\"1\",\"a\":\"2\"}";
+
+    auto err = deserializeJsonInPlace(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"a\":\"2\"}");
+  }
+
+  SECTION("input size") {
+    char input[] = "[\"hello\"]garbage";
+
+    auto err = deserializeJsonInPlace(doc, input, 9);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc[0] == "hello");
+  }
+
+  SECTION("input size cuts a string") {
+    char input[] = "[\"hello\"]";
+
+    auto err = deserializeJsonInPlace(doc, input, 4);
+
+    REQUIRE(err == DeserializationError::IncompleteInput);
+  }
+
+  SECTION("filter") {
+    char input[] = "{\"a\":\"1\",\"b\":\"2\"}";
+    JsonDocument filter;
+    filter["b"] = true;
+
+    auto err = deserializeJsonInPlace(doc, input,
+                                      DeserializationOption::Filter(filter));
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"b\":\"2\"}");
+  }
+
+  SECTION("nesting limit") {
+    char input[] = "[[\"a\"]]";
+
+    auto err = deserializeJsonInPlace(doc, input,
+                                      DeserializationOption::NestingLimit(1));
+
+    REQUIRE(err == DeserializationError::TooDeep);
+  }
+
+  SECTION("invalid input") {
+    char input[] = "{\"a\":\"1\\q\"}";
+
+    auto err = deserializeJsonInPlace(doc, input);
+
+    REQUIRE(err == DeserializationError::InvalidInput);
+  }
+
+  SECTION("copying the document keeps the pointers") {
+    char input[] = "{\"a\":\"b\"}";
+    deserializeJsonInPlace(doc, input);
+
+    JsonDocument copy(doc);
+
+    REQUIRE(copy["a"].as<const char*>() == doc["a"].as<const char*>());
+  }
+}
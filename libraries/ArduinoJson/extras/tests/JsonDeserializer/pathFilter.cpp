@@ -0,0 +1,128 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+using DeserializationOption::PathFilter;
+
+static std::string filtered(const char* input, const PathFilter<>& filter,
+                            DeserializationError expectedError =
+                                DeserializationError::Ok) {
+  JsonDocument doc;
+  REQUIRE(deserializeJson(doc, input, filter) == expectedError);
+  return doc.as<std::string>();
+}
+
+TEST_CASE("deserializeJson() with PathFilter") {
+  const char* input =
+      "{\"success\":true,\"data\":{\"user\":{\"name\":\"Ann\",\"role_type\":"
+      "\"student\",\"email\":\"ann@example.com\"},\"card\":{\"balance\":12.5,"
+      "\"is_blocked\":false,\"history\":[{\"amount\":1},{\"amount\":2}]}}}";
+
+  SECTION("empty filter rejects everything") {
+    PathFilter<> filter;
+    REQUIRE(filtered(input, filter) == "null");
+  }
+
+  SECTION("empty path allows everything") {
+    PathFilter<> filter;
+    filter.add("");
+    REQUIRE(filtered("[1,{\"a\":2}]", filter) == "[1,{\"a\":2}]");
+  }
+
+  SECTION("single path") {
+    PathFilter<> filter;
+    filter.add("data.card.balance");
+    REQUIRE(filtered(input, filter) == "{\"data\":{\"card\":{\"balance\":12.5}}}");
+  }
+
+  SECTION("several paths") {
+    const char* paths[] = {"success", "data.user.name", "data.user.role_type",
+                           "data.card.balance", "data.card.is_blocked"};
+    PathFilter<> filter(paths);
+    REQUIRE_FALSE(filter.overflowed());
+    REQUIRE(filtered(input, filter) ==
+            "{\"success\":true,\"data\":{\"user\":{\"name\":\"Ann\","
+            "\"role_type\":\"student\"},\"card\":{\"balance\":12.5,"
+            "\"is_blocked\":false}}}");
+  }
+
+  SECTION("prefix allows the whole subtree") {
+    PathFilter<> filter;
+    filter.add("data.user");
+    filter.add("data.user.name");  // redundant
+    REQUIRE(filtered(input, filter) ==
+            "{\"data\":{\"user\":{\"name\":\"Ann\",\"role_type\":\"student\","
+            "\"email\":\"ann@example.com\"}}}");
+  }
+
+  SECTION("wildcard matches members and elements") {
+    PathFilter<> filter;
+    filter.add("data.card.history.*.amount");
+    filter.add("data.*.name");
+    REQUIRE(filtered(input, filter) ==
+            "{\"data\":{\"user\":{\"name\":\"Ann\"},\"card\":{\"history\":[{"
+            "\"amount\":1},{\"amount\":2}]}}}");
+  }
+
+  SECTION("exact key is preferred over wildcard") {
+    PathFilter<> filter;
+    filter.add("*.a");
+    filter.add("x.b");
+    REQUIRE(filtered("{\"x\":{\"a\":1,\"b\":2},\"y\":{\"a\":3,\"b\":4}}",
+                     filter) == "{\"x\":{\"b\":2},\"y\":{\"a\":3}}");
+  }
+
+  SECTION("array is rejected without wildcard") {
+    PathFilter<> filter;
+    filter.add("list.id");
+    REQUIRE(filtered("{\"list\":[{\"id\":1}]}", filter) == "{\"list\":null}");
+  }
+
+  SECTION("still reports errors in skipped values") {
+    PathFilter<> filter;
+    filter.add("a");
+    filtered("{\"b\":[1,2", filter, DeserializationError::IncompleteInput);
+  }
+
+  SECTION("overflow") {
+    PathFilter<3> filter;
+    REQUIRE(filter.add("a.b") == true);
+    REQUIRE(filter.add("a.c") == false);
+    REQUIRE(filter.overflowed() == true);
+  }
+
+  SECTION("failed path leaves no prefix behind") {
+    PathFilter<4> filter;
+    REQUIRE(filter.add("a.b") == true);
+    REQUIRE(filter.add("c.d.e") == false);
+    REQUIRE(filter.add("a.f") == true);
+
+    JsonDocument doc;
+    deserializeJson(doc, "{\"c\":{\"d\":1},\"a\":{\"b\":2,\"f\":3}}",
+                    filter);
+    REQUIRE(doc.as<std::string>() == "{\"a\":{\"b\":2,\"f\":3}}");
+  }
+
+  SECTION("nesting limit") {
+    PathFilter<> filter;
+    filter.add("a");
+    JsonDocument doc;
+    REQUIRE(deserializeJson(doc, "{\"a\":[[1]]}",
+                            DeserializationOption::NestingLimit(2), filter) ==
+            DeserializationError::TooDeep);
+  }
+
+  SECTION("MessagePack") {
+    PathFilter<> filter;
+    filter.add("b");
+    JsonDocument doc;
+    REQUIRE(deserializeMsgPack(doc, "\x82\xA1\x61\x01\xA1\x62\x02", filter) ==
+            DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"b\":2}");
+  }
+}
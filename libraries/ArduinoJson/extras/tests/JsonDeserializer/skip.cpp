@@ -0,0 +1,139 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_ENABLE_COMMENTS 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <sstream>
+#include <string>
+
+// The values rejected by the filter are skipped by the SkipScanner when the
+// input is in RAM, and by JsonDeserializer::skipVariant() otherwise; both
+// must agree.
+static DeserializationError skipWithAllReaders(
+    const std::string& input, JsonDocument& filterDoc,
+    DeserializationOption::NestingLimit nestingLimit = {}) {
+  JsonDocument doc1, doc2, doc3;
+  DeserializationOption::Filter filter(filterDoc);
+
+  auto err1 = deserializeJson(doc1, input.c_str(), filter, nestingLimit);
+  auto err2 = deserializeJson(doc2, input.data(), input.size(), filter,
+                              nestingLimit);
+  std::istringstream stream(input);
+  auto err3 = deserializeJson(doc3, stream, filter, nestingLimit);
+
+  CAPTURE(input);
+  CHECK(err2 == err1);
+  CHECK(err3 == err1);
+  CHECK(doc2.as<std::string>() == doc1.as<std::string>());
+  CHECK(doc3.as<std::string>() == doc1.as<std::string>());
+  return err1;
+}
+
+TEST_CASE("Skip rejected values") {
+  JsonDocument filter;
+  filter["keep"] = true;
+
+  SECTION("nested containers") {
+    REQUIRE(skipWithAllReaders("{\"skip\":[1,{\"a\":[[],{}]},\"]\",true],"
+                               "\"keep\":1}",
+                               filter) == DeserializationError::Ok);
+    REQUIRE(skipWithAllReaders("{\"skip\":{\"a\":{'b':null,c:-1.5e3}},"
+                               "\"keep\":1}",
+                               filter) == DeserializationError::Ok);
+  }
+
+  SECTION("spaces and comments") {
+    REQUIRE(skipWithAllReaders("{\"skip\" : [ 1 , /* ] */ { } // }\n ] ,"
+                               "\"keep\":1}",
+                               filter) == DeserializationError::Ok);
+    REQUIRE(skipWithAllReaders("{\"skip\":[1/*]", filter) ==
+            DeserializationError::IncompleteInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":[1/]", filter) ==
+            DeserializationError::InvalidInput);
+  }
+
+  SECTION("invalid input") {
+    REQUIRE(skipWithAllReaders("{\"skip\":[1}", filter) ==
+            DeserializationError::InvalidInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":{\"a\"]", filter) ==
+            DeserializationError::InvalidInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":{\"a\":1,}}", filter) ==
+            DeserializationError::InvalidInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":[1 2]}", filter) ==
+            DeserializationError::InvalidInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":[nul]}", filter) ==
+            DeserializationError::InvalidInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":[!]}", filter) ==
+            DeserializationError::InvalidInput);
+  }
+
+  SECTION("incomplete input") {
+    REQUIRE(skipWithAllReaders("{\"skip\":[", filter) ==
+            DeserializationError::IncompleteInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":{\"a\":[1,{", filter) ==
+            DeserializationError::IncompleteInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":[tru", filter) ==
+            DeserializationError::IncompleteInput);
+    REQUIRE(skipWithAllReaders("{\"skip\":['abc\\", filter) ==
+            DeserializationError::IncompleteInput);
+    REQUIRE(skipWithAllReaders(std::string("{\"skip\":[\"abc\0\"]}", 17),
+                               filter) ==
+            DeserializationError::IncompleteInput);
+  }
+
+  SECTION("nesting limit") {
+    DeserializationOption::NestingLimit limit(3);
+    REQUIRE(skipWithAllReaders("{\"skip\":[[1]],\"keep\":1}", filter,
+                               limit) == DeserializationError::Ok);
+    REQUIRE(skipWithAllReaders("{\"skip\":[[[1]]],\"keep\":1}", filter,
+                               limit) == DeserializationError::TooDeep);
+    REQUIRE(skipWithAllReaders("{\"skip\":{\"a\":{}},\"keep\":1}", filter,
+                               limit) == DeserializationError::Ok);
+    REQUIRE(skipWithAllReaders("{\"skip\":{\"a\":{\"b\":{}}},\"keep\":1}",
+                               filter,
+                               limit) == DeserializationError::TooDeep);
+  }
+
+  SECTION("long strings") {
+    // moves the special characters across the word boundaries
+    for (size_t i = 0; i < 40; i++) {
+      std::string padding(i, 'x');
+      REQUIRE(skipWithAllReaders("{\"skip\":[\"" + padding +
+                                     "\\\"]\\\\\"],\"keep\":1}",
+                                 filter) == DeserializationError::Ok);
+      REQUIRE(skipWithAllReaders("{\"skip\":'" + padding +
+                                     "\"\\'',\"keep\":1}",
+                                 filter) == DeserializationError::Ok);
+      REQUIRE(skipWithAllReaders("{\"skip\":[\"" + padding, filter) ==
+              DeserializationError::IncompleteInput);
+      REQUIRE(skipWithAllReaders("{\"skip\":\"" + padding + "\\", filter) ==
+              DeserializationError::IncompleteInput);
+    }
+  }
+}
+
+TEST_CASE("Skip rejected elements in RAM") {
+  JsonDocument doc;
+  JsonDocument filter;
+  filter[0]["id"] = true;
+
+  std::string input = "[";
+  for (int i = 0; i < 10; i++) {
+    if (i)
+      input += ",";
+    input += "{\"id\":" + std::to_string(i) +
+             ",\"history\":[{\"note\":\"a \\\"long\\\" note that spans "
+             "several words\"},[]],\"permissions\":{\"door\":[1,2,3]}}";
+  }
+  input += "]";
+
+  auto err = deserializeJson(doc, input.data(), input.size(),
+                             DeserializationOption::Filter(filter));
+
+  REQUIRE(err == DeserializationError::Ok);
+  REQUIRE(doc.size() == 10);
+  REQUIRE(doc[9].as<std::string>() == "{\"id\":9}");
+}
@@ -0,0 +1,128 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+#include "Allocators.hpp"
+
+TEST_CASE("JsonDocument::garbageCollect()") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+
+  SECTION("null") {
+    REQUIRE(doc.garbageCollect() == true);
+
+    REQUIRE(doc.isNull());
+    REQUIRE(spy.log() == AllocatorLog{});
+  }
+
+  SECTION("no free slot") {
+    deserializeJson(doc, "[1,2,3]");
+    spy.clearLog();
+
+    REQUIRE(doc.garbageCollect() == true);
+
+    REQUIRE(doc.as<std::string>() == "[1,2,3]");
+    REQUIRE(spy.log() == AllocatorLog{});
+  }
+
+  SECTION("releases the empty pools") {
+    JsonArray array = doc.to<JsonArray>();
+    for (int i = 0; i < ARDUINOJSON_POOL_CAPACITY * 2; i++)
+      array.add(i);
+    for (int i = 0; i < ARDUINOJSON_POOL_CAPACITY; i++)
+      array.remove(0);
+    spy.clearLog();
+
+    REQUIRE(doc.garbageCollect() == true);
+
+    REQUIRE(doc.size() == ARDUINOJSON_POOL_CAPACITY);
+    for (int i = 0; i < ARDUINOJSON_POOL_CAPACITY; i++)
+      REQUIRE(doc[i] == ARDUINOJSON_POOL_CAPACITY + i);
+    REQUIRE(spy.log() == AllocatorLog{
+                             Allocate(ARDUINOJSON_POOL_CAPACITY / 8),
+                             Deallocate(ARDUINOJSON_POOL_CAPACITY / 8),
+                             Deallocate(sizeofPool()),
+                         });
+  }
+
+  SECTION("moves the slots of nested values") {
+    deserializeJson(doc, "{\"old\":[1,2,3,4,5,6],\"a\":{\"b\":[1,{\"c\":3}]}}");
+    doc.remove("old");
+    doc["d"]["e"] = "hello";
+    doc["a"]["b"].add(7);
+
+    REQUIRE(doc.garbageCollect() == true);
+
+    REQUIRE(doc.as<std::string>() ==
+            "{\"a\":{\"b\":[1,{\"c\":3},7]},\"d\":{\"e\":\"hello\"}}");
+  }
+
+  SECTION("after the last pool was shrunk by deserializeJson()") {
+    // the shrunk pool holds fewer slots than the new one after it
+    deserializeJson(doc, "{\"a\":1,\"b\":2,\"c\":3}");
+    for (int i = 0; i < 10; i++)
+      doc["k" + std::to_string(i)] = i;
+    doc.remove("a");
+    doc.remove("b");
+
+    REQUIRE(doc.garbageCollect() == true);
+
+    REQUIRE(doc.as<std::string>() ==
+            "{\"c\":3,\"k0\":0,\"k1\":1,\"k2\":2,\"k3\":3,\"k4\":4,"
+            "\"k5\":5,\"k6\":6,\"k7\":7,\"k8\":8,\"k9\":9}");
+    doc["k10"] = 10;
+    doc.remove("c");
+    REQUIRE(doc.garbageCollect() == true);
+    REQUIRE(doc.size() == 11);
+    REQUIRE(doc["k10"] == 10);
+  }
+
+  SECTION("moves the extensions") {
+    doc["removed"] = "x";
+    doc["removed2"] = 1.5;
+    doc["removed3"] = 2.5;
+    doc["big"] = 1234567890123456789LL;
+    doc["pi"] = 3.141592653589793;
+    doc.remove("removed");
+    doc.remove("removed2");
+    doc.remove("removed3");
+
+    REQUIRE(doc.garbageCollect() == true);
+
+    REQUIRE(doc["big"].as<long long>() == 1234567890123456789LL);
+    REQUIRE(doc["pi"].as<double>() == 3.141592653589793);
+    REQUIRE(doc.size() == 2);
+  }
+
+  SECTION("the document can be modified afterwards") {
+    deserializeJson(doc, "[[1,2],[3,4],[5,6]]");
+    doc.remove(0);
+    doc.remove(1);
+
+    REQUIRE(doc.garbageCollect() == true);
+    doc[0].add(5);
+    doc.add("x");
+    doc.remove(0);
+
+    REQUIRE(doc.as<std::string>() == "[\"x\"]");
+  }
+
+  SECTION("keeps the memory when the bitmap can't be allocated") {
+    TimebombAllocator timebomb(1);
+    JsonDocument doc2(&timebomb);
+    deserializeJson(doc2, "[1,2,3,4]");
+    doc2.remove(1);
+
+    REQUIRE(doc2.garbageCollect() == false);
+
+    REQUIRE(doc2.as<std::string>() == "[1,3,4]");
+    timebomb.setCountdown(1);
+    REQUIRE(doc2.garbageCollect() == true);
+    REQUIRE(doc2.as<std::string>() == "[1,3,4]");
+  }
+}
@@ -0,0 +1,116 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+#include "Allocators.hpp"
+#include "Literals.hpp"
+
+TEST_CASE("JsonDocument::retainMemory()") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+  doc.retainMemory();
+
+  SECTION("clear() keeps the pool") {
+    doc["hello"_s] = "world"_s;
+    spy.clearLog();
+
+    doc.clear();
+
+    REQUIRE(doc.isNull());
+    REQUIRE(spy.log() == AllocatorLog{
+                             Deallocate(sizeofString("hello")),
+                             Deallocate(sizeofString("world")),
+                         });
+  }
+
+  SECTION("the pool is reused after clear()") {
+    doc["a"] = 1;
+    doc.clear();
+    spy.clearLog();
+
+    doc["b"] = 2;
+
+    REQUIRE(doc.as<std::string>() == "{\"b\":2}");
+    REQUIRE(spy.log() == AllocatorLog{});
+  }
+
+  SECTION("deserializeJson() reuses the pool and doesn't shrink it") {
+    deserializeJson(doc, "[1,2,3]");
+    deserializeJson(doc, "[4,5,6]");
+
+    REQUIRE(doc.as<std::string>() == "[4,5,6]");
+    REQUIRE(spy.log() == AllocatorLog{
+                             Allocate(sizeofPool()),
+                         });
+  }
+
+  SECTION("the free list is emptied") {  // same as issue #2034
+    JsonObject obj = doc.to<JsonObject>();
+    obj["a"] = 1;
+    obj.clear();  // puts the slot in the free list
+
+    doc.clear();
+
+    doc["b"] = 2;
+
+    REQUIRE(doc.as<std::string>() == "{\"b\":2}");
+  }
+
+  SECTION("shrinkToFit() releases the retained pool") {
+    doc["a"] = 1;
+    doc.clear();
+    spy.clearLog();
+
+    doc.shrinkToFit();
+
+    REQUIRE(spy.log() == AllocatorLog{
+                             Deallocate(sizeofPool()),
+                         });
+  }
+
+  SECTION("clear() releases a pool shrunk by shrinkToFit()") {
+    doc["a"] = 1;
+    doc.shrinkToFit();
+    spy.clearLog();
+
+    doc.clear();
+    doc["b"] = 2;
+
+    REQUIRE(doc.as<std::string>() == "{\"b\":2}");
+    REQUIRE(spy.log() == AllocatorLog{
+                             Deallocate(sizeofPool(2)),
+                             Allocate(sizeofPool()),
+                         });
+  }
+
+  SECTION("the destructor releases the retained pool") {
+    {
+      JsonDocument doc2(&spy);
+      doc2.retainMemory();
+      doc2["a"] = 1;
+      doc2.clear();
+      spy.clearLog();
+    }
+
+    REQUIRE(spy.log() == AllocatorLog{
+                             Deallocate(sizeofPool()),
+                         });
+  }
+
+  SECTION("retainMemory(false) restores the default behavior") {
+    doc.retainMemory(false);
+    doc["a"] = 1;
+    spy.clearLog();
+
+    doc.clear();
+
+    REQUIRE(spy.log() == AllocatorLog{
+                             Deallocate(sizeofPool()),
+                         });
+  }
+}
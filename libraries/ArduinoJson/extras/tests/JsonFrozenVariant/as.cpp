@@ -0,0 +1,140 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+static std::vector<uint8_t> freeze(JsonVariantConst value) {
+  std::vector<uint8_t> image(measureFrozenJson(value));
+  freezeJson(value, image.data(), image.size());
+  return image;
+}
+
+TEST_CASE("JsonFrozenVariant::is<T>() and as<T>()") {
+  JsonDocument doc;
+
+  SECTION("unbound") {
+    JsonFrozenVariant variant;
+
+    REQUIRE(variant.isNull() == true);
+    REQUIRE(variant.size() == 0);
+    REQUIRE(variant.is<int>() == false);
+    REQUIRE(variant.as<int>() == 0);
+    REQUIRE(variant.as<bool>() == false);
+    REQUIRE(variant.as<const char*>() == nullptr);
+    REQUIRE(variant.as<JsonString>().isNull() == true);
+  }
+
+  SECTION("null") {
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.isNull() == true);
+    REQUIRE(variant.is<bool>() == false);
+    REQUIRE(variant.as<const char*>() == nullptr);
+  }
+
+  SECTION("true") {
+    doc.set(true);
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.is<bool>() == true);
+    REQUIRE(variant.is<int>() == false);
+    REQUIRE(variant.as<bool>() == true);
+    REQUIRE(variant.as<int>() == 1);
+  }
+
+  SECTION("false") {
+    doc.set(false);
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.is<bool>() == true);
+    REQUIRE(variant.as<bool>() == false);
+    REQUIRE(variant.as<int>() == 0);
+  }
+
+  SECTION("negative integer") {
+    doc.set(-300);
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.is<int>() == true);
+    REQUIRE(variant.is<unsigned>() == false);
+    REQUIRE(variant.is<int8_t>() == false);
+    REQUIRE(variant.is<double>() == true);
+    REQUIRE(variant.is<const char*>() == false);
+    REQUIRE(variant.as<int>() == -300);
+    REQUIRE(variant.as<int8_t>() == 0);
+    REQUIRE(variant.as<double>() == -300);
+    REQUIRE(variant.as<bool>() == true);
+  }
+
+  SECTION("large unsigned integer") {
+    doc.set(4294967295U);
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.is<uint32_t>() == true);
+    REQUIRE(variant.is<int16_t>() == false);
+    REQUIRE(variant.as<uint32_t>() == 4294967295U);
+  }
+
+  SECTION("float") {
+    doc.set(3.14);
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.is<double>() == true);
+    REQUIRE(variant.is<int>() == false);
+    REQUIRE(variant.as<double>() == 3.14);
+    REQUIRE(variant.as<int>() == 3);
+    REQUIRE(variant.as<bool>() == true);
+  }
+
+  SECTION("string") {
+    doc.set("hello");
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.is<const char*>() == true);
+    REQUIRE(variant.is<JsonString>() == true);
+    REQUIRE(variant.is<int>() == false);
+    REQUIRE(variant.as<const char*>() == std::string("hello"));
+    REQUIRE(variant.as<JsonString>().isStatic() == true);
+    REQUIRE(variant.as<int>() == 0);
+    REQUIRE(variant.as<bool>() == true);
+  }
+
+  SECTION("raw string") {
+    doc.set(serialized("[1,2]"));
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.as<JsonString>() == "[1,2]");
+  }
+
+  SECTION("array") {
+    doc.to<JsonArray>().add(1);
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.is<JsonArrayConst>() == true);
+    REQUIRE(variant.is<JsonObjectConst>() == false);
+    REQUIRE(variant.as<const char*>() == nullptr);
+  }
+
+  SECTION("object") {
+    doc["a"] = 1;
+    auto image = freeze(doc);
+    JsonFrozenVariant variant(image.data());
+
+    REQUIRE(variant.is<JsonObjectConst>() == true);
+    REQUIRE(variant.is<JsonArrayConst>() == false);
+  }
+}
@@ -0,0 +1,92 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("freezeJson()") {
+  JsonDocument doc;
+  std::vector<uint8_t> image(1024);
+
+  SECTION("null") {
+    size_t n = freezeJson(doc, image.data(), image.size());
+
+    REQUIRE(n == 9);  // header + type
+    REQUIRE(JsonFrozenVariant(image.data()).isNull() == true);
+  }
+
+  SECTION("integer") {
+    doc.set(42);
+
+    REQUIRE(freezeJson(doc, image.data(), image.size()) == 17);
+    REQUIRE(JsonFrozenVariant(image.data()).as<int>() == 42);
+  }
+
+  SECTION("short string") {
+    doc.set("hello");
+
+    REQUIRE(freezeJson(doc, image.data(), image.size()) == 16);
+    REQUIRE(JsonFrozenVariant(image.data()).as<JsonString>() == "hello");
+  }
+
+  SECTION("long string") {
+    std::string s(300, 'x');
+    doc.set(s);
+
+    REQUIRE(freezeJson(doc, image.data(), image.size()) == 8 + 1 + 4 + 301);
+    REQUIRE(JsonFrozenVariant(image.data()).as<const char*>() == s);
+  }
+
+  SECTION("object") {
+    deserializeJson(doc, "{\"b\":1,\"a\":true}");
+
+    // header + object (1 + 4 + 2 * 8) + 2 keys (4) + int (9) + bool (1)
+    REQUIRE(freezeJson(doc, image.data(), image.size()) == 8 + 21 + 8 + 10);
+  }
+
+  SECTION("returns 0 if the buffer is too small") {
+    deserializeJson(doc, "{\"hello\":\"world\",\"values\":[1,2,3]}");
+    size_t size = measureFrozenJson(doc);
+
+    REQUIRE(freezeJson(doc, image.data(), size - 1) == 0);
+    REQUIRE(freezeJson(doc, image.data(), size) == size);
+  }
+
+  SECTION("doesn't write past the buffer") {
+    deserializeJson(doc, "{\"hello\":\"world\",\"values\":[1,2,3]}");
+    size_t size = measureFrozenJson(doc);
+    std::fill(image.begin(), image.end(), 0x55);
+
+    freezeJson(doc, image.data(), size / 2);
+
+    for (size_t i = size / 2; i < image.size(); i++)
+      REQUIRE(image[i] == 0x55);
+  }
+
+  SECTION("the image is relocatable") {
+    deserializeJson(doc, "{\"wifi\":{\"ssid\":\"Kantin\"},\"ports\":[80,443]}");
+    size_t size = freezeJson(doc, image.data(), image.size());
+    std::vector<uint8_t> copy(image.begin(), image.begin() + long(size));
+    std::fill(image.begin(), image.end(), 0);
+
+    JsonFrozenVariant root(copy.data(), copy.size());
+
+    REQUIRE(root["wifi"]["ssid"].as<JsonString>() == "Kantin");
+    REQUIRE(root["ports"][1].as<int>() == 443);
+  }
+}
+
+TEST_CASE("measureFrozenJson()") {
+  JsonDocument doc;
+  deserializeJson(doc,
+                  "{\"config\":{\"version\":7,\"host\":\"api.example.sch.id\","
+                  "\"gain\":0.25},\"allow\":[\"04A1\",\"04A2\",null,false]}");
+  std::vector<uint8_t> image(1024);
+
+  REQUIRE(measureFrozenJson(doc) ==
+          freezeJson(doc, image.data(), image.size()));
+}
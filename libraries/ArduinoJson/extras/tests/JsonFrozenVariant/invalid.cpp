@@ -0,0 +1,65 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <vector>
+
+TEST_CASE("JsonFrozenVariant with an invalid image") {
+  JsonDocument doc;
+  deserializeJson(doc, "{\"name\":\"Siti\",\"ids\":[1,2,3]}");
+  std::vector<uint8_t> image(measureFrozenJson(doc));
+  freezeJson(doc, image.data(), image.size());
+
+  SECTION("null pointer") {
+    REQUIRE(JsonFrozenVariant(nullptr).isNull() == true);
+  }
+
+  SECTION("wrong magic") {
+    image[1] = 'X';
+
+    REQUIRE(JsonFrozenVariant(image.data()).isNull() == true);
+  }
+
+  SECTION("capacity smaller than the image") {
+    REQUIRE(JsonFrozenVariant(image.data(), image.size() - 1).isNull() ==
+            true);
+    REQUIRE(JsonFrozenVariant(image.data(), 4).isNull() == true);
+    REQUIRE(JsonFrozenVariant(image.data(), image.size()).isNull() == false);
+  }
+
+  SECTION("size in header smaller than the root") {
+    image[4] = 9;  // header + type of the root, but not its table
+    image[5] = image[6] = image[7] = 0;
+
+    REQUIRE(JsonFrozenVariant(image.data()).isNull() == true);
+  }
+
+  SECTION("child offset out of range") {
+    // the first entry of the root object
+    image[8 + 5] = 0xFF;
+    image[8 + 6] = 0xFF;
+
+    JsonFrozenVariant root(image.data());
+
+    REQUIRE(root.size() == 2);
+    REQUIRE(root.keyAt(0).isNull() == true);
+  }
+
+  SECTION("string length out of range") {
+    JsonDocument small;
+    small["name"] = "Siti";
+    std::vector<uint8_t> buffer(measureFrozenJson(small));
+    freezeJson(small, buffer.data(), buffer.size());
+    // header (8) + object (1 + 4 + 8) puts the key at 21
+    REQUIRE(buffer[21] == 6);  // ShortString
+    buffer[22] = 0xFF;
+
+    JsonFrozenVariant root(buffer.data(), buffer.size());
+
+    REQUIRE(root.keyAt(0).isNull() == true);
+    REQUIRE(root["name"].isNull() == true);
+  }
+}
@@ -0,0 +1,123 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+static std::vector<uint8_t> freeze(const char* json) {
+  JsonDocument doc;
+  deserializeJson(doc, json);
+  std::vector<uint8_t> image(measureFrozenJson(doc));
+  freezeJson(doc, image.data(), image.size());
+  return image;
+}
+
+TEST_CASE("JsonFrozenVariant::operator[]") {
+  SECTION("object") {
+    auto image = freeze(
+        "{\"uid\":\"04A1\",\"balance\":125000.5,\"user\":{\"name\":\"Siti\","
+        "\"class\":\"XI IPA 2\"},\"a\":1,\"z\":2,\"ab\":3}");
+    JsonFrozenVariant root(image.data(), image.size());
+
+    REQUIRE(root.size() == 6);
+    REQUIRE(root["uid"].as<JsonString>() == "04A1");
+    REQUIRE(root["balance"].as<double>() == 125000.5);
+    REQUIRE(root["user"]["name"].as<JsonString>() == "Siti");
+    REQUIRE(root["a"].as<int>() == 1);
+    REQUIRE(root["ab"].as<int>() == 3);
+    REQUIRE(root["z"].as<int>() == 2);
+  }
+
+  SECTION("missing key") {
+    auto image = freeze("{\"a\":1,\"c\":2}");
+    JsonFrozenVariant root(image.data());
+
+    REQUIRE(root["b"].isNull() == true);
+    REQUIRE(root[""].isNull() == true);
+    REQUIRE(root["aa"].isNull() == true);
+    REQUIRE(root["d"]["e"].isNull() == true);
+  }
+
+  SECTION("std::string key") {
+    auto image = freeze("{\"hello\":\"world\"}");
+    JsonFrozenVariant root(image.data());
+
+    REQUIRE(root[std::string("hello")].as<JsonString>() == "world");
+  }
+
+  SECTION("non-const char* key") {
+    auto image = freeze("{\"hello\":\"world\"}");
+    JsonFrozenVariant root(image.data());
+    char key[] = "hello";
+
+    REQUIRE(root[key].as<JsonString>() == "world");
+  }
+
+  SECTION("key with a NUL") {
+    auto image = freeze("{\"a\\u0000b\":1,\"a\":2}");
+    JsonFrozenVariant root(image.data());
+
+    REQUIRE(root["a"].as<int>() == 2);
+    REQUIRE(root[JsonString("a\0b", 3)].as<int>() == 1);
+  }
+
+  SECTION("array") {
+    auto image = freeze("[10,\"twenty\",[30],{\"x\":40}]");
+    JsonFrozenVariant root(image.data());
+
+    REQUIRE(root.size() == 4);
+    REQUIRE(root[0].as<int>() == 10);
+    REQUIRE(root[1].as<JsonString>() == "twenty");
+    REQUIRE(root[2][0].as<int>() == 30);
+    REQUIRE(root[3]["x"].as<int>() == 40);
+    REQUIRE(root[4].isNull() == true);
+  }
+
+  SECTION("key on an array, index on an object") {
+    auto image = freeze("[{\"0\":1}]");
+    JsonFrozenVariant root(image.data());
+
+    REQUIRE(root["0"].isNull() == true);
+    REQUIRE(root[0][0].isNull() == true);
+  }
+
+  SECTION("large object") {
+    JsonDocument doc;
+    for (int i = 999; i >= 0; i--)
+      doc[std::to_string(i)] = i;
+    std::vector<uint8_t> image(measureFrozenJson(doc));
+    freezeJson(doc, image.data(), image.size());
+    JsonFrozenVariant root(image.data());
+
+    for (int i = 0; i < 1000; i++)
+      REQUIRE(root[std::to_string(i)].as<int>() == i);
+  }
+}
+
+TEST_CASE("JsonFrozenVariant::keyAt() and valueAt()") {
+  auto image = freeze("{\"b\":2,\"c\":3,\"a\":1}");
+  JsonFrozenVariant root(image.data());
+
+  SECTION("iterates the members in key order") {
+    REQUIRE(root.keyAt(0) == "a");
+    REQUIRE(root.valueAt(0).as<int>() == 1);
+    REQUIRE(root.keyAt(1) == "b");
+    REQUIRE(root.valueAt(1).as<int>() == 2);
+    REQUIRE(root.keyAt(2) == "c");
+    REQUIRE(root.valueAt(2).as<int>() == 3);
+  }
+
+  SECTION("out of range") {
+    REQUIRE(root.keyAt(3).isNull() == true);
+    REQUIRE(root.valueAt(3).isNull() == true);
+  }
+
+  SECTION("not an object") {
+    REQUIRE(root["a"].keyAt(0).isNull() == true);
+    REQUIRE(root["a"].valueAt(0).isNull() == true);
+  }
+}
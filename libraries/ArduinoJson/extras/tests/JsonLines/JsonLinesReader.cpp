@@ -0,0 +1,193 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+#include "Allocators.hpp"
+
+TEST_CASE("JsonLinesReader") {
+  JsonDocument doc;
+
+  SECTION("reads one record per line") {
+    JsonLinesReader<const char*> reader(
+        "{\"uid\":\"04A1\",\"amount\":100}\n"
+        "{\"uid\":\"04A2\",\"amount\":200}\n"
+        "[1,2]\n"
+        "42\n",
+        doc);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.error() == DeserializationError::Ok);
+    REQUIRE(doc["uid"] == "04A1");
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["amount"] == 200);
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc.as<std::string>() == "[1,2]");
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc.as<int>() == 42);
+    REQUIRE(reader.next() == false);
+    REQUIRE(reader.errors() == 0);
+  }
+
+  SECTION("last line without newline") {
+    JsonLinesReader<const char*> reader("{\"a\":1}\n{\"a\":2}", doc);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 2);
+    REQUIRE(reader.next() == false);
+  }
+
+  SECTION("skips blank lines") {
+    JsonLinesReader<const char*> reader("\n{\"a\":1}\r\n  \r\n\n{\"a\":2}\n\n",
+                                        doc);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 1);
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 2);
+    REQUIRE(reader.next() == false);
+  }
+
+  SECTION("resynchronizes after a truncated line") {
+    JsonLinesReader<const char*> reader(
+        "{\"a\":1}\n{\"a\":2,\"b\":\n{\"a\":3}\n", doc);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 1);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.error() == DeserializationError::IncompleteInput);
+    REQUIRE(doc.isNull());
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.error() == DeserializationError::Ok);
+    REQUIRE(doc["a"] == 3);
+
+    REQUIRE(reader.next() == false);
+    REQUIRE(reader.errors() == 1);
+  }
+
+  SECTION("resynchronizes after garbage") {
+    JsonLinesReader<const char*> reader("%$#@!\n{\"a\":1}\n", doc);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.error() == DeserializationError::InvalidInput);
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 1);
+  }
+
+  SECTION("rejects trailing characters") {
+    JsonLinesReader<const char*> reader("{\"a\":1} {\"a\":2}\n{\"a\":3}\n",
+                                        doc);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.error() == DeserializationError::InvalidInput);
+    REQUIRE(doc.isNull());
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 3);
+  }
+
+  SECTION("accepts trailing spaces") {
+    JsonLinesReader<const char*> reader("{\"a\":1}  \t\r\n", doc);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.error() == DeserializationError::Ok);
+  }
+
+  SECTION("honors the nesting limit") {
+    JsonLinesReader<const char*> reader(
+        "[[1]]\n[2]\n", doc, DeserializationOption::NestingLimit(1));
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.error() == DeserializationError::TooDeep);
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc[0] == 2);
+  }
+
+  SECTION("reads a std::istream") {
+    std::istringstream input("{\"a\":1}\n{\"a\":2}\n");
+    JsonLinesReader<std::istream> reader(input, doc);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 1);
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 2);
+    REQUIRE(reader.next() == false);
+    REQUIRE(reader.bytesRead() == 16);
+  }
+
+  SECTION("record limit") {
+    JsonLinesReader<const char*> reader("1\n2\n3\n4\n5\n", doc);
+    reader.setRecordLimit(2);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.next() == false);
+    REQUIRE(reader.batchRecords() == 2);
+
+    reader.startBatch();
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc.as<int>() == 3);
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.next() == false);
+
+    reader.startBatch();
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc.as<int>() == 5);
+    REQUIRE(reader.next() == false);
+  }
+
+  SECTION("byte budget") {
+    JsonLinesReader<const char*> reader(
+        "{\"a\":1}\n{\"a\":2}\n{\"a\":3}\n", doc);  // 8 bytes per line
+    reader.setByteBudget(10);
+
+    REQUIRE(reader.next() == true);
+    REQUIRE(reader.next() == true);  // crosses the budget
+    REQUIRE(doc["a"] == 2);
+    REQUIRE(reader.next() == false);
+
+    reader.startBatch();
+    REQUIRE(reader.next() == true);
+    REQUIRE(doc["a"] == 3);
+  }
+}
+
+TEST_CASE("JsonLinesReader reuses the memory pools") {
+  using namespace ArduinoJson::detail;
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+  JsonLinesReader<const char*> reader(
+      "{\"seq\":1,\"ok\":true}\n{\"seq\":2,\"ok\":false}\n"
+      "{\"seq\":3,\"ok\":true}\n",
+      doc);
+
+  REQUIRE(reader.next() == true);
+  spy.clearLog();
+
+  REQUIRE(reader.next() == true);
+  REQUIRE(reader.next() == true);
+  REQUIRE(doc["seq"] == 3);
+
+  // the keys are the same on each line: they are the only allocations
+  REQUIRE(spy.log() == AllocatorLog{
+                           Deallocate(sizeofString("ok")),
+                           Deallocate(sizeofString("seq")),
+                           Allocate(sizeofStringBuffer()),
+                           Reallocate(sizeofStringBuffer(), sizeofString("seq")),
+                           Allocate(sizeofStringBuffer()),
+                           Reallocate(sizeofStringBuffer(), sizeofString("ok")),
+                           Deallocate(sizeofString("ok")),
+                           Deallocate(sizeofString("seq")),
+                           Allocate(sizeofStringBuffer()),
+                           Reallocate(sizeofStringBuffer(), sizeofString("seq")),
+                           Allocate(sizeofStringBuffer()),
+                           Reallocate(sizeofStringBuffer(), sizeofString("ok")),
+                       });
+}
@@ -0,0 +1,69 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+TEST_CASE("JsonLinesWriter") {
+  JsonDocument doc;
+
+  SECTION("writes one line per record") {
+    std::string output = "garbage";
+    JsonLinesWriter<std::string> writer(output);
+    REQUIRE(output == "");
+
+    doc["uid"] = "04A1";
+    doc["amount"] = 100;
+    REQUIRE(writer.write(doc) == 28);
+    doc["uid"] = "04A2";
+    REQUIRE(writer.write(doc) == 28);
+
+    REQUIRE(output ==
+            "{\"uid\":\"04A1\",\"amount\":100}\n"
+            "{\"uid\":\"04A2\",\"amount\":100}\n");
+    REQUIRE(writer.records() == 2);
+    REQUIRE(writer.bytesWritten() == 56);
+  }
+
+  SECTION("escapes the newlines in the strings") {
+    std::string output;
+    JsonLinesWriter<std::string> writer(output);
+
+    doc["message"] = "line1\nline2";
+    writer.write(doc);
+
+    REQUIRE(output == "{\"message\":\"line1\\nline2\"}\n");
+  }
+
+  SECTION("writes to a std::ostream") {
+    std::ostringstream output;
+    JsonLinesWriter<std::ostream> writer(output);
+
+    writer.write(doc.to<JsonArray>());
+    writer.write(JsonVariantConst());
+
+    REQUIRE(output.str() == "[]\nnull\n");
+  }
+
+  SECTION("round trip") {
+    std::string output;
+    JsonLinesWriter<std::string> writer(output);
+    for (int i = 0; i < 10; i++) {
+      doc.clear();
+      doc["seq"] = i;
+      writer.write(doc);
+    }
+
+    JsonLinesReader<std::string> reader(output, doc);
+    int count = 0;
+    while (reader.next()) {
+      REQUIRE(doc["seq"] == count);
+      count++;
+    }
+    REQUIRE(count == 10);
+  }
+}
@@ -0,0 +1,24 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_DECODE_UNICODE 1
+#include "helpers.hpp"
+
+TEST_CASE("JsonPushParser matches deserializeJson() for any split") {
+  SECTION("the inputs give the expected errors") {
+    checkErrors(testInputs);
+  }
+
+  SECTION("default nesting limit") {
+    checkAllSplits(testInputs, DeserializationOption::NestingLimit());
+  }
+
+  SECTION("nesting limit 0") {
+    checkAllSplits(testInputs, DeserializationOption::NestingLimit(0));
+  }
+
+  SECTION("nesting limit 1") {
+    checkAllSplits(testInputs, DeserializationOption::NestingLimit(1));
+  }
+}
@@ -0,0 +1,21 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_ENABLE_COMMENTS 1
+#define ARDUINOJSON_DECODE_UNICODE 0
+#include "helpers.hpp"
+
+TEST_CASE("JsonPushParser matches deserializeJson() with comments") {
+  SECTION("the inputs give the expected errors") {
+    checkErrors(commentInputs);
+  }
+
+  SECTION("documents with comments") {
+    checkAllSplits(commentInputs, DeserializationOption::NestingLimit());
+  }
+
+  SECTION("documents without comments") {
+    checkAllSplits(testInputs, DeserializationOption::NestingLimit());
+  }
+}
@@ -0,0 +1,139 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+#include "Allocators.hpp"
+
+using Status = JsonPushParser::Status;
+
+TEST_CASE("JsonPushParser::feed()") {
+  JsonDocument doc;
+  JsonPushParser parser(doc);
+
+  SECTION("returns NeedMore until the object is complete") {
+    REQUIRE(parser.feed("{\"tem") == Status::NeedMore);
+    REQUIRE(parser.feed("p\":2") == Status::NeedMore);
+    REQUIRE(parser.feed("1.5}") == Status::Done);
+    REQUIRE(parser.error() == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"temp\":21.5}");
+  }
+
+  SECTION("empty chunks") {
+    REQUIRE(parser.feed("", 0) == Status::NeedMore);
+    REQUIRE(parser.feed("[]") == Status::Done);
+    REQUIRE(parser.feed("", 0) == Status::Done);
+  }
+
+  SECTION("ignores the bytes after the value") {
+    REQUIRE(parser.feed("[1]garbage") == Status::Done);
+    REQUIRE(parser.feed("{") == Status::Done);
+    REQUIRE(doc.as<std::string>() == "[1]");
+  }
+
+  SECTION("uint8_t buffer") {
+    const uint8_t input[] = {'[', '4', '2', ']'};
+
+    REQUIRE(parser.feed(input, sizeof(input)) == Status::Done);
+    REQUIRE(doc[0] == 42);
+  }
+
+  SECTION("reports errors as soon as possible") {
+    REQUIRE(parser.feed("[1,]") == Status::Error);
+    REQUIRE(parser.error() == DeserializationError::InvalidInput);
+    REQUIRE(parser.feed("[1]") == Status::Error);
+  }
+
+  SECTION("a number needs the next byte or finish()") {
+    REQUIRE(parser.feed("42") == Status::NeedMore);
+    REQUIRE(parser.finish() == Status::Done);
+    REQUIRE(doc.as<int>() == 42);
+  }
+
+  SECTION("a NUL byte ends the input") {
+    REQUIRE(parser.feed("[1", 3) == Status::Error);
+    REQUIRE(parser.error() == DeserializationError::IncompleteInput);
+  }
+
+  SECTION("finish() on an incomplete input") {
+    parser.feed("{\"a\":[1,");
+
+    REQUIRE(parser.finish() == Status::Error);
+    REQUIRE(parser.error() == DeserializationError::IncompleteInput);
+  }
+
+  SECTION("finish() on an empty input") {
+    REQUIRE(parser.finish() == Status::Error);
+    REQUIRE(parser.error() == DeserializationError::EmptyInput);
+  }
+
+  SECTION("status()") {
+    REQUIRE(parser.status() == Status::NeedMore);
+    parser.feed("true");
+    REQUIRE(parser.status() == Status::Done);
+  }
+
+  SECTION("reset()") {
+    parser.feed("[1,2");
+
+    parser.reset();
+
+    REQUIRE(doc.isNull());
+    REQUIRE(parser.feed("{\"a\":1}") == Status::Done);
+    REQUIRE(doc.as<std::string>() == "{\"a\":1}");
+  }
+
+  SECTION("reset() after an error") {
+    parser.feed("]");
+
+    parser.reset();
+
+    REQUIRE(parser.status() == Status::NeedMore);
+    REQUIRE(parser.error() == DeserializationError::Ok);
+    REQUIRE(parser.feed("[]") == Status::Done);
+  }
+}
+
+TEST_CASE("JsonPushParser nesting") {
+  JsonDocument doc;
+
+  SECTION("deep nesting") {
+    JsonPushParser parser(doc, DeserializationOption::NestingLimit(100));
+    std::string input = std::string(100, '[') + std::string(100, ']');
+
+    REQUIRE(parser.feed(input.c_str()) == Status::Done);
+    REQUIRE(doc.nesting() == 100);
+  }
+
+  SECTION("too deep") {
+    JsonPushParser parser(doc, DeserializationOption::NestingLimit(2));
+
+    REQUIRE(parser.feed("[[[]]]") == Status::Error);
+    REQUIRE(parser.error() == DeserializationError::TooDeep);
+  }
+}
+
+TEST_CASE("JsonPushParser memory") {
+  SECTION("NoMemory") {
+    TimebombAllocator timebomb(1);
+    JsonDocument doc(&timebomb);
+    JsonPushParser parser(doc);
+
+    REQUIRE(parser.feed("[\"hello\",\"world\"]") == Status::Error);
+    REQUIRE(parser.error() == DeserializationError::NoMemory);
+  }
+
+  SECTION("releases its stack") {
+    SpyingAllocator spy;
+    {
+      JsonDocument doc(&spy);
+      JsonPushParser parser(doc);
+      parser.feed("[[1]]");
+    }
+    REQUIRE(spy.allocatedBytes() == 0);
+  }
+}
@@ -0,0 +1,89 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+#include "inputs.hpp"
+
+namespace {  // this file is compiled with different configurations
+
+struct ParseResult {
+  DeserializationError error;
+  std::string output;
+
+  bool operator==(const ParseResult& other) const {
+    return error == other.error && output == other.output;
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ParseResult& r) {
+  return os << r.error << " " << r.output;
+}
+
+inline ParseResult resultOf(DeserializationError error,
+                            const JsonDocument& doc) {
+  return {error, doc.as<std::string>()};
+}
+
+inline ParseResult parseAtOnce(const char* input,
+                               DeserializationOption::NestingLimit limit) {
+  JsonDocument doc;
+  auto err = deserializeJson(doc, input, limit);
+  return resultOf(err, doc);
+}
+
+inline ParseResult parseInTwoChunks(const char* input, size_t split,
+                                    DeserializationOption::NestingLimit limit) {
+  JsonDocument doc;
+  JsonPushParser parser(doc, limit);
+  parser.feed(input, split);
+  parser.feed(input + split);
+  parser.finish();
+  return resultOf(parser.error(), doc);
+}
+
+inline ParseResult parseByteByByte(const char* input,
+                                   DeserializationOption::NestingLimit limit) {
+  JsonDocument doc;
+  JsonPushParser parser(doc, limit);
+  for (const char* p = input; *p; p++)
+    parser.feed(p, 1);
+  parser.finish();
+  return resultOf(parser.error(), doc);
+}
+
+// Checks that deserializeJson() returns the expected errors, so that the
+// inputs keep covering what they are meant to
+template <size_t N>
+void checkErrors(const TestInput (&inputs)[N]) {
+  for (auto& test : inputs) {
+    CAPTURE(test.json);
+    REQUIRE(parseAtOnce(test.json, {}).error == test.error);
+  }
+}
+
+// Checks that splitting the input anywhere gives the same result as
+// deserializeJson()
+template <size_t N>
+void checkAllSplits(const TestInput (&inputs)[N],
+                    DeserializationOption::NestingLimit limit) {
+  for (auto& test : inputs) {
+    auto input = test.json;
+    CAPTURE(input);
+    auto expected = parseAtOnce(input, limit);
+    size_t length = strlen(input);
+    for (size_t split = 0; split <= length; split++) {
+      CAPTURE(split);
+      REQUIRE(parseInTwoChunks(input, split, limit) == expected);
+    }
+    REQUIRE(parseByteByByte(input, limit) == expected);
+  }
+}
+
+}  // namespace
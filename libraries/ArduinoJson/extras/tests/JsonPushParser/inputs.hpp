@@ -0,0 +1,127 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+struct TestInput {
+  const char* json;
+  DeserializationError::Code error;  // with the default options
+};
+
+// Real-world documents, then the same kind of documents broken in the ways a
+// network or a careless sender breaks them.
+static const TestInput testInputs[] = {
+    // weather API response
+    {"{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},\"weather\":[{\"id\":803,"
+     "\"main\":\"Clouds\",\"description\":\"broken clouds\",\"icon\":\"04d\"}],"
+     "\"main\":{\"temp\":288.55,\"feels_like\":287.84,\"pressure\":1012,"
+     "\"humidity\":67},\"visibility\":10000,\"wind\":{\"speed\":4.63,"
+     "\"deg\":250},\"dt\":1718352000,\"sys\":{\"country\":\"GB\",\"sunrise\":"
+     "1718336566,\"sunset\":1718396474},\"timezone\":3600,\"name\":\"London\","
+     "\"cod\":200}",
+     DeserializationError::Ok},
+
+    // device configuration, pretty-printed
+    {"{\r\n"
+     "  \"wifi\": {\r\n"
+     "    \"ssid\": \"HomeNetwork\",\r\n"
+     "    \"password\": \"p@ss\\\"word\\\\\",\r\n"
+     "    \"dhcp\": true,\r\n"
+     "    \"ip\": null\r\n"
+     "  },\r\n"
+     "  \"mqtt\": {\"host\": \"broker.local\", \"port\": 1883, \"topics\": "
+     "[\"home/+/temp\", \"home/+/hum\"]},\r\n"
+     "  \"sleep\": 300,\r\n"
+     "  \"calibration\": [0.998, -1.25e-3, 0, -0]\r\n"
+     "}\r\n",
+     DeserializationError::Ok},
+
+    // GeoJSON
+    {"{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\","
+     "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[[102.0,0.0],"
+     "[103.0,1.0],[104.0,0.0],[102.0,0.0]]]},\"properties\":{\"name\":"
+     "\"Z\\u00fcrich \\u2013 Altstadt\",\"emoji\":\"\\ud83c\\udfd4\"}}]}",
+     DeserializationError::Ok},
+
+    // batch of sensor readings
+    {"[{\"t\":1718352000,\"v\":[21.5,48,1013.25]},{\"t\":1718352060,"
+     "\"v\":[21.4,49,1013.2]},{\"t\":1718352120,\"v\":[]},{\"t\":1718352180,"
+     "\"v\":[4294967295,-2147483648,18446744073709551615,"
+     "1.7976931348623157e308,5e-324]}]",
+     DeserializationError::Ok},
+
+    // JSON-RPC request and response
+    {"{\"jsonrpc\":\"2.0\",\"method\":\"set\",\"params\":{\"led\":[true,false,"
+     "true]},\"id\":7}",
+     DeserializationError::Ok},
+    {"{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32601,\"message\":\"Method not "
+     "found\",\"data\":{}},\"id\":null}",
+     DeserializationError::Ok},
+
+    // escapes and control characters
+    {"[\"tab\\there\",\"line\\nbreak\",\"\\/path\\/to\",\"\\b\\f\\r\","
+     "\"quote\\\"\",\"\"]",
+     DeserializationError::Ok},
+
+    // scalars at the root
+    {"\"hello world\"", DeserializationError::Ok},
+    {"-12.5e+3", DeserializationError::Ok},
+    {"true", DeserializationError::Ok},
+    {"null", DeserializationError::Ok},
+    {"[]", DeserializationError::Ok},
+    {"{}", DeserializationError::Ok},
+
+    // lenient syntax that deserializeJson() accepts
+    {"{name:'sensor-1',enabled:true}", DeserializationError::Ok},
+    {"[1] trailing bytes are ignored", DeserializationError::Ok},
+
+    // nested 11 levels deep, one more than the default limit
+    {"[[[[[[[[[[[42]]]]]]]]]]]", DeserializationError::TooDeep},
+    {"{\"a\":{\"b\":{\"c\":{\"d\":{\"e\":{\"f\":{\"g\":{\"h\":{\"i\":{\"j\":{"
+     "\"k\":1}}}}}}}}}}}",
+     DeserializationError::TooDeep},
+
+    // cut by a dropped connection
+    {"{\"coord\":{\"lon\":-0.1257,\"lat\":51.50",
+     DeserializationError::IncompleteInput},
+    {"{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085}",
+     DeserializationError::IncompleteInput},
+    {"[{\"t\":1718352000,\"v\":[21.5,", DeserializationError::IncompleteInput},
+    {"{\"name\":\"Z\\u00f", DeserializationError::IncompleteInput},
+    {"{\"ok\":tr", DeserializationError::IncompleteInput},
+    {"[\"unterminated", DeserializationError::IncompleteInput},
+
+    // malformed
+    {"{\"a\":1,}", DeserializationError::InvalidInput},
+    {"[1,2,]", DeserializationError::InvalidInput},
+    {"{\"a\":1 \"b\":2}", DeserializationError::InvalidInput},
+    {"{\"a\" 1}", DeserializationError::InvalidInput},
+    {"{\"a\"}", DeserializationError::InvalidInput},
+    {"[true false]", DeserializationError::InvalidInput},
+    {"{\"temp\":NaN}", DeserializationError::InvalidInput},
+    {"[-Infinity]", DeserializationError::InvalidInput},
+    {"[0x1F]", DeserializationError::InvalidInput},
+    {"[-]", DeserializationError::InvalidInput},
+    {"{\"ok\":tru3}", DeserializationError::InvalidInput},
+    {"\"bad \\q escape\"", DeserializationError::InvalidInput},
+    {"\"\\u00zz\"", DeserializationError::InvalidInput},
+    {"]", DeserializationError::InvalidInput},
+    {"// comment\n[1]", DeserializationError::InvalidInput},
+
+    // nothing to parse
+    {"", DeserializationError::EmptyInput},
+    {" \t\r\n", DeserializationError::EmptyInput},
+};
+
+// Documents with comments, for ARDUINOJSON_ENABLE_COMMENTS
+static const TestInput commentInputs[] = {
+    {"// settings\n{\"interval\":60, // seconds\n\"retries\":3}",
+     DeserializationError::Ok},
+    {"/* header */ [1, /* inline */ 2, 3] /* footer", DeserializationError::Ok},
+    {"{\"a\":/* x */ 1}", DeserializationError::Ok},
+    {"[1, /* never closed", DeserializationError::IncompleteInput},
+    {"// only a comment", DeserializationError::IncompleteInput},
+    {"[1 / 2]", DeserializationError::InvalidInput},
+    {"/# not a comment #/ 1", DeserializationError::InvalidInput},
+};
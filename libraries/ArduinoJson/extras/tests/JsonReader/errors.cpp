@@ -0,0 +1,55 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+static DeserializationError readAll(const char* input,
+                                    DeserializationOption::NestingLimit limit =
+                                        DeserializationOption::NestingLimit()) {
+  JsonDocument doc;
+  JsonReader<const char*> reader(input, doc, limit);
+  for (;;) {
+    switch (reader.next()) {
+      case JsonEvent::End:
+        return DeserializationError::Ok;
+      case JsonEvent::Error:
+        REQUIRE(reader.next() == JsonEvent::Error);  // sticky
+        return reader.error();
+      default:
+        break;
+    }
+  }
+}
+
+TEST_CASE("JsonReader errors") {
+  SECTION("EmptyInput") {
+    REQUIRE(readAll("") == DeserializationError::EmptyInput);
+    REQUIRE(readAll("  ") == DeserializationError::EmptyInput);
+  }
+
+  SECTION("IncompleteInput") {
+    REQUIRE(readAll("[") == DeserializationError::IncompleteInput);
+    REQUIRE(readAll("[1,") == DeserializationError::IncompleteInput);
+    REQUIRE(readAll("{\"a\"") == DeserializationError::IncompleteInput);
+    REQUIRE(readAll("{\"a\":") == DeserializationError::IncompleteInput);
+    REQUIRE(readAll("{\"a") == DeserializationError::IncompleteInput);
+  }
+
+  SECTION("InvalidInput") {
+    REQUIRE(readAll("[1;2]") == DeserializationError::InvalidInput);
+    REQUIRE(readAll("{\"a\" 1}") == DeserializationError::InvalidInput);
+    REQUIRE(readAll("{\"a\":1]") == DeserializationError::InvalidInput);
+    REQUIRE(readAll("[1}") == DeserializationError::InvalidInput);
+    REQUIRE(readAll("[truth]") == DeserializationError::InvalidInput);
+  }
+
+  SECTION("TooDeep") {
+    DeserializationOption::NestingLimit limit(2);
+    REQUIRE(readAll("[[1]]", limit) == DeserializationError::Ok);
+    REQUIRE(readAll("[[[1]]]", limit) == DeserializationError::TooDeep);
+    REQUIRE(readAll("{\"a\":{\"b\":{}}}", limit) ==
+            DeserializationError::TooDeep);
+  }
+}
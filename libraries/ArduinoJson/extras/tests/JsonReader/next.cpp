@@ -0,0 +1,106 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+#include "CustomReader.hpp"
+
+// Replays all the events as a compact string
+template <typename TInput>
+static std::string replay(JsonReader<TInput>& reader) {
+  std::string result;
+  for (;;) {
+    switch (reader.next()) {
+      case JsonEvent::StartObject:
+        result += "{";
+        break;
+      case JsonEvent::EndObject:
+        result += "}";
+        break;
+      case JsonEvent::StartArray:
+        result += "[";
+        break;
+      case JsonEvent::EndArray:
+        result += "]";
+        break;
+      case JsonEvent::Key:
+        result += reader.key().c_str();
+        result += "=";
+        break;
+      case JsonEvent::Value:
+        result += reader.value().template as<std::string>();
+        result += ";";
+        break;
+      case JsonEvent::End:
+        return result;
+      case JsonEvent::Error:
+        return result + "!" + reader.error().c_str();
+    }
+  }
+}
+
+TEST_CASE("JsonReader::next()") {
+  JsonDocument doc;
+
+  SECTION("scalar") {
+    JsonReader<const char*> reader("42", doc);
+    REQUIRE(replay(reader) == "42;");
+    REQUIRE(reader.next() == JsonEvent::End);
+  }
+
+  SECTION("empty array") {
+    JsonReader<const char*> reader(" [ ] ", doc);
+    REQUIRE(replay(reader) == "[]");
+  }
+
+  SECTION("empty object") {
+    JsonReader<const char*> reader(" { } ", doc);
+    REQUIRE(replay(reader) == "{}");
+  }
+
+  SECTION("array of values") {
+    JsonReader<const char*> reader("[1, \"two\", 3.5, true, null]", doc);
+    REQUIRE(replay(reader) == "[1;two;3.5;true;null;]");
+  }
+
+  SECTION("nested objects") {
+    JsonReader<const char*> reader(
+        "{\"data\":{\"user\":{\"name\":\"Ann\"},\"ids\":[1,[2]]},\"ok\":true}",
+        doc);
+    REQUIRE(replay(reader) == "{data={user={name=Ann;}ids=[1;[2;]]}ok=true;}");
+  }
+
+  SECTION("depth()") {
+    JsonReader<const char*> reader("{\"a\":[1]}", doc);
+    REQUIRE(reader.depth() == 0);
+    REQUIRE(reader.next() == JsonEvent::StartObject);
+    REQUIRE(reader.depth() == 0);
+    REQUIRE(reader.next() == JsonEvent::Key);
+    REQUIRE(reader.depth() == 1);
+    REQUIRE(reader.next() == JsonEvent::StartArray);
+    REQUIRE(reader.next() == JsonEvent::Value);
+    REQUIRE(reader.depth() == 2);
+    REQUIRE(reader.next() == JsonEvent::EndArray);
+    REQUIRE(reader.depth() == 1);
+    REQUIRE(reader.next() == JsonEvent::EndObject);
+    REQUIRE(reader.depth() == 0);
+  }
+
+  SECTION("stops after the root value") {
+    std::istringstream input("[1]{}");
+    JsonReader<std::istream> reader(input, doc);
+    REQUIRE(replay(reader) == "[1;]");
+    REQUIRE(input.get() == '{');
+  }
+
+  SECTION("custom reader") {
+    CustomReader input("{\"a\":[true]}");
+    JsonReader<CustomReader> reader(input, doc);
+    REQUIRE(replay(reader) == "{a=[true;]}");
+  }
+}
@@ -0,0 +1,127 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+
+#include "Allocators.hpp"
+#include "Literals.hpp"
+
+TEST_CASE("JsonReader::read()") {
+  JsonDocument doc;
+
+  SECTION("materializes each element of an array") {
+    JsonReader<const char*> reader(
+        "[{\"id\":1,\"name\":\"Ann\"},{\"id\":2,\"name\":\"Bob\"}]", doc);
+
+    REQUIRE(reader.next() == JsonEvent::StartArray);
+
+    REQUIRE(reader.next() == JsonEvent::StartObject);
+    REQUIRE(reader.read() == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"id\":1,\"name\":\"Ann\"}");
+
+    REQUIRE(reader.next() == JsonEvent::StartObject);
+    REQUIRE(reader.read() == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"id\":2,\"name\":\"Bob\"}");
+
+    REQUIRE(reader.next() == JsonEvent::EndArray);
+    REQUIRE(reader.next() == JsonEvent::End);
+  }
+
+  SECTION("materializes a member") {
+    JsonReader<const char*> reader(
+        "{\"status\":\"ok\",\"data\":{\"card\":{\"balance\":12.5}},\"x\":1}",
+        doc);
+
+    REQUIRE(reader.next() == JsonEvent::StartObject);
+    REQUIRE(reader.next() == JsonEvent::Key);
+    REQUIRE(reader.key() == "status");
+    REQUIRE(reader.next() == JsonEvent::Value);
+    REQUIRE(reader.value() == "ok");
+    REQUIRE(reader.next() == JsonEvent::Key);
+    REQUIRE(reader.key() == "data");
+    REQUIRE(reader.next() == JsonEvent::StartObject);
+    REQUIRE(reader.read() == DeserializationError::Ok);
+    REQUIRE(doc["card"]["balance"] == 12.5);
+    REQUIRE(reader.next() == JsonEvent::Key);
+    REQUIRE(reader.key() == "x");
+  }
+
+  SECTION("applies the filter") {
+    JsonDocument filter;
+    filter["name"] = true;
+    JsonReader<const char*> reader("[{\"id\":1,\"name\":\"Ann\"}]", doc);
+
+    REQUIRE(reader.next() == JsonEvent::StartArray);
+    REQUIRE(reader.next() == JsonEvent::StartObject);
+    REQUIRE(reader.read(DeserializationOption::Filter(filter)) ==
+            DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"name\":\"Ann\"}");
+  }
+
+  SECTION("succeeds after Value") {
+    JsonReader<const char*> reader("[42]", doc);
+
+    REQUIRE(reader.next() == JsonEvent::StartArray);
+    REQUIRE(reader.next() == JsonEvent::Value);
+    REQUIRE(reader.read() == DeserializationError::Ok);
+    REQUIRE(doc.as<int>() == 42);
+  }
+
+  SECTION("fails after Key") {
+    JsonReader<const char*> reader("{\"a\":1}", doc);
+
+    REQUIRE(reader.next() == JsonEvent::StartObject);
+    REQUIRE(reader.next() == JsonEvent::Key);
+    REQUIRE(reader.read() == DeserializationError::InvalidInput);
+    REQUIRE(reader.next() == JsonEvent::Error);
+  }
+}
+
+TEST_CASE("JsonReader::skip()") {
+  JsonDocument doc;
+  JsonReader<const char*> reader(
+      "{\"history\":[[1,2],{\"a\":\"]\"}],\"balance\":7}", doc);
+
+  REQUIRE(reader.next() == JsonEvent::StartObject);
+  REQUIRE(reader.next() == JsonEvent::Key);
+  REQUIRE(reader.next() == JsonEvent::StartArray);
+  REQUIRE(reader.skip() == DeserializationError::Ok);
+  REQUIRE(reader.next() == JsonEvent::Key);
+  REQUIRE(reader.key() == "balance");
+  REQUIRE(reader.next() == JsonEvent::Value);
+  REQUIRE(reader.value() == 7);
+  REQUIRE(reader.next() == JsonEvent::EndObject);
+}
+
+TEST_CASE("JsonReader memory usage") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+
+  std::stringstream input;
+  input << "[";
+  for (int i = 0; i < 1000; i++)
+    input << (i ? "," : "") << "{\"id\":" << i << ",\"name\":\"user" << i
+          << "\"}";
+  input << "]";
+
+  JsonReader<std::istream> reader(input, doc);
+  REQUIRE(reader.next() == JsonEvent::StartArray);
+
+  size_t peak = 0;
+  int count = 0;
+  while (reader.next() == JsonEvent::StartObject) {
+    REQUIRE(reader.read() == DeserializationError::Ok);
+    REQUIRE(doc["id"] == count);
+    if (spy.allocatedBytes() > peak)
+      peak = spy.allocatedBytes();
+    count++;
+  }
+
+  REQUIRE(count == 1000);
+  REQUIRE(reader.error() == DeserializationError::Ok);
+  REQUIRE(peak < sizeofPool() + 2 * sizeofPoolList() + 4 * sizeofStringBuffer());
+}
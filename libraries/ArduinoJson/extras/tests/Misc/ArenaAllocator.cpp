@@ -0,0 +1,176 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include "Allocators.hpp"
+#include "Literals.hpp"
+
+TEST_CASE("ArenaAllocator") {
+  alignas(void*) char buffer[8192];  // must hold a memory pool
+  ArenaAllocator arena(buffer, sizeof(buffer));
+
+  SECTION("capacity()") {
+    REQUIRE(arena.capacity() == sizeof(buffer));
+    REQUIRE(arena.size() == 0);
+    REQUIRE(arena.highWaterMark() == 0);
+  }
+
+  SECTION("allocate() returns aligned, distinct blocks") {
+    auto a = arena.allocate(3);
+    auto b = arena.allocate(5);
+
+    REQUIRE(a != nullptr);
+    REQUIRE(b != nullptr);
+    REQUIRE(a != b);
+    REQUIRE(ArduinoJson::detail::isAligned(a));
+    REQUIRE(ArduinoJson::detail::isAligned(b));
+    REQUIRE(arena.size() > 8);
+  }
+
+  SECTION("allocate() fails when the buffer is full") {
+    REQUIRE(arena.allocate(sizeof(buffer)) == nullptr);
+    REQUIRE(arena.allocate(4000) != nullptr);
+    REQUIRE(arena.allocate(4000) != nullptr);
+    REQUIRE(arena.allocate(4000) == nullptr);
+  }
+
+  SECTION("releasing every block rewinds the arena") {
+    auto a = arena.allocate(100);
+    auto b = arena.allocate(100);
+
+    arena.deallocate(a);
+    REQUIRE(arena.size() > 0);
+
+    arena.deallocate(b);
+    REQUIRE(arena.size() == 0);
+    REQUIRE(arena.allocate(200) == a);
+  }
+
+  SECTION("releasing the last block reclaims it") {
+    auto a = arena.allocate(10);
+    auto sizeAfterA = arena.size();
+    arena.allocate(100);
+    auto c = arena.allocate(100);
+
+    arena.deallocate(c);
+
+    REQUIRE(arena.size() < sizeAfterA + 200);
+    REQUIRE(arena.allocate(100) == c);
+    (void)a;
+  }
+
+  SECTION("blocks released out of order are reclaimed together") {
+    arena.allocate(10);
+    auto sizeAfterA = arena.size();
+    auto b = arena.allocate(100);
+    auto c = arena.allocate(100);
+    auto d = arena.allocate(100);
+    auto sizeAfterD = arena.size();
+
+    arena.deallocate(b);
+    arena.deallocate(c);
+    REQUIRE(arena.size() == sizeAfterD);
+
+    arena.deallocate(d);
+    REQUIRE(arena.size() == sizeAfterA);
+    REQUIRE(arena.allocate(100) == b);
+  }
+
+  SECTION("reallocate() grows the last block in place") {
+    arena.allocate(10);
+    auto b = static_cast<char*>(arena.allocate(10));
+    strcpy(b, "hello");
+
+    auto c = static_cast<char*>(arena.reallocate(b, 100));
+
+    REQUIRE(c == b);
+    REQUIRE(std::string(c) == "hello");
+  }
+
+  SECTION("reallocate() moves other blocks") {
+    auto a = static_cast<char*>(arena.allocate(10));
+    strcpy(a, "hello");
+    arena.allocate(10);
+
+    auto c = static_cast<char*>(arena.reallocate(a, 20));
+
+    REQUIRE(c != a);
+    REQUIRE(std::string(c) == "hello");
+  }
+
+  SECTION("reallocate() fails when the buffer is full") {
+    auto a = arena.allocate(10);
+
+    REQUIRE(arena.reallocate(a, 10000) == nullptr);
+  }
+
+  SECTION("highWaterMark()") {
+    auto a = arena.allocate(100);
+    auto peak = arena.size();
+    arena.deallocate(a);
+
+    REQUIRE(arena.size() == 0);
+    REQUIRE(arena.highWaterMark() == peak);
+
+    arena.resetHighWaterMark();
+    REQUIRE(arena.highWaterMark() == 0);
+  }
+
+  SECTION("JsonDocument") {
+    JsonDocument doc(&arena);
+
+    deserializeJson(doc, "{\"hello\":\"world\",\"answer\":42}");
+    REQUIRE(doc.as<std::string>() == "{\"hello\":\"world\",\"answer\":42}");
+    REQUIRE(arena.size() > 0);
+
+    doc.clear();
+    REQUIRE(arena.size() == 0);
+  }
+
+  SECTION("JsonDocument with retainMemory() keeps a bounded usage") {
+    JsonDocument doc(&arena);
+    doc.retainMemory();
+    size_t sizeAfterFill = 0, sizeAfterClear = 0;
+
+    for (int i = 0; i < 20; i++) {
+      deserializeJson(doc, "{\"first\":\"hello\",\"second\":\"world\"}");
+      doc.remove("first");  // not the last string
+      for (int j = 0; j < 10; j++)
+        doc["key" + std::to_string(j)] = "value" + std::to_string(i);
+      if (i % 2)
+        doc.shrinkToFit();
+      if (i < 2)  // once with shrinkToFit() and once without
+        sizeAfterFill = std::max(sizeAfterFill, arena.size());
+      REQUIRE(arena.size() <= sizeAfterFill);
+
+      doc.clear();
+      if (i < 2)
+        sizeAfterClear = std::max(sizeAfterClear, arena.size());
+      REQUIRE(arena.size() <= sizeAfterClear);
+    }
+    REQUIRE(sizeAfterClear > 0);  // the pool is still there
+    REQUIRE(arena.highWaterMark() <= sizeAfterFill);
+  }
+
+  SECTION("JsonDocument overflows when the buffer is full") {
+    JsonDocument doc(&arena);
+
+    for (int i = 0; i < 1000; i++)
+      doc.add("abcdefghijklmnopqrstuvwxyz"_s);
+
+    REQUIRE(doc.overflowed());
+  }
+
+  SECTION("unaligned buffer") {
+    ArenaAllocator arena2(buffer + 1, sizeof(buffer) - 1);
+
+    REQUIRE(arena2.capacity() == sizeof(buffer) - sizeof(void*));
+    REQUIRE(ArduinoJson::detail::isAligned(arena2.allocate(1)));
+  }
+}
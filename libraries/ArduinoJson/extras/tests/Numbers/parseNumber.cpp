@@ -61,3 +61,29 @@ TEST_CASE("double") {
 
   REQUIRE(result.type() == NumberType::Double);
 }
+
+TEST_CASE("Integers longer than 8 digits") {
+  // avoids MSVC warning C4127 (conditional expression is constant)
+  size_t integerSize = sizeof(JsonInteger);
+
+  REQUIRE(parseNumber("12345678").asUnsignedInteger() == 12345678);
+  REQUIRE(parseNumber("123456789").asUnsignedInteger() == 123456789);
+  REQUIRE(parseNumber("-87654321").asSignedInteger() == -87654321);
+
+  if (integerSize == 8) {
+    REQUIRE(parseNumber("1234567890123456").asUnsignedInteger() ==
+            1234567890123456);
+    REQUIRE(parseNumber("9999999999999999999").asUnsignedInteger() ==
+            9999999999999999999U);
+    REQUIRE(parseNumber("00000000000000000001").asUnsignedInteger() == 1);
+  }
+}
+
+TEST_CASE("Exact float conversion") {
+  // values that need a single rounding must be bit-exact
+  REQUIRE(parseNumber("0.1").asFloat() == 0.1f);
+  REQUIRE(parseNumber("1.2e-3").asFloat() == 1.2e-3f);
+  REQUIRE(parseNumber("1234.567891").asDouble() == 1234.567891);
+  REQUIRE(parseNumber("0.000123456789").asDouble() == 0.000123456789);
+  REQUIRE(parseNumber("123456789.012345").asDouble() == 123456789.012345);
+}
@@ -0,0 +1,697 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Deserialization/deserialize.hpp>
+#include <ArduinoJson/Memory/ResourceManager.hpp>
+#include <ArduinoJson/Memory/StringBuffer.hpp>
+#include <ArduinoJson/MsgPack/endianness.hpp>
+#include <ArduinoJson/MsgPack/ieee754.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Variant/VariantData.hpp>
+
+#include <string.h>  // memcpy
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+inline float halfToFloat(uint16_t half) {
+  auto sign = uint32_t(half & 0x8000) << 16;
+  auto exponent = uint32_t(half >> 10) & 0x1F;
+  auto mantissa = uint32_t(half & 0x3FF);
+
+  if (exponent == 0) {  // zero or subnormal
+    float value = float(mantissa) * 5.9604644775390625e-8f;  // 2^-24
+    return sign ? -value : value;
+  }
+
+  uint32_t bits;
+  if (exponent == 0x1F)  // infinity or NaN
+    bits = sign | 0x7F800000 | (mantissa << 13);
+  else
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// https://www.rfc-editor.org/rfc/rfc8949
+// Tags are ignored, undefined and simple values become null, byte strings
+// are stored as raw strings (with their header, so they can be serialized
+// back), and map keys must be text strings.
+template <typename TReader>
+class CborDeserializer {
+ public:
+  CborDeserializer(ResourceManager* resources, TReader reader)
+      : resources_(resources),
+        reader_(reader),
+        stringBuffer_(resources),
+        foundSomething_(false) {}
+
+  template <typename TFilter>
+  DeserializationError parse(VariantData& variant, TFilter filter,
+                             DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+    uint8_t code;
+    err = readByte(code);
+    if (!err)
+      err = parseVariant(code, &variant, filter, nestingLimit);
+    return foundSomething_ ? err : DeserializationError::EmptyInput;
+  }
+
+ private:
+  static const uint8_t breakCode = 0xFF;
+
+  template <typename TFilter>
+  DeserializationError::Code parseVariant(
+      uint8_t code, VariantData* variant, TFilter filter,
+      DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+    uint8_t header[9];
+    uint64_t argument;
+
+    foundSomething_ = true;
+
+    while ((code >> 5) == 6) {  // tag
+      err = readArgument(code, header + 1, argument);
+      if (err)
+        return err;
+      err = readByte(code);
+      if (err)
+        return err;
+    }
+
+    bool allowValue = filter.allowValue();
+
+    if (allowValue) {
+      // callers pass a null pointer only when value must be ignored
+      ARDUINOJSON_ASSERT(variant != 0);
+    }
+
+    uint8_t majorType = uint8_t(code >> 5);
+
+    if (majorType == 7)
+      return parseSimpleValue(code, allowValue ? variant : 0);
+
+    if ((code & 0x1F) == 31) {  // indefinite length
+      switch (majorType) {
+        case 2:  // byte string
+          if (allowValue)
+            return readChunkedRawString(variant, code);
+          else
+            return skipChunks(code);
+
+        case 3:  // text string
+          if (allowValue)
+            return readChunkedString(variant, code);
+          else
+            return skipChunks(code);
+
+        case 4:
+          return readArray(variant, 0, true, filter, nestingLimit);
+
+        case 5:
+          return readObject(variant, 0, true, filter, nestingLimit);
+
+        default:
+          return DeserializationError::InvalidInput;
+      }
+    }
+
+    err = readArgument(code, header + 1, argument);
+    if (err)
+      return err;
+
+    switch (majorType) {
+      case 0:  // unsigned integer
+        if (allowValue)
+          return setUnsignedInteger(variant, argument);
+        return DeserializationError::Ok;
+
+      case 1:  // negative integer
+        if (allowValue)
+          return setNegativeInteger(variant, argument);
+        return DeserializationError::Ok;
+    }
+
+    auto size = size_t(argument);
+    if (size < argument)                      // integer overflow
+      return DeserializationError::NoMemory;  // (not testable on 64-bit)
+
+    switch (majorType) {
+      case 2:  // byte string
+        header[0] = code;
+        if (allowValue)
+          return readRawString(variant, header,
+                               uint8_t(1 + argumentSize(code)), size);
+        else
+          return skipBytes(size);
+
+      case 3:  // text string
+        if (allowValue)
+          return readString(variant, size);
+        else
+          return skipBytes(size);
+
+      case 4:
+        return readArray(variant, size, false, filter, nestingLimit);
+
+      default:
+        return readObject(variant, size, false, filter, nestingLimit);
+    }
+  }
+
+  DeserializationError::Code parseSimpleValue(uint8_t code,
+                                              VariantData* variant) {
+    switch (code & 0x1F) {
+      case 20:  // false
+      case 21:  // true
+        if (variant)
+          variant->setBoolean(code == 0xF5);
+        return DeserializationError::Ok;
+
+      case 24:  // simple value in the next byte
+        return skipBytes(1);
+
+      case 25:
+        if (variant)
+          return readHalf(variant);
+        else
+          return skipBytes(2);
+
+      case 26:
+        if (variant)
+          return readFloat<float>(variant);
+        else
+          return skipBytes(4);
+
+      case 27:
+        if (variant)
+          return readDouble<double>(variant);
+        else
+          return skipBytes(8);
+
+      case 28:
+      case 29:
+      case 30:
+      case 31:  // "break" outside of an indefinite-length item
+        return DeserializationError::InvalidInput;
+
+      default:  // null, undefined, and unassigned simple values
+        return DeserializationError::Ok;
+    }
+  }
+
+  static uint8_t argumentSize(uint8_t code) {
+    uint8_t info = code & 0x1F;
+    return info < 24 ? 0 : uint8_t(1U << (info - 24));
+  }
+
+  // Reads the argument that follows the initial byte.
+  // The big-endian bytes are also copied to the buffer.
+  DeserializationError::Code readArgument(uint8_t code, uint8_t* buffer,
+                                          uint64_t& value) {
+    uint8_t info = code & 0x1F;
+    if (info < 24) {
+      value = info;
+      return DeserializationError::Ok;
+    }
+    if (info > 27)
+      return DeserializationError::InvalidInput;
+
+    uint8_t size = argumentSize(code);
+    auto err = readBytes(buffer, size);
+    if (err)
+      return err;
+
+    value = 0;
+    for (uint8_t i = 0; i < size; i++)
+      value = (value << 8) | buffer[i];
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code readByte(uint8_t& value) {
+    int c = reader_.read();
+    if (c < 0)
+      return DeserializationError::IncompleteInput;
+    value = static_cast<uint8_t>(c);
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code readBytes(void* p, size_t n) {
+    if (reader_.readBytes(reinterpret_cast<char*>(p), n) == n)
+      return DeserializationError::Ok;
+    return DeserializationError::IncompleteInput;
+  }
+
+  template <typename T>
+  DeserializationError::Code readBytes(T& value) {
+    return readBytes(&value, sizeof(value));
+  }
+
+  DeserializationError::Code skipBytes(size_t n) {
+    for (; n; --n) {
+      if (reader_.read() < 0)
+        return DeserializationError::IncompleteInput;
+    }
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code setUnsignedInteger(VariantData* variant,
+                                                uint64_t value) {
+    auto truncatedValue = static_cast<JsonUInt>(value);
+    if (truncatedValue == value) {
+      if (!variant->setInteger(truncatedValue, resources_))
+        return DeserializationError::NoMemory;
+    }
+    // else set null on overflow
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code setNegativeInteger(VariantData* variant,
+                                                uint64_t n) {
+    if (n > 0x7FFFFFFFFFFFFFFFU)
+      return DeserializationError::Ok;  // set null on overflow
+
+    auto value = -1 - static_cast<int64_t>(n);
+    auto truncatedValue = static_cast<JsonInteger>(value);
+    if (truncatedValue == value) {
+      if (!variant->setInteger(truncatedValue, resources_))
+        return DeserializationError::NoMemory;
+    }
+    // else set null on overflow
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code readHalf(VariantData* variant) {
+    DeserializationError::Code err;
+    uint16_t value;
+
+    err = readBytes(value);
+    if (err)
+      return err;
+
+    fixEndianness(value);
+    variant->setFloat(halfToFloat(value), resources_);
+
+    return DeserializationError::Ok;
+  }
+
+  template <typename T>
+  enable_if_t<sizeof(T) == 4, DeserializationError::Code> readFloat(
+      VariantData* variant) {
+    DeserializationError::Code err;
+    T value;
+
+    err = readBytes(value);
+    if (err)
+      return err;
+
+    fixEndianness(value);
+    variant->setFloat(value, resources_);
+
+    return DeserializationError::Ok;
+  }
+
+  template <typename T>
+  enable_if_t<sizeof(T) == 8, DeserializationError::Code> readDouble(
+      VariantData* variant) {
+    DeserializationError::Code err;
+    T value;
+
+    err = readBytes(value);
+    if (err)
+      return err;
+
+    fixEndianness(value);
+    if (variant->setFloat(value, resources_))
+      return DeserializationError::Ok;
+    else
+      return DeserializationError::NoMemory;
+  }
+
+  template <typename T>
+  enable_if_t<sizeof(T) == 4, DeserializationError::Code> readDouble(
+      VariantData* variant) {
+    DeserializationError::Code err;
+    uint8_t i[8];  // input is 8 bytes
+    T value;       // output is 4 bytes
+    uint8_t* o = reinterpret_cast<uint8_t*>(&value);
+
+    err = readBytes(i, 8);
+    if (err)
+      return err;
+
+    doubleToFloat(i, o);
+    fixEndianness(value);
+    variant->setFloat(value, resources_);
+
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code readString(VariantData* variant, size_t n) {
+    DeserializationError::Code err;
+
+    err = readString(n);
+    if (err)
+      return err;
+
+    variant->setOwnedString(stringBuffer_.save());
+    return DeserializationError::Ok;
+  }
+
+  // Reads an indefinite-length text string
+  DeserializationError::Code readChunkedString(VariantData* variant,
+                                               uint8_t code) {
+    DeserializationError::Code err;
+
+    err = readChunks(code, false);
+    if (err)
+      return err;
+
+    variant->setOwnedString(stringBuffer_.save());
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code readString(size_t n) {
+    char* p = stringBuffer_.reserve(n);
+    if (!p)
+      return DeserializationError::NoMemory;
+
+    return readBytes(p, n);
+  }
+
+  DeserializationError::Code readRawString(VariantData* variant,
+                                           const void* header,
+                                           uint8_t headerSize, size_t n) {
+    auto totalSize = size_t(headerSize + n);
+    if (totalSize < n)                        // integer overflow
+      return DeserializationError::NoMemory;  // (not testable on 64-bit)
+
+    char* p = stringBuffer_.reserve(totalSize);
+    if (!p)
+      return DeserializationError::NoMemory;
+
+    memcpy(p, header, headerSize);
+
+    auto err = readBytes(p + headerSize, n);
+    if (err)
+      return err;
+
+    variant->setRawString(stringBuffer_.save());
+    return DeserializationError::Ok;
+  }
+
+  // Reads an indefinite-length byte string, keeping the chunk headers so the
+  // raw string remains valid CBOR
+  DeserializationError::Code readChunkedRawString(VariantData* variant,
+                                                  uint8_t code) {
+    DeserializationError::Code err;
+
+    err = readChunks(code, true);
+    if (err)
+      return err;
+
+    variant->setRawString(stringBuffer_.save());
+    return DeserializationError::Ok;
+  }
+
+  // Concatenates the chunks of an indefinite-length string in stringBuffer_
+  DeserializationError::Code readChunks(uint8_t code, bool keepHeaders) {
+    DeserializationError::Code err;
+    uint8_t header[9];
+    uint64_t argument;
+
+    if (!stringBuffer_.reserve(0))
+      return DeserializationError::NoMemory;
+
+    if (keepHeaders && !appendByte(code))
+      return DeserializationError::NoMemory;
+
+    for (;;) {
+      err = readByte(header[0]);
+      if (err)
+        return err;
+
+      if (header[0] == breakCode)
+        break;
+
+      // chunks must be definite-length strings of the same type
+      if ((header[0] & 0xE0) != (code & 0xE0) || (header[0] & 0x1F) == 31)
+        return DeserializationError::InvalidInput;
+
+      err = readArgument(header[0], header + 1, argument);
+      if (err)
+        return err;
+
+      auto size = size_t(argument);
+      if (size < argument)                      // integer overflow
+        return DeserializationError::NoMemory;  // (not testable on 64-bit)
+
+      if (keepHeaders) {
+        auto headerSize = size_t(1 + argumentSize(header[0]));
+        char* p = stringBuffer_.extend(headerSize);
+        if (!p)
+          return DeserializationError::NoMemory;
+        memcpy(p, header, headerSize);
+      }
+
+      char* p = stringBuffer_.extend(size);
+      if (!p)
+        return DeserializationError::NoMemory;
+
+      err = readBytes(p, size);
+      if (err)
+        return err;
+    }
+
+    if (keepHeaders && !appendByte(breakCode))
+      return DeserializationError::NoMemory;
+
+    return DeserializationError::Ok;
+  }
+
+  bool appendByte(uint8_t c) {
+    char* p = stringBuffer_.extend(1);
+    if (!p)
+      return false;
+    *p = static_cast<char>(c);
+    return true;
+  }
+
+  DeserializationError::Code skipChunks(uint8_t code) {
+    DeserializationError::Code err;
+    uint8_t header[9];
+    uint64_t argument;
+
+    for (;;) {
+      err = readByte(header[0]);
+      if (err)
+        return err;
+
+      if (header[0] == breakCode)
+        return DeserializationError::Ok;
+
+      if ((header[0] & 0xE0) != (code & 0xE0) || (header[0] & 0x1F) == 31)
+        return DeserializationError::InvalidInput;
+
+      err = readArgument(header[0], header + 1, argument);
+      if (err)
+        return err;
+
+      auto size = size_t(argument);
+      if (size < argument)                      // integer overflow
+        return DeserializationError::NoMemory;  // (not testable on 64-bit)
+
+      err = skipBytes(size);
+      if (err)
+        return err;
+    }
+  }
+
+  // Reads the initial byte of the next item of a container.
+  // Sets done after the last item, or after the "break" that terminates an
+  // indefinite-length container.
+  DeserializationError::Code readItemHeader(uint8_t& code, bool indefinite,
+                                            size_t& remaining, bool& done) {
+    if (!indefinite) {
+      done = remaining == 0;
+      if (done)
+        return DeserializationError::Ok;
+      remaining--;
+    }
+
+    auto err = readByte(code);
+    if (err)
+      return err;
+
+    done = indefinite && code == breakCode;
+    return DeserializationError::Ok;
+  }
+
+  template <typename TFilter>
+  DeserializationError::Code readArray(
+      VariantData* variant, size_t n, bool indefinite, TFilter filter,
+      DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    bool allowArray = filter.allowArray();
+
+    ArrayData* array;
+    if (allowArray) {
+      ARDUINOJSON_ASSERT(variant != 0);
+      array = &variant->toArray();
+    } else {
+      array = 0;
+    }
+
+    TFilter elementFilter = filter[0U];
+
+    for (;;) {
+      uint8_t code;
+      bool done;
+
+      err = readItemHeader(code, indefinite, n, done);
+      if (err)
+        return err;
+      if (done)
+        break;
+
+      VariantData* value;
+
+      if (elementFilter.allow()) {
+        ARDUINOJSON_ASSERT(array != 0);
+        value = array->addElement(resources_);
+        if (!value)
+          return DeserializationError::NoMemory;
+      } else {
+        value = 0;
+      }
+
+      err = parseVariant(code, value, elementFilter, nestingLimit.decrement());
+      if (err)
+        return err;
+    }
+
+    return DeserializationError::Ok;
+  }
+
+  template <typename TFilter>
+  DeserializationError::Code readObject(
+      VariantData* variant, size_t n, bool indefinite, TFilter filter,
+      DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    ObjectData* object;
+    if (filter.allowObject()) {
+      ARDUINOJSON_ASSERT(variant != 0);
+      object = &variant->toObject();
+    } else {
+      object = 0;
+    }
+
+    for (;;) {
+      uint8_t code;
+      bool done;
+
+      err = readItemHeader(code, indefinite, n, done);
+      if (err)
+        return err;
+      if (done)
+        break;
+
+      err = readKey(code);
+      if (err)
+        return err;
+
+      JsonString key = stringBuffer_.str();
+      TFilter memberFilter = filter[key.c_str()];
+      VariantData* member;
+
+      if (memberFilter.allow()) {
+        ARDUINOJSON_ASSERT(object != 0);
+
+        // Save key in memory pool.
+        auto savedKey = stringBuffer_.save();
+
+        member = object->addMember(savedKey, resources_);
+        if (!member)
+          return DeserializationError::NoMemory;
+      } else {
+        member = 0;
+      }
+
+      err = readByte(code);
+      if (err)
+        return err;
+
+      err = parseVariant(code, member, memberFilter, nestingLimit.decrement());
+      if (err)
+        return err;
+    }
+
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code readKey(uint8_t code) {
+    DeserializationError::Code err;
+    uint8_t buffer[8];
+    uint64_t size;
+
+    if ((code & 0xE0) != 0x60)  // not a text string
+      return DeserializationError::InvalidInput;
+
+    if ((code & 0x1F) == 31)
+      return readChunks(code, false);
+
+    err = readArgument(code, buffer, size);
+    if (err)
+      return err;
+
+    if (size_t(size) < size)                  // integer overflow
+      return DeserializationError::NoMemory;  // (not testable on 64-bit)
+
+    return readString(size_t(size));
+  }
+
+  ResourceManager* resources_;
+  TReader reader_;
+  StringBuffer stringBuffer_;
+  bool foundSomething_;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Parses a CBOR input and puts the result in a JsonDocument.
+template <typename TDestination, typename... Args,
+          detail::enable_if_t<
+              detail::is_deserialize_destination<TDestination>::value, int> = 0>
+inline DeserializationError deserializeCbor(TDestination&& dst,
+                                            Args&&... args) {
+  using namespace detail;
+  return deserialize<CborDeserializer>(detail::forward<TDestination>(dst),
+                                       detail::forward<Args>(args)...);
+}
+
+// Parses a CBOR input and puts the result in a JsonDocument.
+template <typename TDestination, typename TChar, typename... Args,
+          detail::enable_if_t<
+              detail::is_deserialize_destination<TDestination>::value, int> = 0>
+inline DeserializationError deserializeCbor(TDestination&& dst, TChar* input,
+                                            Args&&... args) {
+  using namespace detail;
+  return deserialize<CborDeserializer>(detail::forward<TDestination>(dst),
+                                       input, detail::forward<Args>(args)...);
+}
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -96,6 +96,8 @@ class CollectionData {
     return head_;
   }
 
+  void relocateSlots(const ResourceManager* resources, SlotCount liveSlots);
+
  protected:
   void appendOne(Slot<VariantData> slot, const ResourceManager* resources);
   void appendPair(Slot<VariantData> key, Slot<VariantData> value,
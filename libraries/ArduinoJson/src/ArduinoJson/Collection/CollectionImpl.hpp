@@ -70,6 +70,18 @@ inline void CollectionData::clear(ResourceManager* resources) {
   tail_ = NULL_SLOT;
 }
 
+inline void CollectionData::relocateSlots(const ResourceManager* resources,
+                                          SlotCount liveSlots) {
+  head_ = resources->relocatedSlot(head_, liveSlots);
+  tail_ = resources->relocatedSlot(tail_, liveSlots);
+  for (auto id = head_; id != NULL_SLOT;) {
+    auto slot = resources->getVariant(id);
+    slot->setNext(resources->relocatedSlot(slot->next(), liveSlots));
+    slot->relocateSlots(resources, liveSlots);
+    id = slot->next();
+  }
+}
+
 inline Slot<VariantData> CollectionData::getPreviousSlot(
     VariantData* target, const ResourceManager* resources) const {
   auto prev = Slot<VariantData>();
@@ -238,6 +238,15 @@
 #  define ARDUINOJSON_NEGATIVE_EXPONENTIATION_THRESHOLD 1e-5
 #endif
 
+// Use SSE2 to skip the strings rejected by the filter
+#ifndef ARDUINOJSON_USE_SSE2
+#  if defined(__SSE2__)
+#    define ARDUINOJSON_USE_SSE2 1
+#  else
+#    define ARDUINOJSON_USE_SSE2 0
+#  endif
+#endif
+
 #ifndef ARDUINOJSON_LITTLE_ENDIAN
 #  if defined(_MSC_VER) ||                           \
       (defined(__BYTE_ORDER__) &&                    \
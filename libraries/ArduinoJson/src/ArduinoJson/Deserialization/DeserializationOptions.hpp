@@ -6,6 +6,7 @@
 
 #include <ArduinoJson/Deserialization/Filter.hpp>
 #include <ArduinoJson/Deserialization/NestingLimit.hpp>
+#include <ArduinoJson/Deserialization/PathFilter.hpp>
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
@@ -27,6 +28,21 @@ inline DeserializationOptions<TFilter> makeDeserializationOptions(
   return {filter, nestingLimit};
 }
 
+// PathFilter is large, so we only pass a cursor to its root
+template <size_t N>
+inline DeserializationOptions<PathFilterCursor> makeDeserializationOptions(
+    const DeserializationOption::PathFilter<N>& filter,
+    DeserializationOption::NestingLimit nestingLimit = {}) {
+  return {filter.root(), nestingLimit};
+}
+
+template <size_t N>
+inline DeserializationOptions<PathFilterCursor> makeDeserializationOptions(
+    DeserializationOption::NestingLimit nestingLimit,
+    const DeserializationOption::PathFilter<N>& filter) {
+  return {filter.root(), nestingLimit};
+}
+
 inline DeserializationOptions<AllowAllFilter> makeDeserializationOptions(
     DeserializationOption::NestingLimit nestingLimit = {}) {
   return {{}, nestingLimit};
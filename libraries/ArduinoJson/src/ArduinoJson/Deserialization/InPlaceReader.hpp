@@ -0,0 +1,96 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/StringBuilder.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Reads a mutable buffer that the deserializer is allowed to overwrite
+class InPlaceReader {
+ public:
+  // end == nullptr means the input stops at the first '\0'
+  InPlaceReader(char* begin, char* end) : ptr_(begin), end_(end) {}
+
+  int read() {
+    if (ptr_ == end_)
+      return -1;
+    return static_cast<unsigned char>(*ptr_++);
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t i = 0;
+    while (i < length && ptr_ != end_)
+      buffer[i++] = *ptr_++;
+    return i;
+  }
+
+  // Returns the address of the next character to read
+  char* position() const {
+    return ptr_;
+  }
+
+  // Returns nullptr if the input stops at the first '\0'
+  char* end() const {
+    return end_;
+  }
+
+  void seek(char* ptr) {
+    ptr_ = ptr;
+  }
+
+ private:
+  char* ptr_;
+  char* end_;
+};
+
+// Writes the unescaped strings over the input.
+// This is safe because a string can only get shorter when unescaped, so the
+// writer never catches up with the reader.
+class InPlaceStringBuilder {
+ public:
+  InPlaceStringBuilder(ResourceManager*) {}
+
+  // dest is the address of the opening quote, or of the first character if
+  // the key is not quoted
+  void startString(char* dest) {
+    dest_ = dest;
+    size_ = 0;
+  }
+
+  // Returns a static string, which makes the variant store the pointer
+  RamString save() {
+    dest_[size_] = 0;
+    return RamString(dest_, size_, true);
+  }
+
+  void append(char c) {
+    dest_[size_++] = c;
+  }
+
+  bool isValid() const {
+    return true;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  JsonString str() const {
+    dest_[size_] = 0;
+    return JsonString(dest_, size_);
+  }
+
+ private:
+  char* dest_ = nullptr;
+  size_t size_ = 0;
+};
+
+template <>
+struct StringBuilderFor<InPlaceReader> {
+  using type = InPlaceStringBuilder;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
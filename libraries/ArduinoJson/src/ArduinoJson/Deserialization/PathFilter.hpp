@@ -0,0 +1,194 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Strings/StringAdapters.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+struct PathFilterNode {
+  static const uint8_t none = 0xFF;
+
+  const char* key;
+  uint8_t keyLength;
+  uint8_t firstChild;
+  uint8_t nextSibling;
+  bool leaf;  // allows everything below this node
+
+  RamString adaptedKey() const {
+    return RamString(key, keyLength);
+  }
+
+  bool isWildcard() const {
+    return keyLength == 1 && key[0] == '*';
+  }
+};
+
+// A position in the trie of a PathFilter, passed down by the deserializers
+class PathFilterCursor {
+ public:
+  PathFilterCursor(const PathFilterNode* nodes, uint8_t index)
+      : nodes_(nodes), index_(index) {}
+
+  bool allow() const {
+    return index_ != PathFilterNode::none;
+  }
+
+  bool allowArray() const {
+    return allow() && (node().leaf || findWildcard() != PathFilterNode::none);
+  }
+
+  bool allowObject() const {
+    return allow() && (node().leaf || node().firstChild != PathFilterNode::none);
+  }
+
+  bool allowValue() const {
+    return allow() && node().leaf;
+  }
+
+  template <typename TKey, enable_if_t<!is_integral<TKey>::value, int> = 0>
+  PathFilterCursor operator[](const TKey& key) const {
+    if (!allow() || node().leaf)
+      return *this;
+    auto adaptedKey = adaptString(key);
+    uint8_t wildcard = PathFilterNode::none;
+    for (uint8_t i = node().firstChild; i != PathFilterNode::none;
+         i = nodes_[i].nextSibling) {
+      if (stringEquals(nodes_[i].adaptedKey(), adaptedKey))
+        return PathFilterCursor(nodes_, i);
+      if (nodes_[i].isWildcard())
+        wildcard = i;
+    }
+    return PathFilterCursor(nodes_, wildcard);
+  }
+
+  template <typename TIndex, enable_if_t<is_integral<TIndex>::value, int> = 0>
+  PathFilterCursor operator[](TIndex) const {
+    if (!allow() || node().leaf)
+      return *this;
+    return PathFilterCursor(nodes_, findWildcard());
+  }
+
+ private:
+  const PathFilterNode& node() const {
+    return nodes_[index_];
+  }
+
+  uint8_t findWildcard() const {
+    for (uint8_t i = node().firstChild; i != PathFilterNode::none;
+         i = nodes_[i].nextSibling) {
+      if (nodes_[i].isWildcard())
+        return i;
+    }
+    return PathFilterNode::none;
+  }
+
+  const PathFilterNode* nodes_;
+  uint8_t index_;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+namespace DeserializationOption {
+
+// A filter built once from a list of paths, like "data.card.balance".
+// Segments are separated by dots, and "*" matches any member or element.
+// The paths are not copied, so they must outlive the filter.
+template <size_t N = 16>
+class PathFilter {
+  static_assert(N > 0 && N < detail::PathFilterNode::none,
+                "PathFilter capacity must be between 1 and 254");
+
+ public:
+  PathFilter() : count_(1), overflowed_(false) {
+    nodes_[0] = {"", 0, detail::PathFilterNode::none,
+                 detail::PathFilterNode::none, false};
+  }
+
+  template <size_t M>
+  explicit PathFilter(const char* const (&paths)[M]) : PathFilter() {
+    for (size_t i = 0; i < M; i++)
+      add(paths[i]);
+  }
+
+  // Adds a path to the filter.
+  // Returns false if the capacity is exhausted, leaving the filter unchanged.
+  bool add(const char* path) {
+    uint8_t firstNew = count_;
+    uint8_t index = 0;
+    while (*path) {
+      if (nodes_[index].leaf)
+        return true;  // already allowed
+
+      const char* end = path;
+      while (*end && *end != '.')
+        end++;
+      size_t length = size_t(end - path);
+      if (length > 255)
+        return fail(firstNew);
+
+      index = findOrAddChild(index, path, uint8_t(length));
+      if (index == detail::PathFilterNode::none)
+        return fail(firstNew);
+
+      path = *end ? end + 1 : end;
+    }
+    nodes_[index].leaf = true;
+    return true;
+  }
+
+  // Returns true if a call to add() failed
+  bool overflowed() const {
+    return overflowed_;
+  }
+
+  detail::PathFilterCursor root() const {
+    return detail::PathFilterCursor(nodes_, 0);
+  }
+
+ private:
+  uint8_t findOrAddChild(uint8_t parent, const char* key, uint8_t length) {
+    detail::RamString adaptedKey(key, length);
+    uint8_t* link = &nodes_[parent].firstChild;
+    while (*link != detail::PathFilterNode::none) {
+      if (stringEquals(nodes_[*link].adaptedKey(), adaptedKey))
+        return *link;
+      link = &nodes_[*link].nextSibling;
+    }
+    if (count_ >= N)
+      return detail::PathFilterNode::none;
+    nodes_[count_] = {key, length, detail::PathFilterNode::none,
+                      detail::PathFilterNode::none, false};
+    *link = count_;
+    return count_++;
+  }
+
+  // Removes the nodes added by the failed call, otherwise the prefix of the
+  // path would still let objects through
+  bool fail(uint8_t firstNew) {
+    for (uint8_t i = 0; i < firstNew; i++) {
+      if (nodes_[i].firstChild != detail::PathFilterNode::none &&
+          nodes_[i].firstChild >= firstNew)
+        nodes_[i].firstChild = detail::PathFilterNode::none;
+      if (nodes_[i].nextSibling != detail::PathFilterNode::none &&
+          nodes_[i].nextSibling >= firstNew)
+        nodes_[i].nextSibling = detail::PathFilterNode::none;
+    }
+    count_ = firstNew;
+    overflowed_ = true;
+    return false;
+  }
+
+  detail::PathFilterNode nodes_[N];
+  uint8_t count_;
+  bool overflowed_;
+};
+
+}  // namespace DeserializationOption
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -35,6 +35,19 @@ struct Reader<TSource*, enable_if_t<IsCharOrVoid<TSource>::value>> {
       buffer[i] = *ptr_++;
     return length;
   }
+
+  // Direct access to the input, see SkipScanner
+  const char* position() const {
+    return ptr_;
+  }
+
+  const char* end() const {
+    return nullptr;  // stops at the first '\0'
+  }
+
+  void seek(const char* ptr) {
+    ptr_ = ptr;
+  }
 };
 
 template <typename TSource>
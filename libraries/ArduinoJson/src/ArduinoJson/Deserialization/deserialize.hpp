@@ -36,7 +36,8 @@ inline void shrinkJsonDocument(TDestination&) {
 
 #if ARDUINOJSON_AUTO_SHRINK
 inline void shrinkJsonDocument(JsonDocument& doc) {
-  doc.shrinkToFit();
+  if (!VariantAttorney::getResourceManager(doc)->retainsMemory())
+    doc.shrinkToFit();
 }
 #endif
 
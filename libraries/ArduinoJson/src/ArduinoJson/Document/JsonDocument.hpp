@@ -70,6 +70,21 @@ class JsonDocument : public detail::VariantOperators<const JsonDocument&> {
     resources_.shrinkToFit();
   }
 
+  // Moves the values into the fewest memory pools and releases the empty
+  // pools, undoing the fragmentation caused by repeated modifications.
+  // Invalidates the existing JsonVariant, JsonArray, and JsonObject.
+  // Returns false if there wasn't enough memory for the temporary bitmap.
+  bool garbageCollect() {
+    return resources_.garbageCollect(&data_);
+  }
+
+  // Keeps the memory pools when the document is cleared, so that the next
+  // values (for example, the next call to deserializeJson()) reuse them
+  // instead of allocating new ones. Strings are still released.
+  void retainMemory(bool value = true) {
+    resources_.retainMemory(value);
+  }
+
   // Casts the root to the specified type.
   // https://arduinojson.org/v7/api/jsondocument/as/
   template <typename T>
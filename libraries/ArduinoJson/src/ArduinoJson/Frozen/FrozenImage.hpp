@@ -0,0 +1,109 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Strings/Adapters/RamString.hpp>
+
+#include <stdint.h>
+#include <string.h>  // memcpy
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// The layout of the image produced by freezeJson():
+//
+//   header:  magic (4 bytes) | total size (uint32)
+//   node:    type (1 byte) | payload
+//
+// Payloads:
+//   Int, Uint, Float:  int64_t, uint64_t, double
+//   ShortString:       length (uint8) | characters | '\0'
+//   String:            length (uint32) | characters | '\0'
+//   Array:             count (uint32) | count x element offset (uint32)
+//   Object:            count (uint32) | count x (key offset, value offset)
+//
+// The offsets are relative to the beginning of the image, so the image can be
+// moved anywhere (flash, file, another RAM buffer). The children of a
+// container follow its offset table. Object members are sorted by key.
+// Multi-byte values use the native byte order and no alignment.
+namespace FrozenImage {
+const uint8_t magic[4] = {0xA7, 'J', 'F', 1};
+const uint32_t headerSize = 8;
+const uint32_t rootOffset = headerSize;
+const uint32_t maxShortString = 0xFF;
+
+enum class Type : uint8_t {
+  Null,
+  False,
+  True,
+  Int,
+  Uint,
+  Float,
+  ShortString,
+  String,
+  Array,
+  Object,
+};
+
+template <typename T>
+inline T read(const uint8_t* image, uint32_t offset) {
+  T value;
+  memcpy(&value, image + offset, sizeof(T));
+  return value;
+}
+
+template <typename T>
+inline void write(uint8_t* image, uint32_t offset, T value) {
+  memcpy(image + offset, &value, sizeof(T));
+}
+
+// Returns true if the node at the specified offset lies within the image, so
+// that it can be read without further checks. The offsets of the children are
+// checked when they are followed.
+inline bool isValidNode(const uint8_t* image, uint32_t size, uint32_t offset) {
+  if (offset < rootOffset || offset >= size)
+    return false;
+  uint32_t available = size - offset - 1;  // after the type
+  switch (Type(image[offset])) {
+    case Type::Null:
+    case Type::False:
+    case Type::True:
+      return true;
+    case Type::Int:
+    case Type::Uint:
+    case Type::Float:
+      return available >= 8;
+    case Type::ShortString:
+      return available >= 1 && available - 1u > image[offset + 1];
+    case Type::String:
+      return available >= 4 &&
+             available - 4 > read<uint32_t>(image, offset + 1);
+    case Type::Array:
+      return available >= 4 &&
+             (available - 4) / 4 >= read<uint32_t>(image, offset + 1);
+    case Type::Object:
+      return available >= 4 &&
+             (available - 4) / 8 >= read<uint32_t>(image, offset + 1);
+    default:
+      return false;
+  }
+}
+
+// Returns the string stored at the specified offset, or a null string if the
+// node is not a string
+inline RamString readString(const uint8_t* image, uint32_t offset) {
+  switch (Type(image[offset])) {
+    case Type::ShortString:
+      return RamString(reinterpret_cast<const char*>(image + offset + 2),
+                       image[offset + 1]);
+    case Type::String:
+      return RamString(reinterpret_cast<const char*>(image + offset + 5),
+                       read<uint32_t>(image, offset + 1));
+    default:
+      return RamString(nullptr, 0);
+  }
+}
+}  // namespace FrozenImage
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
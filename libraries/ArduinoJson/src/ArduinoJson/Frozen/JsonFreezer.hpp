@@ -0,0 +1,218 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Frozen/FrozenImage.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Variant/JsonVariantConst.hpp>
+#include <ArduinoJson/Variant/VariantData.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Writes the image described in FrozenImage.hpp.
+// Each visit() writes a node and returns its offset. Nothing is written past
+// the capacity, but the size keeps growing, so a null buffer measures the
+// image.
+class JsonFreezer : public VariantDataVisitor<uint32_t> {
+ public:
+  JsonFreezer(uint8_t* buffer, size_t capacity,
+              const ResourceManager* resources)
+      : buffer_(buffer),
+        capacity_(capacity),
+        size_(FrozenImage::headerSize),
+        resources_(resources) {}
+
+  // Writes the image and returns its size
+  size_t freeze(const VariantData* root) {
+    VariantData::accept(root, resources_, *this);
+    if (fits(0, FrozenImage::headerSize)) {
+      memcpy(buffer_, FrozenImage::magic, sizeof(FrozenImage::magic));
+      FrozenImage::write(buffer_, 4, uint32_t(size_));
+    }
+    return size_;
+  }
+
+  uint32_t visit(const ArrayData& array) {
+    size_t count = array.size(resources_);
+    uint32_t node = writeHeader(FrozenImage::Type::Array, count, 4);
+
+    uint32_t entry = node + 5;
+    for (auto slotId = array.head(); slotId != NULL_SLOT;) {
+      auto slot = resources_->getVariant(slotId);
+      writeEntry(entry, slot->accept(*this, resources_));
+      entry += 4;
+      slotId = slot->next();
+    }
+
+    return node;
+  }
+
+  uint32_t visit(const ObjectData& object) {
+    size_t count = object.size(resources_);
+    uint32_t node = writeHeader(FrozenImage::Type::Object, count, 8);
+
+    uint32_t entry = node + 5;
+    for (auto slotId = object.head(); slotId != NULL_SLOT;) {
+      auto key = resources_->getVariant(slotId);
+      auto value = resources_->getVariant(key->next());
+      writeEntry(entry, key->accept(*this, resources_));
+      writeEntry(entry + 4, value->accept(*this, resources_));
+      entry += 8;
+      slotId = value->next();
+    }
+
+    // the keys are written, we can sort the table
+    if (fits(0, size_))
+      sortMembers(node + 5, count);
+
+    return node;
+  }
+
+  uint32_t visit(const char* value) {
+    return visit(JsonString(value));
+  }
+
+  uint32_t visit(JsonString value) {
+    return writeString(value.c_str(), value.size());
+  }
+
+  uint32_t visit(RawString value) {
+    return writeString(value.data(), value.size());
+  }
+
+  uint32_t visit(JsonInteger value) {
+    return writeNumber(FrozenImage::Type::Int, int64_t(value));
+  }
+
+  uint32_t visit(JsonUInt value) {
+    return writeNumber(FrozenImage::Type::Uint, uint64_t(value));
+  }
+
+  template <typename T>
+  enable_if_t<is_floating_point<T>::value, uint32_t> visit(T value) {
+    return writeNumber(FrozenImage::Type::Float, double(value));
+  }
+
+  uint32_t visit(bool value) {
+    return writeType(value ? FrozenImage::Type::True : FrozenImage::Type::False);
+  }
+
+  uint32_t visit(nullptr_t) {
+    return writeType(FrozenImage::Type::Null);
+  }
+
+ private:
+  bool fits(size_t offset, size_t n) const {
+    return buffer_ && offset + n <= capacity_;
+  }
+
+  // Reserves n bytes and returns their offset
+  uint32_t reserve(size_t n) {
+    uint32_t offset = uint32_t(size_);
+    size_ += n;
+    return offset;
+  }
+
+  uint32_t writeType(FrozenImage::Type type) {
+    uint32_t node = reserve(1);
+    if (fits(node, 1))
+      buffer_[node] = uint8_t(type);
+    return node;
+  }
+
+  template <typename T>
+  uint32_t writeNumber(FrozenImage::Type type, T value) {
+    uint32_t node = writeType(type);
+    uint32_t payload = reserve(sizeof(T));
+    if (fits(payload, sizeof(T)))
+      FrozenImage::write(buffer_, payload, value);
+    return node;
+  }
+
+  uint32_t writeString(const char* s, size_t n) {
+    uint32_t node;
+    if (n <= FrozenImage::maxShortString) {
+      node = writeType(FrozenImage::Type::ShortString);
+      uint32_t length = reserve(1);
+      if (fits(length, 1))
+        buffer_[length] = uint8_t(n);
+    } else {
+      node = writeType(FrozenImage::Type::String);
+      uint32_t length = reserve(4);
+      if (fits(length, 4))
+        FrozenImage::write(buffer_, length, uint32_t(n));
+    }
+    uint32_t chars = reserve(n + 1);
+    if (fits(chars, n + 1)) {
+      memcpy(buffer_ + chars, s, n);
+      buffer_[chars + n] = 0;
+    }
+    return node;
+  }
+
+  // Writes the type and the count, and reserves the table
+  uint32_t writeHeader(FrozenImage::Type type, size_t count, size_t entrySize) {
+    uint32_t node = writeType(type);
+    uint32_t payload = reserve(4 + count * entrySize);
+    if (fits(payload, 4))
+      FrozenImage::write(buffer_, payload, uint32_t(count));
+    return node;
+  }
+
+  void writeEntry(uint32_t entry, uint32_t offset) {
+    if (fits(entry, 4))
+      FrozenImage::write(buffer_, entry, offset);
+  }
+
+  RamString keyAt(uint32_t table, size_t index) const {
+    return FrozenImage::readString(
+        buffer_, FrozenImage::read<uint32_t>(buffer_, uint32_t(table + index * 8)));
+  }
+
+  // Insertion sort: objects are usually small, and mostly sorted already
+  void sortMembers(uint32_t table, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+      uint8_t member[8];
+      memcpy(member, buffer_ + table + i * 8, 8);
+      RamString key = keyAt(table, i);
+      size_t j = i;
+      while (j > 0 && stringCompare(keyAt(table, j - 1), key) > 0) {
+        memcpy(buffer_ + table + j * 8, buffer_ + table + (j - 1) * 8, 8);
+        j--;
+      }
+      memcpy(buffer_ + table + j * 8, member, 8);
+    }
+  }
+
+  uint8_t* buffer_;
+  size_t capacity_;
+  size_t size_;
+  const ResourceManager* resources_;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Writes a compact, read-only image of source that JsonFrozenVariant can
+// query in place.
+// Returns the size of the image, or 0 if the buffer is too small.
+inline size_t freezeJson(JsonVariantConst source, void* buffer,
+                         size_t capacity) {
+  using namespace detail;
+  JsonFreezer freezer(reinterpret_cast<uint8_t*>(buffer), capacity,
+                      VariantAttorney::getResourceManager(source));
+  size_t size = freezer.freeze(VariantAttorney::getData(source));
+  return size <= capacity ? size : 0;
+}
+
+// Computes the size of the image that freezeJson() produces.
+inline size_t measureFrozenJson(JsonVariantConst source) {
+  using namespace detail;
+  JsonFreezer freezer(nullptr, 0, VariantAttorney::getResourceManager(source));
+  return freezer.freeze(VariantAttorney::getData(source));
+}
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -0,0 +1,265 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Array/JsonArrayConst.hpp>
+#include <ArduinoJson/Frozen/FrozenImage.hpp>
+#include <ArduinoJson/Numbers/convertNumber.hpp>
+#include <ArduinoJson/Object/JsonObjectConst.hpp>
+#include <ArduinoJson/Strings/JsonString.hpp>
+#include <ArduinoJson/Strings/StringAdapters.hpp>
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// A read-only reference to a value in an image produced by freezeJson().
+// The image is never modified, so any number of threads can read it
+// concurrently. Keys are found by binary search, and iterating an object with
+// keyAt()/valueAt() visits its members in key order.
+class JsonFrozenVariant {
+  using Type = detail::FrozenImage::Type;
+
+ public:
+  // Creates an unbound reference.
+  JsonFrozenVariant() : image_(nullptr), size_(0), node_(0) {}
+
+  // Creates a reference to the root of the image.
+  // The reference is unbound if the image is not valid or if its header says
+  // it's larger than capacity.
+  explicit JsonFrozenVariant(const void* image, size_t capacity = size_t(-1))
+      : JsonFrozenVariant() {
+    using namespace detail;
+    auto bytes = reinterpret_cast<const uint8_t*>(image);
+    if (!bytes || capacity < FrozenImage::headerSize ||
+        memcmp(bytes, FrozenImage::magic, sizeof(FrozenImage::magic)) != 0)
+      return;
+    uint32_t size = FrozenImage::read<uint32_t>(bytes, 4);
+    if (size > capacity ||
+        !FrozenImage::isValidNode(bytes, size, FrozenImage::rootOffset))
+      return;
+    image_ = bytes;
+    size_ = size;
+    node_ = FrozenImage::rootOffset;
+  }
+
+  // Returns true if the reference is unbound or the value is null.
+  bool isNull() const {
+    return !node_ || type() == Type::Null;
+  }
+
+  // Returns the number of elements or members, or 0 for other types.
+  size_t size() const {
+    if (type() != Type::Array && type() != Type::Object)
+      return 0;
+    return read<uint32_t>(node_ + 1);
+  }
+
+  // Gets the array's element at the specified index.
+  template <typename T,
+            detail::enable_if_t<detail::is_integral<T>::value, int> = 0>
+  JsonFrozenVariant operator[](T index) const {
+    if (type() != Type::Array || size_t(index) >= size())
+      return JsonFrozenVariant();
+    return child(read<uint32_t>(entry(size_t(index), 4)));
+  }
+
+  // Gets the object's member with the specified key.
+  template <typename TString,
+            detail::enable_if_t<detail::IsString<TString>::value, int> = 0>
+  JsonFrozenVariant operator[](const TString& key) const {
+    return getMember(detail::adaptString(key));
+  }
+
+  // Gets the object's member with the specified key.
+  template <typename TChar,
+            detail::enable_if_t<detail::IsString<TChar*>::value &&
+                                    !detail::is_const<TChar>::value,
+                                int> = 0>
+  JsonFrozenVariant operator[](TChar* key) const {
+    return getMember(detail::adaptString(key));
+  }
+
+  // Returns the key of the object's member at the specified index.
+  JsonString keyAt(size_t index) const {
+    if (type() != Type::Object || index >= size())
+      return JsonString();
+    return stringAt(read<uint32_t>(entry(index, 8)));
+  }
+
+  // Returns the value of the object's member at the specified index.
+  JsonFrozenVariant valueAt(size_t index) const {
+    if (type() != Type::Object || index >= size())
+      return JsonFrozenVariant();
+    return child(read<uint32_t>(entry(index, 8) + 4));
+  }
+
+  // Returns true if the value is of the specified type.
+  template <typename T>
+  detail::enable_if_t<detail::is_same<T, bool>::value, bool> is() const {
+    return type() == Type::True || type() == Type::False;
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_integral<T>::value &&
+                          !detail::is_same<T, bool>::value,
+                      bool>
+  is() const {
+    switch (type()) {
+      case Type::Int:
+        return detail::canConvertNumber<T>(read<int64_t>(node_ + 1));
+      case Type::Uint:
+        return detail::canConvertNumber<T>(read<uint64_t>(node_ + 1));
+      default:
+        return false;
+    }
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_floating_point<T>::value, bool> is() const {
+    return type() == Type::Int || type() == Type::Uint ||
+           type() == Type::Float;
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_same<T, const char*>::value ||
+                          detail::is_same<T, JsonString>::value,
+                      bool>
+  is() const {
+    return type() == Type::ShortString || type() == Type::String;
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_same<T, JsonArrayConst>::value, bool> is()
+      const {
+    return type() == Type::Array;
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_same<T, JsonObjectConst>::value, bool> is()
+      const {
+    return type() == Type::Object;
+  }
+
+  // Returns the value converted to the specified type.
+  template <typename T>
+  detail::enable_if_t<detail::is_same<T, bool>::value, bool> as() const {
+    switch (type()) {
+      case Type::Null:
+      case Type::False:
+        return false;
+      case Type::Int:
+      case Type::Uint:
+        return read<uint64_t>(node_ + 1) != 0;
+      case Type::Float:
+        return read<double>(node_ + 1) != 0;
+      default:
+        return true;
+    }
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_integral<T>::value &&
+                          !detail::is_same<T, bool>::value,
+                      T>
+  as() const {
+    switch (type()) {
+      case Type::True:
+        return 1;
+      case Type::Int:
+        return detail::convertNumber<T>(read<int64_t>(node_ + 1));
+      case Type::Uint:
+        return detail::convertNumber<T>(read<uint64_t>(node_ + 1));
+      case Type::Float:
+        return detail::convertNumber<T>(read<double>(node_ + 1));
+      default:
+        return 0;
+    }
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_floating_point<T>::value, T> as() const {
+    switch (type()) {
+      case Type::True:
+        return 1;
+      case Type::Int:
+        return static_cast<T>(read<int64_t>(node_ + 1));
+      case Type::Uint:
+        return static_cast<T>(read<uint64_t>(node_ + 1));
+      case Type::Float:
+        return static_cast<T>(read<double>(node_ + 1));
+      default:
+        return 0;
+    }
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_same<T, const char*>::value, T> as() const {
+    return node_ ? stringAt(node_).c_str() : nullptr;
+  }
+
+  template <typename T>
+  detail::enable_if_t<detail::is_same<T, JsonString>::value, T> as() const {
+    return node_ ? stringAt(node_) : JsonString();
+  }
+
+ private:
+  JsonFrozenVariant(const uint8_t* image, uint32_t size, uint32_t node)
+      : image_(image), size_(size), node_(node) {}
+
+  Type type() const {
+    return node_ ? Type(image_[node_]) : Type::Null;
+  }
+
+  template <typename T>
+  T read(uint32_t offset) const {
+    return detail::FrozenImage::read<T>(image_, offset);
+  }
+
+  // Returns the offset of the entry at the specified index in the table
+  uint32_t entry(size_t index, uint32_t entrySize) const {
+    return uint32_t(node_ + 5 + index * entrySize);
+  }
+
+  JsonFrozenVariant child(uint32_t offset) const {
+    if (!detail::FrozenImage::isValidNode(image_, size_, offset))
+      return JsonFrozenVariant();
+    return JsonFrozenVariant(image_, size_, offset);
+  }
+
+  JsonString stringAt(uint32_t offset) const {
+    if (!detail::FrozenImage::isValidNode(image_, size_, offset))
+      return JsonString();
+    auto s = detail::FrozenImage::readString(image_, offset);
+    return JsonString(s.data(), s.size(), true);
+  }
+
+  template <typename TAdaptedString>
+  JsonFrozenVariant getMember(TAdaptedString key) const {
+    if (type() != Type::Object || key.isNull())
+      return JsonFrozenVariant();
+    size_t low = 0, high = size();
+    while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      uint32_t keyOffset = read<uint32_t>(entry(middle, 8));
+      JsonString candidate = stringAt(keyOffset);
+      if (candidate.isNull())
+        return JsonFrozenVariant();
+      int cmp = detail::stringCompare(
+          detail::RamString(candidate.c_str(), candidate.size()), key);
+      if (cmp == 0)
+        return child(read<uint32_t>(entry(middle, 8) + 4));
+      if (cmp < 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+    return JsonFrozenVariant();
+  }
+
+  const uint8_t* image_;
+  uint32_t size_;
+  uint32_t node_;  // 0 means unbound
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -0,0 +1,436 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Json/JsonReader.hpp>
+#include <ArduinoJson/Json/TextFormatter.hpp>
+#include <ArduinoJson/Serialization/measure.hpp>
+#include <ArduinoJson/Serialization/serialize.hpp>
+
+#include <string.h>  // memcmp, memcpy
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// A dotted path, like "data.card.balance", seen as a list of segments
+class BindingPath {
+ public:
+  BindingPath(const char* path) : path_(path) {}
+
+  // Returns the number of segments
+  uint8_t depth() const {
+    if (!*path_)
+      return 0;
+    uint8_t n = 1;
+    for (const char* p = path_; *p; p++) {
+      if (*p == '.')
+        n++;
+    }
+    return n;
+  }
+
+  // Returns the segment at the specified index, or an empty string if the
+  // path is too short
+  RamString segment(uint8_t index) const {
+    const char* begin = path_;
+    for (; index > 0; index--) {
+      while (*begin && *begin != '.')
+        begin++;
+      if (!*begin)
+        return RamString("", 0);
+      begin++;
+    }
+    const char* end = begin;
+    while (*end && *end != '.')
+      end++;
+    return RamString(begin, size_t(end - begin));
+  }
+
+  // Returns true if the first n segments are the same in both paths
+  bool sharesPrefix(BindingPath other, uint8_t n) const {
+    size_t length = prefixLength(n);
+    return length == other.prefixLength(n) &&
+           memcmp(path_, other.path_, length) == 0;
+  }
+
+ private:
+  size_t prefixLength(uint8_t n) const {
+    const char* p = path_;
+    for (; n > 0 && *p; p++) {
+      if (p[1] == '.' || p[1] == 0)
+        n--;
+    }
+    return size_t(p - path_);
+  }
+
+  const char* path_;
+};
+
+template <typename T>
+void readBoundValue(T& dst, JsonVariantConst src) {
+  dst = src.as<T>();
+}
+
+template <size_t N>
+void readBoundValue(char (&dst)[N], JsonVariantConst src) {
+  JsonString s = src.as<JsonString>();
+  size_t n = s.size() < N - 1 ? s.size() : N - 1;
+  if (n)
+    memcpy(dst, s.c_str(), n);
+  dst[n] = 0;
+}
+
+template <typename TWriter>
+void writeBoundValue(TextFormatter<TWriter>& formatter, bool value) {
+  formatter.writeBoolean(value);
+}
+
+template <typename TWriter, typename T>
+enable_if_t<is_integral<T>::value && !is_same<T, bool>::value> writeBoundValue(
+    TextFormatter<TWriter>& formatter, T value) {
+  formatter.writeInteger(value);
+}
+
+template <typename TWriter, typename T>
+enable_if_t<is_floating_point<T>::value> writeBoundValue(
+    TextFormatter<TWriter>& formatter, T value) {
+  formatter.writeFloat(value);
+}
+
+template <typename TWriter, size_t N>
+void writeBoundValue(TextFormatter<TWriter>& formatter, const char (&value)[N]) {
+  size_t n = 0;
+  while (n < N && value[n])
+    n++;
+  formatter.writeString(value, n);
+}
+
+template <typename TWriter, typename T>
+enable_if_t<IsString<T>::value && !is_array<T>::value> writeBoundValue(
+    TextFormatter<TWriter>& formatter, const T& value) {
+  auto s = adaptString(value);
+  if (s.isNull()) {
+    formatter.writeRaw("null");
+    return;
+  }
+  formatter.writeRaw('"');
+  for (size_t i = 0; i < s.size(); i++)
+    formatter.writeChar(s[i]);
+  formatter.writeRaw('"');
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Associates a JSON path, like "data.card.balance", to a member of TStruct
+template <typename TStruct, typename TMember>
+class JsonField {
+  static_assert(!detail::is_pointer<TMember>::value,
+                "a bound member can't be a pointer: it would dangle; use a "
+                "char array or a string class instead");
+
+ public:
+  constexpr JsonField(const char* path, TMember TStruct::*member)
+      : path_(path), member_(member) {}
+
+  const char* path() const {
+    return path_;
+  }
+
+  void read(TStruct& dst, JsonVariantConst value) const {
+    detail::readBoundValue(dst.*member_, value);
+  }
+
+  template <typename TWriter>
+  void write(const TStruct& src,
+             detail::TextFormatter<TWriter>& formatter) const {
+    detail::writeBoundValue(formatter, src.*member_);
+  }
+
+ private:
+  const char* path_;
+  TMember TStruct::*member_;
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// A heterogeneous list of JsonFields, accessed by index
+template <typename TStruct, typename... TMembers>
+class BoundFieldList;
+
+template <typename TStruct>
+class BoundFieldList<TStruct> {
+ public:
+  constexpr BoundFieldList() {}
+
+  const char* path(size_t) const {
+    return "";
+  }
+
+  void read(size_t, TStruct&, JsonVariantConst) const {}
+
+  template <typename TWriter>
+  void write(size_t, const TStruct&, TextFormatter<TWriter>&) const {}
+};
+
+template <typename TStruct, typename TFirst, typename... TRest>
+class BoundFieldList<TStruct, TFirst, TRest...> {
+ public:
+  constexpr BoundFieldList(JsonField<TStruct, TFirst> first,
+                           JsonField<TStruct, TRest>... rest)
+      : first_(first), rest_(rest...) {}
+
+  const char* path(size_t index) const {
+    return index == 0 ? first_.path() : rest_.path(index - 1);
+  }
+
+  void read(size_t index, TStruct& dst, JsonVariantConst value) const {
+    if (index == 0)
+      first_.read(dst, value);
+    else
+      rest_.read(index - 1, dst, value);
+  }
+
+  template <typename TWriter>
+  void write(size_t index, const TStruct& src,
+             TextFormatter<TWriter>& formatter) const {
+    if (index == 0)
+      first_.write(src, formatter);
+    else
+      rest_.write(index - 1, src, formatter);
+  }
+
+ private:
+  JsonField<TStruct, TFirst> first_;
+  BoundFieldList<TStruct, TRest...> rest_;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Maps the members of TStruct to JSON paths.
+// deserialize() reads the input with a JsonReader and writes the values
+// straight into the struct: no tree is built, and the branches that contain
+// no bound path are skipped. The keys and the string values still go through
+// the string buffer of a temporary JsonDocument, so deserialize() allocates
+// one string at a time, but no memory pool. serialize() writes the members as
+// nested objects.
+// Paths can't go through arrays, and are limited to 8 levels.
+template <typename TStruct, typename... TMembers>
+class JsonBinding {
+  static_assert(sizeof...(TMembers) <= 32,
+                "JsonBinding supports up to 32 fields");
+
+  using mask_type = uint32_t;
+  static const uint8_t maxDepth = 8;
+
+ public:
+  constexpr JsonBinding(JsonField<TStruct, TMembers>... fields)
+      : fields_(fields...) {}
+
+  // Parses a JSON object and stores the bound values in dst.
+  // The members whose path is missing from the input are left unchanged.
+  template <typename TInput>
+  DeserializationError deserialize(
+      TStruct& dst, TInput&& input,
+      DeserializationOption::NestingLimit nestingLimit = {}) const {
+    return deserialize(dst, detail::forward<TInput>(input),
+                       detail::DefaultAllocator::instance(), nestingLimit);
+  }
+
+  // Same as above, but the temporary strings are allocated with allocator
+  template <typename TInput>
+  DeserializationError deserialize(
+      TStruct& dst, TInput&& input, Allocator* allocator,
+      DeserializationOption::NestingLimit nestingLimit = {}) const {
+    JsonDocument doc(allocator);  // holds one value, and one string, at a time
+    JsonReader<detail::decay_t<TInput>> reader(detail::forward<TInput>(input),
+                                               doc, nestingLimit);
+    mask_type candidates[maxDepth];  // the fields that match each level
+
+    auto event = reader.next();
+    if (event == JsonEvent::Error)
+      return reader.error();
+    if (event != JsonEvent::StartObject)
+      return DeserializationError::InvalidInput;
+    candidates[0] = allFields();
+
+    for (;;) {
+      event = reader.next();
+      switch (event) {
+        case JsonEvent::Key: {
+          uint8_t depth = reader.depth();  // 1 for the members of the root
+          mask_type matches =
+              match(candidates[depth - 1], uint8_t(depth - 1), reader.key());
+
+          event = reader.next();
+          if (event == JsonEvent::Value) {
+            store(dst, matches, depth, reader.value());
+          } else if (event == JsonEvent::StartObject &&
+                     hasDeeperPath(matches, depth) && depth < maxDepth) {
+            candidates[depth] = matches;
+          } else if (event == JsonEvent::StartObject ||
+                     event == JsonEvent::StartArray) {
+            reader.skip();
+          }
+          if (event == JsonEvent::Error || reader.error())
+            return reader.error();
+          break;
+        }
+
+        case JsonEvent::EndObject:
+          if (reader.depth() == 0)
+            return DeserializationError::Ok;
+          break;
+
+        case JsonEvent::Error:
+          return reader.error();
+
+        default:
+          return DeserializationError::InvalidInput;
+      }
+    }
+  }
+
+  // Writes the bound members as JSON
+  template <
+      typename TDestination,
+      detail::enable_if_t<!detail::is_pointer<TDestination>::value, int> = 0>
+  size_t serialize(const TStruct& src, TDestination& destination) const {
+    detail::Writer<TDestination> writer(destination);
+    return doSerialize(src, writer);
+  }
+
+  // Writes the bound members as JSON
+  size_t serialize(const TStruct& src, void* buffer, size_t bufferSize) const {
+    detail::StaticStringWriter writer(reinterpret_cast<char*>(buffer),
+                                      bufferSize);
+    size_t n = doSerialize(src, writer);
+    // add null-terminator for text output (not counted in the size)
+    if (n < bufferSize)
+      reinterpret_cast<char*>(buffer)[n] = 0;
+    return n;
+  }
+
+  // Computes the length of the JSON that serialize() produces
+  size_t measure(const TStruct& src) const {
+    detail::DummyWriter writer;
+    return doSerialize(src, writer);
+  }
+
+ private:
+  static constexpr size_t fieldCount() {
+    return sizeof...(TMembers);
+  }
+
+  static mask_type allFields() {
+    return fieldCount() == 32 ? ~mask_type(0)
+                              : mask_type((mask_type(1) << fieldCount()) - 1);
+  }
+
+  detail::BindingPath path(size_t index) const {
+    return detail::BindingPath(fields_.path(index));
+  }
+
+  // Returns the candidates whose segment at the specified depth is the key
+  mask_type match(mask_type candidates, uint8_t depth, JsonString key) const {
+    mask_type matches = 0;
+    detail::RamString adaptedKey(key.c_str(), key.size());
+    for (size_t i = 0; i < fieldCount(); i++) {
+      if ((candidates >> i) & 1) {
+        if (detail::stringEquals(path(i).segment(depth), adaptedKey))
+          matches |= mask_type(1) << i;
+      }
+    }
+    return matches;
+  }
+
+  bool hasDeeperPath(mask_type matches, uint8_t depth) const {
+    for (size_t i = 0; i < fieldCount(); i++) {
+      if (((matches >> i) & 1) && path(i).depth() > depth)
+        return true;
+    }
+    return false;
+  }
+
+  void store(TStruct& dst, mask_type matches, uint8_t depth,
+             JsonVariantConst value) const {
+    for (size_t i = 0; i < fieldCount(); i++) {
+      if (((matches >> i) & 1) && path(i).depth() == depth)
+        fields_.read(i, dst, value);
+    }
+  }
+
+  template <typename TWriter>
+  size_t doSerialize(const TStruct& src, TWriter writer) const {
+    detail::TextFormatter<TWriter> formatter(writer);
+    writeObject(src, formatter, 0, 0);
+    return formatter.bytesWritten();
+  }
+
+  // Writes the object that contains the fields whose first `depth` segments
+  // are the same as the ones of the field `parent`
+  template <typename TWriter>
+  void writeObject(const TStruct& src,
+                   detail::TextFormatter<TWriter>& formatter, size_t parent,
+                   uint8_t depth) const {
+    formatter.writeRaw('{');
+    bool first = true;
+    for (size_t i = 0; i < fieldCount(); i++) {
+      auto fieldPath = path(i);
+      if (!fieldPath.sharesPrefix(path(parent), depth))
+        continue;
+      if (fieldPath.depth() <= depth)
+        continue;
+      if (isDuplicate(i, depth))
+        continue;
+
+      if (!first)
+        formatter.writeRaw(',');
+      first = false;
+
+      auto key = fieldPath.segment(depth);
+      formatter.writeString(key.data(), key.size());
+      formatter.writeRaw(':');
+
+      if (fieldPath.depth() == depth + 1)
+        fields_.write(i, src, formatter);
+      else
+        writeObject(src, formatter, i, uint8_t(depth + 1));
+    }
+    formatter.writeRaw('}');
+  }
+
+  // Returns true if a previous field already wrote this member
+  bool isDuplicate(size_t index, uint8_t depth) const {
+    for (size_t i = 0; i < index; i++) {
+      if (path(i).depth() > depth &&
+          path(i).sharesPrefix(path(index), uint8_t(depth + 1)))
+        return true;
+    }
+    return false;
+  }
+
+  detail::BoundFieldList<TStruct, TMembers...> fields_;
+};
+
+// Creates a JsonField
+template <typename TStruct, typename TMember>
+constexpr JsonField<TStruct, TMember> jsonField(const char* path,
+                                                TMember TStruct::*member) {
+  return JsonField<TStruct, TMember>(path, member);
+}
+
+// Creates a JsonBinding from a list of JsonFields
+template <typename TStruct, typename... TMembers>
+constexpr JsonBinding<TStruct, TMembers...> bindJson(
+    JsonField<TStruct, TMembers>... fields) {
+  return JsonBinding<TStruct, TMembers...>(fields...);
+}
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <ArduinoJson/Deserialization/InPlaceReader.hpp>
 #include <ArduinoJson/Deserialization/deserialize.hpp>
+#include <ArduinoJson/Json/CharacterClasses.hpp>
 #include <ArduinoJson/Json/EscapeSequence.hpp>
 #include <ArduinoJson/Json/Latch.hpp>
+#include <ArduinoJson/Json/SkipScanner.hpp>
 #include <ArduinoJson/Json/Utf16.hpp>
 #include <ArduinoJson/Json/Utf8.hpp>
 #include <ArduinoJson/Memory/ResourceManager.hpp>
@@ -18,8 +21,54 @@
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
+inline uint8_t decodeHex(char c) {
+  if (c < 'A')
+    return uint8_t(c - '0');
+  c = char(c & ~0x20);  // uppercase
+  return uint8_t(c - 'A' + 10);
+}
+
+// Parses the number in s and stores it in result
+inline DeserializationError::Code setNumericValue(VariantData& result,
+                                                  const char* s,
+                                                  ResourceManager* resources) {
+  auto number = parseNumber(s);
+  switch (number.type()) {
+    case NumberType::UnsignedInteger:
+      if (result.setInteger(number.asUnsignedInteger(), resources))
+        return DeserializationError::Ok;
+      else
+        return DeserializationError::NoMemory;
+
+    case NumberType::SignedInteger:
+      if (result.setInteger(number.asSignedInteger(), resources))
+        return DeserializationError::Ok;
+      else
+        return DeserializationError::NoMemory;
+
+    case NumberType::Float:
+      if (result.setFloat(number.asFloat(), resources))
+        return DeserializationError::Ok;
+      else
+        return DeserializationError::NoMemory;
+
+#if ARDUINOJSON_USE_DOUBLE
+    case NumberType::Double:
+      if (result.setFloat(number.asDouble(), resources))
+        return DeserializationError::Ok;
+      else
+        return DeserializationError::NoMemory;
+#endif
+
+    default:
+      return DeserializationError::InvalidInput;
+  }
+}
+
 template <typename TReader>
 class JsonDeserializer {
+  using string_builder = typename StringBuilderFor<TReader>::type;
+
  public:
   JsonDeserializer(ResourceManager* resources, TReader reader)
       : stringBuilder_(resources),
@@ -42,7 +91,7 @@ class JsonDeserializer {
     return err;
   }
 
- private:
+ protected:
   char current() {
     return latch_.current();
   }
@@ -201,8 +250,6 @@ class JsonDeserializer {
 
   DeserializationError::Code skipArray(
       DeserializationOption::NestingLimit nestingLimit) {
-    DeserializationError::Code err;
-
     if (nestingLimit.reached())
       return DeserializationError::TooDeep;
 
@@ -210,6 +257,18 @@ class JsonDeserializer {
     ARDUINOJSON_ASSERT(current() == '[');
     move();
 
+    return skipArrayContent(nestingLimit, HasDirectAccess<TReader>());
+  }
+
+  DeserializationError::Code skipArrayContent(
+      DeserializationOption::NestingLimit nestingLimit, true_type) {
+    return scanDirectly('[', nestingLimit);
+  }
+
+  DeserializationError::Code skipArrayContent(
+      DeserializationOption::NestingLimit nestingLimit, false_type) {
+    DeserializationError::Code err;
+
     // Read each value
     for (;;) {
       // 1 - Skip value
@@ -316,8 +375,6 @@ class JsonDeserializer {
 
   DeserializationError::Code skipObject(
       DeserializationOption::NestingLimit nestingLimit) {
-    DeserializationError::Code err;
-
     if (nestingLimit.reached())
       return DeserializationError::TooDeep;
 
@@ -325,6 +382,18 @@ class JsonDeserializer {
     ARDUINOJSON_ASSERT(current() == '{');
     move();
 
+    return skipObjectContent(nestingLimit, HasDirectAccess<TReader>());
+  }
+
+  DeserializationError::Code skipObjectContent(
+      DeserializationOption::NestingLimit nestingLimit, true_type) {
+    return scanDirectly('{', nestingLimit);
+  }
+
+  DeserializationError::Code skipObjectContent(
+      DeserializationOption::NestingLimit nestingLimit, false_type) {
+    DeserializationError::Code err;
+
     // Skip spaces
     err = skipSpacesAndComments();
     if (err)
@@ -373,7 +442,7 @@ class JsonDeserializer {
   }
 
   DeserializationError::Code parseKey() {
-    stringBuilder_.startString();
+    startString();
     if (isQuote(current())) {
       return parseQuotedString();
     } else {
@@ -384,17 +453,30 @@ class JsonDeserializer {
   DeserializationError::Code parseStringValue(VariantData& variant) {
     DeserializationError::Code err;
 
-    stringBuilder_.startString();
+    startString();
 
     err = parseQuotedString();
     if (err)
       return err;
 
-    variant.setOwnedString(stringBuilder_.save());
+    variant.setString(stringBuilder_.save(), resources_);
 
     return DeserializationError::Ok;
   }
 
+  void startString() {
+    startString(stringBuilder_);
+  }
+
+  static void startString(StringBuilder& builder) {
+    builder.startString();
+  }
+
+  void startString(InPlaceStringBuilder& builder) {
+    // current() is loaded, so it's the last character read
+    builder.startString(latch_.reader().position() - 1);
+  }
+
   DeserializationError::Code parseQuotedString() {
 #if ARDUINOJSON_DECODE_UNICODE
     Utf16::Codepoint codepoint;
@@ -479,8 +561,15 @@ class JsonDeserializer {
 
   DeserializationError::Code skipQuotedString() {
     const char stopChar = current();
-
     move();
+    return skipStringContent(stopChar, HasDirectAccess<TReader>());
+  }
+
+  DeserializationError::Code skipStringContent(char stopChar, true_type) {
+    return scanDirectly(stopChar);
+  }
+
+  DeserializationError::Code skipStringContent(char stopChar, false_type) {
     for (;;) {
       char c = current();
       move();
@@ -497,6 +586,22 @@ class JsonDeserializer {
     return DeserializationError::Ok;
   }
 
+  // Skips the rest of the value with a SkipScanner, which reads the input
+  // buffer directly. opening is the bracket or the quote that was just
+  // consumed.
+  DeserializationError::Code scanDirectly(
+      char opening, DeserializationOption::NestingLimit nestingLimit = {}) {
+    TReader& reader = latch_.reader();
+    auto scanner = makeSkipScanner(reader.position(), reader.end());
+    DeserializationError::Code err;
+    if (opening == '[' || opening == '{')
+      err = scanner.skipContainer(opening == '{', nestingLimit);
+    else
+      err = scanner.skipString(opening);
+    reader.seek(scanner.position());
+    return err;
+  }
+
   DeserializationError::Code skipNonQuotedString() {
     char c = current();
     while (canBeInNonQuotedString(c)) {
@@ -517,37 +622,7 @@ class JsonDeserializer {
     }
     buffer_[n] = 0;
 
-    auto number = parseNumber(buffer_);
-    switch (number.type()) {
-      case NumberType::UnsignedInteger:
-        if (result.setInteger(number.asUnsignedInteger(), resources_))
-          return DeserializationError::Ok;
-        else
-          return DeserializationError::NoMemory;
-
-      case NumberType::SignedInteger:
-        if (result.setInteger(number.asSignedInteger(), resources_))
-          return DeserializationError::Ok;
-        else
-          return DeserializationError::NoMemory;
-
-      case NumberType::Float:
-        if (result.setFloat(number.asFloat(), resources_))
-          return DeserializationError::Ok;
-        else
-          return DeserializationError::NoMemory;
-
-#if ARDUINOJSON_USE_DOUBLE
-      case NumberType::Double:
-        if (result.setFloat(number.asDouble(), resources_))
-          return DeserializationError::Ok;
-        else
-          return DeserializationError::NoMemory;
-#endif
-
-      default:
-        return DeserializationError::InvalidInput;
-    }
+    return setNumericValue(result, buffer_, resources_);
   }
 
   DeserializationError::Code skipNumericValue() {
@@ -574,35 +649,6 @@ class JsonDeserializer {
     return DeserializationError::Ok;
   }
 
-  static inline bool isBetween(char c, char min, char max) {
-    return min <= c && c <= max;
-  }
-
-  static inline bool canBeInNumber(char c) {
-    return isBetween(c, '0', '9') || c == '+' || c == '-' || c == '.' ||
-#if ARDUINOJSON_ENABLE_NAN || ARDUINOJSON_ENABLE_INFINITY
-           isBetween(c, 'A', 'Z') || isBetween(c, 'a', 'z');
-#else
-           c == 'e' || c == 'E';
-#endif
-  }
-
-  static inline bool canBeInNonQuotedString(char c) {
-    return isBetween(c, '0', '9') || isBetween(c, '_', 'z') ||
-           isBetween(c, 'A', 'Z');
-  }
-
-  static inline bool isQuote(char c) {
-    return c == '\'' || c == '\"';
-  }
-
-  static inline uint8_t decodeHex(char c) {
-    if (c < 'A')
-      return uint8_t(c - '0');
-    c = char(c & ~0x20);  // uppercase
-    return uint8_t(c - 'A' + 10);
-  }
-
   DeserializationError::Code skipSpacesAndComments() {
     for (;;) {
       switch (current()) {
@@ -682,7 +728,7 @@ class JsonDeserializer {
     return DeserializationError::Ok;
   }
 
-  StringBuilder stringBuilder_;
+  string_builder stringBuilder_;
   bool foundSomething_;
   Latch<TReader> latch_;
   ResourceManager* resources_;
@@ -719,4 +765,36 @@ inline DeserializationError deserializeJson(TDestination&& dst, TChar* input,
                                        input, detail::forward<Args>(args)...);
 }
 
+// Same as deserializeJson(), but unescapes the strings in the input buffer
+// instead of copying them: the document points to the input, which must
+// outlive it and remain unchanged while the document is in use.
+// Strings containing a NUL character are truncated.
+template <typename TDestination, typename... Args,
+          detail::enable_if_t<
+              detail::is_deserialize_destination<TDestination>::value &&
+                  !detail::is_integral<
+                      typename detail::first_or_void<Args...>::type>::value,
+              int> = 0>
+inline DeserializationError deserializeJsonInPlace(TDestination&& dst,
+                                                   char* input, Args... args) {
+  using namespace detail;
+  return doDeserialize<JsonDeserializer>(
+      dst, InPlaceReader(input, nullptr), makeDeserializationOptions(args...));
+}
+
+// Same as above, with the size of the input
+template <typename TDestination, typename Size, typename... Args,
+          detail::enable_if_t<
+              detail::is_deserialize_destination<TDestination>::value &&
+                  detail::is_integral<Size>::value,
+              int> = 0>
+inline DeserializationError deserializeJsonInPlace(TDestination&& dst,
+                                                   char* input, Size inputSize,
+                                                   Args... args) {
+  using namespace detail;
+  return doDeserialize<JsonDeserializer>(
+      dst, InPlaceReader(input, input + size_t(inputSize)),
+      makeDeserializationOptions(args...));
+}
+
 ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -0,0 +1,240 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Document/JsonDocument.hpp>
+#include <ArduinoJson/Json/JsonDeserializer.hpp>
+#include <ArduinoJson/Json/JsonSerializer.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Presents the current line of the input as a complete input, so that the
+// deserializer can't read past the '\n', even when the line is corrupted.
+template <typename TReader>
+class LineReader {
+ public:
+  explicit LineReader(TReader reader) : reader_(reader) {}
+
+  int read() {
+    if (state_ != State::InLine)
+      return -1;
+    int c = reader_.read();
+    if (c <= 0) {  // RamReader returns 0 at the terminator
+      state_ = State::EndOfInput;
+      return -1;
+    }
+    bytesRead_++;
+    if (c == '\n') {
+      state_ = State::EndOfLine;
+      return -1;
+    }
+    return c;
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    for (; n < length; n++) {
+      int c = read();
+      if (c < 0)
+        break;
+      buffer[n] = static_cast<char>(c);
+    }
+    return n;
+  }
+
+  // Starts reading the next line. Returns false at the end of the input.
+  bool nextLine() {
+    if (state_ == State::EndOfInput)
+      return false;
+    state_ = State::InLine;
+    return true;
+  }
+
+  // Consumes the rest of the line.
+  // Returns true if it only contained whitespace.
+  bool skipLine() {
+    bool blank = true;
+    for (int c = read(); c >= 0; c = read()) {
+      if (c != ' ' && c != '\t' && c != '\r')
+        blank = false;
+    }
+    return blank;
+  }
+
+  bool atEndOfInput() const {
+    return state_ == State::EndOfInput;
+  }
+
+  size_t bytesRead() const {
+    return bytesRead_;
+  }
+
+ private:
+  enum class State : uint8_t {
+    InLine,
+    EndOfLine,
+    EndOfInput,
+  };
+
+  TReader reader_;
+  State state_ = State::EndOfLine;
+  size_t bytesRead_ = 0;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Reads newline-delimited JSON (JSON Lines, NDJSON) one record at a time.
+// Each record is stored in the document passed to the constructor, which is
+// cleared each time; retainMemory() is enabled on that document so that the
+// records reuse the same memory pools.
+// A corrupted line is reported by error(), and reading resumes at the next
+// line.
+template <typename TInput>
+class JsonLinesReader {
+  using reader_type = detail::Reader<detail::remove_cv_t<TInput>>;
+
+ public:
+  template <typename T>
+  JsonLinesReader(T&& input, JsonDocument& doc,
+                  DeserializationOption::NestingLimit nestingLimit = {})
+      : lines_(reader_type(detail::forward<T>(input))),
+        doc_(&doc),
+        nestingLimit_(nestingLimit) {
+    doc.retainMemory();
+  }
+
+  // Reads the next record, skipping the blank lines.
+  // Returns false at the end of the input, or when the record limit or the
+  // byte budget of the current batch is reached.
+  bool next() {
+    for (;;) {
+      if (limitReached() || !lines_.nextLine())
+        return false;
+
+      error_ = deserializeJson(*doc_, lines_, nestingLimit_);
+      bool onlySpacesAfter = lines_.skipLine();
+
+      if (error_ == DeserializationError::EmptyInput) {  // blank line
+        if (lines_.atEndOfInput())
+          return false;
+        continue;
+      }
+
+      if (!error_ && !onlySpacesAfter)
+        error_ = DeserializationError::InvalidInput;
+      if (error_) {
+        doc_->clear();
+        errors_++;
+      }
+      batchRecords_++;
+      return true;
+    }
+  }
+
+  // Returns the error of the last record, or Ok.
+  DeserializationError error() const {
+    return error_;
+  }
+
+  // Returns the number of corrupted lines since the beginning.
+  size_t errors() const {
+    return errors_;
+  }
+
+  // Returns the number of bytes consumed since the beginning.
+  size_t bytesRead() const {
+    return lines_.bytesRead();
+  }
+
+  // Makes next() return false after the specified number of records in the
+  // current batch. Zero means no limit.
+  void setRecordLimit(size_t limit) {
+    recordLimit_ = limit;
+  }
+
+  // Makes next() return false once the current batch has consumed the
+  // specified number of bytes. The line that crosses the limit is still read
+  // entirely. Zero means no limit.
+  void setByteBudget(size_t budget) {
+    byteBudget_ = budget;
+  }
+
+  // Returns the number of records (including the corrupted ones) read in the
+  // current batch.
+  size_t batchRecords() const {
+    return batchRecords_;
+  }
+
+  // Starts a new batch, so that next() can read past the limits again.
+  void startBatch() {
+    batchRecords_ = 0;
+    batchStart_ = lines_.bytesRead();
+  }
+
+ private:
+  bool limitReached() const {
+    if (recordLimit_ && batchRecords_ >= recordLimit_)
+      return true;
+    if (byteBudget_ && lines_.bytesRead() - batchStart_ >= byteBudget_)
+      return true;
+    return false;
+  }
+
+  detail::LineReader<reader_type> lines_;
+  JsonDocument* doc_;
+  DeserializationOption::NestingLimit nestingLimit_;
+  DeserializationError error_;
+  size_t errors_ = 0;
+  size_t recordLimit_ = 0;
+  size_t byteBudget_ = 0;
+  size_t batchRecords_ = 0;
+  size_t batchStart_ = 0;
+};
+
+// Writes records to a destination as newline-delimited JSON (JSON Lines,
+// NDJSON). Each record is serialized once, the previous ones are left as is.
+// The destination can be anything serializeJson() writes to: Print, File,
+// String, std::string, std::ostream...
+// Like serializeJson(), the constructor clears a string destination.
+template <typename TDestination>
+class JsonLinesWriter {
+ public:
+  explicit JsonLinesWriter(TDestination& destination) : writer_(destination) {}
+
+  // Writes the record on a single line.
+  // Returns the number of bytes written, including the '\n', or 0 if the
+  // destination refused the record.
+  size_t write(JsonVariantConst record) {
+    size_t n = detail::doSerialize<detail::JsonSerializer, writer_type&>(
+        record, writer_);
+    if (!n)
+      return 0;
+    n += writer_.write(uint8_t('\n'));
+    records_++;
+    bytesWritten_ += n;
+    return n;
+  }
+
+  // Returns the number of records written.
+  size_t records() const {
+    return records_;
+  }
+
+  // Returns the number of bytes written.
+  size_t bytesWritten() const {
+    return bytesWritten_;
+  }
+
+ private:
+  using writer_type = detail::Writer<TDestination>;
+
+  writer_type writer_;
+  size_t records_ = 0;
+  size_t bytesWritten_ = 0;
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -0,0 +1,532 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Document/JsonDocument.hpp>
+#include <ArduinoJson/Json/JsonDeserializer.hpp>
+
+#include <string.h>  // strlen
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Parses a JSON input that arrives in chunks of any size.
+// Unlike deserializeJson(), it never waits for the input: each call to feed()
+// consumes the bytes it receives and returns immediately.
+// The result is stored in the document passed to the constructor, which is
+// cleared first.
+class JsonPushParser {
+ public:
+  enum class Status : uint8_t {
+    NeedMore,  // the value is not complete yet
+    Done,      // the document contains the value
+    Error,     // see error()
+  };
+
+  JsonPushParser(JsonDocument& doc,
+                 DeserializationOption::NestingLimit nestingLimit = {})
+      : doc_(&doc),
+        resources_(detail::VariantAttorney::getResourceManager(doc)),
+        stringBuilder_(resources_),
+        nestingLimit_(nestingLimit) {
+    reset();
+  }
+
+  ~JsonPushParser() {
+    if (stack_)
+      resources_->allocator()->deallocate(stack_);
+  }
+
+  JsonPushParser(const JsonPushParser&) = delete;
+  JsonPushParser& operator=(const JsonPushParser&) = delete;
+
+  // Clears the document and gets ready for a new input
+  void reset() {
+    doc_->clear();
+    target_ = detail::VariantAttorney::getOrCreateData(*doc_);
+    depth_ = 0;
+    state_ = State::Value;
+    comment_ = Comment::None;
+    foundSomething_ = false;
+    status_ = Status::NeedMore;
+    error_ = DeserializationError::Ok;
+  }
+
+  // Parses the next chunk of the input.
+  // Once the value is complete, the remaining bytes are ignored.
+  Status feed(const char* data, size_t length) {
+    for (size_t i = 0; i < length && status_ == Status::NeedMore; i++)
+      process(data[i]);
+    return status_;
+  }
+
+  Status feed(const uint8_t* data, size_t length) {
+    return feed(reinterpret_cast<const char*>(data), length);
+  }
+
+  Status feed(const char* s) {
+    return feed(s, strlen(s));
+  }
+
+  // Signals the end of the input.
+  // Needed when the input is a number, because nothing else marks its end.
+  Status finish() {
+    if (status_ == Status::NeedMore)
+      process('\0');
+    return status_;
+  }
+
+  Status status() const {
+    return status_;
+  }
+
+  DeserializationError error() const {
+    return error_;
+  }
+
+ private:
+  enum class State : uint8_t {
+    Value,        // skipping spaces before a value
+    ArrayFirst,   // after '['
+    ArrayNext,    // after an element
+    ObjectFirst,  // after '{'
+    ObjectNext,   // after a member
+    NextKey,      // after ','
+    Key,
+    UnquotedKey,
+    Colon,
+    String,
+    Escape,
+    Hex,
+    Keyword,
+    Number,
+  };
+
+  enum class Comment : uint8_t {
+    None,
+    Slash,
+    Block,
+    BlockStar,
+    Line,
+  };
+
+  // '\0' means the end of the input, like in the other deserializers
+  void process(char c) {
+    while (status_ == Status::NeedMore && !step(c)) {
+      // state changed, c must be processed again
+    }
+  }
+
+  // Returns false if c was not consumed
+  bool step(char c) {
+    if (comment_ != Comment::None)
+      return skipComment(c);
+
+    switch (state_) {
+      case State::Value:
+        return skipSpace(c) || startValue(c);
+
+      case State::ArrayFirst:
+        if (skipSpace(c))
+          return true;
+        if (c == ']')
+          return closeContainer();
+        addElement();
+        return false;
+
+      case State::ArrayNext:
+        if (skipSpace(c))
+          return true;
+        if (c == ']')
+          return closeContainer();
+        if (c != ',')
+          return fail(DeserializationError::InvalidInput);
+        addElement();
+        return true;
+
+      case State::ObjectFirst:
+        if (skipSpace(c))
+          return true;
+        if (c == '}')
+          return closeContainer();
+        state_ = State::Key;
+        return false;
+
+      case State::ObjectNext:
+        if (skipSpace(c))
+          return true;
+        if (c == '}')
+          return closeContainer();
+        if (c != ',')
+          return fail(DeserializationError::InvalidInput);
+        state_ = State::NextKey;
+        return true;
+
+      case State::NextKey:
+        if (skipSpace(c))
+          return true;
+        state_ = State::Key;
+        return false;
+
+      case State::Key:
+        return startKey(c);
+
+      case State::UnquotedKey:
+        if (detail::canBeInNonQuotedString(c)) {
+          stringBuilder_.append(c);
+          return true;
+        }
+        if (!stringBuilder_.isValid())
+          return fail(DeserializationError::NoMemory);
+        state_ = State::Colon;
+        return false;
+
+      case State::Colon:
+        if (skipSpace(c))
+          return true;
+        if (c != ':')
+          return fail(DeserializationError::InvalidInput);
+        addMember();
+        return true;
+
+      case State::String:
+        return parseStringChar(c);
+
+      case State::Escape:
+        return parseEscapeSequence(c);
+
+      case State::Hex:
+        return parseHexDigit(c);
+
+      case State::Keyword:
+        if (c == '\0')
+          return fail(DeserializationError::IncompleteInput);
+        if (c != *keyword_)
+          return fail(DeserializationError::InvalidInput);
+        if (!*++keyword_)
+          endValue();
+        return true;
+
+      case State::Number:
+        if (numberLength_ < sizeof(number_) - 1 && detail::canBeInNumber(c)) {
+          number_[numberLength_++] = c;
+          return true;
+        }
+        endNumber(c);
+        return false;
+
+      default:
+        return fail(DeserializationError::InvalidInput);
+    }
+  }
+
+  // Returns true if c was consumed as a space or the start of a comment, or
+  // if the input ended
+  bool skipSpace(char c) {
+    switch (c) {
+      case '\0':
+        fail(foundSomething_ ? DeserializationError::IncompleteInput
+                             : DeserializationError::EmptyInput);
+        return true;
+
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+        return true;
+
+#if ARDUINOJSON_ENABLE_COMMENTS
+      case '/':
+        comment_ = Comment::Slash;
+        return true;
+#endif
+
+      default:
+        foundSomething_ = true;
+        return false;
+    }
+  }
+
+  bool skipComment(char c) {
+    switch (comment_) {
+      case Comment::Slash:
+        if (c == '*')
+          comment_ = Comment::Block;
+        else if (c == '/')
+          comment_ = Comment::Line;
+        else
+          return fail(DeserializationError::InvalidInput);
+        return true;
+
+      case Comment::Line:
+        if (c == '\0')
+          return fail(DeserializationError::IncompleteInput);
+        if (c == '\n')
+          comment_ = Comment::None;
+        return true;
+
+      default:  // Block or BlockStar
+        if (c == '\0')
+          return fail(DeserializationError::IncompleteInput);
+        if (c == '/' && comment_ == Comment::BlockStar)
+          comment_ = Comment::None;
+        else
+          comment_ = c == '*' ? Comment::BlockStar : Comment::Block;
+        return true;
+    }
+  }
+
+  bool startValue(char c) {
+    switch (c) {
+      case '[':
+        target_->toArray();
+        return openContainer(State::ArrayFirst);
+
+      case '{':
+        target_->toObject();
+        return openContainer(State::ObjectFirst);
+
+      case '\"':
+      case '\'':
+        startString(c, false);
+        return true;
+
+      case 't':
+        target_->setBoolean(true);
+        return startKeyword("true");
+
+      case 'f':
+        target_->setBoolean(false);
+        return startKeyword("false");
+
+      case 'n':
+        return startKeyword("null");
+
+      default:
+        numberLength_ = 0;
+        state_ = State::Number;
+        return false;
+    }
+  }
+
+  bool startKey(char c) {
+    if (detail::isQuote(c)) {
+      startString(c, true);
+      return true;
+    }
+    if (!detail::canBeInNonQuotedString(c))
+      return fail(DeserializationError::InvalidInput);
+    stringBuilder_.startString();
+    state_ = State::UnquotedKey;
+    return false;
+  }
+
+  void startString(char quote, bool isKey) {
+    stringBuilder_.startString();
+#if ARDUINOJSON_DECODE_UNICODE
+    codepoint_ = detail::Utf16::Codepoint();
+#endif
+    quote_ = quote;
+    inKey_ = isKey;
+    state_ = State::String;
+  }
+
+  bool startKeyword(const char* keyword) {
+    keyword_ = keyword + 1;  // the first letter is c
+    state_ = State::Keyword;
+    return true;
+  }
+
+  bool parseStringChar(char c) {
+    if (c == quote_)
+      return endString();
+    if (c == '\0')
+      return fail(DeserializationError::IncompleteInput);
+    if (c == '\\')
+      state_ = State::Escape;
+    else
+      stringBuilder_.append(c);
+    return true;
+  }
+
+  bool parseEscapeSequence(char c) {
+    if (c == '\0')
+      return fail(DeserializationError::IncompleteInput);
+
+    if (c == 'u') {
+#if ARDUINOJSON_DECODE_UNICODE
+      codeunit_ = 0;
+      hexDigits_ = 0;
+      state_ = State::Hex;
+      return true;
+#else
+      stringBuilder_.append('\\');
+      state_ = State::String;
+      return false;  // 'u' is a regular character
+#endif
+    }
+
+    c = detail::EscapeSequence::unescapeChar(c);
+    if (c == '\0')
+      return fail(DeserializationError::InvalidInput);
+    stringBuilder_.append(c);
+    state_ = State::String;
+    return true;
+  }
+
+  bool parseHexDigit(char c) {
+#if ARDUINOJSON_DECODE_UNICODE
+    if (c == '\0')
+      return fail(DeserializationError::IncompleteInput);
+    uint8_t value = detail::decodeHex(c);
+    if (value > 0x0F)
+      return fail(DeserializationError::InvalidInput);
+    codeunit_ = uint16_t((codeunit_ << 4) | value);
+    if (++hexDigits_ == 4) {
+      if (codepoint_.append(codeunit_))
+        detail::Utf8::encodeCodepoint(codepoint_.value(), stringBuilder_);
+      state_ = State::String;
+    }
+    return true;
+#else
+    (void)c;
+    return fail(DeserializationError::InvalidInput);  // unreachable
+#endif
+  }
+
+  bool endString() {
+    if (!stringBuilder_.isValid())
+      return fail(DeserializationError::NoMemory);
+    if (inKey_) {
+      state_ = State::Colon;
+    } else {
+      target_->setString(stringBuilder_.save(), resources_);
+      endValue();
+    }
+    return true;
+  }
+
+  void endNumber(char next) {
+    number_[numberLength_] = 0;
+    auto err = detail::setNumericValue(*target_, number_, resources_);
+    if (err) {
+      fail(err);
+      return;
+    }
+    // Like deserializeJson(), reject trailing characters after a float
+    if (depth_ == 0 && next != '\0' && target_->isFloat()) {
+      fail(DeserializationError::InvalidInput);
+      return;
+    }
+    endValue();
+  }
+
+  void endValue() {
+    if (depth_ == 0) {
+      complete(Status::Done);
+      return;
+    }
+    state_ = stack_[depth_ - 1]->isObject() ? State::ObjectNext
+                                            : State::ArrayNext;
+  }
+
+  bool openContainer(State state) {
+    if (remainingNestingLimit().reached())
+      return fail(DeserializationError::TooDeep);
+    if (depth_ == stackCapacity_ && !growStack())
+      return fail(DeserializationError::NoMemory);
+    stack_[depth_++] = target_;
+    state_ = state;
+    return true;
+  }
+
+  bool closeContainer() {
+    depth_--;
+    endValue();
+    return true;
+  }
+
+  void addElement() {
+    target_ = stack_[depth_ - 1]->asArray()->addElement(resources_);
+    if (target_)
+      state_ = State::Value;
+    else
+      fail(DeserializationError::NoMemory);
+  }
+
+  void addMember() {
+    auto object = stack_[depth_ - 1]->asObject();
+    JsonString key = stringBuilder_.str();
+    auto member = object->getMember(detail::adaptString(key), resources_);
+    if (!member) {
+      member = object->addMember(stringBuilder_.save(), resources_);
+      if (!member) {
+        fail(DeserializationError::NoMemory);
+        return;
+      }
+    } else {
+      member->clear(resources_);
+    }
+    target_ = member;
+    state_ = State::Value;
+  }
+
+  bool growStack() {
+    auto capacity = uint8_t(stackCapacity_ ? stackCapacity_ * 2 : 4);
+    if (capacity < stackCapacity_)  // overflow
+      capacity = 255;
+    auto stack = static_cast<detail::VariantData**>(
+        resources_->allocator()->reallocate(
+            stack_, capacity * sizeof(detail::VariantData*)));
+    if (!stack)
+      return false;
+    stack_ = stack;
+    stackCapacity_ = capacity;
+    return true;
+  }
+
+  DeserializationOption::NestingLimit remainingNestingLimit() const {
+    auto limit = nestingLimit_;
+    for (uint8_t i = 0; i < depth_; i++)
+      limit = limit.decrement();
+    return limit;
+  }
+
+  bool fail(DeserializationError::Code err) {
+    error_ = err;
+    complete(Status::Error);
+    return true;
+  }
+
+  void complete(Status result) {
+    status_ = result;
+    detail::shrinkJsonDocument(*doc_);
+  }
+
+  JsonDocument* doc_;
+  detail::ResourceManager* resources_;
+  detail::StringBuilder stringBuilder_;
+  DeserializationOption::NestingLimit nestingLimit_;
+  detail::VariantData* target_ = nullptr;  // the value being parsed
+  detail::VariantData** stack_ = nullptr;  // the open arrays and objects
+  uint8_t stackCapacity_ = 0;
+  uint8_t depth_ = 0;
+  State state_ = State::Value;
+  Comment comment_ = Comment::None;
+  Status status_ = Status::NeedMore;
+  DeserializationError error_ = DeserializationError::Ok;
+  bool foundSomething_ = false;
+  bool inKey_ = false;
+  char quote_ = 0;
+  const char* keyword_ = nullptr;
+#if ARDUINOJSON_DECODE_UNICODE
+  detail::Utf16::Codepoint codepoint_;
+  uint16_t codeunit_ = 0;
+  uint8_t hexDigits_ = 0;
+#endif
+  uint8_t numberLength_ = 0;
+  char number_[64];
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
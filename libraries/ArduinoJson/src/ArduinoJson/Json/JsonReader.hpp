@@ -0,0 +1,291 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Document/JsonDocument.hpp>
+#include <ArduinoJson/Json/JsonDeserializer.hpp>
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// The tokens returned by JsonReader::next()
+enum class JsonEvent : uint8_t {
+  StartObject,
+  EndObject,
+  StartArray,
+  EndArray,
+  Key,
+  Value,
+  End,
+  Error,
+};
+
+// Reads a JSON input one token at a time, with bounded memory.
+// Values, and subtrees materialized with read(), are stored in the document
+// passed to the constructor, which is cleared each time.
+template <typename TInput>
+class JsonReader
+    : detail::JsonDeserializer<detail::Reader<detail::remove_cv_t<TInput>>> {
+  using reader_type = detail::Reader<detail::remove_cv_t<TInput>>;
+  using base = detail::JsonDeserializer<reader_type>;
+
+ public:
+  template <typename T>
+  JsonReader(T&& input, JsonDocument& doc,
+             DeserializationOption::NestingLimit nestingLimit = {})
+      : base(detail::VariantAttorney::getResourceManager(doc),
+             reader_type(detail::forward<T>(input))),
+        doc_(&doc),
+        nestingLimit_(nestingLimit) {}
+
+  // Reads the next token.
+  // When it returns StartObject or StartArray, the container can be entered
+  // by calling next() again, or consumed at once with read() or skip().
+  JsonEvent next() {
+    switch (state_) {
+      case State::Start:
+        return readValue();
+
+      case State::PendingObject:
+        return enterObject();
+
+      case State::PendingArray:
+        return enterArray();
+
+      case State::AfterKey:
+        return readValue();
+
+      case State::AfterValue:
+        return readSeparator();
+
+      case State::Ended:
+        return JsonEvent::End;
+
+      default:
+        return JsonEvent::Error;
+    }
+  }
+
+  // Returns the key, after next() returned Key.
+  // The string is only valid until the next call to next().
+  JsonString key() const {
+    return key_;
+  }
+
+  // Returns the value, after next() returned Value, or read() succeeded.
+  JsonVariantConst value() const {
+    return doc_->as<JsonVariantConst>();
+  }
+
+  // Returns the depth of the current position
+  uint8_t depth() const {
+    return depth_;
+  }
+
+  // Returns the error that stopped the reader
+  DeserializationError error() const {
+    return error_;
+  }
+
+  // Materializes the object or array that next() just announced.
+  // Also works after Value, in which case the document already contains it.
+  DeserializationError read() {
+    return read(detail::AllowAllFilter());
+  }
+
+  // Same as read(), but only keeps the fields allowed by the filter
+  template <typename TFilter>
+  DeserializationError read(TFilter filter) {
+    if (state_ == State::AfterValue)
+      return DeserializationError::Ok;
+    if (state_ != State::PendingObject && state_ != State::PendingArray)
+      return fail(DeserializationError::InvalidInput);
+    doc_->clear();
+    auto data = detail::VariantAttorney::getOrCreateData(*doc_);
+    auto err = base::parseVariant(*data, filter, remainingNestingLimit());
+    if (err)
+      return fail(err);
+    state_ = State::AfterValue;
+    return DeserializationError::Ok;
+  }
+
+  // Skips the object or array that next() just announced
+  DeserializationError skip() {
+    if (state_ == State::AfterValue)
+      return DeserializationError::Ok;
+    if (state_ != State::PendingObject && state_ != State::PendingArray)
+      return fail(DeserializationError::InvalidInput);
+    auto err = base::skipVariant(remainingNestingLimit());
+    if (err)
+      return fail(err);
+    state_ = State::AfterValue;
+    return DeserializationError::Ok;
+  }
+
+ private:
+  enum class State : uint8_t {
+    Start,
+    PendingObject,
+    PendingArray,
+    AfterKey,
+    AfterValue,
+    Ended,
+    Failed,
+  };
+
+  JsonEvent readValue() {
+    auto err = base::skipSpacesAndComments();
+    if (err)
+      return stop(err);
+
+    switch (base::current()) {
+      case '{':
+        state_ = State::PendingObject;
+        return JsonEvent::StartObject;
+
+      case '[':
+        state_ = State::PendingArray;
+        return JsonEvent::StartArray;
+
+      default:
+        doc_->clear();
+        err = base::parseVariant(
+            *detail::VariantAttorney::getOrCreateData(*doc_),
+            detail::AllowAllFilter(), remainingNestingLimit());
+        if (err)
+          return stop(err);
+        state_ = State::AfterValue;
+        return JsonEvent::Value;
+    }
+  }
+
+  JsonEvent readKey() {
+    auto err = base::parseKey();
+    if (err)
+      return stop(err);
+
+    err = base::skipSpacesAndComments();
+    if (err)
+      return stop(err);
+
+    if (!base::eat(':'))
+      return stop(DeserializationError::InvalidInput);
+
+    key_ = base::stringBuilder_.str();
+    state_ = State::AfterKey;
+    return JsonEvent::Key;
+  }
+
+  JsonEvent enterObject() {
+    if (!push(true))
+      return JsonEvent::Error;
+
+    auto err = base::skipSpacesAndComments();
+    if (err)
+      return stop(err);
+
+    if (base::eat('}'))
+      return pop(JsonEvent::EndObject);
+
+    return readKey();
+  }
+
+  JsonEvent enterArray() {
+    if (!push(false))
+      return JsonEvent::Error;
+
+    auto err = base::skipSpacesAndComments();
+    if (err)
+      return stop(err);
+
+    if (base::eat(']'))
+      return pop(JsonEvent::EndArray);
+
+    return readValue();
+  }
+
+  JsonEvent readSeparator() {
+    if (depth_ == 0) {
+      state_ = State::Ended;
+      return JsonEvent::End;
+    }
+
+    auto err = base::skipSpacesAndComments();
+    if (err)
+      return stop(err);
+
+    if (isInObject()) {
+      if (base::eat('}'))
+        return pop(JsonEvent::EndObject);
+      if (!base::eat(','))
+        return stop(DeserializationError::InvalidInput);
+      err = base::skipSpacesAndComments();
+      if (err)
+        return stop(err);
+      return readKey();
+    } else {
+      if (base::eat(']'))
+        return pop(JsonEvent::EndArray);
+      if (!base::eat(','))
+        return stop(DeserializationError::InvalidInput);
+      return readValue();
+    }
+  }
+
+  bool push(bool isObject) {
+    if (remainingNestingLimit().reached()) {
+      stop(DeserializationError::TooDeep);
+      return false;
+    }
+    base::move();  // skip the brace or the bracket
+    uint8_t mask = uint8_t(1 << (depth_ % 8));
+    if (isObject)
+      containers_[depth_ / 8] |= mask;
+    else
+      containers_[depth_ / 8] &= uint8_t(~mask);
+    depth_++;
+    return true;
+  }
+
+  JsonEvent pop(JsonEvent event) {
+    ARDUINOJSON_ASSERT(depth_ > 0);
+    depth_--;
+    state_ = State::AfterValue;
+    return event;
+  }
+
+  bool isInObject() const {
+    ARDUINOJSON_ASSERT(depth_ > 0);
+    uint8_t level = uint8_t(depth_ - 1);
+    return (containers_[level / 8] >> (level % 8)) & 1;
+  }
+
+  DeserializationOption::NestingLimit remainingNestingLimit() const {
+    auto limit = nestingLimit_;
+    for (uint8_t i = 0; i < depth_; i++)
+      limit = limit.decrement();
+    return limit;
+  }
+
+  DeserializationError::Code fail(DeserializationError::Code err) {
+    error_ = err;
+    state_ = State::Failed;
+    return err;
+  }
+
+  JsonEvent stop(DeserializationError::Code err) {
+    fail(err);
+    return JsonEvent::Error;
+  }
+
+  JsonDocument* doc_;
+  DeserializationOption::NestingLimit nestingLimit_;
+  DeserializationError error_ = DeserializationError::Ok;
+  JsonString key_;
+  State state_ = State::Start;
+  uint8_t depth_ = 0;
+  uint8_t containers_[32] = {};  // one bit per level: 1=object, 0=array
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -25,6 +25,14 @@ class Latch {
     return current_;
   }
 
+  const TReader& reader() const {
+    return reader_;
+  }
+
+  TReader& reader() {
+    return reader_;
+  }
+
   FORCE_INLINE char current() {
     if (!loaded_) {
       load();
@@ -0,0 +1,360 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Deserialization/DeserializationError.hpp>
+#include <ArduinoJson/Deserialization/NestingLimit.hpp>
+#include <ArduinoJson/Json/CharacterClasses.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Polyfills/type_traits/declval.hpp>
+
+#include <stdint.h>
+#include <string.h>  // memcpy
+
+#if ARDUINOJSON_USE_SSE2
+#  include <emmintrin.h>
+#endif
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// True if the reader exposes the input buffer with position(), end(), and
+// seek(), like the readers of RAM strings
+template <typename TReader, typename = void>
+struct HasDirectAccess : false_type {};
+
+template <typename TReader>
+struct HasDirectAccess<
+    TReader,
+    enable_if_t<is_pointer<decltype(declval<TReader&>().position())>::value>>
+    : true_type {};
+
+// Skips the values rejected by the filter when the input is in RAM.
+// It accepts and rejects the same inputs as JsonDeserializer::skipVariant(),
+// but it reads the buffer directly, doesn't recurse, and jumps over the
+// content of the strings one word at a time (SWAR: SIMD within a register).
+template <typename TChar>  // char or const char
+class SkipScanner {
+  using word_t = conditional_t<ARDUINOJSON_SIZEOF_POINTER >= 8, uint64_t,
+                               uint32_t>;
+
+ public:
+  // end == nullptr means the input stops at the first '\0'
+  SkipScanner(TChar* ptr, TChar* end) : ptr_(ptr), end_(end) {}
+
+  // Returns the address of the next character to read
+  TChar* position() const {
+    return ptr_;
+  }
+
+  // Skips the rest of the array or object whose opening bracket was just read
+  DeserializationError::Code skipContainer(
+      bool isObject, DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    uint8_t maxDepth = 0;
+    for (; !nestingLimit.reached(); nestingLimit = nestingLimit.decrement())
+      maxDepth++;
+    ARDUINOJSON_ASSERT(maxDepth > 0);
+
+    uint8_t depth = 1;
+    setObjectAt(0, isObject);
+
+    if (isObject) {
+      err = skipSpaces();
+      if (err)
+        return err;
+      if (eat('}'))
+        return DeserializationError::Ok;
+    }
+
+    for (;;) {
+      // 1 - Skip the key
+      if (isObjectAt(depth - 1)) {
+        err = skipKey();
+        if (err)
+          return err;
+        err = skipSpaces();
+        if (err)
+          return err;
+        if (!eat(':'))
+          return DeserializationError::InvalidInput;
+      }
+
+      // 2 - Skip the value, or enter it if it's a container
+      err = skipSpaces();
+      if (err)
+        return err;
+      char c = current();
+      if (c == '[' || c == '{') {
+        if (depth == maxDepth)
+          return DeserializationError::TooDeep;
+        move();
+        setObjectAt(depth++, c == '{');
+        if (c == '[')
+          continue;
+        err = skipSpaces();
+        if (err)
+          return err;
+        if (current() != '}')
+          continue;
+        // empty object: it's closed below
+      } else {
+        err = skipScalar(c);
+        if (err)
+          return err;
+      }
+
+      // 3 - Skip the separator, or the closing brackets
+      for (;;) {
+        err = skipSpaces();
+        if (err)
+          return err;
+        if (!eat(isObjectAt(depth - 1) ? '}' : ']'))
+          break;
+        if (--depth == 0)
+          return DeserializationError::Ok;
+      }
+      if (!eat(','))
+        return DeserializationError::InvalidInput;
+      err = skipSpaces();
+      if (err)
+        return err;
+    }
+  }
+
+  // Skips the rest of the string whose opening quote was just read
+  DeserializationError::Code skipString(char quote) {
+    for (;;) {
+      skipPlainCharacters(quote);
+      char c = current();
+      while (c != quote && c != '\\' && c != '\0') {
+        move();
+        c = current();
+      }
+      if (c == '\0')
+        return DeserializationError::IncompleteInput;
+      move();
+      if (c == quote)
+        return DeserializationError::Ok;
+      if (current() != '\0')
+        move();  // escaped character
+    }
+  }
+
+ private:
+  char current() const {
+    return ptr_ == end_ ? '\0' : *ptr_;
+  }
+
+  void move() {
+    ptr_++;
+  }
+
+  bool eat(char c) {
+    if (current() != c)
+      return false;
+    move();
+    return true;
+  }
+
+  bool isObjectAt(uint8_t level) const {
+    return (objects_[level / 8] >> (level % 8)) & 1;
+  }
+
+  void setObjectAt(uint8_t level, bool isObject) {
+    uint8_t mask = uint8_t(1 << (level % 8));
+    if (isObject)
+      objects_[level / 8] |= mask;
+    else
+      objects_[level / 8] &= uint8_t(~mask);
+  }
+
+  DeserializationError::Code skipScalar(char c) {
+    switch (c) {
+      case '\"':
+      case '\'':
+        move();
+        return skipString(c);
+
+      case 't':
+        return skipKeyword("true");
+
+      case 'f':
+        return skipKeyword("false");
+
+      case 'n':
+        return skipKeyword("null");
+
+      default:
+        while (canBeInNumber(current()))
+          move();
+        return DeserializationError::Ok;
+    }
+  }
+
+  DeserializationError::Code skipKey() {
+    char c = current();
+    if (isQuote(c)) {
+      move();
+      return skipString(c);
+    }
+    while (canBeInNonQuotedString(current()))
+      move();
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code skipKeyword(const char* s) {
+    for (; *s; s++) {
+      char c = current();
+      if (c == '\0')
+        return DeserializationError::IncompleteInput;
+      if (*s != c)
+        return DeserializationError::InvalidInput;
+      move();
+    }
+    return DeserializationError::Ok;
+  }
+
+  // Same as JsonDeserializer::skipSpacesAndComments(), except that we're
+  // always inside a value, so the end of the input is always an error
+  DeserializationError::Code skipSpaces() {
+    for (;;) {
+      switch (current()) {
+        case '\0':
+          return DeserializationError::IncompleteInput;
+
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+          move();
+          continue;
+
+#if ARDUINOJSON_ENABLE_COMMENTS
+        case '/':
+          move();
+          switch (current()) {
+            case '*': {
+              move();
+              bool wasStar = false;
+              for (;;) {
+                char c = current();
+                if (c == '\0')
+                  return DeserializationError::IncompleteInput;
+                move();
+                if (c == '/' && wasStar)
+                  break;
+                wasStar = c == '*';
+              }
+              break;
+            }
+
+            case '/':
+              for (;;) {
+                move();
+                char c = current();
+                if (c == '\0')
+                  return DeserializationError::IncompleteInput;
+                if (c == '\n')
+                  break;
+              }
+              break;
+
+            default:
+              return DeserializationError::InvalidInput;
+          }
+          break;
+#endif
+
+        default:
+          return DeserializationError::Ok;
+      }
+    }
+  }
+
+  // Moves to the next quote, backslash, or '\0', or at least to the block
+  // that contains it.
+  // Only possible when the end of the input is known, because we can't read
+  // past the terminator.
+  void skipPlainCharacters(char quote) {
+    if (!end_)
+      return;
+#if ARDUINOJSON_USE_SSE2
+    skipPlainBlocks(quote);
+#else
+    skipPlainWords(quote);
+#endif
+  }
+
+#if ARDUINOJSON_USE_SSE2
+  // Same as skipPlainWords() with 16 bytes at a time
+  void skipPlainBlocks(char quote) {
+    const __m128i quotes = _mm_set1_epi8(quote);
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i zeros = _mm_setzero_si128();
+    while (end_ - ptr_ >= 16) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr_));
+      __m128i found = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(block, quotes),
+                       _mm_cmpeq_epi8(block, backslashes)),
+          _mm_cmpeq_epi8(block, zeros));
+      int mask = _mm_movemask_epi8(found);
+      if (mask) {
+        ptr_ += __builtin_ctz(unsigned(mask));
+        return;
+      }
+      ptr_ += 16;
+    }
+  }
+#endif
+
+  void skipPlainWords(char quote) {
+    const word_t ones = word_t(~word_t(0)) / 0xFF;  // 0x0101...01
+    const word_t quotes = ones * uint8_t(quote);
+    const word_t backslashes = ones * uint8_t('\\');
+    while (size_t(end_ - ptr_) >= sizeof(word_t)) {
+      word_t block;
+      memcpy(&block, ptr_, sizeof(block));
+      word_t found = hasZeroByte(block ^ quotes) |
+                     hasZeroByte(block ^ backslashes) | hasZeroByte(block);
+      if (found) {
+#if ARDUINOJSON_LITTLE_ENDIAN && defined(__GNUC__)
+        // the lowest flag is always a true match
+        ptr_ += countTrailingZeros(found) / 8;
+#endif
+        return;
+      }
+      ptr_ += sizeof(word_t);
+    }
+  }
+
+#if ARDUINOJSON_LITTLE_ENDIAN && defined(__GNUC__)
+  static int countTrailingZeros(uint32_t x) {
+    return __builtin_ctz(x);
+  }
+
+  static int countTrailingZeros(uint64_t x) {
+    return __builtin_ctzll(x);
+  }
+#endif
+
+  // Returns non-zero if one of the bytes is zero
+  static word_t hasZeroByte(word_t x) {
+    const word_t ones = word_t(~word_t(0)) / 0xFF;
+    return (x - ones) & ~x & (ones * 0x80);
+  }
+
+  TChar* ptr_;
+  TChar* end_;
+  uint8_t objects_[32];  // one bit per level: 1 for object, 0 for array
+};
+
+template <typename TChar>
+SkipScanner<TChar> makeSkipScanner(TChar* ptr, TChar* end) {
+  return SkipScanner<TChar>(ptr, end);
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
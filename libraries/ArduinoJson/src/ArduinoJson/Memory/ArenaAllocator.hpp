@@ -0,0 +1,167 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/Alignment.hpp>
+#include <ArduinoJson/Memory/Allocator.hpp>
+
+#include <string.h>  // memcpy
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// An allocator that carves blocks out of a fixed buffer, and never calls
+// malloc(). The last block can grow and shrink in place; the other blocks are
+// reclaimed once every block after them has been released too, so blocks
+// released out of order are rewound together. With
+// JsonDocument::retainMemory(), clear() releases the strings but keeps the
+// pools, so the arena rewinds to the last pool instead of the beginning.
+// The buffer must be larger than a memory pool (ARDUINOJSON_POOL_CAPACITY
+// slots), otherwise the document can't store anything.
+class ArenaAllocator : public Allocator {
+ public:
+  ArenaAllocator(void* buffer, size_t capacity)
+      : begin_(detail::addPadding(static_cast<char*>(buffer))),
+        end_(static_cast<char*>(buffer) + capacity),
+        top_(begin_),
+        peak_(begin_),
+        last_(nullptr),
+        blocks_(0) {
+    if (begin_ > end_)  // buffer too small to be aligned
+      end_ = begin_;
+  }
+
+  virtual ~ArenaAllocator() {}
+
+  void* allocate(size_t size) override {
+    auto blockSize = paddedBlockSize(size);
+    if (blockSize < size || blockSize > size_t(end_ - top_))
+      return nullptr;
+    auto block = top_;
+    auto header = headerOf(block);
+    header->size = size;
+    header->previous = last_ ? size_t(block - last_) : 0;
+    last_ = block;
+    top_ += blockSize;
+    blocks_++;
+    updatePeak();
+    return block + headerSize;
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr)
+      return;
+    auto block = blockOf(ptr);
+    blocks_--;
+    if (blocks_ == 0) {
+      top_ = begin_;
+      last_ = nullptr;
+    } else if (block == last_) {
+      // rewind past the blocks released before this one
+      do {
+        top_ = block;
+        block = previousBlock(block);
+      } while (block && isReleased(block));
+      last_ = block;
+    } else {
+      headerOf(block)->previous |= released;
+    }
+  }
+
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (!ptr)
+      return allocate(newSize);
+
+    auto block = blockOf(ptr);
+    auto oldSize = headerOf(block)->size;
+
+    if (block == last_) {
+      auto blockSize = paddedBlockSize(newSize);
+      if (blockSize < newSize || blockSize > size_t(end_ - block))
+        return nullptr;
+      headerOf(block)->size = newSize;
+      top_ = block + blockSize;
+      updatePeak();
+      return ptr;
+    }
+
+    if (newSize <= oldSize)
+      return ptr;  // the tail is lost until the block is reclaimed
+
+    auto newPtr = allocate(newSize);
+    if (!newPtr)
+      return nullptr;
+    memcpy(newPtr, ptr, oldSize);
+    deallocate(ptr);
+    return newPtr;
+  }
+
+  // Returns the number of usable bytes in the buffer
+  size_t capacity() const {
+    return size_t(end_ - begin_);
+  }
+
+  // Returns the number of bytes currently reserved, including block headers
+  size_t size() const {
+    return size_t(top_ - begin_);
+  }
+
+  // Returns the largest value of size() since construction or the last call
+  // to resetHighWaterMark()
+  size_t highWaterMark() const {
+    return size_t(peak_ - begin_);
+  }
+
+  void resetHighWaterMark() {
+    peak_ = top_;
+  }
+
+ private:
+  struct Header {
+    size_t size;      // as requested
+    size_t previous;  // offset of the previous block, 0 for the first one
+  };
+
+  // flags a block that was released while blocks after it were still in use,
+  // in the lowest bit of Header::previous which is always a multiple of the
+  // alignment
+  static const size_t released = 1;
+
+  static const size_t headerSize = detail::AddPadding<sizeof(Header)>::value;
+
+  static size_t paddedBlockSize(size_t size) {
+    return detail::addPadding(headerSize + size);
+  }
+
+  static char* blockOf(void* ptr) {
+    return static_cast<char*>(ptr) - headerSize;
+  }
+
+  static Header* headerOf(char* block) {
+    return reinterpret_cast<Header*>(block);
+  }
+
+  static char* previousBlock(char* block) {
+    auto offset = headerOf(block)->previous & ~released;
+    return offset ? block - offset : nullptr;
+  }
+
+  static bool isReleased(char* block) {
+    return (headerOf(block)->previous & released) != 0;
+  }
+
+  void updatePeak() {
+    if (top_ > peak_)
+      peak_ = top_;
+  }
+
+  char* begin_;
+  char* end_;
+  char* top_;
+  char* peak_;
+  char* last_;
+  size_t blocks_;
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -80,6 +80,12 @@ class MemoryPool {
     usage_ = 0;
   }
 
+  // Forgets the slots after the specified count
+  void truncate(SlotCount usage) {
+    ARDUINOJSON_ASSERT(usage <= usage_);
+    usage_ = usage;
+  }
+
   void shrinkToFit(Allocator* allocator) {
     auto newSlots = reinterpret_cast<T*>(
         allocator->reallocate(slots_, slotsToBytes(usage_)));
@@ -93,6 +99,10 @@ class MemoryPool {
     return usage_;
   }
 
+  SlotCount capacity() const {
+    return capacity_;
+  }
+
   static SlotCount bytesToSlots(size_t n) {
     return static_cast<SlotCount>(n / sizeof(T));
   }
@@ -28,7 +28,7 @@ class MemoryPoolList {
   MemoryPoolList() = default;
 
   ~MemoryPoolList() {
-    ARDUINOJSON_ASSERT(count_ == 0);
+    ARDUINOJSON_ASSERT(allocated_ == 0);
   }
 
   friend void swap(MemoryPoolList& a, MemoryPoolList& b) {
@@ -42,13 +42,13 @@ class MemoryPoolList {
         swap_(a.preallocatedPools_[i], b.preallocatedPools_[i]);
     } else if (bUsedPreallocated) {
       // only b => copy b's preallocated pools and give him a's pointer
-      for (PoolCount i = 0; i < b.count_; i++)
+      for (PoolCount i = 0; i < b.allocated_; i++)
         a.preallocatedPools_[i] = b.preallocatedPools_[i];
       b.pools_ = a.pools_;
       a.pools_ = a.preallocatedPools_;
     } else if (aUsedPreallocated) {
       // only a => copy a's preallocated pools and give him b's pointer
-      for (PoolCount i = 0; i < a.count_; i++)
+      for (PoolCount i = 0; i < a.allocated_; i++)
         b.preallocatedPools_[i] = a.preallocatedPools_[i];
       a.pools_ = b.pools_;
       b.pools_ = b.preallocatedPools_;
@@ -58,12 +58,13 @@ class MemoryPoolList {
     }
 
     swap_(a.count_, b.count_);
+    swap_(a.allocated_, b.allocated_);
     swap_(a.capacity_, b.capacity_);
     swap_(a.freeList_, b.freeList_);
   }
 
   MemoryPoolList& operator=(MemoryPoolList&& src) {
-    ARDUINOJSON_ASSERT(count_ == 0);
+    ARDUINOJSON_ASSERT(allocated_ == 0);
     if (src.pools_ == src.preallocatedPools_) {
       memcpy(preallocatedPools_, src.preallocatedPools_,
              sizeof(preallocatedPools_));
@@ -73,8 +74,10 @@ class MemoryPoolList {
       src.pools_ = nullptr;
     }
     count_ = src.count_;
+    allocated_ = src.allocated_;
     capacity_ = src.capacity_;
     src.count_ = 0;
+    src.allocated_ = 0;
     src.capacity_ = 0;
     return *this;
   }
@@ -115,9 +118,10 @@ class MemoryPoolList {
   }
 
   void clear(Allocator* allocator) {
-    for (PoolCount i = 0; i < count_; i++)
+    for (PoolCount i = 0; i < allocated_; i++)
       pools_[i].destroy(allocator);
     count_ = 0;
+    allocated_ = 0;
     freeList_ = NULL_SLOT;
     if (pools_ != preallocatedPools_) {
       allocator->deallocate(pools_);
@@ -126,6 +130,19 @@ class MemoryPoolList {
     }
   }
 
+  // Empties the list, but keeps the pools so that addPool() can reuse them.
+  // The last pool is released if shrinkToFit() made it smaller, otherwise it
+  // would be reused in the middle of the list.
+  void recycle(Allocator* allocator) {
+    if (allocated_ > 0 &&
+        pools_[allocated_ - 1].capacity() < poolCapacity(allocated_)) {
+      pools_[allocated_ - 1].destroy(allocator);
+      allocated_--;
+    }
+    count_ = 0;
+    freeList_ = NULL_SLOT;
+  }
+
   SlotCount usage() const {
     SlotCount total = 0;
     for (PoolCount i = 0; i < count_; i++)
@@ -137,7 +154,103 @@ class MemoryPoolList {
     return Pool::slotsToBytes(usage());
   }
 
+  // Moves the live slots to the lowest positions, so that the free slots end
+  // up at the end of the list. A position counts the slots of the pools end to
+  // end: a pool before the last one can hold fewer than
+  // ARDUINOJSON_POOL_CAPACITY slots, for example after shrinkToFit(), so the
+  // ids don't always run contiguously.
+  // Each slot that moved contains its new id, until truncate() releases it;
+  // use relocated() to follow it.
+  // Returns false if the temporary bitmap couldn't be allocated, in which case
+  // nothing changed.
+  bool compact(Allocator* allocator, SlotCount& liveSlots) {
+    auto total = usage();
+    SlotCount freeSlots = 0;
+    for (auto id = freeList_; id != NULL_SLOT; id = freeSlotAt(id)->next)
+      freeSlots++;
+    liveSlots = SlotCount(total - freeSlots);
+    if (freeSlots == 0)
+      return true;
+
+    // the free slots after liveSlots are flagged in a bitmap, the ones before
+    // (the holes) stay in a list
+    size_t bitmapSize = (freeSlots + 7u) / 8u;
+    auto bitmap = reinterpret_cast<uint8_t*>(allocator->allocate(bitmapSize));
+    if (!bitmap)
+      return false;
+    memset(bitmap, 0, bitmapSize);
+
+    SlotId holes = NULL_SLOT;
+    for (auto id = freeList_; id != NULL_SLOT;) {
+      auto slot = freeSlotAt(id);
+      auto next = slot->next;
+      auto position = positionOf(id);
+      if (position < liveSlots) {
+        slot->next = holes;
+        holes = id;
+      } else {
+        auto bit = SlotCount(position - liveSlots);
+        bitmap[bit / 8] = uint8_t(bitmap[bit / 8] | (1 << (bit % 8)));
+      }
+      id = next;
+    }
+
+    // move each live slot after liveSlots to a hole
+    SlotCount position = 0;
+    for (PoolCount i = 0; i < count_; i++) {
+      auto poolUsage = pools_[i].usage();
+      for (SlotCount index = 0; index < poolUsage; index++, position++) {
+        if (position < liveSlots)
+          continue;
+        auto bit = SlotCount(position - liveSlots);
+        if (bitmap[bit / 8] & (1 << (bit % 8)))
+          continue;
+        ARDUINOJSON_ASSERT(holes != NULL_SLOT);
+        auto target = holes;
+        auto hole = freeSlotAt(target);
+        holes = hole->next;
+        auto slot = pools_[i].getSlot(index);
+        memcpy(static_cast<void*>(hole), slot, sizeof(T));
+        reinterpret_cast<FreeSlot*>(slot)->next = target;
+      }
+    }
+    ARDUINOJSON_ASSERT(holes == NULL_SLOT);
+
+    allocator->deallocate(bitmap);
+    freeList_ = NULL_SLOT;
+    return true;
+  }
+
+  // Returns the id of a slot after compact()
+  SlotId relocated(SlotId id, SlotCount liveSlots) const {
+    if (id == NULL_SLOT || positionOf(id) < liveSlots)
+      return id;
+    return freeSlotAt(id)->next;
+  }
+
+  // Releases the slots after liveSlots, and the pools that become empty
+  void truncate(SlotCount liveSlots, Allocator* allocator) {
+    ARDUINOJSON_ASSERT(freeList_ == NULL_SLOT);
+    PoolCount poolCount = 0;
+    while (liveSlots > 0) {
+      ARDUINOJSON_ASSERT(poolCount < count_);
+      auto poolUsage = pools_[poolCount++].usage();
+      if (liveSlots <= poolUsage) {
+        pools_[poolCount - 1].truncate(liveSlots);
+        break;
+      }
+      liveSlots = SlotCount(liveSlots - poolUsage);
+    }
+    for (PoolCount i = poolCount; i < allocated_; i++)
+      pools_[i].destroy(allocator);
+    count_ = poolCount;
+    allocated_ = poolCount;
+  }
+
   void shrinkToFit(Allocator* allocator) {
+    for (PoolCount i = count_; i < allocated_; i++)
+      pools_[i].destroy(allocator);
+    allocated_ = count_;
     if (count_ > 0)
       pools_[count_ - 1].shrinkToFit(allocator);
     if (pools_ != preallocatedPools_ && count_ != capacity_) {
@@ -149,6 +262,19 @@ class MemoryPoolList {
   }
 
  private:
+  FreeSlot* freeSlotAt(SlotId id) const {
+    return reinterpret_cast<FreeSlot*>(getSlot(id));
+  }
+
+  // Returns the position of a slot, counting the slots of the pools end to end
+  SlotCount positionOf(SlotId id) const {
+    auto poolIndex = PoolCount(id / ARDUINOJSON_POOL_CAPACITY);
+    auto position = SlotCount(id % ARDUINOJSON_POOL_CAPACITY);
+    for (PoolCount i = 0; i < poolIndex; i++)
+      position = SlotCount(position + pools_[i].usage());
+    return position;
+  }
+
   Slot<T> allocFromFreeList() {
     ARDUINOJSON_ASSERT(freeList_ != NULL_SLOT);
     auto id = freeList_;
@@ -168,16 +294,26 @@ class MemoryPoolList {
   }
 
   Pool* addPool(Allocator* allocator) {
+    if (count_ < allocated_) {  // reuse a pool kept by recycle()
+      auto pool = &pools_[count_++];
+      pool->clear();
+      return pool;
+    }
     if (count_ == capacity_ && !increaseCapacity(allocator))
       return nullptr;
     auto pool = &pools_[count_++];
-    SlotCount poolCapacity = ARDUINOJSON_POOL_CAPACITY;
-    if (count_ == maxPools)  // last pool is smaller because of NULL_SLOT
-      poolCapacity--;
-    pool->create(poolCapacity, allocator);
+    pool->create(poolCapacity(count_), allocator);
+    allocated_ = count_;
     return pool;
   }
 
+  // Returns the capacity of the pool that makes the list count pools long
+  static SlotCount poolCapacity(PoolCount count) {
+    if (count == maxPools)  // last pool is smaller because of NULL_SLOT
+      return SlotCount(ARDUINOJSON_POOL_CAPACITY - 1);
+    return ARDUINOJSON_POOL_CAPACITY;
+  }
+
   bool increaseCapacity(Allocator* allocator) {
     if (capacity_ == maxPools)
       return false;
@@ -203,6 +339,7 @@ class MemoryPoolList {
   Pool preallocatedPools_[ARDUINOJSON_INITIAL_POOL_COUNT];
   Pool* pools_ = preallocatedPools_;
   PoolCount count_ = 0;
+  PoolCount allocated_ = 0;  // count_ + pools kept by recycle()
   PoolCount capacity_ = ARDUINOJSON_INITIAL_POOL_COUNT;
   SlotId freeList_ = NULL_SLOT;
 
@@ -29,7 +29,7 @@ class ResourceManager {
   constexpr static size_t slotSize = sizeof(SlotData);
 
   ResourceManager(Allocator* allocator = DefaultAllocator::instance())
-      : allocator_(allocator), overflowed_(false) {}
+      : allocator_(allocator), overflowed_(false), retainMemory_(false) {}
 
   ~ResourceManager() {
     stringPool_.clear(allocator_);
@@ -44,6 +44,7 @@ class ResourceManager {
     swap(a.variantPools_, b.variantPools_);
     swap_(a.allocator_, b.allocator_);
     swap_(a.overflowed_, b.overflowed_);
+    swap_(a.retainMemory_, b.retainMemory_);
   }
 
   Allocator* allocator() const {
@@ -58,6 +59,14 @@ class ResourceManager {
     return overflowed_;
   }
 
+  bool retainsMemory() const {
+    return retainMemory_;
+  }
+
+  void retainMemory(bool value) {
+    retainMemory_ = value;
+  }
+
   Slot<VariantData> allocVariant();
   void freeVariant(Slot<VariantData> slot);
   VariantData* getVariant(SlotId id) const;
@@ -112,7 +121,10 @@ class ResourceManager {
   }
 
   void clear() {
-    variantPools_.clear(allocator_);
+    if (retainMemory_)
+      variantPools_.recycle(allocator_);
+    else
+      variantPools_.clear(allocator_);
     overflowed_ = false;
     stringPool_.clear(allocator_);
   }
@@ -121,9 +133,20 @@ class ResourceManager {
     variantPools_.shrinkToFit(allocator_);
   }
 
+  // Moves the live slots into the fewest pools and releases the others.
+  // The ids in the tree under root are rewritten; other references to the
+  // slots become invalid.
+  bool garbageCollect(VariantData* root);
+
+  // Returns the id of a slot during garbageCollect()
+  SlotId relocatedSlot(SlotId id, SlotCount liveSlots) const {
+    return variantPools_.relocated(id, liveSlots);
+  }
+
  private:
   Allocator* allocator_;
   bool overflowed_;
+  bool retainMemory_;
   StringPool stringPool_;
   MemoryPoolList<SlotData> variantPools_;
 };
@@ -29,6 +29,16 @@ inline VariantData* ResourceManager::getVariant(SlotId id) const {
   return reinterpret_cast<VariantData*>(variantPools_.getSlot(id));
 }
 
+inline bool ResourceManager::garbageCollect(VariantData* root) {
+  SlotCount liveSlots;
+  if (!variantPools_.compact(allocator_, liveSlots))
+    return false;
+  if (root)
+    root->relocateSlots(this, liveSlots);
+  variantPools_.truncate(liveSlots, allocator_);
+  return true;
+}
+
 #if ARDUINOJSON_USE_EXTENSIONS
 inline Slot<VariantExtension> ResourceManager::allocExtension() {
   auto p = variantPools_.allocSlot(allocator_);
@@ -32,6 +32,30 @@ class StringBuffer {
     return node_->data;
   }
 
+  // Appends n bytes to the string started by reserve(), and returns a pointer
+  // to them.
+  // The capacity grows geometrically, like in StringBuilder, so that a string
+  // made of many small chunks isn't reallocated for each of them; save()
+  // trims the excess.
+  char* extend(size_t n) {
+    ARDUINOJSON_ASSERT(node_ != nullptr);
+    auto newSize = size_ + n;
+    if (newSize < n)  // integer overflow
+      return nullptr;
+    if (newSize > node_->length) {
+      auto capacity = size_t(node_->length) * 2U + 1;
+      if (capacity < newSize || capacity > StringNode::maxLength)
+        capacity = newSize;
+      node_ = resources_->resizeString(node_, capacity);
+      if (!node_)
+        return nullptr;
+    }
+    auto p = node_->data + size_;
+    size_ = newSize;
+    node_->data[size_] = 0;
+    return p;
+  }
+
   StringNode* save() {
     ARDUINOJSON_ASSERT(node_ != nullptr);
     node_->data[size_] = 0;
@@ -55,7 +79,7 @@ class StringBuffer {
   JsonString str() const {
     ARDUINOJSON_ASSERT(node_ != nullptr);
 
-    return JsonString(node_->data, node_->length);
+    return JsonString(node_->data, size_);
   }
 
  private:
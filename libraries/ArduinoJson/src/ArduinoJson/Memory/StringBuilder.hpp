@@ -77,4 +77,10 @@ class StringBuilder {
   size_t size_ = 0;
 };
 
+// The string builder used by the deserializers, depending on the reader
+template <typename TReader>
+struct StringBuilderFor {
+  using type = StringBuilder;
+};
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
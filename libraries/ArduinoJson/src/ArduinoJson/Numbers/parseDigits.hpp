@@ -0,0 +1,45 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+#include <ArduinoJson/Polyfills/ctype.hpp>
+
+#include <stddef.h>  // size_t
+#include <stdint.h>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+inline size_t countDigits(const char* s) {
+  const char* p = s;
+  while (isdigit(*p))
+    p++;
+  return size_t(p - s);
+}
+
+// Converts 8 decimal digits in a single pass (SWAR: SIMD within a register)
+// The caller must ensure that the 8 characters are digits.
+inline uint32_t parseEightDigits(const char* s) {
+  uint64_t val = 0;
+  for (uint8_t i = 0; i < 8; i++)  // compilers turn this into a single load
+    val |= uint64_t(uint8_t(s[i])) << (8 * i);
+  val = ((val & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+  val = ((val & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+  return uint32_t(((val & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+}
+
+// Converts n decimal digits, 8 at a time
+// The caller must ensure that the result fits in T.
+template <typename T>
+inline T parseDigits(const char* s, size_t n) {
+  T result = 0;
+  for (; n >= 8; n -= 8, s += 8)
+    result = T(result * 100000000 + parseEightDigits(s));
+  for (; n > 0; n--, s++)
+    result = T(result * 10 + uint8_t(*s - '0'));
+  return result;
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -7,6 +7,7 @@
 #include <ArduinoJson/Numbers/FloatTraits.hpp>
 #include <ArduinoJson/Numbers/JsonFloat.hpp>
 #include <ArduinoJson/Numbers/convertNumber.hpp>
+#include <ArduinoJson/Numbers/parseDigits.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/ctype.hpp>
 #include <ArduinoJson/Polyfills/math.hpp>
@@ -138,6 +139,15 @@ inline Number parseNumber(const char* s) {
   mantissa_t mantissa = 0;
   exponent_t exponent_offset = 0;
   const mantissa_t maxUint = JsonUInt(-1);
+  bool exact = true;  // false if digits were dropped from the mantissa
+
+  // fast path: when the integral part can't overflow, convert 8 digits at once
+  const size_t safeDigits = sizeof(JsonUInt) >= 8 ? 19 : 9;
+  size_t digits = countDigits(s);
+  if (digits <= safeDigits) {
+    mantissa = parseDigits<mantissa_t>(s, digits);
+    s += digits;
+  }
 
   while (isdigit(*s)) {
     uint8_t digit = uint8_t(*s - '0');
@@ -164,12 +174,16 @@ inline Number parseNumber(const char* s) {
 
   // avoid mantissa overflow
   while (mantissa > traits::mantissa_max) {
+    if (mantissa % 10)
+      exact = false;
     mantissa /= 10;
     exponent_offset++;
   }
 
   // remaing digits can't fit in the mantissa
   while (isdigit(*s)) {
+    if (*s != '0')
+      exact = false;
     exponent_offset++;
     s++;
   }
@@ -180,6 +194,8 @@ inline Number parseNumber(const char* s) {
       if (mantissa < traits::mantissa_max / 10) {
         mantissa = mantissa * 10 + uint8_t(*s - '0');
         exponent_offset--;
+      } else if (*s != '0') {
+        exact = false;
       }
       s++;
     }
@@ -220,12 +236,12 @@ inline Number parseNumber(const char* s) {
                   exponent > FloatTraits<float>::exponent_max ||
                   mantissa > FloatTraits<float>::mantissa_max;
   if (isDouble) {
-    auto final_result = make_float(double(mantissa), exponent);
+    auto final_result = make_float<double>(mantissa, exponent, exact);
     return Number(is_negative ? -final_result : final_result);
   } else
 #endif
   {
-    auto final_result = make_float(float(mantissa), exponent);
+    auto final_result = make_float<float>(mantissa, exponent, exact);
     return Number(is_negative ? -final_result : final_result);
   }
 }
@@ -557,6 +557,9 @@ class VariantData {
       return;
     var->clear(resources);
   }
+
+  // Updates the slot ids after ResourceManager::garbageCollect() moved them
+  void relocateSlots(const ResourceManager* resources, SlotCount liveSlots);
 };
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -56,6 +56,18 @@ inline void VariantData::clear(ResourceManager* resources) {
   type_ = VariantType::Null;
 }
 
+inline void VariantData::relocateSlots(const ResourceManager* resources,
+                                       SlotCount liveSlots) {
+#if ARDUINOJSON_USE_EXTENSIONS
+  if (type_ & VariantTypeBits::ExtensionBit)
+    content_.asSlotId = resources->relocatedSlot(content_.asSlotId, liveSlots);
+#endif
+
+  auto collection = asCollection();
+  if (collection)
+    collection->relocateSlots(resources, liveSlots);
+}
+
 #if ARDUINOJSON_USE_EXTENSIONS
 inline const VariantExtension* VariantData::getExtension(
     const ResourceManager* resources) const {
@@ -0,0 +1,60 @@
+/*
+  Base64 benchmark
+
+  Encodes and decodes a block of random data repeatedly, checks that it
+  survived the round trip, and prints the speed in MB/s
+
+  created 18 Oct 2026
+
+  this example is in the public domain
+ */
+#include <Base64Codec.h>
+
+#if defined(__AVR__)
+const size_t kBlockSize = 192;
+#else
+const size_t kBlockSize = 3072;
+#endif
+const int kRepeats = 50;
+
+uint8_t data[kBlockSize];
+char encoded[kBlockSize / 3 * 4];
+uint8_t decoded[kBlockSize];
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial);
+
+  for (size_t i = 0; i < kBlockSize; i++) {
+    data[i] = random(256);
+  }
+}
+
+void loop() {
+  unsigned long start = micros();
+  for (int i = 0; i < kRepeats; i++) {
+    base64Encode(data, kBlockSize, encoded);
+  }
+  unsigned long encodeTime = micros() - start;
+
+  start = micros();
+  int len = 0;
+  for (int i = 0; i < kRepeats; i++) {
+    len = base64Decode(encoded, sizeof(encoded), decoded);
+  }
+  unsigned long decodeTime = micros() - start;
+
+  if (len != (int)kBlockSize || memcmp(data, decoded, kBlockSize) != 0) {
+    Serial.println("Round trip failed!");
+  }
+
+  // bytes per microsecond is MB/s
+  float megabytes = (float)kBlockSize * kRepeats;
+  Serial.print("encode: ");
+  Serial.print(megabytes / encodeTime);
+  Serial.print(" MB/s, decode: ");
+  Serial.print(megabytes / decodeTime);
+  Serial.println(" MB/s");
+
+  delay(5000);
+}
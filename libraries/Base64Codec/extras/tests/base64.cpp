@@ -0,0 +1,330 @@
+// Base64Codec against a plain reference implementation: random data of
+// every length, in random pieces, with and without line breaks, and the
+// broken and badly padded inputs decoding has to reject.  Built once for each
+// code path, see CMakeLists.txt
+// Released under Apache License, version 2.0
+
+#include <Base64Codec.h>
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "check.h"
+
+static const Base64Alphabet kAlphabets[] = {BASE64_STANDARD, BASE64_URL, BASE64_URL_PADDED};
+
+// The same data at every run
+static uint32_t seed = 1;
+static uint32_t randomBelow(uint32_t aMax)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % aMax;
+}
+
+static std::string randomData(size_t aLength)
+{
+    std::string data(aLength, '\0');
+    for (size_t i = 0; i < aLength; i++)
+        data[i] = (char)randomBelow(256);
+    return data;
+}
+
+// A byte at a time, straight from RFC 4648
+static std::string reference(const std::string& aData, Base64Alphabet aAlphabet, size_t aLineLength = 0)
+{
+    const char* alphabet = aAlphabet == BASE64_STANDARD
+        ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+        : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    std::string encoded;
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (unsigned char c : aData)
+    {
+        bits = (bits << 8) | c;
+        bitCount += 8;
+        while (bitCount >= 6)
+        {
+            bitCount -= 6;
+            encoded += alphabet[(bits >> bitCount) & 0x3f];
+        }
+    }
+    if (bitCount > 0)
+        encoded += alphabet[(bits << (6 - bitCount)) & 0x3f];
+    if (aAlphabet != BASE64_URL)
+    {
+        while (encoded.size() % 4)
+            encoded += '=';
+    }
+
+    size_t lineLength = aLineLength & ~(size_t)3;
+    if (lineLength == 0)
+        return encoded;
+    std::string lines;
+    for (size_t i = 0; i < encoded.size(); i += lineLength)
+    {
+        if (i > 0)
+            lines += "\r\n";
+        lines += encoded.substr(i, lineLength);
+    }
+    return lines;
+}
+
+static std::string encode(const std::string& aData, Base64Alphabet aAlphabet)
+{
+    std::vector<char> out(base64EncodedLength(aData.size(), aAlphabet) + 1, '#');
+    size_t len = base64Encode((const uint8_t*)aData.data(), aData.size(), out.data(), aAlphabet);
+    REQUIRE(len == base64EncodedLength(aData.size(), aAlphabet));
+    // nothing written past the end
+    REQUIRE(out[len] == '#');
+    return std::string(out.data(), len);
+}
+
+// @return The decoded data, or "<invalid>"
+static std::string decode(const std::string& aEncoded, Base64Alphabet aAlphabet)
+{
+    std::vector<uint8_t> out(base64DecodedLength(aEncoded.size()) + 1, '#');
+    int len = base64Decode(aEncoded.data(), aEncoded.size(), out.data(), aAlphabet);
+    if (len == BASE64_ERROR_INVALID)
+        return "<invalid>";
+    REQUIRE(len >= 0 && (size_t)len <= base64DecodedLength(aEncoded.size()));
+    REQUIRE(out[base64DecodedLength(aEncoded.size())] == '#');
+    return std::string((const char*)out.data(), len);
+}
+
+// Splits aLength into random pieces, some of them empty or a single byte
+static std::vector<size_t> randomPieces(size_t aLength)
+{
+    std::vector<size_t> pieces;
+    while (aLength > 0)
+    {
+        size_t piece = randomBelow(4) == 0 ? randomBelow(3) : randomBelow(200);
+        if (piece > aLength)
+            piece = aLength;
+        pieces.push_back(piece);
+        aLength -= piece;
+    }
+    return pieces;
+}
+
+static std::string encodeInPieces(const std::string& aData, Base64Alphabet aAlphabet, size_t aLineLength)
+{
+    Base64Encoder encoder(aAlphabet, aLineLength);
+    std::string encoded;
+    size_t pos = 0;
+    for (size_t piece : randomPieces(aData.size()))
+    {
+        size_t most = encoder.updateLength(piece);
+        std::vector<char> out(most + 1, '#');
+        size_t len = encoder.update((const uint8_t*)aData.data() + pos, piece, out.data());
+        REQUIRE(len <= most);
+        REQUIRE(out[most] == '#');
+        encoded.append(out.data(), len);
+        pos += piece;
+    }
+    char tail[Base64Encoder::kEndLength + 1];
+    tail[Base64Encoder::kEndLength] = '#';
+    size_t len = encoder.end(tail);
+    REQUIRE(len <= Base64Encoder::kEndLength && tail[Base64Encoder::kEndLength] == '#');
+    return encoded + std::string(tail, len);
+}
+
+static std::string decodeInPieces(const std::string& aEncoded, Base64Alphabet aAlphabet)
+{
+    Base64Decoder decoder(aAlphabet);
+    std::string decoded;
+    size_t pos = 0;
+    for (size_t piece : randomPieces(aEncoded.size()))
+    {
+        size_t most = decoder.updateLength(piece);
+        std::vector<uint8_t> out(most + 1, '#');
+        int len = decoder.update(aEncoded.data() + pos, piece, out.data());
+        if (len == BASE64_ERROR_INVALID)
+            return "<invalid>";
+        REQUIRE((size_t)len <= most);
+        REQUIRE(out[most] == '#');
+        decoded.append((const char*)out.data(), len);
+        pos += piece;
+    }
+    uint8_t tail[Base64Decoder::kEndLength];
+    int len = decoder.end(tail);
+    if (len == BASE64_ERROR_INVALID)
+        return "<invalid>";
+    return decoded + std::string((const char*)tail, len);
+}
+
+static void testVectors()
+{
+    // RFC 4648 section 10
+    const char* vectors[][2] = {{"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"},
+                                {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"}};
+    for (auto& vector : vectors)
+    {
+        REQUIRE(encode(vector[0], BASE64_STANDARD) == vector[1]);
+        REQUIRE(decode(vector[1], BASE64_STANDARD) == vector[0]);
+    }
+
+    // the two characters the alphabets differ in
+    const std::string data("\xfb\xff\xbf", 3);
+    REQUIRE(encode(data, BASE64_STANDARD) == "+/+/");
+    REQUIRE(encode(data, BASE64_URL) == "-_-_");
+    REQUIRE(encode("\xfb\xff", BASE64_URL) == "-_8");
+    REQUIRE(encode("\xfb\xff", BASE64_URL_PADDED) == "-_8=");
+    REQUIRE(decode("-_8", BASE64_URL) == "\xfb\xff");
+    REQUIRE(decode("-_8=", BASE64_URL) == "\xfb\xff");
+    REQUIRE(decode("+/8=", BASE64_URL) == "<invalid>");
+    REQUIRE(decode("-_8=", BASE64_STANDARD) == "<invalid>");
+}
+
+static void testRandom()
+{
+    // every length up to a few vector blocks, then some long ones
+    std::vector<size_t> lengths;
+    for (size_t length = 0; length <= 200; length++)
+        lengths.push_back(length);
+    for (int i = 0; i < 20; i++)
+        lengths.push_back(200 + randomBelow(5000));
+
+    for (size_t length : lengths)
+    {
+        const std::string data = randomData(length);
+        for (Base64Alphabet alphabet : kAlphabets)
+        {
+            const std::string expected = reference(data, alphabet);
+            REQUIRE(encode(data, alphabet) == expected);
+            REQUIRE(decode(expected, alphabet) == data);
+            REQUIRE(encodeInPieces(data, alphabet, 0) == expected);
+            REQUIRE(decodeInPieces(expected, alphabet) == data);
+        }
+    }
+}
+
+static void testLines()
+{
+    // the MIME length, a single group, one which isn't a multiple of 4,
+    // and one longer than the vector blocks
+    const size_t lineLengths[] = {BASE64_MIME_LINE_LENGTH, 4, 5, 77, 200};
+    for (int i = 0; i < 200; i++)
+    {
+        const std::string data = randomData(randomBelow(i < 100 ? 300 : 3000));
+        for (size_t lineLength : lineLengths)
+        {
+            const std::string expected = reference(data, BASE64_STANDARD, lineLength);
+            const std::string encoded = encodeInPieces(data, BASE64_STANDARD, lineLength);
+            REQUIRE(encoded == expected);
+            REQUIRE(encoded.size() < 2 || encoded.substr(encoded.size() - 2) != "\r\n");
+
+            // the line breaks are skipped, wherever the pieces split them
+            REQUIRE(decode(encoded, BASE64_STANDARD) == data);
+            REQUIRE(decodeInPieces(encoded, BASE64_STANDARD) == data);
+        }
+    }
+
+    // an encoder can be used again after end()
+    Base64Encoder encoder(BASE64_STANDARD, BASE64_MIME_LINE_LENGTH);
+    for (int i = 0; i < 3; i++)
+    {
+        char out[300];
+        size_t len = encoder.update((const uint8_t*)"foobar and more", 15, out);
+        len += encoder.end(out + len);
+        REQUIRE(std::string(out, len) == "Zm9vYmFyIGFuZCBtb3Jl");
+    }
+}
+
+static void testWhitespace()
+{
+    // spaces, tabs and line breaks anywhere, also between the padding
+    for (int i = 0; i < 200; i++)
+    {
+        const std::string data = randomData(randomBelow(500));
+        std::string encoded = reference(data, BASE64_STANDARD);
+        for (int spaces = randomBelow(10); spaces > 0; spaces--)
+            encoded.insert(randomBelow(encoded.size() + 1), 1, " \t\r\n"[randomBelow(4)]);
+        REQUIRE(decode(encoded, BASE64_STANDARD) == data);
+        REQUIRE(decodeInPieces(encoded, BASE64_STANDARD) == data);
+    }
+    REQUIRE(decode("Zm\r\n9v Yg =\t=\r\n", BASE64_STANDARD) == "foob");
+}
+
+static void testPadding()
+{
+    // padding is optional
+    REQUIRE(decode("Zg", BASE64_STANDARD) == "f");
+    REQUIRE(decode("Zm8", BASE64_STANDARD) == "fo");
+    REQUIRE(decode("Zg==", BASE64_URL) == "f");
+
+    // but must be complete, and only where a group can end
+    REQUIRE(decode("Zg=", BASE64_STANDARD) == "<invalid>");
+    REQUIRE(decode("Z===", BASE64_STANDARD) == "<invalid>");
+    REQUIRE(decode("Zm9v=", BASE64_STANDARD) == "<invalid>");
+    REQUIRE(decode("=", BASE64_STANDARD) == "<invalid>");
+    REQUIRE(decode("Zm8==", BASE64_STANDARD) == "<invalid>");
+
+    // nothing but whitespace after it
+    REQUIRE(decode("Zg==Zg==", BASE64_STANDARD) == "<invalid>");
+    REQUIRE(decode("Zg==\r\n", BASE64_STANDARD) == "f");
+
+    // a single character left over can't be a byte
+    REQUIRE(decode("Z", BASE64_STANDARD) == "<invalid>");
+    REQUIRE(decode("Zm9vY", BASE64_STANDARD) == "<invalid>");
+
+    // a group split over pieces, as in the lines of a mail: nothing comes out
+    // until it's complete
+    Base64Decoder decoder;
+    uint8_t out[8];
+    REQUIRE(decoder.update("Zm", 2, out) == 0);
+    REQUIRE(decoder.update("9vY", 3, out) == 3 && memcmp(out, "foo", 3) == 0);
+    REQUIRE(decoder.update("g=", 2, out) == 0);
+    REQUIRE(decoder.update("=", 1, out) == 1 && out[0] == 'b');
+    REQUIRE(decoder.end(out) == 0);
+}
+
+static void testInvalid()
+{
+    const std::string invalid[] = {"Zm9v!", "Zm*v", "Zm9v\x80Zg==", "Zm9v-_", std::string("Zm9v\0Zg==", 9), "Zm,9"};
+    for (const std::string& encoded : invalid)
+        REQUIRE(decode(encoded, BASE64_STANDARD) == "<invalid>");
+    REQUIRE(decode("Zm9v+/", BASE64_URL) == "<invalid>");
+
+    // a bad character anywhere in a long input, for the vector paths to find
+    const std::string data = randomData(300);
+    const std::string encoded = reference(data, BASE64_STANDARD);
+    const char bad[] = {'!', '-', '_', '.', '\x80', '\xff', '\0', '='};
+    for (size_t pos = 0; pos < encoded.size() - 2; pos++)
+    {
+        std::string broken = encoded;
+        broken[pos] = bad[pos % sizeof(bad)];
+        REQUIRE(decode(broken, BASE64_STANDARD) == "<invalid>");
+        REQUIRE(decodeInPieces(broken, BASE64_STANDARD) == "<invalid>");
+    }
+
+    // and the decoder stays failed until begin()
+    Base64Decoder decoder;
+    uint8_t out[8];
+    REQUIRE(decoder.update("Zm!v", 4, out) == BASE64_ERROR_INVALID);
+    REQUIRE(decoder.update("Zm9v", 4, out) == BASE64_ERROR_INVALID);
+    REQUIRE(decoder.end(out) == BASE64_ERROR_INVALID);
+    REQUIRE(decoder.update("Zm9v", 4, out) == 3);
+    decoder.update("Zm!v", 4, out);
+    decoder.begin();
+    REQUIRE(decoder.update("Zm9v", 4, out) == 3 && memcmp(out, "foo", 3) == 0);
+}
+
+int main()
+{
+#if defined(__AVX2__)
+    if (!__builtin_cpu_supports("avx2"))
+        return 77;
+#elif defined(__SSSE3__)
+    if (!__builtin_cpu_supports("ssse3"))
+        return 77;
+#endif
+    testVectors();
+    testRandom();
+    testLines();
+    testWhitespace();
+    testPadding();
+    testInvalid();
+    return 0;
+}
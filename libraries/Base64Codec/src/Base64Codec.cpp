@@ -0,0 +1,604 @@
+// Base64 and base64url encoding and decoding
+// Released under Apache License, version 2.0
+
+#include "Base64Codec.h"
+
+#include <string.h>
+
+// The tables live in flash on AVR, where there's little RAM to spare.
+// Everywhere else they're read directly, which is faster (on the ESP8266
+// flash can only be read a word at a time)
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+  #define BASE64_TABLE PROGMEM
+  #define readTable(aTable, aIndex) pgm_read_byte(&(aTable)[aIndex])
+#else
+  #define BASE64_TABLE
+  #define readTable(aTable, aIndex) ((aTable)[aIndex])
+#endif
+
+// Processors with 32-bit registers encode and decode a word at a time,
+// unless BASE64_WORD_AT_A_TIME is defined as 0 (e.g. to test the byte path)
+#if !defined(BASE64_WORD_AT_A_TIME)
+  #if !defined(__AVR__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    #define BASE64_WORD_AT_A_TIME 1
+  #endif
+#endif
+
+// When built for a PC (e.g. for tests) the vector units are used if the
+// compiler has been told it can, e.g. with -march=native
+#if !defined(BASE64_NO_SIMD)
+  #if defined(__AVX2__)
+    #include <immintrin.h>
+    #define BASE64_AVX2 1
+  #endif
+  #if defined(__SSSE3__)
+    #include <tmmintrin.h>
+    #define BASE64_SSSE3 1
+  #endif
+#endif
+
+static const char kStandardAlphabet[64] BASE64_TABLE = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/' };
+
+static const char kUrlAlphabet[64] BASE64_TABLE = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '_' };
+
+// Values in the decoding tables for the characters which aren't in the
+// alphabet.  They all have the top bit set, so a group of 4 characters can
+// be checked in one go
+static const uint8_t kPadding = 0xfd;
+static const uint8_t kWhitespace = 0xfe;
+static const uint8_t kInvalid = 0xff;
+
+// Value of each ASCII character.  Anything above 127 is invalid
+static const uint8_t kStandardValues[128] BASE64_TABLE = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xfd, 0xff, 0xff,
+    0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+static const uint8_t kUrlValues[128] BASE64_TABLE = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xfd, 0xff, 0xff,
+    0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0x3f,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+static bool isUrl(Base64Alphabet aAlphabet)
+{
+    return aAlphabet != BASE64_STANDARD;
+}
+
+static bool isPadded(Base64Alphabet aAlphabet)
+{
+    return aAlphabet != BASE64_URL;
+}
+
+#if BASE64_SSSE3
+// Encode the 12 bytes at the start of each 16 byte lane, using Wojciech
+// Muła's method: spread each 3 bytes over 4 bytes, shift the 6-bit values
+// into place with multiplies, then turn them into characters by adding an
+// offset looked up from which range of the alphabet each is in
+static inline __m128i encodeBlock16(__m128i aInput, __m128i aOffsets)
+{
+    __m128i in = _mm_shuffle_epi8(aInput, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    __m128i lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    __m128i values = _mm_or_si128(hi, lo);
+
+    // 0 for a-z, 1-10 for 0-9, 11 and 12 for the last two, 13 for A-Z
+    __m128i range = _mm_subs_epu8(values, _mm_set1_epi8(51));
+    range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), values), _mm_set1_epi8(13)));
+    return _mm_add_epi8(values, _mm_shuffle_epi8(aOffsets, range));
+}
+
+static inline __m128i encodeOffsets(Base64Alphabet aAlphabet)
+{
+    char c62 = isUrl(aAlphabet) ? '-' : '+';
+    char c63 = isUrl(aAlphabet) ? '_' : '/';
+    return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                         '0' - 52, '0' - 52, '0' - 52, '0' - 52, c62 - 62, c63 - 63, 'A', 0, 0);
+}
+
+// Turn 16 characters into their 6-bit values
+// @return false if any of them isn't in the alphabet
+static inline bool decodeValues16(__m128i& aValues, char aC62, char aC63)
+{
+    __m128i s = aValues;
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(s, _mm_set1_epi8('Z' + 1)));
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(s, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(s, _mm_set1_epi8('9' + 1)));
+    __m128i is62 = _mm_cmpeq_epi8(s, _mm_set1_epi8(aC62));
+    __m128i is63 = _mm_cmpeq_epi8(s, _mm_set1_epi8(aC63));
+    __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+    if (_mm_movemask_epi8(valid) != 0xffff)
+    {
+        return false;
+    }
+    __m128i offset = _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                                  _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    offset = _mm_or_si128(offset, _mm_and_si128(is62, _mm_set1_epi8(62 - aC62)));
+    offset = _mm_or_si128(offset, _mm_and_si128(is63, _mm_set1_epi8(63 - aC63)));
+    aValues = _mm_add_epi8(s, offset);
+    return true;
+}
+
+// Join each 4 6-bit values into 3 bytes, at the start of the lane
+static inline __m128i packValues16(__m128i aValues)
+{
+    __m128i merged = _mm_maddubs_epi16(aValues, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+#endif
+
+#if BASE64_AVX2
+// The same as the SSSE3 versions, with the two lanes of an AVX2 register
+static inline __m256i encodeBlock32(__m256i aInput, __m256i aOffsets)
+{
+    const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                             1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    __m256i in = _mm256_shuffle_epi8(aInput, shuffle);
+    __m256i hi = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+    __m256i lo = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+    __m256i values = _mm256_or_si256(hi, lo);
+
+    __m256i range = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), values), _mm256_set1_epi8(13)));
+    return _mm256_add_epi8(values, _mm256_shuffle_epi8(aOffsets, range));
+}
+
+static inline bool decodeValues32(__m256i& aValues, char aC62, char aC63)
+{
+    __m256i s = aValues;
+    __m256i upper = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8('A'), s), _mm256_cmpgt_epi8(s, _mm256_set1_epi8('Z'))), _mm256_set1_epi8(-1));
+    __m256i lower = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8('a'), s), _mm256_cmpgt_epi8(s, _mm256_set1_epi8('z'))), _mm256_set1_epi8(-1));
+    __m256i digit = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8('0'), s), _mm256_cmpgt_epi8(s, _mm256_set1_epi8('9'))), _mm256_set1_epi8(-1));
+    __m256i is62 = _mm256_cmpeq_epi8(s, _mm256_set1_epi8(aC62));
+    __m256i is63 = _mm256_cmpeq_epi8(s, _mm256_set1_epi8(aC63));
+    __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(is62, is63)));
+    if (_mm256_movemask_epi8(valid) != -1)
+    {
+        return false;
+    }
+    __m256i offset = _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                                     _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+    offset = _mm256_or_si256(offset, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+    offset = _mm256_or_si256(offset, _mm256_and_si256(is62, _mm256_set1_epi8(62 - aC62)));
+    offset = _mm256_or_si256(offset, _mm256_and_si256(is63, _mm256_set1_epi8(63 - aC63)));
+    aValues = _mm256_add_epi8(s, offset);
+    return true;
+}
+
+static inline __m256i packValues32(__m256i aValues)
+{
+    __m256i merged = _mm256_maddubs_epi16(aValues, _mm256_set1_epi32(0x01400140));
+    merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    return _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+#endif
+
+// Encode whole groups of 3 bytes
+// @return End of the output
+static char* encodeGroups(const uint8_t* aInput, size_t aGroups, char* aOutput, Base64Alphabet aAlphabet)
+{
+    const char* alphabet = isUrl(aAlphabet) ? kUrlAlphabet : kStandardAlphabet;
+
+#if BASE64_AVX2
+    // Each load reads 4 bytes more than it uses
+    __m256i offsets256 = _mm256_broadcastsi128_si256(encodeOffsets(aAlphabet));
+    while (aGroups >= 10)
+    {
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)aInput)),
+                                             _mm_loadu_si128((const __m128i*)(aInput + 12)), 1);
+        _mm256_storeu_si256((__m256i*)aOutput, encodeBlock32(in, offsets256));
+        aInput += 24;
+        aOutput += 32;
+        aGroups -= 8;
+    }
+#endif
+#if BASE64_SSSE3
+    __m128i offsets = encodeOffsets(aAlphabet);
+    while (aGroups >= 6)
+    {
+        _mm_storeu_si128((__m128i*)aOutput, encodeBlock16(_mm_loadu_si128((const __m128i*)aInput), offsets));
+        aInput += 12;
+        aOutput += 16;
+        aGroups -= 4;
+    }
+#endif
+#if BASE64_WORD_AT_A_TIME
+    // 4 groups at a time: read the 12 bytes as 3 big-endian words and write
+    // the 16 characters as 4 words
+    while (aGroups >= 4)
+    {
+        uint32_t w[3];
+        memcpy(w, aInput, sizeof(w));
+        uint32_t w0 = __builtin_bswap32(w[0]);
+        uint32_t w1 = __builtin_bswap32(w[1]);
+        uint32_t w2 = __builtin_bswap32(w[2]);
+        uint32_t out[4];
+        out[0] = (uint32_t)alphabet[w0 >> 26]
+               | (uint32_t)alphabet[(w0 >> 20) & 0x3f] << 8
+               | (uint32_t)alphabet[(w0 >> 14) & 0x3f] << 16
+               | (uint32_t)alphabet[(w0 >> 8) & 0x3f] << 24;
+        out[1] = (uint32_t)alphabet[(w0 >> 2) & 0x3f]
+               | (uint32_t)alphabet[((w0 & 0x03) << 4) | (w1 >> 28)] << 8
+               | (uint32_t)alphabet[(w1 >> 22) & 0x3f] << 16
+               | (uint32_t)alphabet[(w1 >> 16) & 0x3f] << 24;
+        out[2] = (uint32_t)alphabet[(w1 >> 10) & 0x3f]
+               | (uint32_t)alphabet[(w1 >> 4) & 0x3f] << 8
+               | (uint32_t)alphabet[((w1 & 0x0f) << 2) | (w2 >> 30)] << 16
+               | (uint32_t)alphabet[(w2 >> 24) & 0x3f] << 24;
+        out[3] = (uint32_t)alphabet[(w2 >> 18) & 0x3f]
+               | (uint32_t)alphabet[(w2 >> 12) & 0x3f] << 8
+               | (uint32_t)alphabet[(w2 >> 6) & 0x3f] << 16
+               | (uint32_t)alphabet[w2 & 0x3f] << 24;
+        memcpy(aOutput, out, sizeof(out));
+        aInput += 12;
+        aOutput += 16;
+        aGroups -= 4;
+    }
+#endif
+    while (aGroups > 0)
+    {
+        aOutput[0] = readTable(alphabet, aInput[0] >> 2);
+        aOutput[1] = readTable(alphabet, ((aInput[0] & 0x03) << 4) | (aInput[1] >> 4));
+        aOutput[2] = readTable(alphabet, ((aInput[1] & 0x0f) << 2) | (aInput[2] >> 6));
+        aOutput[3] = readTable(alphabet, aInput[2] & 0x3f);
+        aInput += 3;
+        aOutput += 4;
+        aGroups--;
+    }
+    return aOutput;
+}
+
+// Decode whole groups of 4 characters, for as long as they're all in the
+// alphabet.  There must be room for 3 bytes for each 4 characters up to
+// aEnd
+// @return Number of bytes written
+static size_t decodeGroups(const char*& aInput, const char* aEnd, uint8_t* aOutput, Base64Alphabet aAlphabet)
+{
+    const uint8_t* values = isUrl(aAlphabet) ? kUrlValues : kStandardValues;
+    uint8_t* out = aOutput;
+
+#if BASE64_SSSE3 || BASE64_AVX2
+    char c62 = isUrl(aAlphabet) ? '-' : '+';
+    char c63 = isUrl(aAlphabet) ? '_' : '/';
+#endif
+#if BASE64_AVX2
+    // Each store writes 4 bytes more than it decodes, which the loop
+    // condition leaves room for
+    while (aEnd - aInput >= 48)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)aInput);
+        if (!decodeValues32(block, c62, c63))
+        {
+            break;
+        }
+        block = packValues32(block);
+        _mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(block));
+        _mm_storeu_si128((__m128i*)(out + 12), _mm256_extracti128_si256(block, 1));
+        aInput += 32;
+        out += 24;
+    }
+#endif
+#if BASE64_SSSE3
+    while (aEnd - aInput >= 24)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)aInput);
+        if (!decodeValues16(block, c62, c63))
+        {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)out, packValues16(block));
+        aInput += 16;
+        out += 12;
+    }
+#endif
+    while (aEnd - aInput >= 4)
+    {
+#if BASE64_WORD_AT_A_TIME
+        uint32_t w;
+        memcpy(&w, aInput, sizeof(w));
+        if (w & 0x80808080)
+        {
+            break;
+        }
+        uint8_t v0 = values[w & 0x7f];
+        uint8_t v1 = values[(w >> 8) & 0x7f];
+        uint8_t v2 = values[(w >> 16) & 0x7f];
+        uint8_t v3 = values[w >> 24];
+#else
+        uint8_t c0 = aInput[0];
+        uint8_t c1 = aInput[1];
+        uint8_t c2 = aInput[2];
+        uint8_t c3 = aInput[3];
+        if ((c0 | c1 | c2 | c3) & 0x80)
+        {
+            break;
+        }
+        uint8_t v0 = readTable(values, c0);
+        uint8_t v1 = readTable(values, c1);
+        uint8_t v2 = readTable(values, c2);
+        uint8_t v3 = readTable(values, c3);
+#endif
+        // Padding, whitespace and invalid characters all have the top bit set
+        if ((v0 | v1 | v2 | v3) & 0x80)
+        {
+            break;
+        }
+        out[0] = (v0 << 2) | (v1 >> 4);
+        out[1] = (v1 << 4) | (v2 >> 2);
+        out[2] = (v2 << 6) | v3;
+        aInput += 4;
+        out += 3;
+    }
+    return out - aOutput;
+}
+
+size_t base64EncodedLength(size_t aLength, Base64Alphabet aAlphabet)
+{
+    if (isPadded(aAlphabet))
+    {
+        return (aLength + 2) / 3 * 4;
+    }
+    return aLength / 3 * 4 + (aLength % 3 ? aLength % 3 + 1 : 0);
+}
+
+size_t base64DecodedLength(size_t aLength)
+{
+    return (aLength + 3) / 4 * 3;
+}
+
+size_t base64Encode(const uint8_t* aInput, size_t aLength, char* aOutput, Base64Alphabet aAlphabet)
+{
+    Base64Encoder encoder(aAlphabet);
+    size_t len = encoder.update(aInput, aLength, aOutput);
+    return len + encoder.end(aOutput + len);
+}
+
+int base64Decode(const char* aInput, size_t aLength, uint8_t* aOutput, Base64Alphabet aAlphabet)
+{
+    Base64Decoder decoder(aAlphabet);
+    int len = decoder.update(aInput, aLength, aOutput);
+    if (len < 0)
+    {
+        return len;
+    }
+    int tail = decoder.end(aOutput + len);
+    if (tail < 0)
+    {
+        return tail;
+    }
+    return len + tail;
+}
+
+Base64Encoder::Base64Encoder(Base64Alphabet aAlphabet, size_t aLineLength)
+ : iAlphabet(aAlphabet), iLineLength(aLineLength & ~(size_t)3)
+{
+    begin();
+}
+
+void Base64Encoder::begin()
+{
+    iColumn = 0;
+    iCarryLength = 0;
+}
+
+size_t Base64Encoder::updateLength(size_t aLength)
+{
+    size_t len = (iCarryLength + aLength) / 3 * 4;
+    if (iLineLength > 0 && len > 0)
+    {
+        // CR LF before each character which doesn't fit on the line
+        len += (iColumn + len - 1) / iLineLength * 2;
+    }
+    return len;
+}
+
+size_t Base64Encoder::update(const uint8_t* aInput, size_t aLength, char* aOutput)
+{
+    char* out = aOutput;
+
+    if (iCarryLength > 0)
+    {
+        // Finish the group left over from last time
+        while (iCarryLength < 3 && aLength > 0)
+        {
+            iCarry[iCarryLength++] = *aInput++;
+            aLength--;
+        }
+        if (iCarryLength < 3)
+        {
+            return 0;
+        }
+        out = putGroups(iCarry, 1, out);
+        iCarryLength = 0;
+    }
+
+    size_t groups = aLength / 3;
+    out = putGroups(aInput, groups, out);
+    aInput += groups * 3;
+    iCarryLength = aLength - groups * 3;
+    memcpy(iCarry, aInput, iCarryLength);
+
+    return out - aOutput;
+}
+
+size_t Base64Encoder::end(char* aOutput)
+{
+    char* out = aOutput;
+    if (iCarryLength > 0)
+    {
+        if (iLineLength > 0 && iColumn >= iLineLength)
+        {
+            *out++ = '\r';
+            *out++ = '\n';
+        }
+
+        const char* alphabet = isUrl(iAlphabet) ? kUrlAlphabet : kStandardAlphabet;
+        uint8_t b1 = iCarryLength > 1 ? iCarry[1] : 0;
+        *out++ = readTable(alphabet, iCarry[0] >> 2);
+        *out++ = readTable(alphabet, ((iCarry[0] & 0x03) << 4) | (b1 >> 4));
+        if (iCarryLength > 1)
+        {
+            *out++ = readTable(alphabet, (b1 & 0x0f) << 2);
+        }
+        if (isPadded(iAlphabet))
+        {
+            for (int i = iCarryLength; i < 3; i++)
+            {
+                *out++ = '=';
+            }
+        }
+    }
+    begin();
+    return out - aOutput;
+}
+
+char* Base64Encoder::putGroups(const uint8_t* aInput, size_t aGroups, char* aOutput)
+{
+    if (iLineLength == 0)
+    {
+        return encodeGroups(aInput, aGroups, aOutput, iAlphabet);
+    }
+
+    while (aGroups > 0)
+    {
+        if (iColumn >= iLineLength)
+        {
+            *aOutput++ = '\r';
+            *aOutput++ = '\n';
+            iColumn = 0;
+        }
+        size_t groups = (iLineLength - iColumn) / 4;
+        if (groups > aGroups)
+        {
+            groups = aGroups;
+        }
+        aOutput = encodeGroups(aInput, groups, aOutput, iAlphabet);
+        aInput += groups * 3;
+        aGroups -= groups;
+        iColumn += groups * 4;
+    }
+    return aOutput;
+}
+
+Base64Decoder::Base64Decoder(Base64Alphabet aAlphabet)
+ : iAlphabet(aAlphabet)
+{
+    begin();
+}
+
+void Base64Decoder::begin()
+{
+    iState = eData;
+    iCarry = 0;
+    iCarryLength = 0;
+    iPaddingLength = 0;
+}
+
+int Base64Decoder::update(const char* aInput, size_t aLength, uint8_t* aOutput)
+{
+    if (iState == eFailed)
+    {
+        return BASE64_ERROR_INVALID;
+    }
+
+    const uint8_t* values = isUrl(iAlphabet) ? kUrlValues : kStandardValues;
+    const char* end = aInput + aLength;
+    uint8_t* out = aOutput;
+    while (aInput < end)
+    {
+        if (iCarryLength == 0 && iState == eData)
+        {
+            out += decodeGroups(aInput, end, out, iAlphabet);
+            if (aInput == end)
+            {
+                break;
+            }
+        }
+
+        // Deal with the characters the fast path can't a character at a time
+        uint8_t c = *aInput++;
+        uint8_t value = c < 128 ? readTable(values, c) : kInvalid;
+        if (value < 64 && iState == eData)
+        {
+            iCarry = (iCarry << 6) | value;
+            if (++iCarryLength == 4)
+            {
+                out[0] = iCarry >> 16;
+                out[1] = iCarry >> 8;
+                out[2] = iCarry;
+                out += 3;
+                iCarry = 0;
+                iCarryLength = 0;
+            }
+        }
+        else if (value == kWhitespace)
+        {
+            continue;
+        }
+        else if (value == kPadding && iState != eDone && iCarryLength >= 2)
+        {
+            iState = ePadding;
+            if (iCarryLength + ++iPaddingLength == 4)
+            {
+                out += putTail(out);
+                iState = eDone;
+            }
+        }
+        else
+        {
+            iState = eFailed;
+            return BASE64_ERROR_INVALID;
+        }
+    }
+    return out - aOutput;
+}
+
+int Base64Decoder::end(uint8_t* aOutput)
+{
+    int ret = 0;
+    if (iState == eFailed || iState == ePadding || iCarryLength == 1)
+    {
+        ret = BASE64_ERROR_INVALID;
+    }
+    else if (iCarryLength > 0)
+    {
+        ret = putTail(aOutput);
+    }
+    begin();
+    return ret;
+}
+
+int Base64Decoder::putTail(uint8_t* aOutput)
+{
+    int len = iCarryLength - 1;
+    uint32_t bits = iCarry << (6 * (4 - iCarryLength));
+    aOutput[0] = bits >> 16;
+    if (len > 1)
+    {
+        aOutput[1] = bits >> 8;
+    }
+    iCarry = 0;
+    iCarryLength = 0;
+    return len;
+}
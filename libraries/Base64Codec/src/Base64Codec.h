@@ -0,0 +1,196 @@
+// Base64 and base64url encoding and decoding
+// Released under Apache License, version 2.0
+
+#ifndef Base64Codec_h
+#define Base64Codec_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** The flavours of base64 in RFC 4648
+*/
+typedef enum {
+    // A-Z a-z 0-9 + /, padded with '=' to a multiple of 4 characters, as
+    // used by MIME and HTTP Basic authentication
+    BASE64_STANDARD,
+    // - and _ instead of + and /, without padding, as used by JWT
+    BASE64_URL,
+    // - and _ instead of + and /, padded with '='
+    BASE64_URL_PADDED
+} Base64Alphabet;
+
+// Line length for MIME bodies (RFC 2045)
+static const size_t BASE64_MIME_LINE_LENGTH = 76;
+
+// The data wasn't valid base64
+static const int BASE64_ERROR_INVALID = -1;
+
+/** Return the number of characters base64Encode() produces
+  @param aLength   Number of bytes to encode
+  @param aAlphabet Alphabet they will be encoded with
+*/
+size_t base64EncodedLength(size_t aLength, Base64Alphabet aAlphabet = BASE64_STANDARD);
+
+/** Return the most bytes base64Decode() can produce
+  @param aLength Number of characters to decode
+*/
+size_t base64DecodedLength(size_t aLength);
+
+/** Encode a block of data in one go
+  @param aInput    Data to encode
+  @param aLength   Length of aInput
+  @param aOutput   Buffer for the result, which must hold
+                   base64EncodedLength(aLength, aAlphabet) characters.  It
+                   isn't NUL terminated
+  @param aAlphabet Alphabet to use
+  @return Number of characters written
+*/
+size_t base64Encode(const uint8_t* aInput, size_t aLength, char* aOutput, Base64Alphabet aAlphabet = BASE64_STANDARD);
+
+/** Decode a block of data in one go.  Whitespace (including line breaks)
+  is skipped, and the padding is optional
+  @param aInput    Characters to decode
+  @param aLength   Length of aInput
+  @param aOutput   Buffer for the result, which must hold
+                   base64DecodedLength(aLength) bytes
+  @param aAlphabet Alphabet aInput is encoded with
+  @return Number of bytes written, or BASE64_ERROR_INVALID
+*/
+int base64Decode(const char* aInput, size_t aLength, uint8_t* aOutput, Base64Alphabet aAlphabet = BASE64_STANDARD);
+
+/** Encodes data which arrives a piece at a time, e.g. a file read a block at
+    a time.  The bytes which don't make up a whole group of 3 are carried
+    over to the next update(), so the pieces can be any length.
+
+    Typical use:
+      Base64Encoder encoder(BASE64_STANDARD, BASE64_MIME_LINE_LENGTH);
+      uint8_t block[57];
+      char encoded[80];
+      while ((len = file.read(block, sizeof(block))) > 0)
+      {
+          client.write(encoded, encoder.update(block, len, encoded));
+      }
+      client.write(encoded, encoder.end(encoded));
+*/
+class Base64Encoder
+{
+public:
+    // Most characters end() writes
+    static const size_t kEndLength = 6;
+
+    /** Create an encoder
+      @param aAlphabet   Alphabet to use
+      @param aLineLength Number of characters to put on each line, rounded
+                         down to a multiple of 4, or 0 for a single line.
+                         Lines are separated by CR LF, and there isn't one
+                         after the last line
+    */
+    Base64Encoder(Base64Alphabet aAlphabet = BASE64_STANDARD, size_t aLineLength = 0);
+
+    /** Forget any data from a previous message
+    */
+    void begin();
+
+    /** Encode the next piece of the data
+      @param aInput  Data to encode
+      @param aLength Length of aInput
+      @param aOutput Buffer for the result, which must hold updateLength(aLength)
+                     characters
+      @return Number of characters written
+    */
+    size_t update(const uint8_t* aInput, size_t aLength, char* aOutput);
+
+    /** Encode the last bytes of the data, which didn't make up a whole group,
+      and their padding.  The encoder is then ready for another message
+      @param aOutput Buffer for the result, which must hold kEndLength
+                     characters
+      @return Number of characters written
+    */
+    size_t end(char* aOutput);
+
+    /** Return the most characters update() can write for aLength bytes
+    */
+    size_t updateLength(size_t aLength);
+
+protected:
+    /** Encode whole groups of 3 bytes, breaking the lines where needed
+      @return End of the output
+    */
+    char* putGroups(const uint8_t* aInput, size_t aGroups, char* aOutput);
+
+    Base64Alphabet iAlphabet;
+    size_t iLineLength;
+    // Characters on the current line
+    size_t iColumn;
+    uint8_t iCarry[3];
+    uint8_t iCarryLength;
+};
+
+/** Decodes data which arrives a piece at a time, e.g. the lines of a mail
+    body.  The characters which don't make up a whole group of 4 are carried
+    over to the next update(), so the pieces can be split anywhere.
+    Whitespace (including line breaks) is skipped, and the padding is
+    optional; anything else outside the alphabet is an error.
+*/
+class Base64Decoder
+{
+public:
+    // Most bytes end() writes
+    static const size_t kEndLength = 2;
+
+    /** Create a decoder
+      @param aAlphabet Alphabet the data is encoded with.  BASE64_URL and
+                       BASE64_URL_PADDED are the same when decoding
+    */
+    Base64Decoder(Base64Alphabet aAlphabet = BASE64_STANDARD);
+
+    /** Forget any data from a previous message
+    */
+    void begin();
+
+    /** Decode the next piece of the data
+      @param aInput  Characters to decode
+      @param aLength Length of aInput
+      @param aOutput Buffer for the result, which must hold updateLength(aLength)
+                     bytes
+      @return Number of bytes written, or BASE64_ERROR_INVALID (and every
+              later call fails too, until begin())
+    */
+    int update(const char* aInput, size_t aLength, uint8_t* aOutput);
+
+    /** Decode the last characters of unpadded data, and check that the data
+      didn't stop part way through a group.  The decoder is then ready for
+      another message
+      @param aOutput Buffer for the result, which must hold kEndLength bytes
+      @return Number of bytes written, or BASE64_ERROR_INVALID
+    */
+    int end(uint8_t* aOutput);
+
+    /** Return the most bytes update() can write for aLength characters
+    */
+    size_t updateLength(size_t aLength) { return (iCarryLength + iPaddingLength + aLength) / 4 * 3; };
+
+protected:
+    typedef enum {
+        eData,
+        // Some of the padding at the end has been read
+        ePadding,
+        // The padding is complete, only whitespace can follow
+        eDone,
+        eFailed
+    } tDecodeState;
+
+    /** Write the bytes of a group cut short by the end of the data
+      @return Number of bytes written
+    */
+    int putTail(uint8_t* aOutput);
+
+    Base64Alphabet iAlphabet;
+    tDecodeState iState;
+    // Characters of the current group read so far, 6 bits each
+    uint32_t iCarry;
+    uint8_t iCarryLength;
+    uint8_t iPaddingLength;
+};
+
+#endif
@@ -1812,87 +1812,43 @@ MB_String ESP_Mail_Client::getXOAUTH2String(const MB_String &email, const MB_Str
 
 unsigned char *ESP_Mail_Client::decodeBase64(const unsigned char *src, size_t len, size_t *out_len)
 {
-  unsigned char *out, *pos, block[4], tmp;
-  size_t i, count, olen;
-  int pad = 0;
-  size_t extra_pad;
+  // one more byte for the NUL terminator, as the result is often text
+  unsigned char *out = allocMem<unsigned char *>(base64DecodedLength(len) + 1);
 
-  unsigned char *dtable = allocMem<unsigned char *>(256);
-
-  memset(dtable, 0x80, 256);
+  if (out == NULL)
+    return nullptr;
 
-  for (i = 0; i < sizeof(b64_index_table) - 1; i++)
-    dtable[b64_index_table[i]] = (unsigned char)i;
-  dtable['='] = 0;
+  int olen = base64Decode((const char *)src, len, out);
 
-  count = 0;
-  for (i = 0; i < len; i++)
+  if (olen <= 0)
   {
-    if (dtable[src[i]] != 0x80)
-      count++;
+    // release memory
+    freeMem(&out);
+    return nullptr;
   }
 
-  if (count == 0)
-    goto exit;
-
-  extra_pad = (4 - count % 4) % 4;
-
-  olen = (count + extra_pad) / 4 * 3;
+  *out_len = olen;
+  return out;
+}
 
-  pos = out = allocMem<unsigned char *>(olen);
+unsigned char *ESP_Mail_Client::decodeBase64Line(Base64Decoder &decoder, const char *src, size_t len, size_t *out_len)
+{
+  unsigned char *out = allocMem<unsigned char *>(decoder.updateLength(len) + 1);
 
   if (out == NULL)
-    goto exit;
+    return nullptr;
 
-  count = 0;
+  int olen = decoder.update(src, len, out);
 
-  for (i = 0; i < len + extra_pad; i++)
+  if (olen <= 0)
   {
-    unsigned char val;
-
-    if (i >= len)
-      val = '=';
-    else
-      val = src[i];
-    tmp = dtable[val];
-    if (tmp == 0x80)
-      continue;
-
-    if (val == '=')
-      pad++;
-    block[count] = tmp;
-    count++;
-    if (count == 4)
-    {
-      *pos++ = (block[0] << 2) | (block[1] >> 4);
-      *pos++ = (block[1] << 4) | (block[2] >> 2);
-      *pos++ = (block[2] << 6) | block[3];
-      count = 0;
-      if (pad)
-      {
-        if (pad == 1)
-          pos--;
-        else if (pad == 2)
-          pos -= 2;
-        else
-        {
-          // release memory
-          free(out);
-          goto exit;
-        }
-        break;
-      }
-    }
+    // release memory
+    freeMem(&out);
+    return nullptr;
   }
 
-  *out_len = pos - out;
-  // release memory
-  freeMem(&dtable);
+  *out_len = olen;
   return out;
-exit:
-  // release memory
-  freeMem(&dtable);
-  return nullptr;
 }
 
 MB_String ESP_Mail_Client::encodeBase64Str(const unsigned char *src, size_t len)
@@ -1903,43 +1859,12 @@ MB_String ESP_Mail_Client::encodeBase64Str(const unsigned char *src, size_t len)
 MB_String ESP_Mail_Client::encodeBase64Str(uint8_t *src, size_t len)
 {
   MB_String outStr;
-  unsigned char *out, *pos;
-  const unsigned char *end, *in;
-  size_t olen = 4 * ((len + 2) / 3);
+  size_t olen = base64EncodedLength(len);
   if (olen < len)
     return outStr;
 
   outStr.resize(olen);
-  out = (unsigned char *)&outStr[0];
-
-  end = src + len;
-  in = src;
-  pos = out;
-
-  while (end - in >= 3)
-  {
-    *pos++ = b64_index_table[in[0] >> 2];
-    *pos++ = b64_index_table[((in[0] & 0x03) << 4) | (in[1] >> 4)];
-    *pos++ = b64_index_table[((in[1] & 0x0f) << 2) | (in[2] >> 6)];
-    *pos++ = b64_index_table[in[2] & 0x3f];
-    in += 3;
-  }
-
-  if (end - in)
-  {
-    *pos++ = b64_index_table[in[0] >> 2];
-    if (end - in == 1)
-    {
-      *pos++ = b64_index_table[(in[0] & 0x03) << 4];
-      *pos++ = '=';
-    }
-    else
-    {
-      *pos++ = b64_index_table[((in[0] & 0x03) << 4) | (in[1] >> 4)];
-      *pos++ = b64_index_table[(in[1] & 0x0f) << 2];
-    }
-    *pos++ = '=';
-  }
+  base64Encode(src, len, &outStr[0]);
 
   return outStr;
 }
@@ -1177,6 +1177,9 @@ private:
   // Decode base64 encoded string
   unsigned char *decodeBase64(const unsigned char *src, size_t len, size_t *out_len);
 
+  // Decode the next line of a base64 encoded part, the partial group at its end is kept by the decoder
+  unsigned char *decodeBase64Line(Base64Decoder &decoder, const char *src, size_t len, size_t *out_len);
+
   // Decode base64 encoded string
   MB_String encodeBase64Str(const unsigned char *src, size_t len);
 
@@ -1460,13 +1463,13 @@ private:
   int chunkAvailable(SMTPSession *smtp, esp_mail_smtp_send_base64_data_info_t &data_info);
 
   // Read chunk data of blob or file
-  int getChunk(SMTPSession *smtp, esp_mail_smtp_send_base64_data_info_t &data_info, unsigned char *rawChunk, bool base64);
+  int getChunk(SMTPSession *smtp, esp_mail_smtp_send_base64_data_info_t &data_info, unsigned char *rawChunk, size_t size);
 
   // Terminate chunk reading
   void closeChunk(esp_mail_smtp_send_base64_data_info_t &data_info);
 
-  // Get base64 encoded buffer or raw buffer
-  void getBuffer(bool base64, uint8_t *out, uint8_t *in, int &encodedCount, int &bufIndex, bool &dataReady, int &size, size_t chunkSize);
+  // Append data which is already base64 encoded to the send buffer
+  void getBuffer(uint8_t *out, uint8_t *in, int &encodedCount, int &bufIndex, bool &dataReady, int &size, size_t chunkSize);
 
   // Send blob or file as base64 encoded chunk
   bool sendBase64(SMTPSession *smtp, SMTP_Message *msg, esp_mail_smtp_send_base64_data_info_t &data_info, bool base64, bool report);
@@ -11,6 +11,7 @@
 #include "ESP_Mail_Error.h"
 #include "extras/MB_FS.h"
 #include "extras/RFC2047.h"
+#include <Base64Codec.h>
 #include <time.h>
 #include <ctype.h>
 
@@ -2223,6 +2224,8 @@ struct esp_mail_message_part_info_t
     bool plain_flowed = false;
     bool plain_delsp = false;
     esp_mail_msg_xencoding xencoding = esp_mail_msg_xencoding_none;
+    // base64 content is decoded line by line, a group split between lines is carried over
+    Base64Decoder base64_decoder;
 };
 
 struct esp_mail_message_header_t
@@ -3428,8 +3431,6 @@ static const char boundary_table[] PROGMEM = "=_abcdefghijklmnopqrstuvwxyz012345
 
 #if defined(ENABLE_SMTP) || defined(ENABLE_IMAP)
 
-static const unsigned char b64_index_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
 static void __attribute__((used))
 appendDebugTag(MB_String &buf, esp_mail_debug_tag_type type, bool clear, PGM_P text = NULL)
 {
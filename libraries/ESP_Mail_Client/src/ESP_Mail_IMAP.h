@@ -4073,7 +4073,7 @@ bool ESP_Mail_Client::parseAttachmentResponse(IMAPSession *imap, char *buf, esp_
         {
 
             size_t olen = 0;
-            unsigned char *decoded = decodeBase64((const unsigned char *)buf, bufLen, &olen);
+            unsigned char *decoded = decodeBase64Line(cPart(imap)->base64_decoder, buf, bufLen, &olen);
 
             if (decoded)
             {
@@ -4331,7 +4331,7 @@ void ESP_Mail_Client::decodeText(IMAPSession *imap, esp_mail_imap_response_data
             // decode the content based on the transfer decoding
             if (cPart(imap)->xencoding == esp_mail_msg_xencoding_base64)
             {
-                decoded = (char *)decodeBase64((const unsigned char *)res.response, bufLen, &olen);
+                decoded = (char *)decodeBase64Line(cPart(imap)->base64_decoder, res.response, bufLen, &olen);
             }
             else if (cPart(imap)->xencoding == esp_mail_msg_xencoding_qp)
             {
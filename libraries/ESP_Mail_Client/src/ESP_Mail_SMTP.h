@@ -2945,15 +2945,13 @@ int ESP_Mail_Client::chunkAvailable(SMTPSession *smtp, esp_mail_smtp_send_base64
     return data_info.size - data_info.dataIndex;
 }
 
-int ESP_Mail_Client::getChunk(SMTPSession *smtp, esp_mail_smtp_send_base64_data_info_t &data_info, unsigned char *rawChunk, bool base64)
+int ESP_Mail_Client::getChunk(SMTPSession *smtp, esp_mail_smtp_send_base64_data_info_t &data_info, unsigned char *rawChunk, size_t size)
 {
     int available = chunkAvailable(smtp, data_info);
 
     if (available <= 0)
         return available;
 
-    size_t size = base64 ? 3 : 4;
-
     if (data_info.dataIndex + size > data_info.size)
         size = data_info.size - data_info.dataIndex;
 
@@ -3014,54 +3012,47 @@ bool ESP_Mail_Client::sendBase64(SMTPSession *smtp, SMTP_Message *msg, esp_mail_
     uint8_t *buf = allocMem<uint8_t *>(chunkSize);
     memset(buf, 0, chunkSize);
 
-    uint8_t *rawChunk = allocMem<uint8_t *>(base64 ? 3 : 4);
+    // The raw data is read in blocks which encode to UPLOAD_CHUNKS_NUM whole lines,
+    // filling buf, the encoded data 4 bytes at a time
+    size_t rawChunkSize = base64 ? (BASE64_CHUNKED_LEN / 4 * 3) * UPLOAD_CHUNKS_NUM : 4;
+    uint8_t *rawChunk = allocMem<uint8_t *>(rawChunkSize);
 
     if (report)
         uploadReport(data_info.filename, addr, data_info.dataIndex / data_info.size);
 
-    int min = base64 ? 3 : 1;
-
-    while (chunkAvailable(smtp, data_info))
+    if (base64)
     {
+        // The encoder carries the bytes which don't make up a whole group over to the next block,
+        // and breaks the lines
+        Base64Encoder encoder(BASE64_STANDARD, BASE64_CHUNKED_LEN);
 
-        if (chunkAvailable(smtp, data_info) >= min)
+        while (chunkAvailable(smtp, data_info) > 0)
         {
+            read = getChunk(smtp, data_info, rawChunk, rawChunkSize);
 
-            read = getChunk(smtp, data_info, rawChunk, base64);
-
-            if (!read)
+            if (read <= 0)
                 goto ex;
 
-            getBuffer(base64, buf, rawChunk, encodedCount, bufIndex, dataReady, read, chunkSize);
+            bufIndex = encoder.update(rawChunk, read, (char *)buf);
 
-            if (dataReady)
+            if (bufIndex > 0)
             {
-
-                if (!sendBDAT(smtp, msg, base64 ? bufIndex : bufIndex + 1, false))
+                if (!sendBDAT(smtp, msg, bufIndex, false))
                     goto ex;
 
-                if (!altSendData(buf, base64 ? bufIndex : bufIndex + 1, smtp, msg, false, false, esp_mail_smtp_cmd_undefined, esp_mail_smtp_status_code_0, SMTP_STATUS_UNDEFINED))
+                if (!altSendData(buf, bufIndex, smtp, msg, false, false, esp_mail_smtp_cmd_undefined, esp_mail_smtp_status_code_0, SMTP_STATUS_UNDEFINED))
                     goto ex;
-
-                memset(buf, 0, chunkSize);
-                bufIndex = 0;
             }
 
             if (report)
                 uploadReport(data_info.filename, addr, 100 * data_info.dataIndex / data_info.size);
         }
-        else if (base64)
-        {
-            read = getChunk(smtp, data_info, rawChunk, base64);
-            if (!read)
-                goto ex;
-        }
-    }
 
-    closeChunk(data_info);
+        closeChunk(data_info);
+
+        // the last partial group and its padding
+        bufIndex = encoder.end((char *)buf);
 
-    if (base64)
-    {
         if (bufIndex > 0)
         {
             if (!sendBDAT(smtp, msg, bufIndex, false))
@@ -3070,30 +3061,36 @@ bool ESP_Mail_Client::sendBase64(SMTPSession *smtp, SMTP_Message *msg, esp_mail_
             if (!altSendData(buf, bufIndex, smtp, msg, false, false, esp_mail_smtp_cmd_undefined, esp_mail_smtp_status_code_0, SMTP_STATUS_UNDEFINED))
                 goto ex;
         }
-
-        if (read)
+    }
+    else
+    {
+        while (chunkAvailable(smtp, data_info))
         {
-            memset(buf, 0, chunkSize);
-            bufIndex = 0;
-            buf[bufIndex++] = b64_index_table[rawChunk[0] >> 2];
-            if (read == 1)
-            {
-                buf[bufIndex++] = b64_index_table[(rawChunk[0] & 0x03) << 4];
-                buf[bufIndex++] = '=';
-            }
-            else
-            {
-                buf[bufIndex++] = b64_index_table[((rawChunk[0] & 0x03) << 4) | (rawChunk[1] >> 4)];
-                buf[bufIndex++] = b64_index_table[(rawChunk[1] & 0x0f) << 2];
-            }
-            buf[bufIndex++] = '=';
+            read = getChunk(smtp, data_info, rawChunk, rawChunkSize);
 
-            if (!sendBDAT(smtp, msg, bufIndex, false))
+            if (!read)
                 goto ex;
 
-            if (!altSendData(buf, bufIndex, smtp, msg, false, false, esp_mail_smtp_cmd_undefined, esp_mail_smtp_status_code_0, SMTP_STATUS_UNDEFINED))
-                goto ex;
+            getBuffer(buf, rawChunk, encodedCount, bufIndex, dataReady, read, chunkSize);
+
+            if (dataReady)
+            {
+
+                if (!sendBDAT(smtp, msg, bufIndex + 1, false))
+                    goto ex;
+
+                if (!altSendData(buf, bufIndex + 1, smtp, msg, false, false, esp_mail_smtp_cmd_undefined, esp_mail_smtp_status_code_0, SMTP_STATUS_UNDEFINED))
+                    goto ex;
+
+                memset(buf, 0, chunkSize);
+                bufIndex = 0;
+            }
+
+            if (report)
+                uploadReport(data_info.filename, addr, 100 * data_info.dataIndex / data_info.size);
         }
+
+        closeChunk(data_info);
     }
 
     ret = true;
@@ -3112,46 +3109,21 @@ ex:
     return ret;
 }
 
-void ESP_Mail_Client::getBuffer(bool base64, uint8_t *out, uint8_t *in, int &encodedCount, int &bufIndex, bool &dataReady, int &size, size_t chunkSize)
+void ESP_Mail_Client::getBuffer(uint8_t *out, uint8_t *in, int &encodedCount, int &bufIndex, bool &dataReady, int &size, size_t chunkSize)
 {
-    if (base64)
-    {
-        size = 0;
-        out[bufIndex++] = b64_index_table[in[0] >> 2];
-        out[bufIndex++] = b64_index_table[((in[0] & 0x03) << 4) | (in[1] >> 4)];
-        out[bufIndex++] = b64_index_table[((in[1] & 0x0f) << 2) | (in[2] >> 6)];
-        out[bufIndex++] = b64_index_table[in[2] & 0x3f];
-
-        encodedCount += 4;
-
-        if (encodedCount == BASE64_CHUNKED_LEN)
-        {
-            if (bufIndex + 1 < (int)chunkSize)
-            {
-                out[bufIndex++] = 0x0d;
-                out[bufIndex++] = 0x0a;
-            }
-            encodedCount = 0;
-        }
+    memcpy(out + bufIndex, in, size);
+    bufIndex += size;
 
-        dataReady = bufIndex >= (int)chunkSize - 4;
-    }
-    else
+    if (bufIndex + 1 == BASE64_CHUNKED_LEN)
     {
-        memcpy(out + bufIndex, in, size);
-        bufIndex += size;
-
-        if (bufIndex + 1 == BASE64_CHUNKED_LEN)
+        if (bufIndex + 2 < (int)chunkSize)
         {
-            if (bufIndex + 2 < (int)chunkSize)
-            {
-                out[bufIndex++] = 0x0d;
-                out[bufIndex++] = 0x0a;
-            }
+            out[bufIndex++] = 0x0d;
+            out[bufIndex++] = 0x0a;
         }
-
-        dataReady = bufIndex + 1 >= (int)chunkSize - size;
     }
+
+    dataReady = bufIndex + 1 >= (int)chunkSize - size;
 }
 
 MB_FS *ESP_Mail_Client::getMBFS()
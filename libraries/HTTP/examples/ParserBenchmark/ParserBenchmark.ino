@@ -0,0 +1,61 @@
+/*
+ * ParserBenchmark
+ *
+ * Example of using the Arduino_HTTP request parser on its own,
+ * measuring how many requests per second the board can parse
+ */
+
+#include <httpServer.hpp>
+
+// A request like the ones sent by web browsers
+const char request[] =
+	"GET /status?full=1 HTTP/1.1\r\n"
+	"Host: 192.168.1.20\r\n"
+	"User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/115.0\r\n"
+	"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+	"Accept-Language: en-US,en;q=0.5\r\n"
+	"Accept-Encoding: gzip, deflate\r\n"
+	"Connection: keep-alive\r\n"
+	"\r\n" ;
+
+// The parser holds a whole request, so keep it off the stack
+http::RequestParser parser ;
+
+void setup()
+	{
+		Serial.begin( 9600 ) ;
+	}
+
+void loop()
+	{
+		const unsigned long iterations = 1000 ;
+		const unsigned long startTime = micros() ;
+
+		for( unsigned long n = 0 ; n < iterations ; ++ n )
+			{
+				parser.reset() ;
+
+				// Feed the request in pieces, as it would arrive from the network
+				for( size_t offset = 0 ; offset < sizeof( request ) - 1 ; offset += 64 )
+					parser.parse( request + offset, min( sizeof( request ) - 1 - offset, ( size_t ) 64 ) ) ;
+			}
+
+		const unsigned long elapsedTime = micros() - startTime ;
+
+		if( parser.status() != http::RequestParser::Status::COMPLETE )
+			{
+				Serial.println( "The request could not be parsed" ) ;
+				return ;
+			}
+
+		// Show the parsed fields, which are views into the parser buffer
+		Serial.print( "Target: " ) ;
+		Serial.println( ( String ) parser.target() ) ;
+		Serial.print( "Host: " ) ;
+		Serial.println( ( String ) parser.field( http::HeaderField::HOST ) ) ;
+
+		Serial.print( iterations * 1000000.0 / elapsedTime ) ;
+		Serial.println( " requests/s" ) ;
+
+		delay( 5000 ) ;
+	}
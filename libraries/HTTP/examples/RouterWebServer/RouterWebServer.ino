@@ -0,0 +1,99 @@
+/*
+ * RouterWebServer
+ *
+ * Example of using the Arduino_HTTP library to make a small web API
+ * over Ethernet: requests are dispatched by method and path,
+ * responses are streamed without building them in memory
+ * and connections are kept open between requests
+ */
+
+#include <Ethernet.h>
+#include <httpServer.hpp>
+
+// Set the MAC address for the Ethernet Shield
+byte macAddress[ 6 ] { 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED } ;
+
+// Create a EthernetServer to manage the Ethernet connection
+// Set it to work on port 80, so that web browsers can communicate with it
+EthernetServer ethernetServer( 80 ) ;
+
+// Create a HTTP Server with the default parameters
+http::Server httpServer ;
+
+// Keep some connections open, so that clients don't have to connect for every request.
+// HTTP_MAX_CLIENTS of them by default, fewer on AVR boards, as each one has a request buffer
+http::ConnectionPool < EthernetClient > connections ;
+
+/* Route handlers receive the request and a ResponseWriter,
+ * that sends the response to the client while it is written
+ *
+ * GET /
+ * The page is sent straight from flash memory
+ */
+IMPLEMENT_HTTP_ROUTE_HANDLER( showHomePage )
+	{
+		response.send( http::Response::OK, "text/html", F(
+				"<html><body>"
+				"<h1>Arduino</h1>"
+				"<p><a href=\"/analog/0\">Analog input 0</a></p>"
+				"<p><a href=\"/uptime\">Uptime</a></p>"
+				"</body></html>"
+			) ) ;
+	}
+
+/* GET /analog/:pin
+ * The ":pin" part of the path is a parameter, matching any value
+ */
+IMPLEMENT_HTTP_ROUTE_HANDLER( showAnalogInput )
+	{
+		const int pin = ( ( String ) request.parameter( "pin" ) ).toInt() ;
+
+		if( pin < 0 || pin >= NUM_ANALOG_INPUTS )
+			{
+				response.send( http::Response::NOT_FOUND, "text/plain", "No such pin" ) ;
+				return ;
+			}
+
+		// The length of the payload isn't known in advance, so it is sent in chunks
+		response.begin( http::Response::OK, "text/plain" ) ;
+		response.print( F( "A" ) ) ;
+		response.print( pin ) ;
+		response.print( F( " = " ) ) ;
+		response.println( analogRead( A0 + pin ) ) ;
+	}
+
+/* GET /uptime
+ */
+IMPLEMENT_HTTP_ROUTE_HANDLER( showUptime )
+	{
+		response.begin( http::Response::OK, "text/plain" ) ;
+		response.sendField( "Cache-Control", "no-store" ) ;
+		response.print( millis() / 1000 ) ;
+		response.println( F( " s" ) ) ;
+	}
+
+void setup()
+	{
+		// Set the Ethernet Shield to get an automatic IP address from the network
+		Ethernet.begin( macAddress ) ;
+		ethernetServer.begin() ;
+
+		// Show the obtained address on the serial monitor
+		Serial.begin( 9600 ) ;
+		Serial.println( Ethernet.localIP() ) ;
+
+		// Fill the route table
+		httpServer.on( http::Request::GET, "/", showHomePage ) ;
+		httpServer.on( http::Request::GET, "/analog/:pin", showAnalogInput ) ;
+		httpServer.on( http::Request::GET, "/uptime", showUptime ) ;
+
+		// Answer the paths without a route with 404 Not Found, rather than the test page
+		httpServer.GET_requestHandler = nullptr ;
+	}
+
+void loop()
+	{
+		// Take the new connections, then answer the requests received on all of them
+		connections.add( ethernetServer.accept() ) ;
+		connections.serve( httpServer ) ;
+	}
@@ -0,0 +1,188 @@
+/**
+ * @file
+ * @brief Timing helpers and a HTTP client for the HTTP benchmarks
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+
+/**
+ * Run setup then run iterations times, and return the fastest run in microseconds.
+ * The best run is the one least disturbed by the rest of the host
+ */
+template < typename Setup, typename Run >
+double bestOf( int iterations, Setup setup, Run run )
+	{
+		double best = 1e300 ;
+
+		for( int n = 0 ; n < iterations ; ++ n )
+			{
+				setup() ;
+
+				const auto start = std::chrono::steady_clock::now() ;
+				run() ;
+				const std::chrono::duration < double, std::micro > elapsed = std::chrono::steady_clock::now() - start ;
+
+				best = min( best, elapsed.count() ) ;
+			}
+
+		return best ;
+	}
+
+/**
+ * The remote client of the server under test: a blocking socket to 127.0.0.1,
+ * reading responses framed by Content-Length, by chunks or by closing the connection
+ */
+class HostConnection
+	{
+		public:
+
+			~HostConnection() { close() ; }
+
+			bool connect( uint16_t port )
+				{
+					close() ;
+
+					socket = ::socket( AF_INET, SOCK_STREAM, 0 ) ;
+
+					sockaddr_in address = {} ;
+					address.sin_family			= AF_INET ;
+					address.sin_port				= htons( port ) ;
+					address.sin_addr.s_addr	= htonl( INADDR_LOOPBACK ) ;
+
+					if( ::connect( socket, ( sockaddr * ) & address, sizeof( address ) ) != 0 )
+						{
+							close() ;
+							return false ;
+						}
+
+					int one = 1 ;
+					setsockopt( socket, IPPROTO_TCP, TCP_NODELAY, & one, sizeof( one ) ) ;
+
+					// Don't wait forever for a server that has stopped
+					timeval timeout { 2, 0 } ;
+					setsockopt( socket, SOL_SOCKET, SO_RCVTIMEO, & timeout, sizeof( timeout ) ) ;
+
+					received.clear() ;
+
+					return true ;
+				}
+
+			void close()
+				{
+					if( socket >= 0 ) ::close( socket ) ;
+					socket = -1 ;
+				}
+
+			bool send( const std::string & data )
+				{
+					for( size_t sent = 0 ; sent < data.size() ; )
+						{
+							const ssize_t n = ::send( socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL ) ;
+							if( n <= 0 ) return false ;
+							sent += n ;
+						}
+
+					return true ;
+				}
+
+			/**
+			 * Read the next response
+			 *
+			 * @param body	set to the payload, without the chunk framing
+			 * @return			the response code, 0 if there was no complete response
+			 */
+			int readResponse( std::string & body )
+				{
+					size_t headerEnd ;
+
+					while( ( headerEnd = received.find( "\r\n\r\n" ) ) == std::string::npos )
+						if( ! receive() ) return 0 ;
+
+					std::string header = received.substr( 0, headerEnd + 2 ) ;
+					received.erase( 0, headerEnd + 4 ) ;
+
+					for( char & c : header ) c = tolower( c ) ;
+
+					body.clear() ;
+					keepAlive = header.find( "\r\nconnection: close\r\n" ) == std::string::npos ;
+
+					const size_t lengthField = header.find( "\r\ncontent-length:" ) ;
+
+					if( lengthField != std::string::npos )
+						{
+							if( ! take( body, atol( header.c_str() + lengthField + 17 ) ) ) return 0 ;
+						}
+						else if( header.find( "\r\ntransfer-encoding: chunked\r\n" ) != std::string::npos )
+							{
+								for( ;; )
+									{
+										size_t lineEnd ;
+
+										while( ( lineEnd = received.find( "\r\n" ) ) == std::string::npos )
+											if( ! receive() ) return 0 ;
+
+										const size_t chunkLength = strtoul( received.c_str(), nullptr, 16 ) ;
+										received.erase( 0, lineEnd + 2 ) ;
+
+										std::string chunk ;
+										if( ! take( chunk, chunkLength + 2 ) ) return 0 ;
+
+										if( chunkLength == 0 ) break ;
+										body += chunk.substr( 0, chunkLength ) ;
+									}
+							}
+						else
+							{
+								// The end of the payload is the end of the connection
+								while( receive() ) ;
+
+								body.swap( received ) ;
+								keepAlive = false ;
+							}
+
+					return atoi( header.c_str() + 9 ) ;
+				}
+
+			/// True if the last response left the connection open
+			bool keptAlive() const { return keepAlive ; }
+
+		private:
+
+			bool receive()
+				{
+					char buffer[ 4096 ] ;
+					const ssize_t n = recv( socket, buffer, sizeof( buffer ), 0 ) ;
+
+					if( n <= 0 ) return false ;
+
+					received.append( buffer, n ) ;
+					return true ;
+				}
+
+			bool take( std::string & data, size_t length )
+				{
+					while( received.size() < length )
+						if( ! receive() ) return false ;
+
+					data = received.substr( 0, length ) ;
+					received.erase( 0, length ) ;
+
+					return true ;
+				}
+
+			int socket = -1 ;
+			std::string received ;
+			bool keepAlive = false ;
+	} ;
@@ -0,0 +1,195 @@
+/**
+ * @file
+ * @brief Load test of http::Server behind a http::ConnectionPool, over loopback TCP
+ *
+ * Keep-alive clients send GET requests back to back, each waiting for the response
+ * before the next one, and the time each response takes is recorded.
+ * The server loop is the one of the RouterWebServer example.
+ *
+ * Optionally one more client sends its requests slowly, in two halves 20 ms apart,
+ * to show that it doesn't hold up the others
+ */
+
+#include <httpServer.hpp>
+#include <Loopback.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "harness.h"
+
+namespace
+	{
+		IMPLEMENT_HTTP_ROUTE_HANDLER( showStatus )
+			{
+				response.send( http::Response::OK, "application/json", "{\"uptime\":1234,\"heap\":20480}" ) ;
+			}
+
+		// About 300 bytes, of a length not known in advance, so it is sent in chunks
+		IMPLEMENT_HTTP_ROUTE_HANDLER( showMetrics )
+			{
+				response.begin( http::Response::OK, "text/plain" ) ;
+
+				for( int n = 0 ; n < 12 ; ++ n )
+					{
+						response.print( "sensor_value{id=\"" ) ;
+						response.print( n ) ;
+						response.print( "\"} " ) ;
+						response.println( 1000 + n * 37 ) ;
+					}
+			}
+
+		http::Server httpServer ;
+
+		struct Result
+			{
+				double rate ;		// Requests per second
+				double p50 ;		// Response times, in µs
+				double p99 ;
+				long reconnections ;
+			} ;
+
+		/**
+		 * Run clientN clients against a pool of maxClients connections
+		 *
+		 * @param path				the path requested
+		 * @param slowClient	true to add a client that sends its requests slowly
+		 */
+		template < uint8_t maxClients >
+		Result run( int clientN, const char * path, bool slowClient )
+			{
+				LoopbackServer server ;
+				http::ConnectionPool < LoopbackClient, maxClients > connections ;
+
+				std::atomic < bool > serving( true ) ;
+				std::atomic < bool > measuring( false ) ;
+				std::atomic < bool > running( true ) ;
+				std::atomic < long > reconnections( 0 ) ;
+
+				std::thread serverLoop( [ & ]
+					{
+						while( serving )
+							{
+								connections.add( server.accept() ) ;
+								connections.serve( httpServer ) ;
+							}
+					} ) ;
+
+				const std::string request = std::string( "GET " ) + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n" ;
+				std::vector < std::vector < double > > times( clientN ) ;
+				std::vector < std::thread > clients ;
+
+				for( int n = 0 ; n < clientN ; ++ n )
+					clients.emplace_back( [ &, n ]
+						{
+							HostConnection connection ;
+							std::string body ;
+							bool connected = false ;
+
+							while( running )
+								{
+									if( ! connected )
+										{
+											connected = connection.connect( server.port() ) ;
+											if( measuring ) ++ reconnections ;
+										}
+
+									const auto start = std::chrono::steady_clock::now() ;
+									const bool answered = connection.send( request ) && connection.readResponse( body ) == 200 ;
+									const std::chrono::duration < double, std::micro > elapsed = std::chrono::steady_clock::now() - start ;
+
+									if( answered && measuring )
+										times[ n ].push_back( elapsed.count() ) ;
+
+									// Closed by the server, e.g. to make room for another connection
+									connected = answered && connection.keptAlive() ;
+								}
+						} ) ;
+
+				if( slowClient )
+					clients.emplace_back( [ & ]
+						{
+							HostConnection connection ;
+							std::string body ;
+							bool connected = false ;
+
+							while( running )
+								{
+									if( ! connected )
+										connected = connection.connect( server.port() ) ;
+
+									connection.send( request.substr( 0, request.size() / 2 ) ) ;
+									std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) ) ;
+
+									connected =
+										connection.send( request.substr( request.size() / 2 ) ) &&
+										connection.readResponse( body ) == 200 &&
+										connection.keptAlive() ;
+								}
+						} ) ;
+
+				// Let the connections settle first
+				std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) ) ;
+
+				measuring = true ;
+				const auto start = std::chrono::steady_clock::now() ;
+				std::this_thread::sleep_for( std::chrono::seconds( 1 ) ) ;
+				measuring = false ;
+				const std::chrono::duration < double > elapsed = std::chrono::steady_clock::now() - start ;
+
+				running = false ;
+
+				for( std::thread & client : clients )
+					client.join() ;
+
+				serving = false ;
+				serverLoop.join() ;
+
+				std::vector < double > all ;
+
+				for( const auto & clientTimes : times )
+					all.insert( all.end(), clientTimes.begin(), clientTimes.end() ) ;
+
+				std::sort( all.begin(), all.end() ) ;
+
+				if( all.empty() ) return Result { 0, 0, 0, reconnections } ;
+
+				return Result
+					{
+						all.size() / elapsed.count() ,
+						all[ all.size() / 2 ] ,
+						all[ all.size() * 99 / 100 ] ,
+						reconnections
+					} ;
+			}
+
+		template < uint8_t maxClients >
+		void table( const char * path, bool slowClient = false )
+			{
+				printf( "\nGET %s, pool of %d%s\n", path, maxClients, slowClient ? ", and a slow client" : "" ) ;
+				printf( "  conns    req/s   p50 us   p99 us   reconnections\n" ) ;
+
+				for( int clientN : { 1, 4, 8, 16, 32 } )
+					{
+						const Result result = run < maxClients >( clientN, path, slowClient ) ;
+
+						printf( "  %5d  %6.1fk  %7.0f  %7.0f  %14ld\n",
+								clientN, result.rate / 1000, result.p50, result.p99, result.reconnections ) ;
+					}
+			}
+	}
+
+int main()
+	{
+		httpServer.on( http::Request::GET, "/status", showStatus ) ;
+		httpServer.on( http::Request::GET, "/metrics", showMetrics ) ;
+
+		table < 32 >( "/status" ) ;
+		table < HTTP_MAX_CLIENTS >( "/status" ) ;
+		table < 32 >( "/metrics" ) ;
+		table < 32 >( "/status", true ) ;
+
+		return 0 ;
+	}
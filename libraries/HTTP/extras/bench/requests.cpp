@@ -0,0 +1,133 @@
+/**
+ * @file
+ * @brief How fast requests are parsed, on their own and as served over loopback TCP
+ *
+ * The loopback part works as the CustomWebServer and TestWebServer examples do:
+ * every request on a new connection, answered by replyTo(), which then closes it
+ */
+
+#include <httpServer.hpp>
+#include <Loopback.h>
+#include <ScriptedClient.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "harness.h"
+
+namespace
+	{
+		// A request like the ones sent by web browsers, the same as in the ParserBenchmark example
+		const std::string request =
+			"GET /status?full=1 HTTP/1.1\r\n"
+			"Host: 192.168.1.20\r\n"
+			"User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/115.0\r\n"
+			"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+			"Accept-Language: en-US,en;q=0.5\r\n"
+			"Accept-Encoding: gzip, deflate\r\n"
+			"Connection: keep-alive\r\n"
+			"\r\n" ;
+
+		constexpr int batch = 10000 ;
+
+		http::RequestParser parser ;
+
+		// In µs, a request arriving in pieces of 64 bytes
+		double parseTime()
+			{
+				return bestOf( 20, [] {}, []
+					{
+						for( int n = 0 ; n < batch ; ++ n )
+							{
+								parser.reset() ;
+
+								for( size_t start = 0 ; start < request.size() ; start += 64 )
+									parser.parse( request.data() + start, min( request.size() - start, ( size_t ) 64 ) ) ;
+							}
+					} ) / batch ;
+			}
+
+		// In µs, the same request read from a client into a RequestMessage
+		double messageTime()
+			{
+				std::vector < ScriptedClient > clients( batch ) ;
+
+				return bestOf( 20, [ & ]
+					{
+						for( ScriptedClient & client : clients )
+							{
+								client = ScriptedClient() ;
+								client.arrive( request, 64 ) ;
+							}
+					},
+					[ & ]
+					{
+						for( ScriptedClient & client : clients )
+							http::parseRawMessageFrom( http::RemoteClient < ScriptedClient >( client ), parser ) ;
+					} ) / batch ;
+			}
+
+		// Requests per second, with clientN clients each sending one request per connection
+		double requestRate( int clientN )
+			{
+				static http::Server httpServer ;
+
+				LoopbackServer server ;
+				std::atomic < bool > running( true ) ;
+				std::atomic < long > answered( 0 ) ;
+				std::vector < std::thread > clients ;
+
+				for( int n = 0 ; n < clientN ; ++ n )
+					clients.emplace_back( [ & ]
+						{
+							HostConnection connection ;
+							std::string body ;
+
+							while( running )
+								if(
+										connection.connect( server.port() ) &&
+										connection.send( request ) &&
+										connection.readResponse( body ) == 200
+									)
+									++ answered ;
+						} ) ;
+
+				const auto start = std::chrono::steady_clock::now() ;
+				const long answeredBefore = answered ;
+
+				while( std::chrono::steady_clock::now() - start < std::chrono::seconds( 2 ) )
+					{
+						const http::RemoteClient < LoopbackClient > client = server.available() ;
+						httpServer.replyTo( client ) ;
+					}
+
+				const std::chrono::duration < double > elapsed = std::chrono::steady_clock::now() - start ;
+				const double rate = ( answered - answeredBefore ) / elapsed.count() ;
+
+				// Let the clients finish the requests they are waiting for
+				running = false ;
+
+				for( auto deadline = millis() + 500 ; millis() < deadline ; )
+					{
+						const http::RemoteClient < LoopbackClient > client = server.available() ;
+						httpServer.replyTo( client ) ;
+					}
+
+				for( std::thread & client : clients )
+					client.join() ;
+
+				return rate ;
+			}
+	}
+
+int main()
+	{
+		printf( "RequestParser alone:            %6.2f us\n", parseTime() ) ;
+		printf( "parse into a RequestMessage:    %6.2f us\n", messageTime() ) ;
+
+		for( int clientN : { 1, 4 } )
+			printf( "loopback, %d client%s:           %6.1fk requests/s\n", clientN, clientN > 1 ? "s" : " ", requestRate( clientN ) / 1000 ) ;
+
+		return 0 ;
+	}
@@ -0,0 +1,48 @@
+/**
+ * @file
+ * @brief Stand-in for the parts of the Arduino core used by the library
+ */
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial ;
+
+namespace
+	{
+		std::atomic < unsigned long > skippedTime( 0 ) ;
+
+		unsigned long long hostMicros()
+			{
+				using namespace std::chrono ;
+				return duration_cast < microseconds >( steady_clock::now().time_since_epoch() ).count() ;
+			}
+	}
+
+void MockClock::advance( unsigned long milliseconds )
+	{
+		skippedTime += milliseconds ;
+	}
+
+unsigned long millis()
+	{
+		return hostMicros() / 1000 + skippedTime ;
+	}
+
+unsigned long micros()
+	{
+		return hostMicros() + skippedTime * 1000ULL ;
+	}
+
+void delay( unsigned long milliseconds )
+	{
+		std::this_thread::sleep_for( std::chrono::milliseconds( milliseconds ) ) ;
+	}
+
+void yield()
+	{
+		std::this_thread::yield() ;
+	}
@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @brief Stand-in for the parts of the Arduino core used by the library,
+ * so that it can be built and run on a host
+ */
+
+#pragma once
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte ;
+
+#define DEC 10
+#define HEX 16
+
+// There is no flash memory apart from RAM on a host
+class __FlashStringHelper ;
+#define F( text ) ( reinterpret_cast < const __FlashStringHelper * >( text ) )
+#define PGM_P const char *
+#define strlen_P strlen
+
+/**
+ * millis() and micros() follow the host clock,
+ * plus the time the tests have skipped with MockClock::advance()
+ */
+namespace MockClock
+	{
+		void advance( unsigned long milliseconds ) ;
+	}
+
+unsigned long millis() ;
+unsigned long micros() ;
+void delay( unsigned long milliseconds ) ;
+void yield() ;
+
+using std::max ;
+using std::min ;
+
+class String
+	{
+		public:
+
+			String() {}
+			String( const char * text ) { if( text != nullptr ) string = text ; }
+			String( const std::string & text ) : string( text ) {}
+			String( char c ) : string( 1, c ) {}
+			String( int value, unsigned char base = DEC ) : string( format( value, base ) ) {}
+			String( unsigned int value, unsigned char base = DEC ) : string( format( value, base ) ) {}
+			String( long value, unsigned char base = DEC ) : string( format( value, base ) ) {}
+			String( unsigned long value, unsigned char base = DEC ) : string( format( value, base ) ) {}
+
+			unsigned char reserve( unsigned int size ) { string.reserve( size ) ; return 1 ; }
+			unsigned int length() const { return string.size() ; }
+			const char * c_str() const { return string.c_str() ; }
+			const std::string & str() const { return string ; }
+
+			char * begin() { return & string[ 0 ] ; }
+			char * end() { return & string[ 0 ] + string.size() ; }
+			const char * begin() const { return string.data() ; }
+			const char * end() const { return string.data() + string.size() ; }
+
+			String & operator += ( const String & text ) { string += text.string ; return * this ; }
+			String & operator += ( const char * text ) { string += text ; return * this ; }
+			String & operator += ( char c ) { string += c ; return * this ; }
+
+			friend String operator + ( const String & a, const String & b ) { return a.string + b.string ; }
+			friend String operator + ( const String & a, const char * b ) { return a.string + b ; }
+			friend String operator + ( const char * a, const String & b ) { return a + b.string ; }
+			friend String operator + ( const String & a, char b ) { return a.string + b ; }
+
+			bool operator == ( const String & text ) const { return string == text.string ; }
+			bool operator == ( const char * text ) const { return string == text ; }
+			bool operator != ( const String & text ) const { return string != text.string ; }
+			bool operator != ( const char * text ) const { return string != text ; }
+
+			char operator [] ( unsigned int index ) const { return index < string.size() ? string[ index ] : 0 ; }
+
+			int indexOf( char c, unsigned int from = 0 ) const
+				{
+					const size_t position = string.find( c, from ) ;
+					return position == std::string::npos ? -1 : ( int ) position ;
+				}
+
+			long toInt() const { return atol( string.c_str() ) ; }
+
+		private:
+
+			template < typename T >
+			static std::string format( T value, unsigned char base )
+				{
+					char text[ 32 ] ;
+
+					if( base == HEX )
+						snprintf( text, sizeof( text ), "%llx", ( unsigned long long ) value ) ;
+						else snprintf( text, sizeof( text ), "%lld", ( long long ) value ) ;
+
+					return text ;
+				}
+
+			std::string string ;
+	} ;
+
+class Print
+	{
+		public:
+
+			virtual ~Print() {}
+
+			virtual size_t write( uint8_t byte ) = 0 ;
+
+			virtual size_t write( const uint8_t * data, size_t length )
+				{
+					size_t n = 0 ;
+					while( length -- ) n += write( * data ++ ) ;
+					return n ;
+				}
+
+			size_t write( const char * text ) { return write( ( const uint8_t * ) text, strlen( text ) ) ; }
+			size_t write( const char * data, size_t length ) { return write( ( const uint8_t * ) data, length ) ; }
+
+			size_t print( const char * text ) { return write( text ) ; }
+			size_t print( const __FlashStringHelper * text ) { return write( ( const char * ) text ) ; }
+			size_t print( const String & text ) { return write( text.c_str(), text.length() ) ; }
+			size_t print( char c ) { return write( ( uint8_t ) c ) ; }
+			size_t print( int value, int base = DEC ) { return print( String( value, base ) ) ; }
+			size_t print( unsigned int value, int base = DEC ) { return print( String( value, base ) ) ; }
+			size_t print( long value, int base = DEC ) { return print( String( value, base ) ) ; }
+			size_t print( unsigned long value, int base = DEC ) { return print( String( value, base ) ) ; }
+
+			size_t print( double value, int digits = 2 )
+				{
+					char text[ 32 ] ;
+					snprintf( text, sizeof( text ), "%.*f", digits, value ) ;
+					return write( text ) ;
+				}
+
+			size_t println() { return write( "\r\n" ) ; }
+
+			template < typename T >
+			size_t println( const T & value ) { return print( value ) + println() ; }
+	} ;
+
+class HardwareSerial : public Print
+	{
+		public:
+
+			void begin( unsigned long ) {}
+
+			size_t write( uint8_t byte ) override { return fputc( byte, stdout ) == EOF ? 0 : 1 ; }
+			using Print::write ;
+	} ;
+
+extern HardwareSerial Serial ;
@@ -0,0 +1,186 @@
+/**
+ * @file
+ * @brief A transport layer server and client on loopback TCP sockets, for host benchmarks
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * The server side of a connection, over a non-blocking socket
+ *
+ * Copies share the socket, which is closed by stop() or when the last copy goes,
+ * as with the clients of the Arduino network libraries
+ */
+class LoopbackClient
+	{
+		public:
+
+			LoopbackClient() {}
+
+			explicit LoopbackClient( int socket ) :
+				handle( std::make_shared < Socket >( socket ) ) {}
+
+			int available()
+				{
+					int queued = 0 ;
+					if( isOpen() ) ioctl( handle->socket, FIONREAD, & queued ) ;
+					return queued ;
+				}
+
+			int read()
+				{
+					uint8_t byte ;
+					return read( & byte, 1 ) == 1 ? byte : -1 ;
+				}
+
+			int read( uint8_t * buffer, size_t length )
+				{
+					return isOpen() ? recv( handle->socket, buffer, length, 0 ) : -1 ;
+				}
+
+			size_t write( const uint8_t * data, size_t length )
+				{
+					size_t sent = 0 ;
+
+					while( isOpen() && sent < length )
+						{
+							const ssize_t n = send( handle->socket, data + sent, length - sent, MSG_NOSIGNAL ) ;
+
+							if( n > 0 ) sent += n ;
+								else if( errno == EAGAIN || errno == EWOULDBLOCK )
+									{
+										// Wait for room in the send buffer, as the Arduino clients do
+										pollfd writable { handle->socket, POLLOUT, 0 } ;
+										poll( & writable, 1, 100 ) ;
+									}
+								else break ;
+						}
+
+					return sent ;
+				}
+
+			size_t write( const char * text ) { return write( ( const uint8_t * ) text, strlen( text ) ) ; }
+
+			uint8_t connected()
+				{
+					if( ! isOpen() ) return false ;
+
+					// The remote side has closed when there's nothing left to read but the end
+					char byte ;
+					return recv( handle->socket, & byte, 1, MSG_PEEK | MSG_DONTWAIT ) != 0 ;
+				}
+
+			void stop()
+				{
+					if( ! isOpen() ) return ;
+
+					close( handle->socket ) ;
+					handle->socket = -1 ;
+				}
+
+			operator bool() { return isOpen() ; }
+
+		private:
+
+			struct Socket
+				{
+					explicit Socket( int socket_ ) : socket( socket_ ) {}
+					~Socket() { if( socket >= 0 ) close( socket ) ; }
+
+					int socket ;
+				} ;
+
+			bool isOpen() const { return handle && handle->socket >= 0 ; }
+
+			std::shared_ptr < Socket > handle ;
+	} ;
+
+/// A TCP server on 127.0.0.1, on a port picked by the system
+class LoopbackServer
+	{
+		public:
+
+			LoopbackServer()
+				{
+					listener = socket( AF_INET, SOCK_STREAM, 0 ) ;
+
+					sockaddr_in address = {} ;
+					address.sin_family			= AF_INET ;
+					address.sin_addr.s_addr	= htonl( INADDR_LOOPBACK ) ;
+
+					bind( listener, ( sockaddr * ) & address, sizeof( address ) ) ;
+
+					socklen_t length = sizeof( address ) ;
+					getsockname( listener, ( sockaddr * ) & address, & length ) ;
+					listenPort = ntohs( address.sin_port ) ;
+
+					listen( listener, 128 ) ;
+					fcntl( listener, F_SETFL, O_NONBLOCK ) ;
+				}
+
+			~LoopbackServer() { close( listener ) ; }
+
+			uint16_t port() const { return listenPort ; }
+
+			/// A newly connected client, or one that is false if there is none, as EthernetServer::accept()
+			LoopbackClient accept()
+				{
+					const int socket = ::accept( listener, nullptr, nullptr ) ;
+
+					if( socket < 0 ) return LoopbackClient() ;
+
+					int one = 1 ;
+					setsockopt( socket, IPPROTO_TCP, TCP_NODELAY, & one, sizeof( one ) ) ;
+					fcntl( socket, F_SETFL, O_NONBLOCK ) ;
+
+					return LoopbackClient( socket ) ;
+				}
+
+			/**
+			 * A connected client that has sent data, or one that is false if there is none,
+			 * as EthernetServer::available().
+			 * The others are kept until they send something or close
+			 */
+			LoopbackClient available()
+				{
+					for( LoopbackClient client ; ( client = accept() ) ; )
+						waiting.push_back( client ) ;
+
+					for( size_t n = 0 ; n < waiting.size() ; ++ n )
+						{
+							LoopbackClient client = waiting[ n ] ;
+
+							if( client.available() || ! client.connected() )
+								{
+									waiting.erase( waiting.begin() + n ) ;
+
+									if( client.available() ) return client ;
+
+									-- n ;
+								}
+						}
+
+					return LoopbackClient() ;
+				}
+
+		private:
+
+			int listener ;
+			uint16_t listenPort ;
+			std::vector < LoopbackClient > waiting ;
+	} ;
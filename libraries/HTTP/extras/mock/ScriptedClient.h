@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @brief A transport layer client that plays back what the tests give it
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+
+/**
+ * The server side of a connection, whose remote client is played by the test
+ *
+ * The request arrives in the pieces given to arrive(), and a read never
+ * returns more than one piece, as when they come in separate packets.
+ * Copies share the connection, as the clients of the Arduino network libraries do
+ */
+class ScriptedClient
+	{
+		public:
+
+			ScriptedClient() : connection( std::make_shared < Connection >() ) {}
+
+			/// Let the remote client send data, split in pieces of pieceSize bytes
+			void arrive( const std::string & data, size_t pieceSize = 0 )
+				{
+					if( pieceSize == 0 ) pieceSize = data.size() ;
+
+					for( size_t start = 0 ; start < data.size() ; start += pieceSize )
+						connection->pieces.push_back( data.substr( start, pieceSize ) ) ;
+				}
+
+			/// Let every piece take some milliseconds of MockClock time to arrive, as from a slow client
+			void pace( unsigned long milliseconds ) { connection->pace = milliseconds ; }
+
+			/// The remote client closes its side of the connection
+			void hangUp() { connection->hungUp = true ; }
+
+			/// What the server has sent, which is then forgotten
+			std::string sent()
+				{
+					std::string data ;
+					data.swap( connection->sent ) ;
+					return data ;
+				}
+
+			/// True if the server has closed the connection
+			bool stopped() const { return connection->stopped ; }
+
+			/// Number of calls to read( buffer, length ), to check that the server doesn't wait for data
+			size_t readCalls() const { return connection->readCalls ; }
+
+			// The API of the Arduino network clients
+
+			int available()
+				{
+					return connection->pieces.empty() ? 0 : connection->pieces.front().size() ;
+				}
+
+			int read()
+				{
+					uint8_t byte ;
+					return read( & byte, 1 ) == 1 ? byte : -1 ;
+				}
+
+			int read( uint8_t * buffer, size_t length )
+				{
+					++ connection->readCalls ;
+
+					if( connection->stopped || connection->pieces.empty() ) return -1 ;
+
+					MockClock::advance( connection->pace ) ;
+
+					std::string & piece = connection->pieces.front() ;
+					length = min( length, piece.size() ) ;
+
+					memcpy( buffer, piece.data(), length ) ;
+					piece.erase( 0, length ) ;
+
+					if( piece.empty() ) connection->pieces.pop_front() ;
+
+					return length ;
+				}
+
+			size_t write( const uint8_t * data, size_t length )
+				{
+					if( connection->stopped ) return 0 ;
+
+					connection->sent.append( ( const char * ) data, length ) ;
+					return length ;
+				}
+
+			size_t write( const char * text ) { return write( ( const uint8_t * ) text, strlen( text ) ) ; }
+
+			uint8_t connected()
+				{
+					return ! connection->stopped && ( ! connection->pieces.empty() || ! connection->hungUp ) ;
+				}
+
+			void stop() { connection->stopped = true ; }
+
+			operator bool() { return ! connection->stopped ; }
+
+		private:
+
+			struct Connection
+				{
+					std::deque < std::string > pieces ;
+					std::string sent ;
+					bool hungUp = false ;
+					bool stopped = false ;
+					size_t readCalls = 0 ;
+					unsigned long pace = 0 ;
+				} ;
+
+			std::shared_ptr < Connection > connection ;
+	} ;
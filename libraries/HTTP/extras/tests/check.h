@@ -0,0 +1,21 @@
+/**
+ * @file
+ * @brief Assertions for the HTTP tests
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Stops the test with the location of the failure, also in release builds
+#define REQUIRE( condition ) \
+	do \
+		{ \
+			if( ! ( condition ) ) \
+				{ \
+					fprintf( stderr, "%s:%d: REQUIRE(%s) failed\n", __FILE__, __LINE__, #condition ) ; \
+					exit( 1 ) ; \
+				} \
+		} \
+	while( 0 )
@@ -0,0 +1,386 @@
+/**
+ * @file
+ * @brief Tests of http::RequestParser: requests arriving in pieces,
+ * early rejection of the ones that can't be served, pipelining
+ * and the lookup of the header fields
+ */
+
+#include <httpServer.hpp>
+#include <ScriptedClient.h>
+
+#include <strings.h>
+
+#include <string>
+
+#include "check.h"
+
+using http::HeaderField ;
+using http::RequestParser ;
+using http::Response ;
+
+namespace
+	{
+		// A request like the ones sent by web browsers, with a payload
+		const std::string request =
+			"\r\n"
+			"POST /sensors/7?unit=C HTTP/1.1\r\n"
+			"Host: 192.168.1.20\r\n"
+			"User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/115.0\r\n"
+			"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+			"X-Unknown-Field: ignored\r\n"
+			"accept-language:en-US,en;q=0.5  \r\n"
+			"Accept-Language: de\r\n"
+			"CONTENT-LENGTH: 11\r\n"
+			"Connection: keep-alive\n"
+			"\r\n"
+			"temp=21.5&x" ;
+
+		// All the known field names, in the order of http::HeaderField
+		const char * const fieldNames[]
+			{
+				"Pragma" , "Connection" , "Cache-Control" , "Expect" , "Host" , "Max-Forwards" ,
+				"Range" , "TE" , "If-Match" , "If-None-Match" , "If-Modified-Since" ,
+				"If-Unmodified-Since" , "If-Range" , "Accept" , "Accept-Charset" ,
+				"Accept-Encoding" , "Accept-Language" , "Authorization" , "Proxy-Authorization" ,
+				"From" , "Referer" , "User-Agent" , "Content-Length" , "Transfer-Encoding"
+			} ;
+
+		static_assert(
+				sizeof( fieldNames ) / sizeof( fieldNames[ 0 ] ) == ( size_t ) HeaderField::COUNT ,
+				"A known field is missing from the test"
+			) ;
+
+		// The same sequence at every run
+		size_t randomBelow( size_t limit )
+			{
+				static uint32_t state = 1 ;
+				state = state * 1103515245 + 12345 ;
+				return ( state >> 8 ) % limit ;
+			}
+
+		std::string text( const http::StringView & view )
+			{
+				return view.data == nullptr ? std::string() : std::string( view.data, view.length ) ;
+			}
+
+		RequestParser::Status parse( RequestParser & parser, const std::string & data )
+			{
+				return parser.parse( data.data(), data.size() ) ;
+			}
+
+		void requireSampleRequest( const RequestParser & parser )
+			{
+				REQUIRE( parser.status() == RequestParser::Status::COMPLETE ) ;
+				REQUIRE( ( http::Request ) parser.method() == http::Request::POST ) ;
+				REQUIRE( text( parser.target() ) == "/sensors/7?unit=C" ) ;
+				REQUIRE( text( parser.version() ) == "HTTP/1.1" ) ;
+				REQUIRE( text( parser.field( HeaderField::HOST ) ) == "192.168.1.20" ) ;
+				REQUIRE( text( parser.field( HeaderField::ACCEPT_LANGUAGE ) ) == "en-US,en;q=0.5" ) ;
+				REQUIRE( text( parser.field( HeaderField::CONTENT_LENGTH ) ) == "11" ) ;
+				REQUIRE( text( parser.field( HeaderField::CONNECTION ) ) == "keep-alive" ) ;
+				REQUIRE( parser.field( HeaderField::REFERER ).data == nullptr ) ;
+				REQUIRE( text( parser.payload() ) == "temp=21.5&x" ) ;
+				REQUIRE( parser.messageLength() == request.size() ) ;
+			}
+	}
+
+static void testWholeRequest()
+	{
+		static RequestParser parser ;
+
+		REQUIRE( parse( parser, request ) == RequestParser::Status::COMPLETE ) ;
+		requireSampleRequest( parser ) ;
+
+		// Copied into a RequestMessage
+		http::RequestMessage message ;
+		parser.copyTo( message ) ;
+
+		REQUIRE( ! message.parsingFailed ) ;
+		REQUIRE( ( http::Request ) message.header.requestMethod == http::Request::POST ) ;
+		REQUIRE( message.header.requestTarget == "/sensors/7?unit=C" ) ;
+		REQUIRE( message.header.host.value == "192.168.1.20" ) ;
+		REQUIRE( message.header.userAgent.value.length() > 0 ) ;
+		REQUIRE( message.header.referrer.value.length() == 0 ) ;
+		REQUIRE( message.payload == "temp=21.5&x" ) ;
+
+		// The views are gone with the request
+		parser.reset() ;
+		REQUIRE( parser.status() == RequestParser::Status::INCOMPLETE ) ;
+		REQUIRE( parser.target().data == nullptr && parser.field( HeaderField::HOST ).data == nullptr ) ;
+		REQUIRE( parser.receiveSpace() == HTTP_REQUEST_BUFFER_SIZE ) ;
+	}
+
+static void testPartialReads()
+	{
+		static RequestParser parser ;
+
+		// Pieces of the same size, down to a byte at a time
+		for( size_t pieceSize = 1 ; pieceSize <= request.size() ; ++ pieceSize )
+			{
+				parser.reset() ;
+
+				for( size_t start = 0 ; start < request.size() ; start += pieceSize )
+					{
+						REQUIRE( parser.status() == RequestParser::Status::INCOMPLETE ) ;
+						parse( parser, request.substr( start, pieceSize ) ) ;
+					}
+
+				requireSampleRequest( parser ) ;
+			}
+
+		// Pieces of random sizes
+		for( int round = 0 ; round < 1000 ; ++ round )
+			{
+				parser.reset() ;
+
+				for( size_t start = 0, length ; start < request.size() ; start += length )
+					{
+						length = 1 + randomBelow( 40 ) ;
+						parse( parser, request.substr( start, length ) ) ;
+					}
+
+				requireSampleRequest( parser ) ;
+			}
+
+		// Received straight into the buffer, as readRequestFrom() does
+		ScriptedClient scripted ;
+		scripted.arrive( request, 7 ) ;
+
+		const http::RemoteClient < ScriptedClient > client( scripted ) ;
+		parser.reset() ;
+
+		REQUIRE( http::readRequestFrom( client, parser ) == RequestParser::Status::COMPLETE ) ;
+		requireSampleRequest( parser ) ;
+		REQUIRE( scripted.readCalls() == ( request.size() + 6 ) / 7 ) ;
+
+		// A client that goes away halfway
+		ScriptedClient leaving ;
+		leaving.arrive( request.substr( 0, 40 ) ) ;
+		leaving.hangUp() ;
+
+		const http::RequestMessage message = http::parseRawMessageFrom( http::RemoteClient < ScriptedClient >( leaving ), parser ) ;
+
+		REQUIRE( message.parsingFailed ) ;
+		REQUIRE( ( Response ) message.parsingError == Response::BAD_REQUEST ) ;
+	}
+
+static void testEarlyRejection()
+	{
+		static RequestParser parser ;
+
+		// A request line that doesn't fit: 414 as soon as the buffer is full
+		parser.reset() ;
+		const std::string longTarget = "GET /" + std::string( HTTP_REQUEST_BUFFER_SIZE, 'a' ) ;
+
+		REQUIRE( parse( parser, longTarget.substr( 0, HTTP_REQUEST_BUFFER_SIZE - 1 ) ) == RequestParser::Status::INCOMPLETE ) ;
+		REQUIRE( parse( parser, longTarget.substr( HTTP_REQUEST_BUFFER_SIZE - 1 ) ) == RequestParser::Status::FAILED ) ;
+		REQUIRE( ( Response ) parser.error() == Response::URI_TOO_LONG ) ;
+
+		// Header fields that don't fit: 431, before their end arrives
+		parser.reset() ;
+		parse( parser, "GET / HTTP/1.1\r\n" ) ;
+
+		while( parser.status() == RequestParser::Status::INCOMPLETE )
+			parse( parser, "Cookie: 0123456789012345678901234567890123456789\r\n" ) ;
+
+		REQUIRE( parser.receiveSpace() == 0 ) ;
+		REQUIRE( ( Response ) parser.error() == Response::REQUEST_HEADER_FIELDS_TOO_LARGE ) ;
+
+		// A payload that doesn't fit: 413 as soon as Content-Length is read, before the payload
+		parser.reset() ;
+		REQUIRE( parse( parser, "POST /upload HTTP/1.1\r\nHost: x\r\n" ) == RequestParser::Status::INCOMPLETE ) ;
+		REQUIRE( parse( parser, "Content-Length: 4096\r\n" ) == RequestParser::Status::FAILED ) ;
+		REQUIRE( ( Response ) parser.error() == Response::ENTITY_TOO_LARGE ) ;
+
+		// Also when the number would overflow
+		parser.reset() ;
+		parse( parser, "POST / HTTP/1.1\r\nContent-Length: 99999999999999999999999999\r\n" ) ;
+		REQUIRE( ( Response ) parser.error() == Response::ENTITY_TOO_LARGE ) ;
+
+		// A payload that fills the buffer exactly is fine
+		parser.reset() ;
+		std::string header = "PUT /f HTTP/1.1\r\nContent-Length: 0000\r\n\r\n" ;
+		const std::string length = std::to_string( HTTP_REQUEST_BUFFER_SIZE - header.size() ) ;
+		header.replace( header.find( "0000" ), 4, std::string( 4 - length.size(), '0' ) + length ) ;
+
+		REQUIRE( parse( parser, header + std::string( HTTP_REQUEST_BUFFER_SIZE - header.size(), 'p' ) ) == RequestParser::Status::COMPLETE ) ;
+		REQUIRE( parser.payload().length == HTTP_REQUEST_BUFFER_SIZE - header.size() ) ;
+
+		// A wrong method is rejected after 8 bytes, without waiting for the line
+		parser.reset() ;
+		REQUIRE( parse( parser, "GETTING_" ) == RequestParser::Status::FAILED ) ;
+		REQUIRE( ( Response ) parser.error() == Response::BAD_REQUEST ) ;
+
+		parser.reset() ;
+		REQUIRE( parse( parser, "OPTIONS " ) == RequestParser::Status::INCOMPLETE ) ;
+	}
+
+static void testBadRequests()
+	{
+		static RequestParser parser ;
+
+		struct
+			{
+				const char * request ;
+				Response error ;
+			}
+		const cases[]
+			{
+				// Repeated Content-Length, even with the same value, could be used to smuggle requests
+				{ "POST / HTTP/1.1\r\nContent-Length: 3\r\nContent-Length: 3\r\n\r\nabc" , Response::BAD_REQUEST } ,
+				{ "POST / HTTP/1.1\r\nContent-Length: 3\r\ncontent-length: 4\r\n\r\nabcd" , Response::BAD_REQUEST } ,
+				{ "POST / HTTP/1.1\r\nContent-Length: 3x\r\n\r\nabc" , Response::BAD_REQUEST } ,
+				{ "POST / HTTP/1.1\r\nContent-Length:\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n" , Response::NOT_IMPLEMENTED } ,
+				// Folded fields and whitespace before the colon
+				{ "GET / HTTP/1.1\r\nAccept: text/html,\r\n  text/plain\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "GET / HTTP/1.1\r\nHost : x\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "GET / HTTP/1.1\r\nNo colon\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "GET / HTTP/1.1\r\n: empty name\r\n\r\n" , Response::BAD_REQUEST } ,
+				// Wrong request lines
+				{ "FETCH / HTTP/1.1\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "get / HTTP/1.1\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "GET  HTTP/1.1\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "GET /\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "GET / HTTP/2.0\r\n\r\n" , Response::BAD_REQUEST } ,
+				{ "GET / HTTP/1.10\r\n\r\n" , Response::BAD_REQUEST }
+			} ;
+
+		for( const auto & badRequest : cases )
+			{
+				parser.reset() ;
+
+				REQUIRE( parser.parse( badRequest.request, strlen( badRequest.request ) ) == RequestParser::Status::FAILED ) ;
+				REQUIRE( ( Response ) parser.error() == badRequest.error ) ;
+			}
+
+		// Once failed, the request stays failed
+		REQUIRE( parse( parser, "\r\n\r\n" ) == RequestParser::Status::FAILED ) ;
+		REQUIRE( parser.fail( Response::REQUEST_TIMEOUT ) == RequestParser::Status::FAILED ) ;
+		REQUIRE( ( Response ) parser.error() == Response::BAD_REQUEST ) ;
+
+		// And the ones that are fine
+		const char * const goodRequests[]
+			{
+				"GET / HTTP/1.0\r\n\r\n" ,
+				"GET / HTTP/1.1\n\n" ,
+				"\r\n\r\nHEAD /x HTTP/1.1\r\n\r\n" ,
+				"DELETE /x HTTP/1.1\r\nHost:\r\n\r\n" ,
+				"CONNECT example.org:443 HTTP/1.1\r\n\r\n" ,
+				"POST / HTTP/1.1\r\nContent-Length: 0\r\n\r\n"
+			} ;
+
+		for( const char * goodRequest : goodRequests )
+			{
+				parser.reset() ;
+				REQUIRE( parser.parse( goodRequest, strlen( goodRequest ) ) == RequestParser::Status::COMPLETE ) ;
+			}
+	}
+
+static void testPipelining()
+	{
+		static RequestParser parser ;
+
+		const std::string first		= "GET /a HTTP/1.1\r\nHost: x\r\n\r\n" ;
+		const std::string second	= "POST /b HTTP/1.1\r\nContent-Length: 4\r\n\r\nbody" ;
+		const std::string third		= "GET /c HTTP/1.1\r\nHost: z\r\n\r\n" ;
+
+		parser.reset() ;
+		REQUIRE( parse( parser, first + second + third.substr( 0, 10 ) ) == RequestParser::Status::COMPLETE ) ;
+		REQUIRE( text( parser.target() ) == "/a" ) ;
+		REQUIRE( parser.messageLength() == first.size() ) ;
+
+		// The bytes after the request are the next one
+		REQUIRE( parser.next() == second.size() + 10 ) ;
+		REQUIRE( parser.status() == RequestParser::Status::COMPLETE ) ;
+		REQUIRE( text( parser.target() ) == "/b" ) ;
+		REQUIRE( text( parser.payload() ) == "body" ) ;
+		REQUIRE( parser.field( HeaderField::HOST ).data == nullptr ) ;
+
+		// Only part of the third one has arrived
+		REQUIRE( parser.next() == 10 ) ;
+		REQUIRE( parser.status() == RequestParser::Status::INCOMPLETE ) ;
+		REQUIRE( parse( parser, third.substr( 10 ) ) == RequestParser::Status::COMPLETE ) ;
+		REQUIRE( text( parser.target() ) == "/c" ) ;
+		REQUIRE( text( parser.field( HeaderField::HOST ) ) == "z" ) ;
+
+		// Nothing after it
+		REQUIRE( parser.next() == 0 ) ;
+		REQUIRE( parser.status() == RequestParser::Status::INCOMPLETE ) ;
+		REQUIRE( parser.receiveSpace() == HTTP_REQUEST_BUFFER_SIZE ) ;
+
+		// Nothing is kept after an incomplete or failed request
+		parse( parser, first.substr( 0, 20 ) ) ;
+		REQUIRE( parser.next() == 0 ) ;
+		REQUIRE( parser.receiveSpace() == HTTP_REQUEST_BUFFER_SIZE ) ;
+
+		parse( parser, "BAD_METHOD / HTTP/1.1\r\n\r\n" + first ) ;
+		REQUIRE( parser.status() == RequestParser::Status::FAILED ) ;
+		REQUIRE( parser.next() == 0 ) ;
+	}
+
+static void testFieldLookup()
+	{
+		for( uint8_t n = 0 ; n < ( uint8_t ) HeaderField::COUNT ; ++ n )
+			{
+				std::string name = fieldNames[ n ] ;
+				const HeaderField field = ( HeaderField ) n ;
+
+				REQUIRE( RequestParser::lookupField( name.data(), name.size() ) == field ) ;
+
+				// Field names are case insensitive
+				std::string lower = name, upper = name ;
+				for( char & c : lower ) c = tolower( c ) ;
+				for( char & c : upper ) c = toupper( c ) ;
+
+				REQUIRE( RequestParser::lookupField( lower.data(), lower.size() ) == field ) ;
+				REQUIRE( RequestParser::lookupField( upper.data(), upper.size() ) == field ) ;
+
+				// A name with the same length, first and last letter has the same hash,
+				// so only the comparison after the hash tells it apart
+				if( name.size() > 2 )
+					{
+						std::string other = name ;
+						other[ 1 ] = other[ 1 ] == 'q' ? 'r' : 'q' ;
+						REQUIRE( RequestParser::lookupField( other.data(), other.size() ) == HeaderField::UNKNOWN ) ;
+					}
+
+				// Prefixes and longer names
+				REQUIRE( RequestParser::lookupField( name.data(), name.size() - 1 ) != field ) ;
+				REQUIRE( RequestParser::lookupField( ( name + "s" ).data(), name.size() + 1 ) == HeaderField::UNKNOWN ) ;
+			}
+
+		REQUIRE( RequestParser::lookupField( "", 0 ) == HeaderField::UNKNOWN ) ;
+		REQUIRE( RequestParser::lookupField( "Cookie", 6 ) == HeaderField::UNKNOWN ) ;
+		REQUIRE( RequestParser::lookupField( "Content-Type", 12 ) == HeaderField::UNKNOWN ) ;
+
+		// Random names are never mistaken for known ones
+		const char letters[] = "abcdefghijklmnopqrstuvwxyz-ABCDEFGHIJKLMNOPQRSTUVWXYZ" ;
+
+		for( int round = 0 ; round < 100000 ; ++ round )
+			{
+				char name[ 24 ] ;
+				const size_t length = 1 + randomBelow( sizeof( name ) ) ;
+
+				for( size_t n = 0 ; n < length ; ++ n )
+					name[ n ] = letters[ randomBelow( sizeof( letters ) - 1 ) ] ;
+
+				const HeaderField field = RequestParser::lookupField( name, length ) ;
+
+				if( field != HeaderField::UNKNOWN )
+					REQUIRE( strncasecmp( name, fieldNames[ ( uint8_t ) field ], length ) == 0 && fieldNames[ ( uint8_t ) field ][ length ] == '\0' ) ;
+			}
+	}
+
+int main()
+	{
+		testWholeRequest() ;
+		testPartialReads() ;
+		testEarlyRejection() ;
+		testBadRequests() ;
+		testPipelining() ;
+		testFieldLookup() ;
+
+		return 0 ;
+	}
@@ -0,0 +1,255 @@
+/**
+ * @file
+ * @brief Tests of http::Router: fixed names, parameters and wildcards,
+ * backtracking between them, 405 for the other methods and HEAD through GET
+ */
+
+#include <httpServer.hpp>
+
+#include <string>
+
+#include "check.h"
+
+using http::Request ;
+using http::Router ;
+
+namespace
+	{
+		// Handlers that are only told apart by their address
+		IMPLEMENT_HTTP_ROUTE_HANDLER( home ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( sensor ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( sensorValue ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( setSensorValue ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( allValues ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( staticIndex ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( staticFile ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( fixedPath ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( parameterPath ) {}
+		IMPLEMENT_HTTP_ROUTE_HANDLER( headOnly ) {}
+
+		std::string text( const http::StringView & view )
+			{
+				return view.data == nullptr ? std::string() : std::string( view.data, view.length ) ;
+			}
+
+		uint16_t bit( Request method )
+			{
+				return 1 << ( uint8_t ) method ;
+			}
+
+		/// The outcome of looking up a request
+		struct Lookup
+			{
+				Router::Match match ;
+				Router::Handler handler ;
+				uint16_t allowed ;
+				std::string path ;
+				std::string query ;
+				std::string parameters ; // Their values, separated by spaces
+			} ;
+
+		Lookup find( const Router & router, const char * method, const char * target )
+			{
+				static http::RequestParser parser ;
+
+				const std::string request = std::string( method ) + " " + target + " HTTP/1.1\r\n\r\n" ;
+
+				parser.reset() ;
+				REQUIRE( parser.parse( request.data(), request.size() ) == http::RequestParser::Status::COMPLETE ) ;
+
+				http::RouteRequest routeRequest( parser ) ;
+				Lookup lookup { Router::Match::NOT_FOUND, nullptr, 0xFFFF, "", "", "" } ;
+
+				lookup.match	= router.find( routeRequest, lookup.handler, lookup.allowed ) ;
+				lookup.path		= text( routeRequest.path() ) ;
+				lookup.query	= text( routeRequest.query() ) ;
+
+				for( uint8_t n = 0 ; n < routeRequest.parameterCount() ; ++ n )
+					lookup.parameters += ( n > 0 ? " " : "" ) + text( routeRequest.parameter( n ) ) ;
+
+				return lookup ;
+			}
+
+		// The route table of a small local API
+		Router & sampleRouter()
+			{
+				static Router router ;
+
+				if( router.empty() )
+					{
+						REQUIRE( router.add( Request::GET, "/", home ) ) ;
+						REQUIRE( router.add( Request::GET, "/sensors/:name", sensor ) ) ;
+						REQUIRE( router.add( Request::GET, "/sensors/:name/value", sensorValue ) ) ;
+						REQUIRE( router.add( Request::PUT, "/sensors/:name/value", setSensorValue ) ) ;
+						REQUIRE( router.add( Request::GET, "/sensors/all/values", allValues ) ) ;
+						REQUIRE( router.add( Request::GET, "/static/:dir/index", staticIndex ) ) ;
+						REQUIRE( router.add( Request::GET, "/static/*", staticFile ) ) ;
+						REQUIRE( router.add( Request::GET, "/a/b/d", fixedPath ) ) ;
+						REQUIRE( router.add( Request::GET, "/a/:x/c", parameterPath ) ) ;
+						REQUIRE( router.add( Request::HEAD, "/a/:x/c", headOnly ) ) ;
+					}
+
+				return router ;
+			}
+	}
+
+static void testMatching()
+	{
+		const Router & router = sampleRouter() ;
+
+		Lookup lookup = find( router, "GET", "/" ) ;
+		REQUIRE( lookup.match == Router::Match::FOUND && lookup.handler == home ) ;
+		REQUIRE( lookup.parameters == "" ) ;
+
+		// Parameters, with the query split off
+		lookup = find( router, "GET", "/sensors/kitchen?unit=C&raw" ) ;
+		REQUIRE( lookup.match == Router::Match::FOUND && lookup.handler == sensor ) ;
+		REQUIRE( lookup.path == "/sensors/kitchen" ) ;
+		REQUIRE( lookup.query == "unit=C&raw" ) ;
+		REQUIRE( lookup.parameters == "kitchen" ) ;
+
+		lookup = find( router, "PUT", "/sensors/kitchen/value" ) ;
+		REQUIRE( lookup.match == Router::Match::FOUND && lookup.handler == setSensorValue ) ;
+		REQUIRE( lookup.parameters == "kitchen" ) ;
+
+		// Fixed names win over parameters
+		lookup = find( router, "GET", "/sensors/all/values" ) ;
+		REQUIRE( lookup.handler == allValues && lookup.parameters == "" ) ;
+
+		lookup = find( router, "GET", "/sensors/all/value" ) ;
+		REQUIRE( lookup.handler == sensorValue && lookup.parameters == "all" ) ;
+
+		// Repeated and trailing slashes are ignored
+		lookup = find( router, "GET", "//sensors///kitchen/" ) ;
+		REQUIRE( lookup.handler == sensor && lookup.parameters == "kitchen" ) ;
+
+		// Parameters can be looked up by name
+		static http::RequestParser parser ;
+		const char request[] = "GET /sensors/hall/value HTTP/1.1\r\n\r\n" ;
+		parser.parse( request, sizeof( request ) - 1 ) ;
+
+		http::RouteRequest routeRequest( parser ) ;
+		Router::Handler handler ;
+		uint16_t allowed ;
+
+		REQUIRE( router.find( routeRequest, handler, allowed ) == Router::Match::FOUND ) ;
+		REQUIRE( text( routeRequest.parameter( "name" ) ) == "hall" ) ;
+		REQUIRE( routeRequest.parameter( "nam" ).data == nullptr ) ;
+		REQUIRE( routeRequest.parameter( ( uint8_t ) 1 ).data == nullptr ) ;
+		REQUIRE( routeRequest.query().data == nullptr ) ;
+
+		// Not there at all
+		lookup = find( router, "GET", "/sensors" ) ;
+		REQUIRE( lookup.match == Router::Match::NOT_FOUND && lookup.allowed == 0 ) ;
+
+		lookup = find( router, "GET", "/sensors/kitchen/value/extra" ) ;
+		REQUIRE( lookup.match == Router::Match::NOT_FOUND && lookup.allowed == 0 ) ;
+
+		// Without the parameters matched on the way
+		REQUIRE( lookup.parameters == "" ) ;
+	}
+
+static void testBacktracking()
+	{
+		const Router & router = sampleRouter() ;
+
+		// The fixed name "b" is tried first, but has no "c" under it
+		Lookup lookup = find( router, "GET", "/a/b/c" ) ;
+		REQUIRE( lookup.match == Router::Match::FOUND && lookup.handler == parameterPath ) ;
+		REQUIRE( lookup.parameters == "b" ) ;
+
+		lookup = find( router, "GET", "/a/b/d" ) ;
+		REQUIRE( lookup.handler == fixedPath && lookup.parameters == "" ) ;
+
+		// The parameter matches "css", but "site.css" isn't "index":
+		// the wildcard takes the whole rest, and the parameter is forgotten
+		lookup = find( router, "GET", "/static/css/site.css" ) ;
+		REQUIRE( lookup.match == Router::Match::FOUND && lookup.handler == staticFile ) ;
+		REQUIRE( lookup.parameters == "css/site.css" ) ;
+
+		lookup = find( router, "GET", "/static/css/index" ) ;
+		REQUIRE( lookup.handler == staticIndex && lookup.parameters == "css" ) ;
+
+		// A wildcard matches an empty rest too
+		lookup = find( router, "GET", "/static" ) ;
+		REQUIRE( lookup.handler == staticFile && lookup.parameters == "" ) ;
+	}
+
+static void testMethods()
+	{
+		const Router & router = sampleRouter() ;
+
+		// The path has routes, for other methods: 405, with all of them
+		Lookup lookup = find( router, "DELETE", "/sensors/kitchen/value" ) ;
+		REQUIRE( lookup.match == Router::Match::METHOD_NOT_ALLOWED ) ;
+		REQUIRE( lookup.allowed == ( bit( Request::GET ) | bit( Request::PUT ) ) ) ;
+
+		lookup = find( router, "POST", "/" ) ;
+		REQUIRE( lookup.match == Router::Match::METHOD_NOT_ALLOWED && lookup.allowed == bit( Request::GET ) ) ;
+
+		// GET routes answer HEAD
+		lookup = find( router, "HEAD", "/sensors/kitchen/value" ) ;
+		REQUIRE( lookup.match == Router::Match::FOUND && lookup.handler == sensorValue ) ;
+
+		// Unless there is a HEAD route
+		lookup = find( router, "HEAD", "/a/x/c" ) ;
+		REQUIRE( lookup.match == Router::Match::FOUND && lookup.handler == headOnly ) ;
+
+		lookup = find( router, "GET", "/a/x/c" ) ;
+		REQUIRE( lookup.handler == parameterPath ) ;
+
+		// A route for the method further down wins over a 405 on the way
+		lookup = find( router, "PUT", "/sensors/all/value" ) ;
+		REQUIRE( lookup.match == Router::Match::FOUND && lookup.handler == setSensorValue ) ;
+	}
+
+static void testLimits()
+	{
+		static Router router ;
+
+		// Invalid paths
+		REQUIRE( ! router.add( Request::GET, "sensors", home ) ) ;
+		REQUIRE( ! router.add( Request::GET, nullptr, home ) ) ;
+		REQUIRE( ! router.add( Request::GET, "/files/*/name", home ) ) ;
+		REQUIRE( ! router.add( Request::GET, "/files/*.txt", home ) ) ;
+		REQUIRE( ! router.add( Request::GET, "/sensors/:", home ) ) ;
+		REQUIRE( ! router.add( Request::GET, "/", nullptr ) ) ;
+		REQUIRE( router.empty() ) ;
+
+		// Parameters beyond HTTP_MAX_ROUTE_PARAMETERS can't match
+		REQUIRE( router.add( Request::GET, "/:a/:b/:c/:d/:e", home ) ) ;
+		REQUIRE( HTTP_MAX_ROUTE_PARAMETERS == 4 ) ;
+		REQUIRE( find( router, "GET", "/1/2/3/4/5" ).match == Router::Match::NOT_FOUND ) ;
+
+		REQUIRE( router.add( Request::GET, "/:a/:b/:c/:d", sensor ) ) ;
+		REQUIRE( find( router, "GET", "/1/2/3/4" ).parameters == "1 2 3 4" ) ;
+
+		// The table is full
+		int added = 2 ;
+		while( router.add( Request::POST, "/:a/:b/:c/:d", sensor ) ) ++ added ;
+
+		REQUIRE( added == HTTP_MAX_ROUTES ) ;
+
+		// The segment tree fills up separately: one path takes all the segments but the root
+		static Router deep ;
+		static std::string deepPath ; // Has to stay valid as long as the router
+
+		for( int n = 1 ; n < HTTP_MAX_ROUTE_SEGMENTS ; ++ n )
+			deepPath += "/" + std::to_string( n ) ;
+
+		REQUIRE( deep.add( Request::GET, deepPath.c_str(), home ) ) ;
+		REQUIRE( ! deep.add( Request::GET, "/other", home ) ) ;
+		REQUIRE( deep.add( Request::GET, "/1/2", sensor ) ) ;
+		REQUIRE( find( deep, "GET", deepPath.c_str() ).handler == home ) ;
+		REQUIRE( find( deep, "GET", "/1/2" ).handler == sensor ) ;
+	}
+
+int main()
+	{
+		testMatching() ;
+		testBacktracking() ;
+		testMethods() ;
+		testLimits() ;
+
+		return 0 ;
+	}
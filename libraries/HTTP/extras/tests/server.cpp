@@ -0,0 +1,391 @@
+/**
+ * @file
+ * @brief Tests of http::Server and http::ConnectionPool: keep-alive,
+ * pipelined requests, the connections kept open between them
+ * and the clients that are slow to send their requests
+ */
+
+#include <httpServer.hpp>
+#include <ScriptedClient.h>
+
+#include <string>
+
+#include "check.h"
+
+using http::Request ;
+
+namespace
+	{
+		IMPLEMENT_HTTP_ROUTE_HANDLER( showStatus )
+			{
+				response.send( http::Response::OK, "text/plain", "ok" ) ;
+			}
+
+		// The length isn't known in advance, so it is sent in chunks
+		IMPLEMENT_HTTP_ROUTE_HANDLER( streamText )
+			{
+				response.begin( http::Response::OK, "text/plain" ) ;
+				response.print( "streamed" ) ;
+			}
+
+		IMPLEMENT_HTTP_ROUTE_HANDLER( echoPayload )
+			{
+				response.begin( http::Response::OK, "text/plain", request.payload().length ) ;
+				response.write( ( const uint8_t * ) request.payload().data, request.payload().length ) ;
+			}
+
+		// Kept off the stack, as it holds a whole request
+		http::Server server ;
+
+		bool has( const std::string & response, const char * text )
+			{
+				return response.find( text ) != std::string::npos ;
+			}
+
+		size_t count( const std::string & response, const char * text )
+			{
+				size_t n = 0 ;
+
+				for( size_t start = 0 ; ( start = response.find( text, start ) ) != std::string::npos ; ++ start )
+					++ n ;
+
+				return n ;
+			}
+
+		/**
+		 * Send a request to the server
+		 *
+		 * @param keptAlive	set to what serve() returned
+		 * @return					what the server sent back
+		 */
+		std::string exchange( const std::string & request, bool & keptAlive, bool keepAliveAllowed = true, size_t pieceSize = 0 )
+			{
+				ScriptedClient client ;
+				client.arrive( request, pieceSize ) ;
+
+				keptAlive = server.serve( http::RemoteClient < ScriptedClient >( client ), keepAliveAllowed ) ;
+
+				return client.sent() ;
+			}
+	}
+
+static void testKeepAlive()
+	{
+		bool keptAlive ;
+
+		// HTTP/1.1 connections are persistent unless the client says otherwise
+		std::string response = exchange( "GET /status HTTP/1.1\r\nHost: x\r\n\r\n", keptAlive ) ;
+		REQUIRE( keptAlive ) ;
+		REQUIRE( response.find( "HTTP/1.1 200 OK\r\n" ) == 0 ) ;
+		REQUIRE( has( response, "\r\nConnection: keep-alive\r\n" ) ) ;
+		REQUIRE( has( response, "\r\n\r\nok" ) ) ;
+
+		response = exchange( "GET /status HTTP/1.1\r\nConnection: close\r\n\r\n", keptAlive ) ;
+		REQUIRE( ! keptAlive ) ;
+		REQUIRE( has( response, "\r\nConnection: close\r\n" ) ) ;
+
+		// Connection is a list of tokens, in any case
+		exchange( "GET /status HTTP/1.1\r\nConnection: Upgrade , CLOSE\r\n\r\n", keptAlive ) ;
+		REQUIRE( ! keptAlive ) ;
+
+		exchange( "GET /status HTTP/1.1\r\nConnection: keep-alive, closed\r\n\r\n", keptAlive ) ;
+		REQUIRE( keptAlive ) ;
+
+		// HTTP/1.0 ones only if the client asks for it
+		response = exchange( "GET /status HTTP/1.0\r\n\r\n", keptAlive ) ;
+		REQUIRE( ! keptAlive ) ;
+		REQUIRE( has( response, "\r\nConnection: close\r\n" ) ) ;
+
+		exchange( "GET /status HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", keptAlive ) ;
+		REQUIRE( keptAlive ) ;
+
+		// Chunks are HTTP/1.1 only, so the end of the payload is marked by closing
+		response = exchange( "GET /stream HTTP/1.0\r\nConnection: keep-alive\r\n\r\n", keptAlive ) ;
+		REQUIRE( ! keptAlive ) ;
+		REQUIRE( ! has( response, "Transfer-Encoding" ) ) ;
+		REQUIRE( has( response, "\r\n\r\nstreamed" ) ) ;
+
+		response = exchange( "GET /stream HTTP/1.1\r\n\r\n", keptAlive ) ;
+		REQUIRE( keptAlive ) ;
+		REQUIRE( has( response, "\r\nTransfer-Encoding: chunked\r\n" ) ) ;
+		REQUIRE( has( response, "\r\n\r\n0008\r\nstreamed\r\n0\r\n\r\n" ) ) ;
+
+		// The server can refuse
+		response = exchange( "GET /status HTTP/1.1\r\n\r\n", keptAlive, false ) ;
+		REQUIRE( ! keptAlive ) ;
+		REQUIRE( has( response, "\r\nConnection: close\r\n" ) ) ;
+
+		// A request that can't be parsed leaves the connection out of sync
+		response = exchange( "GET /status HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 1\r\n\r\nx", keptAlive ) ;
+		REQUIRE( ! keptAlive ) ;
+		REQUIRE( response.find( "HTTP/1.1 400 BAD REQUEST \r\n" ) == 0 ) ;
+		REQUIRE( has( response, "\r\nConnection: close\r\n" ) ) ;
+
+		// Pieces are put together
+		response = exchange( "POST /echo HTTP/1.1\r\nContent-Length: 13\r\n\r\nhello, pieces", keptAlive, true, 3 ) ;
+		REQUIRE( keptAlive ) ;
+		REQUIRE( has( response, "\r\n\r\nhello, pieces" ) ) ;
+	}
+
+static void testPipelining()
+	{
+		bool keptAlive ;
+
+		// All the requests received are answered, in order
+		std::string response = exchange(
+				"GET /status HTTP/1.1\r\n\r\n"
+				"POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nfirst"
+				"POST /echo HTTP/1.1\r\nContent-Length: 6\r\n\r\nsecond" ,
+				keptAlive
+			) ;
+
+		REQUIRE( keptAlive ) ;
+		REQUIRE( count( response, "HTTP/1.1 200 OK\r\n" ) == 3 ) ;
+		REQUIRE( response.find( "\r\n\r\nok" ) < response.find( "\r\n\r\nfirst" ) ) ;
+		REQUIRE( response.find( "\r\n\r\nfirst" ) < response.find( "\r\n\r\nsecond" ) ) ;
+
+		// Up to the one that closes the connection
+		response = exchange(
+				"GET /status HTTP/1.1\r\n\r\n"
+				"GET /status HTTP/1.1\r\nConnection: close\r\n\r\n"
+				"GET /status HTTP/1.1\r\n\r\n" ,
+				keptAlive
+			) ;
+
+		REQUIRE( ! keptAlive ) ;
+		REQUIRE( count( response, "HTTP/1.1 200 OK\r\n" ) == 2 ) ;
+	}
+
+static void testRoutes()
+	{
+		bool keptAlive ;
+
+		// A path with routes for other methods: 405, with them all, and GET brings HEAD
+		std::string response = exchange( "DELETE /status HTTP/1.1\r\n\r\n", keptAlive ) ;
+		REQUIRE( keptAlive ) ;
+		REQUIRE( response.find( "HTTP/1.1 405 METHOD NOT ALLOWED \r\n" ) == 0 ) ;
+		REQUIRE( has( response, "\r\nAllow: GET, HEAD\r\n" ) ) ;
+		REQUIRE( has( response, "\r\nContent-Length: 0\r\n" ) ) ;
+
+		response = exchange( "GET /echo HTTP/1.1\r\n\r\n", keptAlive ) ;
+		REQUIRE( has( response, "\r\nAllow: POST\r\n" ) ) ;
+
+		// HEAD through the GET route, with the length of the GET payload
+		response = exchange( "HEAD /status HTTP/1.1\r\n\r\n", keptAlive ) ;
+		REQUIRE( keptAlive ) ;
+		REQUIRE( response.find( "HTTP/1.1 200 OK\r\n" ) == 0 ) ;
+		REQUIRE( has( response, "\r\nContent-Length: 2\r\n" ) ) ;
+		REQUIRE( response.size() == response.find( "\r\n\r\n" ) + 4 ) ;
+
+		// Without a route the request handler for the method answers, the test page for GET
+		response = exchange( "GET /elsewhere HTTP/1.1\r\n\r\n", keptAlive ) ;
+		REQUIRE( keptAlive ) ;
+		REQUIRE( response.find( "HTTP/1.1 200 OK\r\n" ) == 0 ) ;
+		REQUIRE( has( response, "The request target was /elsewhere" ) ) ;
+
+		// And without a handler, with routes in use, the path is not there
+		response = exchange( "POST /elsewhere HTTP/1.1\r\n\r\n", keptAlive ) ;
+		REQUIRE( keptAlive ) ;
+		REQUIRE( response.find( "HTTP/1.1 404 NOT FOUND \r\n" ) == 0 ) ;
+	}
+
+static void testReplyTo()
+	{
+		// replyTo() answers one request and closes the connection
+		ScriptedClient client ;
+		const http::RemoteClient < ScriptedClient > remoteClient( client ) ;
+
+		server.replyTo( remoteClient ) ;
+		REQUIRE( ! client.stopped() && client.sent() == "" ) ;
+
+		client.arrive( "GET /status HTTP/1.1\r\n\r\nGET /status HTTP/1.1\r\n\r\n" ) ;
+		server.replyTo( remoteClient ) ;
+
+		const std::string response = client.sent() ;
+		REQUIRE( client.stopped() ) ;
+		REQUIRE( count( response, "HTTP/1.1 200 OK\r\n" ) == 1 ) ;
+		REQUIRE( has( response, "\r\nConnection: close\r\n" ) ) ;
+	}
+
+static void testConnectionPool()
+	{
+		http::ConnectionPool < ScriptedClient, 2 > pool ;
+
+		// Connections that are already closed aren't taken
+		ScriptedClient closed ;
+		closed.stop() ;
+		pool.add( closed ) ;
+		REQUIRE( pool.size() == 0 ) ;
+
+		ScriptedClient first, second ;
+		pool.add( first ) ;
+		pool.add( second ) ;
+		REQUIRE( pool.size() == 2 ) ;
+
+		// Only the connections with requests are answered, the others are left open
+		first.arrive( "GET /status HTTP/1.1\r\n\r\n" ) ;
+		pool.serve( server ) ;
+
+		REQUIRE( has( first.sent(), "\r\n\r\nok" ) ) ;
+		REQUIRE( second.sent() == "" ) ;
+		REQUIRE( pool.size() == 2 ) ;
+
+		// A new connection takes the place of the one idle for the longest time
+		MockClock::advance( 100 ) ;
+		first.arrive( "GET /status HTTP/1.1\r\n\r\n" ) ;
+		pool.serve( server ) ;
+
+		ScriptedClient third ;
+		pool.add( third ) ;
+
+		REQUIRE( pool.size() == 2 ) ;
+		REQUIRE( second.stopped() ) ;
+		REQUIRE( ! first.stopped() && ! third.stopped() ) ;
+
+		// Connections closed by the response or by the client are let go
+		first.arrive( "GET /status HTTP/1.1\r\nConnection: close\r\n\r\n" ) ;
+		third.hangUp() ;
+		pool.serve( server ) ;
+
+		REQUIRE( has( first.sent(), "\r\nConnection: close\r\n" ) ) ;
+		REQUIRE( first.stopped() && third.stopped() ) ;
+		REQUIRE( pool.size() == 0 ) ;
+
+		// And so are the idle ones
+		ScriptedClient idle ;
+		pool.add( idle ) ;
+		MockClock::advance( HTTP_KEEP_ALIVE_TIMEOUT - 100 ) ;
+		pool.serve( server ) ;
+		REQUIRE( pool.size() == 1 ) ;
+
+		MockClock::advance( 200 ) ;
+		pool.serve( server ) ;
+		REQUIRE( idle.stopped() ) ;
+		REQUIRE( pool.size() == 0 ) ;
+	}
+
+static void testSlowClients()
+	{
+		http::ConnectionPool < ScriptedClient, 2 > pool ;
+		const std::string request = "GET /status HTTP/1.1\r\n\r\n" ;
+		ScriptedClient slow, fast ;
+		pool.add( slow ) ;
+		pool.add( fast ) ;
+
+		// Only what has arrived is read, and the other connections are served meanwhile
+		slow.arrive( "GET /status HT" ) ;
+		fast.arrive( request ) ;
+		pool.serve( server ) ;
+
+		REQUIRE( slow.readCalls() == 1 && slow.sent() == "" ) ;
+		REQUIRE( has( fast.sent(), "\r\n\r\nok" ) ) ;
+
+		pool.serve( server ) ;
+		REQUIRE( slow.readCalls() == 1 ) ;
+
+		// Until the rest comes, with the start of a second request
+		const unsigned long pause = HTTP_REQUEST_DEADLINE / 4 + 1 ;
+		REQUIRE( pause < HTTP_REQUEST_TIMEOUT ) ;
+
+		MockClock::advance( pause ) ;
+		slow.arrive( "TP/1.1\r\n" ) ;
+		pool.serve( server ) ;
+
+		MockClock::advance( pause ) ;
+		slow.arrive( "\r\nPOST /echo HTTP/1.1\r\nContent-Length: 4\r\n\r\nsl" ) ;
+		pool.serve( server ) ;
+
+		std::string response = slow.sent() ;
+		REQUIRE( count( response, "HTTP/1.1 200 OK\r\n" ) == 1 ) ;
+		REQUIRE( has( response, "\r\n\r\nok" ) ) ;
+
+		// Whose time counts from there
+		MockClock::advance( pause ) ;
+		slow.arrive( "o" ) ;
+		pool.serve( server ) ;
+
+		MockClock::advance( pause ) ;
+		pool.serve( server ) ;
+
+		slow.arrive( "w" ) ;
+		pool.serve( server ) ;
+		REQUIRE( has( slow.sent(), "\r\n\r\nslow" ) ) ;
+
+		// A client that stops in the middle of a request
+		fast.arrive( request ) ;
+		slow.arrive( "GET /status HTTP/1.1\r\n" ) ;
+		pool.serve( server ) ;
+		MockClock::advance( HTTP_REQUEST_TIMEOUT + 1 ) ;
+		pool.serve( server ) ;
+
+		response = slow.sent() ;
+		REQUIRE( response.find( "HTTP/1.1 408 REQUEST TIMEOUT" ) == 0 ) ;
+		REQUIRE( slow.stopped() ) ;
+
+		// Or that keeps sending it a byte at a time
+		ScriptedClient dribbling ;
+		pool.add( dribbling ) ;
+
+		size_t sentN = 0 ;
+
+		for( unsigned long elapsed = 0 ; elapsed <= HTTP_REQUEST_DEADLINE ; elapsed += HTTP_REQUEST_TIMEOUT / 2 )
+			{
+				dribbling.arrive( request.substr( sentN ++, 1 ) ) ;
+				fast.arrive( request ) ;
+				pool.serve( server ) ;
+
+				// Without holding up the others
+				REQUIRE( has( fast.sent(), "\r\n\r\nok" ) ) ;
+
+				MockClock::advance( HTTP_REQUEST_TIMEOUT / 2 ) ;
+			}
+
+		REQUIRE( sentN < request.size() ) ;
+		pool.serve( server ) ;
+
+		response = dribbling.sent() ;
+		REQUIRE( response.find( "HTTP/1.1 408 REQUEST TIMEOUT" ) == 0 ) ;
+		REQUIRE( dribbling.stopped() ) ;
+
+		// The fast one was kept all along
+		REQUIRE( ! fast.stopped() && pool.size() == 1 ) ;
+	}
+
+static void testRequestDeadline()
+	{
+		// serve() waits for the rest of a request, but not past HTTP_REQUEST_DEADLINE
+		ScriptedClient client ;
+		client.pace( HTTP_REQUEST_TIMEOUT / 2 ) ;
+		client.arrive( "GET /status HTTP/1.1\r\n\r\n", 1 ) ;
+
+		REQUIRE( ! server.serve( http::RemoteClient < ScriptedClient >( client ) ) ) ;
+		REQUIRE( client.sent().find( "HTTP/1.1 408 REQUEST TIMEOUT" ) == 0 ) ;
+		REQUIRE( client.readCalls() <= HTTP_REQUEST_DEADLINE / ( HTTP_REQUEST_TIMEOUT / 2 ) + 1 ) ;
+
+		// A request sent in time is answered
+		bool keptAlive ;
+		ScriptedClient paced ;
+		paced.pace( HTTP_REQUEST_TIMEOUT / 2 ) ;
+		paced.arrive( "GET /status HTTP/1.1\r\n\r\n", 8 ) ;
+
+		keptAlive = server.serve( http::RemoteClient < ScriptedClient >( paced ) ) ;
+		REQUIRE( keptAlive ) ;
+		REQUIRE( has( paced.sent(), "\r\n\r\nok" ) ) ;
+	}
+
+int main()
+	{
+		server.on( Request::GET, "/status", showStatus ) ;
+		server.on( Request::GET, "/stream", streamText ) ;
+		server.on( Request::POST, "/echo", echoPayload ) ;
+
+		testKeepAlive() ;
+		testPipelining() ;
+		testRoutes() ;
+		testReplyTo() ;
+		testConnectionPool() ;
+		testSlowClients() ;
+		testRequestDeadline() ;
+
+		return 0 ;
+	}
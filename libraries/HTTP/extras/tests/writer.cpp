@@ -0,0 +1,319 @@
+/**
+ * @file
+ * @brief Tests of http::ResponseWriter: the header fields, chunk framing,
+ * responses to HEAD and payloads that don't match their Content-Length
+ */
+
+#include <httpServer.hpp>
+
+#include <string>
+
+#include "check.h"
+
+using http::Response ;
+using http::ResponseWriter ;
+
+namespace
+	{
+		// Records what would be sent to the client
+		class RecordingWriter : public ResponseWriter
+			{
+				public:
+
+					explicit RecordingWriter( const http::ResponseHeader & header ) :
+						ResponseWriter( header ) {}
+
+					std::string sent ;
+					size_t transmitN = 0 ;
+					size_t room = SIZE_MAX ; // Bytes the client takes before the connection breaks
+
+				protected:
+
+					bool transmit( const uint8_t * data, size_t length ) override
+						{
+							REQUIRE( length > 0 && length <= HTTP_RESPONSE_BUFFER_SIZE ) ;
+
+							++ transmitN ;
+
+							const size_t taken = min( length, room ) ;
+							sent.append( ( const char * ) data, taken ) ;
+							room -= taken ;
+
+							return taken == length ;
+						}
+			} ;
+
+		http::ResponseHeader & defaultHeader()
+			{
+				static http::ResponseHeader header ;
+
+				header.version	= "1.1" ;
+				header.server		= "Test/1.0" ;
+
+				return header ;
+			}
+
+		std::string headerOf( const std::string & response )
+			{
+				const size_t end = response.find( "\r\n\r\n" ) ;
+				REQUIRE( end != std::string::npos ) ;
+
+				return response.substr( 0, end + 2 ) ;
+			}
+
+		std::string payloadOf( const std::string & response )
+			{
+				return response.substr( response.find( "\r\n\r\n" ) + 4 ) ;
+			}
+
+		bool hasField( const std::string & response, const char * field )
+			{
+				return headerOf( response ).find( std::string( "\r\n" ) + field + "\r\n" ) != std::string::npos ;
+			}
+
+		// Undo the chunk framing, checking it on the way
+		std::string unchunk( const std::string & framed )
+			{
+				std::string payload ;
+
+				for( size_t start = 0 ; ; )
+					{
+						const size_t lineEnd = framed.find( "\r\n", start ) ;
+						REQUIRE( lineEnd != std::string::npos ) ;
+
+						const size_t length = strtoul( framed.c_str() + start, nullptr, 16 ) ;
+
+						if( length == 0 )
+							{
+								// The last chunk ends the response
+								REQUIRE( framed.compare( start, std::string::npos, "0\r\n\r\n" ) == 0 ) ;
+								return payload ;
+							}
+
+						// A chunk never spans two buffers
+						REQUIRE( lineEnd - start == 4 ) ;
+						REQUIRE( length <= HTTP_RESPONSE_BUFFER_SIZE - 8 ) ;
+						REQUIRE( framed.compare( lineEnd + 2 + length, 2, "\r\n" ) == 0 ) ;
+
+						payload += framed.substr( lineEnd + 2, length ) ;
+						start = lineEnd + 2 + length + 2 ;
+					}
+			}
+
+		// A payload of any length, that shows where its pieces went
+		std::string payloadOfLength( size_t length )
+			{
+				std::string payload ;
+
+				for( size_t n = 0 ; n < length ; ++ n )
+					payload += 'a' + n % 26 ;
+
+				return payload ;
+			}
+	}
+
+static void testKnownLength()
+	{
+		RecordingWriter response( defaultHeader() ) ;
+		response.prepare( true, true, false ) ;
+
+		response.begin( Response::OK, "text/plain", 5 ) ;
+		response.sendField( "Cache-Control", "no-store" ) ;
+		response.print( "hello" ) ;
+		response.sendField( "Too-Late", "x" ) ;
+		response.end() ;
+
+		REQUIRE( headerOf( response.sent ) ==
+				"HTTP/1.1 200 OK\r\n"
+				"Server: Test/1.0\r\n"
+				"Content-Length: 5\r\n"
+				"Connection: keep-alive\r\n"
+				"Content-Type: text/plain\r\n"
+				"Cache-Control: no-store\r\n"
+			) ;
+		REQUIRE( payloadOf( response.sent ) == "hello" ) ;
+		REQUIRE( response.keepAlive() ) ;
+
+		// A small response goes in one piece
+		REQUIRE( response.transmitN == 1 ) ;
+
+		// Nothing is sent after the end
+		REQUIRE( response.write( ( const uint8_t * ) "x", 1 ) == 0 ) ;
+		response.end() ;
+		REQUIRE( response.transmitN == 1 ) ;
+
+		// A long one goes in buffers
+		RecordingWriter longResponse( defaultHeader() ) ;
+		const std::string payload = payloadOfLength( 10 * HTTP_RESPONSE_BUFFER_SIZE + 7 ) ;
+
+		longResponse.prepare( true, true, false ) ;
+		longResponse.send( Response::OK, "text/plain", payload.c_str() ) ;
+
+		REQUIRE( payloadOf( longResponse.sent ) == payload ) ;
+		REQUIRE( longResponse.transmitN == ( longResponse.sent.size() + HTTP_RESPONSE_BUFFER_SIZE - 1 ) / HTTP_RESPONSE_BUFFER_SIZE ) ;
+		REQUIRE( longResponse.keepAlive() ) ;
+
+		// From flash memory
+		RecordingWriter flashResponse( defaultHeader() ) ;
+		flashResponse.prepare( false, true, false ) ;
+		flashResponse.send( Response::NOT_FOUND, "text/html", F( "<p>Not here</p>" ) ) ;
+
+		REQUIRE( flashResponse.sent.find( "HTTP/1.1 404 NOT FOUND \r\n" ) == 0 ) ;
+		REQUIRE( hasField( flashResponse.sent, "Content-Length: 15" ) ) ;
+		REQUIRE( hasField( flashResponse.sent, "Connection: close" ) ) ;
+		REQUIRE( payloadOf( flashResponse.sent ) == "<p>Not here</p>" ) ;
+		REQUIRE( ! flashResponse.keepAlive() ) ;
+
+		// Ended without a payload
+		RecordingWriter emptyResponse( defaultHeader() ) ;
+		emptyResponse.prepare( true, true, false ) ;
+		emptyResponse.end() ;
+
+		REQUIRE( hasField( emptyResponse.sent, "Content-Length: 0" ) ) ;
+		REQUIRE( payloadOf( emptyResponse.sent ) == "" ) ;
+		REQUIRE( emptyResponse.keepAlive() ) ;
+	}
+
+static void testChunks()
+	{
+		// Payloads that end around the buffer boundaries, written in pieces of several sizes
+		for( size_t length : { 0, 1, 100, HTTP_RESPONSE_BUFFER_SIZE - 100, HTTP_RESPONSE_BUFFER_SIZE - 8, HTTP_RESPONSE_BUFFER_SIZE, 5 * HTTP_RESPONSE_BUFFER_SIZE + 3 } )
+			for( size_t pieceSize : { 1, 7, 64, HTTP_RESPONSE_BUFFER_SIZE + 1 } )
+				{
+					const std::string payload = payloadOfLength( length ) ;
+
+					RecordingWriter response( defaultHeader() ) ;
+					response.prepare( true, true, false ) ;
+					response.begin( Response::OK, "text/plain" ) ;
+
+					for( size_t start = 0 ; start < length ; start += pieceSize )
+						REQUIRE( response.write( ( const uint8_t * ) payload.data() + start, min( pieceSize, length - start ) ) == min( pieceSize, length - start ) ) ;
+
+					response.end() ;
+
+					REQUIRE( hasField( response.sent, "Transfer-Encoding: chunked" ) ) ;
+					REQUIRE( ! hasField( response.sent, "Content-Length: 0" ) ) ;
+					REQUIRE( hasField( response.sent, "Connection: keep-alive" ) ) ;
+					REQUIRE( unchunk( payloadOf( response.sent ) ) == payload ) ;
+					REQUIRE( response.keepAlive() ) ;
+				}
+
+		// Print formats numbers into the chunks too
+		RecordingWriter response( defaultHeader() ) ;
+		response.prepare( true, true, false ) ;
+		response.print( 42 ) ;
+		response.println( " s" ) ;
+		response.end() ;
+
+		REQUIRE( response.sent.find( "HTTP/1.1 200 OK\r\n" ) == 0 ) ;
+		REQUIRE( unchunk( payloadOf( response.sent ) ) == "42 s\r\n" ) ;
+
+		// Without keep-alive, or for HTTP/1.0 clients, the end is marked by closing instead
+		for( bool keepAlive : { false, true } )
+			{
+				RecordingWriter closing( defaultHeader() ) ;
+				closing.prepare( keepAlive, ! keepAlive, false ) ;
+				closing.begin( Response::OK, "text/plain" ) ;
+				closing.print( "unframed" ) ;
+				closing.end() ;
+
+				REQUIRE( ! hasField( closing.sent, "Transfer-Encoding: chunked" ) ) ;
+				REQUIRE( hasField( closing.sent, "Connection: close" ) ) ;
+				REQUIRE( payloadOf( closing.sent ) == "unframed" ) ;
+				REQUIRE( ! closing.keepAlive() ) ;
+			}
+	}
+
+static void testHead()
+	{
+		// The header is the one of the GET response, the payload is left out
+		RecordingWriter response( defaultHeader() ) ;
+		response.prepare( true, true, true ) ;
+		response.send( Response::OK, "text/plain", "hello" ) ;
+
+		REQUIRE( hasField( response.sent, "Content-Length: 5" ) ) ;
+		REQUIRE( payloadOf( response.sent ) == "" ) ;
+		REQUIRE( response.keepAlive() ) ;
+
+		// Not even the last chunk
+		RecordingWriter chunked( defaultHeader() ) ;
+		chunked.prepare( true, true, true ) ;
+		chunked.begin( Response::OK, "text/plain" ) ;
+		REQUIRE( chunked.print( payloadOfLength( 3 * HTTP_RESPONSE_BUFFER_SIZE ).c_str() ) == 3 * HTTP_RESPONSE_BUFFER_SIZE ) ;
+		chunked.end() ;
+
+		REQUIRE( hasField( chunked.sent, "Transfer-Encoding: chunked" ) ) ;
+		REQUIRE( payloadOf( chunked.sent ) == "" ) ;
+		REQUIRE( chunked.transmitN == 1 ) ;
+		REQUIRE( chunked.keepAlive() ) ;
+
+		// A payload that doesn't match the length still closes the connection
+		RecordingWriter wrongLength( defaultHeader() ) ;
+		wrongLength.prepare( true, true, true ) ;
+		wrongLength.begin( Response::OK, "text/plain", 10 ) ;
+		wrongLength.print( "short" ) ;
+		wrongLength.end() ;
+
+		REQUIRE( payloadOf( wrongLength.sent ) == "" ) ;
+		REQUIRE( ! wrongLength.keepAlive() ) ;
+	}
+
+static void testBrokenResponses()
+	{
+		// Shorter or longer than its Content-Length: the client can only tell the end by the connection closing
+		for( const char * payload : { "four", "sixsix" } )
+			{
+				RecordingWriter response( defaultHeader() ) ;
+				response.prepare( true, true, false ) ;
+				response.begin( Response::OK, "text/plain", 5 ) ;
+				response.print( payload ) ;
+				response.end() ;
+
+				REQUIRE( payloadOf( response.sent ) == payload ) ;
+				REQUIRE( ! response.keepAlive() ) ;
+			}
+
+		// The connection breaks halfway
+		RecordingWriter broken( defaultHeader() ) ;
+		broken.room = HTTP_RESPONSE_BUFFER_SIZE + 10 ;
+		broken.prepare( true, true, false ) ;
+		broken.begin( Response::OK, "text/plain" ) ;
+
+		size_t written = 0 ;
+		for( int n = 0 ; n < 10 ; ++ n )
+			written += broken.print( payloadOfLength( HTTP_RESPONSE_BUFFER_SIZE / 2 ).c_str() ) ;
+
+		broken.end() ;
+
+		REQUIRE( written < 10 * HTTP_RESPONSE_BUFFER_SIZE / 2 ) ;
+		REQUIRE( broken.sent.size() == HTTP_RESPONSE_BUFFER_SIZE + 10 ) ;
+		REQUIRE( broken.transmitN == 2 ) ;
+		REQUIRE( ! broken.keepAlive() ) ;
+
+		// A whole header instead of the default one
+		http::ResponseHeader header = defaultHeader() ;
+		header.responseCode = Response::MOVED_PERMANENTLY ;
+		header.location = "/new" ;
+		header.pragma = "no-cache\nx-test\n" ;
+
+		RecordingWriter moved( defaultHeader() ) ;
+		moved.prepare( true, true, false ) ;
+		moved.begin( header, 0 ) ;
+		moved.end() ;
+
+		REQUIRE( moved.sent.find( "HTTP/1.1 301 MOVED PERMANENTLY \r\n" ) == 0 ) ;
+		REQUIRE( hasField( moved.sent, "Location: /new" ) ) ;
+		REQUIRE( hasField( moved.sent, "Pragma: no-cache" ) ) ;
+		REQUIRE( hasField( moved.sent, "Pragma: x-test" ) ) ;
+		REQUIRE( hasField( moved.sent, "Server: Test/1.0" ) ) ;
+	}
+
+int main()
+	{
+		testKnownLength() ;
+		testChunks() ;
+		testHead() ;
+		testBrokenResponses() ;
+
+		return 0 ;
+	}
@@ -1,5 +1,9 @@
 #include "httpHeader.hpp"
 
+// headerToString() takes them by reference, which in C++11 needs a definition
+constexpr uint8_t http::ResponseHeader::fieldN ;
+constexpr uint8_t http::RequestHeader::fieldN ;
+
 const String requestMethodString[]
 	{
 		"INVALID" , // Internally used value
@@ -61,7 +65,9 @@ const String responseString[]
 		"422 UNPROCESSABLE ENTITY" ,
 		"426 UPGRADE REQUIRED" ,
 		"429 RETRY WITH" ,
-		"451 UNAVAILABLE FOR LEGAL REASONS"
+		"431 REQUEST HEADER FIELDS TOO LARGE" ,
+		"451 UNAVAILABLE FOR LEGAL REASONS" ,
+		"501 NOT IMPLEMENTED"
 	} ;
 
 http::Request_t::operator String() const
@@ -69,6 +75,11 @@ http::Request_t::operator String() const
 		return requestMethodString[ (uint8_t) requestId ] ;
 	}
 
+const char * http::Request_t::c_str() const
+	{
+		return requestMethodString[ ( uint8_t ) requestId ].c_str() ;
+	}
+
 http::Request_t::operator Request() const
 {
 	return requestId ;
@@ -90,6 +101,11 @@ http::Response_t::operator Response() const
 		return responseId ;
 	}
 
+const char * http::Response_t::c_str() const
+	{
+		return responseString[ ( uint8_t ) responseId ].c_str() ;
+	}
+
 /**
  * Main serialization function for HTTP header classes
  * Here is where much of the job is done
@@ -174,6 +190,9 @@ String headerToString( const uint8_t & fieldN, const http::Field * const * field
 
 http::ResponseHeader & http::ResponseHeader::operator = ( const ResponseHeader & other )
 	{
+		version				= other.version ;
+		responseCode	= other.responseCode ;
+
 		for( auto n = 0 ; n < fieldN ; ++ n )
 			fieldArray[ n ]->value = other.fieldArray[ n ]->value ;
 
@@ -201,6 +220,10 @@ http::RequestHeader::operator String() const
 
 http::RequestHeader & http::RequestHeader::operator = ( const RequestHeader & other )
 	{
+		requestMethod = other.requestMethod ;
+		requestTarget = other.requestTarget ;
+		version				= other.version ;
+
 		for( auto n = 0 ; n < fieldN ; ++ n )
 			fieldArray[ n ]->value = other.fieldArray[ n ]->value ;
 
@@ -92,7 +92,9 @@ enum class http::Response
 		UNPROCESSABLE_ENTITY ,
 		UPGRADE_REQUIRED ,
 		RETRY_WITH ,
-		UNAVAILABLE_FOR_LEGAL_REASONS
+		REQUEST_HEADER_FIELDS_TOO_LARGE ,
+		UNAVAILABLE_FOR_LEGAL_REASONS ,
+		NOT_IMPLEMENTED
 	} ;
 
 /**
@@ -111,6 +113,9 @@ class http::Request_t
 			operator Request() const ;
 			Request operator = ( const Request & ) ;
 
+			/// The method name, without building a String
+			const char * c_str() const ;
+
 		private:
 
 			Request requestId = Request::INVALID ;
@@ -137,6 +142,9 @@ class http::Response_t
 			operator String() const ;
 			operator Response() const ;
 
+			/// The code and reason phrase, without building a String
+			const char * c_str() const ;
+
 		private:
 
 			Response responseId ;
@@ -172,6 +180,10 @@ struct http::Field
  */
 struct http::ResponseHeader
 	{
+		ResponseHeader() = default ;
+
+		// fieldArray has to point to the fields of the copy, so copy field by field
+		ResponseHeader( const ResponseHeader & other ) { * this = other ; }
 		ResponseHeader & operator = ( const ResponseHeader & ) ;
 
 		String version ;
@@ -214,7 +226,7 @@ struct http::ResponseHeader
 
 		// This array allows to access header fields in a iterative way.
 		// Used in serialization procedures
-		const Field * const fieldArray[ fieldN ]
+		Field * const fieldArray[ fieldN ]
 			{
 				// pragma needs to be the first element of the array
 				// to corretly execute the serialization
@@ -231,6 +243,10 @@ struct http::ResponseHeader
  */
 struct http::RequestHeader
 	{
+		RequestHeader() = default ;
+
+		// fieldArray has to point to the fields of the copy, so copy field by field
+		RequestHeader( const RequestHeader & other ) { * this = other ; }
 		RequestHeader & operator = ( const RequestHeader & ) ;
 
 		Request_t requestMethod = Request::INVALID ;
@@ -19,6 +19,7 @@ struct http::RequestMessage
 		RequestHeader header ;
 		String payload ;
 		bool parsingFailed = false ;
+		Response_t parsingError = Response::BAD_REQUEST ; ///< Response code for a failed request
 	} ;
 
 /// Struct representing a whole HTTP response message
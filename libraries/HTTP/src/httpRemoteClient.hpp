@@ -1,11 +1,15 @@
 #pragma once
 
 #include "httpMessage.hpp"
+#include "httpResponseWriter.hpp"
 
 namespace http
 	{
 		template < class Client_t >
 			class RemoteClient ;
+
+		template < class Client_t >
+			class RemoteClientWriter ;
 	}
 
 /**
@@ -29,16 +33,36 @@ class http::RemoteClient
 					client.write( String( message ).c_str() ) ;
 				}
 
+			inline size_t write( const uint8_t * buffer, size_t length ) const
+				{
+					return client.write( buffer, length ) ;
+				}
+
 			inline char read() const
 				{
 					return client.read() ;
 				}
 
+			/**
+			 * Read the bytes already received, up to length
+			 *
+			 * @return the number of bytes read, 0 or less if there were none
+			 */
+			inline int read( char * buffer, size_t length ) const
+				{
+					return client.read( ( uint8_t * ) buffer, length ) ;
+				}
+
 			inline bool available() const
 				{
 					return client.available() ;
 				}
 
+			inline bool connected() const
+				{
+					return client.connected() ;
+				}
+
 			inline void close() const
 				{
 					client.stop() ;
@@ -52,5 +76,31 @@ class http::RemoteClient
 
 		private:
 
-			Client_t client ;
+			// The transport layer API isn't const, while this class only adapts it
+			mutable Client_t client ;
+	} ;
+
+/**
+ * Template class that streams a HTTP response to a remote client
+ *
+ * @param Client_t The class representing the socket of the transport layer
+ */
+template < class Client_t >
+class http::RemoteClientWriter : public http::ResponseWriter
+	{
+		public:
+
+			RemoteClientWriter( const RemoteClient < Client_t > & client_, const ResponseHeader & defaultHeader ) :
+				ResponseWriter( defaultHeader ), client( client_ ) {} ;
+
+		protected:
+
+			bool transmit( const uint8_t * data, size_t length ) override
+				{
+					return client.write( data, length ) == length ;
+				}
+
+		private:
+
+			const RemoteClient < Client_t > & client ;
 	} ;
@@ -0,0 +1,417 @@
+#include "httpRequestParser.hpp"
+
+namespace
+	{
+		// The field names as they are compared, in the order of http::HeaderField
+		const char * const fieldNames[]
+			{
+				"pragma" ,
+				"connection" ,
+				"cache-control" ,
+				"expect" ,
+				"host" ,
+				"max-forwards" ,
+				"range" ,
+				"te" ,
+				"if-match" ,
+				"if-none-match" ,
+				"if-modified-since" ,
+				"if-unmodified-since" ,
+				"if-range" ,
+				"accept" ,
+				"accept-charset" ,
+				"accept-encoding" ,
+				"accept-language" ,
+				"authorization" ,
+				"proxy-authorization" ,
+				"from" ,
+				"referer" ,
+				"user-agent" ,
+				"content-length" ,
+				"transfer-encoding"
+			} ;
+
+		/* Perfect hash of the field names: every known name lands in its own slot
+		 * of fieldTable, so a lookup costs one hash and one comparison.
+		 *
+		 * IMPLEMENTATION NOTE:
+		 * The table has to be recomputed whenever a name is added to fieldNames,
+		 * trying other multipliers if two names end up in the same slot
+		 */
+		constexpr uint8_t fieldTableSize = 64 ;
+
+		inline char toLower( const char c )
+			{
+				return c >= 'A' && c <= 'Z' ? c + ( 'a' - 'A' ) : c ;
+			}
+
+		inline uint8_t fieldHash( const char * name, const size_t length )
+			{
+				return (
+						length * 5 +
+						( ( uint8_t ) toLower( name[ 0 ] ) << 1 ) +
+						( ( uint8_t ) toLower( name[ length - 1 ] ) << 4 )
+					) & ( fieldTableSize - 1 ) ;
+			}
+
+		using http::HeaderField ;
+
+		const HeaderField fieldTable[ fieldTableSize ]
+			{
+				HeaderField::UNKNOWN ,							HeaderField::IF_UNMODIFIED_SINCE ,
+				HeaderField::TE ,										HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::MAX_FORWARDS ,					HeaderField::CACHE_CONTROL ,
+				HeaderField::ACCEPT_CHARSET ,				HeaderField::UNKNOWN ,
+				HeaderField::IF_RANGE ,							HeaderField::UNKNOWN ,
+				HeaderField::CONTENT_LENGTH ,				HeaderField::RANGE ,
+				HeaderField::PRAGMA ,								HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::IF_NONE_MATCH ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::CONNECTION ,						HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::USER_AGENT ,						HeaderField::ACCEPT_LANGUAGE ,
+				HeaderField::UNKNOWN ,							HeaderField::PROXY_AUTHORIZATION ,
+				HeaderField::ACCEPT ,								HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::AUTHORIZATION ,
+				HeaderField::HOST ,									HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::REFERER ,
+				HeaderField::EXPECT ,								HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::TRANSFER_ENCODING ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::FROM ,									HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::IF_MODIFIED_SINCE ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN ,
+				HeaderField::IF_MATCH ,							HeaderField::UNKNOWN ,
+				HeaderField::UNKNOWN ,							HeaderField::ACCEPT_ENCODING ,
+				HeaderField::UNKNOWN ,							HeaderField::UNKNOWN
+			} ;
+
+		inline bool isWhitespace( const char c )
+			{
+				return c == ' ' || c == '\t' ;
+			}
+	}
+
+bool http::StringView::operator == ( const char * text ) const
+	{
+		return strncmp( data, text, length ) == 0 && text[ length ] == '\0' ;
+	}
+
+bool http::StringView::equalsIgnoreCase( const char * text ) const
+	{
+		for( size_t n = 0 ; n < length ; ++ n )
+			if( toLower( data[ n ] ) != toLower( text[ n ] ) ) return false ;
+
+		return text[ length ] == '\0' ;
+	}
+
+http::StringView::operator String() const
+	{
+		String text ;
+		text.reserve( length ) ;
+
+		for( size_t n = 0 ; n < length ; ++ n )
+			text += data[ n ] ;
+
+		return text ;
+	}
+
+http::HeaderField http::RequestParser::lookupField( const char * name, size_t length )
+	{
+		if( length == 0 ) return HeaderField::UNKNOWN ;
+
+		const HeaderField candidate = fieldTable[ fieldHash( name, length ) ] ;
+
+		if( candidate == HeaderField::UNKNOWN ) return candidate ;
+
+		// Different names can have the same hash, so check the name too
+		const StringView view { name, length } ;
+
+		return view.equalsIgnoreCase( fieldNames[ ( uint8_t ) candidate ] ) ?
+			candidate : HeaderField::UNKNOWN ;
+	}
+
+http::RequestParser::RequestParser()
+	{
+		reset() ;
+	}
+
+void http::RequestParser::reset()
+	{
+		bufferLength	= 0 ;
+		lineStart			= 0 ;
+		scanPosition	= 0 ;
+		payloadStart	= 0 ;
+		contentLength	= 0 ;
+
+		state					= State::REQUEST_LINE ;
+		currentStatus	= Status::INCOMPLETE ;
+		errorCode			= Response::BAD_REQUEST ;
+
+		requestMethod		= Request::INVALID ;
+		requestTarget		= StringView() ;
+		requestVersion	= StringView() ;
+		messagePayload	= StringView() ;
+
+		for( auto & field : fields )
+			field = StringView() ;
+	}
+
+size_t http::RequestParser::next()
+	{
+		const size_t length = currentStatus == Status::COMPLETE ?
+			bufferLength - messageLength() : 0 ;
+
+		memmove( buffer, buffer + messageLength(), length ) ;
+
+		reset() ;
+		received( length ) ;
+
+		return length ;
+	}
+
+http::RequestParser::Status http::RequestParser::parse( const char * data, size_t length )
+	{
+		if( length > receiveSpace() )
+			length = receiveSpace() ;
+
+		memcpy( receiveBuffer(), data, length ) ;
+
+		return received( length ) ;
+	}
+
+http::RequestParser::Status http::RequestParser::fail( const Response & reason )
+	{
+		if( currentStatus == Status::INCOMPLETE )
+			{
+				currentStatus = Status::FAILED ;
+				errorCode			= reason ;
+			}
+
+		return currentStatus ;
+	}
+
+http::RequestParser::Status http::RequestParser::received( size_t length )
+	{
+		bufferLength += length ;
+
+		if( currentStatus != Status::INCOMPLETE ) return currentStatus ;
+
+		// Parse every line that is complete
+		while( state == State::REQUEST_LINE || state == State::HEADER_FIELDS )
+			{
+				const char * lineEnd = ( const char * ) memchr(
+						buffer + scanPosition, '\n', bufferLength - scanPosition
+					) ;
+
+				if( lineEnd == nullptr )
+					{
+						scanPosition = bufferLength ;
+
+						// A method is never longer than 7 chars, so don't wait
+						// for the rest of the line to reject a wrong one
+						if(
+								state == State::REQUEST_LINE &&
+								bufferLength - lineStart > 7 &&
+								memchr( buffer + lineStart, ' ', 8 ) == nullptr
+							)
+							return fail( Response::BAD_REQUEST ) ;
+
+						if( receiveSpace() == 0 )
+							return fail(
+									state == State::REQUEST_LINE ?
+										Response::URI_TOO_LONG : Response::REQUEST_HEADER_FIELDS_TOO_LARGE
+								) ;
+
+						return currentStatus ;
+					}
+
+				const char * line = buffer + lineStart ;
+				size_t lineLength = lineEnd - line ;
+
+				// Lines should end with CR LF, but a bare LF is accepted too
+				if( lineLength > 0 && line[ lineLength - 1 ] == '\r' )
+					-- lineLength ;
+
+				lineStart = scanPosition = lineEnd - buffer + 1 ;
+
+				if( state == State::REQUEST_LINE )
+					{
+						// As HTTP/1.1 specification states, ignore empty lines before the request line
+						if( lineLength == 0 ) continue ;
+
+						if( parseRequestLine( line, lineLength ) == Status::FAILED ) return currentStatus ;
+
+						state = State::HEADER_FIELDS ;
+					}
+					else if( lineLength == 0 )
+						{
+							// Header-payload separator
+							payloadStart = lineStart ;
+							state = State::PAYLOAD ;
+						}
+					else if( parseHeaderField( line, lineLength ) == Status::FAILED ) return currentStatus ;
+			}
+
+		if( state == State::PAYLOAD )
+			{
+				if( contentLength > HTTP_REQUEST_BUFFER_SIZE - payloadStart )
+					return fail( Response::ENTITY_TOO_LARGE ) ;
+
+				if( bufferLength - payloadStart < contentLength ) return currentStatus ;
+
+				messagePayload = { buffer + payloadStart, contentLength } ;
+				state = State::DONE ;
+				currentStatus = Status::COMPLETE ;
+			}
+
+		return currentStatus ;
+	}
+
+http::RequestParser::Status http::RequestParser::parseRequestLine( const char * line, size_t length )
+	{
+		const char * const lineEnd = line + length ;
+
+		// Split the line into its three words
+		const char * methodEnd = ( const char * ) memchr( line, ' ', length ) ;
+		if( methodEnd == nullptr ) return fail( Response::BAD_REQUEST ) ;
+
+		const char * target = methodEnd + 1 ;
+		const char * targetEnd = ( const char * ) memchr( target, ' ', lineEnd - target ) ;
+		if( targetEnd == nullptr || targetEnd == target ) return fail( Response::BAD_REQUEST ) ;
+
+		const char * version = targetEnd + 1 ;
+
+		// Match the method by its length first
+		auto isMethod = [ & ]( const char * name ) -> bool
+			{
+				return strncmp( line, name, methodEnd - line ) == 0 ;
+			} ;
+
+		switch( methodEnd - line )
+			{
+				case 3 :
+					requestMethod =
+						isMethod( "GET" ) ? Request::GET :
+						isMethod( "PUT" ) ? Request::PUT : Request::INVALID ;
+					break ;
+
+				case 4 :
+					requestMethod =
+						isMethod( "HEAD" ) ? Request::HEAD :
+						isMethod( "POST" ) ? Request::POST : Request::INVALID ;
+					break ;
+
+				case 5 :
+					requestMethod = isMethod( "TRACE" ) ? Request::TRACE : Request::INVALID ;
+					break ;
+
+				case 6 :
+					requestMethod = isMethod( "DELETE" ) ? Request::DELETE : Request::INVALID ;
+					break ;
+
+				case 7 :
+					requestMethod =
+						isMethod( "OPTIONS" ) ? Request::OPTIONS :
+						isMethod( "CONNECT" ) ? Request::CONNECT : Request::INVALID ;
+					break ;
+			}
+
+		requestTarget		= { target, ( size_t ) ( targetEnd - target ) } ;
+		requestVersion	= { version, ( size_t ) ( lineEnd - version ) } ;
+
+		if(
+				( Request ) requestMethod == Request::INVALID ||
+				requestVersion.length != 8 ||
+				strncmp( version, "HTTP/1.", 7 ) != 0
+			)
+			return fail( Response::BAD_REQUEST ) ;
+
+		return currentStatus ;
+	}
+
+http::RequestParser::Status http::RequestParser::parseHeaderField( const char * line, size_t length )
+	{
+		/* As HTTP/1.1 specification states, reject fields folded on multiple lines
+		 * and whitespace between the field name and the colon
+		 */
+		const char * colon = ( const char * ) memchr( line, ':', length ) ;
+
+		if( isWhitespace( line[ 0 ] ) || colon == nullptr || colon == line || isWhitespace( colon[ -1 ] ) )
+			return fail( Response::BAD_REQUEST ) ;
+
+		const HeaderField name = lookupField( line, colon - line ) ;
+
+		// Fields unknown to the parser are ignored
+		if( name == HeaderField::UNKNOWN ) return currentStatus ;
+
+		// Trim the whitespace around the value
+		const char * value = colon + 1 ;
+		const char * valueEnd = line + length ;
+
+		while( value < valueEnd && isWhitespace( * value ) ) ++ value ;
+		while( valueEnd > value && isWhitespace( valueEnd[ -1 ] ) ) -- valueEnd ;
+
+		StringView & field = fields[ ( uint8_t ) name ] ;
+
+		switch( name )
+			{
+				case HeaderField::CONTENT_LENGTH :
+					{
+						// Repeated Content-Length fields could be used to smuggle requests
+						if( field.data != nullptr || value == valueEnd )
+							return fail( Response::BAD_REQUEST ) ;
+
+						for( const char * digit = value ; digit < valueEnd ; ++ digit )
+							{
+								if( * digit < '0' || * digit > '9' )
+									return fail( Response::BAD_REQUEST ) ;
+
+								contentLength = contentLength * 10 + ( * digit - '0' ) ;
+
+								// Reject the request as soon as it is known not to fit the buffer
+								if( contentLength > HTTP_REQUEST_BUFFER_SIZE - lineStart )
+									return fail( Response::ENTITY_TOO_LARGE ) ;
+							}
+
+						break ;
+					}
+
+				case HeaderField::TRANSFER_ENCODING :
+					// Chunked payloads are not supported
+					return fail( Response::NOT_IMPLEMENTED ) ;
+
+				default :
+					// Keep only the first occurrence of a repeated field
+					if( field.data != nullptr ) return currentStatus ;
+					break ;
+			}
+
+		field = { value, ( size_t ) ( valueEnd - value ) } ;
+
+		return currentStatus ;
+	}
+
+void http::RequestParser::copyTo( RequestMessage & message ) const
+	{
+		message.parsingFailed = currentStatus != Status::COMPLETE ;
+		message.parsingError	= errorCode ;
+
+		if( message.parsingFailed ) return ;
+
+		message.header.requestMethod = requestMethod ;
+		message.header.requestTarget = requestTarget ;
+		message.header.version			 = requestVersion ;
+
+		for( uint8_t n = 0 ; n < RequestHeader::fieldN ; ++ n )
+			if( fields[ n ].length > 0 )
+				message.header.fieldArray[ n ]->value = fields[ n ] ;
+
+		message.payload = messagePayload ;
+	}
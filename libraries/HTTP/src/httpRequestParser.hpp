@@ -0,0 +1,231 @@
+/**
+ * @file
+ * @brief Header file containing the incremental HTTP request parser
+ */
+
+#pragma once
+
+#include "httpMessage.hpp"
+
+/* Size of the buffer that holds a whole request ( request line, header fields
+ * and payload ) while it is parsed.
+ * Requests that don't fit are rejected as soon as this is known.
+ * Define it before including the library to change it
+ */
+#ifndef HTTP_REQUEST_BUFFER_SIZE
+	#if defined( __AVR__ )
+		#define HTTP_REQUEST_BUFFER_SIZE 384
+	#else
+		#define HTTP_REQUEST_BUFFER_SIZE 2048
+	#endif
+#endif
+
+namespace http
+	{
+		struct StringView ;
+		enum class HeaderField : uint8_t ;
+		class RequestParser ;
+	}
+
+/**
+ * A read-only view of a piece of text that lives somewhere else,
+ * usually in the buffer of a RequestParser.
+ * It is not NUL terminated
+ *
+ * IMPLEMENTATION NOTE:
+ * Views are written as { data, length } all over the library.
+ * In C++11 a struct with default member initializers is not an aggregate,
+ * so the constructors are what makes that syntax work there
+ */
+struct http::StringView
+	{
+		constexpr StringView() : data( nullptr ), length( 0 ) {}
+
+		constexpr StringView( const char * data_, size_t length_ ) :
+			data( data_ ), length( length_ ) {}
+
+		const char * data ;
+		size_t length ;
+
+		bool operator == ( const char * text ) const ;
+		bool operator != ( const char * text ) const { return ! ( * this == text ) ; }
+
+		/// Compare with text ignoring the case of letters, as needed for field names
+		bool equalsIgnoreCase( const char * text ) const ;
+
+		/// Copy the text into a String
+		operator String() const ;
+	} ;
+
+/**
+ * The header fields known to the parser
+ *
+ * The first ones are in the same order as RequestHeader::fieldArray,
+ * so that a parsed request can be copied into a RequestMessage
+ */
+enum class http::HeaderField : uint8_t
+	{
+		PRAGMA = 0 ,
+		CONNECTION ,
+		CACHE_CONTROL ,
+		EXPECT ,
+		HOST ,
+		MAX_FORWARDS ,
+		RANGE ,
+		TE ,
+		IF_MATCH ,
+		IF_NONE_MATCH ,
+		IF_MODIFIED_SINCE ,
+		IF_UNMODIFIED_SINCE ,
+		IF_RANGE ,
+		ACCEPT ,
+		ACCEPT_CHARSET ,
+		ACCEPT_ENCODING ,
+		ACCEPT_LANGUAGE ,
+		AUTHORIZATION ,
+		PROXY_AUTHORIZATION ,
+		FROM ,
+		REFERER ,
+		USER_AGENT ,
+
+		// Fields used by the parser itself
+		CONTENT_LENGTH ,
+		TRANSFER_ENCODING ,
+
+		COUNT , // Number of known fields
+		UNKNOWN = COUNT
+	} ;
+
+/**
+ * Parser for HTTP requests that arrive a piece at a time
+ *
+ * The request is received straight into a fixed size buffer and parsed
+ * as it arrives, without allocating memory: the request line, the known
+ * header fields and the payload are exposed as views into the buffer,
+ * which stay valid until reset() is called.
+ * Parsing resumes where the previous piece ended, so the pieces can be
+ * split anywhere.
+ *
+ * Typical use:
+ *	while( parser.status() == RequestParser::Status::INCOMPLETE )
+ *		parser.received( client.read( parser.receiveBuffer(), parser.receiveSpace() ) ) ;
+ */
+class http::RequestParser
+	{
+		public:
+
+			enum class Status : uint8_t
+				{
+					INCOMPLETE , // More of the request is needed
+					COMPLETE ,
+					FAILED			// The request was rejected, error() tells why
+				} ;
+
+			RequestParser() ;
+
+			/// Forget the current request and get ready for a new one
+			void reset() ;
+
+			/**
+			 * Forget the current request, keeping the bytes received after it,
+			 * and parse them as the start of the next one.
+			 * These are the requests a client sends without waiting for the responses
+			 *
+			 * @return the number of bytes kept, 0 if the current request is not complete
+			 */
+			size_t next() ;
+
+			/// Where the next bytes of the request have to be stored
+			char * receiveBuffer() { return buffer + bufferLength ; }
+
+			/// Number of bytes that can be stored in receiveBuffer()
+			size_t receiveSpace() const { return HTTP_REQUEST_BUFFER_SIZE - bufferLength ; }
+
+			/**
+			 * Parse the bytes just stored in receiveBuffer()
+			 *
+			 * @param length	number of bytes stored
+			 * @return				the status of the request
+			 */
+			Status received( size_t length ) ;
+
+			/**
+			 * Copy the next piece of the request into the buffer and parse it
+			 *
+			 * @param data		the piece of the request
+			 * @param length	length of data
+			 * @return				the status of the request
+			 */
+			Status parse( const char * data, size_t length ) ;
+
+			/**
+			 * Give up on the current request, e.g. because the client stopped sending it
+			 *
+			 * @param reason	the response code to reply with
+			 * @return				Status::FAILED
+			 */
+			Status fail( const Response & reason ) ;
+
+			Status status() const { return currentStatus ; }
+
+			/// True if nothing of the request has been received yet
+			bool empty() const { return bufferLength == 0 ; }
+
+			/// The response code to reply with when the request was rejected
+			Response_t error() const { return errorCode ; }
+
+			Request_t method() const { return requestMethod ; }
+			const StringView & target() const { return requestTarget ; }
+			const StringView & version() const { return requestVersion ; }
+			const StringView & payload() const { return messagePayload ; }
+
+			/// The value of a header field, empty if the request didn't have it
+			const StringView & field( const HeaderField & name ) const
+				{
+					return fields[ ( uint8_t ) name ] ;
+				}
+
+			/// Number of bytes of the buffer taken up by the request
+			size_t messageLength() const { return payloadStart + contentLength ; }
+
+			/// Copy the parsed request into a RequestMessage
+			void copyTo( RequestMessage & message ) const ;
+
+			/**
+			 * Find a known header field by its name, ignoring case
+			 *
+			 * @param name		the field name, without the ':'
+			 * @param length	length of name
+			 */
+			static HeaderField lookupField( const char * name, size_t length ) ;
+
+		private:
+
+			enum class State : uint8_t
+				{
+					REQUEST_LINE ,
+					HEADER_FIELDS ,
+					PAYLOAD ,
+					DONE
+				} ;
+
+			Status parseRequestLine( const char * line, size_t length ) ;
+			Status parseHeaderField( const char * line, size_t length ) ;
+
+			char buffer[ HTTP_REQUEST_BUFFER_SIZE ] ;
+			size_t bufferLength ; // Bytes received so far
+			size_t lineStart ;		// Start of the line being received
+			size_t scanPosition ; // Where the search for the end of the line resumes
+			size_t payloadStart ;
+			size_t contentLength ;
+
+			State state ;
+			Status currentStatus ;
+			Response_t errorCode = Response::BAD_REQUEST ;
+
+			Request_t requestMethod = Request::INVALID ;
+			StringView requestTarget ;
+			StringView requestVersion ;
+			StringView messagePayload ;
+			StringView fields[ ( uint8_t ) HeaderField::COUNT ] ;
+	} ;
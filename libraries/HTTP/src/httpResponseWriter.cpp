@@ -0,0 +1,284 @@
+#include "httpResponseWriter.hpp"
+
+// The chunk size is written with 4 hex digits, and a chunk needs some room
+static_assert(
+		HTTP_RESPONSE_BUFFER_SIZE >= 16 && HTTP_RESPONSE_BUFFER_SIZE <= 0xFFFF ,
+		"HTTP_RESPONSE_BUFFER_SIZE must be between 16 and 65535"
+	) ;
+
+namespace
+	{
+		// Room taken by the chunk size, followed by CR LF, and by the CR LF after the chunk
+		constexpr size_t chunkHeaderLength	= 6 ;
+		constexpr size_t chunkTrailerLength = 2 ;
+	}
+
+http::ResponseWriter::ResponseWriter( const ResponseHeader & defaultHeader_ ) :
+	defaultHeader( defaultHeader_ ) {}
+
+void http::ResponseWriter::prepare( bool keepAlive_, bool chunkedAllowed_, bool headOnly_ )
+	{
+		keepConnection	= keepAlive_ ;
+		chunkedAllowed	= chunkedAllowed_ ;
+		headOnly				= headOnly_ ;
+	}
+
+void http::ResponseWriter::begin( const Response_t & responseCode, const char * contentType, long contentLength_ )
+	{
+		if( state != State::IDLE ) return ;
+
+		beginHeader( responseCode, defaultHeader, contentLength_ ) ;
+
+		if( contentType != nullptr )
+			sendField( "Content-Type", contentType ) ;
+	}
+
+void http::ResponseWriter::begin( const ResponseHeader & header, long contentLength_ )
+	{
+		if( state != State::IDLE ) return ;
+
+		beginHeader( header.responseCode, header, contentLength_ ) ;
+	}
+
+void http::ResponseWriter::beginHeader( const Response_t & responseCode, const ResponseHeader & header, long contentLength_ )
+	{
+		contentLength = contentLength_ ;
+
+		// Without a length the end of the payload is marked by chunks
+		// or, when they can't be used, by closing the connection
+		chunked = contentLength == UNKNOWN_LENGTH && keepConnection && chunkedAllowed ;
+
+		if( contentLength == UNKNOWN_LENGTH && ! chunked )
+			keepConnection = false ;
+
+		state = State::FIELDS ;
+
+		append( "HTTP/1.1 " ) ;
+		append( responseCode.c_str() ) ;
+		append( "\r\n" ) ;
+
+		/* NOTE:
+		 * As in headerToString(), fieldArray starts with pragma,
+		 * which is dealt with after the other fields.
+		 * Connection is left out, as it depends on the request
+		 */
+		for( uint8_t n = 1 ; n < ResponseHeader::fieldN ; ++ n )
+			{
+				const Field & field = * header.fieldArray[ n ] ;
+
+				if( & field == & header.connection || field.value.length() == 0 ) continue ;
+
+				append( field.tag.c_str() ) ;
+				append( " " ) ;
+				append( field.value.c_str() ) ;
+				append( "\r\n" ) ;
+			}
+
+		// The pragma field value holds all the pragma values, each terminated with a \n
+		const String & pragma = header.pragma.value ;
+
+		for( int start = 0, end ; ( end = pragma.indexOf( '\n', start ) ) >= 0 ; start = end + 1 )
+			{
+				append( "Pragma: " ) ;
+				append( pragma.c_str() + start, end - start ) ;
+				append( "\r\n" ) ;
+			}
+
+		if( chunked )
+			append( "Transfer-Encoding: chunked\r\n" ) ;
+			else if( contentLength != UNKNOWN_LENGTH )
+				{
+					char number[ 24 ] ;
+					char * digit = number + sizeof( number ) ;
+					unsigned long value = contentLength ;
+
+					* -- digit = '\0' ;
+
+					do
+						{
+							* -- digit = '0' + value % 10 ;
+							value /= 10 ;
+						}
+					while( value > 0 ) ;
+
+					append( "Content-Length: " ) ;
+					append( digit ) ;
+					append( "\r\n" ) ;
+				}
+
+		append( keepConnection ? "Connection: keep-alive\r\n" : "Connection: close\r\n" ) ;
+	}
+
+void http::ResponseWriter::sendField( const char * name, const char * value )
+	{
+		if( state != State::FIELDS ) return ;
+
+		append( name ) ;
+		append( ": " ) ;
+		append( value ) ;
+		append( "\r\n" ) ;
+	}
+
+void http::ResponseWriter::send( const Response_t & responseCode, const char * contentType, const char * payload )
+	{
+		begin( responseCode, contentType, strlen( payload ) ) ;
+		print( payload ) ;
+		end() ;
+	}
+
+void http::ResponseWriter::send(
+		const Response_t & responseCode ,
+		const char * contentType ,
+		const __FlashStringHelper * payload
+	)
+	{
+		begin( responseCode, contentType, strlen_P( ( PGM_P ) payload ) ) ;
+		print( payload ) ;
+		end() ;
+	}
+
+void http::ResponseWriter::beginPayload()
+	{
+		if( state == State::IDLE )
+			begin( Response::OK ) ;
+
+		// Header-payload separator
+		append( "\r\n" ) ;
+
+		if( chunkedPayload() )
+			{
+				// Make room for the size of the first chunk
+				if( bufferLength + chunkHeaderLength + chunkTrailerLength >= HTTP_RESPONSE_BUFFER_SIZE )
+					sendBuffer() ;
+
+				chunkStart = bufferLength ;
+				bufferLength += chunkHeaderLength ;
+			}
+
+		state = State::PAYLOAD ;
+	}
+
+size_t http::ResponseWriter::write( uint8_t byte )
+	{
+		return write( & byte, 1 ) ;
+	}
+
+size_t http::ResponseWriter::write( const uint8_t * data, size_t length )
+	{
+		if( state == State::ENDED ) return 0 ;
+
+		if( state != State::PAYLOAD )
+			beginPayload() ;
+
+		payloadLength += length ;
+
+		// The payload of a response to HEAD is left out, but its length still counts
+		if( headOnly ) return length ;
+
+		append( data, length ) ;
+
+		return failed ? 0 : length ;
+	}
+
+void http::ResponseWriter::end()
+	{
+		if( state == State::ENDED ) return ;
+
+		if( state == State::IDLE )
+			begin( Response::OK, nullptr, 0 ) ;
+
+		if( state == State::FIELDS )
+			beginPayload() ;
+
+		// If the payload doesn't match the length sent,
+		// the client can only find where it ends if the connection is closed
+		if( contentLength != UNKNOWN_LENGTH && payloadLength != contentLength )
+			keepConnection = false ;
+
+		if( chunkedPayload() )
+			closeChunk() ;
+
+		state = State::ENDED ;
+
+		// Last chunk
+		if( chunkedPayload() )
+			append( "0\r\n\r\n" ) ;
+
+		sendBuffer() ;
+	}
+
+void http::ResponseWriter::append( const char * text )
+	{
+		append( ( const uint8_t * ) text, strlen( text ) ) ;
+	}
+
+void http::ResponseWriter::append( const char * text, size_t length )
+	{
+		append( ( const uint8_t * ) text, length ) ;
+	}
+
+void http::ResponseWriter::append( const uint8_t * data, size_t length )
+	{
+		// Leave room for the CR LF after a chunk
+		const size_t capacity = HTTP_RESPONSE_BUFFER_SIZE -
+			( state == State::PAYLOAD && chunkedPayload() ? chunkTrailerLength : 0 ) ;
+
+		while( length > 0 && ! failed )
+			{
+				if( bufferLength == capacity )
+					sendBuffer() ;
+
+				const size_t pieceLength = min( length, capacity - bufferLength ) ;
+
+				memcpy( buffer + bufferLength, data, pieceLength ) ;
+				bufferLength += pieceLength ;
+				data += pieceLength ;
+				length -= pieceLength ;
+			}
+	}
+
+void http::ResponseWriter::closeChunk()
+	{
+		const size_t chunkLength = bufferLength - chunkStart - chunkHeaderLength ;
+
+		// An empty chunk would mark the end of the payload
+		if( chunkLength == 0 )
+			{
+				bufferLength = chunkStart ;
+				return ;
+			}
+
+		static const char hexDigits[] = "0123456789ABCDEF" ;
+
+		for( uint8_t n = 0 ; n < 4 ; ++ n )
+			buffer[ chunkStart + n ] = hexDigits[ ( chunkLength >> ( 12 - 4 * n ) ) & 0xF ] ;
+
+		buffer[ chunkStart + 4 ] = '\r' ;
+		buffer[ chunkStart + 5 ] = '\n' ;
+
+		buffer[ bufferLength ++ ] = '\r' ;
+		buffer[ bufferLength ++ ] = '\n' ;
+	}
+
+void http::ResponseWriter::sendBuffer()
+	{
+		const bool sendingChunks = state == State::PAYLOAD && chunkedPayload() ;
+
+		if( sendingChunks )
+			closeChunk() ;
+
+		if( bufferLength > 0 && ! failed && ! transmit( buffer, bufferLength ) )
+			{
+				failed = true ;
+				keepConnection = false ;
+			}
+
+		bufferLength = 0 ;
+
+		// Make room for the size of the next chunk
+		if( sendingChunks )
+			{
+				chunkStart = 0 ;
+				bufferLength = chunkHeaderLength ;
+			}
+	}
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @brief Header file containing the class that streams HTTP responses
+ */
+
+#pragma once
+
+#include "httpHeader.hpp"
+
+/* Size of the buffer that collects a response before it is sent.
+ * Every time it fills up its content is sent in one go,
+ * so bigger buffers mean fewer and bigger packets.
+ * Define it before including the library to change it
+ */
+#ifndef HTTP_RESPONSE_BUFFER_SIZE
+	#if defined( __AVR__ )
+		#define HTTP_RESPONSE_BUFFER_SIZE 64
+	#else
+		#define HTTP_RESPONSE_BUFFER_SIZE 512
+	#endif
+#endif
+
+namespace http
+	{
+		class ResponseWriter ;
+	}
+
+/**
+ * Streams a HTTP response to the client while it is being written,
+ * so that the whole response never has to be in memory
+ *
+ * The status line and the header fields are sent by begin(),
+ * then the payload is written with the Print API, e.g. print( F( "..." ) )
+ * to send text straight from flash memory.
+ * If the length of the payload is not given to begin() it is sent
+ * in chunks, so that the connection can be kept alive anyway.
+ *
+ * The transport layer is reached through transmit(), implemented by derived classes
+ */
+class http::ResponseWriter : public Print
+	{
+		public:
+
+			/// Content length to give to begin() when it isn't known in advance
+			static constexpr long UNKNOWN_LENGTH = -1 ;
+
+			explicit ResponseWriter( const ResponseHeader & defaultHeader ) ;
+
+			/**
+			 * Set how the response has to be sent, before it is begun.
+			 * Used by the server, according to the request
+			 *
+			 * @param keepAlive				true if the connection can be kept open after the response
+			 * @param chunkedAllowed	true if the client understands chunked payloads ( HTTP/1.1 )
+			 * @param headOnly				true if the payload has to be left out ( HEAD requests )
+			 */
+			void prepare( bool keepAlive, bool chunkedAllowed, bool headOnly ) ;
+
+			/**
+			 * Send the status line and the header fields
+			 *
+			 * @param responseCode		the response code
+			 * @param contentType			the value of the Content-Type field, or nullptr
+			 * @param contentLength		the length of the payload, or UNKNOWN_LENGTH
+			 */
+			void begin(
+					const Response_t & responseCode ,
+					const char * contentType = nullptr ,
+					long contentLength = UNKNOWN_LENGTH
+				) ;
+
+			/**
+			 * Send the status line and the fields of a whole response header
+			 *
+			 * @param header					the header to send in place of the default one
+			 * @param contentLength		the length of the payload, or UNKNOWN_LENGTH
+			 */
+			void begin( const ResponseHeader & header, long contentLength = UNKNOWN_LENGTH ) ;
+
+			/// Send one more header field, after begin() and before the payload
+			void sendField( const char * name, const char * value ) ;
+
+			/// Send a whole response
+			void send( const Response_t & responseCode, const char * contentType, const char * payload ) ;
+
+			/// Send a whole response whose payload is stored in flash memory
+			void send(
+					const Response_t & responseCode ,
+					const char * contentType ,
+					const __FlashStringHelper * payload
+				) ;
+
+			// Inherited from Print, used to write the payload
+			size_t write( uint8_t byte ) override ;
+			size_t write( const uint8_t * data, size_t length ) override ;
+			using Print::write ;
+
+			/// Finish the response, sending what is left of it
+			void end() ;
+
+			/// True if the response has been begun
+			bool begun() const { return state != State::IDLE ; }
+
+			/// True if the connection can be kept open after the response
+			bool keepAlive() const { return keepConnection ; }
+
+		protected:
+
+			/**
+			 * Send a piece of the response to the client
+			 *
+			 * @return true if all of it was sent
+			 */
+			virtual bool transmit( const uint8_t * data, size_t length ) = 0 ;
+
+		private:
+
+			enum class State : uint8_t
+				{
+					IDLE ,		// Nothing has been sent yet
+					FIELDS ,	// Sending the header fields
+					PAYLOAD ,
+					ENDED
+				} ;
+
+			void beginHeader( const Response_t & responseCode, const ResponseHeader & header, long contentLength ) ;
+			void beginPayload() ;
+			void append( const char * text ) ;
+			void append( const char * text, size_t length ) ;
+			void append( const uint8_t * data, size_t length ) ;
+
+			/// Write the size of the current chunk before it and the CR LF after it
+			void closeChunk() ;
+
+			/// Send the content of the buffer
+			void sendBuffer() ;
+
+			bool chunkedPayload() const { return chunked && ! headOnly ; }
+
+			const ResponseHeader & defaultHeader ;
+
+			uint8_t buffer[ HTTP_RESPONSE_BUFFER_SIZE ] ;
+			size_t bufferLength = 0 ;
+			size_t chunkStart = 0 ; // Where the size of the current chunk goes
+
+			State state = State::IDLE ;
+			bool keepConnection = false ;
+			bool chunkedAllowed = false ;
+			bool headOnly = false ;
+			bool chunked = false ;
+			bool failed = false ;
+
+			long contentLength = UNKNOWN_LENGTH ;
+			long payloadLength = 0 ;
+	} ;
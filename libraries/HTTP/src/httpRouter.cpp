@@ -0,0 +1,212 @@
+#include "httpRouter.hpp"
+
+namespace
+	{
+		enum class SegmentType : uint8_t
+			{
+				NAME ,
+				PARAMETER ,
+				WILDCARD
+			} ;
+
+		inline SegmentType segmentType( const char * name )
+			{
+				return
+					name[ 0 ] == ':' ? SegmentType::PARAMETER :
+					name[ 0 ] == '*' ? SegmentType::WILDCARD	: SegmentType::NAME ;
+			}
+	}
+
+http::StringView http::RouteRequest::parameter( const char * name ) const
+	{
+		for( uint8_t n = 0 ; n < parameterN ; ++ n )
+			if( parameterNames[ n ] == name ) return parameterValues[ n ] ;
+
+		return StringView() ;
+	}
+
+http::Router::Router()
+	{
+		segments[ 0 ] = { "", 0, NONE, NONE, NONE } ;
+	}
+
+uint8_t http::Router::findChild( uint8_t parent, const char * name, uint8_t length ) const
+	{
+		for( uint8_t child = segments[ parent ].firstChild ; child != NONE ; child = segments[ child ].nextSibling )
+			if( segments[ child ].length == length && memcmp( segments[ child ].name, name, length ) == 0 )
+				return child ;
+
+		return NONE ;
+	}
+
+bool http::Router::add( const Request & method, const char * path, Handler handler )
+	{
+		if( routeN == HTTP_MAX_ROUTES || handler == nullptr || path == nullptr || path[ 0 ] != '/' )
+			return false ;
+
+		// Walk down the tree, adding the segments that aren't there yet
+		uint8_t segment = 0 ;
+
+		for( const char * name = path ; ; )
+			{
+				while( * name == '/' ) ++ name ;
+
+				if( * name == '\0' ) break ;
+
+				const char * nameEnd = name ;
+				while( * nameEnd != '\0' && * nameEnd != '/' ) ++ nameEnd ;
+
+				const size_t length = nameEnd - name ;
+
+				if(
+						length > 0xFF ||
+						( segmentType( name ) == SegmentType::PARAMETER && length == 1 ) ||
+						( segmentType( name ) == SegmentType::WILDCARD && ( length != 1 || * nameEnd != '\0' ) )
+					)
+					return false ;
+
+				uint8_t child = findChild( segment, name, length ) ;
+
+				if( child == NONE )
+					{
+						if( segmentN == HTTP_MAX_ROUTE_SEGMENTS ) return false ;
+
+						child = segmentN ++ ;
+						segments[ child ] = { name, ( uint8_t ) length, NONE, segments[ segment ].firstChild, NONE } ;
+						segments[ segment ].firstChild = child ;
+					}
+
+				segment = child ;
+				name = nameEnd ;
+			}
+
+		routes[ routeN ] = { method, handler, segments[ segment ].firstRoute } ;
+		segments[ segment ].firstRoute = routeN ++ ;
+
+		return true ;
+	}
+
+uint8_t http::Router::match(
+		uint8_t segment ,
+		const char * path ,
+		const char * pathEnd ,
+		const Request & method ,
+		RouteRequest & request ,
+		uint16_t & allowed
+	) const
+	{
+		while( path < pathEnd && * path == '/' ) ++ path ;
+
+		const char * nameEnd = path ;
+		while( nameEnd < pathEnd && * nameEnd != '/' ) ++ nameEnd ;
+
+		const uint8_t parameterN = request.parameterN ;
+
+		// The whole path has been matched, see if this segment has a route for the method
+		if( path == pathEnd && segments[ segment ].firstRoute != NONE )
+			{
+				bool methodFound = false ;
+
+				for( uint8_t route = segments[ segment ].firstRoute ; route != NONE ; route = routes[ route ].nextRoute )
+					{
+						const Request & routeMethod = routes[ route ].method ;
+
+						allowed |= 1 << ( uint8_t ) routeMethod ;
+
+						if( routeMethod == method || ( method == Request::HEAD && routeMethod == Request::GET ) )
+							methodFound = true ;
+					}
+
+				if( methodFound ) return segment ;
+			}
+
+		// Try fixed names first, then parameters, then wildcards
+		for( uint8_t type = 0 ; type < 3 ; ++ type )
+			for( uint8_t child = segments[ segment ].firstChild ; child != NONE ; child = segments[ child ].nextSibling )
+				{
+					const Segment & candidate = segments[ child ] ;
+
+					if( ( uint8_t ) segmentType( candidate.name ) != type ) continue ;
+
+					const char * next = nameEnd ;
+
+					switch( segmentType( candidate.name ) )
+						{
+							case SegmentType::NAME :
+								if(
+										path == pathEnd ||
+										candidate.length != nameEnd - path ||
+										memcmp( candidate.name, path, candidate.length ) != 0
+									)
+									continue ;
+								break ;
+
+							case SegmentType::PARAMETER :
+								if( path == pathEnd || parameterN == HTTP_MAX_ROUTE_PARAMETERS ) continue ;
+
+								request.parameterNames[ parameterN ]	= { candidate.name + 1, ( size_t ) candidate.length - 1 } ;
+								request.parameterValues[ parameterN ] = { path, ( size_t ) ( nameEnd - path ) } ;
+								request.parameterN = parameterN + 1 ;
+								break ;
+
+							case SegmentType::WILDCARD :
+								if( parameterN == HTTP_MAX_ROUTE_PARAMETERS ) continue ;
+
+								// Matches all the rest, even if empty
+								request.parameterNames[ parameterN ]	= { candidate.name, 1 } ;
+								request.parameterValues[ parameterN ] = { path, ( size_t ) ( pathEnd - path ) } ;
+								request.parameterN = parameterN + 1 ;
+								next = pathEnd ;
+								break ;
+						}
+
+					const uint8_t found = match( child, next, pathEnd, method, request, allowed ) ;
+
+					if( found != NONE ) return found ;
+
+					// Backtrack
+					request.parameterN = parameterN ;
+				}
+
+		return NONE ;
+	}
+
+http::Router::Match http::Router::find( RouteRequest & request, Handler & handler, uint16_t & allowed ) const
+	{
+		// Split the request target into path and query
+		const StringView & target = request.parser.target() ;
+		const char * queryStart = ( const char * ) memchr( target.data, '?', target.length ) ;
+
+		if( queryStart == nullptr )
+			request.requestPath = target ;
+			else
+				{
+					request.requestPath		= { target.data, ( size_t ) ( queryStart - target.data ) } ;
+					request.requestQuery	= { queryStart + 1, ( size_t ) ( target.data + target.length - queryStart - 1 ) } ;
+				}
+
+		const Request method = request.method() ;
+		const StringView & path = request.requestPath ;
+
+		request.parameterN = 0 ;
+		allowed = 0 ;
+
+		const uint8_t segment = match( 0, path.data, path.data + path.length, method, request, allowed ) ;
+
+		if( segment == NONE )
+			return allowed != 0 ? Match::METHOD_NOT_ALLOWED : Match::NOT_FOUND ;
+
+		// Prefer a route for the method itself to a GET route answering a HEAD request
+		handler = nullptr ;
+
+		for( uint8_t route = segments[ segment ].firstRoute ; route != NONE ; route = routes[ route ].nextRoute )
+			if( routes[ route ].method == method )
+				{
+					handler = routes[ route ].handler ;
+					break ;
+				}
+				else if( method == Request::HEAD && routes[ route ].method == Request::GET )
+					handler = routes[ route ].handler ;
+
+		return Match::FOUND ;
+	}
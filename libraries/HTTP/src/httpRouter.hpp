@@ -0,0 +1,187 @@
+/**
+ * @file
+ * @brief Header file containing the HTTP route table
+ */
+
+#pragma once
+
+#include "httpRequestParser.hpp"
+#include "httpResponseWriter.hpp"
+
+/* Capacity of the route table, which is allocated statically.
+ * Define them before including the library to change them
+ */
+#ifndef HTTP_MAX_ROUTES
+	#define HTTP_MAX_ROUTES 16						///< Number of method and path pairs
+#endif
+
+#ifndef HTTP_MAX_ROUTE_SEGMENTS
+	#define HTTP_MAX_ROUTE_SEGMENTS 24		///< Number of distinct path segments
+#endif
+
+#ifndef HTTP_MAX_ROUTE_PARAMETERS
+	#define HTTP_MAX_ROUTE_PARAMETERS 4		///< Number of parameters in a single path
+#endif
+
+/**
+ * Helper macro that simplifies the creation of a route handler
+ *
+ * @param name The name of the handler with eventual namespace scoping
+ */
+#define IMPLEMENT_HTTP_ROUTE_HANDLER(name) \
+	void name ( \
+			const http::RouteRequest & request , \
+			http::ResponseWriter & response \
+		)
+
+namespace http
+	{
+		class RouteRequest ;
+		class Router ;
+	}
+
+/**
+ * The request passed to a route handler: the parsed request
+ * and the values of the parameters in the path of the route
+ */
+class http::RouteRequest
+	{
+		public:
+
+			explicit RouteRequest( const RequestParser & parser_ ) :
+				parser( parser_ ) {}
+
+			Request_t method() const { return parser.method() ; }
+
+			/// The path requested, without the query
+			const StringView & path() const { return requestPath ; }
+
+			/// The query, after the '?' of the request target, empty if there isn't one
+			const StringView & query() const { return requestQuery ; }
+
+			const StringView & field( const HeaderField & name ) const { return parser.field( name ) ; }
+			const StringView & payload() const { return parser.payload() ; }
+
+			/**
+			 * The value of a parameter in the path of the route
+			 *
+			 * @param name	the name of the parameter, without the ':',
+			 *							or "*" for the rest of a path ending with a wildcard
+			 * @return			the value, empty if the route has no such parameter
+			 */
+			StringView parameter( const char * name ) const ;
+
+			/// The value of the nth parameter of the route
+			StringView parameter( uint8_t n ) const
+				{
+					return n < parameterN ? parameterValues[ n ] : StringView() ;
+				}
+
+			uint8_t parameterCount() const { return parameterN ; }
+
+		private:
+
+			friend class Router ;
+
+			const RequestParser & parser ;
+			StringView requestPath ;
+			StringView requestQuery ;
+
+			uint8_t parameterN = 0 ;
+			StringView parameterNames[ HTTP_MAX_ROUTE_PARAMETERS ] ;
+			StringView parameterValues[ HTTP_MAX_ROUTE_PARAMETERS ] ;
+	} ;
+
+/**
+ * Table that associates request methods and paths to route handlers
+ *
+ * Paths are stored as a tree of segments, so a request is matched
+ * by walking down the tree one segment at a time.
+ * A segment can be:
+ * - a fixed name, e.g. "status"
+ * - a parameter, e.g. ":sensor", matching any single segment
+ * - a wildcard, "*", matching the rest of the path and only valid as the last one
+ *
+ * Fixed names are preferred to parameters, and parameters to wildcards.
+ * Nothing is copied: the paths given to add() have to stay valid, as string literals do
+ */
+class http::Router
+	{
+		public:
+
+			typedef IMPLEMENT_HTTP_ROUTE_HANDLER( ( * Handler ) ) ;
+
+			enum class Match : uint8_t
+				{
+					FOUND ,
+					METHOD_NOT_ALLOWED ,	// The path has routes, but not for the method
+					NOT_FOUND
+				} ;
+
+			Router() ;
+
+			/**
+			 * Add a route
+			 *
+			 * @param method	the request method
+			 * @param path		the path, e.g. "/sensors/:name/value"
+			 * @param handler	the function that handles the matching requests
+			 * @return				false if the table is full or the path is invalid
+			 */
+			bool add( const Request & method, const char * path, Handler handler ) ;
+
+			/**
+			 * Find the route for a request.
+			 * HEAD requests are also matched by GET routes
+			 *
+			 * @param request		the request, whose path and parameters are set
+			 * @param handler		set to the handler of the route found
+			 * @param allowed		if the path has routes, set to the bit mask of their methods,
+			 *									1 << Request::GET for GET, and so on
+			 */
+			Match find( RouteRequest & request, Handler & handler, uint16_t & allowed ) const ;
+
+			/// True if no route has been added
+			bool empty() const { return routeN == 0 ; }
+
+		private:
+
+			static constexpr uint8_t NONE = 0xFF ;
+
+			struct Segment
+				{
+					const char * name ;
+					uint8_t length ;
+					uint8_t firstChild ;
+					uint8_t nextSibling ;
+					uint8_t firstRoute ;
+				} ;
+
+			struct Route
+				{
+					Request method ;
+					Handler handler ;
+					uint8_t nextRoute ;
+				} ;
+
+			uint8_t findChild( uint8_t parent, const char * name, uint8_t length ) const ;
+
+			/**
+			 * Match the rest of a path against the subtree starting at segment
+			 *
+			 * @return the segment that matches the whole path, or NONE
+			 */
+			uint8_t match(
+					uint8_t segment ,
+					const char * path ,
+					const char * pathEnd ,
+					const Request & method ,
+					RouteRequest & request ,
+					uint16_t & allowed
+				) const ;
+
+			Segment segments[ HTTP_MAX_ROUTE_SEGMENTS ] ;
+			Route routes[ HTTP_MAX_ROUTES ] ;
+			uint8_t segmentN = 1 ; // The root segment, for "/", always exists
+			uint8_t routeN = 0 ;
+	} ;
@@ -0,0 +1,138 @@
+#include "httpServer.hpp"
+
+namespace
+	{
+		/**
+		 * Look for a token in a comma separated list, such as the value of Connection
+		 *
+		 * @param list	the list
+		 * @param token	the token to look for, in lower case
+		 */
+		bool hasToken( const http::StringView & list, const char * token )
+			{
+				const char * const listEnd = list.data + list.length ;
+
+				for( const char * start = list.data ; start < listEnd ; )
+					{
+						const char * end = start ;
+						while( end < listEnd && * end != ',' ) ++ end ;
+
+						const char * next = end + 1 ;
+
+						// Trim the whitespace around the token
+						while( start < end && ( * start == ' ' || * start == '\t' ) ) ++ start ;
+						while( end > start && ( end[ -1 ] == ' ' || end[ -1 ] == '\t' ) ) -- end ;
+
+						if( http::StringView { start, ( size_t ) ( end - start ) }.equalsIgnoreCase( token ) )
+							return true ;
+
+						start = next ;
+					}
+
+				return false ;
+			}
+	}
+
+http::Server::Server()
+	{
+		// Set default header
+		defaultResponseHeader.version			= "1.1"	;
+		defaultResponseHeader.server			= "Arduino_HTTP/1.0.0 Arduino" ;
+
+		// Set default request handlers
+		GET_requestHandler	= requestHandler::returnTestPage			;
+		HEAD_requestHandler	= requestHandler::returnDefaultHeader	;
+	}
+
+bool http::Server::respond( const RequestParser & request, ResponseWriter & response, bool keepAliveAllowed )
+	{
+		// After a request that can't be parsed the connection is out of sync
+		if( request.status() != RequestParser::Status::COMPLETE )
+			{
+				response.prepare( false, false, false ) ;
+				response.begin( request.error(), nullptr, 0 ) ;
+				response.end() ;
+
+				return false ;
+			}
+
+		/* As HTTP/1.1 specification states, HTTP/1.1 connections are persistent
+		 * unless the client says otherwise, HTTP/1.0 ones only if the client asks for it
+		 */
+		const bool isHTTP11 = request.version() == "HTTP/1.1" ;
+		const StringView & connection = request.field( HeaderField::CONNECTION ) ;
+
+		const bool keepAlive = keepAliveAllowed &&
+			( isHTTP11 ? ! hasToken( connection, "close" ) : hasToken( connection, "keep-alive" ) ) ;
+
+		response.prepare( keepAlive, isHTTP11, ( Request ) request.method() == Request::HEAD ) ;
+
+		RouteRequest routeRequest( request ) ;
+		Router::Handler handler = nullptr ;
+		uint16_t allowedMethods = 0 ;
+
+		switch( router.find( routeRequest, handler, allowedMethods ) )
+			{
+				case Router::Match::FOUND :
+					handler( routeRequest, response ) ;
+					break ;
+
+				case Router::Match::METHOD_NOT_ALLOWED :
+					{
+						// GET routes answer HEAD requests too
+						if( allowedMethods & 1 << ( uint8_t ) Request::GET )
+							allowedMethods |= 1 << ( uint8_t ) Request::HEAD ;
+
+						// Long enough for all the methods
+						char allow[ 64 ] = "" ;
+
+						for( uint8_t method = ( uint8_t ) Request::OPTIONS ; method <= ( uint8_t ) Request::CONNECT ; ++ method )
+							if( allowedMethods & 1 << method )
+								{
+									if( allow[ 0 ] != '\0' ) strcat( allow, ", " ) ;
+									strcat( allow, Request_t( ( Request ) method ).c_str() ) ;
+								}
+
+						response.begin( Response::METHOD_NOT_ALLOWED, nullptr, 0 ) ;
+						response.sendField( "Allow", allow ) ;
+						break ;
+					}
+
+				case Router::Match::NOT_FOUND :
+					respondWithRequestHandler( request, response ) ;
+					break ;
+			}
+
+		response.end() ;
+
+		return response.keepAlive() ;
+	}
+
+void http::Server::respondWithRequestHandler( const RequestParser & request, ResponseWriter & response )
+	{
+		RequestMessage inboundMessage ;
+		ResponseMessage responseMessage( defaultResponseHeader ) ;
+
+		request.copyTo( inboundMessage ) ;
+
+		const Request & requestMethod = inboundMessage.header.requestMethod ;
+
+		// Select the appropriate function to handle the request
+		auto requestHandler =
+			requestMethod == Request::OPTIONS	? OPTIONS_requestHandler	:
+			requestMethod == Request::GET			? GET_requestHandler			:
+			requestMethod == Request::HEAD		? HEAD_requestHandler			:
+			requestMethod == Request::POST		? POST_requestHandler			:
+			requestMethod == Request::PUT			? PUT_requestHandler			:
+			requestMethod == Request::DELETE	? DELETE_requestHandler		:
+			requestMethod == Request::TRACE		? TRACE_requestHandler		:
+			requestMethod == Request::CONNECT	? CONNECT_requestHandler	: nullptr ;
+
+		if( requestHandler != nullptr )
+			requestHandler( inboundMessage, responseMessage ) ;
+			// When routes are in use, a path without one is simply not there
+			else responseMessage.header.responseCode = router.empty() ? Response::BAD_REQUEST : Response::NOT_FOUND ;
+
+		response.begin( responseMessage.header, responseMessage.payload.length() ) ;
+		response.print( responseMessage.payload ) ;
+	}
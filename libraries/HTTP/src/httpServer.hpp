@@ -7,16 +7,57 @@
 
 #include "httpRemoteClient.hpp"
 #include "httpRequestHandler.hpp"
+#include "httpRequestParser.hpp"
+#include "httpRouter.hpp"
+
+// Milliseconds a client can take to send the next piece of a request
+#ifndef HTTP_REQUEST_TIMEOUT
+	#define HTTP_REQUEST_TIMEOUT 1000
+#endif
+
+// Milliseconds a client can take to send a whole request, however it splits it
+#ifndef HTTP_REQUEST_DEADLINE
+	#define HTTP_REQUEST_DEADLINE 3000
+#endif
+
+// Most connections a ConnectionPool keeps open by default.
+// Each one has a request buffer of its own, see HTTP_REQUEST_BUFFER_SIZE
+#ifndef HTTP_MAX_CLIENTS
+	#if defined( __AVR__ )
+		#define HTTP_MAX_CLIENTS 2
+	#else
+		#define HTTP_MAX_CLIENTS 4
+	#endif
+#endif
+
+// Milliseconds a connection is kept open without requests
+#ifndef HTTP_KEEP_ALIVE_TIMEOUT
+	#define HTTP_KEEP_ALIVE_TIMEOUT 5000
+#endif
 
 namespace http
 	{
 		class Server ;
 
+		template < class Client_t, uint8_t maxClients = HTTP_MAX_CLIENTS >
+		class ConnectionPool ;
+
+		template < class Client_t >
+		RequestParser::Status readRequestFrom( const http::RemoteClient < Client_t > &, RequestParser & ) ;
+
+		template < class Client_t >
+		RequestMessage parseRawMessageFrom( const http::RemoteClient < Client_t > &, RequestParser & ) ;
+
 		template < class Client_t >
 		RequestMessage parseRawMessageFrom( const http::RemoteClient < Client_t > & ) ;
 	}
 
-/// The HTTP Server Class, managing the requests from remote clients
+/**
+ * The HTTP Server Class, managing the requests from remote clients
+ *
+ * Requests are first looked up in the route table, filled by on().
+ * The ones without a route are passed to the request handler for their method
+ */
 class http::Server
 	{
 		public:
@@ -26,6 +67,26 @@ class http::Server
 			template < class Client_t >
 			void replyTo( const RemoteClient < Client_t > & ) ;
 
+			template < class Client_t >
+			bool serve( const RemoteClient < Client_t > &, bool keepAliveAllowed = true ) ;
+
+			template < class Client_t >
+			bool serveReceived( const RemoteClient < Client_t > &, RequestParser &, bool keepAliveAllowed = true ) ;
+
+			/**
+			 * Add a route: requests with the given method and path are answered by handler
+			 *
+			 * @param method	the request method
+			 * @param path		the path, e.g. "/sensors/:name", see http::Router for the syntax.
+			 *							It isn't copied, so it has to stay valid, as string literals do
+			 * @param handler	a function created by IMPLEMENT_HTTP_ROUTE_HANDLER
+			 * @return				false if the route table is full or the path is invalid
+			 */
+			bool on( const Request & method, const char * path, Router::Handler handler )
+				{
+					return router.add( method, path, handler ) ;
+				}
+
 			ResponseHeader defaultResponseHeader ;
 
 			// Callback functions for HTTP requests
@@ -42,26 +103,72 @@ class http::Server
 			DECLARE_REQUEST_HANDLER_PTR( CONNECT_requestHandler	) ;
 
 			#undef DECLARE_REQUEST_HANDLER_PTR
+
+		private:
+
+			/**
+			 * Answer the request in a parser, which is complete or failed
+			 *
+			 * @return true if the connection can be kept open
+			 */
+			bool respond( const RequestParser & request, ResponseWriter & response, bool keepAliveAllowed ) ;
+
+			/// Answer a request without a route with the request handler for its method
+			void respondWithRequestHandler( const RequestParser & request, ResponseWriter & response ) ;
+
+			// Used by serve(), kept here rather than on the stack, as it holds a whole request
+			RequestParser requestParser ;
+			Router router ;
+	} ;
+
+/**
+ * A bounded set of connections that are kept open between requests
+ * ( HTTP/1.1 persistent connections )
+ *
+ * Every connection has a RequestParser of its own, that takes what the client
+ * has sent at each serve() and keeps it until the request is complete.
+ * So a client that is slow to send its request never holds up the others,
+ * at the price of HTTP_REQUEST_BUFFER_SIZE bytes per connection
+ *
+ * @param Client_t		The class representing the socket of the transport layer
+ * @param maxClients	The most connections kept open at the same time
+ */
+template < class Client_t, uint8_t maxClients >
+class http::ConnectionPool
+	{
+		public:
+
+			/**
+			 * Add a newly accepted connection.
+			 * When all the connections are taken, the one that has been idle
+			 * for the longest time is closed to make room
+			 */
+			void add( Client_t client ) ;
+
+			/**
+			 * Take what the clients have sent, without waiting for more,
+			 * answer the requests that are complete and close the idle connections
+			 */
+			void serve( Server & server ) ;
+
+			/// Number of open connections
+			uint8_t size() const ;
+
+		private:
+
+			Client_t clients[ maxClients ] ;
+			RequestParser parsers[ maxClients ] ;
+			unsigned long lastActivityTime[ maxClients ] ;
+			unsigned long requestStartTime[ maxClients ] ;
+			bool isOpen[ maxClients ] = {} ;
 	} ;
 
 // ******************
 // * IMPLEMENTATION *
 // ******************
 
-http::Server::Server()
-	{
-		// Set default header
-		defaultResponseHeader.version			= "1.1"		;
-		defaultResponseHeader.connection	= "close"	;
-		defaultResponseHeader.server			= "Arduino_HTTP/1.0.0 Arduino" ;
-
-		// Set default request handlers
-		GET_requestHandler	= requestHandler::returnTestPage			;
-		HEAD_requestHandler	= requestHandler::returnDefaultHeader	;
-	}
-
 /**
- * Method used to reply to remote client requests
+ * Method used to reply to remote client requests, closing the connection afterwards
  * The request type and the appropriate handler are automatically deduced from
  * the request header
  *
@@ -73,157 +180,230 @@ void http::Server::replyTo( const RemoteClient < Client_t > & client )
 	{
 		if( ! client.available() ) return ;
 
-		RequestMessage inboundMessage = parseRawMessageFrom( client ) ;
-		ResponseMessage responseMessage( defaultResponseHeader ) ;
-
-		if( inboundMessage.parsingFailed )
-			responseMessage.header.responseCode = Response::BAD_REQUEST ;
-			else
-				{
-					const Request & requestMethod = inboundMessage.header.requestMethod ;
-
-					// Select the appropriate function to handle the request
-					auto requestHandler =
-						requestMethod == Request::OPTIONS	? OPTIONS_requestHandler	:
-						requestMethod == Request::GET			? GET_requestHandler			:
-						requestMethod == Request::HEAD		? HEAD_requestHandler			:
-						requestMethod == Request::POST		? POST_requestHandler			:
-						requestMethod == Request::PUT			? PUT_requestHandler			:
-						requestMethod == Request::DELETE	? DELETE_requestHandler		:
-						requestMethod == Request::TRACE		? TRACE_requestHandler		:
-						requestMethod == Request::CONNECT	? CONNECT_requestHandler	: nullptr ;
-
-					if( requestHandler == nullptr )
-						responseMessage.header.responseCode = Response::BAD_REQUEST ;
-						else requestHandler( inboundMessage, responseMessage ) ;
-				}
-
-		client.write( responseMessage ) ;
+		serve( client, false ) ;
 		client.close() ;
 	}
 
 /**
- * The parsing function used to deserialize incoming HTTP messages
+ * Method used to answer the requests a remote client has sent,
+ * leaving the connection open if possible
  *
- * @param Client_t	The class representing the socket of the transport layer
- * @param client		A RemoteClient object representing the remote client
+ * @param Client_t					The class representing the socket of the transport layer
+ * @param client						A RemoteClient object representing the remote client
+ * @param keepAliveAllowed	false to close the connection after the response
+ * @return									true if the connection can be kept open
  */
 template < class Client_t >
-http::RequestMessage http::parseRawMessageFrom( const http::RemoteClient < Client_t > & client )
+bool http::Server::serve( const RemoteClient < Client_t > & client, bool keepAliveAllowed )
 	{
-		RequestMessage requestMessage ;
-
-		// Manually read the first byte to let getNextWord and accessNextField
-		// work as expected
-		char charBuffer = client.read() ;
+		requestParser.reset() ;
 
-		auto getNextWord = [ & ]() -> String
+		do
 			{
-				String word ;
+				readRequestFrom( client, requestParser ) ;
 
-				// Read from the buffer until a word-terminating char or field end is encoutered
-				while( charBuffer != ' ' && charBuffer != '\n' )
-					{
-						word += charBuffer ;
-						charBuffer = client.read() ;
-					}
+				RemoteClientWriter < Client_t > response( client, defaultResponseHeader ) ;
 
-				// This is necessary to not get stuck on next call
-				if( charBuffer == ' ' )
-					charBuffer = client.read() ;
+				if( ! respond( requestParser, response, keepAliveAllowed ) ) return false ;
+			}
+		// Answer the requests the client has sent without waiting for the responses
+		while( requestParser.next() > 0 ) ;
 
-				return word ;
-			} ;
+		return true ;
+	}
 
-		auto accessNextField = [ & ]() -> void
+/**
+ * Method used to answer the requests a parser has already received from a remote client,
+ * without waiting for more of them.
+ * The start of a request that isn't complete yet is left in the parser
+ *
+ * @param Client_t					The class representing the socket of the transport layer
+ * @param client						A RemoteClient object representing the remote client
+ * @param parser						The parser the requests of the client are received into
+ * @param keepAliveAllowed	false to close the connection after the response
+ * @return									true if the connection can be kept open
+ */
+template < class Client_t >
+bool http::Server::serveReceived( const RemoteClient < Client_t > & client, RequestParser & parser, bool keepAliveAllowed )
+	{
+		while( parser.status() != RequestParser::Status::INCOMPLETE )
 			{
-				// Discard all chars until the next field
-				while( charBuffer != '\n' )
-					charBuffer = client.read() ;
-
-				// Begin reading the new field, so getNextWord doesn't get stuck
-				charBuffer = client.read() ;
-			} ;
-
-		// Parse first line
-		// Parse request method
-		{
-			String requestMethod = getNextWord() ;
-
-			#define ifMatchesThenAssign(x) requestMethod == ( Request_t ) x ? x
-
-			requestMessage.header.requestMethod =
-				ifMatchesThenAssign( Request::CONNECT	) :
-				ifMatchesThenAssign( Request::DELETE	) :
-				ifMatchesThenAssign( Request::GET			) :
-				ifMatchesThenAssign( Request::HEAD		) :
-				ifMatchesThenAssign( Request::OPTIONS	) :
-				ifMatchesThenAssign( Request::POST		) :
-				ifMatchesThenAssign( Request::PUT			) :
-				ifMatchesThenAssign( Request::TRACE		) : Request::INVALID ;
-
-			#undef ifMatchesThenAssign
-		}
-
-		requestMessage.header.requestTarget = getNextWord() ;
-		requestMessage.header.version				= getNextWord() ;
-
-		if(
-				requestMessage.header.requestMethod		== Request::INVALID ||
-				requestMessage.header.requestTarget	== ""
-			)
+				RemoteClientWriter < Client_t > response( client, defaultResponseHeader ) ;
+
+				if( ! respond( parser, response, keepAliveAllowed ) ) return false ;
+
+				parser.next() ;
+			}
+
+		return true ;
+	}
+
+template < class Client_t, uint8_t maxClients >
+void http::ConnectionPool < Client_t, maxClients >::add( Client_t client )
+	{
+		if( ! client ) return ;
+
+		uint8_t slot = 0 ;
+
+		for( uint8_t n = 0 ; n < maxClients ; ++ n )
 			{
-				requestMessage.parsingFailed = true ;
-				return requestMessage ;
+				if( ! isOpen[ n ] )
+					{
+						slot = n ;
+						break ;
+					}
+
+				if( millis() - lastActivityTime[ n ] > millis() - lastActivityTime[ slot ] )
+					slot = n ;
 			}
 
-		// Parse header fields until the header-payload separator or end-of-message is encoutered
-		while( charBuffer != '\r' && client.available() )
+		if( isOpen[ slot ] )
+			clients[ slot ].stop() ;
+
+		clients[ slot ]						= client ;
+		lastActivityTime[ slot ]	= millis() ;
+		isOpen[ slot ]						= true ;
+		parsers[ slot ].reset() ;
+	}
+
+template < class Client_t, uint8_t maxClients >
+void http::ConnectionPool < Client_t, maxClients >::serve( Server & server )
+	{
+		for( uint8_t n = 0 ; n < maxClients ; ++ n )
 			{
-				accessNextField() ;
-
-				// Get the field name
-				const String parsedTag = getNextWord() ;
-
-				/* As HTTP/1.1 specification states, if a field starts with a space ignore it
-				 *
-				 * IMPLEMENTATION NOTE:
-				 * Since getNextWord() stops extracting the word on every whitespace
-				 * if the field begins with a whitespace the first word extracted
-				 * for that field will be empty
-				 */
-				if( parsedTag == "" ) continue ;
-
-				// Go through all the header fields to find one with a matching name
-				// if no one is found the current field is ignored
-				for( uint8_t n = 0 ; n < requestMessage.header.fieldN ; ++ n )
+				if( ! isOpen[ n ] ) continue ;
+
+				const RemoteClient < Client_t > client( clients[ n ] ) ;
+				RequestParser & parser = parsers[ n ] ;
+				bool keepOpen = true ;
+
+				// Take what has arrived, the rest of the request can wait for the next time
+				const int length = client.available() ?
+					client.read( parser.receiveBuffer(), parser.receiveSpace() ) : 0 ;
+
+				if( length > 0 )
 					{
-						Field & field = * requestMessage.header.fieldArray[ n ] ;
+						if( parser.empty() )
+							requestStartTime[ n ] = millis() ;
 
-						if( field.tag != parsedTag ) continue ;
+						parser.received( length ) ;
+						lastActivityTime[ n ] = millis() ;
+					}
 
-						// Read the field value, appending eventual spaces discarded by getNextWord()
-						for( String parsedValue = getNextWord() ; parsedValue != "" ; parsedValue = getNextWord() )
-							field.value += parsedValue + ( charBuffer == ' ' ? " " : "" ) ;
+				// The same limits as readRequestFrom()
+				if( parser.status() == RequestParser::Status::INCOMPLETE && ! parser.empty() )
+					{
+						if( ! client.connected() )
+							parser.fail( Response::BAD_REQUEST ) ;
+							else if(
+									millis() - lastActivityTime[ n ] > HTTP_REQUEST_TIMEOUT ||
+									millis() - requestStartTime[ n ] > HTTP_REQUEST_DEADLINE
+								)
+								parser.fail( Response::REQUEST_TIMEOUT ) ;
+					}
 
-						break ;
+				if( parser.status() != RequestParser::Status::INCOMPLETE )
+					{
+						keepOpen = server.serveReceived( client, parser ) ;
+
+						// What is left in the parser is the start of the next request
+						lastActivityTime[ n ] = requestStartTime[ n ] = millis() ;
+					}
+					else if( parser.empty() )
+						keepOpen = client.connected() && millis() - lastActivityTime[ n ] < HTTP_KEEP_ALIVE_TIMEOUT ;
+
+				if( ! keepOpen )
+					{
+						client.close() ;
+						isOpen[ n ] = false ;
 					}
 			}
+	}
 
-		// Read the payload
-		accessNextField() ;
+template < class Client_t, uint8_t maxClients >
+uint8_t http::ConnectionPool < Client_t, maxClients >::size() const
+	{
+		uint8_t openN = 0 ;
+
+		for( uint8_t n = 0 ; n < maxClients ; ++ n )
+			if( isOpen[ n ] ) ++ openN ;
+
+		return openN ;
+	}
+
+/**
+ * Receive a request into a parser, waiting for the rest of it
+ * as long as the client keeps sending it, up to HTTP_REQUEST_DEADLINE
+ *
+ * @param Client_t	The class representing the socket of the transport layer
+ * @param client		A RemoteClient object representing the remote client
+ * @param parser		The parser to receive the request into
+ * @return					The status of the request, never INCOMPLETE
+ */
+template < class Client_t >
+http::RequestParser::Status http::readRequestFrom( const http::RemoteClient < Client_t > & client, RequestParser & parser )
+	{
+		const unsigned long startTime = millis() ;
+		unsigned long lastReceiveTime = startTime ;
 
-		/* IMPLEMENTATION NOTE :
-		 * This method allows to correctly read the payload even when using
-		 * keep-alive connections
-		 */
-		while( charBuffer != '\r' && client.available() )
+		while( parser.status() == RequestParser::Status::INCOMPLETE )
 			{
-				const String nextWord = getNextWord() ;
+				const int length = client.available() ?
+					client.read( parser.receiveBuffer(), parser.receiveSpace() ) : 0 ;
 
-				if( nextWord == "" ) accessNextField() ;
-				else requestMessage.payload += nextWord + ( charBuffer == ' ' ? " " : "" ) ;
+				if( length > 0 )
+					{
+						parser.received( length ) ;
+						lastReceiveTime = millis() ;
+					}
+					else if( ! client.connected() )
+						parser.fail( Response::BAD_REQUEST ) ;
+					else if( millis() - lastReceiveTime > HTTP_REQUEST_TIMEOUT )
+						parser.fail( Response::REQUEST_TIMEOUT ) ;
+					else yield() ;
+
+				// Also when the client keeps it coming a byte at a time
+				if( millis() - startTime > HTTP_REQUEST_DEADLINE )
+					parser.fail( Response::REQUEST_TIMEOUT ) ;
 			}
 
+		return parser.status() ;
+	}
+
+/**
+ * The parsing function used to deserialize incoming HTTP messages
+ *
+ * @param Client_t	The class representing the socket of the transport layer
+ * @param client		A RemoteClient object representing the remote client
+ * @param parser		The parser to use, which is reset first
+ */
+template < class Client_t >
+http::RequestMessage http::parseRawMessageFrom( const http::RemoteClient < Client_t > & client, RequestParser & parser )
+	{
+		RequestMessage requestMessage ;
+
+		parser.reset() ;
+		readRequestFrom( client, parser ) ;
+		parser.copyTo( requestMessage ) ;
+
 		return requestMessage ;
-}
+	}
+
+/**
+ * The parsing function used to deserialize incoming HTTP messages
+ *
+ * IMPLEMENTATION NOTE:
+ * The parser, with its HTTP_REQUEST_BUFFER_SIZE buffer, lives on the stack
+ * for the duration of the call.
+ * Where the stack is small pass a parser that lives elsewhere instead
+ *
+ * @param Client_t	The class representing the socket of the transport layer
+ * @param client		A RemoteClient object representing the remote client
+ */
+template < class Client_t >
+http::RequestMessage http::parseRawMessageFrom( const http::RemoteClient < Client_t > & client )
+	{
+		RequestParser parser ;
+
+		return parseRawMessageFrom( client, parser ) ;
+	}
@@ -21,52 +21,66 @@
 
 #include "NTPClient.h"
 
+// Read a 32 bit big-endian value from a NTP packet
+static uint32_t readLong(const byte* data) {
+  return (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3];
+}
+
+// Convert a NTP timestamp, seconds since 1900 and fraction of second, to µs since 1970
+static int64_t ntpToMicros(const byte* timestamp) {
+  // Both wrap around in 2036, so the difference stays right until 2106
+  uint32_t secsSince1970 = readLong(timestamp) - SEVENZYYEARS;
+  uint32_t fraction      = readLong(timestamp + 4);
+
+  return (int64_t)secsSince1970 * 1000000 + (int64_t)(((uint64_t)fraction * 1000000) >> 32);
+}
+
 NTPClient::NTPClient(UDP& udp) {
-  this->_udp            = &udp;
+  this->_udp             = &udp;
 }
 
 NTPClient::NTPClient(UDP& udp, long timeOffset) {
-  this->_udp            = &udp;
-  this->_timeOffset     = timeOffset;
+  this->_udp             = &udp;
+  this->_timeOffset      = timeOffset;
 }
 
 NTPClient::NTPClient(UDP& udp, const char* poolServerName) {
-  this->_udp            = &udp;
-  this->_poolServerName = poolServerName;
+  this->_udp             = &udp;
+  this->_servers[0].name = poolServerName;
 }
 
 NTPClient::NTPClient(UDP& udp, IPAddress poolServerIP) {
-  this->_udp            = &udp;
-  this->_poolServerIP   = poolServerIP;
-  this->_poolServerName = NULL;
+  this->_udp             = &udp;
+  this->_servers[0].ip   = poolServerIP;
+  this->_servers[0].name = NULL;
 }
 
 NTPClient::NTPClient(UDP& udp, const char* poolServerName, long timeOffset) {
-  this->_udp            = &udp;
-  this->_timeOffset     = timeOffset;
-  this->_poolServerName = poolServerName;
+  this->_udp             = &udp;
+  this->_timeOffset      = timeOffset;
+  this->_servers[0].name = poolServerName;
 }
 
 NTPClient::NTPClient(UDP& udp, IPAddress poolServerIP, long timeOffset){
-  this->_udp            = &udp;
-  this->_timeOffset     = timeOffset;
-  this->_poolServerIP   = poolServerIP;
-  this->_poolServerName = NULL;
+  this->_udp             = &udp;
+  this->_timeOffset      = timeOffset;
+  this->_servers[0].ip   = poolServerIP;
+  this->_servers[0].name = NULL;
 }
 
 NTPClient::NTPClient(UDP& udp, const char* poolServerName, long timeOffset, unsigned long updateInterval) {
-  this->_udp            = &udp;
-  this->_timeOffset     = timeOffset;
-  this->_poolServerName = poolServerName;
-  this->_updateInterval = updateInterval;
+  this->_udp             = &udp;
+  this->_timeOffset      = timeOffset;
+  this->_servers[0].name = poolServerName;
+  this->_updateInterval  = updateInterval;
 }
 
 NTPClient::NTPClient(UDP& udp, IPAddress poolServerIP, long timeOffset, unsigned long updateInterval) {
-  this->_udp            = &udp;
-  this->_timeOffset     = timeOffset;
-  this->_poolServerIP   = poolServerIP;
-  this->_poolServerName = NULL;
-  this->_updateInterval = updateInterval;
+  this->_udp             = &udp;
+  this->_timeOffset      = timeOffset;
+  this->_servers[0].ip   = poolServerIP;
+  this->_servers[0].name = NULL;
+  this->_updateInterval  = updateInterval;
 }
 
 void NTPClient::begin() {
@@ -86,54 +100,76 @@ bool NTPClient::forceUpdate() {
     Serial.println("Update from NTP Server");
   #endif
 
-  // flush any existing packets
-  while(this->_udp->parsePacket() != 0)
-    this->_udp->flush();
-
-  this->sendNTPPacket();
-
-  // Wait till data is there or timeout...
-  byte timeout = 0;
-  int cb = 0;
-  do {
-    delay ( 10 );
-    cb = this->_udp->parsePacket();
-    if (timeout > 100) return false; // timeout after 1000 ms
-    timeout++;
-  } while (cb == 0);
-
-  this->_lastUpdate = millis() - (10 * (timeout + 1)); // Account for delay in reading the time
-
-  this->_udp->read(this->_packetBuffer, NTP_PACKET_SIZE);
-
-  unsigned long highWord = word(this->_packetBuffer[40], this->_packetBuffer[41]);
-  unsigned long lowWord = word(this->_packetBuffer[42], this->_packetBuffer[43]);
-  // combine the four bytes (two words) into a long integer
-  // this is NTP time (seconds since Jan 1 1900):
-  unsigned long secsSince1900 = highWord << 16 | lowWord;
+  // Join the round started by poll(), if there is one
+  if (!this->_roundActive)
+    this->sendRequests();
 
-  this->_currentEpoc = secsSince1900 - SEVENZYYEARS;
+  // Wait till all the responses are there or timeout...
+  while (this->_roundActive) {
+    if (this->receiveResponses()) return true;
+    yield();
+  }
 
-  return true;  // return true after successful update
+  return false;
 }
 
 bool NTPClient::update() {
-  if ((millis() - this->_lastUpdate >= this->_updateInterval)     // Update after _updateInterval
-    || this->_lastUpdate == 0) {                                // Update if there was no update yet.
+  if (this->updateDue()) {
     if (!this->_udpSetup || this->_port != NTP_DEFAULT_LOCAL_PORT) this->begin(this->_port); // setup the UDP client if needed
     return this->forceUpdate();
   }
   return false;   // return false if update does not occur
 }
 
+bool NTPClient::poll() {
+  if (this->_roundActive)
+    return this->receiveResponses();
+
+  if (this->updateDue()) {
+    if (!this->_udpSetup || this->_port != NTP_DEFAULT_LOCAL_PORT) this->begin(this->_port); // setup the UDP client if needed
+    this->sendRequests();
+  }
+  return false;   // the responses are read by the next calls
+}
+
+bool NTPClient::updateDue() const {
+  // After a failure try again sooner
+  unsigned long interval = this->_retrying ? min(this->_updateInterval, (unsigned long)NTP_RETRY_INTERVAL) : this->_updateInterval;
+
+  return (millis() - this->_lastRound >= interval) // Update after interval
+    || this->_lastRound == 0;                      // Update if there was no update yet.
+}
+
 bool NTPClient::isTimeSet() const {
   return (this->_lastUpdate != 0); // returns true if the time has been set, else false
 }
 
+int64_t NTPClient::elapsed(unsigned long fromMillis, unsigned long fromMicros, unsigned long toMillis, unsigned long toMicros) {
+  // micros() is more precise, but it wraps around after about 71 minutes
+  unsigned long elapsedMillis = toMillis - fromMillis;
+  return elapsedMillis < 4000000UL ? (int64_t)(unsigned long)(toMicros - fromMicros)
+                                   : (int64_t)elapsedMillis * 1000;
+}
+
+int64_t NTPClient::timeAt(unsigned long localMillis, unsigned long localMicros) const {
+  int64_t elapsed = NTPClient::elapsed(this->_lastUpdate, this->_lastUpdateMicros, localMillis, localMicros);
+
+  return this->_currentEpoc + // Time at the last update
+         elapsed + elapsed * this->_drift / 1000000000; // Time since last update, corrected by the drift
+}
+
+int64_t NTPClient::currentTime() const {
+  return this->timeAt(millis(), micros());
+}
+
 unsigned long NTPClient::getEpochTime() const {
   return this->_timeOffset + // User offset
-         this->_currentEpoc + // Epoch returned by the NTP server
-         ((millis() - this->_lastUpdate) / 1000); // Time since last update
+         (unsigned long)(this->currentTime() / 1000000); // Time from the NTP server and since then
+}
+
+unsigned long long NTPClient::getEpochMillis() const {
+  return (long long)this->_timeOffset * 1000 + // User offset
+         (unsigned long long)(this->currentTime() / 1000); // Time from the NTP server and since then
 }
 
 int NTPClient::getDay() const {
@@ -163,10 +199,23 @@ String NTPClient::getFormattedTime() const {
   return hoursStr + ":" + minuteStr + ":" + secondStr;
 }
 
+long NTPClient::getLastCorrection() const {
+  return this->_lastCorrection;
+}
+
+unsigned long NTPClient::getLastDelay() const {
+  return this->_lastDelay;
+}
+
+float NTPClient::getDrift() const {
+  return this->_drift / 1000.0f;
+}
+
 void NTPClient::end() {
   this->_udp->stop();
 
   this->_udpSetup = false;
+  this->_roundActive = false;
 }
 
 void NTPClient::setTimeOffset(int timeOffset) {
@@ -177,11 +226,49 @@ void NTPClient::setUpdateInterval(unsigned long updateInterval) {
   this->_updateInterval = updateInterval;
 }
 
+void NTPClient::setTimeout(unsigned long timeout) {
+  this->_timeout        = timeout;
+}
+
 void NTPClient::setPoolServerName(const char* poolServerName) {
-    this->_poolServerName = poolServerName;
+    this->_servers[0].name = poolServerName;
+}
+
+bool NTPClient::addServer(const char* serverName) {
+  if (this->_serverCount == NTP_MAX_SERVERS) return false;
+
+  this->_servers[this->_serverCount++].name = serverName;
+  return true;
+}
+
+bool NTPClient::addServer(IPAddress serverIP) {
+  if (this->_serverCount == NTP_MAX_SERVERS) return false;
+
+  this->_servers[this->_serverCount].ip     = serverIP;
+  this->_servers[this->_serverCount++].name = NULL;
+  return true;
 }
 
-void NTPClient::sendNTPPacket() {
+void NTPClient::sendRequests() {
+  // flush any existing packets
+  while(this->_udp->parsePacket() != 0)
+    this->_udp->flush();
+
+  this->_lastRound   = millis();
+  this->_roundStart  = micros();
+  this->_roundActive = false;
+
+  for (byte server = 0; server < this->_serverCount; server++) {
+    this->sendNTPPacket(server);
+    this->_roundActive |= this->_requests[server].pending;
+  }
+
+  if (!this->_roundActive) this->_retrying = true;
+}
+
+void NTPClient::sendNTPPacket(byte server) {
+  Request& request = this->_requests[server];
+
   // set all bytes in the buffer to 0
   memset(this->_packetBuffer, 0, NTP_PACKET_SIZE);
   // Initialize values needed to form NTP request
@@ -195,15 +282,193 @@ void NTPClient::sendNTPPacket() {
   this->_packetBuffer[14]  = 49;
   this->_packetBuffer[15]  = 52;
 
+  // The server copies the transmit timestamp into the originate one of its
+  // response, so a value that can't be guessed tells which request it answers
+  request.cookie = (uint32_t)micros() ^ (server + 1) * 0x9E3779B9UL;
+  this->_packetBuffer[44]  = request.cookie >> 24;
+  this->_packetBuffer[45]  = request.cookie >> 16;
+  this->_packetBuffer[46]  = request.cookie >> 8;
+  this->_packetBuffer[47]  = request.cookie;
+
+  request.pending  = false;
+  request.answered = false;
+
   // all NTP fields have been given values, now
   // you can send a packet requesting a timestamp:
-  if  (this->_poolServerName) {
-    this->_udp->beginPacket(this->_poolServerName, 123);
+  int ready;
+  if  (this->_servers[server].name) {
+    ready = this->_udp->beginPacket(this->_servers[server].name, 123);
   } else {
-    this->_udp->beginPacket(this->_poolServerIP, 123);
+    ready = this->_udp->beginPacket(this->_servers[server].ip, 123);
   }
+  if (!ready) return; // e.g. the server name couldn't be resolved
+
   this->_udp->write(this->_packetBuffer, NTP_PACKET_SIZE);
-  this->_udp->endPacket();
+  request.sentAt   = micros();
+  request.pending  = this->_udp->endPacket() != 0;
+}
+
+bool NTPClient::receiveResponses() {
+  int size;
+  while ((size = this->_udp->parsePacket()) != 0)
+    this->readResponse(size);
+
+  bool pending = false;
+  for (byte server = 0; server < this->_serverCount; server++)
+    pending |= this->_requests[server].pending;
+
+  if (pending && millis() - this->_lastRound < this->_timeout) return false;
+
+  return this->finishRound();
+}
+
+void NTPClient::readResponse(int size) {
+  // Take the time first, the sooner the more precise
+  unsigned long receivedAt       = micros();
+  unsigned long receivedAtMillis = millis();
+
+  if (size < NTP_PACKET_SIZE) {
+    this->_udp->flush();
+    return;
+  }
+
+  this->_udp->read(this->_packetBuffer, NTP_PACKET_SIZE);
+  this->_udp->flush();
+
+  const byte* packet   = this->_packetBuffer;
+  byte leapIndicator   = packet[0] >> 6;
+  byte mode            = packet[0] & 0x07;
+  byte stratum         = packet[1];
+
+  // Only accept the responses of synchronized servers, stratum 0 is a "kiss-o'-death" packet
+  if (mode != 4 || leapIndicator == 3 || stratum == 0 || stratum > 15) return;
+  if (readLong(packet + 40) == 0 && readLong(packet + 44) == 0) return;
+
+  // Find the request answered, from the originate timestamp
+  byte server = 0;
+  while (server < this->_serverCount &&
+         !(this->_requests[server].pending && readLong(packet + 24) == 0 && readLong(packet + 28) == this->_requests[server].cookie))
+    server++;
+  if (server == this->_serverCount) return;
+
+  Request& request = this->_requests[server];
+
+  /* The four timestamps of NTP: the request is sent at T1 and received by the server at T2,
+   * the response is sent at T3 and received at T4. T1 and T4 are on the local clock,
+   * so only their difference is used: the time at T4 is T3 plus half the round trip,
+   * which is (T4 - T1) - (T3 - T2). Offset and local time are worked out by finishRound()
+   */
+  int64_t serverReceived    = ntpToMicros(packet + 32);
+  int64_t serverTransmitted = ntpToMicros(packet + 40);
+  int64_t roundTrip         = (int64_t)(unsigned long)(receivedAt - request.sentAt) - (serverTransmitted - serverReceived);
+  if (roundTrip < 0) roundTrip = 0; // The clocks can't be that precise
+
+  request.pending          = false;
+  request.answered         = true;
+  request.serverTime       = serverTransmitted + roundTrip / 2;
+  request.receivedAt       = receivedAt;
+  request.receivedAtMillis = receivedAtMillis;
+  request.roundTrip        = roundTrip;
+}
+
+bool NTPClient::finishRound() {
+  this->_roundActive = false;
+  this->_retrying    = true;
+
+  /* Compare the responses by the time they give for the start of the round:
+   * as long as the round lasts the drift of the local clock doesn't matter
+   */
+  byte    sorted[NTP_MAX_SERVERS];
+  int64_t startTime[NTP_MAX_SERVERS];
+  byte    count = 0;
+
+  for (byte server = 0; server < this->_serverCount; server++) {
+    const Request& request = this->_requests[server];
+    if (!request.answered) continue;
+
+    startTime[server] = request.serverTime - (unsigned long)(request.receivedAt - this->_roundStart);
+
+    // Insertion sort, there are only a few
+    byte position = count++;
+    for (; position > 0 && startTime[sorted[position - 1]] > startTime[server]; position--)
+      sorted[position] = sorted[position - 1];
+    sorted[position] = server;
+  }
+
+  if (count == 0) return false;
+
+  int64_t median = count % 2 ? startTime[sorted[count / 2]]
+                             : (startTime[sorted[count / 2 - 1]] + startTime[sorted[count / 2]]) / 2;
+
+  /* Outliers: the true time is within half the round trip of the one given by a server,
+   * give or take a millisecond. The servers that can't agree with the median are left out,
+   * and of the others the one with the shortest round trip is the most precise
+   */
+  int best = -1;
+  for (byte n = 0; n < count; n++) {
+    const Request& request = this->_requests[sorted[n]];
+    int64_t distance = startTime[sorted[n]] - median;
+    if (distance < 0) distance = -distance;
+
+    if (distance <= (int64_t)request.roundTrip / 2 + 1000 &&
+        (best < 0 || request.roundTrip < this->_requests[best].roundTrip))
+      best = sorted[n];
+  }
+
+  // No agreement, e.g. two servers far apart: just trust the closest one
+  if (best < 0) {
+    best = sorted[0];
+    for (byte n = 1; n < count; n++)
+      if (this->_requests[sorted[n]].roundTrip < this->_requests[best].roundTrip) best = sorted[n];
+  }
+
+  const Request& request = this->_requests[best];
+  bool step = true;
+
+  if (this->isTimeSet()) {
+    int64_t correction = request.serverTime - this->timeAt(request.receivedAtMillis, request.receivedAt);
+    step = correction > NTP_STEP_THRESHOLD * 1000LL || correction < -NTP_STEP_THRESHOLD * 1000LL;
+
+    // A big jump is most likely a wrong response, unless the next updates confirm it
+    if (step && this->_spikes < NTP_MAX_SPIKES) {
+      this->_spikes++;
+      this->_retrying = false;
+      return false;
+    }
+
+    this->_lastCorrection = constrain(correction, -0x7FFFFFFFLL, 0x7FFFFFFFLL);
+  }
+
+  /* The drift is measured over a long time, as the error of each update is
+   * about as big as what the local clock drifts away in a few minutes.
+   * It starts again after a jump, which would distort it
+   */
+  int64_t driftInterval = NTPClient::elapsed(this->_driftMillis, this->_driftMicros, request.receivedAtMillis, request.receivedAt);
+
+  if (!step && driftInterval >= NTP_DRIFT_INTERVAL * 1000LL) {
+    int64_t drift = (request.serverTime - this->_driftEpoc - driftInterval) * 1000000000 / driftInterval;
+
+    if (drift >= -NTP_MAX_DRIFT * 1000LL && drift <= NTP_MAX_DRIFT * 1000LL) {
+      // The first measurement is taken as it is, the next ones only refine it
+      this->_drift    = this->_driftSet ? this->_drift + (drift - this->_drift) / 4 : drift;
+      this->_driftSet = true;
+    }
+  }
+
+  if (step || driftInterval >= NTP_DRIFT_INTERVAL * 1000LL) {
+    this->_driftEpoc   = request.serverTime;
+    this->_driftMillis = request.receivedAtMillis;
+    this->_driftMicros = request.receivedAt;
+  }
+
+  this->_spikes           = 0;
+  this->_retrying         = false;
+  this->_currentEpoc      = request.serverTime;
+  this->_lastUpdate       = request.receivedAtMillis;
+  this->_lastUpdateMicros = request.receivedAt;
+  this->_lastDelay        = request.roundTrip;
+
+  return true;  // return true after successful update
 }
 
 void NTPClient::setRandomPort(unsigned int minValue, unsigned int maxValue) {
@@ -8,24 +8,94 @@
 #define NTP_PACKET_SIZE 48
 #define NTP_DEFAULT_LOCAL_PORT 1337
 
+// The following can be defined before including the library to change them
+#ifndef NTP_MAX_SERVERS
+#define NTP_MAX_SERVERS 4                 // Servers queried in each update
+#endif
+
+#ifndef NTP_DEFAULT_TIMEOUT
+#define NTP_DEFAULT_TIMEOUT 1000          // In ms, how long to wait for the responses
+#endif
+
+#ifndef NTP_RETRY_INTERVAL
+#define NTP_RETRY_INTERVAL 10000          // In ms, how soon to try again after a failed update
+#endif
+
+#ifndef NTP_STEP_THRESHOLD
+#define NTP_STEP_THRESHOLD 128            // In ms, bigger corrections are taken as spikes...
+#endif
+
+#ifndef NTP_MAX_SPIKES
+#define NTP_MAX_SPIKES 2                  // ...and ignored, unless this many updates in a row confirm them
+#endif
+
+#ifndef NTP_MAX_DRIFT
+#define NTP_MAX_DRIFT 500                 // In ppm, the largest drift of the local clock that is corrected
+#endif
+
+#ifndef NTP_DRIFT_INTERVAL
+#define NTP_DRIFT_INTERVAL 900000         // In ms, how long the drift of the local clock is measured over
+#endif
+
 class NTPClient {
   private:
+    struct Server {
+      const char* name;
+      IPAddress   ip;
+    };
+
+    // A request sent to a server in the current round, and the sample given by its response
+    struct Request {
+      uint32_t      cookie;               // Sent in the transmit timestamp, echoed by the server
+      unsigned long sentAt;               // In µs, local time
+      bool          pending;
+      bool          answered;
+      int64_t       serverTime;           // In µs since Jan. 1, 1970, at receivedAt
+      unsigned long receivedAt;           // In µs, local time
+      unsigned long receivedAtMillis;     // In ms, local time
+      unsigned long roundTrip;            // In µs, minus the time spent by the server
+    };
+
     UDP*          _udp;
     bool          _udpSetup       = false;
 
-    const char*   _poolServerName = "pool.ntp.org"; // Default time server
-    IPAddress     _poolServerIP;
+    Server        _servers[NTP_MAX_SERVERS] = { { "pool.ntp.org", IPAddress() } }; // Default time server
+    byte          _serverCount    = 1;
     unsigned int  _port           = NTP_DEFAULT_LOCAL_PORT;
     long          _timeOffset     = 0;
 
     unsigned long _updateInterval = 60000;  // In ms
+    unsigned long _timeout        = NTP_DEFAULT_TIMEOUT; // In ms
 
-    unsigned long _currentEpoc    = 0;      // In s
+    int64_t       _currentEpoc    = 0;      // In µs, at _lastUpdate
     unsigned long _lastUpdate     = 0;      // In ms
+    unsigned long _lastUpdateMicros = 0;    // In µs, local time of the same instant as _lastUpdate
+    long          _drift          = 0;      // In ppb, how much slower the local clock runs
+    bool          _driftSet       = false;
+    int64_t       _driftEpoc      = 0;      // In µs, at the update the drift is measured from
+    unsigned long _driftMillis    = 0;      // In ms, local time of the same update
+    unsigned long _driftMicros    = 0;      // In µs, local time of the same update
+    byte          _spikes         = 0;      // Updates in a row that have been ignored as spikes
+    long          _lastCorrection = 0;      // In µs
+    unsigned long _lastDelay      = 0;      // In µs
+
+    Request       _requests[NTP_MAX_SERVERS] = {};
+    bool          _roundActive    = false;
+    bool          _retrying       = true;   // The last round failed, or there was none yet
+    unsigned long _lastRound      = 0;      // In ms
+    unsigned long _roundStart     = 0;      // In µs
 
     byte          _packetBuffer[NTP_PACKET_SIZE];
 
-    void          sendNTPPacket();
+    void          sendNTPPacket(byte server);
+    void          sendRequests();
+    bool          receiveResponses();
+    void          readResponse(int size);
+    bool          finishRound();
+    bool          updateDue() const;
+    int64_t       timeAt(unsigned long localMillis, unsigned long localMicros) const;
+    static int64_t elapsed(unsigned long fromMillis, unsigned long fromMicros, unsigned long toMillis, unsigned long toMicros);
+    int64_t       currentTime() const;
 
   public:
     NTPClient(UDP& udp);
@@ -44,6 +114,15 @@ class NTPClient {
      */
     void setPoolServerName(const char* poolServerName);
 
+    /**
+     * Add a time server, queried together with the others at every update.
+     * The more servers, the better a wrong one can be told from the right ones
+     *
+     * @return false if there are already NTP_MAX_SERVERS servers
+     */
+    bool addServer(const char* serverName);
+    bool addServer(IPAddress serverIP);
+
      /**
      * Set random local port
      */
@@ -62,6 +141,7 @@ class NTPClient {
     /**
      * This should be called in the main loop of your application. By default an update from the NTP Server is only
      * made every 60 seconds. This can be configured in the NTPClient constructor.
+     * It waits for the responses of the servers, see poll() for an update that doesn't.
      *
      * @return true on success, false on failure
      */
@@ -74,6 +154,15 @@ class NTPClient {
      */
     bool forceUpdate();
 
+    /**
+     * Like update(), but it never waits: the requests are sent to all the servers, and their
+     * responses are read by the following calls as they arrive. It should be called often,
+     * the precision of the time depends on how soon a response is read.
+     *
+     * @return true if the time has just been updated, else false
+     */
+    bool poll();
+
     /**
      * This allows to check if the NTPClient successfully received a NTP packet and set the time.
      *
@@ -97,6 +186,11 @@ class NTPClient {
      */
     void setUpdateInterval(unsigned long updateInterval);
 
+    /**
+     * Set how long to wait for the responses of the servers, in ms
+     */
+    void setTimeout(unsigned long timeout);
+
     /**
      * @return time formatted like `hh:mm:ss`
      */
@@ -107,6 +201,26 @@ class NTPClient {
      */
     unsigned long getEpochTime() const;
 
+    /**
+     * @return time in milliseconds since Jan. 1, 1970
+     */
+    unsigned long long getEpochMillis() const;
+
+    /**
+     * @return the correction made by the last update, in µs
+     */
+    long getLastCorrection() const;
+
+    /**
+     * @return the round trip time to the server used by the last update, in µs
+     */
+    unsigned long getLastDelay() const;
+
+    /**
+     * @return the estimated drift of the local clock, in ppm, positive if it runs slow
+     */
+    float getDrift() const;
+
     /**
      * Stops the underlying UDP client
      */
@@ -0,0 +1,55 @@
+#include <NTPClient.h>
+// change next line to use with another board/shield
+#include <ESP8266WiFi.h>
+//#include <WiFi.h> // for WiFi shield
+//#include <WiFi101.h> // for WiFi 101 shield or MKR1000
+#include <WiFiUdp.h>
+
+const char *ssid     = "<SSID>";
+const char *password = "<PASSWORD>";
+
+WiFiUDP ntpUDP;
+
+// The servers are queried together, a wrong one is left out
+NTPClient timeClient(ntpUDP, "0.pool.ntp.org");
+
+unsigned long lastPrint = 0;
+
+void setup(){
+  Serial.begin(115200);
+
+  WiFi.begin(ssid, password);
+
+  while ( WiFi.status() != WL_CONNECTED ) {
+    delay ( 500 );
+    Serial.print ( "." );
+  }
+
+  timeClient.addServer("1.pool.ntp.org");
+  timeClient.addServer("2.pool.ntp.org");
+  timeClient.begin();
+}
+
+void loop() {
+  // Never waits for the servers, so the rest of the loop keeps running
+  if (timeClient.poll()) {
+    Serial.print("Corrected by ");
+    Serial.print(timeClient.getLastCorrection() / 1000.0);
+    Serial.print(" ms, round trip ");
+    Serial.print(timeClient.getLastDelay() / 1000.0);
+    Serial.print(" ms, drift ");
+    Serial.print(timeClient.getDrift());
+    Serial.println(" ppm");
+  }
+
+  if (timeClient.isTimeSet() && millis() - lastPrint >= 1000) {
+    lastPrint = millis();
+
+    unsigned long long epochMillis = timeClient.getEpochMillis();
+    unsigned int milliseconds = epochMillis % 1000;
+
+    Serial.print(timeClient.getFormattedTime());
+    Serial.print(milliseconds < 100 ? (milliseconds < 10 ? ".00" : ".0") : ".");
+    Serial.println(milliseconds);
+  }
+}
@@ -0,0 +1,64 @@
+// Stand-in for the Arduino core, on a simulated clock
+// MIT License
+
+#include <Arduino.h>
+
+namespace MockClock
+{
+  int64_t now = 1792281600LL * 1000000; // 2026-10-18
+  double drift = 0;
+  unsigned long long waited = 0;
+
+  // The local clock starts at 1 s, as if the board had just booted
+  static double local = 1000000;
+
+  void advance(int64_t aMicros)
+  {
+    now += aMicros;
+    local += aMicros * (1 - drift * 1e-6);
+  }
+}
+
+unsigned long millis()
+{
+  return (unsigned long)((unsigned long long)MockClock::local / 1000);
+}
+
+unsigned long micros()
+{
+  return (unsigned long)(unsigned long long)MockClock::local;
+}
+
+void delay(unsigned long ms)
+{
+  MockClock::waited += ms * 1000;
+  MockClock::advance(ms * 1000);
+}
+
+void yield()
+{
+  MockClock::waited += 100;
+  MockClock::advance(100);
+}
+
+void randomSeed(unsigned long seed)
+{
+  srand(seed);
+}
+
+long random(long max)
+{
+  return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max)
+{
+  return min + random(max - min);
+}
+
+int analogRead(uint8_t pin)
+{
+  return 0;
+}
+
+HardwareSerial Serial;
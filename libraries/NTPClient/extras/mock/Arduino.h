@@ -0,0 +1,88 @@
+// Stand-in for the parts of the Arduino core NTPClient uses, for host tests.
+// The clock is simulated, see MockClock
+// MIT License
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte;
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/** The local clock millis() and micros() read.  It only moves when the test
+  advances it, or the library waits with delay() or yield(), so the tests
+  don't depend on how busy the host is
+*/
+namespace MockClock
+{
+  // True time, in µs since Jan. 1, 1970
+  extern int64_t now;
+  // How much slower than true time the local clock runs, in ppm
+  extern double drift;
+  // Local time spent in delay() and yield(), in µs
+  extern unsigned long long waited;
+
+  // Let aMicros of true time pass
+  void advance(int64_t aMicros);
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+// Takes 100 µs, the time a loop around it would take on a board
+void yield();
+
+void randomSeed(unsigned long seed);
+long random(long max);
+long random(long min, long max);
+int analogRead(uint8_t pin);
+
+class String
+{
+public:
+  String() {}
+  String(const char* aString) { if (aString) iString = aString; }
+  String(const std::string& aString) : iString(aString) {}
+  String(unsigned long aValue) : iString(std::to_string(aValue)) {}
+
+  const char* c_str() const { return iString.c_str(); }
+  unsigned int length() const { return iString.size(); }
+  bool operator==(const char* aString) const { return iString == aString; }
+  friend String operator+(const String& a, const String& b) { return String(a.iString + b.iString); }
+  friend String operator+(const String& a, const char* b) { return String(a.iString + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.iString); }
+
+private:
+  std::string iString;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t aByte) = 0;
+  size_t print(const char* aString) { size_t n = 0; while (*aString) n += write(*aString++); return n; }
+  size_t println(const char* aString) { return print(aString) + print("\r\n"); }
+};
+
+class HardwareSerial : public Print
+{
+public:
+  size_t write(uint8_t aByte) override { return fputc(aByte, stderr) == EOF ? 0 : 1; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,23 @@
+// Stand-in for the Arduino IPAddress, for host tests
+// MIT License
+
+#ifndef IPAddress_h
+#define IPAddress_h
+
+#include <Arduino.h>
+
+class IPAddress
+{
+public:
+  IPAddress() : iAddress(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+   : iAddress((uint32_t)a << 24 | (uint32_t)b << 16 | (uint32_t)c << 8 | d) {}
+
+  bool operator==(const IPAddress& aOther) const { return iAddress == aOther.iAddress; }
+  operator uint32_t() const { return iAddress; }
+
+private:
+  uint32_t iAddress;
+};
+
+#endif
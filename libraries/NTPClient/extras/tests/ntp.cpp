@@ -0,0 +1,280 @@
+// NTPClient against stand-in NTP servers on a simulated network: their
+// responses can be late, lost, wrong, or not meant for the client at all
+// MIT License
+
+#include <NTPClient.h>
+
+#include <vector>
+
+#include "check.h"
+
+struct StandInServer {
+  const char* name;
+  int64_t     offset;   // In µs, how far ahead of the true time the server is
+  int64_t     delay;    // In µs, each way
+  int64_t     jitter;   // In µs, up to this much more each way
+  byte        stratum;
+  bool        lost;     // Never answers
+};
+
+// Writes a NTP timestamp, seconds since 1900 and fraction of second
+static void writeTimestamp(byte* timestamp, int64_t microsSince1970) {
+  uint32_t seconds  = (uint32_t)(microsSince1970 / 1000000 + SEVENZYYEARS);
+  uint32_t fraction = (uint32_t)(((uint64_t)(microsSince1970 % 1000000) << 32) / 1000000);
+  for (int i = 0; i < 4; i++) {
+    timestamp[i]     = seconds >> (24 - 8 * i);
+    timestamp[4 + i] = fraction >> (24 - 8 * i);
+  }
+}
+
+// The same jitter at every run
+static int64_t jitter(int64_t max) {
+  static uint32_t state = 1;
+  state = state * 1103515245 + 12345;
+  return max ? (state >> 8) % max : 0;
+}
+
+class StandInUDP : public UDP {
+  public:
+    std::vector<StandInServer> servers;
+    byte lastRequest[NTP_PACKET_SIZE];
+
+    // Answers a request the way the server would, after its delay
+    void respond(const byte* request, const StandInServer& server) {
+      int64_t toServer = server.delay + jitter(server.jitter);
+      int64_t back     = server.delay + jitter(server.jitter);
+
+      byte response[NTP_PACKET_SIZE] = {};
+      response[0] = 0x24;                         // LI 0, version 4, mode 4 (server)
+      response[1] = server.stratum;
+      memcpy(response + 24, request + 40, 8);     // Originate timestamp
+      int64_t received = MockClock::now + toServer + server.offset;
+      writeTimestamp(response + 32, received);
+      writeTimestamp(response + 40, received + 50);
+
+      this->deliver(response, toServer + 50 + back);
+    }
+
+    // Queues a packet to arrive in the given time
+    void deliver(const byte* packet, int64_t in) {
+      Packet arriving;
+      arriving.arrival = MockClock::now + in;
+      memcpy(arriving.data, packet, NTP_PACKET_SIZE);
+
+      std::vector<Packet>::iterator position = this->_inbox.begin();
+      while (position != this->_inbox.end() && position->arrival <= arriving.arrival) position++;
+      this->_inbox.insert(position, arriving);
+    }
+
+    uint8_t begin(uint16_t port) override { return 1; }
+    void stop() override {}
+
+    int beginPacket(IPAddress ip, uint16_t port) override { return 0; }
+    int beginPacket(const char* host, uint16_t port) override {
+      this->_target = -1;
+      for (size_t i = 0; i < this->servers.size(); i++)
+        if (strcmp(this->servers[i].name, host) == 0) this->_target = i;
+      this->_written = 0;
+      return this->_target >= 0;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+      size = min(size, sizeof(this->lastRequest) - this->_written);
+      memcpy(this->lastRequest + this->_written, buffer, size);
+      this->_written += size;
+      return size;
+    }
+
+    int endPacket() override {
+      const StandInServer& server = this->servers[this->_target];
+      if (!server.lost) this->respond(this->lastRequest, server);
+      return 1;
+    }
+
+    int parsePacket() override {
+      if (this->_inbox.empty() || this->_inbox.front().arrival > MockClock::now) return 0;
+      this->_current = this->_inbox.front();
+      this->_inbox.erase(this->_inbox.begin());
+      return NTP_PACKET_SIZE;
+    }
+
+    int read(unsigned char* buffer, size_t len) override {
+      len = min(len, (size_t)NTP_PACKET_SIZE);
+      memcpy(buffer, this->_current.data, len);
+      return len;
+    }
+
+    void flush() override {}
+
+  private:
+    struct Packet {
+      int64_t arrival;    // In µs, true time
+      byte    data[NTP_PACKET_SIZE];
+    };
+
+    std::vector<Packet> _inbox;   // By arrival
+    Packet              _current;
+    int                 _target   = -1;
+    size_t              _written  = 0;
+};
+
+// In ms, how far the time of the client is from the true time
+static long error(const NTPClient& ntp) {
+  return (long)((int64_t)ntp.getEpochMillis() - MockClock::now / 1000);
+}
+
+static void testUpdate() {
+  StandInUDP udp;
+  udp.servers = { { "a.ntp", 0, 10000, 0, 2, false } };
+  NTPClient ntp(udp, "a.ntp");
+  ntp.begin();
+
+  REQUIRE(!ntp.isTimeSet());
+  REQUIRE(ntp.forceUpdate());
+  REQUIRE(ntp.isTimeSet());
+  REQUIRE(labs(error(ntp)) <= 1);
+  REQUIRE(ntp.getLastDelay() >= 20000 && ntp.getLastDelay() <= 20200);
+
+  // Without an answer the round ends at the timeout
+  udp.servers[0].lost = true;
+  MockClock::advance(64000000);
+  unsigned long start = millis();
+  REQUIRE(!ntp.forceUpdate());
+  REQUIRE(millis() - start >= NTP_DEFAULT_TIMEOUT && millis() - start <= NTP_DEFAULT_TIMEOUT + 1);
+  REQUIRE(labs(error(ntp)) <= 1);
+}
+
+static void testCookies() {
+  StandInUDP udp;
+  udp.servers = { { "a.ntp", 0, 10000, 0, 2, true } };
+  NTPClient ntp(udp, "a.ntp");
+  ntp.begin();
+
+  REQUIRE(!ntp.forceUpdate());
+  byte staleRequest[NTP_PACKET_SIZE];
+  memcpy(staleRequest, udp.lastRequest, NTP_PACKET_SIZE);
+
+  // The answer to the last round, 5 s wrong, arrives before the one to this
+  // round. Before it an answer to the request of some other client, with a
+  // different transmit timestamp
+  MockClock::advance(10000000);
+  StandInServer wrong = { "a.ntp", 5000000, 2000, 0, 2, false };
+  udp.respond(staleRequest, wrong);
+  byte foreignRequest[NTP_PACKET_SIZE];
+  memcpy(foreignRequest, staleRequest, NTP_PACKET_SIZE);
+  foreignRequest[47] ^= 0x5A;
+  wrong.delay = 1000;
+  udp.respond(foreignRequest, wrong);
+
+  udp.servers[0].lost = false;
+  REQUIRE(ntp.forceUpdate());
+  REQUIRE(labs(error(ntp)) <= 1);
+  REQUIRE(ntp.getLastDelay() >= 20000 && ntp.getLastDelay() <= 20200);
+
+  // Neither a kiss-o'-death nor an unsynchronized server sets the time
+  StandInUDP kissUdp;
+  kissUdp.servers = { { "kod.ntp", 5000000, 10000, 0, 0, false } };
+  NTPClient kissNtp(kissUdp, "kod.ntp");
+  kissNtp.begin();
+  REQUIRE(!kissNtp.forceUpdate());
+  REQUIRE(!kissNtp.isTimeSet());
+
+  kissUdp.servers[0].stratum = 16;
+  MockClock::advance(10000000);
+  REQUIRE(!kissNtp.forceUpdate());
+  REQUIRE(!kissNtp.isTimeSet());
+}
+
+static void testOutlier() {
+  // The wrong server is the closest one, it would win on the round trip alone
+  StandInUDP udp;
+  udp.servers = {
+    { "a.ntp", 0,       20000, 0, 2, false },
+    { "b.ntp", 0,       5000,  0, 2, false },
+    { "c.ntp", 2500000, 1000,  0, 2, false },
+  };
+  NTPClient ntp(udp, "a.ntp");
+  REQUIRE(ntp.addServer("b.ntp"));
+  REQUIRE(ntp.addServer("c.ntp"));
+  ntp.begin();
+
+  REQUIRE(ntp.forceUpdate());
+  REQUIRE(labs(error(ntp)) <= 1);
+  REQUIRE(ntp.getLastDelay() >= 10000 && ntp.getLastDelay() <= 10200); // b.ntp
+
+  // With only two there's no telling which one is wrong, the closest wins
+  StandInUDP pairUdp;
+  pairUdp.servers = { udp.servers[1], udp.servers[2] };
+  NTPClient pairNtp(pairUdp, "b.ntp");
+  REQUIRE(pairNtp.addServer("c.ntp"));
+  pairNtp.begin();
+
+  REQUIRE(pairNtp.forceUpdate());
+  REQUIRE(labs(error(pairNtp) - 2500) <= 1);
+}
+
+static void testSpikes() {
+  StandInUDP udp;
+  udp.servers = { { "a.ntp", 0, 10000, 2000, 2, false } };
+  NTPClient ntp(udp, "a.ntp");
+  ntp.begin();
+  REQUIRE(ntp.forceUpdate());
+
+  // The server jumps 1 s ahead, the client only follows once it's confirmed
+  udp.servers[0].offset = 1000000;
+  for (int round = 0; round < NTP_MAX_SPIKES; round++) {
+    MockClock::advance(64000000);
+    REQUIRE(!ntp.forceUpdate());
+    REQUIRE(labs(error(ntp)) <= 2);
+  }
+  MockClock::advance(64000000);
+  REQUIRE(ntp.forceUpdate());
+  REQUIRE(labs(ntp.getLastCorrection() - 1000000) <= 2000);
+  REQUIRE(labs(error(ntp) - 1000) <= 2);
+
+  // A single wrong round is ignored, and doesn't count towards the next jump
+  udp.servers[0].offset = 0;
+  MockClock::advance(64000000);
+  REQUIRE(!ntp.forceUpdate());
+  udp.servers[0].offset = 1000000;
+  MockClock::advance(64000000);
+  REQUIRE(ntp.forceUpdate());
+  REQUIRE(labs(ntp.getLastCorrection()) <= 2000);
+
+}
+
+static void testDrift() {
+  // The local clock runs 150 ppm slow, 9.6 ms in each update interval
+  MockClock::drift = 150;
+  unsigned long long waited = MockClock::waited;
+
+  StandInUDP udp;
+  udp.servers = { { "a.ntp", 0, 5000, 4000, 2, false } };
+  NTPClient ntp(udp, "a.ntp", 0, 64000);
+  ntp.begin();
+
+  long maxError = 0;
+  int updates = 0;
+  for (int64_t elapsed = 0; elapsed < 3 * 3600 * 1000000LL; elapsed += 1000) {
+    MockClock::advance(1000);
+    if (ntp.poll()) updates++;
+    if (elapsed >= 2 * 3600 * 1000000LL) maxError = max(maxError, labs(error(ntp)));
+  }
+
+  // poll() never waits for the responses
+  REQUIRE(MockClock::waited == waited);
+  REQUIRE(updates >= 3 * 3600 / 64 - 1);
+  REQUIRE(ntp.getDrift() >= 145 && ntp.getDrift() <= 155);
+  REQUIRE(maxError <= 3);
+
+  MockClock::drift = 0;
+}
+
+int main() {
+  testUpdate();
+  testCookies();
+  testOutlier();
+  testSpikes();
+  testDrift();
+  return 0;
+}
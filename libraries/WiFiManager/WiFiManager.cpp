@@ -14,6 +14,12 @@
 
 #if defined(ESP8266) || defined(ESP32)
 
+#ifdef ESP8266
+#include <EEPROM.h>
+#elif defined(ESP32)
+#include <Preferences.h>
+#endif
+
 #ifdef ESP32
 uint8_t WiFiManager::_lastconxresulttmp = WL_IDLE_STATUS;
 #endif
@@ -268,6 +274,170 @@ boolean WiFiManager::autoConnect() {
   return autoConnect(ssid.c_str(), NULL);
 }
 
+// where fast connect caches the last connection, can be moved with build flags if the sketch uses the same place
+#ifndef WM_FASTCONNECT_RTC_OFFSET
+#define WM_FASTCONNECT_RTC_OFFSET    112  // esp8266 rtc user memory block, 4 bytes each, the first 32 are erased by OTA
+#endif
+
+#ifndef WM_FASTCONNECT_EEPROM_OFFSET
+#define WM_FASTCONNECT_EEPROM_OFFSET 4036 // esp8266 eeprom sector offset, at its end, the sketch keeps the rest
+#endif
+
+#ifdef ESP32
+RTC_NOINIT_ATTR static wm_fastconnect_cache_t _wm_fastconnect_rtc; // kept over resets and deep sleep, garbage after power on
+#endif
+
+/**
+ * fast connect driver, esp wifi, rtc memory and flash
+ * connects with the saved credentials, or the preloaded ones
+ */
+class WiFiManagerFastConnectESP : public WiFiManagerFastConnectDriver {
+  public:
+    WiFiManagerFastConnectESP(WiFiManager &wm, char const *apName = NULL, char const *apPassword = NULL) :
+      _wm(wm), _apName(apName), _apPassword(apPassword) {}
+
+    unsigned long now() override {
+      return millis();
+    }
+
+    void wait(unsigned long ms) override {
+      delay(ms);
+    }
+
+    bool readRTC(wm_fastconnect_cache_t &cache) override {
+      #ifdef ESP8266
+      return ESP.rtcUserMemoryRead(WM_FASTCONNECT_RTC_OFFSET, (uint32_t*)&cache, sizeof(cache));
+      #elif defined(ESP32)
+      memcpy(&cache, &_wm_fastconnect_rtc, sizeof(cache));
+      return true;
+      #endif
+    }
+
+    bool writeRTC(const wm_fastconnect_cache_t &cache) override {
+      #ifdef ESP8266
+      return ESP.rtcUserMemoryWrite(WM_FASTCONNECT_RTC_OFFSET, (uint32_t*)&cache, sizeof(cache));
+      #elif defined(ESP32)
+      memcpy(&_wm_fastconnect_rtc, &cache, sizeof(cache));
+      return true;
+      #endif
+    }
+
+    bool readFlash(wm_fastconnect_cache_t &cache) override {
+      #ifdef ESP8266
+      // own instance, so the sketch's EEPROM buffer is left alone
+      EEPROMClass eeprom;
+      eeprom.begin(WM_FASTCONNECT_EEPROM_OFFSET + sizeof(cache));
+      eeprom.get(WM_FASTCONNECT_EEPROM_OFFSET, cache);
+      eeprom.end();
+      return true;
+      #elif defined(ESP32)
+      Preferences prefs;
+      if(!prefs.begin("wm_fastconnect", true)) return false;
+      bool ret = prefs.getBytes("cache", &cache, sizeof(cache)) == sizeof(cache);
+      prefs.end();
+      return ret;
+      #endif
+    }
+
+    bool writeFlash(const wm_fastconnect_cache_t &cache) override {
+      #ifdef WM_DEBUG_LEVEL
+      _wm.DEBUG_WM(WM_DEBUG_VERBOSE,F("FastConnect: saving to flash"));
+      #endif
+      #ifdef ESP8266
+      EEPROMClass eeprom;
+      eeprom.begin(WM_FASTCONNECT_EEPROM_OFFSET + sizeof(cache));
+      eeprom.put(WM_FASTCONNECT_EEPROM_OFFSET, cache);
+      bool ret = eeprom.commit();
+      eeprom.end();
+      return ret;
+      #elif defined(ESP32)
+      Preferences prefs;
+      if(!prefs.begin("wm_fastconnect", false)) return false;
+      bool ret = prefs.putBytes("cache", &cache, sizeof(cache)) == sizeof(cache);
+      prefs.end();
+      return ret;
+      #endif
+    }
+
+    bool getSavedSSID(char *ssid, size_t size) override {
+      String saved = _wm._defaultssid != "" ? _wm._defaultssid : _wm.WiFi_SSID(true);
+      strncpy(ssid, saved.c_str(), size);
+      ssid[size - 1] = '\0';
+      return saved != "";
+    }
+
+    bool beginDirect(const wm_fastconnect_cache_t &cache, bool reuseIP) override {
+      // a static ip from setSTAStaticIPConfig wins over the cached one
+      _reusedIP = reuseIP && !_wm._sta_static_ip;
+      if(_reusedIP) WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway), IPAddress(cache.subnet), IPAddress(cache.dns));
+      else _wm.setSTAConfig();
+
+      #ifdef WM_DEBUG_LEVEL
+      char bssid[18];
+      sprintf(bssid, "%02X:%02X:%02X:%02X:%02X:%02X", cache.bssid[0], cache.bssid[1], cache.bssid[2], cache.bssid[3], cache.bssid[4], cache.bssid[5]);
+      _wm.DEBUG_WM(F("FastConnect: connecting to"), (String)cache.ssid + " " + bssid + " ch " + (String)cache.channel);
+      if(_reusedIP) _wm.DEBUG_WM(WM_DEBUG_VERBOSE,F("FastConnect: reusing IP"), IPAddress(cache.ip));
+      #endif
+
+      // not persistent, the saved config keeps scanning for any bssid
+      return WiFi.begin(cache.ssid, savedPassword().c_str(), cache.channel, cache.bssid) != WL_CONNECT_FAILED;
+    }
+
+    bool beginScan() override {
+      _wm.WiFi_Disconnect();
+      if(_reusedIP){
+        WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0)); // back to dhcp
+        _reusedIP = false;
+      }
+      _wm.setSTAConfig();
+
+      char ssid[33];
+      if(!getSavedSSID(ssid, sizeof(ssid))) return false;
+
+      #ifdef WM_DEBUG_LEVEL
+      _wm.DEBUG_WM(F("FastConnect: scanning for"), ssid);
+      #endif
+      return WiFi.begin(ssid, savedPassword().c_str()) != WL_CONNECT_FAILED;
+    }
+
+    wm_fastconnect_status_t status() override {
+      switch(WiFi.status()){
+        case WL_CONNECTED:      return WM_FASTCONNECT_CONNECTED;
+        case WL_NO_SSID_AVAIL:
+        case WL_CONNECT_FAILED: return WM_FASTCONNECT_FAILED;
+        default:                return WM_FASTCONNECT_CONNECTING;
+      }
+    }
+
+    bool getConnection(wm_fastconnect_cache_t &cache) override {
+      if(WiFi.status() != WL_CONNECTED) return false;
+      strncpy(cache.ssid, WiFi.SSID().c_str(), sizeof(cache.ssid) - 1);
+      uint8_t *bssid = WiFi.BSSID();
+      if(bssid) memcpy(cache.bssid, bssid, sizeof(cache.bssid));
+      cache.channel = WiFi.channel();
+      cache.ip      = WiFi.localIP();
+      cache.gateway = WiFi.gatewayIP();
+      cache.subnet  = WiFi.subnetMask();
+      cache.dns     = WiFi.dnsIP();
+      return true;
+    }
+
+    bool startPortal() override {
+      _wm.updateConxResult(WiFi.status());
+      return _wm.startConfigPortal(_apName, _apPassword);
+    }
+
+  protected:
+    WiFiManager &_wm;
+    char const  *_apName;
+    char const  *_apPassword;
+    bool         _reusedIP = false;
+
+    String savedPassword() {
+      return _wm._defaultssid != "" ? _wm._defaultpass : _wm.WiFi_psk(true);
+    }
+};
+
 /**
  * [autoConnect description]
  * @access public
@@ -347,16 +517,29 @@ boolean WiFiManager::autoConnect(char const *apName, char const *apPassword) {
       // and we have no idea WHAT we are connected to
     }
 
+    // cached ap first, then scan, then config portal
+    if(!connected && _fastConnect){
+      return fastConnect(apName, apPassword);
+    }
+
     if(connected || connectWifi(_defaultssid, _defaultpass) == WL_CONNECTED){
       //connected
+      _bootToOnline = millis();
       #ifdef WM_DEBUG_LEVEL
       DEBUG_WM(F("AutoConnect: SUCCESS"));
       DEBUG_WM(WM_DEBUG_VERBOSE,F("Connected in"),(String)((millis()-_startconn)) + " ms");
+      DEBUG_WM(F("Boot to online:"),(String)_bootToOnline + " ms");
       DEBUG_WM(F("STA IP Address:"),WiFi.localIP());
       #endif
       // Serial.println("Connected in " + (String)((millis()-_startconn)) + " ms");
       _lastconxresult = WL_CONNECTED;
 
+      // connected before autoconnect, cache it for the next boot
+      if(_fastConnect){
+        WiFiManagerFastConnectESP driver(*this);
+        WiFiManagerFastConnect(driver).save();
+      }
+
       if(_hostname != ""){
         #ifdef WM_DEBUG_LEVEL
           DEBUG_WM(WM_DEBUG_DEV,F("hostname: STA: "),getWiFiHostname());
@@ -389,6 +572,41 @@ boolean WiFiManager::autoConnect(char const *apName, char const *apPassword) {
   return res;
 }
 
+/**
+ * autoConnect with fast connect, the cached bssid, channel and ip first,
+ * then a scan connect, then the config portal
+ * @since $dev
+ * @access protected
+ * @return bool connected
+ */
+boolean WiFiManager::fastConnect(char const *apName, char const *apPassword) {
+  WiFiManagerFastConnectESP driver(*this, apName, apPassword);
+  WiFiManagerFastConnect fc(driver);
+  fc.setDirectTimeout(_fastConnectTimeout);
+  fc.setScanTimeout(_connectTimeout > 0 ? _connectTimeout : WM_FASTCONNECT_SCAN_TIMEOUT);
+  fc.setReuseIP(_fastConnectReuseIP);
+  fc.setPortal(_enableConfigPortal);
+
+  bool res = fc.connect();
+  _fastConnectPath = fc.getPath();
+  _bootToOnline    = fc.getBootToOnline();
+
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(F("FastConnect:"),WiFiManagerFastConnect::getStateString(_fastConnectPath));
+  if(res){
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Connected in"),(String)fc.getConnectTime() + " ms");
+    DEBUG_WM(F("Boot to online:"),(String)_bootToOnline + " ms");
+    DEBUG_WM(F("STA IP Address:"),WiFi.localIP());
+  }
+  else if(!_enableConfigPortal){
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("enableConfigPortal: FALSE, skipping "));
+  }
+  #endif
+
+  if(res) _lastconxresult = WL_CONNECTED;
+  return res;
+}
+
 bool WiFiManager::setupHostname(bool restart){
   if(_hostname == "") {
     #ifdef WM_DEBUG_LEVEL
@@ -2650,6 +2868,11 @@ void WiFiManager::resetSettings() {
     WiFi.disconnect(true);
     WiFi.persistent(false);
   #endif
+
+  // and the fast connect cache
+  WiFiManagerFastConnectESP driver(*this);
+  WiFiManagerFastConnect(driver).erase();
+
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(F("SETTINGS ERASED"));
   #endif
@@ -2693,6 +2916,27 @@ void WiFiManager::setConnectRetries(uint8_t numRetries){
   _connectRetries = constrain(numRetries,1,10);
 }
 
+/**
+ * toggle fast connect for autoconnect, cached bssid channel and ip first
+ * @since $dev
+ * @access public
+ * @param {[type]} bool enable  [description]
+ * @param {[type]} bool reuseIP reuse the cached ip, skipping dhcp
+ */
+void WiFiManager::setFastConnect(bool enable, bool reuseIP){
+  _fastConnect        = enable;
+  _fastConnectReuseIP = reuseIP;
+}
+
+/**
+ * [setFastConnectTimeout description]
+ * @access public
+ * @param {[type]} unsigned long seconds [description]
+ */
+void WiFiManager::setFastConnectTimeout(unsigned long seconds){
+  _fastConnectTimeout = seconds * 1000;
+}
+
 /**
  * toggle _cleanconnect, always disconnect before connecting
  * @param {[type]} bool enable [description]
@@ -3249,6 +3493,26 @@ bool WiFiManager::getWiFiIsSaved(){
   return WiFi_hasAutoConnect();
 }
 
+/**
+ * get when autoconnect got online
+ * @since $dev
+ * @access public
+ * @return unsigned long ms since boot, 0 if not online
+ */
+unsigned long WiFiManager::getBootToOnline(){
+  return _bootToOnline;
+}
+
+/**
+ * get how autoconnect got online with fast connect
+ * @since $dev
+ * @access public
+ * @return wm_fastconnect_state_t DIRECT, SCAN, PORTAL or OFFLINE, IDLE if not used
+ */
+wm_fastconnect_state_t WiFiManager::getFastConnectPath(){
+  return _fastConnectPath;
+}
+
 /**
  * getDefaultAPName
  * @since $dev
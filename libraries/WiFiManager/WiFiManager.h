@@ -132,6 +132,8 @@
 #include <DNSServer.h>
 #include <memory>
 
+#include "wm_fastconnect.h"
+
 
 // Include wm strings vars
 // Pass in strings env override via WM_STRINGS_FILE
@@ -338,6 +340,13 @@ class WiFiManager
 
     // sets number of retries for autoconnect, force retry after wait failure exit
     void          setConnectRetries(uint8_t numRetries); // default 1
+
+    // autoconnect tries the bssid, channel and ip of the last connection before scanning, cached in rtc memory and flash
+    // reuseIP skips dhcp too, only if the lease is reserved or long
+    void          setFastConnect(bool enable, bool reuseIP = false); // default false
+
+    //sets timeout for the fast connect attempt, before falling back to a scan connect
+    void          setFastConnectTimeout(unsigned long seconds); // default 4
     
     //sets timeout for which to attempt connecting on saves, useful if there are bugs in esp waitforconnectloop
     void          setSaveConnectTimeout(unsigned long seconds);
@@ -455,6 +464,12 @@ class WiFiManager
     // check if the module has a saved ap to connect to
     bool          getWiFiIsSaved();
 
+    // ms since boot when autoconnect got online, 0 if it did not
+    unsigned long getBootToOnline();
+
+    // how autoconnect got online with fast connect, WM_FASTCONNECT_DIRECT, _SCAN, _PORTAL, or _OFFLINE
+    wm_fastconnect_state_t getFastConnectPath();
+
     // helper to get saved password, if persistent get stored, else get current if connected    
     String        getWiFiPass(bool persistent = true);
 
@@ -509,6 +524,8 @@ class WiFiManager
     std::unique_ptr<WM_WebServer> server;
 
   protected:
+    friend class WiFiManagerFastConnectESP;
+
     // vars
     std::vector<uint8_t> _menuIds;
     std::vector<const char *> _menuIdsParams  = {"wifi","param","info","exit"};
@@ -593,6 +610,11 @@ class WiFiManager
     boolean       _showBack               = false; // show back button
     boolean       _enableConfigPortal     = true;  // FOR autoconnect - start config portal if autoconnect failed
     boolean       _disableConfigPortal    = true;  // FOR autoconnect - stop config portal if cp wifi save
+    bool          _fastConnect            = false; // FOR autoconnect - try the cached bssid, channel and ip first
+    bool          _fastConnectReuseIP     = false; // FOR autoconnect - reuse the cached ip, skip dhcp
+    unsigned long _fastConnectTimeout     = WM_FASTCONNECT_DIRECT_TIMEOUT; // ms give up the fast connect attempt, then scan
+    unsigned long _bootToOnline           = 0; // ms since boot when autoconnect got online
+    wm_fastconnect_state_t _fastConnectPath = WM_FASTCONNECT_IDLE; // how autoconnect got online with fast connect
     String        _hostname               = "";    // hostname for esp8266 for dhcp, and or MDNS
 
     const char*   _customHeadElement      = ""; // store custom head element html from user isnide <head>
@@ -660,6 +682,7 @@ protected:
     uint8_t       waitForConnectResult();
     uint8_t       waitForConnectResult(uint32_t timeout);
     void          updateConxResult(uint8_t status);
+    boolean       fastConnect(char const *apName, char const *apPassword);
 
     // webserver handlers
 public:
@@ -0,0 +1,361 @@
+/**
+ * fastconnect.cpp
+ * WiFiManagerFastConnect against a fake driver: one access point, and rtc
+ * memory and flash that count their writes
+ *
+ * @license MIT
+ */
+
+#include "wm_fastconnect.h"
+
+#include <string.h>
+
+#include "check.h"
+
+class FakeDriver : public WiFiManagerFastConnectDriver {
+  public:
+    unsigned long clock = 350; // ms, boot to autoConnect
+
+    bool          rtcValid    = false;
+    bool          flashValid  = false;
+    wm_fastconnect_cache_t rtc   = {};
+    wm_fastconnect_cache_t flash = {};
+    int           rtcWrites   = 0;
+    int           flashWrites = 0;
+    const char   *savedSSID   = "home";
+
+    // the access point, and how long each way of connecting to it takes
+    uint8_t       bssid[6]    = {0x02, 0x1A, 0x2B, 0x3C, 0x4D, 0x5E};
+    uint8_t       channel     = 6;
+    bool          apUp        = true;
+    unsigned long directMs    = 180;
+    unsigned long scanMs      = 2300;
+    unsigned long dhcpMs      = 600;
+    unsigned long failMs      = 1500; // until a directed connect to the wrong bssid or channel gives up
+
+    bool          portalConnects = false;
+    int           portals     = 0;
+    int           directs     = 0;
+    int           scans       = 0;
+    bool          reusedIP    = false;
+
+    unsigned long now() override { return clock; }
+    void wait(unsigned long ms) override { clock += ms; }
+
+    bool readRTC(wm_fastconnect_cache_t &cache) override {
+      if(!rtcValid) return false;
+      cache = rtc;
+      return true;
+    }
+    bool writeRTC(const wm_fastconnect_cache_t &cache) override {
+      rtc = cache;
+      rtcValid = true;
+      rtcWrites++;
+      return true;
+    }
+    bool readFlash(wm_fastconnect_cache_t &cache) override {
+      if(!flashValid) return false;
+      cache = flash;
+      return true;
+    }
+    bool writeFlash(const wm_fastconnect_cache_t &cache) override {
+      flash = cache;
+      flashValid = true;
+      flashWrites++;
+      return true;
+    }
+
+    bool getSavedSSID(char *ssid, size_t size) override {
+      strncpy(ssid, savedSSID, size);
+      return savedSSID[0] != '\0';
+    }
+
+    bool beginDirect(const wm_fastconnect_cache_t &cache, bool reuseIP) override {
+      directs++;
+      reusedIP   = reuseIP;
+      _connected = false;
+      _failing   = !apUp || memcmp(cache.bssid, bssid, sizeof(bssid)) != 0 || cache.channel != channel;
+      _doneAt    = clock + (_failing ? failMs : directMs + (reuseIP ? 0 : dhcpMs));
+      return true;
+    }
+    bool beginScan() override {
+      scans++;
+      reusedIP   = false;
+      _connected = false;
+      _failing   = !apUp;
+      _doneAt    = clock + scanMs + dhcpMs;
+      return true;
+    }
+    wm_fastconnect_status_t status() override {
+      if(!_connected && clock >= _doneAt && !_failing) _connected = true;
+      if(_connected) return WM_FASTCONNECT_CONNECTED;
+      return clock >= _doneAt ? WM_FASTCONNECT_FAILED : WM_FASTCONNECT_CONNECTING;
+    }
+
+    bool getConnection(wm_fastconnect_cache_t &cache) override {
+      if(!_connected) return false;
+      strncpy(cache.ssid, savedSSID, sizeof(cache.ssid));
+      memcpy(cache.bssid, bssid, sizeof(bssid));
+      cache.channel = channel;
+      cache.ip      = 0x6401A8C0; // 192.168.1.100
+      cache.gateway = 0x0101A8C0;
+      cache.subnet  = 0x00FFFFFF;
+      cache.dns     = 0x0101A8C0;
+      return true;
+    }
+
+    bool startPortal() override {
+      portals++;
+      clock += 60000;
+      _connected = portalConnects;
+      _doneAt    = clock;
+      _failing   = !portalConnects;
+      return portalConnects;
+    }
+
+    // a reset keeps rtc memory, a power cycle doesn't
+    void reboot(bool powerCycle = false) {
+      clock      = 350;
+      _connected = false;
+      _doneAt    = (unsigned long)-1;
+      if(powerCycle){
+        rtcValid = true;
+        memset(&rtc, 0xA5, sizeof(rtc));
+      }
+    }
+
+  private:
+    bool          _connected  = false;
+    bool          _failing    = false;
+    unsigned long _doneAt     = (unsigned long)-1;
+};
+
+// connects once, with a scan, so that the next boot has a cache
+static void prime(FakeDriver &driver) {
+  WiFiManagerFastConnect fastConnect(driver);
+  REQUIRE(fastConnect.connect());
+  driver.reboot();
+}
+
+static void testFirstBoot() {
+  FakeDriver driver;
+  WiFiManagerFastConnect fastConnect(driver);
+  fastConnect.begin();
+  REQUIRE(!fastConnect.getCacheValid());
+  REQUIRE(fastConnect.getState() == WM_FASTCONNECT_SCAN);
+
+  REQUIRE(fastConnect.connect());
+  REQUIRE(fastConnect.getPath() == WM_FASTCONNECT_SCAN);
+  REQUIRE(driver.directs == 0);
+  REQUIRE(fastConnect.getConnectTime() >= driver.scanMs + driver.dhcpMs);
+  REQUIRE(fastConnect.getBootToOnline() == 350 + fastConnect.getConnectTime());
+
+  // both caches written, with the connection
+  REQUIRE(driver.rtcWrites == 1 && driver.flashWrites == 1);
+  REQUIRE(strcmp(driver.flash.ssid, "home") == 0);
+  REQUIRE(driver.flash.channel == 6);
+  REQUIRE(driver.flash.crc == WiFiManagerFastConnect::crc(driver.flash));
+}
+
+static void testDirect() {
+  FakeDriver driver;
+  prime(driver);
+
+  WiFiManagerFastConnect fastConnect(driver);
+  REQUIRE(fastConnect.connect());
+  REQUIRE(fastConnect.getPath() == WM_FASTCONNECT_DIRECT);
+  REQUIRE(driver.scans == 1);
+  REQUIRE(!driver.reusedIP);
+  REQUIRE(fastConnect.getConnectTime() < driver.directMs + driver.dhcpMs + WM_FASTCONNECT_POLL);
+
+  // the same connection, nothing written
+  REQUIRE(driver.rtcWrites == 1 && driver.flashWrites == 1);
+
+  // and without dhcp
+  driver.reboot();
+  WiFiManagerFastConnect reuseIP(driver);
+  reuseIP.setReuseIP(true);
+  REQUIRE(reuseIP.connect());
+  REQUIRE(reuseIP.getPath() == WM_FASTCONNECT_DIRECT);
+  REQUIRE(driver.reusedIP);
+  REQUIRE(reuseIP.getConnectTime() < driver.directMs + WM_FASTCONNECT_POLL);
+}
+
+static void testDirectTimeout() {
+  FakeDriver driver;
+  prime(driver);
+
+  // the directed connect hangs, the scan gets it after the timeout
+  driver.directMs = 100000;
+  WiFiManagerFastConnect fastConnect(driver);
+  fastConnect.setDirectTimeout(3000);
+  fastConnect.begin();
+  REQUIRE(fastConnect.getState() == WM_FASTCONNECT_DIRECT);
+
+  while(fastConnect.process() == WM_FASTCONNECT_DIRECT) driver.wait(1);
+  REQUIRE(fastConnect.getState() == WM_FASTCONNECT_SCAN);
+  REQUIRE(driver.clock - 350 == 3000);
+
+  REQUIRE(fastConnect.connect());
+  REQUIRE(fastConnect.getPath() == WM_FASTCONNECT_SCAN);
+
+  // a directed connect that fails is left before the timeout
+  driver.reboot();
+  driver.directMs = 180;
+  driver.channel  = 11;
+  WiFiManagerFastConnect moved(driver);
+  REQUIRE(moved.connect());
+  REQUIRE(moved.getPath() == WM_FASTCONNECT_SCAN);
+  REQUIRE(moved.getConnectTime() < driver.failMs + driver.scanMs + driver.dhcpMs + 2 * WM_FASTCONNECT_POLL);
+
+  // and the new channel is cached
+  REQUIRE(driver.rtc.channel == 11 && driver.flash.channel == 11);
+  REQUIRE(driver.flashWrites == 2);
+}
+
+static void testPortal() {
+  FakeDriver driver;
+  prime(driver);
+
+  // no ap: direct and scan fail, the portal connects
+  driver.apUp = false;
+  driver.portalConnects = true;
+  WiFiManagerFastConnect fastConnect(driver);
+  REQUIRE(fastConnect.connect());
+  REQUIRE(fastConnect.getPath() == WM_FASTCONNECT_PORTAL);
+  REQUIRE(driver.portals == 1);
+
+  // the portal doesn't connect either
+  driver.reboot();
+  driver.portalConnects = false;
+  WiFiManagerFastConnect offline(driver);
+  REQUIRE(!offline.connect());
+  REQUIRE(offline.getState() == WM_FASTCONNECT_OFFLINE);
+  REQUIRE(offline.getPath() == WM_FASTCONNECT_OFFLINE);
+  REQUIRE(offline.getBootToOnline() == 0 && offline.getConnectTime() == 0);
+  REQUIRE(driver.portals == 2);
+
+  // portal disabled: OFFLINE right after the scan
+  driver.reboot();
+  WiFiManagerFastConnect noPortal(driver);
+  noPortal.setPortal(false);
+  REQUIRE(!noPortal.connect());
+  REQUIRE(noPortal.getPath() == WM_FASTCONNECT_OFFLINE);
+  REQUIRE(driver.portals == 2);
+
+  // nothing enabled at all
+  driver.reboot();
+  WiFiManagerFastConnect nothing(driver);
+  nothing.setDirectTimeout(0);
+  nothing.setScanTimeout(0);
+  nothing.setPortal(false);
+  nothing.begin();
+  REQUIRE(nothing.getState() == WM_FASTCONNECT_OFFLINE);
+}
+
+static void testRejectedCache() {
+  FakeDriver driver;
+  prime(driver);
+
+  // a power cycle leaves garbage in rtc memory, flash is used
+  driver.reboot(true);
+  WiFiManagerFastConnect fromFlash(driver);
+  fromFlash.begin();
+  REQUIRE(fromFlash.getCacheValid());
+  REQUIRE(fromFlash.getState() == WM_FASTCONNECT_DIRECT);
+  REQUIRE(fromFlash.connect());
+  REQUIRE(fromFlash.getPath() == WM_FASTCONNECT_DIRECT);
+  REQUIRE(driver.rtcWrites == 2 && driver.flashWrites == 1);
+
+  // a flipped bit in both
+  driver.reboot();
+  driver.rtc.bssid[2]   ^= 0x10;
+  driver.flash.bssid[2] ^= 0x10;
+  WiFiManagerFastConnect corrupted(driver);
+  corrupted.begin();
+  REQUIRE(!corrupted.getCacheValid());
+  REQUIRE(corrupted.getState() == WM_FASTCONNECT_SCAN);
+
+  // an ssid without its terminator, even with the right crc
+  driver.reboot();
+  memset(driver.rtc.ssid, 'x', sizeof(driver.rtc.ssid));
+  driver.rtc.crc = WiFiManagerFastConnect::crc(driver.rtc);
+  driver.flash   = driver.rtc;
+  WiFiManagerFastConnect unterminated(driver);
+  unterminated.begin();
+  REQUIRE(!unterminated.getCacheValid());
+
+  // the credentials were changed since the cache was written
+  driver.reboot();
+  prime(driver);
+  driver.savedSSID = "office";
+  WiFiManagerFastConnect changed(driver);
+  changed.begin();
+  REQUIRE(!changed.getCacheValid());
+  REQUIRE(changed.getState() == WM_FASTCONNECT_SCAN);
+
+  driver.savedSSID = "";
+  WiFiManagerFastConnect none(driver);
+  none.begin();
+  REQUIRE(!none.getCacheValid());
+}
+
+static void testSave() {
+  FakeDriver driver;
+  prime(driver);
+
+  WiFiManagerFastConnect fastConnect(driver);
+  REQUIRE(fastConnect.connect());
+
+  // unchanged, no writes
+  REQUIRE(fastConnect.save());
+  REQUIRE(fastConnect.save());
+  REQUIRE(driver.rtcWrites == 1 && driver.flashWrites == 1);
+
+  // only rtc memory lost, only rtc memory written
+  driver.rtcValid = false;
+  REQUIRE(fastConnect.save());
+  REQUIRE(driver.rtcWrites == 2 && driver.flashWrites == 1);
+
+  // a new ip, both
+  driver.rtc.ip = 0;
+  driver.rtc.crc = WiFiManagerFastConnect::crc(driver.rtc);
+  driver.flash = driver.rtc;
+  REQUIRE(fastConnect.save());
+  REQUIRE(driver.rtcWrites == 3 && driver.flashWrites == 2);
+  REQUIRE(driver.flash.ip == 0x6401A8C0);
+
+  // not connected, nothing to save
+  driver.reboot();
+  REQUIRE(!fastConnect.save());
+  REQUIRE(driver.rtcWrites == 3 && driver.flashWrites == 2);
+}
+
+static void testErase() {
+  FakeDriver driver;
+  prime(driver);
+
+  WiFiManagerFastConnect fastConnect(driver);
+  fastConnect.erase();
+  REQUIRE(!fastConnect.getCacheValid());
+  REQUIRE(driver.rtcWrites == 2 && driver.flashWrites == 2);
+
+  // already erased, no writes
+  fastConnect.erase();
+  REQUIRE(driver.rtcWrites == 2 && driver.flashWrites == 2);
+
+  fastConnect.begin();
+  REQUIRE(!fastConnect.getCacheValid());
+  REQUIRE(fastConnect.getState() == WM_FASTCONNECT_SCAN);
+}
+
+int main() {
+  testFirstBoot();
+  testDirect();
+  testDirectTimeout();
+  testPortal();
+  testRejectedCache();
+  testSave();
+  testErase();
+  return 0;
+}
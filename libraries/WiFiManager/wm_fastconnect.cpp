@@ -0,0 +1,220 @@
+/**
+ * wm_fastconnect.cpp
+ * fast reconnect for autoConnect
+ * WiFiManager, a library for the ESP8266/Arduino platform
+ * for configuration of WiFi credentials using a Captive Portal
+ *
+ * @license MIT
+ */
+
+#include "wm_fastconnect.h"
+
+#include <string.h>
+
+static_assert(sizeof(wm_fastconnect_cache_t) % 4 == 0, "wm_fastconnect_cache_t must be a multiple of 4 bytes");
+
+WiFiManagerFastConnect::WiFiManagerFastConnect(WiFiManagerFastConnectDriver &driver) : _driver(driver) {
+  memset(&_cache, 0, sizeof(_cache));
+}
+
+void WiFiManagerFastConnect::setDirectTimeout(unsigned long ms) {
+  _directTimeout = ms;
+}
+
+void WiFiManagerFastConnect::setScanTimeout(unsigned long ms) {
+  _scanTimeout = ms;
+}
+
+void WiFiManagerFastConnect::setReuseIP(bool enable) {
+  _reuseIP = enable;
+}
+
+void WiFiManagerFastConnect::setPortal(bool enable) {
+  _portal = enable;
+}
+
+void WiFiManagerFastConnect::begin() {
+  _begin       = _driver.now();
+  _online      = 0;
+  _path        = WM_FASTCONNECT_IDLE;
+  _state       = WM_FASTCONNECT_IDLE;
+
+  // rtc memory survives deep sleep and resets, flash is only needed after power on
+  _cacheValid = loadCache(_cache, true) || loadCache(_cache, false);
+
+  // only for the ap of the saved credentials, they may have changed since
+  char ssid[33] = "";
+  if(_cacheValid && (!_driver.getSavedSSID(ssid, sizeof(ssid)) || strncmp(ssid, _cache.ssid, sizeof(ssid)) != 0)){
+    _cacheValid = false;
+  }
+
+  next();
+}
+
+wm_fastconnect_state_t WiFiManagerFastConnect::process() {
+  switch(_state){
+    case WM_FASTCONNECT_IDLE:
+      begin();
+      break;
+
+    case WM_FASTCONNECT_DIRECT:
+    case WM_FASTCONNECT_SCAN: {
+      if(!_stepStarted){
+        _stepStarted = true;
+        _stepStart   = _driver.now();
+
+        bool started = _state == WM_FASTCONNECT_DIRECT ?
+          _driver.beginDirect(_cache, _reuseIP && _cache.ip != 0) : _driver.beginScan();
+
+        if(!started){
+          next();
+          break;
+        }
+      }
+
+      wm_fastconnect_status_t status = _driver.status();
+      unsigned long timeout = _state == WM_FASTCONNECT_DIRECT ? _directTimeout : _scanTimeout;
+
+      if(status == WM_FASTCONNECT_CONNECTED) setOnline();
+      else if(status == WM_FASTCONNECT_FAILED || _driver.now() - _stepStart >= timeout) next();
+      break;
+    }
+
+    case WM_FASTCONNECT_PORTAL:
+      if(_driver.startPortal() && _driver.status() == WM_FASTCONNECT_CONNECTED) setOnline();
+      else next();
+      break;
+
+    default:
+      break;
+  }
+
+  return _state;
+}
+
+bool WiFiManagerFastConnect::connect() {
+  begin();
+  while(process() != WM_FASTCONNECT_ONLINE && _state != WM_FASTCONNECT_OFFLINE){
+    _driver.wait(WM_FASTCONNECT_POLL);
+  }
+  return _state == WM_FASTCONNECT_ONLINE;
+}
+
+bool WiFiManagerFastConnect::save() {
+  wm_fastconnect_cache_t cache;
+  memset(&cache, 0, sizeof(cache));
+  if(!_driver.getConnection(cache) || cache.ssid[0] == '\0') return false;
+  cache.ssid[sizeof(cache.ssid) - 1] = '\0';
+  cache.crc = crc(cache);
+
+  // only write what changed, flash in particular
+  wm_fastconnect_cache_t stored;
+  bool ret = true;
+  if(!loadCache(stored, true) || memcmp(&stored, &cache, sizeof(cache)) != 0){
+    ret = _driver.writeRTC(cache) && ret;
+  }
+  if(!loadCache(stored, false) || memcmp(&stored, &cache, sizeof(cache)) != 0){
+    ret = _driver.writeFlash(cache) && ret;
+  }
+
+  _cache      = cache;
+  _cacheValid = true;
+  return ret;
+}
+
+void WiFiManagerFastConnect::erase() {
+  wm_fastconnect_cache_t cache;
+  memset(&cache, 0, sizeof(cache)); // crc never matches, caches are seeded with the version
+
+  wm_fastconnect_cache_t stored;
+  if(loadCache(stored, true))  _driver.writeRTC(cache);
+  if(loadCache(stored, false)) _driver.writeFlash(cache);
+
+  _cache      = cache;
+  _cacheValid = false;
+}
+
+wm_fastconnect_state_t WiFiManagerFastConnect::getState() {
+  return _state;
+}
+
+wm_fastconnect_state_t WiFiManagerFastConnect::getPath() {
+  return _path;
+}
+
+unsigned long WiFiManagerFastConnect::getBootToOnline() {
+  return _state == WM_FASTCONNECT_ONLINE ? _online : 0;
+}
+
+unsigned long WiFiManagerFastConnect::getConnectTime() {
+  return _state == WM_FASTCONNECT_ONLINE ? _online - _begin : 0;
+}
+
+bool WiFiManagerFastConnect::getCacheValid() {
+  return _cacheValid;
+}
+
+const char* WiFiManagerFastConnect::getStateString(wm_fastconnect_state_t state) {
+  switch(state){
+    case WM_FASTCONNECT_IDLE:    return "IDLE";
+    case WM_FASTCONNECT_DIRECT:  return "DIRECT";
+    case WM_FASTCONNECT_SCAN:    return "SCAN";
+    case WM_FASTCONNECT_PORTAL:  return "PORTAL";
+    case WM_FASTCONNECT_ONLINE:  return "ONLINE";
+    case WM_FASTCONNECT_OFFLINE: return "OFFLINE";
+  }
+  return "UNKNOWN";
+}
+
+/**
+ * crc32 of the cache after the crc field, seeded with WM_FASTCONNECT_VERSION
+ * bitwise, the cache is checked once per boot
+ */
+uint32_t WiFiManagerFastConnect::crc(const wm_fastconnect_cache_t &cache) {
+  const uint8_t *data = (const uint8_t *)&cache + sizeof(cache.crc);
+  size_t length       = sizeof(cache) - sizeof(cache.crc);
+  uint32_t crc        = 0xFFFFFFFF ^ WM_FASTCONNECT_VERSION;
+
+  while(length--){
+    crc ^= *data++;
+    for(uint8_t bit = 0; bit < 8; bit++){
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+bool WiFiManagerFastConnect::loadCache(wm_fastconnect_cache_t &cache, bool fromRTC) {
+  bool read = fromRTC ? _driver.readRTC(cache) : _driver.readFlash(cache);
+  return read && cache.crc == crc(cache) && cache.ssid[0] != '\0' && cache.ssid[sizeof(cache.ssid) - 1] == '\0';
+}
+
+// move on to the next step that is enabled
+void WiFiManagerFastConnect::next() {
+  _stepStarted = false;
+
+  switch(_state){
+    case WM_FASTCONNECT_IDLE:
+      _state = WM_FASTCONNECT_DIRECT;
+      if(_cacheValid && _directTimeout > 0) return;
+      // fall through
+    case WM_FASTCONNECT_DIRECT:
+      _state = WM_FASTCONNECT_SCAN;
+      if(_scanTimeout > 0) return;
+      // fall through
+    case WM_FASTCONNECT_SCAN:
+      _state = WM_FASTCONNECT_PORTAL;
+      if(_portal) return;
+      // fall through
+    default:
+      _state = WM_FASTCONNECT_OFFLINE;
+      _path  = WM_FASTCONNECT_OFFLINE;
+  }
+}
+
+void WiFiManagerFastConnect::setOnline() {
+  _path   = _state;
+  _state  = WM_FASTCONNECT_ONLINE;
+  _online = _driver.now();
+  save();
+}
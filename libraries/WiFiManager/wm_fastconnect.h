@@ -0,0 +1,162 @@
+/**
+ * wm_fastconnect.h
+ * fast reconnect for autoConnect
+ * WiFiManager, a library for the ESP8266/Arduino platform
+ * for configuration of WiFi credentials using a Captive Portal
+ *
+ * Remembers the bssid, channel and ip of the last good connection, in rtc
+ * memory and in flash, and tries them first: a directed connect skips the
+ * scan of all channels, and a reused ip skips dhcp. The full scan, and then
+ * the config portal, are only used if it fails.
+ *
+ * No platform includes here, wifi and storage go through
+ * WiFiManagerFastConnectDriver so the steps can be run on a host too.
+ *
+ * @license MIT
+ */
+
+#ifndef WiFiManagerFastConnect_h
+#define WiFiManagerFastConnect_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef WM_FASTCONNECT_DIRECT_TIMEOUT
+#define WM_FASTCONNECT_DIRECT_TIMEOUT 4000  // ms to wait for the directed connect before scanning
+#endif
+
+#ifndef WM_FASTCONNECT_SCAN_TIMEOUT
+#define WM_FASTCONNECT_SCAN_TIMEOUT   30000 // ms to wait for the scan connect if no connect timeout is set
+#endif
+
+#define WM_FASTCONNECT_POLL           10    // ms between status checks in connect()
+#define WM_FASTCONNECT_VERSION        1     // change with wm_fastconnect_cache_t, older caches are then ignored
+
+// the last good connection, 60 bytes, a multiple of 4 as esp8266 rtc memory is accessed in 32 bit blocks
+// the password is not cached, it stays in the wifi config
+typedef struct {
+    uint32_t crc;        // crc32 of the rest, seeded with the version
+    uint32_t ip;         // leased or static, as IPAddress casts to uint32_t
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    char     ssid[33];
+    uint8_t  bssid[6];
+    uint8_t  channel;
+} wm_fastconnect_cache_t;
+
+typedef enum {
+    WM_FASTCONNECT_IDLE    = 0, // not started
+    WM_FASTCONNECT_DIRECT  = 1, // connecting to the cached bssid, on the cached channel
+    WM_FASTCONNECT_SCAN    = 2, // connecting to the saved ssid, scanning all channels
+    WM_FASTCONNECT_PORTAL  = 3, // config portal
+    WM_FASTCONNECT_ONLINE  = 4,
+    WM_FASTCONNECT_OFFLINE = 5  // all steps failed
+} wm_fastconnect_state_t;
+
+typedef enum {
+    WM_FASTCONNECT_CONNECTING = 0,
+    WM_FASTCONNECT_CONNECTED  = 1,
+    WM_FASTCONNECT_FAILED     = 2  // gave up before the timeout, no ap or wrong password
+} wm_fastconnect_status_t;
+
+// platform side of fast connect, WiFiManager has the esp8266/esp32 one
+class WiFiManagerFastConnectDriver {
+  public:
+    virtual ~WiFiManagerFastConnectDriver() {}
+
+    virtual unsigned long now() = 0; // ms since boot
+    virtual void          wait(unsigned long ms) = 0;
+
+    // cache storage, false if nothing could be read or written
+    virtual bool          readRTC(wm_fastconnect_cache_t &cache) = 0;
+    virtual bool          writeRTC(const wm_fastconnect_cache_t &cache) = 0;
+    virtual bool          readFlash(wm_fastconnect_cache_t &cache) = 0;
+    virtual bool          writeFlash(const wm_fastconnect_cache_t &cache) = 0;
+
+    // ssid of the saved credentials, the cache is only used if it matches
+    virtual bool          getSavedSSID(char *ssid, size_t size) = 0;
+
+    // start connecting with the saved credentials, false if it could not be started
+    virtual bool          beginDirect(const wm_fastconnect_cache_t &cache, bool reuseIP) = 0;
+    virtual bool          beginScan() = 0;
+    virtual wm_fastconnect_status_t status() = 0;
+
+    // the current connection, ssid bssid channel and ip
+    virtual bool          getConnection(wm_fastconnect_cache_t &cache) = 0;
+
+    // run the config portal, true if connected when it closes
+    virtual bool          startPortal() = 0;
+};
+
+class WiFiManagerFastConnect {
+  public:
+    WiFiManagerFastConnect(WiFiManagerFastConnectDriver &driver);
+
+    // ms to wait for the directed and scan connects, 0 to skip the step
+    void          setDirectTimeout(unsigned long ms);
+    void          setScanTimeout(unsigned long ms);
+
+    // reuse the cached ip instead of waiting for dhcp, only safe if the dhcp lease is long or reserved
+    void          setReuseIP(bool enable);
+
+    // skip the config portal, OFFLINE after the scan connect fails
+    void          setPortal(bool enable);
+
+    // load the cache, rtc first then flash, and start over
+    void          begin();
+
+    // run the current step without blocking, returns the new state
+    // the portal step blocks if the portal does
+    wm_fastconnect_state_t process();
+
+    // begin() and process() until ONLINE or OFFLINE, true if ONLINE
+    bool          connect();
+
+    // cache the current connection, for when it was made some other way
+    bool          save();
+
+    // invalidate the cache in rtc memory and flash
+    void          erase();
+
+    wm_fastconnect_state_t getState();
+
+    // the step that got ONLINE, or OFFLINE
+    wm_fastconnect_state_t getPath();
+
+    // ms since boot when ONLINE, 0 if not
+    unsigned long getBootToOnline();
+
+    // ms from begin() to ONLINE, 0 if not
+    unsigned long getConnectTime();
+
+    // true if a valid cache for the saved ssid was found by begin()
+    bool          getCacheValid();
+
+    static const char* getStateString(wm_fastconnect_state_t state);
+    static uint32_t    crc(const wm_fastconnect_cache_t &cache);
+
+  protected:
+    WiFiManagerFastConnectDriver &_driver;
+
+    wm_fastconnect_cache_t _cache;
+    bool          _cacheValid     = false;
+
+    unsigned long _directTimeout  = WM_FASTCONNECT_DIRECT_TIMEOUT; // ms
+    unsigned long _scanTimeout    = WM_FASTCONNECT_SCAN_TIMEOUT;   // ms
+    bool          _reuseIP        = false;
+    bool          _portal         = true;
+
+    wm_fastconnect_state_t _state = WM_FASTCONNECT_IDLE;
+    wm_fastconnect_state_t _path  = WM_FASTCONNECT_IDLE;
+    bool          _stepStarted    = false;
+    unsigned long _stepStart      = 0; // ms
+    unsigned long _begin          = 0; // ms
+    unsigned long _online         = 0; // ms since boot
+
+    bool          loadCache(wm_fastconnect_cache_t &cache, bool fromRTC);
+    void          next();
+    void          setOnline();
+};
+
+#endif
@@ -179,10 +179,9 @@ void loop() {
     }
   }
 
-  // Update waktu NTP secara berkala
-  if (millis() - state.lastNtpUpdate > NTP_UPDATE_INTERVAL) {
+  // Update waktu NTP secara berkala, tanpa menunggu jawaban server
+  if (isWiFiConnected() && timeClient.poll()) {
     state.lastNtpUpdate = millis();
-    updateNtpTime();
   }
 
   // Periksa autentikasi terminal secara berkala
@@ -370,8 +369,12 @@ void setupWiFi() {
 }
 
 void setupNTP() {
+  // Beberapa server, agar server yang waktunya salah bisa diabaikan
+  timeClient.addServer("0.id.pool.ntp.org");
+  timeClient.addServer("1.id.pool.ntp.org");
   timeClient.begin();
   timeClient.setTimeOffset(7 * 3600);  // GMT+7 (WIB)
+  timeClient.setUpdateInterval(NTP_UPDATE_INTERVAL);
   updateNtpTime();
 }
 
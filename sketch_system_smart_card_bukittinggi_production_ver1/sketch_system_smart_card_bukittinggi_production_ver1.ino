@@ -507,33 +507,31 @@ void handleServerResponse(int httpCode, const String& uid) {
 }
 
 /**
- * Cek status WiFi dan reconnect jika perlu - optimasi timeout
+ * Cek status WiFi dan reconnect jika perlu - tanpa menunggu, pembacaan kartu tetap jalan
+ * (kartu yang dibaca saat terputus dilaporkan lewat RESP_WIFI_ERROR)
  */
 bool ensureWiFiConnected() {
+  static bool disconnected = false;
+
   if (WiFi.status() == WL_CONNECTED) {
+    if (disconnected) {
+      disconnected = false;
+      showSuccess(F("WiFi Tersambung"), WiFi.SSID());
+      delay(DELAY_SHORT);
+      showCardPrompt();
+    }
     return true;
   }
 
-  showMessage(F("WiFi Terputus"), F("Menyambung ulang"));
-
-  // Coba reconnect
-  WiFi.reconnect();
-
-  // Tunggu beberapa saat, dengan timeout yang lebih singkat
-  unsigned long startTime = millis();
-  while (WiFi.status() != WL_CONNECTED && millis() - startTime < 4000) {  // 4 detik dari 6 detik
-    delay(300);                                                           // Interval check lebih singkat
-  }
-
-  if (WiFi.status() != WL_CONNECTED) {
-    showMessage(F("WiFi Gagal"), F("Coba lagi..."));
+  if (!disconnected) {
+    disconnected = true;
+    showMessage(F("WiFi Terputus"), F("Menyambung ulang"));
     blinkLED(3, 100);
-    return false;
   }
 
-  showSuccess(F("WiFi Tersambung"), WiFi.SSID());
-  delay(DELAY_SHORT);
-  return true;
+  // Auto reconnect menyambung di latar belakang, ini hanya dorongan tiap pengecekan
+  WiFi.reconnect();
+  return false;
 }
 
 /**
@@ -570,10 +568,17 @@ void setup() {
 
   WiFiManager wifiManager;
 
-  wifiManager.resetSettings();
+  // Hapus WiFi tersimpan hanya jika tombol mode ditekan saat ini (bukan saat power on, GPIO0 LOW = mode flash)
+  if (digitalRead(BUTTON_PIN) == LOW) {
+    showMessage(F("Reset WiFi"), F("Buka portal..."));
+    wifiManager.resetSettings();
+  }
 
   wifiManager.setConfigPortalTimeout(180);  // 3 menit timeout untuk konfigurasi
 
+  // Coba AP, channel dan BSSID terakhir dulu tanpa scan, lalu scan, lalu portal
+  wifiManager.setFastConnect(true);
+
   WiFi.setSleepMode(WIFI_NONE_SLEEP);  // Hindari sleep mode yang menyebabkan koneksi lambat
   WiFi.setAutoReconnect(true);
 
@@ -583,6 +588,11 @@ void setup() {
     ESP.restart();
   }
 
+  Serial.print(F("Online sejak boot: "));
+  Serial.print(wifiManager.getBootToOnline());
+  Serial.print(F(" ms, lewat "));
+  Serial.println(WiFiManagerFastConnect::getStateString(wifiManager.getFastConnectPath()));
+
   showSuccess(F("WiFi Terhubung"), WiFi.SSID());
   delay(DELAY_SHORT);
 
@@ -624,10 +634,7 @@ void loop() {
   static unsigned long lastWifiCheck = 0;
   if (millis() - lastWifiCheck > 10000) {  // Cek tiap 10 detik saja
     lastWifiCheck = millis();
-    if (!ensureWiFiConnected()) {
-      delay(1000);
-      return;
-    }
+    ensureWiFiConnected();
   }
 
   // Baca kartu RFID